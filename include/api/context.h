@@ -89,6 +89,10 @@ class MS_API CPUDeviceInfo : public DeviceInfoContext {
   int GetThreadAffinity() const;
   void SetEnableFP16(bool is_fp16);
   bool GetEnableFP16() const;
+
+  /// \brief Run independent kernels of the graph concurrently on the threads of the context.
+  void SetEnableParallel(bool is_parallel);
+  bool GetEnableParallel() const;
 };
 
 class MS_API MaliGPUDeviceInfo : public DeviceInfoContext {
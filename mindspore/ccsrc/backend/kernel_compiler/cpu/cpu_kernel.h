@@ -30,6 +30,7 @@ using mindspore::kernel::AddressPtr;
 using CTask = std::function<void(size_t, size_t)>;
 namespace mindspore {
 namespace kernel {
+const size_t kParallelGrainSize = 128;
 const char KERNEL_SIZE[] = "kernel_size";
 const char STRIDE[] = "stride";
 const char STRIDES[] = "strides";
@@ -146,7 +147,8 @@ class CPUKernelUtils {
   static size_t CalcOffset(const std::vector<size_t> &shape, size_t dim0, size_t dim1, size_t dim2, size_t dim3);
   static size_t GetElementNumOnAxis(const std::vector<size_t> &shape, int axis);
   static void GetElementNumEveryDim(const std::vector<size_t> &shape, std::vector<size_t> *element_num);
-  static void ParallelFor(const CTask &task, size_t count);
+  // elements below grain_size are not worth a task of their own, lower it for kernels with costly elements
+  static void ParallelFor(const CTask &task, size_t count, size_t grain_size = kParallelGrainSize);
   static std::vector<size_t> FlatShapeByAxis(const std::vector<size_t> &shape, int axis);
 };
 
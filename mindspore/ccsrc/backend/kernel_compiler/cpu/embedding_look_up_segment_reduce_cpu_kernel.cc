@@ -0,0 +1,181 @@
+/**
+ * Copyright 2021 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "backend/kernel_compiler/cpu/embedding_look_up_segment_reduce_cpu_kernel.h"
+#include <algorithm>
+#include "runtime/device/cpu/cpu_device_address.h"
+
+namespace mindspore {
+namespace kernel {
+namespace {
+// rows of a bag are picked at random from the table, start loading them this many lookups ahead
+constexpr size_t kPrefetchDistance = 4;
+constexpr size_t kCacheLineSize = 64;
+
+template <typename T>
+inline void PrefetchRow(const T *row, size_t row_size) {
+#if defined(__GNUC__) || defined(__clang__)
+  const char *addr = reinterpret_cast<const char *>(row);
+  for (size_t i = 0; i < row_size * sizeof(T); i += kCacheLineSize) {
+    __builtin_prefetch(addr + i, 0, 0);
+  }
+#endif
+}
+
+template <typename T>
+inline void SumRow(const T *row, float *output, size_t row_size) {
+  for (size_t j = 0; j < row_size; ++j) {
+    output[j] += static_cast<float>(row[j]);
+  }
+}
+}  // namespace
+
+template <typename T>
+void EmbeddingLookUpSegmentReduceCPUKernel<T>::InitKernel(const CNodePtr &kernel_node) {
+  CheckParam(kernel_node);
+  std::vector<size_t> input_shape = AnfAlgo::GetPrevNodeOutputInferShape(kernel_node, 0);
+  first_dim_size_ = input_shape[0];
+  outer_dim_size_ = 1;
+  for (size_t i = 1; i < input_shape.size(); ++i) {
+    outer_dim_size_ *= input_shape[i];
+  }
+  indices_lens_ = 1;
+  std::vector<size_t> indices_shape = AnfAlgo::GetPrevNodeOutputInferShape(kernel_node, 1);
+  for (const auto &shape : indices_shape) {
+    indices_lens_ *= shape;
+  }
+  std::vector<size_t> output_shape = AnfAlgo::GetOutputInferShape(kernel_node, 0);
+  segment_num_ = output_shape[0];
+  indices_data_type_ = AnfAlgo::GetInputDeviceDataType(kernel_node, 1);
+  if (AnfAlgo::HasNodeAttr(kAttrOffset, kernel_node)) {
+    offset_ = AnfAlgo::GetNodeAttr<int64_t>(kernel_node, kAttrOffset);
+  }
+}
+
+template <typename T>
+void EmbeddingLookUpSegmentReduceCPUKernel<T>::InitInputOutputSize(const CNodePtr &kernel_node) {
+  CPUKernel::InitInputOutputSize(kernel_node);
+  // bag_offsets and the positions of every bag, the csr form of segment_ids
+  workspace_size_list_.emplace_back((segment_num_ + 1) * sizeof(size_t));
+  workspace_size_list_.emplace_back(indices_lens_ * sizeof(size_t));
+}
+
+// Counting sort of the lookup positions by segment id, positions of bag s end up in
+// positions[bag_offsets[s], bag_offsets[s + 1]) in their original order. Ids out of range are dropped.
+template <typename T>
+template <typename S>
+void EmbeddingLookUpSegmentReduceCPUKernel<T>::GroupBags(const S *segment_ids, size_t *bag_offsets,
+                                                          size_t *positions) const {
+  std::fill(bag_offsets, bag_offsets + segment_num_ + 1, 0);
+  for (size_t i = 0; i < indices_lens_; ++i) {
+    auto segment = segment_ids[i];
+    if (segment >= 0 && static_cast<size_t>(segment) < segment_num_) {
+      bag_offsets[segment + 1]++;
+    }
+  }
+  for (size_t s = 1; s <= segment_num_; ++s) {
+    bag_offsets[s] += bag_offsets[s - 1];
+  }
+  // bag_offsets[s] is used as the write cursor of bag s - 1 and ends at its end, which is where bag s starts
+  for (size_t i = 0; i < indices_lens_; ++i) {
+    auto segment = segment_ids[i];
+    if (segment >= 0 && static_cast<size_t>(segment) < segment_num_) {
+      positions[bag_offsets[segment]++] = i;
+    }
+  }
+  for (size_t s = segment_num_; s > 0; --s) {
+    bag_offsets[s] = bag_offsets[s - 1];
+  }
+  bag_offsets[0] = 0;
+}
+
+template <typename T>
+template <typename S>
+void EmbeddingLookUpSegmentReduceCPUKernel<T>::LaunchKernel(const std::vector<AddressPtr> &inputs,
+                                                            const std::vector<AddressPtr> &workspace,
+                                                            const std::vector<AddressPtr> &outputs) {
+  auto table = reinterpret_cast<T *>(inputs[0]->addr);
+  auto indices = reinterpret_cast<S *>(inputs[1]->addr);
+  auto segment_ids = reinterpret_cast<S *>(inputs[2]->addr);
+  auto bag_offsets = reinterpret_cast<size_t *>(workspace[0]->addr);
+  auto positions = reinterpret_cast<size_t *>(workspace[1]->addr);
+  auto output = reinterpret_cast<float *>(outputs[0]->addr);
+  GroupBags(segment_ids, bag_offsets, positions);
+
+  auto task = [&](size_t start, size_t end) {
+    for (size_t s = start; s < end; ++s) {
+      float *output_row = output + s * outer_dim_size_;
+      size_t bag_begin = bag_offsets[s];
+      size_t bag_end = bag_offsets[s + 1];
+      std::fill(output_row, output_row + outer_dim_size_, 0.0f);
+      for (size_t k = bag_begin; k < bag_end; ++k) {
+        if (k + kPrefetchDistance < bag_end) {
+          int64_t next = static_cast<int64_t>(indices[positions[k + kPrefetchDistance]]) - offset_;
+          if (next >= 0 && static_cast<size_t>(next) < first_dim_size_) {
+            PrefetchRow(table + next * outer_dim_size_, outer_dim_size_);
+          }
+        }
+        int64_t index = static_cast<int64_t>(indices[positions[k]]) - offset_;
+        // a lookup out of the table reads a zero row, as in EmbeddingLookup
+        if (index >= 0 && static_cast<size_t>(index) < first_dim_size_) {
+          SumRow(table + index * outer_dim_size_, output_row, outer_dim_size_);
+        }
+      }
+    }
+  };
+  size_t bag_cost = std::max<size_t>(indices_lens_ / std::max<size_t>(segment_num_, 1), 1) * outer_dim_size_;
+  CPUKernelUtils::ParallelFor(task, segment_num_, std::max<size_t>(kParallelGrainSize / bag_cost, 1));
+}
+
+template <typename T>
+bool EmbeddingLookUpSegmentReduceCPUKernel<T>::Launch(const std::vector<AddressPtr> &inputs,
+                                                      const std::vector<AddressPtr> &workspace,
+                                                      const std::vector<AddressPtr> &outputs) {
+  if (inputs.size() != 3 || workspace.size() != 2 || outputs.size() != 1) {
+    MS_LOG(EXCEPTION) << "EmbeddingLookupSegmentReduce needs 3 inputs, 2 workspaces and 1 output, but got "
+                      << inputs.size() << ", " << workspace.size() << ", " << outputs.size();
+  }
+  if (indices_data_type_ == kNumberTypeInt32) {
+    LaunchKernel<int>(inputs, workspace, outputs);
+  } else {
+    LaunchKernel<int64_t>(inputs, workspace, outputs);
+  }
+  return true;
+}
+
+template <typename T>
+void EmbeddingLookUpSegmentReduceCPUKernel<T>::CheckParam(const CNodePtr &kernel_node) {
+  size_t input_num = AnfAlgo::GetInputTensorNum(kernel_node);
+  if (input_num != 3) {
+    MS_LOG(EXCEPTION) << "Argument number is " << input_num << ", but EmbeddingLookupSegmentReduce needs 3.";
+  }
+  auto input_shape = AnfAlgo::GetPrevNodeOutputInferShape(kernel_node, 0);
+  if (input_shape.empty() || input_shape.size() > 4) {
+    MS_LOG(EXCEPTION) << "Input dims is " << input_shape.size()
+                      << ", but EmbeddingLookupSegmentReduce only support 1d to 4d.";
+  }
+  auto indices_shape = AnfAlgo::GetPrevNodeOutputInferShape(kernel_node, 1);
+  auto segment_ids_shape = AnfAlgo::GetPrevNodeOutputInferShape(kernel_node, 2);
+  if (indices_shape != segment_ids_shape) {
+    MS_LOG(EXCEPTION) << "The shape of segment_ids should be the same as indices.";
+  }
+  auto output_shape = AnfAlgo::GetOutputInferShape(kernel_node, 0);
+  if (output_shape.size() != input_shape.size() ||
+      !std::equal(input_shape.begin() + 1, input_shape.end(), output_shape.begin() + 1)) {
+    MS_LOG(EXCEPTION) << "The output of EmbeddingLookupSegmentReduce should be [num_segments] + param shape[1:].";
+  }
+}
+}  // namespace kernel
+}  // namespace mindspore
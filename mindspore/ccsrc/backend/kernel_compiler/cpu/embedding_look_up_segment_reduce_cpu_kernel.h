@@ -0,0 +1,92 @@
+/**
+ * Copyright 2021 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef MINDSPORE_CCSRC_BACKEND_KERNEL_COMPILER_CPU_EMBEDDING_LOOK_UP_SEGMENT_REDUCE_CPU_KERNEL_H_
+#define MINDSPORE_CCSRC_BACKEND_KERNEL_COMPILER_CPU_EMBEDDING_LOOK_UP_SEGMENT_REDUCE_CPU_KERNEL_H_
+#include <vector>
+#include <memory>
+#include "backend/kernel_compiler/cpu/cpu_kernel.h"
+#include "backend/kernel_compiler/cpu/cpu_kernel_factory.h"
+
+namespace mindspore {
+namespace kernel {
+// Gathers the rows of table picked by indices and reduces them per bag given by segment_ids, so the
+// [indices_lens, row] gathered tensor of EmbeddingLookup + UnsortedSegmentSum is never written. T is the table
+// type, the output is always accumulated and stored in float32.
+template <typename T>
+class EmbeddingLookUpSegmentReduceCPUKernel : public CPUKernel {
+ public:
+  EmbeddingLookUpSegmentReduceCPUKernel() = default;
+  ~EmbeddingLookUpSegmentReduceCPUKernel() override = default;
+
+  void InitKernel(const CNodePtr &kernel_node) override;
+
+  bool Launch(const std::vector<AddressPtr> &inputs, const std::vector<AddressPtr> &workspace,
+              const std::vector<AddressPtr> &outputs) override;
+
+ protected:
+  void InitInputOutputSize(const CNodePtr &kernel_node) override;
+
+ private:
+  template <typename S>
+  void LaunchKernel(const std::vector<AddressPtr> &inputs, const std::vector<AddressPtr> &workspace,
+                    const std::vector<AddressPtr> &outputs);
+  template <typename S>
+  void GroupBags(const S *segment_ids, size_t *bag_offsets, size_t *positions) const;
+  void CheckParam(const CNodePtr &kernel_node);
+
+  int64_t offset_{0};
+  size_t indices_lens_{1};
+  size_t first_dim_size_{1};
+  size_t outer_dim_size_{1};
+  size_t segment_num_{1};
+  TypeId indices_data_type_{kNumberTypeInt32};
+};
+
+MS_REG_CPU_KERNEL_T(EmbeddingLookupSegmentReduce,
+                    KernelAttr()
+                      .AddInputAttr(kNumberTypeFloat32)
+                      .AddInputAttr(kNumberTypeInt32)
+                      .AddInputAttr(kNumberTypeInt32)
+                      .AddOutputAttr(kNumberTypeFloat32),
+                    EmbeddingLookUpSegmentReduceCPUKernel, float);
+
+MS_REG_CPU_KERNEL_T(EmbeddingLookupSegmentReduce,
+                    KernelAttr()
+                      .AddInputAttr(kNumberTypeFloat32)
+                      .AddInputAttr(kNumberTypeInt64)
+                      .AddInputAttr(kNumberTypeInt64)
+                      .AddOutputAttr(kNumberTypeFloat32),
+                    EmbeddingLookUpSegmentReduceCPUKernel, float);
+
+MS_REG_CPU_KERNEL_T(EmbeddingLookupSegmentReduce,
+                    KernelAttr()
+                      .AddInputAttr(kNumberTypeFloat16)
+                      .AddInputAttr(kNumberTypeInt32)
+                      .AddInputAttr(kNumberTypeInt32)
+                      .AddOutputAttr(kNumberTypeFloat32),
+                    EmbeddingLookUpSegmentReduceCPUKernel, float16);
+
+MS_REG_CPU_KERNEL_T(EmbeddingLookupSegmentReduce,
+                    KernelAttr()
+                      .AddInputAttr(kNumberTypeFloat16)
+                      .AddInputAttr(kNumberTypeInt64)
+                      .AddInputAttr(kNumberTypeInt64)
+                      .AddOutputAttr(kNumberTypeFloat32),
+                    EmbeddingLookUpSegmentReduceCPUKernel, float16);
+}  // namespace kernel
+}  // namespace mindspore
+
+#endif  // MINDSPORE_CCSRC_BACKEND_KERNEL_COMPILER_CPU_EMBEDDING_LOOK_UP_SEGMENT_REDUCE_CPU_KERNEL_H_
@@ -15,6 +15,7 @@
  */
 
 #include "backend/kernel_compiler/cpu/l2_normalize_cpu_kernel.h"
+#include <algorithm>
 #include "runtime/device/cpu/cpu_device_address.h"
 
 namespace mindspore {
@@ -74,7 +75,7 @@ void L2NormalizeCPUKernel<T>::CalcDenominator(const T *input_addr, const size_t
       (*denominator_addr)[i] = sqrt(denominator);
     }
   };
-  CPUKernelUtils::ParallelFor(task, reduce_size);
+  CPUKernelUtils::ParallelFor(task, reduce_size, std::max<size_t>(kParallelGrainSize / stride, 1));
 }
 
 template <typename T>
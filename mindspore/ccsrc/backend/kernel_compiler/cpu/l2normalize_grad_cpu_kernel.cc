@@ -63,7 +63,8 @@ bool L2NormalizeGradCPUKernel<T>::Launch(const std::vector<AddressPtr> &inputs,
       GetOutput(input_x_vector, y_vector, dout_vector, high_dim_index, &output[i]);
     }
   };
-  CPUKernelUtils::ParallelFor(task, output_size);
+  // every output gathers whole vectors along the axis
+  CPUKernelUtils::ParallelFor(task, output_size, 1);
   return true;
 }
 
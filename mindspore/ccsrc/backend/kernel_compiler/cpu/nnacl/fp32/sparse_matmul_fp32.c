@@ -0,0 +1,309 @@
+/**
+ * Copyright 2021 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "nnacl/fp32/sparse_matmul_fp32.h"
+#include <string.h>
+
+static bool IsZeroBlock(const float *src, int oc, int cur_oc, int deep, int d) {
+  for (int j = 0; j < cur_oc; ++j) {
+    if (src[(oc + j) * deep + d] != 0.0f) {
+      return false;
+    }
+  }
+  return true;
+}
+
+int BlockSparseNonzeroNum(const float *src, int col, int deep) {
+  int block_num = 0;
+  for (int oc = 0; oc < col; oc += SPARSE_BLOCK) {
+    int cur_oc = MSMIN(SPARSE_BLOCK, col - oc);
+    for (int d = 0; d < deep; ++d) {
+      block_num += IsZeroBlock(src, oc, cur_oc, deep, d) ? 0 : 1;
+    }
+  }
+  return block_num;
+}
+
+size_t BlockSparsePackSize(int col, int block_num) {
+  return (UP_DIV(col, SPARSE_BLOCK) + 1 + block_num) * sizeof(int) + block_num * SPARSE_BLOCK * sizeof(float);
+}
+
+void PackBlockSparse(const float *src, void *dst, int col, int deep) {
+  int col_block = UP_DIV(col, SPARSE_BLOCK);
+  int *block_offset = (int *)dst;
+  int *deep_index = block_offset + col_block + 1;
+  int block_num = 0;
+  for (int cb = 0; cb < col_block; ++cb) {
+    block_offset[cb] = block_num;
+    int oc = cb * SPARSE_BLOCK;
+    int cur_oc = MSMIN(SPARSE_BLOCK, col - oc);
+    for (int d = 0; d < deep; ++d) {
+      if (!IsZeroBlock(src, oc, cur_oc, deep, d)) {
+        deep_index[block_num++] = d;
+      }
+    }
+  }
+  block_offset[col_block] = block_num;
+
+  float *value = (float *)(deep_index + block_num);
+  memset(value, 0, block_num * SPARSE_BLOCK * sizeof(float));
+  for (int cb = 0; cb < col_block; ++cb) {
+    int oc = cb * SPARSE_BLOCK;
+    int cur_oc = MSMIN(SPARSE_BLOCK, col - oc);
+    for (int b = block_offset[cb]; b < block_offset[cb + 1]; ++b) {
+      for (int j = 0; j < cur_oc; ++j) {
+        value[b * SPARSE_BLOCK + j] = src[(oc + j) * deep + deep_index[b]];
+      }
+    }
+  }
+}
+
+int UnpackBlockSparse(const void *src, size_t size, float *dst, int col, int deep) {
+  int col_block = UP_DIV(col, SPARSE_BLOCK);
+  if (size < (col_block + 1) * sizeof(int)) {
+    return NNACL_PARAM_INVALID;
+  }
+  const int *block_offset = (const int *)src;
+  int block_num = block_offset[col_block];
+  if (block_num < 0 || block_num > col_block * deep || size != BlockSparsePackSize(col, block_num)) {
+    return NNACL_PARAM_INVALID;
+  }
+  const int *deep_index = block_offset + col_block + 1;
+  const float *value = (const float *)(deep_index + block_num);
+  memset(dst, 0, col * deep * sizeof(float));
+  for (int cb = 0; cb < col_block; ++cb) {
+    if (block_offset[cb] < 0 || block_offset[cb] > block_offset[cb + 1]) {
+      return NNACL_PARAM_INVALID;
+    }
+    int oc = cb * SPARSE_BLOCK;
+    int cur_oc = MSMIN(SPARSE_BLOCK, col - oc);
+    for (int b = block_offset[cb]; b < block_offset[cb + 1]; ++b) {
+      int d = deep_index[b];
+      if (d < 0 || d >= deep) {
+        return NNACL_PARAM_INVALID;
+      }
+      for (int j = 0; j < cur_oc; ++j) {
+        dst[(oc + j) * deep + d] = value[b * SPARSE_BLOCK + j];
+      }
+    }
+  }
+  return NNACL_OK;
+}
+
+static void StoreSparseBlock(float *acc, float *c, int cur_oc, ActType act_type) {
+  for (int j = 0; j < cur_oc; ++j) {
+    float v = acc[j];
+    if (act_type == ActType_Relu || act_type == ActType_Relu6) {
+      v = MSMAX(0.0f, v);
+    }
+    if (act_type == ActType_Relu6) {
+      v = MSMIN(6.0f, v);
+    }
+    c[j] = v;
+  }
+}
+
+/* rows x SPARSE_BLOCK outputs of one column block, every nonzero block broadcasts one value of each row of a */
+static void SparseBlockRows(const float *a, const int *deep_index, const float *value, int block_num,
+                            const float *bias, float *c, ActType act_type, int deep, int rows, int col, int cur_oc) {
+  float acc[SPARSE_ROW_TILE][SPARSE_BLOCK];
+#ifdef ENABLE_AVX
+  MS_FLOAT32X8 init = bias == NULL ? _mm256_setzero_ps() : MS_LD256_F32(bias);
+  MS_FLOAT32X8 acc0 = init, acc1 = init, acc2 = init, acc3 = init;
+  if (rows == SPARSE_ROW_TILE) {
+    for (int b = 0; b < block_num; ++b) {
+      const float *src_a = a + deep_index[b];
+      MS_FLOAT32X8 w = MS_LD256_F32(value + b * SPARSE_BLOCK);
+      acc0 = _mm256_fmadd_ps(_mm256_set1_ps(src_a[0]), w, acc0);
+      acc1 = _mm256_fmadd_ps(_mm256_set1_ps(src_a[deep]), w, acc1);
+      acc2 = _mm256_fmadd_ps(_mm256_set1_ps(src_a[2 * deep]), w, acc2);
+      acc3 = _mm256_fmadd_ps(_mm256_set1_ps(src_a[3 * deep]), w, acc3);
+    }
+  } else {
+    for (int b = 0; b < block_num; ++b) {
+      acc0 = _mm256_fmadd_ps(_mm256_set1_ps(a[deep_index[b]]), MS_LD256_F32(value + b * SPARSE_BLOCK), acc0);
+    }
+  }
+  MS_ST256_F32(acc[0], acc0);
+  MS_ST256_F32(acc[1], acc1);
+  MS_ST256_F32(acc[2], acc2);
+  MS_ST256_F32(acc[3], acc3);
+#elif defined(ENABLE_ARM) || defined(ENABLE_SSE)
+  MS_FLOAT32X4 init_lo = bias == NULL ? MS_MOVQ_F32(0.0f) : MS_LDQ_F32(bias);
+  MS_FLOAT32X4 init_hi = bias == NULL ? MS_MOVQ_F32(0.0f) : MS_LDQ_F32(bias + C4NUM);
+  MS_FLOAT32X4 acc0_lo = init_lo, acc1_lo = init_lo, acc2_lo = init_lo, acc3_lo = init_lo;
+  MS_FLOAT32X4 acc0_hi = init_hi, acc1_hi = init_hi, acc2_hi = init_hi, acc3_hi = init_hi;
+  if (rows == SPARSE_ROW_TILE) {
+    for (int b = 0; b < block_num; ++b) {
+      const float *src_a = a + deep_index[b];
+      MS_FLOAT32X4 w_lo = MS_LDQ_F32(value + b * SPARSE_BLOCK);
+      MS_FLOAT32X4 w_hi = MS_LDQ_F32(value + b * SPARSE_BLOCK + C4NUM);
+      MS_FLOAT32X4 a0 = MS_MOVQ_F32(src_a[0]);
+      MS_FLOAT32X4 a1 = MS_MOVQ_F32(src_a[deep]);
+      MS_FLOAT32X4 a2 = MS_MOVQ_F32(src_a[2 * deep]);
+      MS_FLOAT32X4 a3 = MS_MOVQ_F32(src_a[3 * deep]);
+      acc0_lo = MS_MLAQ_F32(acc0_lo, a0, w_lo);
+      acc0_hi = MS_MLAQ_F32(acc0_hi, a0, w_hi);
+      acc1_lo = MS_MLAQ_F32(acc1_lo, a1, w_lo);
+      acc1_hi = MS_MLAQ_F32(acc1_hi, a1, w_hi);
+      acc2_lo = MS_MLAQ_F32(acc2_lo, a2, w_lo);
+      acc2_hi = MS_MLAQ_F32(acc2_hi, a2, w_hi);
+      acc3_lo = MS_MLAQ_F32(acc3_lo, a3, w_lo);
+      acc3_hi = MS_MLAQ_F32(acc3_hi, a3, w_hi);
+    }
+  } else {
+    for (int b = 0; b < block_num; ++b) {
+      MS_FLOAT32X4 a0 = MS_MOVQ_F32(a[deep_index[b]]);
+      acc0_lo = MS_MLAQ_F32(acc0_lo, a0, MS_LDQ_F32(value + b * SPARSE_BLOCK));
+      acc0_hi = MS_MLAQ_F32(acc0_hi, a0, MS_LDQ_F32(value + b * SPARSE_BLOCK + C4NUM));
+    }
+  }
+  MS_STQ_F32(acc[0], acc0_lo);
+  MS_STQ_F32(acc[0] + C4NUM, acc0_hi);
+  MS_STQ_F32(acc[1], acc1_lo);
+  MS_STQ_F32(acc[1] + C4NUM, acc1_hi);
+  MS_STQ_F32(acc[2], acc2_lo);
+  MS_STQ_F32(acc[2] + C4NUM, acc2_hi);
+  MS_STQ_F32(acc[3], acc3_lo);
+  MS_STQ_F32(acc[3] + C4NUM, acc3_hi);
+#else
+  for (int r = 0; r < rows; ++r) {
+    for (int j = 0; j < SPARSE_BLOCK; ++j) {
+      acc[r][j] = bias == NULL ? 0.0f : bias[j];
+    }
+  }
+  for (int b = 0; b < block_num; ++b) {
+    const float *w = value + b * SPARSE_BLOCK;
+    for (int r = 0; r < rows; ++r) {
+      float src_a = a[r * deep + deep_index[b]];
+      for (int j = 0; j < SPARSE_BLOCK; ++j) {
+        acc[r][j] += src_a * w[j];
+      }
+    }
+  }
+#endif
+  for (int r = 0; r < rows; ++r) {
+    StoreSparseBlock(acc[r], c + r * col, cur_oc, act_type);
+  }
+}
+
+void SparseMatMulFp32(const float *a, const void *packed_b, float *c, const float *bias, ActType act_type, int deep,
+                      int row, int col, int block_start, int block_end) {
+  int col_block = UP_DIV(col, SPARSE_BLOCK);
+  const int *block_offset = (const int *)packed_b;
+  const int *deep_index = block_offset + col_block + 1;
+  const float *value = (const float *)(deep_index + block_offset[col_block]);
+  block_end = MSMIN(block_end, col_block);
+  float bias_tail[SPARSE_BLOCK];
+  for (int cb = block_start; cb < block_end; ++cb) {
+    int oc = cb * SPARSE_BLOCK;
+    int cur_oc = MSMIN(SPARSE_BLOCK, col - oc);
+    const float *cur_bias = bias == NULL ? NULL : bias + oc;
+    if (cur_bias != NULL && cur_oc < SPARSE_BLOCK) {
+      memset(bias_tail, 0, sizeof(bias_tail));
+      memcpy(bias_tail, cur_bias, cur_oc * sizeof(float));
+      cur_bias = bias_tail;
+    }
+    int first = block_offset[cb];
+    int block_num = block_offset[cb + 1] - first;
+    int r = 0;
+    for (; r + SPARSE_ROW_TILE <= row; r += SPARSE_ROW_TILE) {
+      SparseBlockRows(a + r * deep, deep_index + first, value + first * SPARSE_BLOCK, block_num, cur_bias,
+                      c + r * col + oc, act_type, deep, SPARSE_ROW_TILE, col, cur_oc);
+    }
+    for (; r < row; ++r) {
+      SparseBlockRows(a + r * deep, deep_index + first, value + first * SPARSE_BLOCK, block_num, cur_bias,
+                      c + r * col + oc, act_type, deep, 1, col, cur_oc);
+    }
+  }
+}
+
+bool IsSparse24(const float *src, int col, int deep) {
+  for (int j = 0; j < col; ++j) {
+    for (int g = 0; g < deep; g += C4NUM) {
+      int nonzero = 0;
+      for (int d = g; d < MSMIN(g + C4NUM, deep); ++d) {
+        nonzero += src[j * deep + d] != 0.0f ? 1 : 0;
+      }
+      if (nonzero > 2) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+size_t Sparse24PackSize(int col, int deep) { return col * SPARSE24_KEEP(deep) * (sizeof(float) + sizeof(uint8_t)); }
+
+void PackSparse24(const float *src, void *dst, int col, int deep) {
+  int keep = SPARSE24_KEEP(deep);
+  float *value = (float *)dst;
+  uint8_t *offset = (uint8_t *)(value + col * keep);
+  memset(dst, 0, Sparse24PackSize(col, deep));
+  for (int j = 0; j < col; ++j) {
+    for (int g = 0; g < deep; g += C4NUM) {
+      int k = j * keep + g / C4NUM * 2;
+      int kept = 0;
+      for (int d = g; d < MSMIN(g + C4NUM, deep) && kept < 2; ++d) {
+        if (src[j * deep + d] != 0.0f) {
+          value[k + kept] = src[j * deep + d];
+          offset[k + kept] = (uint8_t)(d - g);
+          kept++;
+        }
+      }
+    }
+  }
+}
+
+void Sparse24MatMulFp32(const float *packed_a, const void *packed_b, float *c, const float *bias, ActType act_type,
+                        int deep, int row, int col, int col_start, int col_end) {
+  int keep = SPARSE24_KEEP(deep);
+  const float *value = (const float *)packed_b;
+  const uint8_t *offset = (const uint8_t *)(value + col * keep);
+  col_end = MSMIN(col_end, col);
+  for (int r = 0; r < row; r += C4NUM) {
+    const float *a_tile = packed_a + r * deep;
+    int rows = MSMIN(C4NUM, row - r);
+    for (int j = col_start; j < col_end; ++j) {
+      const float *w = value + j * keep;
+      const uint8_t *w_offset = offset + j * keep;
+      float acc[C4NUM];
+#if defined(ENABLE_ARM) || defined(ENABLE_SSE)
+      MS_FLOAT32X4 acc0 = MS_MOVQ_F32(bias == NULL ? 0.0f : bias[j]);
+      MS_FLOAT32X4 acc1 = MS_MOVQ_F32(0.0f);
+      for (int k = 0; k < keep; k += 2) {
+        const float *group = a_tile + (k / 2) * C4NUM * C4NUM;
+        acc0 = MS_MLAQ_F32(acc0, MS_LDQ_F32(group + w_offset[k] * C4NUM), MS_MOVQ_F32(w[k]));
+        acc1 = MS_MLAQ_F32(acc1, MS_LDQ_F32(group + w_offset[k + 1] * C4NUM), MS_MOVQ_F32(w[k + 1]));
+      }
+      MS_STQ_F32(acc, MS_ADDQ_F32(acc0, acc1));
+#else
+      for (int i = 0; i < C4NUM; ++i) {
+        acc[i] = bias == NULL ? 0.0f : bias[j];
+      }
+      for (int k = 0; k < keep; ++k) {
+        const float *src_a = a_tile + ((k / 2) * C4NUM + w_offset[k]) * C4NUM;
+        for (int i = 0; i < C4NUM; ++i) {
+          acc[i] += src_a[i] * w[k];
+        }
+      }
+#endif
+      for (int i = 0; i < rows; ++i) {
+        StoreSparseBlock(acc + i, c + (r + i) * col + j, 1, act_type);
+      }
+    }
+  }
+}
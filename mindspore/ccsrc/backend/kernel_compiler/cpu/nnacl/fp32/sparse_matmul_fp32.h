@@ -0,0 +1,61 @@
+/**
+ * Copyright 2021 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MINDSPORE_NNACL_FP32_SPARSE_MATMUL_H_
+#define MINDSPORE_NNACL_FP32_SPARSE_MATMUL_H_
+
+#include <stddef.h>
+#include "nnacl/errorcode.h"
+#include "nnacl/op_base.h"
+
+/* Block sparse weight of shape [col, deep] (the transposed b of a matmul, or the [oc, ic] filter of a 1x1 conv).
+ * A block is SPARSE_BLOCK consecutive output channels at one deep index, only blocks with a nonzero value are kept.
+ * Packed layout, blocks of each column block ordered by deep index:
+ *   int   block_offset[UP_DIV(col, SPARSE_BLOCK) + 1]  first block of each column block
+ *   int   deep_index[block_num]
+ *   float value[block_num][SPARSE_BLOCK]              zero padded past col */
+#define SPARSE_BLOCK C8NUM
+#define SPARSE_ROW_TILE C4NUM
+
+/* 2:4 sparse weight of shape [col, deep], every group of 4 consecutive deep values of a column has 2 nonzeros at most.
+ * The 2 kept values of each group are stored with their index in the group, short groups are zero padded:
+ *   float   value[col][SPARSE24_KEEP(deep)]
+ *   uint8_t offset[col][SPARSE24_KEEP(deep)]        deep index is 4 * (k / 2) + offset */
+#define SPARSE24_KEEP(deep) (2 * UP_DIV(deep, C4NUM))
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+int BlockSparseNonzeroNum(const float *src, int col, int deep);
+size_t BlockSparsePackSize(int col, int block_num);
+void PackBlockSparse(const float *src, void *dst, int col, int deep);
+/* restore the dense [col, deep] weight, the packed data comes from a model file so it is validated against size */
+int UnpackBlockSparse(const void *src, size_t size, float *dst, int col, int deep);
+/* c[row, col] = a[row, deep] * b[col, deep]^T + bias for the column blocks in [block_start, block_end) */
+void SparseMatMulFp32(const float *a, const void *packed_b, float *c, const float *bias, ActType act_type, int deep,
+                      int row, int col, int block_start, int block_end);
+bool IsSparse24(const float *src, int col, int deep);
+size_t Sparse24PackSize(int col, int deep);
+void PackSparse24(const float *src, void *dst, int col, int deep);
+/* c[row, col] = a[row, deep] * b[col, deep]^T + bias for the columns in [col_start, col_end), a is packed by
+ * RowMajor2Col4Major so the 4 rows of a tile are loaded at once for every kept value */
+void Sparse24MatMulFp32(const float *packed_a, const void *packed_b, float *c, const float *bias, ActType act_type,
+                        int deep, int row, int col, int col_start, int col_end);
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // MINDSPORE_NNACL_FP32_SPARSE_MATMUL_H_
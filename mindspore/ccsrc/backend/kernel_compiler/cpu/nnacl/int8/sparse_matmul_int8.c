@@ -0,0 +1,207 @@
+/**
+ * Copyright 2021 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "nnacl/int8/sparse_matmul_int8.h"
+#include <string.h>
+#include "nnacl/int8/fixed_point.h"
+
+static bool IsZeroBlockInt8(const int8_t *src, const int32_t *filter_zp, bool per_channel, int oc, int cur_oc,
+                            int deep, int d) {
+  for (int j = 0; j < cur_oc; ++j) {
+    int32_t zp = per_channel ? filter_zp[oc + j] : filter_zp[0];
+    if (src[(oc + j) * deep + d] != zp) {
+      return false;
+    }
+  }
+  return true;
+}
+
+int BlockSparseNonzeroNumInt8(const int8_t *src, const int32_t *filter_zp, bool per_channel, int col, int deep) {
+  int block_num = 0;
+  for (int oc = 0; oc < col; oc += SPARSE_BLOCK) {
+    int cur_oc = MSMIN(SPARSE_BLOCK, col - oc);
+    for (int d = 0; d < deep; ++d) {
+      block_num += IsZeroBlockInt8(src, filter_zp, per_channel, oc, cur_oc, deep, d) ? 0 : 1;
+    }
+  }
+  return block_num;
+}
+
+size_t BlockSparsePackSizeInt8(int col, int block_num) {
+  return (UP_DIV(col, SPARSE_BLOCK) + 1 + block_num) * sizeof(int) + block_num * SPARSE_BLOCK * sizeof(int16_t);
+}
+
+void PackBlockSparseInt8(const int8_t *src, const int32_t *filter_zp, bool per_channel, void *dst, int col, int deep) {
+  int col_block = UP_DIV(col, SPARSE_BLOCK);
+  int *block_offset = (int *)dst;
+  int *deep_index = block_offset + col_block + 1;
+  int block_num = 0;
+  for (int cb = 0; cb < col_block; ++cb) {
+    block_offset[cb] = block_num;
+    int oc = cb * SPARSE_BLOCK;
+    int cur_oc = MSMIN(SPARSE_BLOCK, col - oc);
+    for (int d = 0; d < deep; ++d) {
+      if (!IsZeroBlockInt8(src, filter_zp, per_channel, oc, cur_oc, deep, d)) {
+        deep_index[block_num++] = d;
+      }
+    }
+  }
+  block_offset[col_block] = block_num;
+
+  int16_t *value = (int16_t *)(deep_index + block_num);
+  memset(value, 0, block_num * SPARSE_BLOCK * sizeof(int16_t));
+  for (int cb = 0; cb < col_block; ++cb) {
+    int oc = cb * SPARSE_BLOCK;
+    int cur_oc = MSMIN(SPARSE_BLOCK, col - oc);
+    for (int b = block_offset[cb]; b < block_offset[cb + 1]; ++b) {
+      for (int j = 0; j < cur_oc; ++j) {
+        int32_t zp = per_channel ? filter_zp[oc + j] : filter_zp[0];
+        value[b * SPARSE_BLOCK + j] = (int16_t)(src[(oc + j) * deep + deep_index[b]] - zp);
+      }
+    }
+  }
+}
+
+static void StoreSparseBlockInt8(const int32_t *acc, int8_t *c, int oc, int cur_oc,
+                                 const MatmulQuantParameter *quant_param, bool per_channel) {
+  for (int j = 0; j < cur_oc; ++j) {
+    int q = per_channel ? oc + j : 0;
+    int32_t v = MultiplyByQuantizedMultiplier(acc[j], quant_param->quant_multiplier_[q], quant_param->left_shift_[q],
+                                              quant_param->right_shift_[q]) +
+                quant_param->output_.zp_;
+    v = MSMIN(quant_param->out_act_max_, v);
+    v = MSMAX(quant_param->out_act_min_, v);
+    c[j] = (int8_t)v;
+  }
+}
+
+/* rows x SPARSE_BLOCK accumulators of one column block, every nonzero block broadcasts one value of each row of a */
+static void SparseBlockRowsInt8(const int8_t *a, const int *deep_index, const int16_t *value, int block_num,
+                                const int32_t *bias, int32_t input_zp, int32_t acc[SPARSE_ROW_TILE][SPARSE_BLOCK],
+                                int deep, int rows) {
+#ifdef ENABLE_AVX
+  __m256i init = _mm256_loadu_si256((const __m256i *)bias);
+  __m256i acc0 = init, acc1 = init, acc2 = init, acc3 = init;
+  if (rows == SPARSE_ROW_TILE) {
+    for (int b = 0; b < block_num; ++b) {
+      const int8_t *src_a = a + deep_index[b];
+      __m256i w = _mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i *)(value + b * SPARSE_BLOCK)));
+      acc0 = _mm256_add_epi32(acc0, _mm256_mullo_epi32(_mm256_set1_epi32(src_a[0] - input_zp), w));
+      acc1 = _mm256_add_epi32(acc1, _mm256_mullo_epi32(_mm256_set1_epi32(src_a[deep] - input_zp), w));
+      acc2 = _mm256_add_epi32(acc2, _mm256_mullo_epi32(_mm256_set1_epi32(src_a[2 * deep] - input_zp), w));
+      acc3 = _mm256_add_epi32(acc3, _mm256_mullo_epi32(_mm256_set1_epi32(src_a[3 * deep] - input_zp), w));
+    }
+  } else {
+    for (int b = 0; b < block_num; ++b) {
+      __m256i w = _mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i *)(value + b * SPARSE_BLOCK)));
+      acc0 = _mm256_add_epi32(acc0, _mm256_mullo_epi32(_mm256_set1_epi32(a[deep_index[b]] - input_zp), w));
+    }
+  }
+  _mm256_storeu_si256((__m256i *)acc[0], acc0);
+  _mm256_storeu_si256((__m256i *)acc[1], acc1);
+  _mm256_storeu_si256((__m256i *)acc[2], acc2);
+  _mm256_storeu_si256((__m256i *)acc[3], acc3);
+#elif defined(ENABLE_ARM)
+  int32x4_t init_lo = vld1q_s32(bias);
+  int32x4_t init_hi = vld1q_s32(bias + C4NUM);
+  int32x4_t acc0_lo = init_lo, acc1_lo = init_lo, acc2_lo = init_lo, acc3_lo = init_lo;
+  int32x4_t acc0_hi = init_hi, acc1_hi = init_hi, acc2_hi = init_hi, acc3_hi = init_hi;
+  if (rows == SPARSE_ROW_TILE) {
+    for (int b = 0; b < block_num; ++b) {
+      const int8_t *src_a = a + deep_index[b];
+      int16x8_t w = vld1q_s16(value + b * SPARSE_BLOCK);
+      int16x4_t w_lo = vget_low_s16(w);
+      int16x4_t w_hi = vget_high_s16(w);
+      int16_t a0 = (int16_t)(src_a[0] - input_zp);
+      int16_t a1 = (int16_t)(src_a[deep] - input_zp);
+      int16_t a2 = (int16_t)(src_a[2 * deep] - input_zp);
+      int16_t a3 = (int16_t)(src_a[3 * deep] - input_zp);
+      acc0_lo = vmlal_n_s16(acc0_lo, w_lo, a0);
+      acc0_hi = vmlal_n_s16(acc0_hi, w_hi, a0);
+      acc1_lo = vmlal_n_s16(acc1_lo, w_lo, a1);
+      acc1_hi = vmlal_n_s16(acc1_hi, w_hi, a1);
+      acc2_lo = vmlal_n_s16(acc2_lo, w_lo, a2);
+      acc2_hi = vmlal_n_s16(acc2_hi, w_hi, a2);
+      acc3_lo = vmlal_n_s16(acc3_lo, w_lo, a3);
+      acc3_hi = vmlal_n_s16(acc3_hi, w_hi, a3);
+    }
+  } else {
+    for (int b = 0; b < block_num; ++b) {
+      int16x8_t w = vld1q_s16(value + b * SPARSE_BLOCK);
+      int16_t a0 = (int16_t)(a[deep_index[b]] - input_zp);
+      acc0_lo = vmlal_n_s16(acc0_lo, vget_low_s16(w), a0);
+      acc0_hi = vmlal_n_s16(acc0_hi, vget_high_s16(w), a0);
+    }
+  }
+  vst1q_s32(acc[0], acc0_lo);
+  vst1q_s32(acc[0] + C4NUM, acc0_hi);
+  vst1q_s32(acc[1], acc1_lo);
+  vst1q_s32(acc[1] + C4NUM, acc1_hi);
+  vst1q_s32(acc[2], acc2_lo);
+  vst1q_s32(acc[2] + C4NUM, acc2_hi);
+  vst1q_s32(acc[3], acc3_lo);
+  vst1q_s32(acc[3] + C4NUM, acc3_hi);
+#else
+  for (int r = 0; r < rows; ++r) {
+    memcpy(acc[r], bias, SPARSE_BLOCK * sizeof(int32_t));
+  }
+  for (int b = 0; b < block_num; ++b) {
+    const int16_t *w = value + b * SPARSE_BLOCK;
+    for (int r = 0; r < rows; ++r) {
+      int32_t src_a = a[r * deep + deep_index[b]] - input_zp;
+      for (int j = 0; j < SPARSE_BLOCK; ++j) {
+        acc[r][j] += src_a * w[j];
+      }
+    }
+  }
+#endif
+}
+
+void SparseMatMulInt8(const int8_t *a, const void *packed_b, int8_t *c, const int32_t *bias,
+                      const MatmulQuantParameter *quant_param, bool per_channel, int deep, int row, int col,
+                      int block_start, int block_end) {
+  int col_block = UP_DIV(col, SPARSE_BLOCK);
+  const int *block_offset = (const int *)packed_b;
+  const int *deep_index = block_offset + col_block + 1;
+  const int16_t *value = (const int16_t *)(deep_index + block_offset[col_block]);
+  int32_t input_zp = quant_param->input_.zp_;
+  block_end = MSMIN(block_end, col_block);
+  int32_t cur_bias[SPARSE_BLOCK];
+  int32_t acc[SPARSE_ROW_TILE][SPARSE_BLOCK];
+  for (int cb = block_start; cb < block_end; ++cb) {
+    int oc = cb * SPARSE_BLOCK;
+    int cur_oc = MSMIN(SPARSE_BLOCK, col - oc);
+    memset(cur_bias, 0, sizeof(cur_bias));
+    if (bias != NULL) {
+      memcpy(cur_bias, bias + oc, cur_oc * sizeof(int32_t));
+    }
+    int first = block_offset[cb];
+    int block_num = block_offset[cb + 1] - first;
+    int r = 0;
+    for (; r + SPARSE_ROW_TILE <= row; r += SPARSE_ROW_TILE) {
+      SparseBlockRowsInt8(a + r * deep, deep_index + first, value + first * SPARSE_BLOCK, block_num, cur_bias,
+                          input_zp, acc, deep, SPARSE_ROW_TILE);
+      for (int i = 0; i < SPARSE_ROW_TILE; ++i) {
+        StoreSparseBlockInt8(acc[i], c + (r + i) * col + oc, oc, cur_oc, quant_param, per_channel);
+      }
+    }
+    for (; r < row; ++r) {
+      SparseBlockRowsInt8(a + r * deep, deep_index + first, value + first * SPARSE_BLOCK, block_num, cur_bias,
+                          input_zp, acc, deep, 1);
+      StoreSparseBlockInt8(acc[0], c + r * col + oc, oc, cur_oc, quant_param, per_channel);
+    }
+  }
+}
@@ -0,0 +1,46 @@
+/**
+ * Copyright 2021 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MINDSPORE_NNACL_INT8_SPARSE_MATMUL_INT8_H_
+#define MINDSPORE_NNACL_INT8_SPARSE_MATMUL_INT8_H_
+
+#include <stddef.h>
+#include "nnacl/op_base.h"
+#include "nnacl/matmul_parameter.h"
+#include "nnacl/fp32/sparse_matmul_fp32.h"
+
+/* Block sparse int8 weight of shape [col, deep], blocked as the fp32 one. A block is zero when all its values equal
+ * the zero point of their output channel, the kept values are stored with the zero point taken off:
+ *   int     block_offset[UP_DIV(col, SPARSE_BLOCK) + 1]  first block of each column block
+ *   int     deep_index[block_num]
+ *   int16_t value[block_num][SPARSE_BLOCK]              zero padded past col */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+int BlockSparseNonzeroNumInt8(const int8_t *src, const int32_t *filter_zp, bool per_channel, int col, int deep);
+size_t BlockSparsePackSizeInt8(int col, int block_num);
+void PackBlockSparseInt8(const int8_t *src, const int32_t *filter_zp, bool per_channel, void *dst, int col, int deep);
+/* c[row, col] = requant((a - input_zp) * (b - filter_zp)^T + bias) for the column blocks in [block_start, block_end),
+ * the multipliers and shifts of quant_param are per output channel when per_channel is set */
+void SparseMatMulInt8(const int8_t *a, const void *packed_b, int8_t *c, const int32_t *bias,
+                      const MatmulQuantParameter *quant_param, bool per_channel, int deep, int row, int col,
+                      int block_start, int block_end);
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // MINDSPORE_NNACL_INT8_SPARSE_MATMUL_INT8_H_
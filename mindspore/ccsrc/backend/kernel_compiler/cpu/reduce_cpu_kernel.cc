@@ -131,7 +131,8 @@ bool ReduceCPUKernel<T>::Launch(const std::vector<kernel::AddressPtr> &inputs,
         }
       }
     };
-    CPUKernelUtils::ParallelFor(task, output_size);
+    // every output reduces stride inputs
+    CPUKernelUtils::ParallelFor(task, output_size, std::max<size_t>(kParallelGrainSize / stride, 1));
   }
   return true;
 }
@@ -19,13 +19,23 @@
 #include <vector>
 #include <memory>
 #include <unordered_map>
+#include <iterator>
 #include <algorithm>
 #include <utility>
 #include "backend/kernel_compiler/cpu/cpu_kernel.h"
 #include "backend/kernel_compiler/cpu/cpu_kernel_factory.h"
+#include "nnacl/op_base.h"
+#if defined(ENABLE_SSE) || defined(ENABLE_ARM)
+#include "nnacl/intrinsics/ms_simd_instructions.h"
+#endif
 #include "common/thread_pool.h"
 namespace mindspore {
 namespace kernel {
+// Unique indices each bucket is sized for, so that its hash table and reduced rows stay in the L2 cache.
+constexpr size_t kReduceBucketUniqueSize = 8192;
+constexpr size_t kMaxReduceBucketNumPerThread = 64;
+// Indices sampled to estimate the cardinality of a gradient.
+constexpr size_t kCardinalitySampleSize = 1024;
 template <typename T>
 struct SparseGradient {
   float *value_{nullptr};
@@ -83,6 +93,7 @@ struct MultiThreadReduceSparseGradientParam {
   size_t value_stride_{0};
   size_t thread_num_{0};
   bool use_sort_reduce_{false};
+  size_t bucket_num_{0};
 };
 
 class SparseOptimizerCPUKernel : public CPUKernel {
@@ -98,9 +109,15 @@ class SparseOptimizerCPUKernel : public CPUKernel {
     if (param.input_grad_->indices_size_ < thread_num) {
       thread_num = param.input_grad_->indices_size_;
     }
+    // The indices are radix partitioned by their low bits into buckets, high cardinality gradients get more buckets
+    // than threads so that each bucket is reduced in cache.
+    size_t bucket_num = thread_num;
+    if (!param.use_sort_reduce_) {
+      bucket_num = CalculateBucketNum(param, thread_num);
+    }
     MultiThreadReduceSparseGradientParam<T> multi_thread_param(
       {param.input_grad_, param.workspace_grad_, param.output_grad_, param.max_index_, param.value_stride_, thread_num,
-       param.use_sort_reduce_});
+       param.use_sort_reduce_, bucket_num});
     std::vector<std::shared_ptr<SparseGradient<T>>> segments;
     std::vector<std::shared_ptr<std::vector<size_t>>> segment_bucket_sizes;
     SplitAndCalculateSegmentBucketSize(multi_thread_param, &segments, &segment_bucket_sizes);
@@ -137,6 +154,31 @@ class SparseOptimizerCPUKernel : public CPUKernel {
   }
 
  private:
+  template <typename T>
+  static size_t CalculateBucketNum(const ReduceSparseGradientParam<T> &param, size_t thread_num) {
+    auto input_grad = param.input_grad_;
+    MS_EXCEPTION_IF_NULL(input_grad->indices_);
+    size_t indices_size = input_grad->indices_size_;
+    if (thread_num == 0 || indices_size <= thread_num * kReduceBucketUniqueSize) {
+      return thread_num;
+    }
+    size_t step = std::max<size_t>(indices_size / kCardinalitySampleSize, 1);
+    std::vector<T> sample;
+    sample.reserve(kCardinalitySampleSize + 1);
+    for (size_t i = 0; i < indices_size; i += step) {
+      sample.push_back(input_grad->indices_[i]);
+    }
+    std::sort(sample.begin(), sample.end());
+    size_t sample_unique = LongToSize(std::distance(sample.begin(), std::unique(sample.begin(), sample.end())));
+    size_t unique_size = std::min(indices_size / sample.size() * sample_unique, param.max_index_);
+    size_t bucket_num_per_thread = (unique_size + thread_num * kReduceBucketUniqueSize - 1) /
+                                   (thread_num * kReduceBucketUniqueSize);
+    bucket_num_per_thread = std::min(std::max<size_t>(bucket_num_per_thread, 1), kMaxReduceBucketNumPerThread);
+    MS_LOG(DEBUG) << "Estimated unique indices " << unique_size << " of " << indices_size << ", buckets "
+                  << thread_num * bucket_num_per_thread;
+    return thread_num * bucket_num_per_thread;
+  }
+
   template <typename T>
   static void CalculateEachBucketSize(const std::shared_ptr<SparseGradient<T>> &sparse_grad, size_t max_index,
                                       std::vector<size_t> *each_bucket_size) {
@@ -176,7 +218,7 @@ class SparseOptimizerCPUKernel : public CPUKernel {
 
     size_t current_indices_offset = 0;
     for (size_t i = 0; i < param.thread_num_; ++i) {
-      segment_bucket_sizes.emplace_back(std::make_shared<std::vector<size_t>>(param.thread_num_, 0));
+      segment_bucket_sizes.emplace_back(std::make_shared<std::vector<size_t>>(param.bucket_num_, 0));
       size_t indices_size = thread_indices_size;
       if (i < left_indices_size) {
         indices_size += 1;
@@ -202,11 +244,11 @@ class SparseOptimizerCPUKernel : public CPUKernel {
     MS_LOG(DEBUG) << "Start";
     MS_EXCEPTION_IF_NULL(segment);
     MS_EXCEPTION_IF_NULL(segment->indices_);
-    std::vector<size_t> bucket_data_num(param.thread_num_, 0);
+    std::vector<size_t> bucket_data_num(param.bucket_num_, 0);
     for (size_t i = 0; i < segment->indices_size_; ++i) {
       T index = segment->indices_[i];
       if (index >= 0 && LongToSize(index) < param.max_index_) {
-        auto bucket_id = index % param.thread_num_;
+        auto bucket_id = index % param.bucket_num_;
         auto bucket_index = bucket_data_num[bucket_id];
         buckets[bucket_id]->indices_[bucket_index] = index;
         buckets[bucket_id]->global_indices_[bucket_index] = bucket_offset + i;
@@ -228,17 +270,18 @@ class SparseOptimizerCPUKernel : public CPUKernel {
     MS_EXCEPTION_IF_NULL(buckets_ptr);
     auto &buckets = *buckets_ptr;
     size_t thread_num = param.thread_num_;
+    size_t bucket_num = param.bucket_num_;
     if (thread_num != segment_bucket_sizes.size()) {
       MS_EXCEPTION(ArgumentError) << "Input param thread num not equal to segment size!";
     }
-    std::vector<size_t> bucket_data_size(thread_num, 0);
+    std::vector<size_t> bucket_data_size(bucket_num, 0);
     for (size_t i = 0; i < thread_num; ++i) {
-      for (size_t j = 0; j < thread_num; ++j) {
+      for (size_t j = 0; j < bucket_num; ++j) {
         bucket_data_size[j] += segment_bucket_sizes[i]->at(j);
       }
     }
     size_t current_indices_offset = 0;
-    for (size_t i = 0; i < thread_num; ++i) {
+    for (size_t i = 0; i < bucket_num; ++i) {
       buckets.emplace_back(std::make_shared<BucketSparseGradient<T>>());
       buckets[i]->value_ = param.output_grad_->value_ + current_indices_offset * param.value_stride_;
       buckets[i]->indices_ = param.output_grad_->indices_ + current_indices_offset;
@@ -246,11 +289,11 @@ class SparseOptimizerCPUKernel : public CPUKernel {
       buckets[i]->indices_size_ = bucket_data_size[i];
       current_indices_offset += bucket_data_size[i];
     }
-    std::vector<size_t> tmp_bucket_data_size(thread_num, 0);
+    std::vector<size_t> tmp_bucket_data_size(bucket_num, 0);
     std::vector<std::vector<std::shared_ptr<BucketSparseGradient<T>>>> each_thread_buckets;
     for (size_t i = 0; i < thread_num; ++i) {
       std::vector<std::shared_ptr<BucketSparseGradient<T>>> thread_buckets;
-      for (size_t j = 0; j < thread_num; ++j) {
+      for (size_t j = 0; j < bucket_num; ++j) {
         thread_buckets.emplace_back(std::make_shared<BucketSparseGradient<T>>());
         thread_buckets[j]->indices_ = buckets[j]->indices_ + tmp_bucket_data_size[j];
         thread_buckets[j]->global_indices_ = buckets[j]->global_indices_ + tmp_bucket_data_size[j];
@@ -315,16 +358,34 @@ class SparseOptimizerCPUKernel : public CPUKernel {
           MS_LOG(EXCEPTION) << "Failed to copy data!";
         }
       } else {
-        for (size_t j = 0; j < param.value_stride_; ++j) {
-          reduced_bucket->value_[value_offset + j] += global_value[global_value_offset + j];
-        }
+        AccumulateRow(reduced_bucket->value_ + value_offset, global_value + global_value_offset, param.value_stride_);
       }
       last_index = index;
     }
-    reduced_bucket->indices_size_ = unique_indices_size;
+    reduced_bucket->indices_size_ = sorted_indices.empty() ? 0 : unique_indices_size + 1;
     MS_LOG(DEBUG) << "End";
   }
 
+  static void AccumulateRow(float *dst, const float *src, size_t stride) {
+    size_t i = 0;
+#ifdef ENABLE_AVX
+    for (; i + C8NUM <= stride; i += C8NUM) {
+      MS_ST256_F32(dst + i, MS_ADD256_F32(MS_LD256_F32(dst + i), MS_LD256_F32(src + i)));
+    }
+#endif
+#if defined(ENABLE_ARM) || defined(ENABLE_SSE)
+    for (; i + C4NUM <= stride; i += C4NUM) {
+      MS_STQ_F32(dst + i, MS_ADDQ_F32(MS_LDQ_F32(dst + i), MS_LDQ_F32(src + i)));
+    }
+#endif
+    for (; i < stride; ++i) {
+      dst[i] += src[i];
+    }
+  }
+
+  // Open addressing table from the index to the position of its reduced row, linear probing over a power of two
+  // capacity of at least twice the bucket size. The bucket holds indices of the same low bits, so the slot is taken
+  // from the high bits of a multiplicative hash.
   template <typename T>
   static void ReduceBucketSparseGradient(const MultiThreadReduceSparseGradientParam<T> &param,
                                          const std::shared_ptr<BucketSparseGradient<T>> &bucket,
@@ -337,18 +398,29 @@ class SparseOptimizerCPUKernel : public CPUKernel {
     MS_EXCEPTION_IF_NULL(reduced_bucket->value_);
     MS_EXCEPTION_IF_NULL(reduced_bucket->indices_);
 
+    const size_t empty_slot = SIZE_MAX;
+    size_t capacity_bits = 1;
+    while ((static_cast<size_t>(1) << capacity_bits) < 2 * bucket->indices_size_) {
+      capacity_bits++;
+    }
+    size_t mask = (static_cast<size_t>(1) << capacity_bits) - 1;
+    std::vector<std::pair<T, size_t>> slots(mask + 1, std::pair<T, size_t>(0, empty_slot));
+
     float *global_value = param.input_grad_->value_;
-    std::unordered_map<T, size_t> index_map;
     size_t unique_indices_size = 0;
     size_t max_length = reduced_bucket->indices_size_ * param.value_stride_;
     for (size_t i = 0; i < bucket->indices_size_; ++i) {
       T index = bucket->indices_[i];
       T global_index = bucket->global_indices_[i];
-      auto iter = index_map.find(index);
-      if (iter == index_map.end()) {
+      uint64_t hash = static_cast<uint64_t>(index) * 0x9E3779B97F4A7C15ULL;
+      size_t slot = static_cast<size_t>(hash >> (64 - capacity_bits));
+      while (slots[slot].second != empty_slot && slots[slot].first != index) {
+        slot = (slot + 1) & mask;
+      }
+      if (slots[slot].second == empty_slot) {
         reduced_bucket->indices_[unique_indices_size] = index;
         size_t start_index = unique_indices_size * param.value_stride_;
-        index_map[index] = start_index;
+        slots[slot] = std::pair<T, size_t>(index, start_index);
         auto ret_code =
           memcpy_s(reduced_bucket->value_ + start_index, (max_length - start_index) * sizeof(float),
                    global_value + global_index * param.value_stride_, param.value_stride_ * sizeof(float));
@@ -357,11 +429,8 @@ class SparseOptimizerCPUKernel : public CPUKernel {
         }
         unique_indices_size++;
       } else {
-        size_t start_index = iter->second;
-        size_t end_index = start_index + param.value_stride_;
-        for (size_t j = start_index, k = global_index * param.value_stride_; j < end_index; ++j, ++k) {
-          reduced_bucket->value_[j] += global_value[k];
-        }
+        AccumulateRow(reduced_bucket->value_ + slots[slot].second, global_value + global_index * param.value_stride_,
+                      param.value_stride_);
       }
     }
     reduced_bucket->indices_size_ = unique_indices_size;
@@ -0,0 +1,108 @@
+/**
+ * Copyright 2021 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "backend/optimizer/cpu/embedding_lookup_segment_reduce_fusion.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+#include "backend/kernel_compiler/kernel_build_info.h"
+#include "backend/session/anf_runtime_algorithm.h"
+#include "backend/optimizer/common/helper.h"
+#include "utils/utils.h"
+
+namespace mindspore {
+namespace opt {
+namespace {
+// the float32 table InsertCastCPU made for a float16 parameter, the fused kernel reads float16 itself
+AnfNodePtr GetFloat16Table(const AnfNodePtr &param) {
+  if (!AnfAlgo::CheckPrimitiveType(param, prim::kPrimCast)) {
+    return nullptr;
+  }
+  auto cast = param->cast<CNodePtr>();
+  if (!AnfAlgo::HasNodeAttr(kIsBackendCast, cast) || AnfAlgo::GetInputDeviceDataType(cast, 0) != kNumberTypeFloat16) {
+    return nullptr;
+  }
+  return AnfAlgo::GetInputNode(cast, 0);
+}
+
+kernel::KernelBuildInfoPtr GenerateKernelBuildInfo(const std::vector<TypeId> &inputs_type, TypeId output_type) {
+  kernel::KernelBuildInfo::KernelBuildInfoBuilder builder;
+  builder.SetInputsDeviceType(inputs_type);
+  builder.SetInputsFormat(std::vector<std::string>(inputs_type.size(), kOpFormat_DEFAULT));
+  builder.SetOutputsDeviceType({output_type});
+  builder.SetOutputsFormat({kOpFormat_DEFAULT});
+  return builder.Build();
+}
+}  // namespace
+
+const BaseRef EmbeddingLookupSegmentReduceFusion::DefinePattern() const {
+  VectorRef lookup = VectorRef({prim::kPrimEmbeddingLookup, param_, indices_});
+  return VectorRef({prim::kPrimUnsortedSegmentSum, lookup, segment_ids_});
+}
+
+const AnfNodePtr EmbeddingLookupSegmentReduceFusion::Process(const FuncGraphPtr &graph, const AnfNodePtr &node,
+                                                             const EquivPtr &equiv) const {
+  MS_EXCEPTION_IF_NULL(graph);
+  MS_EXCEPTION_IF_NULL(node);
+  MS_EXCEPTION_IF_NULL(equiv);
+  auto param = utils::cast<AnfNodePtr>((*equiv)[param_]);
+  auto indices = utils::cast<AnfNodePtr>((*equiv)[indices_]);
+  auto segment_ids = utils::cast<AnfNodePtr>((*equiv)[segment_ids_]);
+  auto segment_sum = node->cast<CNodePtr>();
+  MS_EXCEPTION_IF_NULL(segment_sum);
+  auto lookup = AnfAlgo::GetInputNode(segment_sum, 0);
+  MS_EXCEPTION_IF_NULL(lookup);
+  if (GetRealNodeUsedList(graph, lookup)->size() > 1 || AnfAlgo::IsDynamicShape(lookup) ||
+      AnfAlgo::IsDynamicShape(segment_sum)) {
+    return nullptr;
+  }
+  // UnsortedSegmentSum also takes segment_ids covering only the leading dims of the lookup, the fused kernel wants
+  // one segment id per lookup
+  if (AnfAlgo::GetPrevNodeOutputInferShape(lookup, 1) != AnfAlgo::GetPrevNodeOutputInferShape(segment_sum, 1)) {
+    return nullptr;
+  }
+  auto indices_type = AnfAlgo::GetInputDeviceDataType(lookup, 1);
+  if (indices_type != AnfAlgo::GetInputDeviceDataType(segment_sum, 1)) {
+    return nullptr;
+  }
+  auto table_type = AnfAlgo::GetInputDeviceDataType(lookup, 0);
+  auto output_type = AnfAlgo::GetOutputDeviceDataType(segment_sum, 0);
+  if (table_type != kNumberTypeFloat32 || output_type != kNumberTypeFloat32) {
+    return nullptr;
+  }
+  auto float16_table = GetFloat16Table(param);
+  if (float16_table != nullptr) {
+    param = float16_table;
+    table_type = kNumberTypeFloat16;
+  }
+
+  auto prim = std::make_shared<Primitive>(kEmbeddingLookupSegmentReduceOpName);
+  std::vector<AnfNodePtr> inputs = {NewValueNode(prim), param, indices, segment_ids};
+  auto fused = graph->NewCNode(inputs);
+  MS_EXCEPTION_IF_NULL(fused);
+  AnfAlgo::SetOutputInferTypeAndShape({AnfAlgo::GetOutputInferDataType(segment_sum, 0)},
+                                      {AnfAlgo::GetOutputInferShape(segment_sum, 0)}, fused.get());
+  fused->set_scope(segment_sum->scope());
+  if (AnfAlgo::HasNodeAttr(kAttrOffset, lookup->cast<CNodePtr>())) {
+    AnfAlgo::CopyNodeAttr(kAttrOffset, lookup, fused);
+  }
+  AnfAlgo::SetSelectKernelBuildInfo(GenerateKernelBuildInfo({table_type, indices_type, indices_type}, output_type),
+                                    fused.get());
+  return fused;
+}
+}  // namespace opt
+}  // namespace mindspore
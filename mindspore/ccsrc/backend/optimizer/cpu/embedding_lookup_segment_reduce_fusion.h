@@ -0,0 +1,49 @@
+/**
+ * Copyright 2021 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MINDSPORE_CCSRC_BACKEND_OPTIMIZER_CPU_EMBEDDING_LOOKUP_SEGMENT_REDUCE_FUSION_H
+#define MINDSPORE_CCSRC_BACKEND_OPTIMIZER_CPU_EMBEDDING_LOOKUP_SEGMENT_REDUCE_FUSION_H
+
+#include <memory>
+#include "backend/optimizer/common/optimizer.h"
+#include "ir/anf.h"
+
+namespace mindspore {
+namespace opt {
+// UnsortedSegmentSum(EmbeddingLookup(param, indices), segment_ids) -> EmbeddingLookupSegmentReduce(param, indices,
+// segment_ids), the bags are reduced while the rows are gathered. Runs after InsertCastCPU, a float16 table is read
+// directly instead of through its backend cast to float32.
+class EmbeddingLookupSegmentReduceFusion : public PatternProcessPass {
+ public:
+  explicit EmbeddingLookupSegmentReduceFusion(bool multigraph = true)
+      : PatternProcessPass("embedding_lookup_segment_reduce_fusion", multigraph) {
+    param_ = std::make_shared<Var>();
+    indices_ = std::make_shared<Var>();
+    segment_ids_ = std::make_shared<Var>();
+  }
+  ~EmbeddingLookupSegmentReduceFusion() override = default;
+  const BaseRef DefinePattern() const override;
+  const AnfNodePtr Process(const FuncGraphPtr &, const AnfNodePtr &, const EquivPtr &) const override;
+
+ private:
+  VarPtr param_;
+  VarPtr indices_;
+  VarPtr segment_ids_;
+};
+}  // namespace opt
+}  // namespace mindspore
+
+#endif  // MINDSPORE_CCSRC_BACKEND_OPTIMIZER_CPU_EMBEDDING_LOOKUP_SEGMENT_REDUCE_FUSION_H
@@ -126,6 +126,9 @@ bool Somas::Allocate(const session::KernelGraph *graph) {
 
 bool Somas::CalcSomasModelHash(const session::KernelGraph *graph) {
   auto model_str = SomasInfo(true);
+  if (parallel_execution_) {
+    model_str += "\nparallel execution\n";
+  }
   hash_id_ = std::to_string(std::hash<std::string>()(model_str));
   MS_LOG(INFO) << "Graph " << graph->graph_id() << "'s SOMAS Model hash id is " << hash_id_;
   std::string filename =
@@ -367,6 +370,7 @@ bool Somas::InitSomasTensors(const session::KernelGraph *graph) {
   UnReuseNodeProcess(graph);
   GenContiguousList(graph);
   GetNextOutputProcess(graph);
+  GraphOutputProcess(graph);
 
   if (tensors_list_.empty()) {
     MS_LOG(INFO) << "No Tensor from graph " << graph->graph_id();
@@ -464,7 +468,9 @@ void Somas::InitSomasOutputAndWorkspaceTensors(const session::KernelGraph *graph
       tensor->lifetime_.start_ = node->GetId();
       tensor->lifetime_.end_ = (nodes.size() > 1) ? nodes.back()->GetId() : node->GetId();
       tensor->type_ = kOutputOnly;
-      if (AnfAlgo::OutputAddrExist(kernel, index)) {
+      // the actor runtime creates the addresses before planning, only the ones holding memory are skipped then
+      if (AnfAlgo::OutputAddrExist(kernel, index) &&
+          (!parallel_execution_ || AnfAlgo::GetOutputAddr(kernel, index, false)->GetPtr() != nullptr)) {
         tensor->aligned_size_ = 0;
       }
 
@@ -488,7 +494,8 @@ void Somas::InitSomasOutputAndWorkspaceTensors(const session::KernelGraph *graph
       tensor->type_ = kWorkspace;
       tensor->lifetime_.start_ = node->GetId();
       tensor->lifetime_.end_ = (nodes.size() > 1) ? nodes.back()->GetId() : node->GetId();
-      if (AnfAlgo::WorkspaceAddrExist(kernel, index)) {
+      if (AnfAlgo::WorkspaceAddrExist(kernel, index) &&
+          (!parallel_execution_ || AnfAlgo::GetWorkspaceAddr(kernel, index)->GetPtr() != nullptr)) {
         tensor->aligned_size_ = 0;
       }
       tensors_list_.push_back(tensor);
@@ -727,6 +734,29 @@ void Somas::GetNextOutputProcess(const session::KernelGraph *graph) {
   MS_LOG(INFO) << "Special Tensor total size: GetNext Output " << total_size;
 }
 
+void Somas::GraphOutputProcess(const session::KernelGraph *graph) {
+  MS_EXCEPTION_IF_NULL(graph);
+  if (!parallel_execution_) {
+    return;
+  }
+  size_t total_size = 0;
+  auto outputs = AnfAlgo::GetAllOutput(graph->output(), {prim::kPrimTupleGetItem});
+  for (const auto &output : outputs) {
+    auto output_with_index = AnfAlgo::VisitKernelWithReturnType(output, 0, true);
+    auto iter = nodes_map_.find(output_with_index.first.get());
+    if (iter == nodes_map_.end()) {
+      continue;
+    }
+    auto &node = iter->second.at(0);
+    if (output_with_index.second < node->output_tensors_.size()) {
+      auto &tensor = node->output_tensors_[output_with_index.second];
+      total_size += tensor->GetAlignedSize();
+      tensor->lifelong_value_ = kLifeLongGraphAll;
+    }
+  }
+  MS_LOG(INFO) << "Special Tensor total size: Graph Output " << total_size;
+}
+
 void Somas::IndependentNodeOutputProcess(const session::KernelGraph *graph) {
   MS_EXCEPTION_IF_NULL(graph);
   auto kernel_cnodes = graph->execution_order();
@@ -1010,11 +1040,12 @@ void Somas::ComputeConflictPairs() {
 }
 
 void Somas::UpdateTensorDestinations() {
-  // Loop to add edges within each stream (node order within stream)
+  // Loop to add edges within each stream (node order within stream), there is no such order when the kernels of a
+  // stream run concurrently and only the data edges added with the inputs are left
   for (const auto &stream : streams_list_) {
     auto &nodes = stream->nodes_;
     std::sort(nodes.begin(), nodes.end(), NodeSort);
-    for (size_t i = 1; i < nodes.size(); i++) {
+    for (size_t i = 1; i < nodes.size() && !parallel_execution_; i++) {
       const auto &previous_node = nodes[i - 1];
       const auto &current_node = nodes[i];
       current_node->ancestor_nodes_.insert(previous_node);
@@ -1082,6 +1113,15 @@ void Somas::ComputeOneTensorConflicts(const std::shared_ptr<SomasTensor> &calc_t
                                       const std::vector<SomasTensorPtr> &all_tensors_list,
                                       const vector<DynamicBitSet> &nodes_dependency,
                                       std::vector<DynamicBitSet> *tensor_relation) const {
+  // the last consumer in each stream stands for the others when the stream runs in order, otherwise every consumer
+  // is checked
+  std::vector<SomasNodePtr> consumers;
+  if (parallel_execution_) {
+    consumers.assign(calc_tensor->destinations_.begin(), calc_tensor->destinations_.end());
+  } else {
+    (void)std::transform(calc_tensor->max_destinations_.begin(), calc_tensor->max_destinations_.end(),
+                         std::back_inserter(consumers), [](const auto &dst_map) { return dst_map.second; });
+  }
   for (size_t j = 0; j < all_tensors_list.size(); j++) {
     auto target_tensor = all_tensors_list[j];
     if (calc_tensor == target_tensor || target_tensor->IsLifelong() || target_tensor->IsRefOverlap() ||
@@ -1100,8 +1140,7 @@ void Somas::ComputeOneTensorConflicts(const std::shared_ptr<SomasTensor> &calc_t
 
     bool reuse = true;
     // check calc_tensor's all consumers is target_tensor's source node's dependency or not
-    for (const auto &dst_map : calc_tensor->max_destinations_) {
-      const auto &dst_node = dst_map.second;
+    for (const auto &dst_node : consumers) {
       if (nodes_dependency[target_src_node].IsBitTrue(dst_node->GetId()) == false) {
         // calc_tensor's consumer is not in target_tensor's source node's dependency, not sure this consumer is done or
         // not when target_tensor produced
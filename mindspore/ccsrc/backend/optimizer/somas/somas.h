@@ -45,6 +45,9 @@ class Somas {
 
   bool Allocate(const session::KernelGraph *graph);
   size_t GetTotalMemSize() { return mem_offset_; }
+  // Kernels of one stream may run concurrently (the actor runtime): memory is only reused along data dependencies
+  // and the graph outputs are kept through the whole step.
+  void set_parallel_execution(bool parallel_execution) { parallel_execution_ = parallel_execution; }
   void set_mem_base_addr(uint8_t *mem_base_addr) { mem_base_addr_ = mem_base_addr; }
   uint8_t *GetNodeOutputPtr(const AnfNodePtr &node, size_t index) const;
   uint8_t *GetNodeWorkSpacePtr(const AnfNodePtr &node, size_t index) const;
@@ -92,6 +95,8 @@ class Somas {
   // Memory base addr
   uint8_t *mem_base_addr_{nullptr};
 
+  bool parallel_execution_{false};
+
   // Save debug info
   bool save_graphs_{false};
   std::string save_graphs_path_;
@@ -112,6 +117,7 @@ class Somas {
   void InitSomasOutputAndWorkspaceTensors(const session::KernelGraph *graph);
   void InitSomasInputTensors(const session::KernelGraph *graph);
   void GetNextOutputProcess(const session::KernelGraph *graph);
+  void GraphOutputProcess(const session::KernelGraph *graph);
   void IndependentNodeOutputProcess(const session::KernelGraph *graph);
   void SummaryInputProcess(const session::KernelGraph *graph);
   void RefNodeProcess(const session::KernelGraph *graph);
@@ -28,6 +28,7 @@
 #include "backend/optimizer/common/optimizer.h"
 #include "backend/optimizer/common/pass_manager.h"
 #include "backend/optimizer/cpu/insert_cast_cpu.h"
+#include "backend/optimizer/cpu/embedding_lookup_segment_reduce_fusion.h"
 #include "backend/optimizer/cpu/insert_format_transform_op.h"
 #include "backend/optimizer/pass/replace_node_by_proxy.h"
 #include "backend/optimizer/pass/erase_visit_attr.h"
@@ -89,6 +90,7 @@ void CPUSession::Optimize(const std::shared_ptr<KernelGraph> &kernel_graph) {
 #endif
   pm->AddPass(std::make_shared<opt::InsertCastCPU>());
   MS_LOG(INFO) << "insert cast pass";
+  pm->AddPass(std::make_shared<opt::EmbeddingLookupSegmentReduceFusion>());
   pm->AddPass(std::make_shared<opt::InsertFormatTransformOpCPU>("insert_format_transform_op_cpu"));
   pm->AddPass(std::make_shared<opt::EraseVisitAttr>());
 
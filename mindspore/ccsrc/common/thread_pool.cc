@@ -16,6 +16,7 @@
 
 #include "common/thread_pool.h"
 #include <algorithm>
+#include <chrono>
 #include <exception>
 #include "utils/log_adapter.h"
 #include "utils/convert_utils_base.h"
@@ -27,6 +28,33 @@ namespace common {
 const size_t kDeviceNum = 8;
 #endif
 const size_t kMaxThreadNum = 23;
+// blocks of a ParallelFor per thread, more blocks balance better and cost more scheduling
+const size_t kBlocksPerThread = 4;
+constexpr auto kHelpInterval = std::chrono::microseconds(100);
+
+namespace {
+// the pool and deque of the worker running on this thread, null on threads outside the pool
+thread_local ThreadPool *tls_pool = nullptr;
+thread_local size_t tls_worker_index = 0;
+// nesting depth of SyncRun and ParallelFor calls on this thread
+thread_local size_t tls_run_depth = 0;
+
+// Shared hold of the pool by the outermost call of a thread. Workers run tasks of calls which already hold it, so
+// neither they nor nested calls take it again, a recursive shared lock deadlocks once a resize is waiting.
+class RunGuard {
+ public:
+  RunGuard(const ThreadPool *pool, std::shared_mutex *mtx) {
+    if (tls_pool != pool && tls_run_depth == 0) {
+      lock_ = std::shared_lock<std::shared_mutex>(*mtx);
+    }
+    ++tls_run_depth;
+  }
+  ~RunGuard() { --tls_run_depth; }
+
+ private:
+  std::shared_lock<std::shared_mutex> lock_;
+};
+}  // namespace
 
 ThreadPool::ThreadPool() {
   size_t process_core_num = std::thread::hardware_concurrency() - 1;
@@ -44,63 +72,181 @@ ThreadPool::ThreadPool() {
   if (max_thread_num_ > kMaxThreadNum) {
     max_thread_num_ = kMaxThreadNum;
   }
+  for (size_t i = 0; i < max_thread_num_; ++i) {
+    workers_.emplace_back(std::make_unique<Worker>());
+  }
+}
+
+void ThreadPool::StartWorkers() {
+  std::lock_guard<std::mutex> sync_run_lock(pool_mtx_);
+  if (started_) {
+    return;
+  }
+  exit_run_ = false;
+  for (size_t i = 0; i < max_thread_num_; ++i) {
+    sync_run_threads_.emplace_back(std::thread(&ThreadPool::WorkerLoop, this, i));
+  }
+  started_ = true;
 }
 
-void ThreadPool::SyncRunLoop() {
+void ThreadPool::WorkerLoop(size_t index) {
+  tls_pool = this;
+  tls_worker_index = index;
   while (true) {
-    Task task;
-    {
-      std::unique_lock<std::mutex> lock(task_mutex_);
-      task_cond_var_.wait(lock, [this] { return !task_queue_.empty() || exit_run_; });
-      if (exit_run_) {
-        return;
-      }
-      task = task_queue_.front();
-      task_queue_.pop();
+    PoolTask task;
+    if (PopTask(&task)) {
+      RunTask(task);
+      continue;
+    }
+    std::unique_lock<std::mutex> lock(wake_mtx_);
+    wake_cond_var_.wait(lock, [this] { return queued_num_ > 0 || exit_run_; });
+    if (exit_run_) {
+      return;
     }
-    try {
-      task();
-    } catch (std::exception &e) {
-      MsException::Instance().SetException();
+  }
+}
+
+void ThreadPool::PushTasks(const std::vector<Task> &tasks, TaskGroup *group) {
+  if (tls_pool == this) {
+    // nested call, the tasks stay hot in the cache of this worker unless somebody steals them
+    auto &worker = workers_[tls_worker_index];
+    std::lock_guard<std::mutex> lock(worker->mtx);
+    for (auto &task : tasks) {
+      worker->tasks.push_back({&task, group});
     }
-    {
-      std::unique_lock<std::mutex> task_lock(task_mutex_);
-      task_finished_count_ = task_finished_count_ + 1;
+    queued_num_ += tasks.size();
+  } else {
+    size_t worker_num = workers_.size();
+    size_t start = next_worker_.fetch_add(1);
+    for (size_t i = 0; i < tasks.size(); ++i) {
+      auto &worker = workers_[(start + i) % worker_num];
+      std::lock_guard<std::mutex> lock(worker->mtx);
+      worker->tasks.push_back({&tasks[i], group});
+      ++queued_num_;
     }
-    finished_cond_var_.notify_one();
+  }
+  {
+    std::lock_guard<std::mutex> lock(wake_mtx_);
+  }
+  wake_cond_var_.notify_all();
+}
+
+bool ThreadPool::PopTask(PoolTask *task) {
+  size_t worker_num = workers_.size();
+  size_t start;
+  if (tls_pool == this) {
+    auto &worker = workers_[tls_worker_index];
+    std::lock_guard<std::mutex> lock(worker->mtx);
+    if (!worker->tasks.empty()) {
+      *task = worker->tasks.back();
+      worker->tasks.pop_back();
+      --queued_num_;
+      return true;
+    }
+    start = tls_worker_index + 1;
+  } else {
+    start = next_worker_.fetch_add(1);
+  }
+  for (size_t i = 0; i < worker_num && queued_num_ > 0; ++i) {
+    auto &victim = workers_[(start + i) % worker_num];
+    std::lock_guard<std::mutex> lock(victim->mtx);
+    if (!victim->tasks.empty()) {
+      *task = victim->tasks.front();
+      victim->tasks.pop_front();
+      --queued_num_;
+      return true;
+    }
+  }
+  return false;
+}
+
+void ThreadPool::RunTask(const PoolTask &task) {
+  int ret = FAIL;
+  try {
+    ret = (*task.task)();
+  } catch (std::exception &e) {
+    MsException::Instance().SetException();
+  }
+  auto group = task.group;
+  if (ret != SUCCESS) {
+    group->failed = true;
+  }
+  // the waiter may destroy the group as soon as it sees zero, it takes the lock before it does
+  std::lock_guard<std::mutex> lock(group->mtx);
+  if (--group->pending == 0) {
+    group->cond.notify_all();
   }
 }
 
 bool ThreadPool::SyncRun(const std::vector<Task> &tasks) {
+  if (tasks.empty()) {
+    return true;
+  }
+  RunGuard guard(this, &resize_mtx_);
   if (tasks.size() == 1) {
     auto ret = tasks[0]();
     return ret == SUCCESS;
   }
-  std::unique_lock<std::mutex> lock(pool_mtx_);
-  exit_run_ = false;
-  size_t task_num = tasks.size();
-  size_t thread_num = sync_run_threads_.size();
-  if (thread_num < max_thread_num_ && thread_num < task_num) {
-    auto new_thread_num = max_thread_num_;
-    if (task_num < max_thread_num_) {
-      new_thread_num = task_num;
-    }
-    for (size_t i = thread_num; i < new_thread_num; ++i) {
-      sync_run_threads_.emplace_back(std::thread(&ThreadPool::SyncRunLoop, this));
+  if (!started_) {
+    StartWorkers();
+  }
+  TaskGroup group;
+  group.pending = tasks.size();
+  PushTasks(tasks, &group);
+  // help instead of blocking, which is what keeps nested and concurrent calls from starving the workers
+  while (group.pending > 0) {
+    PoolTask task;
+    if (PopTask(&task)) {
+      RunTask(task);
+      continue;
     }
+    // the rest of the group is running on other threads, recheck now and then for newly pushed work
+    std::unique_lock<std::mutex> lock(group.mtx);
+    group.cond.wait_for(lock, kHelpInterval, [&group] { return group.pending == 0; });
   }
+  std::lock_guard<std::mutex> lock(group.mtx);
+  return !group.failed;
+}
 
-  for (auto &task : tasks) {
-    std::lock_guard<std::mutex> task_lock(task_mutex_);
-    task_queue_.push(task);
-    task_cond_var_.notify_one();
+bool ThreadPool::ParallelFor(const ParallelTask &task, size_t count, size_t grain_size) {
+  if (count == 0) {
+    return true;
   }
-  {
-    std::unique_lock<std::mutex> task_lock(task_mutex_);
-    finished_cond_var_.wait(task_lock, [this, task_num] { return task_num == task_finished_count_; });
-    task_finished_count_ = 0;
+  RunGuard guard(this, &resize_mtx_);
+  grain_size = std::max<size_t>(grain_size, 1);
+  // the caller runs blocks as well
+  size_t thread_num = GetSyncRunThreadNum() + 1;
+  size_t max_block_num = thread_num * kBlocksPerThread;
+  size_t block_num = std::min(max_block_num, (count + grain_size - 1) / grain_size);
+  size_t block_size = (count + block_num - 1) / block_num;
+  block_num = (count + block_size - 1) / block_size;
+  // one runner per thread claims blocks until none is left, which holds the call to thread_num threads even if more
+  // workers are idle
+  std::atomic<size_t> next_block{0};
+  Task runner = [&task, &next_block, block_num, block_size, count]() {
+    for (size_t block = next_block++; block < block_num; block = next_block++) {
+      size_t start = block * block_size;
+      task(start, std::min(start + block_size, count));
+    }
+    return SUCCESS;
+  };
+  std::vector<Task> tasks(std::min(thread_num, block_num), runner);
+  return SyncRun(tasks);
+}
+
+void ThreadPool::SetSyncRunThreadNum(size_t thread_num) {
+  if (tls_pool == this || tls_run_depth > 0) {
+    MS_LOG(EXCEPTION) << "The thread pool can not be resized from inside its own tasks.";
+  }
+  // the queues are empty once no call holds the pool, the idle workers can be joined and replaced
+  std::unique_lock<std::shared_mutex> resize_lock(resize_mtx_);
+  ClearThreadPool();
+  std::lock_guard<std::mutex> sync_run_lock(pool_mtx_);
+  max_thread_num_ = std::min(std::max<size_t>(thread_num, 1), kMaxThreadNum);
+  workers_.clear();
+  for (size_t i = 0; i < max_thread_num_; ++i) {
+    workers_.emplace_back(std::make_unique<Worker>());
   }
-  return true;
 }
 
 ThreadPool &ThreadPool::GetInstance() {
@@ -110,17 +256,21 @@ ThreadPool &ThreadPool::GetInstance() {
 
 void ThreadPool::ClearThreadPool() {
   std::lock_guard<std::mutex> sync_run_lock(pool_mtx_);
-  if (exit_run_) {
+  if (!started_) {
     return;
   }
-  exit_run_ = true;
-  task_cond_var_.notify_all();
+  {
+    std::lock_guard<std::mutex> lock(wake_mtx_);
+    exit_run_ = true;
+  }
+  wake_cond_var_.notify_all();
   for (auto &it : sync_run_threads_) {
     if (it.joinable()) {
       it.join();
     }
   }
   sync_run_threads_.clear();
+  started_ = false;
 }
 
 ThreadPool::~ThreadPool() { ClearThreadPool(); }
@@ -17,11 +17,13 @@
 #ifndef MINDSPORE_CCSRC_COMMON_THREAD_POOL_H_
 #define MINDSPORE_CCSRC_COMMON_THREAD_POOL_H_
 
+#include <algorithm>
 #include <mutex>
+#include <shared_mutex>
 #include <condition_variable>
 #include <thread>
 #include <vector>
-#include <queue>
+#include <deque>
 #include <string>
 #include <atomic>
 #include <memory>
@@ -34,30 +36,75 @@ namespace mindspore {
 namespace common {
 enum Status { FAIL = -1, SUCCESS = 0 };
 using Task = std::function<int()>;
+using ParallelTask = std::function<void(size_t, size_t)>;
 
+// Work stealing pool: every worker owns a deque, pops its own tasks from the back and steals from the front of the
+// others when it runs dry. Callers wait by running queued tasks themselves, so any number of threads may call
+// SyncRun at the same time and a task may call SyncRun again (nested parallelism) without deadlock.
 class ThreadPool {
  public:
   ~ThreadPool();
   ThreadPool(const ThreadPool &) = delete;
   ThreadPool &operator=(const ThreadPool &) = delete;
   static ThreadPool &GetInstance();
+  // returns when all tasks are done, false if any of them failed
   bool SyncRun(const std::vector<Task> &tasks);
-  size_t GetSyncRunThreadNum() { return max_thread_num_; }
+  // runs task(start, end) over [0, count) in blocks of at least grain_size elements on GetSyncRunThreadNum() threads
+  // besides the caller, there are a few blocks per thread and the threads claim them in turn so that blocks of uneven
+  // cost even out
+  bool ParallelFor(const ParallelTask &task, size_t count, size_t grain_size);
+  // the threads a call should split its work for, the pool size unless the parallelism is capped
+  size_t GetSyncRunThreadNum() {
+    size_t parallel_thread_num = parallel_thread_num_;
+    return parallel_thread_num == 0 ? max_thread_num_ : std::min(parallel_thread_num, max_thread_num_);
+  }
+  // resizes the pool, waits until the SyncRun and ParallelFor calls in flight have returned and holds new ones
+  // until it is done, so it must not be called from a task of the pool
+  void SetSyncRunThreadNum(size_t thread_num);
+  // caps the threads of the calls starting from now without resizing the pool, 0 lifts the cap
+  void SetParallelThreadNum(size_t thread_num) { parallel_thread_num_ = thread_num; }
   void ClearThreadPool();
 
  private:
+  // tasks of one SyncRun call
+  struct TaskGroup {
+    std::atomic<size_t> pending{0};
+    std::atomic_bool failed{false};
+    std::mutex mtx;
+    std::condition_variable cond;
+  };
+  struct PoolTask {
+    const Task *task{nullptr};
+    TaskGroup *group{nullptr};
+  };
+  struct Worker {
+    std::mutex mtx;
+    std::deque<PoolTask> tasks;
+  };
+
   ThreadPool();
-  void SyncRunLoop();
+  void StartWorkers();
+  void WorkerLoop(size_t index);
+  void PushTasks(const std::vector<Task> &tasks, TaskGroup *group);
+  bool PopTask(PoolTask *task);
+  void RunTask(const PoolTask &task);
 
   size_t max_thread_num_{1};
+  std::atomic<size_t> parallel_thread_num_{0};
+  // held shared by the outermost SyncRun or ParallelFor call of a thread and exclusively while resizing, since the
+  // calls read workers_ and max_thread_num_ without locks
+  std::shared_mutex resize_mtx_;
+  // guards starting and joining the workers only, running tasks never takes it
   std::mutex pool_mtx_;
-  std::atomic_bool exit_run_ = {false};
-  std::queue<Task> task_queue_;
-  std::mutex task_mutex_;
-  std::condition_variable task_cond_var_;
-  size_t task_finished_count_{0};
-  std::condition_variable finished_cond_var_;
+  std::atomic_bool started_{false};
+  std::atomic_bool exit_run_{false};
+  std::vector<std::unique_ptr<Worker>> workers_;
   std::vector<std::thread> sync_run_threads_{};
+  // tasks pushed and not popped yet, idle workers sleep while it is zero
+  std::atomic<size_t> queued_num_{0};
+  std::atomic<size_t> next_worker_{0};
+  std::mutex wake_mtx_;
+  std::condition_variable wake_cond_var_;
 };
 }  // namespace common
 }  // namespace mindspore
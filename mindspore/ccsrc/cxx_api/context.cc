@@ -22,6 +22,7 @@
 
 constexpr auto kModelOptionCpuEnableFP16 = "mindspore.option.cpu.enable_fp16";
 constexpr auto kModelOptionCpuThreadAffinity = "mindspore.option.cpu.thread_affinity";
+constexpr auto kModelOptionCpuEnableParallel = "mindspore.option.cpu.enable_parallel";
 constexpr auto kModelOptionMaliGpuEnableFP16 = "mindspore.option.mali_gpu.enable_fp16";
 constexpr auto kModelOptionKirinNpuFrequency = "mindspore.option.kirin_npu.frequency";
 constexpr auto kModelOptionDeviceID = "mindspore.option.device_id";
@@ -118,6 +119,15 @@ int CPUDeviceInfo::GetThreadAffinity() const {
   return GetValue<bool>(data_, kModelOptionCpuThreadAffinity);
 }
 
+void CPUDeviceInfo::SetEnableParallel(bool is_parallel) {
+  MS_EXCEPTION_IF_NULL(data_);
+  data_->params[kModelOptionCpuEnableParallel] = is_parallel;
+}
+bool CPUDeviceInfo::GetEnableParallel() const {
+  MS_EXCEPTION_IF_NULL(data_);
+  return GetValue<bool>(data_, kModelOptionCpuEnableParallel);
+}
+
 void MaliGPUDeviceInfo::SetEnableFP16(bool is_fp16) {
   MS_EXCEPTION_IF_NULL(data_);
   data_->params[kModelOptionMaliGpuEnableFP16] = is_fp16;
@@ -538,8 +538,16 @@ bool TaskEmitAction(const ResourcePtr &res) {
 
   // The graph compiling of mindRT.
   if ((backend == kMsConvert) && compile::IsMindRTUsed()) {
-    TaskEmitActionForMindRT(res);
-    return true;
+    if (compile::IsMindRTSupported(func_graph)) {
+      TaskEmitActionForMindRT(res);
+      return true;
+    }
+    // Fall back to the session backend and the segment VM.
+    MS_LOG(INFO) << "The graph " << func_graph->ToString() << " has control flow or several segments, run it on VM.";
+    bc_ptr = std::make_shared<compile::MsBackend>(backend, context_ptr->get_param<std::string>(MS_CTX_DEVICE_TARGET),
+                                                  context_ptr->get_param<uint32_t>(MS_CTX_DEVICE_ID));
+    bc_ptr->SetDebugger();
+    res->results()[kBackend] = bc_ptr;
   }
 
   // The graph compiling of control sink.
@@ -566,8 +574,9 @@ bool ExecuteAction(const ResourcePtr &res) {
   }
   std::string backend = MsContext::GetInstance()->backend_policy();
 
-  // The graph running of mindRT.
-  if ((backend == kMsConvert) && compile::IsMindRTUsed()) {
+  // The graph running of mindRT, the graphs mindRT does not support were compiled by the session backend.
+  auto bc_ptr = res->results()[kBackend].cast<compile::BackendPtr>();
+  if ((backend == kMsConvert) && std::dynamic_pointer_cast<compile::MindRTBackend>(bc_ptr) != nullptr) {
     ExecuteActionForMindRT(res);
     return true;
   }
@@ -578,7 +587,6 @@ bool ExecuteAction(const ResourcePtr &res) {
       MS_LOG(EXCEPTION) << "Execute args error";
     }
     auto graph_id = res->results()[kOutput].cast<GraphId>();
-    std::shared_ptr<compile::Backend> bc_ptr = res->results()[kBackend].cast<std::shared_ptr<compile::Backend>>();
     compile::MsBackend *msbc_ptr = std::dynamic_pointer_cast<compile::MsBackend>(bc_ptr).get();
     MS_EXCEPTION_IF_NULL(msbc_ptr);
     compile::VmEvalFuncPtr run =
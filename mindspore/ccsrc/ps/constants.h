@@ -35,6 +35,22 @@ constexpr char kEnvPServerNum[] = "MS_SERVER_NUM";
 constexpr char kEnvWorkerNum[] = "MS_WORKER_NUM";
 constexpr char kEnvSchedulerHost[] = "MS_SCHED_HOST";
 constexpr char kEnvSchedulerPort[] = "MS_SCHED_PORT";
+// directory of the ssd logs of the embedding tables that do not fit the dram size (MB) on a server, lru or lfu
+constexpr char kEnvEmbeddingStorePath[] = "MS_EMBEDDING_STORE_PATH";
+constexpr char kEnvEmbeddingStoreDramSize[] = "MS_EMBEDDING_STORE_DRAM_SIZE";
+constexpr char kEnvEmbeddingStorePolicy[] = "MS_EMBEDDING_STORE_POLICY";
+// pushes of embedding rows a worker may have in flight before the next one blocks, 0 pushes synchronously
+constexpr char kEnvEmbeddingPushWindow[] = "MS_EMBEDDING_PUSH_WINDOW";
+constexpr size_t kDefaultEmbeddingPushWindow = 2;
+// gradient pushes a worker may have in flight before the next one blocks, 0 pushes synchronously
+constexpr char kEnvGradPushWindow[] = "MS_GRAD_PUSH_WINDOW";
+constexpr size_t kDefaultGradPushWindow = 2;
+// messages of at least this many bytes to a node on the same host go through posix shared memory, 0 disables it
+constexpr char kEnvShmThreshold[] = "MS_PS_SHM_THRESHOLD";
+// encoding of the dense gradients pushed by workers (fp16, int8, topk or randomk) and the ratio top-k and random-k keep
+constexpr char kEnvGradCompression[] = "MS_PS_GRAD_COMPRESSION";
+constexpr char kEnvGradCompressionRatio[] = "MS_PS_GRAD_COMPRESSION_RATIO";
+constexpr float kDefaultGradCompressionRatio = 0.01;
 
 constexpr char kCommTypeOfIBVerbs[] = "ibverbs";
 constexpr char kRoleOfPServer[] = "server";
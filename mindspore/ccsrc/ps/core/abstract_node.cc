@@ -77,7 +77,7 @@ bool AbstractNode::Broadcast(const enum NodeRole &node_role, const DataPtr &mess
     message_meta->set_user_cmd(command);
 
     auto client = GetOrCreateTcpClient((*it).first.second);
-    client->SendMessage(message_meta, Protos::RAW, message.get(), size);
+    client->SendMessage(message_meta, Protos::RAW, message, size);
   }
   MS_LOG(DEBUG) << "The node role is:" << CommUtil::NodeRoleToString(node_info_.node_role_)
                 << ", the node id is:" << node_info_.node_id_ << " send the request id is:" << request_id;
@@ -101,8 +101,13 @@ bool AbstractNode::Send(const enum NodeRole &node_role, const uint32_t &rank_id,
   message_meta->set_role(node_info_.node_role_);
   message_meta->set_user_cmd(command);
 
+  uint64_t request_id = AddMessageTrack(1);
+  message_meta->set_request_id(request_id);
   auto client = GetOrCreateTcpClient(rank_id);
-  return SendMessageSync(client, message_meta, Protos::RAW, data.get(), len, timeout);
+  client->SendMessage(message_meta, Protos::RAW, data, len);
+  MS_LOG(DEBUG) << "The node role is:" << CommUtil::NodeRoleToString(node_info_.node_role_)
+                << ", the node id is:" << node_info_.node_id_ << " send the request id is:" << request_id;
+  return Wait(request_id, timeout);
 }
 
 bool AbstractNode::Send(const NodeRole &node_role, const std::vector<uint32_t> &rank_ids,
@@ -128,7 +133,7 @@ bool AbstractNode::Send(const NodeRole &node_role, const std::vector<uint32_t> &
     auto send = data.at(it);
     auto len = lens.at(it);
     auto client = GetOrCreateTcpClient(rank_ids.at(it));
-    client->SendMessage(message_meta, Protos::RAW, send.get(), len);
+    client->SendMessage(message_meta, Protos::RAW, send, len);
   }
   MS_LOG(DEBUG) << "The node role is:" << CommUtil::NodeRoleToString(node_info_.node_role_)
                 << ", the node id is:" << node_info_.node_id_ << " send the request id is:" << request_id;
@@ -160,7 +165,7 @@ bool AbstractNode::Send(const enum NodeRole &node_role, const uint32_t &rank_id,
   message_meta->set_user_cmd(command);
 
   auto client = GetOrCreateTcpClient(rank_id);
-  client->SendMessage(message_meta, Protos::RAW, message.get(), len);
+  client->SendMessage(message_meta, Protos::RAW, message, len);
   MS_LOG(DEBUG) << "The node role is:" << CommUtil::NodeRoleToString(node_info_.node_role_)
                 << ", the node id is:" << node_info_.node_id_ << " send the request id is:" << request_id;
   return Wait(request_id, timeout);
@@ -204,7 +209,7 @@ bool AbstractNode::Send(const NodeRole &node_role, const std::vector<uint32_t> &
     auto len = data_lens.at(it);
 
     auto client = GetOrCreateTcpClient(rank_ids.at(it));
-    client->SendMessage(message_meta, Protos::RAW, send.get(), len);
+    client->SendMessage(message_meta, Protos::RAW, send, len);
   }
   MS_LOG(DEBUG) << "The node role is:" << CommUtil::NodeRoleToString(node_info_.node_role_)
                 << ", the node id is:" << node_info_.node_id_ << " send the request id is:" << request_id;
@@ -457,11 +462,21 @@ const std::shared_ptr<TcpClient> &AbstractNode::GetOrCreateTcpClient(const int &
     std::string ip = nodes_address_[std::make_pair(NodeRole::SERVER, rank_id)].first;
     uint16_t port = nodes_address_[std::make_pair(NodeRole::SERVER, rank_id)].second;
     auto client = std::make_shared<TcpClient>(ip, port);
-    client->SetMessageCallback([&](std::shared_ptr<MessageMeta> meta, const Protos &protos, const void *data,
-                                   size_t size) {
+    // the data of a response is received straight into the vector handed to the caller, both callbacks run on the
+    // event loop thread of the clients one message after another
+    auto receiving_data = std::make_shared<VectorPtr>();
+    client->SetMessageAllocator([receiving_data](const MessageMeta &meta, size_t size) -> void * {
+      if (meta.cmd() != NodeCommand::SEND_DATA) {
+        return nullptr;
+      }
+      *receiving_data = std::make_shared<std::vector<unsigned char>>(size);
+      return (*receiving_data)->data();
+    });
+    client->SetMessageCallback([&, receiving_data](std::shared_ptr<MessageMeta> meta, const Protos &protos,
+                                                   const void *data, size_t size) {
       switch (meta->cmd()) {
         case NodeCommand::SEND_DATA:
-          ProcessSendDataResp(meta, protos, data, size);
+          ProcessSendDataResp(meta, protos, data, size, std::move(*receiving_data));
           RunMessageCallback(meta->request_id());
           break;
         case NodeCommand::COLLECTIVE_SEND_DATA:
@@ -515,7 +530,7 @@ bool AbstractNode::SendMessageSync(const std::shared_ptr<TcpClient> &client, std
 }
 
 void AbstractNode::ProcessSendDataResp(std::shared_ptr<MessageMeta> meta, const Protos &protos, const void *data,
-                                       size_t size) {
+                                       size_t size, VectorPtr received_data) {
   MS_EXCEPTION_IF_NULL(meta);
   MS_EXCEPTION_IF_NULL(data);
   std::lock_guard<std::mutex> lock(receive_messages_mutex_);
@@ -524,13 +539,16 @@ void AbstractNode::ProcessSendDataResp(std::shared_ptr<MessageMeta> meta, const
   MS_LOG(DEBUG) << "The node role is:" << CommUtil::NodeRoleToString(node_info_.node_role_)
                 << ", the node id is:" << node_info_.node_id_ << " send the request id is:" << request_id;
   auto it = receive_messages_.find(request_id);
-  VectorPtr received_data = std::make_shared<std::vector<unsigned char>>(size, 0);
-  if (size > 0) {
-    size_t dest_size = size;
-    size_t src_size = size;
-    auto ret = memcpy_s(received_data.get()->data(), dest_size, data, src_size);
-    if (ret != EOK) {
-      MS_LOG(EXCEPTION) << "The memcpy_s error, errorno(" << ret << ")";
+  // the data is only copied when it was not received into received_data
+  if (received_data == nullptr || received_data->data() != data) {
+    received_data = std::make_shared<std::vector<unsigned char>>(size, 0);
+    if (size > 0) {
+      size_t dest_size = size;
+      size_t src_size = size;
+      auto ret = memcpy_s(received_data.get()->data(), dest_size, data, src_size);
+      if (ret != EOK) {
+        MS_LOG(EXCEPTION) << "The memcpy_s error, errorno(" << ret << ")";
+      }
     }
   }
   if (it != receive_messages_.end()) {
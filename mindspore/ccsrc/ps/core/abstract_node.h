@@ -83,7 +83,9 @@ class AbstractNode : public Node {
                        const void *, size_t size, const uint32_t &timeout = kCommTimeoutInSeconds);
   uint64_t SendMessageAsync(const std::shared_ptr<TcpClient> &client, std::shared_ptr<MessageMeta> meta,
                             const Protos &protos, const void *data, size_t size);
-  void ProcessSendDataResp(std::shared_ptr<MessageMeta> meta, const Protos &protos, const void *data, size_t size);
+  // received_data is the buffer the client allocated for the data, which is copied when it is somewhere else
+  void ProcessSendDataResp(std::shared_ptr<MessageMeta> meta, const Protos &protos, const void *data, size_t size,
+                           VectorPtr received_data = nullptr);
   void RunMessageCallback(const uint64_t &request_id);
   void set_message_callback(const uint64_t &request_id, const MessageCallback &callback);
   void NotifyMessageArrival(std::shared_ptr<MessageMeta> meta);
@@ -74,6 +74,10 @@ uint32_t ClusterMetadata::scheduler_timeout() { return scheduler_timeout_; }
 void ClusterMetadata::set_scheduler_timeout(const uint32_t &scheduler_timeout) {
   scheduler_timeout_ = scheduler_timeout;
 }
+
+uint64_t ClusterMetadata::shm_threshold() { return shm_threshold_; }
+
+void ClusterMetadata::set_shm_threshold(const uint64_t &shm_threshold) { shm_threshold_ = shm_threshold; }
 }  // namespace core
 }  // namespace ps
 }  // namespace mindspore
@@ -50,6 +50,8 @@ class ClusterMetadata {
   void set_connect_interval(const uint32_t &connect_interval);
   uint32_t scheduler_timeout();
   void set_scheduler_timeout(const uint32_t &scheduler_timeout);
+  uint64_t shm_threshold();
+  void set_shm_threshold(const uint64_t &shm_threshold);
 
  private:
   ClusterMetadata()
@@ -61,7 +63,8 @@ class ClusterMetadata {
         heartbeat_timeout_(30),
         cluster_available_timeout_(300),
         connect_interval_(100),
-        scheduler_timeout_(30) {}
+        scheduler_timeout_(30),
+        shm_threshold_(0) {}
   uint32_t worker_num_;
   uint32_t server_num_;
   // The interval for sending heartbeat packets between worker node,server node and scheduler node is 3 seconds.
@@ -76,6 +79,8 @@ class ClusterMetadata {
   uint32_t connect_interval_;
   // When the scheduler exits, the worker and server can continue to work for 5 hours
   uint32_t scheduler_timeout_;
+  // Messages of at least this many bytes to a node on the same host are passed in shared memory, 0 disables it.
+  uint64_t shm_threshold_;
 };
 }  // namespace core
 }  // namespace ps
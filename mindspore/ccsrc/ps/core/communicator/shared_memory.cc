@@ -0,0 +1,112 @@
+/**
+ * Copyright 2021 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ps/core/communicator/shared_memory.h"
+
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+
+#include "utils/log_adapter.h"
+
+namespace mindspore {
+namespace ps {
+namespace core {
+namespace {
+// every segment of the transport is named with this prefix, a received meta may not name any other object
+constexpr char kSegmentPrefix[] = "/mindspore_ps_";
+}  // namespace
+
+SharedMemory::~SharedMemory() {
+  if (data_ != nullptr && munmap(data_, size_) != 0) {
+    MS_LOG(WARNING) << "Unmap the shared memory failed, errno: " << errno;
+  }
+}
+
+std::string SharedMemory::Write(const void *data, size_t size) {
+  static std::atomic<uint64_t> segment_count{0};
+  std::string name = kSegmentPrefix + std::to_string(getpid()) + "_" + std::to_string(segment_count++);
+  int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, S_IRUSR | S_IWUSR);
+  if (fd < 0) {
+    MS_LOG(WARNING) << "Create the shared memory " << name << " failed, errno: " << errno;
+    return "";
+  }
+  void *segment = MAP_FAILED;
+  if (ftruncate(fd, size) == 0) {
+    segment = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  }
+  (void)close(fd);
+  if (segment == MAP_FAILED) {
+    MS_LOG(WARNING) << "Map the shared memory " << name << " of " << size << " bytes failed, errno: " << errno;
+    (void)shm_unlink(name.c_str());
+    return "";
+  }
+  (void)memcpy(segment, data, size);
+  (void)munmap(segment, size);
+  return name;
+}
+
+void SharedMemory::Remove(const std::string &name) { (void)shm_unlink(name.c_str()); }
+
+std::unique_ptr<SharedMemory> SharedMemory::Open(const std::string &name, size_t size) {
+  if (name.compare(0, strlen(kSegmentPrefix), kSegmentPrefix) != 0 || name.find('/', 1) != std::string::npos) {
+    MS_LOG(EXCEPTION) << "The shared memory " << name << " is not a segment of the transport.";
+  }
+  int fd = shm_open(name.c_str(), O_RDONLY, 0);
+  if (fd < 0) {
+    MS_LOG(EXCEPTION) << "Open the shared memory " << name << " failed, errno: " << errno;
+  }
+  // the sender does not know when the message is read, so the receiver removes the name
+  (void)shm_unlink(name.c_str());
+  // a size larger than the object would map pages past its end, which fault when they are read
+  struct stat shm_stat {};
+  if (fstat(fd, &shm_stat) != 0 || static_cast<uint64_t>(shm_stat.st_size) != size) {
+    (void)close(fd);
+    MS_LOG(EXCEPTION) << "The shared memory " << name << " holds " << shm_stat.st_size << " bytes, but the message has "
+                      << size << " bytes.";
+  }
+  void *data = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+  (void)close(fd);
+  if (data == MAP_FAILED) {
+    MS_LOG(EXCEPTION) << "Map the shared memory " << name << " of " << size << " bytes failed, errno: " << errno;
+  }
+  return std::unique_ptr<SharedMemory>(new SharedMemory(data, size));
+}
+
+bool SharedMemory::IsLocalPeer(int fd) {
+  sockaddr_storage local_addr{};
+  sockaddr_storage peer_addr{};
+  socklen_t local_len = sizeof(local_addr);
+  socklen_t peer_len = sizeof(peer_addr);
+  if (getsockname(fd, reinterpret_cast<sockaddr *>(&local_addr), &local_len) != 0 ||
+      getpeername(fd, reinterpret_cast<sockaddr *>(&peer_addr), &peer_len) != 0) {
+    return false;
+  }
+  if (local_addr.ss_family != AF_INET || peer_addr.ss_family != AF_INET) {
+    return false;
+  }
+  return reinterpret_cast<sockaddr_in *>(&local_addr)->sin_addr.s_addr ==
+         reinterpret_cast<sockaddr_in *>(&peer_addr)->sin_addr.s_addr;
+}
+}  // namespace core
+}  // namespace ps
+}  // namespace mindspore
@@ -0,0 +1,56 @@
+/**
+ * Copyright 2021 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MINDSPORE_CCSRC_PS_CORE_COMMUNICATOR_SHARED_MEMORY_H_
+#define MINDSPORE_CCSRC_PS_CORE_COMMUNICATOR_SHARED_MEMORY_H_
+
+#include <memory>
+#include <string>
+
+namespace mindspore {
+namespace ps {
+namespace core {
+// A posix shared memory segment carrying the data of one message between nodes on the same host, instead of
+// copying it through the sockets of both ends. The sender creates and fills it, the receiver maps it and removes its
+// name, the memory is released when the receiver unmaps it.
+class SharedMemory {
+ public:
+  ~SharedMemory();
+  SharedMemory(const SharedMemory &) = delete;
+  SharedMemory &operator=(const SharedMemory &) = delete;
+
+  // Creates a segment holding a copy of data, returns its name or an empty string on failure.
+  static std::string Write(const void *data, size_t size);
+  // Removes a segment that was written but will not be received.
+  static void Remove(const std::string &name);
+  // Maps the segment of a received message read only.
+  static std::unique_ptr<SharedMemory> Open(const std::string &name, size_t size);
+  // Whether the peer of a connected socket has the same address as this end.
+  static bool IsLocalPeer(int fd);
+
+  const void *data() const { return data_; }
+  size_t size() const { return size_; }
+
+ private:
+  SharedMemory(void *data, size_t size) : data_(data), size_(size) {}
+
+  void *data_;
+  size_t size_;
+};
+}  // namespace core
+}  // namespace ps
+}  // namespace mindspore
+#endif  // MINDSPORE_CCSRC_PS_CORE_COMMUNICATOR_SHARED_MEMORY_H_
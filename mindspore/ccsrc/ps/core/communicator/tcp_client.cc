@@ -166,11 +166,20 @@ void TcpClient::ReadCallback(struct bufferevent *bev, void *ctx) {
   MS_EXCEPTION_IF_NULL(ctx);
   auto tcp_client = reinterpret_cast<TcpClient *>(ctx);
 
-  char read_buffer[kMessageChunkLength];
-  int read = 0;
-
-  while ((read = bufferevent_read(bev, &read_buffer, sizeof(read_buffer))) > 0) {
-    tcp_client->OnReadHandler(read_buffer, read);
+  // hand the chunks of the input buffer to the message handler in place instead of copying them out first
+  struct evbuffer *input = bufferevent_get_input(bev);
+  size_t length = evbuffer_get_length(input);
+  int chunk_num = evbuffer_peek(input, -1, nullptr, nullptr, 0);
+  if (chunk_num <= 0) {
+    return;
+  }
+  std::vector<evbuffer_iovec> chunks(IntToSize(chunk_num));
+  (void)evbuffer_peek(input, -1, nullptr, chunks.data(), chunk_num);
+  for (const auto &chunk : chunks) {
+    tcp_client->OnReadHandler(chunk.iov_base, chunk.iov_len);
+  }
+  if (evbuffer_drain(input, length) == -1) {
+    MS_LOG(EXCEPTION) << "Can not drain data from the event buffer!";
   }
 }
 
@@ -249,6 +258,8 @@ void TcpClient::StartWithNoBlock() {
 
 void TcpClient::SetMessageCallback(const OnMessage &cb) { message_callback_ = cb; }
 
+void TcpClient::SetMessageAllocator(const messageAllocate &allocator) { message_handler_.SetAllocator(allocator); }
+
 bool TcpClient::SendMessage(const CommMessage &message) const {
   MS_EXCEPTION_IF_NULL(buffer_event_);
   bufferevent_lock(buffer_event_);
@@ -276,29 +287,22 @@ bool TcpClient::SendMessage(const CommMessage &message) const {
 }
 
 bool TcpClient::SendMessage(std::shared_ptr<MessageMeta> meta, const Protos &protos, const void *data, size_t size) {
+  return SendMessage(meta, protos, data, size, nullptr);
+}
+
+bool TcpClient::SendMessage(std::shared_ptr<MessageMeta> meta, const Protos &protos,
+                            const std::shared_ptr<unsigned char[]> &data, size_t size) {
+  MS_EXCEPTION_IF_NULL(data);
+  return SendMessage(meta, protos, data.get(), size, data);
+}
+
+bool TcpClient::SendMessage(const std::shared_ptr<MessageMeta> &meta, const Protos &protos, const void *data,
+                            size_t size, const std::shared_ptr<unsigned char[]> &holder) {
   MS_EXCEPTION_IF_NULL(buffer_event_);
   MS_EXCEPTION_IF_NULL(meta);
   MS_EXCEPTION_IF_NULL(data);
   bufferevent_lock(buffer_event_);
-  bool res = true;
-
-  MessageHeader header;
-  header.message_proto_ = protos;
-  header.message_meta_length_ = SizeToUint(meta->ByteSizeLong());
-  header.message_length_ = size + header.message_meta_length_;
-
-  if (bufferevent_write(buffer_event_, &header, sizeof(header)) == -1) {
-    MS_LOG(ERROR) << "Event buffer add header failed!";
-    res = false;
-  }
-  if (bufferevent_write(buffer_event_, meta->SerializeAsString().data(), meta->ByteSizeLong()) == -1) {
-    MS_LOG(ERROR) << "Event buffer add protobuf data failed!";
-    res = false;
-  }
-  if (bufferevent_write(buffer_event_, data, size) == -1) {
-    MS_LOG(ERROR) << "Event buffer add protobuf data failed!";
-    res = false;
-  }
+  bool res = TcpMessageHandler::WriteMessage(buffer_event_, meta, protos, data, size, holder);
   int result = bufferevent_flush(buffer_event_, EV_READ | EV_WRITE, BEV_FLUSH);
   if (result < 0) {
     MS_LOG(ERROR) << "Bufferevent flush failed!";
@@ -61,8 +61,14 @@ class TcpClient {
   void Start();
   void StartWithNoBlock();
   void SetMessageCallback(const OnMessage &cb);
+  // Must be set before the client starts receiving, the allocator runs on the event loop thread.
+  void SetMessageAllocator(const messageAllocate &allocator);
   bool SendMessage(const CommMessage &message) const;
   bool SendMessage(std::shared_ptr<MessageMeta> meta, const Protos &protos, const void *data, size_t size);
+  // The data is sent from where it is instead of being copied into the output buffer, it must not be modified until
+  // it is sent.
+  bool SendMessage(std::shared_ptr<MessageMeta> meta, const Protos &protos,
+                   const std::shared_ptr<unsigned char[]> &data, size_t size);
   void StartTimer(const uint32_t &time);
   void set_timer_callback(const OnTimer &timer);
   const event_base &eventbase();
@@ -75,6 +81,8 @@ class TcpClient {
   virtual void OnReadHandler(const void *buf, size_t num);
   static void TimerCallback(evutil_socket_t fd, int16_t event, void *arg);
   void NotifyConnected();
+  bool SendMessage(const std::shared_ptr<MessageMeta> &meta, const Protos &protos, const void *data, size_t size,
+                   const std::shared_ptr<unsigned char[]> &holder);
 
  private:
   OnMessage message_callback_;
@@ -17,66 +17,185 @@
 #include "ps/core/communicator/tcp_message_handler.h"
 
 #include <arpa/inet.h>
+#include <event2/buffer.h>
+#include <algorithm>
 #include <iostream>
 #include <utility>
 
+#include "ps/core/cluster_metadata.h"
+#include "ps/core/communicator/shared_memory.h"
+#include "utils/convert_utils_base.h"
+
 namespace mindspore {
 namespace ps {
 namespace core {
 void TcpMessageHandler::SetCallback(const messageReceive &message_receive) { message_callback_ = message_receive; }
 
+void TcpMessageHandler::SetAllocator(const messageAllocate &allocator) { message_allocator_ = allocator; }
+
 void TcpMessageHandler::ReceiveMessage(const void *buffer, size_t num) {
   MS_EXCEPTION_IF_NULL(buffer);
   auto buffer_data = reinterpret_cast<const unsigned char *>(buffer);
 
   while (num > 0) {
-    if (remaining_length_ == 0) {
-      for (int i = 0; i < kHeaderLen && num > 0; ++i) {
-        header_[++header_index_] = *(buffer_data + i);
-        --num;
-        if (header_index_ == kHeaderLen - 1) {
-          message_header_.message_proto_ = *reinterpret_cast<const Protos *>(header_);
-          message_header_.message_meta_length_ =
-            *reinterpret_cast<const uint32_t *>(header_ + sizeof(message_header_.message_proto_));
-          message_header_.message_length_ = *reinterpret_cast<const size_t *>(
-            header_ + sizeof(message_header_.message_proto_) + sizeof(message_header_.message_meta_length_));
-          remaining_length_ = message_header_.message_length_;
-          message_buffer_.reset(new unsigned char[remaining_length_]);
-          buffer_data += (i + 1);
-          break;
+    if (header_index_ < sizeof(header_)) {
+      size_t copy_len = std::min(sizeof(header_) - header_index_, num);
+      (void)memcpy(header_ + header_index_, buffer_data, copy_len);
+      header_index_ += copy_len;
+      buffer_data += copy_len;
+      num -= copy_len;
+      if (header_index_ == sizeof(header_)) {
+        message_header_.message_proto_ = *reinterpret_cast<const Protos *>(header_);
+        message_header_.message_meta_length_ =
+          *reinterpret_cast<const uint32_t *>(header_ + sizeof(message_header_.message_proto_));
+        message_header_.message_length_ = *reinterpret_cast<const uint64_t *>(
+          header_ + sizeof(message_header_.message_proto_) + sizeof(message_header_.message_meta_length_));
+        if (message_header_.message_length_ < message_header_.message_meta_length_) {
+          MS_LOG(EXCEPTION) << "The message length " << message_header_.message_length_
+                            << " is less than the meta length " << message_header_.message_meta_length_;
+        }
+        meta_length_ = message_header_.message_meta_length_;
+        data_length_ = message_header_.message_length_ - meta_length_;
+        meta_buffer_.clear();
+        if (meta_length_ == 0) {
+          OnMetaReceived();
         }
       }
+    } else if (meta_ == nullptr) {
+      size_t copy_len = std::min(meta_length_ - meta_buffer_.size(), num);
+      (void)meta_buffer_.append(reinterpret_cast<const char *>(buffer_data), copy_len);
+      buffer_data += copy_len;
+      num -= copy_len;
+      if (meta_buffer_.size() == meta_length_) {
+        OnMetaReceived();
+      }
+    } else {
+      size_t copy_len = std::min(data_length_ - data_index_, num);
+      auto ret = memcpy_s(data_ + data_index_, data_length_ - data_index_, buffer_data, copy_len);
+      if (ret != EOK) {
+        MS_LOG(EXCEPTION) << "The memcpy_s error, errorno(" << ret << ")";
+      }
+      data_index_ += copy_len;
+      buffer_data += copy_len;
+      num -= copy_len;
+      if (data_index_ == data_length_) {
+        OnDataReceived();
+      }
     }
+  }
+}
 
-    if (remaining_length_ > 0 && num > 0) {
-      size_t copy_len = remaining_length_ <= num ? remaining_length_ : num;
-      remaining_length_ -= copy_len;
-      num -= copy_len;
+void TcpMessageHandler::OnMetaReceived() {
+  meta_ = std::make_shared<MessageMeta>();
+  if (!meta_->ParseFromArray(meta_buffer_.data(), SizeToInt(meta_length_))) {
+    MS_LOG(EXCEPTION) << "Parse the message meta of " << meta_length_ << " bytes failed!";
+  }
+  std::unique_ptr<SharedMemory> shared_memory = nullptr;
+  const unsigned char *shared_data = nullptr;
+  if (!meta_->shm_name().empty()) {
+    if (data_length_ != 0) {
+      MS_LOG(EXCEPTION) << "The message in shared memory " << meta_->shm_name() << " also has data in the stream!";
+    }
+    shared_memory = SharedMemory::Open(meta_->shm_name(), meta_->shm_size());
+    shared_data = reinterpret_cast<const unsigned char *>(shared_memory->data());
+    data_length_ = meta_->shm_size();
+  }
 
-      size_t dest_size = copy_len;
-      size_t src_size = copy_len;
-      auto ret = memcpy_s(message_buffer_.get() + last_copy_len_, dest_size, buffer_data, src_size);
-      last_copy_len_ += copy_len;
-      buffer_data += copy_len;
+  data_index_ = 0;
+  data_ = nullptr;
+  if (message_allocator_ && data_length_ > 0) {
+    data_ = reinterpret_cast<unsigned char *>(message_allocator_(*meta_, data_length_));
+  }
+  if (data_ == nullptr && (shared_data == nullptr || data_length_ == 0)) {
+    data_buffer_.reset(new unsigned char[data_length_]);
+    data_ = data_buffer_.get();
+  }
+  if (shared_data != nullptr) {
+    if (data_ == nullptr) {
+      // the mapping lives until the callback returns, no copy is needed
+      data_ = const_cast<unsigned char *>(shared_data);
+    } else {
+      auto ret = memcpy_s(data_, data_length_, shared_data, data_length_);
       if (ret != EOK) {
         MS_LOG(EXCEPTION) << "The memcpy_s error, errorno(" << ret << ")";
       }
+    }
+    data_index_ = data_length_;
+  }
+  if (data_index_ == data_length_) {
+    OnDataReceived();
+  }
+}
 
-      if (remaining_length_ == 0) {
-        if (message_callback_) {
-          std::shared_ptr<MessageMeta> pb_message = std::make_shared<MessageMeta>();
-          pb_message->ParseFromArray(message_buffer_.get(), message_header_.message_meta_length_);
-          message_callback_(pb_message, message_header_.message_proto_,
-                            message_buffer_.get() + message_header_.message_meta_length_,
-                            message_header_.message_length_ - message_header_.message_meta_length_);
-        }
-        message_buffer_.reset();
-        message_buffer_ = nullptr;
-        header_index_ = -1;
-        last_copy_len_ = 0;
+void TcpMessageHandler::OnDataReceived() {
+  // reset before the callback so that an exception in it does not break the next message
+  auto meta = std::move(meta_);
+  auto data_buffer = std::move(data_buffer_);
+  auto data = data_;
+  auto size = data_length_;
+  meta_ = nullptr;
+  data_ = nullptr;
+  header_index_ = 0;
+  data_index_ = 0;
+  if (message_callback_) {
+    message_callback_(meta, message_header_.message_proto_, data, size);
+  }
+}
+
+bool TcpMessageHandler::WriteMessage(struct bufferevent *bev, const std::shared_ptr<MessageMeta> &meta,
+                                     const Protos &protos, const void *data, size_t size,
+                                     const std::shared_ptr<unsigned char[]> &holder) {
+  MS_EXCEPTION_IF_NULL(bev);
+  MS_EXCEPTION_IF_NULL(meta);
+  MS_EXCEPTION_IF_NULL(data);
+  // a response reuses the meta of its request, which may name the segment the request came in
+  meta->clear_shm_name();
+  meta->clear_shm_size();
+  uint64_t shm_threshold = ClusterMetadata::instance()->shm_threshold();
+  if (shm_threshold > 0 && size >= shm_threshold && SharedMemory::IsLocalPeer(bufferevent_getfd(bev))) {
+    std::string shm_name = SharedMemory::Write(data, size);
+    if (!shm_name.empty()) {
+      meta->set_shm_name(shm_name);
+      meta->set_shm_size(size);
+      size = 0;
+    }
+  }
+
+  std::string meta_data = meta->SerializeAsString();
+  MessageHeader header;
+  header.message_proto_ = protos;
+  header.message_meta_length_ = SizeToUint(meta_data.size());
+  header.message_length_ = size + meta_data.size();
+
+  bool res = true;
+  if (bufferevent_write(bev, &header, sizeof(header)) == -1) {
+    MS_LOG(ERROR) << "Event buffer add header failed!";
+    res = false;
+  }
+  if (bufferevent_write(bev, meta_data.data(), meta_data.size()) == -1) {
+    MS_LOG(ERROR) << "Event buffer add protobuf data failed!";
+    res = false;
+  }
+  if (size > 0) {
+    if (holder != nullptr) {
+      // the output buffer points at the data and releases it once it has been written to the socket
+      auto reference = new std::shared_ptr<unsigned char[]>(holder);
+      auto cleanup = [](const void *, size_t, void *extra) {
+        delete reinterpret_cast<std::shared_ptr<unsigned char[]> *>(extra);
+      };
+      if (evbuffer_add_reference(bufferevent_get_output(bev), data, size, cleanup, reference) == -1) {
+        delete reference;
+        MS_LOG(ERROR) << "Event buffer add data reference failed!";
+        res = false;
       }
+    } else if (bufferevent_write(bev, data, size) == -1) {
+      MS_LOG(ERROR) << "Event buffer add protobuf data failed!";
+      res = false;
     }
+  } else if (!res && !meta->shm_name().empty()) {
+    SharedMemory::Remove(meta->shm_name());
   }
+  return res;
 }
 }  // namespace core
 }  // namespace ps
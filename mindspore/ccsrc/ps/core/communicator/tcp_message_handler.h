@@ -17,6 +17,8 @@
 #ifndef MINDSPORE_CCSRC_PS_CORE_COMMUNICATOR_TCP_MESSAGE_HANDLER_H_
 #define MINDSPORE_CCSRC_PS_CORE_COMMUNICATOR_TCP_MESSAGE_HANDLER_H_
 
+#include <event2/bufferevent.h>
+
 #include <functional>
 #include <iostream>
 #include <string>
@@ -32,27 +34,45 @@ namespace mindspore {
 namespace ps {
 namespace core {
 using messageReceive = std::function<void(std::shared_ptr<MessageMeta>, const Protos &, const void *, size_t size)>;
+// Returns the buffer of size bytes the data of a message is received into, or nullptr to let the handler allocate
+// it. The buffer is owned by the caller and is the data passed to the message callback.
+using messageAllocate = std::function<void *(const MessageMeta &meta, size_t size)>;
 constexpr int kHeaderLen = 16;
 
+// Splits the byte stream of a connection into messages: the header, the serialized meta and the data. The data is
+// received straight into the buffer given by the allocator, or read from the shared memory named by the meta when
+// the sender is on the same host.
 class TcpMessageHandler {
  public:
-  TcpMessageHandler()
-      : is_parsed_(false), message_buffer_(nullptr), remaining_length_(0), header_index_(-1), last_copy_len_(0) {}
+  TcpMessageHandler() : header_index_(0), meta_length_(0), data_length_(0), data_index_(0), data_(nullptr) {}
   virtual ~TcpMessageHandler() = default;
 
   void SetCallback(const messageReceive &cb);
+  void SetAllocator(const messageAllocate &allocator);
   void ReceiveMessage(const void *buffer, size_t num);
 
+  // Writes a message to the output of a bufferevent. The data is referenced by the buffer instead of copied when
+  // holder is given, which keeps it alive until it is sent, and goes through shared memory when the peer is on the
+  // same host and the data reaches the threshold of ClusterMetadata.
+  static bool WriteMessage(struct bufferevent *bev, const std::shared_ptr<MessageMeta> &meta, const Protos &protos,
+                           const void *data, size_t size, const std::shared_ptr<unsigned char[]> &holder = nullptr);
+
  private:
+  void OnMetaReceived();
+  void OnDataReceived();
+
   messageReceive message_callback_;
-  bool is_parsed_;
-  std::unique_ptr<unsigned char> message_buffer_;
-  size_t remaining_length_;
-  char header_[16]{0};
-  int header_index_;
-  size_t last_copy_len_;
+  messageAllocate message_allocator_;
+  char header_[kHeaderLen]{0};
+  size_t header_index_;
   MessageHeader message_header_;
-  std::string mBuffer;
+  std::string meta_buffer_;
+  size_t meta_length_;
+  std::shared_ptr<MessageMeta> meta_;
+  size_t data_length_;
+  size_t data_index_;
+  unsigned char *data_;
+  std::unique_ptr<unsigned char[]> data_buffer_;
 };
 }  // namespace core
 }  // namespace ps
@@ -72,24 +72,7 @@ bool TcpConnection::SendMessage(std::shared_ptr<MessageMeta> meta, const Protos
   MS_EXCEPTION_IF_NULL(meta);
   MS_EXCEPTION_IF_NULL(data);
   bufferevent_lock(buffer_event_);
-  bool res = true;
-  MessageHeader header;
-  header.message_proto_ = protos;
-  header.message_meta_length_ = SizeToUint(meta->ByteSizeLong());
-  header.message_length_ = size + header.message_meta_length_;
-
-  if (bufferevent_write(buffer_event_, &header, sizeof(header)) == -1) {
-    MS_LOG(ERROR) << "Event buffer add header failed!";
-    res = false;
-  }
-  if (bufferevent_write(buffer_event_, meta->SerializeAsString().data(), meta->ByteSizeLong()) == -1) {
-    MS_LOG(ERROR) << "Event buffer add protobuf data failed!";
-    res = false;
-  }
-  if (bufferevent_write(buffer_event_, data, size) == -1) {
-    MS_LOG(ERROR) << "Event buffer add protobuf data failed!";
-    res = false;
-  }
+  bool res = TcpMessageHandler::WriteMessage(buffer_event_, meta, protos, data, size);
   int result = bufferevent_flush(buffer_event_, EV_READ | EV_WRITE, BEV_FLUSH);
   if (result < 0) {
     MS_LOG(EXCEPTION) << "Bufferevent flush failed!";
@@ -102,6 +85,10 @@ bool TcpConnection::SendMessage(std::shared_ptr<MessageMeta> meta, const Protos
   return res;
 }
 
+void TcpConnection::SetMessageAllocator(const messageAllocate &allocator) {
+  tcp_message_handler_.SetAllocator(allocator);
+}
+
 TcpServer::TcpServer(const std::string &address, std::uint16_t port)
     : base_(nullptr),
       signal_event_(nullptr),
@@ -302,6 +289,12 @@ void TcpServer::ListenerCallback(struct evconnlistener *, evutil_socket_t fd, st
       on_server_receive(conn, meta, protos, data, size);
     }
   });
+  if (server->message_allocator_) {
+    TcpConnection *connection = conn.get();
+    conn->SetMessageAllocator([server, connection](const MessageMeta &meta, size_t size) -> void * {
+      return server->message_allocator_(*connection, meta, size);
+    });
+  }
   bufferevent_setcb(bev, TcpServer::ReadCallback, nullptr, TcpServer::EventCallback,
                     reinterpret_cast<void *>(conn.get()));
   if (bufferevent_enable(bev, EV_READ | EV_WRITE) == -1) {
@@ -323,6 +316,8 @@ std::shared_ptr<TcpConnection> TcpServer::onCreateConnection(struct bufferevent
 
 OnServerReceiveMessage TcpServer::GetServerReceive() const { return message_callback_; }
 
+void TcpServer::SetMessageAllocator(const OnServerAllocateMessage &allocator) { message_allocator_ = allocator; }
+
 void TcpServer::SignalCallback(evutil_socket_t, std::int16_t, void *data) {
   auto server = reinterpret_cast<class TcpServer *>(data);
   MS_EXCEPTION_IF_NULL(server);
@@ -339,20 +334,26 @@ void TcpServer::ReadCallback(struct bufferevent *bev, void *connection) {
   MS_EXCEPTION_IF_NULL(connection);
 
   auto conn = static_cast<class TcpConnection *>(connection);
+  // hand the chunks of the input buffer to the connection in place instead of copying them out first
   struct evbuffer *buf = bufferevent_get_input(bev);
-  char read_buffer[kMessageChunkLength];
-  while (EVBUFFER_LENGTH(buf) > 0) {
-    int read = evbuffer_remove(buf, &read_buffer, sizeof(read_buffer));
-    if (read == -1) {
-      MS_LOG(EXCEPTION) << "Can not drain data from the event buffer!";
-    }
-    conn->OnReadHandler(read_buffer, IntToSize(read));
-    MS_LOG(DEBUG) << "the current time is:"
-                  << std::chrono::time_point_cast<std::chrono::microseconds>(std::chrono::high_resolution_clock::now())
-                       .time_since_epoch()
-                       .count()
-                  << " the read size is:" << read;
+  size_t length = evbuffer_get_length(buf);
+  int chunk_num = evbuffer_peek(buf, -1, nullptr, nullptr, 0);
+  if (chunk_num <= 0) {
+    return;
+  }
+  std::vector<evbuffer_iovec> chunks(IntToSize(chunk_num));
+  (void)evbuffer_peek(buf, -1, nullptr, chunks.data(), chunk_num);
+  for (const auto &chunk : chunks) {
+    conn->OnReadHandler(chunk.iov_base, chunk.iov_len);
   }
+  if (evbuffer_drain(buf, length) == -1) {
+    MS_LOG(EXCEPTION) << "Can not drain data from the event buffer!";
+  }
+  MS_LOG(DEBUG) << "the current time is:"
+                << std::chrono::time_point_cast<std::chrono::microseconds>(std::chrono::high_resolution_clock::now())
+                     .time_since_epoch()
+                     .count()
+                << " the read size is:" << length;
 }
 
 void TcpServer::EventCallback(struct bufferevent *bev, std::int16_t events, void *data) {
@@ -374,14 +375,13 @@ void TcpServer::EventCallback(struct bufferevent *bev, std::int16_t events, void
     bufferevent_free(bev);
   } else if (events & BEV_EVENT_ERROR) {
     MS_LOG(WARNING) << "Event buffer remain data: " << remain;
-    // Free connection structures
-    srv->RemoveConnection(conn->GetFd());
-    bufferevent_free(bev);
-
-    // Notify about disconnection
+    // Notify about disconnection while the connection is still alive
     if (srv->client_disconnection_) {
       srv->client_disconnection_(*srv, *conn);
     }
+    // Free connection structures
+    srv->RemoveConnection(conn->GetFd());
+    bufferevent_free(bev);
   } else {
     MS_LOG(WARNING) << "Unhandled event!";
   }
@@ -57,6 +57,7 @@ class TcpConnection {
   bool SendMessage(std::shared_ptr<CommMessage> message) const;
   bool SendMessage(std::shared_ptr<MessageMeta> meta, const Protos &protos, const void *data, size_t size) const;
   virtual void OnReadHandler(const void *buffer, size_t numBytes);
+  void SetMessageAllocator(const messageAllocate &allocator);
   const TcpServer *GetServer() const;
   const evutil_socket_t &GetFd() const;
   void set_callback(const Callback &callback);
@@ -73,6 +74,10 @@ using OnServerReceiveMessage =
   std::function<void(std::shared_ptr<TcpConnection> conn, std::shared_ptr<MessageMeta> meta, const Protos &protos,
                      const void *data, size_t size)>;
 
+// Gives the buffer the data of a message received on conn is read into, see messageAllocate.
+using OnServerAllocateMessage =
+  std::function<void *(const TcpConnection &conn, const MessageMeta &meta, size_t size)>;
+
 class TcpServer {
  public:
   using OnConnected = std::function<void(const TcpServer &, const TcpConnection &)>;
@@ -101,6 +106,8 @@ class TcpServer {
   std::shared_ptr<TcpConnection> GetConnectionByFd(const evutil_socket_t &fd);
   OnServerReceiveMessage GetServerReceive() const;
   void SetMessageCallback(const OnServerReceiveMessage &cb);
+  // Must be set before the server starts, it is installed on the connections it accepts.
+  void SetMessageAllocator(const OnServerAllocateMessage &allocator);
   bool SendMessage(std::shared_ptr<TcpConnection> conn, std::shared_ptr<CommMessage> message);
   bool SendMessage(std::shared_ptr<TcpConnection> conn, std::shared_ptr<MessageMeta> meta, const Protos &protos,
                    const void *data, size_t sizee);
@@ -134,6 +141,7 @@ class TcpServer {
   OnAccepted client_accept_;
   std::mutex connection_mutex_;
   OnServerReceiveMessage message_callback_;
+  OnServerAllocateMessage message_allocator_;
   OnTimerOnce on_timer_once_callback_;
   OnTimer on_timer_callback_;
 };
@@ -75,6 +75,18 @@ void ServerNode::CreateTcpServer() {
         MS_LOG(EXCEPTION) << "The cmd:" << meta->cmd() << " is not supported!";
     }
   });
+  server_->SetMessageAllocator([&](const TcpConnection &conn, const MessageMeta &meta, size_t size) -> void * {
+    if (meta.cmd() != NodeCommand::SEND_DATA) {
+      return nullptr;
+    }
+    DataPtr data(new unsigned char[size]);
+    receiving_data_[&conn] = data;
+    return data.get();
+  });
+  // a connection closed in the middle of a message never delivers it, its buffer is dropped with the connection so
+  // the next connection allocated at the same address does not find it
+  server_->SetServerCallback(
+    nullptr, [&](const TcpServer &, const TcpConnection &conn) { (void)receiving_data_.erase(&conn); }, nullptr);
   server_->Init();
   server_thread_ = std::make_unique<std::thread>([&]() {
     MS_LOG(INFO) << "The server node start a tcp server!";
@@ -103,12 +115,23 @@ void ServerNode::ProcessSendData(std::shared_ptr<TcpConnection> conn, std::share
   MS_EXCEPTION_IF_NULL(conn);
   MS_EXCEPTION_IF_NULL(meta);
   MS_EXCEPTION_IF_NULL(data);
-  std::shared_ptr<unsigned char[]> res(new unsigned char[size]);
-  size_t dest_size = size;
-  size_t src_size = size;
-  auto ret = memcpy_s(res.get(), dest_size, data, src_size);
-  if (ret != EOK) {
-    MS_LOG(EXCEPTION) << "The memcpy_s error, errorno(" << ret << ")";
+  DataPtr res = nullptr;
+  auto iter = receiving_data_.find(conn.get());
+  if (iter != receiving_data_.end()) {
+    if (iter->second.get() == data) {
+      res = iter->second;
+    }
+    receiving_data_.erase(iter);
+  }
+  // the data is only copied when it was not received into the buffer of the connection
+  if (res == nullptr) {
+    res.reset(new unsigned char[size]);
+    size_t dest_size = size;
+    size_t src_size = size;
+    auto ret = memcpy_s(res.get(), dest_size, data, src_size);
+    if (ret != EOK) {
+      MS_LOG(EXCEPTION) << "The memcpy_s error, errorno(" << ret << ")";
+    }
   }
   MS_LOG(DEBUG) << "The node role is:" << CommUtil::NodeRoleToString(node_info_.node_role_)
                 << ", the node id is:" << node_info_.node_id_ << " send the request id is:" << meta->request_id()
@@ -74,6 +74,9 @@ class ServerNode : public AbstractNode {
   RequestHandler request_handler_;
   std::unordered_map<std::string, std::shared_ptr<CommunicatorBase>> communicators_;
   std::mutex communicator_mutex_;
+  // The buffer the data of the request being received on each connection is read into, only used on the thread of
+  // the tcp server.
+  std::unordered_map<const TcpConnection *, DataPtr> receiving_data_;
 };
 }  // namespace core
 }  // namespace ps
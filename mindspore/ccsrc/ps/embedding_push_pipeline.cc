@@ -0,0 +1,207 @@
+/**
+ * Copyright 2021 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ps/embedding_push_pipeline.h"
+#include <chrono>
+#include <map>
+#include <utility>
+#include "utils/log_adapter.h"
+
+namespace mindspore {
+namespace ps {
+namespace {
+uint64_t ElapsedUs(const std::chrono::steady_clock::time_point &start) {
+  return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+}
+}  // namespace
+
+EmbeddingPushPipeline::EmbeddingPushPipeline(size_t window, const Sender &sender) : window_(window), sender_(sender) {
+  if (window_ == 0) {
+    MS_LOG(EXCEPTION) << "The window of the embedding push pipeline should be at least 1.";
+  }
+  send_thread_ = std::thread(&EmbeddingPushPipeline::SendLoop, this);
+}
+
+EmbeddingPushPipeline::~EmbeddingPushPipeline() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  queued_cond_.notify_all();
+  if (send_thread_.joinable()) {
+    send_thread_.join();
+  }
+}
+
+void EmbeddingPushPipeline::Push(const Key &key, const std::vector<int> &ids, const std::vector<float> &vals) {
+  if (ids.empty()) {
+    return;
+  }
+  if (vals.size() % ids.size() != 0) {
+    MS_LOG(EXCEPTION) << "The size of the values " << vals.size() << " is not a multiple of the ids " << ids.size();
+  }
+  auto batch = std::make_shared<PushBatch>();
+  batch->key = key;
+  batch->ids = ids;
+  batch->vals = vals;
+  for (size_t i = 0; i < ids.size(); ++i) {
+    batch->id_to_row[ids[i]] = i;
+  }
+
+  auto start = std::chrono::steady_clock::now();
+  std::unique_lock<std::mutex> lock(mutex_);
+  acked_cond_.wait(lock, [this] { return batches_.size() < window_ || send_error_ != nullptr; });
+  RethrowSendError();
+  metrics_.blocked_us += ElapsedUs(start);
+  metrics_.push_count++;
+  metrics_.pushed_rows += ids.size();
+  batches_.emplace_back(std::move(batch));
+  lock.unlock();
+  queued_cond_.notify_one();
+}
+
+void EmbeddingPushPipeline::Lookup(const Key &key, const std::vector<int> &ids, size_t row_size, float *result,
+                                   std::vector<size_t> *missing) {
+  MS_EXCEPTION_IF_NULL(result);
+  MS_EXCEPTION_IF_NULL(missing);
+  std::lock_guard<std::mutex> lock(mutex_);
+  size_t served_rows = 0;
+  for (size_t i = 0; i < ids.size(); ++i) {
+    bool found = false;
+    // the newest push of a row holds its latest value
+    for (auto iter = batches_.rbegin(); iter != batches_.rend() && !found; ++iter) {
+      const auto &batch = *iter;
+      if (batch->key != key) {
+        continue;
+      }
+      auto row_iter = batch->id_to_row.find(ids[i]);
+      if (row_iter == batch->id_to_row.end()) {
+        continue;
+      }
+      if (batch->vals.size() != batch->ids.size() * row_size) {
+        MS_LOG(EXCEPTION) << "The row size of key " << key << " is " << batch->vals.size() / batch->ids.size()
+                          << ", but the lookup expects " << row_size;
+      }
+      std::copy(batch->vals.begin() + row_iter->second * row_size,
+                batch->vals.begin() + (row_iter->second + 1) * row_size, result + i * row_size);
+      found = true;
+    }
+    if (found) {
+      served_rows++;
+    } else {
+      missing->push_back(i);
+    }
+  }
+  metrics_.served_rows += served_rows;
+}
+
+void EmbeddingPushPipeline::Flush() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  acked_cond_.wait(lock, [this] { return batches_.empty() || send_error_ != nullptr; });
+  RethrowSendError();
+  MS_LOG(INFO) << "Embedding push pipeline flushed, pushes: " << metrics_.push_count
+               << ", rows: " << metrics_.pushed_rows << ", coalesced rows: " << metrics_.coalesced_rows
+               << ", rows served to pulls: " << metrics_.served_rows << ", blocked: " << metrics_.blocked_us
+               << "us, sending: " << metrics_.send_us << "us";
+}
+
+EmbeddingPushMetrics EmbeddingPushPipeline::metrics() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return metrics_;
+}
+
+void EmbeddingPushPipeline::SendLoop() {
+  while (true) {
+    std::vector<std::shared_ptr<PushBatch>> batches;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      queued_cond_.wait(lock, [this] { return stop_ || batches_.size() > sending_num_; });
+      // pushes queued before the pipeline is destroyed are still sent
+      if (batches_.size() == sending_num_) {
+        return;
+      }
+      batches.assign(batches_.begin() + sending_num_, batches_.end());
+      sending_num_ = batches_.size();
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    std::exception_ptr error = nullptr;
+    try {
+      Send(batches);
+    } catch (const std::exception &e) {
+      MS_LOG(ERROR) << "Pushing embeddings failed: " << e.what();
+      error = std::current_exception();
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      metrics_.send_us += ElapsedUs(start);
+      batches_.erase(batches_.begin(), batches_.begin() + batches.size());
+      sending_num_ -= batches.size();
+      if (error != nullptr) {
+        send_error_ = error;
+      }
+    }
+    acked_cond_.notify_all();
+  }
+}
+
+// Merges the batches of every table, a row keeps the place of its first push and the value of its last one.
+void EmbeddingPushPipeline::Send(const std::vector<std::shared_ptr<PushBatch>> &batches) {
+  std::map<Key, std::vector<const PushBatch *>> key_batches;
+  for (const auto &batch : batches) {
+    key_batches[batch->key].push_back(batch.get());
+  }
+  for (const auto &item : key_batches) {
+    const auto &key_batch = item.second;
+    if (key_batch.size() == 1 && key_batch[0]->id_to_row.size() == key_batch[0]->ids.size()) {
+      sender_(item.first, key_batch[0]->ids, key_batch[0]->vals);
+      continue;
+    }
+    size_t row_size = key_batch[0]->vals.size() / key_batch[0]->ids.size();
+    std::vector<int> ids;
+    std::vector<float> vals;
+    std::unordered_map<int, size_t> id_to_row;
+    size_t coalesced_rows = 0;
+    for (const auto batch : key_batch) {
+      for (size_t i = 0; i < batch->ids.size(); ++i) {
+        auto src = batch->vals.begin() + i * row_size;
+        auto iter = id_to_row.find(batch->ids[i]);
+        if (iter != id_to_row.end()) {
+          std::copy(src, src + row_size, vals.begin() + iter->second * row_size);
+          coalesced_rows++;
+          continue;
+        }
+        id_to_row.emplace(batch->ids[i], ids.size());
+        ids.push_back(batch->ids[i]);
+        vals.insert(vals.end(), src, src + row_size);
+      }
+    }
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      metrics_.coalesced_rows += coalesced_rows;
+    }
+    sender_(item.first, ids, vals);
+  }
+}
+
+void EmbeddingPushPipeline::RethrowSendError() {
+  if (send_error_ != nullptr) {
+    std::rethrow_exception(send_error_);
+  }
+}
+}  // namespace ps
+}  // namespace mindspore
@@ -0,0 +1,98 @@
+/**
+ * Copyright 2021 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MINDSPORE_CCSRC_PS_EMBEDDING_PUSH_PIPELINE_H_
+#define MINDSPORE_CCSRC_PS_EMBEDDING_PUSH_PIPELINE_H_
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "ps/constants.h"
+
+namespace mindspore {
+namespace ps {
+struct EmbeddingPushMetrics {
+  uint64_t push_count{0};
+  uint64_t pushed_rows{0};
+  // rows not sent because a later push in the window overwrote them
+  uint64_t coalesced_rows{0};
+  // rows of pulls served from the window instead of the servers
+  uint64_t served_rows{0};
+  // time pushes waited for room in the window and time spent sending, in microseconds
+  uint64_t blocked_us{0};
+  uint64_t send_us{0};
+};
+
+// Window of embedding rows pushed to the servers in the background, so that the push of a step overlaps the pulls
+// and the compute of the next ones:
+//  - Push only queues the rows and blocks while window pushes are not acknowledged yet, which bounds how far the
+//    servers lag behind this worker.
+//  - The sender thread takes every queued push at once and sends one message per table, a row pushed again within
+//    the window is sent once with its latest value.
+//  - Rows still in the window are read from it by Lookup, so a pull always sees the pushes of this worker.
+class EmbeddingPushPipeline {
+ public:
+  using Sender = std::function<void(const Key &key, const std::vector<int> &ids, const std::vector<float> &vals)>;
+
+  EmbeddingPushPipeline(size_t window, const Sender &sender);
+  ~EmbeddingPushPipeline();
+  EmbeddingPushPipeline(const EmbeddingPushPipeline &) = delete;
+  EmbeddingPushPipeline &operator=(const EmbeddingPushPipeline &) = delete;
+
+  void Push(const Key &key, const std::vector<int> &ids, const std::vector<float> &vals);
+  // Copies the rows of ids found in the window into result, which holds row_size floats per id. Positions of the
+  // other ids are appended to missing.
+  void Lookup(const Key &key, const std::vector<int> &ids, size_t row_size, float *result,
+              std::vector<size_t> *missing);
+  // Waits until every push is acknowledged by the servers.
+  void Flush();
+  EmbeddingPushMetrics metrics() const;
+
+ private:
+  struct PushBatch {
+    Key key;
+    std::vector<int> ids;
+    std::vector<float> vals;
+    // the row of the last occurrence of every id
+    std::unordered_map<int, size_t> id_to_row;
+  };
+
+  void SendLoop();
+  void Send(const std::vector<std::shared_ptr<PushBatch>> &batches);
+  void RethrowSendError();
+
+  size_t window_;
+  Sender sender_;
+  // oldest first, the first sending_num_ ones are being sent
+  std::deque<std::shared_ptr<PushBatch>> batches_;
+  size_t sending_num_{0};
+  bool stop_{false};
+  std::exception_ptr send_error_;
+  mutable std::mutex mutex_;
+  std::condition_variable queued_cond_;
+  std::condition_variable acked_cond_;
+  EmbeddingPushMetrics metrics_;
+  std::thread send_thread_;
+};
+}  // namespace ps
+}  // namespace mindspore
+#endif  // MINDSPORE_CCSRC_PS_EMBEDDING_PUSH_PIPELINE_H_
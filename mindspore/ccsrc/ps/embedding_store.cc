@@ -0,0 +1,360 @@
+/**
+ * Copyright 2021 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ps/embedding_store.h"
+#include <fcntl.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstdio>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <numeric>
+#include <utility>
+
+namespace mindspore {
+namespace ps {
+namespace {
+// slots compared to pick a victim, the sampled eviction stays within a few percent of the exact policy
+constexpr size_t kEvictionSampleNum = 16;
+// lfu frequencies are halved every time this many rounds of the dram size were accessed, so rows that were hot
+// long ago can leave
+constexpr uint64_t kFrequencyDecayRounds = 8;
+// the log is rewritten with the live records only once it is this much larger than them
+constexpr uint64_t kCompactRatio = 2;
+constexpr uint64_t kMinCompactBytes = 64 << 20;
+// bucket b holds pull latencies in [2^(b - 1), 2^b) us
+constexpr size_t kLatencyBucketNum = 32;
+
+bool ReadFull(int fd, void *data, size_t size, uint64_t offset) {
+  auto buf = reinterpret_cast<char *>(data);
+  while (size > 0) {
+    ssize_t ret = pread(fd, buf, size, static_cast<off_t>(offset));
+    if (ret < 0 && errno == EINTR) {
+      continue;
+    }
+    if (ret <= 0) {
+      return false;
+    }
+    buf += ret;
+    size -= static_cast<size_t>(ret);
+    offset += static_cast<uint64_t>(ret);
+  }
+  return true;
+}
+
+bool WriteFull(int fd, const void *data, size_t size, uint64_t offset) {
+  auto buf = reinterpret_cast<const char *>(data);
+  while (size > 0) {
+    ssize_t ret = pwrite(fd, buf, size, static_cast<off_t>(offset));
+    if (ret < 0 && errno == EINTR) {
+      continue;
+    }
+    if (ret <= 0) {
+      return false;
+    }
+    buf += ret;
+    size -= static_cast<size_t>(ret);
+    offset += static_cast<uint64_t>(ret);
+  }
+  return true;
+}
+
+uint64_t BucketUpperBound(size_t bucket) { return bucket == 0 ? 0 : (uint64_t(1) << bucket); }
+}  // namespace
+
+EmbeddingStore::EmbeddingStore(size_t row_num, size_t row_size, size_t dram_row_num, EvictionPolicy policy,
+                               const RowInitializer &initializer)
+    : row_num_(row_num),
+      row_size_(row_size),
+      dram_row_num_(std::max<size_t>(std::min(dram_row_num, row_num), 1)),
+      policy_(policy),
+      initializer_(initializer),
+      dram_(dram_row_num_ * row_size, 0),
+      slots_(dram_row_num_),
+      log_index_(row_num, kNotInLog),
+      min_compact_bytes_(kMinCompactBytes),
+      latency_buckets_(kLatencyBucketNum, 0) {
+  MS_EXCEPTION_IF_NULL(initializer_);
+  row_to_slot_.reserve(dram_row_num_);
+}
+
+EmbeddingStore::~EmbeddingStore() {
+  if (log_fd_ >= 0) {
+    (void)close(log_fd_);
+    (void)unlink(log_path_.c_str());
+  }
+}
+
+bool EmbeddingStore::Open(const std::string &log_path) {
+  log_fd_ = open(log_path.c_str(), O_RDWR | O_CREAT | O_TRUNC, S_IRUSR | S_IWUSR);
+  if (log_fd_ < 0) {
+    MS_LOG(ERROR) << "Open embedding store log " << log_path << " failed, errno " << errno;
+    return false;
+  }
+  log_path_ = log_path;
+  MS_LOG(INFO) << "Embedding store of " << row_num_ << " rows keeps " << dram_row_num_ << " rows in dram, log "
+               << log_path;
+  return true;
+}
+
+void EmbeddingStore::Lookup(const Key *ids, size_t ids_size, size_t offset, float *output) {
+  MS_EXCEPTION_IF_NULL(ids);
+  MS_EXCEPTION_IF_NULL(output);
+  auto start = std::chrono::steady_clock::now();
+  size_t row_bytes = row_size_ * sizeof(float);
+  for (size_t i = 0; i < ids_size; ++i) {
+    float *dst = output + i * row_size_;
+    if (ids[i] < offset || ids[i] - offset >= row_num_) {
+      (void)std::fill(dst, dst + row_size_, 0.0f);
+      continue;
+    }
+    size_t slot = Promote(ids[i] - offset, true);
+    auto ret = memcpy_s(dst, row_bytes, slot_data(slot), row_bytes);
+    if (ret != EOK) {
+      MS_LOG(EXCEPTION) << "Embedding store lookup memcpy failed.";
+    }
+  }
+  metrics_.pull_count++;
+  auto cost = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+  RecordPullLatency(static_cast<uint64_t>(cost.count()));
+}
+
+void EmbeddingStore::Update(const Key *ids, const float *values, size_t ids_size, size_t offset) {
+  MS_EXCEPTION_IF_NULL(ids);
+  MS_EXCEPTION_IF_NULL(values);
+  size_t row_bytes = row_size_ * sizeof(float);
+  for (size_t i = 0; i < ids_size; ++i) {
+    if (ids[i] < offset || ids[i] - offset >= row_num_) {
+      MS_LOG(EXCEPTION) << "UpdateEmbeddings index invalid.";
+    }
+    // the whole row is overwritten, no need to read it back from the log
+    size_t slot = Promote(ids[i] - offset, false);
+    auto ret = memcpy_s(slot_data(slot), row_bytes, values + i * row_size_, row_bytes);
+    if (ret != EOK) {
+      MS_LOG(EXCEPTION) << "Embedding store update memcpy failed.";
+    }
+    slots_[slot].dirty = true;
+  }
+  metrics_.push_count++;
+}
+
+void EmbeddingStore::Load(size_t begin, size_t num, const float *values) {
+  MS_EXCEPTION_IF_NULL(values);
+  if (begin > row_num_ || num > row_num_ - begin) {
+    MS_LOG(EXCEPTION) << "Load rows [" << begin << ", " << begin + num << ") out of " << row_num_ << " rows.";
+  }
+  if (log_fd_ < 0) {
+    MS_LOG(EXCEPTION) << "The embedding store log is not open.";
+  }
+  size_t row_bytes = row_size_ * sizeof(float);
+  if (!WriteFull(log_fd_, values, num * row_bytes, log_end_)) {
+    MS_LOG(EXCEPTION) << "Write rows [" << begin << ", " << begin + num << ") to embedding store log " << log_path_
+                      << " failed, errno " << errno;
+  }
+  for (size_t i = 0; i < num; ++i) {
+    if (log_index_[begin + i] == kNotInLog) {
+      log_row_num_++;
+    }
+    log_index_[begin + i] = log_end_ + i * row_bytes;
+  }
+  log_end_ += num * row_bytes;
+}
+
+void EmbeddingStore::Export(size_t begin, size_t num, float *output, size_t output_size) {
+  MS_EXCEPTION_IF_NULL(output);
+  if (begin > row_num_ || num > row_num_ - begin) {
+    MS_LOG(EXCEPTION) << "Export rows [" << begin << ", " << begin + num << ") out of " << row_num_ << " rows.";
+  }
+  if (output_size < num * row_size_) {
+    MS_LOG(EXCEPTION) << "Export needs " << num * row_size_ << " floats, but got " << output_size;
+  }
+  size_t row_bytes = row_size_ * sizeof(float);
+  for (size_t i = 0; i < num; ++i) {
+    size_t row = begin + i;
+    float *dst = output + i * row_size_;
+    auto iter = row_to_slot_.find(row);
+    if (iter == row_to_slot_.end()) {
+      ReadRow(row, dst);
+    } else if (memcpy_s(dst, row_bytes, slot_data(iter->second), row_bytes) != EOK) {
+      MS_LOG(EXCEPTION) << "Embedding store export memcpy failed.";
+    }
+  }
+}
+
+EmbeddingStoreMetrics EmbeddingStore::metrics() const {
+  EmbeddingStoreMetrics metrics = metrics_;
+  metrics.log_bytes = log_end_;
+  uint64_t total = std::accumulate(latency_buckets_.begin(), latency_buckets_.end(), uint64_t(0));
+  if (total == 0) {
+    return metrics;
+  }
+  std::vector<std::pair<double, uint64_t *>> percentiles = {
+    {0.5, &metrics.pull_p50_us}, {0.9, &metrics.pull_p90_us}, {0.99, &metrics.pull_p99_us}};
+  for (auto &percentile : percentiles) {
+    auto target = static_cast<uint64_t>(std::ceil(percentile.first * total));
+    uint64_t seen = 0;
+    for (size_t b = 0; b < kLatencyBucketNum; ++b) {
+      seen += latency_buckets_[b];
+      if (seen >= target) {
+        *percentile.second = BucketUpperBound(b);
+        break;
+      }
+    }
+  }
+  return metrics;
+}
+
+size_t EmbeddingStore::Promote(size_t row, bool load) {
+  clock_++;
+  if (policy_ == EvictionPolicy::kLFU && clock_ % (kFrequencyDecayRounds * dram_row_num_) == 0) {
+    for (auto &slot : slots_) {
+      slot.frequency >>= 1;
+    }
+  }
+  auto iter = row_to_slot_.find(row);
+  size_t slot = 0;
+  if (iter != row_to_slot_.end()) {
+    metrics_.hit_rows++;
+    slot = iter->second;
+  } else {
+    metrics_.miss_rows++;
+    if (used_slot_num_ < dram_row_num_) {
+      slot = used_slot_num_++;
+    } else {
+      slot = PickVictim();
+      Evict(slot);
+    }
+    if (load) {
+      ReadRow(row, slot_data(slot));
+    }
+    slots_[slot].row = row;
+    slots_[slot].dirty = false;
+    slots_[slot].frequency = 0;
+    row_to_slot_[row] = slot;
+  }
+  slots_[slot].last_access = clock_;
+  slots_[slot].frequency++;
+  return slot;
+}
+
+size_t EmbeddingStore::PickVictim() {
+  std::uniform_int_distribution<size_t> distribution(0, dram_row_num_ - 1);
+  size_t victim = distribution(sampler_);
+  for (size_t i = 1; i < kEvictionSampleNum; ++i) {
+    size_t candidate = distribution(sampler_);
+    const Slot &c = slots_[candidate];
+    const Slot &v = slots_[victim];
+    bool colder = policy_ == EvictionPolicy::kLRU
+                    ? c.last_access < v.last_access
+                    : (c.frequency < v.frequency || (c.frequency == v.frequency && c.last_access < v.last_access));
+    if (colder) {
+      victim = candidate;
+    }
+  }
+  return victim;
+}
+
+void EmbeddingStore::Evict(size_t slot) {
+  Slot &victim = slots_[slot];
+  if (victim.dirty) {
+    AppendRow(victim.row, slot_data(slot));
+    metrics_.written_back_rows++;
+  }
+  (void)row_to_slot_.erase(victim.row);
+  victim.row = kEmptySlot;
+  metrics_.evicted_rows++;
+}
+
+void EmbeddingStore::ReadRow(size_t row, float *data) {
+  if (log_index_[row] == kNotInLog) {
+    initializer_(row, data, row_size_);
+    return;
+  }
+  if (!ReadFull(log_fd_, data, row_size_ * sizeof(float), log_index_[row])) {
+    MS_LOG(EXCEPTION) << "Read row " << row << " from embedding store log " << log_path_ << " failed, errno "
+                      << errno;
+  }
+}
+
+void EmbeddingStore::AppendRow(size_t row, const float *data) {
+  if (log_fd_ < 0) {
+    MS_LOG(EXCEPTION) << "The embedding store log is not open.";
+  }
+  size_t row_bytes = row_size_ * sizeof(float);
+  if (!WriteFull(log_fd_, data, row_bytes, log_end_)) {
+    MS_LOG(EXCEPTION) << "Write row " << row << " to embedding store log " << log_path_ << " failed, errno " << errno;
+  }
+  if (log_index_[row] == kNotInLog) {
+    log_row_num_++;
+  }
+  log_index_[row] = log_end_;
+  log_end_ += row_bytes;
+  uint64_t live_bytes = log_row_num_ * row_bytes;
+  if (log_end_ > min_compact_bytes_ && log_end_ > kCompactRatio * live_bytes) {
+    CompactLog();
+  }
+}
+
+void EmbeddingStore::CompactLog() {
+  std::string compact_path = log_path_ + ".compact";
+  int compact_fd = open(compact_path.c_str(), O_RDWR | O_CREAT | O_TRUNC, S_IRUSR | S_IWUSR);
+  if (compact_fd < 0) {
+    MS_LOG(WARNING) << "Open " << compact_path << " failed, errno " << errno << ", the log is not compacted.";
+    return;
+  }
+  size_t row_bytes = row_size_ * sizeof(float);
+  std::vector<float> buffer(row_size_);
+  std::vector<uint64_t> compact_index(row_num_, kNotInLog);
+  uint64_t compact_end = 0;
+  for (size_t row = 0; row < row_num_; ++row) {
+    if (log_index_[row] == kNotInLog) {
+      continue;
+    }
+    if (!ReadFull(log_fd_, buffer.data(), row_bytes, log_index_[row]) ||
+        !WriteFull(compact_fd, buffer.data(), row_bytes, compact_end)) {
+      MS_LOG(WARNING) << "Copy row " << row << " to " << compact_path << " failed, the log is not compacted.";
+      (void)close(compact_fd);
+      (void)unlink(compact_path.c_str());
+      return;
+    }
+    compact_index[row] = compact_end;
+    compact_end += row_bytes;
+  }
+  if (rename(compact_path.c_str(), log_path_.c_str()) != 0) {
+    MS_LOG(WARNING) << "Rename " << compact_path << " failed, errno " << errno << ", the log is not compacted.";
+    (void)close(compact_fd);
+    (void)unlink(compact_path.c_str());
+    return;
+  }
+  MS_LOG(INFO) << "Compacted embedding store log " << log_path_ << " from " << log_end_ << " to " << compact_end
+               << " bytes.";
+  (void)close(log_fd_);
+  log_fd_ = compact_fd;
+  log_index_.swap(compact_index);
+  log_end_ = compact_end;
+}
+
+void EmbeddingStore::RecordPullLatency(uint64_t us) {
+  size_t bucket = 0;
+  while (us > 0 && bucket + 1 < kLatencyBucketNum) {
+    us >>= 1;
+    bucket++;
+  }
+  latency_buckets_[bucket]++;
+}
+}  // namespace ps
+}  // namespace mindspore
@@ -0,0 +1,131 @@
+/**
+ * Copyright 2021 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MINDSPORE_CCSRC_PS_EMBEDDING_STORE_H_
+#define MINDSPORE_CCSRC_PS_EMBEDDING_STORE_H_
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <functional>
+#include <random>
+#include "ps/constants.h"
+#include "utils/log_adapter.h"
+
+namespace mindspore {
+namespace ps {
+enum class EvictionPolicy { kLRU, kLFU };
+
+struct EmbeddingStoreMetrics {
+  uint64_t pull_count{0};
+  uint64_t push_count{0};
+  // rows found in dram and rows promoted from the log or initialized by pulls and pushes
+  uint64_t hit_rows{0};
+  uint64_t miss_rows{0};
+  uint64_t evicted_rows{0};
+  uint64_t written_back_rows{0};
+  uint64_t log_bytes{0};
+  // pull latency in microseconds
+  uint64_t pull_p50_us{0};
+  uint64_t pull_p90_us{0};
+  uint64_t pull_p99_us{0};
+
+  double hit_rate() const {
+    return hit_rows + miss_rows == 0 ? 0 : static_cast<double>(hit_rows) / (hit_rows + miss_rows);
+  }
+};
+
+// Rows of an embedding table shard kept in two tiers: a fixed number of hot rows in dram and the cold rows in an
+// append only log file on local disk, located by an in-memory index. Pulls and pushes promote the rows they touch
+// into dram, the victim is sampled by the eviction policy and only written to the log when it is dirty. A row that
+// was never written is produced by the initializer, which must give the same values for a row every time.
+// Not thread safe, ParameterServer serializes the calls under its mutex.
+class EmbeddingStore {
+ public:
+  using RowInitializer = std::function<void(size_t row, float *data, size_t row_size)>;
+
+  EmbeddingStore(size_t row_num, size_t row_size, size_t dram_row_num, EvictionPolicy policy,
+                 const RowInitializer &initializer);
+  ~EmbeddingStore();
+  EmbeddingStore(const EmbeddingStore &) = delete;
+  EmbeddingStore &operator=(const EmbeddingStore &) = delete;
+
+  bool Open(const std::string &log_path);
+  // ids are global, offset is the first row of this shard. Rows out of the shard read zeros.
+  void Lookup(const Key *ids, size_t ids_size, size_t offset, float *output);
+  // rows out of the shard are an error, as in EmbeddingLookUpPSKernel::UpdateEmbeddings
+  void Update(const Key *ids, const float *values, size_t ids_size, size_t offset);
+  // writes rows [begin, begin + num) to the log as their initial values instead of the row initializer, for tables
+  // initialized as a whole. Only before the first lookup or update.
+  void Load(size_t begin, size_t num, const float *values);
+  // copies rows [begin, begin + num) in order into output of num * row_size floats, so a large shard can be saved
+  // a chunk at a time
+  void Export(size_t begin, size_t num, float *output, size_t output_size);
+  EmbeddingStoreMetrics metrics() const;
+
+  size_t row_num() const { return row_num_; }
+  size_t row_size() const { return row_size_; }
+  // the log is only compacted once it is larger than this, 64MB by default
+  void set_min_compact_bytes(uint64_t min_compact_bytes) { min_compact_bytes_ = min_compact_bytes; }
+
+ private:
+  struct Slot {
+    size_t row{kEmptySlot};
+    bool dirty{false};
+    uint64_t last_access{0};
+    uint64_t frequency{0};
+  };
+
+  // returns the dram slot holding row, loading it on a miss
+  size_t Promote(size_t row, bool load);
+  size_t PickVictim();
+  void Evict(size_t slot);
+  void ReadRow(size_t row, float *data);
+  void AppendRow(size_t row, const float *data);
+  void CompactLog();
+  void RecordPullLatency(uint64_t us);
+  float *slot_data(size_t slot) { return dram_.data() + slot * row_size_; }
+
+  static constexpr size_t kEmptySlot = SIZE_MAX;
+  static constexpr uint64_t kNotInLog = UINT64_MAX;
+
+  size_t row_num_;
+  size_t row_size_;
+  size_t dram_row_num_;
+  EvictionPolicy policy_;
+  RowInitializer initializer_;
+
+  std::vector<float> dram_;
+  std::vector<Slot> slots_;
+  std::unordered_map<size_t, size_t> row_to_slot_;
+  size_t used_slot_num_{0};
+  uint64_t clock_{0};
+  std::mt19937 sampler_;
+
+  std::string log_path_;
+  int log_fd_{-1};
+  uint64_t log_end_{0};
+  // offset in the log of the latest record of every row
+  std::vector<uint64_t> log_index_;
+  size_t log_row_num_{0};
+  uint64_t min_compact_bytes_;
+
+  EmbeddingStoreMetrics metrics_;
+  std::vector<uint64_t> latency_buckets_;
+};
+}  // namespace ps
+}  // namespace mindspore
+#endif  // MINDSPORE_CCSRC_PS_EMBEDDING_STORE_H_
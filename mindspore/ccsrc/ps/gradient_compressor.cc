@@ -0,0 +1,244 @@
+/**
+ * Copyright 2021 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ps/gradient_compressor.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <map>
+#include <numeric>
+#include <unordered_set>
+#include "base/float16.h"
+#include "utils/log_adapter.h"
+
+namespace mindspore {
+namespace ps {
+namespace {
+// int8 elements sharing a scale
+constexpr size_t kInt8BlockSize = 512;
+constexpr float kInt8Max = 127.0f;
+
+size_t BlockNum(size_t size) { return (size + kInt8BlockSize - 1) / kInt8BlockSize; }
+
+// the values of an encoding are bytes in the message, which are not aligned for the element type
+template <typename T>
+inline T LoadValue(const char *values, size_t i) {
+  T value;
+  (void)memcpy(&value, values + i * sizeof(T), sizeof(T));
+  return value;
+}
+
+template <typename T>
+inline void StoreValue(char *values, size_t i, T value) {
+  (void)memcpy(values + i * sizeof(T), &value, sizeof(T));
+}
+
+void CheckValuesSize(const CompressedGradient &compressed, size_t expect) {
+  if (compressed.values().size() != expect) {
+    MS_LOG(EXCEPTION) << "The compressed gradient of type " << compressed.type() << " has "
+                      << compressed.values().size() << " bytes of values, but " << expect << " are expected.";
+  }
+}
+}  // namespace
+
+GradientCompressor::GradientCompressor(GradCompressionType type, float ratio)
+    : type_(type), ratio_(ratio), seed_engine_(std::random_device()()) {
+  if ((type_ == GradCompressionType::kTopK || type_ == GradCompressionType::kRandomK) &&
+      (ratio_ <= 0 || ratio_ > 1)) {
+    MS_LOG(EXCEPTION) << "The ratio of the elements kept by the gradient compression should be in (0, 1], but got "
+                      << ratio_;
+  }
+}
+
+GradCompressionType GradientCompressor::TypeFromName(const std::string &name) {
+  static const std::map<std::string, GradCompressionType> types = {{"", GradCompressionType::kNone},
+                                                                   {"none", GradCompressionType::kNone},
+                                                                   {"fp16", GradCompressionType::kFp16},
+                                                                   {"int8", GradCompressionType::kInt8},
+                                                                   {"topk", GradCompressionType::kTopK},
+                                                                   {"randomk", GradCompressionType::kRandomK}};
+  auto iter = types.find(name);
+  if (iter == types.end()) {
+    MS_LOG(EXCEPTION) << "Unsupported gradient compression " << name << ", supports fp16, int8, topk, randomk.";
+  }
+  return iter->second;
+}
+
+// Floyd's sampling of count distinct positions, ascending. mt19937_64 gives the same numbers everywhere, so the
+// servers draw the positions the worker did.
+std::vector<uint32_t> GradientCompressor::RandomIndices(uint64_t seed, size_t size, size_t count) {
+  std::mt19937_64 engine(seed);
+  std::unordered_set<uint32_t> chosen;
+  chosen.reserve(count);
+  for (size_t j = size - count; j < size; ++j) {
+    auto candidate = static_cast<uint32_t>(engine() % (j + 1));
+    if (!chosen.insert(candidate).second) {
+      (void)chosen.insert(static_cast<uint32_t>(j));
+    }
+  }
+  std::vector<uint32_t> indices(chosen.begin(), chosen.end());
+  std::sort(indices.begin(), indices.end());
+  return indices;
+}
+
+void GradientCompressor::Compress(const Key &key, const float *grad, size_t size, CompressedGradient *compressed) {
+  MS_EXCEPTION_IF_NULL(grad);
+  MS_EXCEPTION_IF_NULL(compressed);
+  auto start = std::chrono::steady_clock::now();
+  std::lock_guard<std::mutex> lock(mutex_);
+  // the residual becomes the gradient plus the error of the former encodings, then the error of this one
+  std::vector<float> &residual = residuals_[key];
+  if (residual.size() != size) {
+    residual.assign(size, 0);
+  }
+  for (size_t i = 0; i < size; ++i) {
+    residual[i] += grad[i];
+  }
+
+  compressed->Clear();
+  compressed->set_type(static_cast<int>(type_));
+  compressed->set_size(size);
+  std::string *values = compressed->mutable_values();
+  switch (type_) {
+    case GradCompressionType::kFp16: {
+      values->resize(size * sizeof(float16));
+      for (size_t i = 0; i < size; ++i) {
+        float16 value(residual[i]);
+        StoreValue(&(*values)[0], i, value);
+        residual[i] -= static_cast<float>(value);
+      }
+      break;
+    }
+    case GradCompressionType::kInt8: {
+      values->resize(size * sizeof(int8_t));
+      for (size_t block = 0; block < BlockNum(size); ++block) {
+        size_t begin = block * kInt8BlockSize;
+        size_t end = std::min(begin + kInt8BlockSize, size);
+        float max_abs = 0;
+        for (size_t i = begin; i < end; ++i) {
+          max_abs = std::max(max_abs, std::fabs(residual[i]));
+        }
+        float scale = max_abs / kInt8Max;
+        compressed->add_scales(scale);
+        for (size_t i = begin; i < end; ++i) {
+          auto value = scale == 0 ? 0 : static_cast<int8_t>(std::lround(residual[i] / scale));
+          (*values)[i] = static_cast<char>(value);
+          residual[i] -= value * scale;
+        }
+      }
+      break;
+    }
+    case GradCompressionType::kTopK:
+    case GradCompressionType::kRandomK: {
+      size_t count = std::min(size, std::max<size_t>(static_cast<size_t>(std::ceil(size * ratio_)), 1));
+      std::vector<uint32_t> indices;
+      if (type_ == GradCompressionType::kTopK) {
+        indices.resize(size);
+        std::iota(indices.begin(), indices.end(), 0);
+        auto larger = [&residual](uint32_t a, uint32_t b) { return std::fabs(residual[a]) > std::fabs(residual[b]); };
+        std::nth_element(indices.begin(), indices.begin() + count - 1, indices.end(), larger);
+        indices.resize(count);
+        std::sort(indices.begin(), indices.end());
+        uint32_t last = 0;
+        for (auto index : indices) {
+          compressed->add_indices(index - last);
+          last = index;
+        }
+      } else {
+        uint64_t seed = seed_engine_();
+        indices = RandomIndices(seed, size, count);
+        compressed->set_seed(seed);
+        compressed->set_count(count);
+      }
+      values->resize(count * sizeof(float));
+      for (size_t j = 0; j < count; ++j) {
+        StoreValue(&(*values)[0], j, residual[indices[j]]);
+        residual[indices[j]] = 0;
+      }
+      break;
+    }
+    default:
+      MS_LOG(EXCEPTION) << "The gradient compression type " << static_cast<int>(type_) << " is not supported.";
+  }
+
+  metrics_.compress_count++;
+  metrics_.raw_bytes += size * sizeof(float);
+  metrics_.compressed_bytes += compressed->ByteSizeLong();
+  metrics_.compress_us +=
+    std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+}
+
+void GradientCompressor::Accumulate(const CompressedGradient &compressed, float *grad, size_t size) {
+  MS_EXCEPTION_IF_NULL(grad);
+  if (compressed.size() != size) {
+    MS_LOG(EXCEPTION) << "The compressed gradient has " << compressed.size() << " elements, but the gradient has "
+                      << size;
+  }
+  const char *values = compressed.values().data();
+  switch (static_cast<GradCompressionType>(compressed.type())) {
+    case GradCompressionType::kFp16:
+      CheckValuesSize(compressed, size * sizeof(float16));
+      for (size_t i = 0; i < size; ++i) {
+        grad[i] += static_cast<float>(LoadValue<float16>(values, i));
+      }
+      break;
+    case GradCompressionType::kInt8: {
+      CheckValuesSize(compressed, size * sizeof(int8_t));
+      if (static_cast<size_t>(compressed.scales_size()) != BlockNum(size)) {
+        MS_LOG(EXCEPTION) << "The int8 gradient has " << compressed.scales_size() << " scales, but "
+                          << BlockNum(size) << " are expected.";
+      }
+      for (size_t i = 0; i < size; ++i) {
+        grad[i] += static_cast<int8_t>(values[i]) * compressed.scales(i / kInt8BlockSize);
+      }
+      break;
+    }
+    case GradCompressionType::kTopK: {
+      CheckValuesSize(compressed, compressed.indices_size() * sizeof(float));
+      size_t index = 0;
+      for (int j = 0; j < compressed.indices_size(); ++j) {
+        index += compressed.indices(j);
+        if (index >= size) {
+          MS_LOG(EXCEPTION) << "The position " << index << " of the top-k gradient is out of its size " << size;
+        }
+        grad[index] += LoadValue<float>(values, j);
+      }
+      break;
+    }
+    case GradCompressionType::kRandomK: {
+      if (compressed.count() > size) {
+        MS_LOG(EXCEPTION) << "The random-k gradient keeps " << compressed.count() << " of its " << size
+                          << " elements.";
+      }
+      CheckValuesSize(compressed, compressed.count() * sizeof(float));
+      auto indices = RandomIndices(compressed.seed(), size, compressed.count());
+      for (size_t j = 0; j < indices.size(); ++j) {
+        grad[indices[j]] += LoadValue<float>(values, j);
+      }
+      break;
+    }
+    default:
+      MS_LOG(EXCEPTION) << "The gradient compression type " << compressed.type() << " is not supported.";
+  }
+}
+
+GradCompressionMetrics GradientCompressor::metrics() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return metrics_;
+}
+}  // namespace ps
+}  // namespace mindspore
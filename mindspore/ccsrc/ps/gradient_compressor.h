@@ -0,0 +1,76 @@
+/**
+ * Copyright 2021 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MINDSPORE_CCSRC_PS_GRADIENT_COMPRESSOR_H_
+#define MINDSPORE_CCSRC_PS_GRADIENT_COMPRESSOR_H_
+
+#include <mutex>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "ps/constants.h"
+#include "proto/ps.pb.h"
+
+namespace mindspore {
+namespace ps {
+enum class GradCompressionType { kNone = 0, kFp16 = 1, kInt8 = 2, kTopK = 3, kRandomK = 4 };
+
+struct GradCompressionMetrics {
+  uint64_t compress_count{0};
+  // bytes of the gradients before and after the encoding
+  uint64_t raw_bytes{0};
+  uint64_t compressed_bytes{0};
+  uint64_t compress_us{0};
+
+  double ratio() const { return compressed_bytes == 0 ? 0 : static_cast<double>(raw_bytes) / compressed_bytes; }
+};
+
+// Lossy encodings of the dense gradients pushed by a worker, which the servers add to the accumulated gradient
+// without decoding them into a dense one first:
+//  - fp16 and int8 quantize every element, int8 with a scale per block of elements.
+//  - top-k keeps the ratio of the elements with the largest magnitudes and their positions, random-k keeps a random
+//    ratio of them and only the seed the servers draw the same positions from.
+// What an encoding loses is kept as the residual of the key and added to its next gradient (error feedback), so every
+// update reaches the servers eventually.
+class GradientCompressor {
+ public:
+  GradientCompressor(GradCompressionType type, float ratio);
+  ~GradientCompressor() = default;
+  GradientCompressor(const GradientCompressor &) = delete;
+  GradientCompressor &operator=(const GradientCompressor &) = delete;
+
+  void Compress(const Key &key, const float *grad, size_t size, CompressedGradient *compressed);
+  // Adds the gradient to grad, which has size elements.
+  static void Accumulate(const CompressedGradient &compressed, float *grad, size_t size);
+  GradCompressionMetrics metrics() const;
+
+  // fp16, int8, topk or randomk, none or an empty name disables the compression
+  static GradCompressionType TypeFromName(const std::string &name);
+
+ private:
+  static std::vector<uint32_t> RandomIndices(uint64_t seed, size_t size, size_t count);
+
+  GradCompressionType type_;
+  float ratio_;
+  std::unordered_map<Key, std::vector<float>> residuals_;
+  std::mt19937_64 seed_engine_;
+  GradCompressionMetrics metrics_;
+  mutable std::mutex mutex_;
+};
+}  // namespace ps
+}  // namespace mindspore
+#endif  // MINDSPORE_CCSRC_PS_GRADIENT_COMPRESSOR_H_
@@ -0,0 +1,127 @@
+/**
+ * Copyright 2021 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ps/gradient_push_pipeline.h"
+#include <chrono>
+#include "utils/log_adapter.h"
+
+namespace mindspore {
+namespace ps {
+namespace {
+uint64_t ElapsedUs(const std::chrono::steady_clock::time_point &start) {
+  return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+}
+}  // namespace
+
+GradientPushPipeline::GradientPushPipeline(size_t window) : window_(window) {
+  if (window_ == 0) {
+    MS_LOG(EXCEPTION) << "The window of the gradient push pipeline should be at least 1.";
+  }
+  send_thread_ = std::thread(&GradientPushPipeline::SendLoop, this);
+}
+
+GradientPushPipeline::~GradientPushPipeline() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  queued_cond_.notify_all();
+  if (send_thread_.joinable()) {
+    send_thread_.join();
+  }
+}
+
+void GradientPushPipeline::Push(const Key &key, const Sender &sender) {
+  MS_EXCEPTION_IF_NULL(sender);
+  auto start = std::chrono::steady_clock::now();
+  std::unique_lock<std::mutex> lock(mutex_);
+  acked_cond_.wait(lock, [this] { return pushes_.size() < window_ || send_error_ != nullptr; });
+  RethrowSendError();
+  metrics_.blocked_us += ElapsedUs(start);
+  metrics_.push_count++;
+  pushes_.emplace_back(key, sender);
+  key_push_num_[key]++;
+  lock.unlock();
+  queued_cond_.notify_one();
+}
+
+void GradientPushPipeline::Wait(const Key &key) {
+  auto start = std::chrono::steady_clock::now();
+  std::unique_lock<std::mutex> lock(mutex_);
+  acked_cond_.wait(lock, [this, &key] { return key_push_num_.count(key) == 0 || send_error_ != nullptr; });
+  RethrowSendError();
+  metrics_.pull_wait_us += ElapsedUs(start);
+}
+
+void GradientPushPipeline::Flush() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  acked_cond_.wait(lock, [this] { return pushes_.empty() || send_error_ != nullptr; });
+  RethrowSendError();
+  MS_LOG(INFO) << "Gradient push pipeline flushed, pushes: " << metrics_.push_count
+               << ", blocked: " << metrics_.blocked_us << "us, pulls waiting: " << metrics_.pull_wait_us
+               << "us, sending: " << metrics_.send_us << "us";
+}
+
+GradientPushMetrics GradientPushPipeline::metrics() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return metrics_;
+}
+
+void GradientPushPipeline::SendLoop() {
+  while (true) {
+    Sender sender;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      queued_cond_.wait(lock, [this] { return stop_ || !pushes_.empty(); });
+      // pushes queued before the pipeline is destroyed are still sent
+      if (pushes_.empty()) {
+        return;
+      }
+      sender = pushes_.front().second;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    std::exception_ptr error = nullptr;
+    try {
+      sender();
+    } catch (const std::exception &e) {
+      MS_LOG(ERROR) << "Pushing gradients failed: " << e.what();
+      error = std::current_exception();
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      metrics_.send_us += ElapsedUs(start);
+      auto iter = key_push_num_.find(pushes_.front().first);
+      if (iter != key_push_num_.end() && --iter->second == 0) {
+        (void)key_push_num_.erase(iter);
+      }
+      pushes_.pop_front();
+      if (error != nullptr) {
+        send_error_ = error;
+      }
+    }
+    acked_cond_.notify_all();
+  }
+}
+
+void GradientPushPipeline::RethrowSendError() {
+  if (send_error_ != nullptr) {
+    std::rethrow_exception(send_error_);
+  }
+}
+}  // namespace ps
+}  // namespace mindspore
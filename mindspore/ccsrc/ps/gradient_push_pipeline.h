@@ -0,0 +1,80 @@
+/**
+ * Copyright 2021 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MINDSPORE_CCSRC_PS_GRADIENT_PUSH_PIPELINE_H_
+#define MINDSPORE_CCSRC_PS_GRADIENT_PUSH_PIPELINE_H_
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include "ps/constants.h"
+
+namespace mindspore {
+namespace ps {
+struct GradientPushMetrics {
+  uint64_t push_count{0};
+  // time pushes waited for room in the window, pulls waited for the pushes of their key and the sends took, in
+  // microseconds
+  uint64_t blocked_us{0};
+  uint64_t pull_wait_us{0};
+  uint64_t send_us{0};
+};
+
+// Gradient pushes of a worker sent one after the other on a background thread, so that sending the gradient of a
+// parameter overlaps the backward pass and the pushes of the others:
+//  - Push queues the send and blocks while window pushes are not acknowledged yet.
+//  - Wait blocks until every push of a key is acknowledged, the pull of the updated weight calls it first.
+// The servers accumulate the gradients of a step, so unlike embedding rows nothing is coalesced.
+class GradientPushPipeline {
+ public:
+  using Sender = std::function<void()>;
+
+  explicit GradientPushPipeline(size_t window);
+  ~GradientPushPipeline();
+  GradientPushPipeline(const GradientPushPipeline &) = delete;
+  GradientPushPipeline &operator=(const GradientPushPipeline &) = delete;
+
+  void Push(const Key &key, const Sender &sender);
+  void Wait(const Key &key);
+  // Waits until every push is acknowledged by the servers.
+  void Flush();
+  GradientPushMetrics metrics() const;
+
+ private:
+  void SendLoop();
+  void RethrowSendError();
+
+  size_t window_;
+  // oldest first, the front one is being sent
+  std::deque<std::pair<Key, Sender>> pushes_;
+  // pushes of every key queued or being sent
+  std::unordered_map<Key, size_t> key_push_num_;
+  bool stop_{false};
+  std::exception_ptr send_error_;
+  mutable std::mutex mutex_;
+  std::condition_variable queued_cond_;
+  std::condition_variable acked_cond_;
+  GradientPushMetrics metrics_;
+  std::thread send_thread_;
+};
+}  // namespace ps
+}  // namespace mindspore
+#endif  // MINDSPORE_CCSRC_PS_GRADIENT_PUSH_PIPELINE_H_
@@ -0,0 +1,107 @@
+/**
+ * Copyright 2021 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ps/kv_message_frame.h"
+#include <cstring>
+#include <limits>
+#include "utils/convert_utils_base.h"
+#include "utils/log_adapter.h"
+
+namespace mindspore {
+namespace ps {
+namespace {
+// the values start at a multiple of the alignment, the buffers of the transport are aligned to at least that
+constexpr size_t kValuesAlign = 8;
+
+size_t ValuesOffset(size_t header_size) {
+  size_t end = sizeof(uint32_t) + header_size;
+  return (end + kValuesAlign - 1) / kValuesAlign * kValuesAlign;
+}
+}  // namespace
+
+size_t KVMessageFrame::Size(const KVMessage &header, size_t value_num) {
+  return ValuesOffset(header.ByteSizeLong()) + value_num * sizeof(float);
+}
+
+float *KVMessageFrame::Write(const KVMessage &header, size_t value_num, void *buffer, size_t size) {
+  MS_EXCEPTION_IF_NULL(buffer);
+  if (header.values_size() != 0) {
+    MS_LOG(EXCEPTION) << "The header of a frame should not hold values, but it has " << header.values_size();
+  }
+  size_t header_size = header.ByteSizeLong();
+  if (header_size > std::numeric_limits<uint32_t>::max() || size != Size(header, value_num)) {
+    MS_LOG(EXCEPTION) << "The frame of a " << header_size << " bytes header and " << value_num
+                      << " values does not fit in " << size << " bytes.";
+  }
+  auto bytes = reinterpret_cast<unsigned char *>(buffer);
+  uint32_t header_len = static_cast<uint32_t>(header_size);
+  (void)memcpy(bytes, &header_len, sizeof(header_len));
+  if (!header.SerializeToArray(bytes + sizeof(header_len), static_cast<int>(header_size))) {
+    MS_LOG(EXCEPTION) << "Serialize the header of a frame failed.";
+  }
+  size_t offset = ValuesOffset(header_size);
+  (void)memset(bytes + sizeof(header_len) + header_size, 0, offset - sizeof(header_len) - header_size);
+  return reinterpret_cast<float *>(bytes + offset);
+}
+
+float *KVMessageFrame::Write(const KVMessage &header, size_t value_num, std::vector<unsigned char> *output) {
+  MS_EXCEPTION_IF_NULL(output);
+  output->resize(Size(header, value_num));
+  return Write(header, value_num, output->data(), output->size());
+}
+
+DataPtr KVMessageFrame::Encode(const KVMessage &header, const float *values, size_t value_num, size_t *size) {
+  MS_EXCEPTION_IF_NULL(size);
+  *size = Size(header, value_num);
+  DataPtr frame(new unsigned char[*size]);
+  float *frame_values = Write(header, value_num, frame.get(), *size);
+  if (value_num > 0) {
+    MS_EXCEPTION_IF_NULL(values);
+    (void)memcpy(frame_values, values, value_num * sizeof(float));
+  }
+  return frame;
+}
+
+DataPtr KVMessageFrame::Encode(KVMessage *message, size_t *size) {
+  MS_EXCEPTION_IF_NULL(message);
+  google::protobuf::RepeatedField<float> values;
+  values.Swap(message->mutable_values());
+  return Encode(*message, values.data(), IntToSize(values.size()), size);
+}
+
+const float *KVMessageFrame::Decode(const void *data, size_t size, KVMessage *header, size_t *value_num) {
+  MS_EXCEPTION_IF_NULL(data);
+  MS_EXCEPTION_IF_NULL(header);
+  MS_EXCEPTION_IF_NULL(value_num);
+  auto bytes = reinterpret_cast<const unsigned char *>(data);
+  uint32_t header_len = 0;
+  if (size < sizeof(header_len)) {
+    MS_LOG(EXCEPTION) << "The frame of " << size << " bytes has no header.";
+  }
+  (void)memcpy(&header_len, bytes, sizeof(header_len));
+  size_t offset = ValuesOffset(header_len);
+  if (offset > size || (size - offset) % sizeof(float) != 0) {
+    MS_LOG(EXCEPTION) << "The frame of " << size << " bytes does not hold a " << header_len
+                      << " bytes header and whole values.";
+  }
+  if (!header->ParseFromArray(bytes + sizeof(header_len), static_cast<int>(header_len))) {
+    MS_LOG(EXCEPTION) << "Parse the " << header_len << " bytes header of a frame failed.";
+  }
+  *value_num = (size - offset) / sizeof(float);
+  return reinterpret_cast<const float *>(bytes + offset);
+}
+}  // namespace ps
+}  // namespace mindspore
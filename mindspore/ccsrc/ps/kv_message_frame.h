@@ -0,0 +1,48 @@
+/**
+ * Copyright 2021 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MINDSPORE_CCSRC_PS_KV_MESSAGE_FRAME_H_
+#define MINDSPORE_CCSRC_PS_KV_MESSAGE_FRAME_H_
+
+#include <memory>
+#include <vector>
+#include "ps/constants.h"
+#include "proto/ps.pb.h"
+
+namespace mindspore {
+namespace ps {
+// The data of a KVMessage between workers and servers: the size of the header as a uint32, the message without its
+// values as the header, padding, then the values as raw floats. The values never go through the repeated field of
+// protobuf, which copies them on every serialization and parse: the sender writes them once into the frame and the
+// receiver reads them in place from the buffer the transport received the frame into.
+class KVMessageFrame {
+ public:
+  // The size of the frame of a header followed by value_num values.
+  static size_t Size(const KVMessage &header, size_t value_num);
+  // Writes the header into buffer of Size(header, value_num) bytes, returns where the values go.
+  static float *Write(const KVMessage &header, size_t value_num, void *buffer, size_t size);
+  // Resizes output to the frame and writes the header into it, returns where the values go.
+  static float *Write(const KVMessage &header, size_t value_num, std::vector<unsigned char> *output);
+  // Allocates a frame of the header followed by a copy of the values.
+  static DataPtr Encode(const KVMessage &header, const float *values, size_t value_num, size_t *size);
+  // Same as above for a message holding its values, which are moved out of the message into the frame.
+  static DataPtr Encode(KVMessage *message, size_t *size);
+  // Parses the header of a received frame, returns its values in place and their number in value_num.
+  static const float *Decode(const void *data, size_t size, KVMessage *header, size_t *value_num);
+};
+}  // namespace ps
+}  // namespace mindspore
+#endif  // MINDSPORE_CCSRC_PS_KV_MESSAGE_FRAME_H_
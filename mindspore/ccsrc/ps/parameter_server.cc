@@ -18,6 +18,20 @@
 
 namespace mindspore {
 namespace ps {
+namespace {
+constexpr uint64_t kEmbeddingStoreMetricsInterval = 1000;
+// rows of a store table are initialized and saved this many bytes at a time
+constexpr size_t kEmbeddingStoreChunkBytes = 64 << 20;
+
+void LogEmbeddingStoreMetrics(const Key &key, const EmbeddingStoreMetrics &metrics) {
+  MS_LOG(INFO) << "Embedding store of key " << key << ": pulls " << metrics.pull_count << ", pushes "
+               << metrics.push_count << ", dram hit rate " << metrics.hit_rate() << ", pull latency p50 "
+               << metrics.pull_p50_us << "us p90 " << metrics.pull_p90_us << "us p99 " << metrics.pull_p99_us
+               << "us, evicted rows " << metrics.evicted_rows << ", written back rows " << metrics.written_back_rows
+               << ", log bytes " << metrics.log_bytes;
+}
+}  // namespace
+
 void ParameterServer::Run(const FuncGraphPtr &func_graph) {
   MS_EXCEPTION_IF_NULL(func_graph);
   MS_LOG(INFO) << "PServer starts connecting to scheduler and workers...";
@@ -42,6 +56,12 @@ void ParameterServer::Run(const FuncGraphPtr &func_graph) {
 bool ParameterServer::Init(const FuncGraphPtr &func_graph) {
   pserver_num_ = std::strtol(mindspore::common::GetEnv(kEnvPServerNum).c_str(), nullptr, 10);
   worker_num_ = std::strtol(mindspore::common::GetEnv(kEnvWorkerNum).c_str(), nullptr, 10);
+  embedding_store_path_ = mindspore::common::GetEnv(kEnvEmbeddingStorePath);
+  embedding_store_dram_size_ =
+    std::strtoull(mindspore::common::GetEnv(kEnvEmbeddingStoreDramSize).c_str(), nullptr, 10) << 20;
+  if (mindspore::common::GetEnv(kEnvEmbeddingStorePolicy) == "lfu") {
+    embedding_store_policy_ = EvictionPolicy::kLFU;
+  }
   func_graph_ = func_graph;
   handler_.reset(new ServerHandler(this));
   handler_->Init();
@@ -159,14 +179,29 @@ void ParameterServer::InitEmbeddingTable(
   const Key &key, const std::shared_ptr<std::vector<std::shared_ptr<std::vector<size_t>>>> &shapes,
   const ParamInitInfo &param_init_info) {
   MS_EXCEPTION_IF_NULL(shapes);
-  if (weights_.count(key) == 0) {
+  if (weights_.count(key) == 0 && embedding_stores_.count(key) == 0) {
     std::shared_ptr<PServerKernel> lookup =
       std::make_shared<kernel::ps::EmbeddingLookUpPSKernel>(server_node_->rank_id(), pserver_num_, worker_num_);
     lookup->InitKernel(shapes);
     embedding_lookup_ops_[key] = lookup;
+    tokens_[key] = 0;
+    is_embedding_[key] = true;
+    grads_accum_counter_[key] = 0;
 
-    // Init embedding weight
     const std::vector<size_t> &input_shapes = lookup->input_sizes();
+    auto store = CreateEmbeddingStore(key, input_shapes, param_init_info);
+    if (store != nullptr) {
+      size_t first_dim = (*shapes)[0]->at(0);
+      size_t offset = 0;
+      for (size_t i = 0; i < server_node_->rank_id(); i++) {
+        offset += Util::LocalShard(first_dim, i, pserver_num_);
+      }
+      embedding_stores_[key] = store;
+      embedding_offsets_[key] = offset;
+      return;
+    }
+
+    // Init embedding weight
     size_t total_dims =
       std::accumulate(input_shapes.begin(), input_shapes.end(), IntToSize(1), std::multiplies<size_t>());
     WeightPtr embedding = std::make_shared<Weight>(total_dims, 0);
@@ -189,11 +224,52 @@ void ParameterServer::InitEmbeddingTable(
     }
     weights_[key] = embedding;
     MS_LOG(DEBUG) << "The key:" << key << " the embedding:" << *embedding;
-    tokens_[key] = 0;
-    is_embedding_[key] = true;
+  }
+}
 
-    grads_accum_counter_[key] = 0;
+std::shared_ptr<EmbeddingStore> ParameterServer::CreateEmbeddingStore(const Key &key,
+                                                                      const std::vector<size_t> &input_shapes,
+                                                                      const ParamInitInfo &param_init_info) {
+  size_t total_dims =
+    std::accumulate(input_shapes.begin(), input_shapes.end(), IntToSize(1), std::multiplies<size_t>());
+  if (embedding_store_path_.empty() || !ps::PsDataPrefetch::GetInstance().cache_enable() || input_shapes.empty() ||
+      input_shapes[0] == 0 || total_dims * sizeof(float) <= embedding_store_dram_size_) {
+    return nullptr;
+  }
+  size_t row_size = total_dims / input_shapes[0];
+  size_t dram_row_num = embedding_store_dram_size_ / (row_size * sizeof(float));
+  EmbeddingStore::RowInitializer initializer;
+  if (param_init_info.param_type_ == kAccumulation) {
+    float init_val = param_init_info.init_val_;
+    initializer = [init_val](size_t, float *data, size_t size) { std::fill(data, data + size, init_val); };
+  } else {
+    // every row is loaded into the log below
+    initializer = [key](size_t row, float *, size_t) {
+      MS_LOG(EXCEPTION) << "Row " << row << " of the embedding store of key " << key << " was not loaded.";
+    };
+  }
+  auto store =
+    std::make_shared<EmbeddingStore>(input_shapes[0], row_size, dram_row_num, embedding_store_policy_, initializer);
+  std::string log_path = embedding_store_path_ + "/embedding_store_" + std::to_string(server_node_->rank_id()) + "_" +
+                         std::to_string(key) + ".log";
+  if (!store->Open(log_path)) {
+    MS_LOG(EXCEPTION) << "Create the embedding store of key " << key << " in " << embedding_store_path_ << " failed.";
+  }
+  if (param_init_info.param_type_ == kWeight) {
+    // the same values InitRandomNormal gives the table in weights_, produced a chunk of rows at a time
+    size_t chunk_rows = std::max<size_t>(kEmbeddingStoreChunkBytes / (row_size * sizeof(float)), 1);
+    size_t begin = 0;
+    bool ret = InitRandomNormal(0.01, input_shapes, param_init_info.global_seed_, param_init_info.op_seed_,
+                                chunk_rows * row_size, [&store, &begin, row_size](const float *data, size_t size) {
+                                  store->Load(begin, size / row_size, data);
+                                  begin += size / row_size;
+                                  return true;
+                                });
+    if (!ret) {
+      MS_LOG(EXCEPTION) << "Init the embedding store of key " << key << " failed.";
+    }
   }
+  return store;
 }
 
 bool ParameterServer::HasWeight(const Key &key) { return (weights_.count(key) > 0 && !is_embedding_.count(key)); }
@@ -252,12 +328,17 @@ void ParameterServer::UpdateWeights() {
   }
 }
 
-void ParameterServer::AccumGrad(const Keys &keys, const Values &values, const Lengths &lengths) {
+void ParameterServer::AccumGrad(const Keys &keys, const Values &values, const Lengths &lengths,
+                                const CompressedGradient *compressed) {
   std::unique_lock<std::mutex> lock(mutex_);
   const Key &key = keys[0];
   bool no_sparse_grad = values.size() == 1 && values[0] == -100;
   if (!no_sparse_grad) {
     std::shared_ptr<OptimizerInfo> optim_info = optim_infos_[key];
+    if (compressed != nullptr && (compressed->index() < 0 || IntToSize(compressed->index()) >= lengths.size() ||
+                                  lengths[compressed->index()] != 0)) {
+      MS_LOG(EXCEPTION) << "The compressed gradient of key " << key << " has invalid index " << compressed->index();
+    }
 
     // Create or update the optimizer info
     if (optim_info == nullptr) {
@@ -267,13 +348,35 @@ void ParameterServer::AccumGrad(const Keys &keys, const Values &values, const Le
         MS_LOG(EXCEPTION) << "no optimizer found for key " << key << " optim name " << weight_key_to_optims_[key];
       }
       MS_EXCEPTION_IF_NULL(pserver_kernel);
-      OptimizerInfo *optim = builder->Build(pserver_kernel, weights_[key], keys, values, lengths,
-                                            optim_inputs_shape_[key], worker_num_, is_embedding_[key]);
-      optim_info.reset(optim);
+      if (compressed == nullptr) {
+        OptimizerInfo *optim = builder->Build(pserver_kernel, weights_[key], keys, values, lengths,
+                                              optim_inputs_shape_[key], worker_num_, is_embedding_[key]);
+        optim_info.reset(optim);
+      } else {
+        // the optimizer info keeps the gradient of the first push, so it is decoded into the dense inputs once
+        Values dense_values(values);
+        Lengths dense_lengths(lengths);
+        size_t grad_offset = std::accumulate(lengths.begin(), lengths.begin() + compressed->index(), IntToSize(0));
+        (void)dense_values.insert(dense_values.begin() + grad_offset, compressed->size(), 0);
+        GradientCompressor::Accumulate(*compressed, dense_values.data() + grad_offset, compressed->size());
+        dense_lengths[compressed->index()] = SizeToInt(compressed->size());
+        OptimizerInfo *optim = builder->Build(pserver_kernel, weights_[key], keys, dense_values, dense_lengths,
+                                              optim_inputs_shape_[key], worker_num_, is_embedding_[key]);
+        optim_info.reset(optim);
+      }
       optim_infos_[key] = optim_info;
-    } else {
+    } else if (compressed == nullptr) {
       optim_info->Update(values, lengths);
       optim_info->Accumulate(values, lengths);
+    } else {
+      if (optim_info->IsSparse()) {
+        MS_LOG(EXCEPTION) << "The gradient of the sparse optimizer of key " << key << " can not be compressed.";
+      }
+      // the gradient of length 0 leaves the offsets of the other inputs as they are sent
+      optim_info->Update(values, lengths);
+      MS_EXCEPTION_IF_NULL(optim_info->gradient());
+      GradientCompressor::Accumulate(*compressed, reinterpret_cast<float *>(optim_info->gradient()->addr),
+                                     optim_info->gradient()->size / sizeof(float));
     }
   }
 
@@ -300,15 +403,32 @@ WeightPtr ParameterServer::weight(const Key &key) {
   return copy_weight_ptr;
 }
 
-void ParameterServer::DoEmbeddingLookup(Key key, const LookupIds &lookup_ids, KVMessage *res) {
+void ParameterServer::DoEmbeddingLookup(Key key, const LookupIds &lookup_ids, KVMessage *res, VectorPtr output) {
   std::unique_lock<std::mutex> lock(mutex_);
   MS_EXCEPTION_IF_NULL(res);
+  MS_EXCEPTION_IF_NULL(output);
+  // the rows are looked up straight into the frame of the response
+  auto store_iter = embedding_stores_.find(key);
+  if (store_iter != embedding_stores_.end()) {
+    auto &store = store_iter->second;
+    size_t value_num = lookup_ids.size() * store->row_size();
+    res->add_len(SizeToInt(value_num));
+    float *values = KVMessageFrame::Write(*res, value_num, output.get());
+    store->Lookup(lookup_ids.data(), lookup_ids.size(), embedding_offsets_[key], values);
+    auto metrics = store->metrics();
+    if (metrics.pull_count % kEmbeddingStoreMetricsInterval == 0) {
+      LogEmbeddingStoreMetrics(key, metrics);
+    }
+    return;
+  }
   if (weights_.count(key) == 0) {
     MS_LOG(ERROR) << "Invalid embedding table key " << key;
+    (void)KVMessageFrame::Write(*res, 0, output.get());
     return;
   }
   if (embedding_lookup_ops_.count(key) == 0) {
     MS_LOG(ERROR) << "Invalid embedding lookup op key " << key;
+    (void)KVMessageFrame::Write(*res, 0, output.get());
     return;
   }
   WeightPtr table_ptr = weights_[key];
@@ -344,21 +464,24 @@ void ParameterServer::DoEmbeddingLookup(Key key, const LookupIds &lookup_ids, KV
 
   std::vector<kernel::AddressPtr> workspaces;
   std::vector<kernel::AddressPtr> outputs;
-  AddressPtr output = std::make_shared<kernel::Address>();
-  MS_EXCEPTION_IF_NULL(output);
-  std::shared_ptr<Values> addr = std::make_shared<Values>(output_shapes[0] / sizeof(float), 0);
-  MS_EXCEPTION_IF_NULL(addr);
-
-  output->addr = addr->data();
-  output->size = output_shapes[0];
-  outputs.push_back(output);
+  AddressPtr lookup_output = std::make_shared<kernel::Address>();
+  MS_EXCEPTION_IF_NULL(lookup_output);
+  size_t value_num = output_shapes[0] / sizeof(float);
+  res->add_len(SizeToInt(value_num));
+  lookup_output->addr = KVMessageFrame::Write(*res, value_num, output.get());
+  lookup_output->size = output_shapes[0];
+  outputs.push_back(lookup_output);
 
   table_lookup_op->Execute(inputs, workspaces, outputs);
-  *res->mutable_values() = {addr->begin(), addr->end()};
-  res->add_len(res->values_size());
 }
 
-void ParameterServer::UpdateEmbeddings(const Key &key, const LookupIds &lookup_ids, const Values &vals) {
+void ParameterServer::UpdateEmbeddings(const Key &key, const LookupIds &lookup_ids, const float *vals) {
+  MS_EXCEPTION_IF_NULL(vals);
+  auto store_iter = embedding_stores_.find(key);
+  if (store_iter != embedding_stores_.end()) {
+    store_iter->second->Update(lookup_ids.data(), vals, lookup_ids.size(), embedding_offsets_[key]);
+    return;
+  }
   if (weights_.count(key) == 0) {
     MS_LOG(ERROR) << "Invalid embedding table key " << key;
     return;
@@ -371,7 +494,7 @@ void ParameterServer::UpdateEmbeddings(const Key &key, const LookupIds &lookup_i
   MS_EXCEPTION_IF_NULL(table_ptr);
   std::shared_ptr<PServerKernel> table_lookup_op = embedding_lookup_ops_[key];
   MS_EXCEPTION_IF_NULL(table_lookup_op);
-  table_lookup_op->UpdateEmbeddings(table_ptr->data(), lookup_ids.data(), vals.data(), lookup_ids.size());
+  table_lookup_op->UpdateEmbeddings(table_ptr->data(), lookup_ids.data(), vals, lookup_ids.size());
 }
 
 inline bool ParameterServer::ReadyForUpdateWeights() {
@@ -453,16 +576,23 @@ void ParameterServer::SyncEmbeddingTables() {
     const std::vector<size_t> &input_shapes = lookup->input_sizes();
     std::vector<int64_t> new_tensor_shape(input_shapes.begin(), input_shapes.end());
 
+    auto store_iter = embedding_stores_.find(key);
+    if (store_iter != embedding_stores_.end()) {
+      LogEmbeddingStoreMetrics(key, store_iter->second->metrics());
+      SaveEmbeddingStore(store_iter->second, embedding_table.second->name(), new_tensor_shape);
+      continue;
+    }
+
     tensor::TensorPtr new_tensor = std::make_shared<tensor::Tensor>(kNumberTypeFloat32, new_tensor_shape);
     MS_EXCEPTION_IF_NULL(new_tensor);
     float *new_tensor_data_ptr = reinterpret_cast<float *>(new_tensor->data_c());
     size_t new_tensor_size = static_cast<size_t>(new_tensor->data().nbytes());
+    MS_EXCEPTION_IF_NULL(new_tensor_data_ptr);
     size_t embedding_table_size = weights_[key]->size() * sizeof(float);
     if (new_tensor_size != embedding_table_size) {
       MS_LOG(EXCEPTION) << "Shape of embedding table can't match. New tensor size:" << new_tensor_size
                         << ", embedding_table size:" << embedding_table_size;
     }
-    MS_EXCEPTION_IF_NULL(new_tensor_data_ptr);
     MS_EXCEPTION_IF_NULL(weights_[key]->data());
     int64_t ret = memcpy_s(new_tensor_data_ptr, new_tensor_size, weights_[key]->data(), embedding_table_size);
     if (ret != 0) {
@@ -476,6 +606,42 @@ void ParameterServer::SyncEmbeddingTables() {
   }
 }
 
+void ParameterServer::SaveEmbeddingStore(const std::shared_ptr<EmbeddingStore> &store, const std::string &name,
+                                         const std::vector<int64_t> &shape) {
+  MS_EXCEPTION_IF_NULL(store);
+  // slices of the table one after the other in the layout save_checkpoint writes large parameters in, so
+  // load_checkpoint concatenates them and the shard is never in memory as a whole
+  std::string ckpt_path =
+    embedding_store_path_ + "/PServer_" + std::to_string(server_node_->rank_id()) + "_" + name + ".ckpt";
+  std::ofstream ofs(ckpt_path, std::ios::binary | std::ios::trunc);
+  if (!ofs.is_open()) {
+    MS_LOG(EXCEPTION) << "Open " << ckpt_path << " failed.";
+  }
+  size_t row_size = store->row_size();
+  size_t chunk_rows = std::max<size_t>(kEmbeddingStoreChunkBytes / (row_size * sizeof(float)), 1);
+  for (size_t begin = 0; begin < store->row_num(); begin += chunk_rows) {
+    size_t num = std::min(chunk_rows, store->row_num() - begin);
+    Checkpoint checkpoint;
+    auto value = checkpoint.add_value();
+    value->set_tag(name);
+    auto tensor = value->mutable_tensor();
+    for (auto dim : shape) {
+      tensor->add_dims(dim);
+    }
+    tensor->set_tensor_type("Float32");
+    std::string *content = tensor->mutable_tensor_content();
+    content->resize(num * row_size * sizeof(float));
+    store->Export(begin, num, reinterpret_cast<float *>(&(*content)[0]), num * row_size);
+    if (!checkpoint.SerializeToOstream(&ofs)) {
+      MS_LOG(EXCEPTION) << "Write rows [" << begin << ", " << begin + num << ") of " << name << " to " << ckpt_path
+                        << " failed.";
+    }
+  }
+  ofs.close();
+  MS_LOG(INFO) << "The embedding table " << name << " of " << store->row_num() << " rows is saved to " << ckpt_path
+               << ", the parameter keeps its initial value.";
+}
+
 void ParameterServer::ServerHandler::Init() {
   handlers_[kInitWeightsCmd] = &ServerHandler::HandleInitWeights;
   handlers_[kInitWeightToOptimIdCmd] = &ServerHandler::HandleInitWeightToOptimId;
@@ -530,29 +696,31 @@ void ParameterServer::ServerHandler::operator()(std::shared_ptr<core::TcpConnect
 void ParameterServer::ServerHandler::HandlePushReq(DataPtr data, size_t size, VectorPtr res) {
   MS_EXCEPTION_IF_NULL(res);
   KVMessage input;
-  input.ParseFromArray(data.get(), size);
+  size_t value_num = 0;
+  const float *input_values = KVMessageFrame::Decode(data.get(), size, &input, &value_num);
   Keys keys = {input.keys().begin(), input.keys().end()};
-  Values values = {input.values().begin(), input.values().end()};
+  Values values = {input_values, input_values + value_num};
   Lengths lens = {input.len().begin(), input.len().end()};
   MS_LOG(DEBUG) << "The keys:" << keys << " the values:" << values << " the len:" << lens;
-  ps_->AccumGrad(keys, values, lens);
+  ps_->AccumGrad(keys, values, lens, input.has_grad() ? &input.grad() : nullptr);
 }
 
 void ParameterServer::ServerHandler::HandlePullReq(DataPtr data, size_t size, VectorPtr res) {
   MS_EXCEPTION_IF_NULL(res);
   KVMessage input;
-  input.ParseFromArray(data.get(), size);
+  size_t value_num = 0;
+  (void)KVMessageFrame::Decode(data.get(), size, &input, &value_num);
   KVMessage res_data;
   *res_data.mutable_keys() = input.keys();
   Key key = input.keys()[0];
   auto weight = ps_->weight(key);
-  *res_data.mutable_values() = {weight->begin(), weight->end()};
-  res->resize(res_data.ByteSizeLong());
-  size_t dest_size = res_data.ByteSizeLong();
-  size_t src_size = res_data.ByteSizeLong();
-  int ret = memcpy_s(res->data(), dest_size, res_data.SerializeAsString().data(), src_size);
-  if (ret != 0) {
-    MS_LOG(EXCEPTION) << "The memcpy_s error, errorno(" << ret << ")";
+  // the weight is copied once, into the frame of the response
+  float *values = KVMessageFrame::Write(res_data, weight->size(), res.get());
+  if (!weight->empty()) {
+    int ret = memcpy_s(values, weight->size() * sizeof(float), weight->data(), weight->size() * sizeof(float));
+    if (ret != 0) {
+      MS_LOG(EXCEPTION) << "The memcpy_s error, errorno(" << ret << ")";
+    }
   }
 }
 
@@ -560,13 +728,16 @@ void ParameterServer::ServerHandler::HandleInitWeights(DataPtr data, size_t size
   std::unique_lock<std::mutex> lock(ps_->mutex());
   MS_EXCEPTION_IF_NULL(res);
   KVMessage input;
-  input.ParseFromArray(data.get(), size);
+  size_t value_num = 0;
+  const float *data_ptr = KVMessageFrame::Decode(data.get(), size, &input, &value_num);
   int key_num = input.keys_size();
-  const float *data_ptr = input.values().data();
   size_t pos = 0;
   for (int i = 0; i < key_num; i++) {
     Key key = input.keys()[i];
-    size_t data_len = input.len_size() != key_num ? input.values_size() / key_num : input.len()[i];
+    size_t data_len = input.len_size() != key_num ? value_num / key_num : input.len()[i];
+    if (pos + data_len > value_num) {
+      MS_LOG(EXCEPTION) << "The weights of " << key_num << " keys exceed the " << value_num << " values sent.";
+    }
 
     if (!ps_->HasWeight(key)) {
       WeightPtr weight_ptr = std::make_shared<std::vector<float>>(data_ptr + pos, data_ptr + (pos + data_len));
@@ -585,11 +756,15 @@ void ParameterServer::ServerHandler::HandleInitWeightToOptimId(DataPtr data, siz
   std::unique_lock<std::mutex> lock(ps_->mutex());
   MS_EXCEPTION_IF_NULL(res);
   KVMessage input;
-  input.ParseFromArray(data.get(), size);
+  size_t value_num = 0;
+  const float *values = KVMessageFrame::Decode(data.get(), size, &input, &value_num);
   size_t key_num = input.keys_size();
+  if (value_num < key_num) {
+    MS_LOG(EXCEPTION) << "The optimizer ids of " << key_num << " keys have " << value_num << " values.";
+  }
   for (size_t i = 0; i < key_num; i++) {
     Key key = input.keys()[i];
-    float val = input.values()[i];
+    float val = values[i];
     if (init_weight_to_optim_[key]) {
       continue;
     } else {
@@ -603,7 +778,8 @@ void ParameterServer::ServerHandler::HandleInitInputsShape(DataPtr data, size_t
   std::unique_lock<std::mutex> lock(ps_->mutex());
   MS_EXCEPTION_IF_NULL(res);
   KVMessage input;
-  input.ParseFromArray(data.get(), size);
+  size_t value_num = 0;
+  const float *input_values = KVMessageFrame::Decode(data.get(), size, &input, &value_num);
   const Key &key = input.keys()[0];
   if (init_optim_info_[key]) {
     return;
@@ -611,7 +787,7 @@ void ParameterServer::ServerHandler::HandleInitInputsShape(DataPtr data, size_t
     init_optim_info_[key] = true;
   }
   Keys keys = {input.keys().begin(), input.keys().end()};
-  Values values = {input.values().begin(), input.values().end()};
+  Values values = {input_values, input_values + value_num};
   Lengths lens = {input.len().begin(), input.len().end()};
   ps_->InitOptimInputsShape(keys, values, lens);
 }
@@ -655,38 +831,26 @@ void ParameterServer::ServerHandler::HandleInitEmbeddings(DataPtr data, size_t s
 void ParameterServer::ServerHandler::HandleCheckReadyForPush(DataPtr data, size_t size, VectorPtr res) {
   MS_EXCEPTION_IF_NULL(res);
   KVMessage input;
-  input.ParseFromArray(data.get(), size);
+  size_t value_num = 0;
+  (void)KVMessageFrame::Decode(data.get(), size, &input, &value_num);
   const Key &key = input.keys()[0];
   bool ready = ps_->ReadyForPush(key);
   MS_LOG(INFO) << "The ready is:" << ready;
   KVMessage res_data;
   res_data.add_keys(key);
-  res_data.add_values(ready);
-  res->resize(res_data.ByteSizeLong());
-  size_t dest_size = res_data.ByteSizeLong();
-  size_t src_size = res_data.ByteSizeLong();
-  int ret = memcpy_s(res->data(), dest_size, res_data.SerializeAsString().data(), src_size);
-  if (ret != 0) {
-    MS_LOG(EXCEPTION) << "The memcpy_s error, errorno(" << ret << ")";
-  }
+  *KVMessageFrame::Write(res_data, 1, res.get()) = ready;
 }
 
 void ParameterServer::ServerHandler::HandleCheckReadyForPull(DataPtr data, size_t size, VectorPtr res) {
   MS_EXCEPTION_IF_NULL(res);
   KVMessage input;
-  input.ParseFromArray(data.get(), size);
+  size_t value_num = 0;
+  (void)KVMessageFrame::Decode(data.get(), size, &input, &value_num);
   const Key &key = input.keys()[0];
   bool ready = ps_->ReadyForPull(key);
   KVMessage res_data;
   res_data.add_keys(key);
-  res_data.add_values(ready);
-  res->resize(res_data.ByteSizeLong());
-  size_t dest_size = res_data.ByteSizeLong();
-  size_t src_size = res_data.ByteSizeLong();
-  int ret = memcpy_s(res->data(), dest_size, res_data.SerializeAsString().data(), src_size);
-  if (ret != 0) {
-    MS_LOG(EXCEPTION) << "The memcpy_s error, errorno(" << ret << ")";
-  }
+  *KVMessageFrame::Write(res_data, 1, res.get()) = ready;
 }
 
 void ParameterServer::ServerHandler::HandleEmbeddingLookup(DataPtr data, size_t size, VectorPtr res) {
@@ -699,25 +863,20 @@ void ParameterServer::ServerHandler::HandleEmbeddingLookup(DataPtr data, size_t
   std::vector<Key> keys = {input.keys().begin(), input.keys().end()};
   *res_data.mutable_keys() = {input.keys().begin(), input.keys().end()};
 
-  ps_->DoEmbeddingLookup(key, keys, &res_data);
-
-  res->resize(res_data.ByteSizeLong());
-  size_t dest_size = res_data.ByteSizeLong();
-  size_t src_size = res_data.ByteSizeLong();
-  int ret = memcpy_s(res->data(), dest_size, res_data.SerializeAsString().data(), src_size);
-  if (ret != 0) {
-    MS_LOG(EXCEPTION) << "The memcpy_s error, errorno(" << ret << ")";
-  }
+  ps_->DoEmbeddingLookup(key, keys, &res_data, res);
 }
 
 void ParameterServer::ServerHandler::HandleUpdateEmbeddings(DataPtr data, size_t size, VectorPtr res) {
   std::unique_lock<std::mutex> lock(ps_->mutex());
   MS_EXCEPTION_IF_NULL(res);
   KVMessage input;
-  input.ParseFromArray(data.get(), size);
+  size_t value_num = 0;
+  const float *update_vals = KVMessageFrame::Decode(data.get(), size, &input, &value_num);
   const Key &key = input.keys()[0];
   const LookupIds &lookup_ids = {input.keys().begin() + 1, input.keys().end()};
-  const Values &update_vals = {input.values().begin(), input.values().end()};
+  if (lookup_ids.empty() || value_num % lookup_ids.size() != 0) {
+    MS_LOG(EXCEPTION) << "The update of " << lookup_ids.size() << " embeddings has " << value_num << " values.";
+  }
   ps_->UpdateEmbeddings(key, lookup_ids, update_vals);
 }
 
@@ -31,6 +31,7 @@
 #include <utility>
 #include <list>
 #include <map>
+#include <fstream>
 #include <functional>
 #include "ir/func_graph.h"
 #include "backend/session/session_basic.h"
@@ -55,9 +56,13 @@
 #include "ps/constants.h"
 #include "ps/util.h"
 #include "ps/embedding_table_shard_metadata.h"
+#include "ps/embedding_store.h"
+#include "ps/gradient_compressor.h"
+#include "ps/kv_message_frame.h"
 #include "utils/log_adapter.h"
 #include "proto/comm.pb.h"
 #include "proto/ps.pb.h"
+#include "proto/checkpoint.pb.h"
 #include "ps/core/server_node.h"
 #include "ps/core/node.h"
 
@@ -125,13 +130,18 @@ class ParameterServer {
   void InitEmbeddingTable(const Key &key,
                           const std::shared_ptr<std::vector<std::shared_ptr<std::vector<size_t>>>> &shapes,
                           const ParamInitInfo &param_init_info);
+  std::shared_ptr<EmbeddingStore> CreateEmbeddingStore(const Key &key, const std::vector<size_t> &input_shapes,
+                                                       const ParamInitInfo &param_init_info);
   bool HasWeight(const Key &key);
   void Finalize();
   void UpdateWeights();
-  void AccumGrad(const Keys &key, const Values &values, const Lengths &lengths);
+  // compressed is the gradient input of a dense push, left out of values
+  void AccumGrad(const Keys &key, const Values &values, const Lengths &lengths,
+                 const CompressedGradient *compressed = nullptr);
   WeightPtr weight(const Key &key);
-  void DoEmbeddingLookup(Key key, const LookupIds &lookup_ids, KVMessage *res);
-  void UpdateEmbeddings(const Key &key, const LookupIds &lookup_ids, const Values &vals);
+  // Writes the frame of res followed by the rows of lookup_ids into output.
+  void DoEmbeddingLookup(Key key, const LookupIds &lookup_ids, KVMessage *res, VectorPtr output);
+  void UpdateEmbeddings(const Key &key, const LookupIds &lookup_ids, const float *vals);
   bool ReadyForUpdateWeights();
   bool ReadyForPush(const Key &key);
   bool ReadyForPull(const Key &key);
@@ -140,6 +150,8 @@ class ParameterServer {
   std::mutex &mutex();
   void GetEmbeddingTableParamPtr();
   void SyncEmbeddingTables();
+  void SaveEmbeddingStore(const std::shared_ptr<EmbeddingStore> &store, const std::string &name,
+                          const std::vector<int64_t> &shape);
 
   size_t pserver_num_;
   size_t worker_num_;
@@ -170,6 +182,14 @@ class ParameterServer {
   std::shared_ptr<core::ServerNode> server_node_;
   std::map<Key, ParameterPtr> embedding_tables_;
 
+  // tables larger than embedding_store_dram_size_ live in a tiered store instead of weights_, only in cache mode
+  // where the server just serves and stores rows
+  std::string embedding_store_path_;
+  size_t embedding_store_dram_size_{0};
+  EvictionPolicy embedding_store_policy_{EvictionPolicy::kLRU};
+  std::unordered_map<Key, std::shared_ptr<EmbeddingStore>> embedding_stores_;
+  std::unordered_map<Key, size_t> embedding_offsets_;
+
   friend class ServerHandler;
 };
 }  // namespace ps
@@ -32,19 +32,21 @@ int EmbeddingHashMap::ParseData(const int id, int *const swap_out_index, int *co
 
   if (!need_swap) {
     hash_count_++;
-    (void)hash_id_to_index_.emplace(id, hash_index);
     hash_map_elements_[hash_index].set_id(id);
     hash_map_elements_[hash_index].set_step(data_step);
+    hash_map_elements_[hash_index].referenced_.store(false, std::memory_order_relaxed);
+    hash_id_to_index_.Insert(id, hash_index);
     return hash_index;
   }
 
   swap_out_index[*swap_out_size] = hash_index;
   swap_out_ids[*swap_out_size] = hash_map_elements_[hash_index].id_;
   (*swap_out_size)++;
-  (void)hash_id_to_index_.erase(hash_map_elements_[hash_index].id_);
-  (void)hash_id_to_index_.emplace(id, hash_index);
+  hash_id_to_index_.Erase(hash_map_elements_[hash_index].id_);
   hash_map_elements_[hash_index].set_id(id);
   hash_map_elements_[hash_index].set_step(data_step);
+  hash_map_elements_[hash_index].referenced_.store(false, std::memory_order_relaxed);
+  hash_id_to_index_.Insert(id, hash_index);
   return hash_index;
 }
 
@@ -53,21 +55,27 @@ int EmbeddingHashMap::FindInsertionPos(const size_t data_step, const size_t grap
   MS_EXCEPTION_IF_NULL(need_swap);
   MS_EXCEPTION_IF_NULL(need_wait_graph);
   int hash_index = INVALID_INDEX_VALUE;
+  // CLOCK: an expired element referenced since the hand last passed gets a second chance, so every element is
+  // evictable within two laps. Elements of the running step are collected in the first lap as the last resort.
   while (!expired_element_full_) {
-    if (hash_map_elements_[current_pos_].IsEmpty()) {
+    auto &element = hash_map_elements_[current_pos_];
+    if (element.IsEmpty()) {
       hash_index = current_pos_;
       hash_count_++;
-    } else if (hash_map_elements_[current_pos_].IsExpired(graph_running_step)) {
-      hash_index = current_pos_;
-      *need_swap = true;
-    } else if (hash_map_elements_[current_pos_].IsStep(graph_running_step)) {
+    } else if (element.IsExpired(graph_running_step)) {
+      if (!element.referenced_.exchange(false, std::memory_order_relaxed)) {
+        hash_index = current_pos_;
+        *need_swap = true;
+      }
+    } else if (element.IsStep(graph_running_step) && swept_num_ < hash_capacity_) {
       graph_running_index_[graph_running_index_num_++] = current_pos_;
     }
     current_pos_ = (current_pos_ + 1) % hash_capacity_;
+    swept_num_++;
     if (hash_index != INVALID_INDEX_VALUE) {
       return hash_index;
     }
-    if (current_pos_ == current_batch_start_pos_) {
+    if (swept_num_ >= 2 * hash_capacity_) {
       expired_element_full_ = true;
       MS_LOG(INFO) << "Running step:" << graph_running_step << "(num:" << graph_running_index_num_
                    << ") will be used, index swap will wait until the graph completed.";
@@ -85,24 +93,23 @@ int EmbeddingHashMap::FindInsertionPos(const size_t data_step, const size_t grap
 void EmbeddingHashMap::DumpHashMap() {
   MS_LOG(INFO) << "Dump hash map info begin, hash_capacity: " << hash_capacity_ << " hash_count: " << hash_count_;
   MS_LOG(INFO) << "Dump hash_id_to_index: ";
-  for (auto iter = hash_id_to_index_.begin(); iter != hash_id_to_index_.end(); ++iter) {
-    MS_LOG(INFO) << "  id: " << iter->first << " index: " << iter->second;
-  }
+  hash_id_to_index_.ForEach([](int id, int index) { MS_LOG(INFO) << "  id: " << id << " index: " << index; });
   MS_LOG(INFO) << "Dump hash_map_unit: ";
-  for (size_t i = 0; i < hash_map_elements_.size(); i++) {
+  for (size_t i = 0; i < hash_capacity_; i++) {
     if (!hash_map_elements_[i].IsEmpty()) {
       MS_LOG(INFO) << "  index: " << i << " id: " << hash_map_elements_[i].id_
-                   << " step: " << hash_map_elements_[i].step_;
+                   << " step: " << hash_map_elements_[i].step();
     }
   }
   MS_LOG(INFO) << "Dump hash map info end.";
 }
 
 void EmbeddingHashMap::Reset() {
-  current_batch_start_pos_ = current_pos_;
+  swept_num_ = 0;
   graph_running_index_num_ = 0;
   graph_running_index_pos_ = 0;
   expired_element_full_ = false;
+  hash_id_to_index_.ReclaimRetired();
 }
 }  // namespace ps
 }  // namespace mindspore
@@ -18,54 +18,68 @@
 #define MINDSPORE_CCSRC_PS_PS_CACHE_EMBEDDING_HASH_MAP_H_
 
 #include <math.h>
+#include <atomic>
 #include <utility>
 #include <memory>
 #include <vector>
-#include <unordered_map>
+#include "ps/ps_cache/embedding_id_map.h"
 #include "utils/convert_utils_base.h"
 
 namespace mindspore {
 namespace ps {
 static const size_t INVALID_STEP_VALUE = 0;
-static const int INVALID_INDEX_VALUE = -1;
 
 struct HashMapElement {
   int id_{INVALID_INDEX_VALUE};
-  size_t step_{INVALID_STEP_VALUE};
-  bool IsEmpty() const { return step_ == INVALID_STEP_VALUE; }
-  bool IsExpired(size_t graph_running_step) const { return graph_running_step > step_; }
-  bool IsStep(size_t step) const { return step_ == step; }
+  // step_ and referenced_ are also written by the threads checking cache hits
+  std::atomic<size_t> step_{INVALID_STEP_VALUE};
+  // CLOCK reference bit, set by a hit and cleared when the clock hand passes the element
+  std::atomic_bool referenced_{false};
+  size_t step() const { return step_.load(std::memory_order_relaxed); }
+  bool IsEmpty() const { return step() == INVALID_STEP_VALUE; }
+  bool IsExpired(size_t graph_running_step) const { return graph_running_step > step(); }
+  bool IsStep(size_t step) const { return this->step() == step; }
   void set_id(int id) { id_ = id; }
-  void set_step(size_t step) { step_ = step; }
+  void set_step(size_t step) { step_.store(step, std::memory_order_relaxed); }
 };
 
 // Hash table is held in device, HashMap is used to manage hash table in host.
+// Lookups through hash_id_to_index and Touch may run on several threads, ParseData allocates the indices and must be
+// called from one thread at a time.
 class EmbeddingHashMap {
  public:
   EmbeddingHashMap(size_t hash_count, size_t hash_capacity)
       : hash_count_(hash_count),
         hash_capacity_(hash_capacity),
+        hash_map_elements_(std::make_unique<HashMapElement[]>(hash_capacity)),
+        hash_id_to_index_(hash_capacity),
         current_pos_(0),
-        current_batch_start_pos_(0),
+        swept_num_(0),
         graph_running_index_num_(0),
         graph_running_index_pos_(0),
         expired_element_full_(false) {
-    hash_map_elements_.resize(hash_capacity);
     // In multi-device mode, embedding table are distributed on different devices by ID interval,
     // and IDs outside the range of local device will use the front and back positions of the table,
     // the positions are reserved for this.
-    hash_map_elements_.front().set_step(SIZE_MAX);
-    hash_map_elements_.back().set_step(SIZE_MAX);
+    hash_map_elements_[0].set_step(SIZE_MAX);
+    hash_map_elements_[hash_capacity - 1].set_step(SIZE_MAX);
     graph_running_index_ = std::make_unique<int[]>(hash_capacity);
   }
   virtual ~EmbeddingHashMap() = default;
   int ParseData(const int id, int *const swap_out_index, int *const swap_out_ids, const size_t data_step,
                 const size_t graph_running_step, size_t *const swap_out_size, bool *const need_wait_graph);
-  size_t hash_step(const int hash_index) const { return hash_map_elements_[hash_index].step_; }
+  size_t hash_step(const int hash_index) const { return hash_map_elements_[hash_index].step(); }
   void set_hash_step(const int hash_index, const size_t step) { hash_map_elements_[hash_index].set_step(step); }
-  const std::unordered_map<int, int> &hash_id_to_index() const { return hash_id_to_index_; }
+  // Marks the element as used by step and referenced, returns whether it was not used by step yet.
+  bool Touch(const int hash_index, const size_t step) {
+    auto &element = hash_map_elements_[hash_index];
+    element.referenced_.store(true, std::memory_order_relaxed);
+    return element.step_.exchange(step, std::memory_order_relaxed) != step;
+  }
+  const EmbeddingIdMap &hash_id_to_index() const { return hash_id_to_index_; }
   size_t hash_capacity() const { return hash_capacity_; }
   void DumpHashMap();
+  // Starts the search of the next batch, no lookup may be running.
   void Reset();
 
  private:
@@ -73,10 +87,11 @@ class EmbeddingHashMap {
                        bool *const need_wait_graph);
   size_t hash_count_;
   size_t hash_capacity_;
-  std::vector<HashMapElement> hash_map_elements_;
-  std::unordered_map<int, int> hash_id_to_index_;
+  std::unique_ptr<HashMapElement[]> hash_map_elements_;
+  EmbeddingIdMap hash_id_to_index_;
   size_t current_pos_;
-  size_t current_batch_start_pos_;
+  // elements passed by the clock hand since Reset
+  size_t swept_num_;
   size_t graph_running_index_num_;
   size_t graph_running_index_pos_;
   std::unique_ptr<int[]> graph_running_index_;
@@ -0,0 +1,211 @@
+/**
+ * Copyright 2021 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ps/ps_cache/embedding_id_map.h"
+#include <algorithm>
+
+namespace mindspore {
+namespace ps {
+namespace {
+constexpr size_t kShardBits = 6;
+constexpr size_t kMinShardSlotNum = 16;
+// ids of a FindBatch block are hashed and their slots prefetched before the first one is probed
+constexpr size_t kFindBatchBlock = 16;
+// An index is never negative, so neither word can be a real id and index.
+constexpr uint64_t kEmptySlot = UINT64_MAX;
+constexpr uint64_t kErasedSlot = UINT64_MAX - 1;
+
+inline uint64_t Pack(int id, int index) {
+  return (static_cast<uint64_t>(static_cast<uint32_t>(id)) << 32) | static_cast<uint32_t>(index);
+}
+inline int UnpackId(uint64_t slot) { return static_cast<int>(static_cast<uint32_t>(slot >> 32)); }
+inline int UnpackIndex(uint64_t slot) { return static_cast<int>(static_cast<uint32_t>(slot)); }
+
+size_t RoundUpPowerOfTwo(size_t num) {
+  size_t power = 1;
+  while (power < num) {
+    power <<= 1;
+  }
+  return power;
+}
+}  // namespace
+
+EmbeddingIdMap::Table::Table(size_t slot_num)
+    : slots(std::make_unique<std::atomic<uint64_t>[]>(slot_num)), mask(slot_num - 1) {
+  for (size_t i = 0; i < slot_num; ++i) {
+    slots[i].store(kEmptySlot, std::memory_order_relaxed);
+  }
+}
+
+EmbeddingIdMap::EmbeddingIdMap(size_t capacity) : shard_num_(1 << kShardBits), shard_shift_(64 - kShardBits) {
+  shards_ = std::make_unique<Shard[]>(shard_num_);
+  // keep every shard at most half full when the ids are spread evenly
+  size_t slot_num = RoundUpPowerOfTwo(std::max(kMinShardSlotNum, 2 * capacity / shard_num_));
+  for (size_t i = 0; i < shard_num_; ++i) {
+    auto &shard = shards_[i];
+    shard.tables.emplace_back(std::make_unique<Table>(slot_num));
+    shard.table.store(shard.tables.back().get(), std::memory_order_release);
+  }
+}
+
+int EmbeddingIdMap::Probe(const Table *table, uint64_t hash, int id) {
+  for (size_t pos = hash & table->mask;; pos = (pos + 1) & table->mask) {
+    uint64_t slot = table->slots[pos].load(std::memory_order_acquire);
+    if (slot == kEmptySlot) {
+      return INVALID_INDEX_VALUE;
+    }
+    if (slot != kErasedSlot && UnpackId(slot) == id) {
+      return UnpackIndex(slot);
+    }
+  }
+}
+
+int EmbeddingIdMap::Find(int id) const {
+  uint64_t hash = Hash(id);
+  const Table *table = shards_[ShardOf(hash)].table.load(std::memory_order_acquire);
+  return Probe(table, hash, id);
+}
+
+void EmbeddingIdMap::FindBatch(const int *ids, size_t ids_size, int *indices) const {
+  uint64_t hashes[kFindBatchBlock];
+  const Table *tables[kFindBatchBlock];
+  for (size_t begin = 0; begin < ids_size; begin += kFindBatchBlock) {
+    size_t block_size = std::min(kFindBatchBlock, ids_size - begin);
+    for (size_t i = 0; i < block_size; ++i) {
+      hashes[i] = Hash(ids[begin + i]);
+      tables[i] = shards_[ShardOf(hashes[i])].table.load(std::memory_order_acquire);
+#if defined(__GNUC__) || defined(__clang__)
+      __builtin_prefetch(&tables[i]->slots[hashes[i] & tables[i]->mask], 0, 1);
+#endif
+    }
+    for (size_t i = 0; i < block_size; ++i) {
+      indices[begin + i] = Probe(tables[i], hashes[i], ids[begin + i]);
+    }
+  }
+}
+
+void EmbeddingIdMap::Insert(int id, int index) {
+  uint64_t hash = Hash(id);
+  auto &shard = shards_[ShardOf(hash)];
+  std::lock_guard<std::mutex> lock(shard.mutex);
+  Table *table = shard.table.load(std::memory_order_relaxed);
+  // an empty slot is never reused, so a probe always ends while a quarter of the slots are left empty
+  if (4 * (shard.size + shard.erased + 1) > 3 * (table->mask + 1)) {
+    Rebuild(&shard);
+    table = shard.table.load(std::memory_order_relaxed);
+  }
+  size_t insert_pos = SIZE_MAX;
+  for (size_t pos = hash & table->mask;; pos = (pos + 1) & table->mask) {
+    uint64_t slot = table->slots[pos].load(std::memory_order_relaxed);
+    if (slot == kEmptySlot) {
+      if (insert_pos == SIZE_MAX) {
+        insert_pos = pos;
+      }
+      break;
+    }
+    if (slot == kErasedSlot) {
+      if (insert_pos == SIZE_MAX) {
+        insert_pos = pos;
+      }
+      continue;
+    }
+    if (UnpackId(slot) == id) {
+      table->slots[pos].store(Pack(id, index), std::memory_order_release);
+      return;
+    }
+  }
+  if (table->slots[insert_pos].load(std::memory_order_relaxed) == kErasedSlot) {
+    shard.erased--;
+  }
+  table->slots[insert_pos].store(Pack(id, index), std::memory_order_release);
+  shard.size.fetch_add(1, std::memory_order_relaxed);
+}
+
+void EmbeddingIdMap::Erase(int id) {
+  uint64_t hash = Hash(id);
+  auto &shard = shards_[ShardOf(hash)];
+  std::lock_guard<std::mutex> lock(shard.mutex);
+  Table *table = shard.table.load(std::memory_order_relaxed);
+  for (size_t pos = hash & table->mask;; pos = (pos + 1) & table->mask) {
+    uint64_t slot = table->slots[pos].load(std::memory_order_relaxed);
+    if (slot == kEmptySlot) {
+      return;
+    }
+    if (slot != kErasedSlot && UnpackId(slot) == id) {
+      table->slots[pos].store(kErasedSlot, std::memory_order_release);
+      shard.size.fetch_sub(1, std::memory_order_relaxed);
+      shard.erased++;
+      return;
+    }
+  }
+}
+
+// Copies the live ids into a new table, twice as large when the shard is more than half full, and publishes it.
+// Readers still probing the old table see a consistent snapshot of it, so it is only freed by ReclaimRetired.
+void EmbeddingIdMap::Rebuild(Shard *shard) {
+  const Table *old_table = shard->table.load(std::memory_order_relaxed);
+  size_t slot_num = old_table->mask + 1;
+  if (2 * (shard->size + 1) > slot_num) {
+    slot_num *= 2;
+  }
+  auto table = std::make_unique<Table>(slot_num);
+  for (size_t i = 0; i <= old_table->mask; ++i) {
+    uint64_t slot = old_table->slots[i].load(std::memory_order_relaxed);
+    if (slot == kEmptySlot || slot == kErasedSlot) {
+      continue;
+    }
+    size_t pos = Hash(UnpackId(slot)) & table->mask;
+    while (table->slots[pos].load(std::memory_order_relaxed) != kEmptySlot) {
+      pos = (pos + 1) & table->mask;
+    }
+    table->slots[pos].store(slot, std::memory_order_relaxed);
+  }
+  shard->erased = 0;
+  shard->table.store(table.get(), std::memory_order_release);
+  shard->tables.emplace_back(std::move(table));
+}
+
+size_t EmbeddingIdMap::size() const {
+  size_t size = 0;
+  for (size_t i = 0; i < shard_num_; ++i) {
+    size += shards_[i].size.load(std::memory_order_relaxed);
+  }
+  return size;
+}
+
+void EmbeddingIdMap::ForEach(const std::function<void(int id, int index)> &visitor) const {
+  for (size_t i = 0; i < shard_num_; ++i) {
+    const Table *table = shards_[i].table.load(std::memory_order_acquire);
+    for (size_t pos = 0; pos <= table->mask; ++pos) {
+      uint64_t slot = table->slots[pos].load(std::memory_order_relaxed);
+      if (slot != kEmptySlot && slot != kErasedSlot) {
+        visitor(UnpackId(slot), UnpackIndex(slot));
+      }
+    }
+  }
+}
+
+void EmbeddingIdMap::ReclaimRetired() {
+  for (size_t i = 0; i < shard_num_; ++i) {
+    auto &shard = shards_[i];
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    if (shard.tables.size() > 1) {
+      (void)shard.tables.erase(shard.tables.begin(), shard.tables.end() - 1);
+    }
+  }
+}
+}  // namespace ps
+}  // namespace mindspore
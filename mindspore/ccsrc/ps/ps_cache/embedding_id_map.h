@@ -0,0 +1,85 @@
+/**
+ * Copyright 2021 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MINDSPORE_CCSRC_PS_PS_CACHE_EMBEDDING_ID_MAP_H_
+#define MINDSPORE_CCSRC_PS_PS_CACHE_EMBEDDING_ID_MAP_H_
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace mindspore {
+namespace ps {
+static const int INVALID_INDEX_VALUE = -1;
+
+// Map from embedding id to cache index, both non-negative. The ids are spread over shards, each an open addressing
+// table with linear probing whose slot packs id and index in one atomic word:
+//  - Find and FindBatch never lock and may run on any number of threads, also while ids are inserted or erased.
+//  - Insert and Erase lock the shard of the id only.
+//  - A shard full of erased slots is rebuilt into a new table, the old one is kept until ReclaimRetired, which
+//    must not run concurrently with Find.
+class EmbeddingIdMap {
+ public:
+  explicit EmbeddingIdMap(size_t capacity);
+  ~EmbeddingIdMap() = default;
+  EmbeddingIdMap(const EmbeddingIdMap &) = delete;
+  EmbeddingIdMap &operator=(const EmbeddingIdMap &) = delete;
+
+  // the index of id, INVALID_INDEX_VALUE if it is absent
+  int Find(int id) const;
+  // indices[i] = Find(ids[i]), hashes a block of ids at a time and prefetches their slots before probing
+  void FindBatch(const int *ids, size_t ids_size, int *indices) const;
+  // id must be absent
+  void Insert(int id, int index);
+  void Erase(int id);
+  size_t size() const;
+  // not safe against concurrent Insert and Erase
+  void ForEach(const std::function<void(int id, int index)> &visitor) const;
+  void ReclaimRetired();
+
+ private:
+  struct Table {
+    explicit Table(size_t slot_num);
+    std::unique_ptr<std::atomic<uint64_t>[]> slots;
+    size_t mask;
+  };
+  struct Shard {
+    std::atomic<Table *> table{nullptr};
+    std::mutex mutex;
+    std::atomic<size_t> size{0};
+    size_t erased{0};
+    std::vector<std::unique_ptr<Table>> tables;
+  };
+
+  // fibonacci hashing, the high half is folded into the low one which picks the slot
+  static uint64_t Hash(int id) {
+    uint64_t hash = static_cast<uint64_t>(static_cast<uint32_t>(id)) * 0x9E3779B97F4A7C15ULL;
+    return hash ^ (hash >> 32);
+  }
+  size_t ShardOf(uint64_t hash) const { return static_cast<size_t>(hash >> shard_shift_); }
+  static int Probe(const Table *table, uint64_t hash, int id);
+  void Rebuild(Shard *shard);
+
+  std::unique_ptr<Shard[]> shards_;
+  size_t shard_num_;
+  // shards take the top bits of the hash
+  size_t shard_shift_;
+};
+}  // namespace ps
+}  // namespace mindspore
+#endif  // MINDSPORE_CCSRC_PS_PS_CACHE_EMBEDDING_ID_MAP_H_
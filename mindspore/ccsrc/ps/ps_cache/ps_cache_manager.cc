@@ -414,7 +414,8 @@ bool PsCacheManager::CheckCacheHitOrOutRangeTask(const int *batch_ids, const siz
   MS_ERROR_IF_NULL(embedding_device_cache_);
   auto &device_hash_map = embedding_device_cache_->device_hash_map_;
   MS_ERROR_IF_NULL(device_hash_map);
-  const auto &hash_id_to_index = device_hash_map->hash_id_to_index();
+  // hash_index holds the cache index of every id until it is replaced below
+  device_hash_map->hash_id_to_index().FindBatch(batch_ids, batch_ids_len, hash_index);
 
   for (size_t i = 0; i < batch_ids_len; ++i) {
     if (batch_ids[i] < emb_table_slice_bounds_.first) {
@@ -427,12 +428,11 @@ bool PsCacheManager::CheckCacheHitOrOutRangeTask(const int *batch_ids, const siz
       out_range[i] = true;
       continue;
     }
-    auto iter = hash_id_to_index.find(batch_ids[i]);
-    if (iter != hash_id_to_index.end()) {
-      hash_index[i] = iter->second + cache_indices_bounds_.first;
-      if (device_hash_map->hash_step(iter->second) != data_step_) {
+    auto index = hash_index[i];
+    if (index != INVALID_INDEX_VALUE) {
+      hash_index[i] = index + cache_indices_bounds_.first;
+      if (device_hash_map->Touch(index, data_step_)) {
         ++(*hash_hit_count);
-        device_hash_map->set_hash_step(iter->second, data_step_);
       }
       in_device[i] = true;
     }
@@ -545,16 +545,12 @@ bool PsCacheManager::ParseDeviceData(size_t id, bool *need_swap_device_to_host,
   auto &device_hash_map = embedding_device_cache_->device_hash_map_;
   MS_ERROR_IF_NULL(device_hash_map);
 
-  int index = INVALID_INDEX_VALUE;
-  const auto &hash_id_to_index = device_hash_map->hash_id_to_index();
-  const auto &iter = hash_id_to_index.find(id);
-  if (iter != hash_id_to_index.end()) {
+  int index = device_hash_map->hash_id_to_index().Find(SizeToInt(id));
+  if (index != INVALID_INDEX_VALUE) {
     *need_swap_device_to_host = false;
     *need_swap_host_to_device = false;
-    index = iter->second;
-    if (device_hash_map->hash_step(index) != data_step_) {
+    if (device_hash_map->Touch(index, data_step_)) {
       statistics_info_.hash_hit_count_++;
-      device_hash_map->set_hash_step(index, data_step_);
     }
   } else {
     int *device_to_host_index = embedding_device_cache_->device_to_host_index.get();
@@ -591,13 +587,9 @@ bool PsCacheManager::ParseHostDataHostToDevice(size_t id) {
   auto &host_hash_map = embedding_host_cache_->host_hash_map_;
   MS_ERROR_IF_NULL(host_hash_map);
 
-  const auto &hash_id_to_index = host_hash_map->hash_id_to_index();
-  const auto &iter = hash_id_to_index.find(id);
-  if (iter != hash_id_to_index.end()) {
-    auto index = iter->second;
-    if (host_hash_map->hash_step(index) != data_step_) {
-      host_hash_map->set_hash_step(index, data_step_);
-    }
+  auto index = host_hash_map->hash_id_to_index().Find(SizeToInt(id));
+  if (index != INVALID_INDEX_VALUE) {
+    (void)host_hash_map->Touch(index, data_step_);
     host_to_device_index[statistics_info_.host_to_device_size_ - 1] = index;
   } else {
     int *host_to_server_index = embedding_host_cache_->host_to_server_index.get();
@@ -607,9 +599,8 @@ bool PsCacheManager::ParseHostDataHostToDevice(size_t id) {
     MS_ERROR_IF_NULL(server_to_host_index);
     MS_ERROR_IF_NULL(server_to_host_ids);
     while (true) {
-      auto index =
-        host_hash_map->ParseData(id, host_to_server_index, host_to_server_ids, data_step_, graph_running_step_,
-                                 &statistics_info_.host_to_server_size_, &host_need_wait_graph_);
+      index = host_hash_map->ParseData(id, host_to_server_index, host_to_server_ids, data_step_, graph_running_step_,
+                                       &statistics_info_.host_to_server_size_, &host_need_wait_graph_);
       if (index == INVALID_INDEX_VALUE) {
         RETURN_IF_FALSE(WaitGraphRun());
         continue;
@@ -633,19 +624,15 @@ bool PsCacheManager::ParseHostDataDeviceToHost() {
   auto &host_hash_map = embedding_host_cache_->host_hash_map_;
   MS_ERROR_IF_NULL(host_hash_map);
   int swap_device_to_host_id = device_to_host_ids[statistics_info_.device_to_host_size_ - 1];
-  const auto &hash_id_to_index = host_hash_map->hash_id_to_index();
-  const auto &iter = hash_id_to_index.find(swap_device_to_host_id);
-  if (iter != hash_id_to_index.end()) {
-    auto index = iter->second;
-    if (host_hash_map->hash_step(index) != data_step_) {
-      host_hash_map->set_hash_step(index, data_step_);
-    }
+  auto index = host_hash_map->hash_id_to_index().Find(swap_device_to_host_id);
+  if (index != INVALID_INDEX_VALUE) {
+    (void)host_hash_map->Touch(index, data_step_);
     device_to_host_index[statistics_info_.device_to_host_size_ - 1] = index;
   } else {
     int *host_to_server_index = embedding_host_cache_->host_to_server_index.get();
     int *host_to_server_ids = embedding_host_cache_->host_to_server_ids.get();
     while (true) {
-      auto index =
+      index =
         host_hash_map->ParseData(swap_device_to_host_id, host_to_server_index, host_to_server_ids, data_step_,
                                  graph_running_step_, &statistics_info_.host_to_server_size_, &host_need_wait_graph_);
       if (index == INVALID_INDEX_VALUE) {
@@ -973,6 +960,7 @@ void PsCacheManager::SyncEmbeddingTable() {
   if (!SyncDeviceEmbeddingTable()) {
     MS_LOG(ERROR) << "SyncDeviceEmbeddingTable failed.";
   }
+  Worker::GetInstance().FlushEmbeddingTableUpdates();
   finish_embedding_table_sync_ = true;
 }
 
@@ -989,10 +977,10 @@ bool PsCacheManager::SyncHostEmbeddingTable() {
   std::unique_ptr<int[]> host_to_server_indices_ptr = std::make_unique<int[]>(swap_indices_lens);
   MS_ERROR_IF_NULL(host_to_server_indices_ptr);
   size_t idx = 0;
-  for (const auto &item : hash_id_to_index) {
-    host_to_server_ids_ptr[idx] = item.first;
-    host_to_server_indices_ptr[idx++] = item.second;
-  }
+  hash_id_to_index.ForEach([&](int id, int index) {
+    host_to_server_ids_ptr[idx] = id;
+    host_to_server_indices_ptr[idx++] = index;
+  });
   for (const auto &item : hash_tables_) {
     const auto &hash_info = item.second;
     if (hash_info.param_init_info_.param_type_ != kWeight) {
@@ -1034,10 +1022,10 @@ bool PsCacheManager::SyncDeviceEmbeddingTable() {
   std::unique_ptr<int[]> device_to_server_indices_ptr = std::make_unique<int[]>(swap_indices_lens);
   MS_ERROR_IF_NULL(device_to_server_indices_ptr);
   size_t idx = 0;
-  for (const auto &item : hash_id_to_index) {
-    device_to_server_ids_ptr[idx] = item.first;
-    device_to_server_indices_ptr[idx++] = item.second;
-  }
+  hash_id_to_index.ForEach([&](int id, int index) {
+    device_to_server_ids_ptr[idx] = id;
+    device_to_server_indices_ptr[idx++] = index;
+  });
   for (const auto &item : hash_tables_) {
     const auto &hash_info = item.second;
     if (hash_info.param_init_info_.param_type_ != kWeight) {
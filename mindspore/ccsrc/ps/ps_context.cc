@@ -53,6 +53,10 @@ void PSContext::SetPSEnable(bool enabled) {
     scheduler_host_ = common::GetEnv(kEnvSchedulerHost);
     scheduler_port_ = std::strtol(common::GetEnv(kEnvSchedulerPort).c_str(), nullptr, 10);
     core::ClusterMetadata::instance()->Init(worker_num_, server_num_, scheduler_host_, scheduler_port_);
+    std::string shm_threshold = common::GetEnv(kEnvShmThreshold);
+    if (!shm_threshold.empty()) {
+      core::ClusterMetadata::instance()->set_shm_threshold(std::strtoull(shm_threshold.c_str(), nullptr, 10));
+    }
   } else {
     MS_LOG(INFO) << "PS mode is disabled.";
     is_worker_ = false;
@@ -22,6 +22,10 @@
 
 namespace mindspore {
 namespace ps {
+namespace {
+constexpr uint32_t kInitThreadNum = 16;
+}  // namespace
+
 bool InitRandomNormal(float mean, float stddev, std::vector<size_t> out_shape, size_t global_seed, size_t op_seed,
                       float *output_data) {
   if (out_shape.size() == 0) {
@@ -31,7 +35,7 @@ bool InitRandomNormal(float mean, float stddev, std::vector<size_t> out_shape, s
   for (uint32_t i = 0; i < out_shape.size(); i++) {
     total_count *= SizeToLong(out_shape[i]);
   }
-  uint32_t thread_num = 16;
+  uint32_t thread_num = kInitThreadNum;
   if (total_count <= thread_num) {
     thread_num = 1;
   }
@@ -67,5 +71,45 @@ bool InitRandomNormal(float mean, float stddev, std::vector<size_t> out_shape, s
   }
   return true;
 }
+
+bool InitRandomNormal(float stddev, const std::vector<size_t> &out_shape, size_t global_seed, size_t op_seed,
+                      size_t chunk_size, const std::function<bool(const float *data, size_t size)> &consumer) {
+  if (out_shape.size() == 0 || chunk_size == 0) {
+    MS_LOG(ERROR) << "Output data shape or chunk size is error.";
+    return false;
+  }
+  int64_t total_count = 1;
+  for (uint32_t i = 0; i < out_shape.size(); i++) {
+    total_count *= SizeToLong(out_shape[i]);
+  }
+  uint32_t thread_num = total_count <= kInitThreadNum ? 1 : kInitThreadNum;
+  int64_t batchSize = total_count / thread_num;
+  int64_t seed = SizeToLong(global_seed);
+  int64_t seed2 = SizeToLong(op_seed);
+  seed = (seed == 0 && seed2 == 0) ? clock() : seed;
+  PhiloxGenerator generator = PhiloxGenerator(seed, seed2);
+  NormalDistribution<PhiloxGenerator, float> distribution;
+  std::vector<float> chunk;
+  chunk.reserve(chunk_size);
+  // the batches of the threads above one after the other, each from the generator state FillRandoms starts it at
+  for (uint32_t i = 0; i < thread_num; i++) {
+    int64_t vet_size = (i == thread_num - 1) ? total_count - (thread_num - 1) * batchSize : batchSize;
+    PhiloxGenerator thread_generator = generator;
+    thread_generator.JumpStep((vet_size * i + gResultNum - 1) / gResultNum);
+    for (int64_t j = 0; j < vet_size; j += gResultNum) {
+      auto result = distribution(&thread_generator);
+      for (int64_t k = 0; k < gResultNum && j + k < vet_size; k++) {
+        chunk.push_back(result[k] * stddev);
+        if (chunk.size() == chunk_size) {
+          if (!consumer(chunk.data(), chunk.size())) {
+            return false;
+          }
+          chunk.clear();
+        }
+      }
+    }
+  }
+  return chunk.empty() || consumer(chunk.data(), chunk.size());
+}
 }  // namespace ps
 }  // namespace mindspore
@@ -15,12 +15,17 @@
  */
 #ifndef MINDSPORE_CCSRC_PS_RANDOM_NORMAL_RANDOM_NORMAL_H_
 #define MINDSPORE_CCSRC_PS_RANDOM_NORMAL_RANDOM_NORMAL_H_
+#include <functional>
 #include <vector>
 
 namespace mindspore {
 namespace ps {
 bool InitRandomNormal(float mean, float stddev, std::vector<size_t> out_shape, size_t global_seed, size_t op_seed,
                       float *output_data);
+// the same values as above, produced in order chunk_size at a time and passed to consumer, so the table never has to
+// be in memory as a whole. A consumer returning false stops it.
+bool InitRandomNormal(float stddev, const std::vector<size_t> &out_shape, size_t global_seed, size_t op_seed,
+                      size_t chunk_size, const std::function<bool(const float *data, size_t size)> &consumer);
 }  // namespace ps
 }  // namespace mindspore
 
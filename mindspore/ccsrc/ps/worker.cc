@@ -16,6 +16,7 @@
 
 #include "ps/worker.h"
 #include "pipeline/jit/pipeline.h"
+#include "utils/ms_utils.h"
 
 namespace mindspore {
 namespace ps {
@@ -95,41 +96,53 @@ void Worker::Push(const std::vector<size_t> &keys, std::vector<uintptr_t> addrs,
   }
   MS_LOG(INFO) << "The total size is:" << total_size;
 
-  while (running_ && (!IsReadyForPush(keys[0]))) {
-    continue;
-  }
   std::vector<int> sizes_int;
   (void)std::transform(sizes.begin(), sizes.end(), std::back_inserter(sizes_int),
                        [](const int64_t &value) { return static_cast<int>(value); });
-  if (!is_sparse) {
-    PushData(std::vector<Key>(keys), total_buffer, std::vector<int>(sizes_int), kPushCmd);
+  // the gradients are copied out of the device memory above, the rest runs on the push thread when it is enabled
+  auto send = [this, keys, key, optim_id, is_sparse, grad_index, indice_index, total_buffer = std::move(total_buffer),
+               sizes_int = std::move(sizes_int)]() {
+    while (running_ && (!IsReadyForPush(keys[0]))) {
+      continue;
+    }
+    if (!is_sparse && grad_compressor_ != nullptr && embedding_table_ranges_.count(key) == 0) {
+      PushCompressedData(std::vector<Key>(keys), total_buffer, sizes_int, optim_id);
+    } else if (!is_sparse) {
+      PushData(std::vector<Key>(keys), total_buffer, std::vector<int>(sizes_int), kPushCmd);
+    } else {
+      std::vector<int64_t> &var_shape = key_to_optim_shapes_[key][0];
+      int64_t first_dim_size = var_shape[0];
+      int64_t outer_dim_size =
+        std::accumulate(var_shape.begin() + 1, var_shape.end(), 1, std::multiplies<int64_t>());
+      MS_LOG(DEBUG) << "The keys:" << keys << " the total_buffer:" << total_buffer << " the sizes_int:" << sizes_int
+                    << " the grad_index:" << grad_index << " the indice_index:" << indice_index
+                    << " the first_dim_size:" << first_dim_size << " the outer_dim_size" << outer_dim_size;
+      PushSparseData(std::vector<Key>(keys), total_buffer, std::vector<int>(sizes_int), grad_index, indice_index,
+                     first_dim_size, outer_dim_size);
+    }
+  };
+  if (grad_push_pipeline_ != nullptr) {
+    grad_push_pipeline_->Push(key, send);
   } else {
-    std::vector<int64_t> &var_shape = key_to_optim_shapes_[key][0];
-    int64_t first_dim_size = var_shape[0];
-    int64_t outer_dim_size = std::accumulate(var_shape.begin() + 1, var_shape.end(), 1, std::multiplies<int64_t>());
-    MS_LOG(DEBUG) << "The keys:" << keys << " the total_buffer:" << total_buffer << " the sizes_int:" << sizes_int
-                  << " the grad_index:" << grad_index << " the indice_index:" << indice_index
-                  << " the first_dim_size:" << first_dim_size << " the outer_dim_size" << outer_dim_size;
-    PushSparseData(std::vector<Key>(keys), total_buffer, std::vector<int>(sizes_int), grad_index, indice_index,
-                   first_dim_size, outer_dim_size);
+    send();
   }
 }
 
 void Worker::Pull(const size_t key, void *dev_addr, const size_t size) {
   MS_EXCEPTION_IF_NULL(dev_addr);
-  std::vector<float> variables(size / sizeof(float), 0);
+  if (grad_push_pipeline_ != nullptr) {
+    grad_push_pipeline_->Wait(key);
+  }
   while (running_ && (!IsReadyForPull(key))) {
     continue;
   }
-  PullData({key}, &variables, nullptr, kPullCmd);
-  MS_LOG(DEBUG) << "The variables:" << variables << " the size is:" << size;
-  size_t dst_size = size;
-  size_t src_size = size;
-  auto ret = memcpy_s(dev_addr, dst_size, variables.data(), src_size);
-  if (ret != 0) {
-    MS_LOG(EXCEPTION) << "memcpy_s error, errorno(" << ret << ")";
-    return;
-  }
+  KVMessage kvs;
+  kvs.add_keys(key);
+  // the weight is copied from the responses straight into the parameter
+  const KVPartitioner &partitioner =
+    embedding_table_ranges_.count(key) > 0 ? broadcast_partitioner_ : round_robin_partitioner_;
+  SendForPull(kPullCmd, kvs, partitioner, reinterpret_cast<float *>(dev_addr), size / sizeof(float));
+  MS_LOG(DEBUG) << "The key:" << key << " is pulled, the size is:" << size;
 }
 
 size_t Worker::SetParamKey(const std::string &param_name) {
@@ -276,6 +289,48 @@ void Worker::InitPSParamAndOptim(const AnfNodePtr &input_node, const tensor::Ten
 void Worker::DoPSEmbeddingLookup(const Key &key, const std::vector<int> &lookup_ids, std::vector<float> *lookup_result,
                                  int64_t cmd) {
   MS_EXCEPTION_IF_NULL(lookup_result);
+  if (lookup_ids.empty()) {
+    PullEmbeddings(key, lookup_ids, lookup_result, cmd);
+    return;
+  }
+  // Rows pushed by this worker and not acknowledged yet are read from the push window, only the others are pulled.
+  size_t row_size = lookup_result->size() / lookup_ids.size();
+  std::vector<size_t> missing;
+  if (embedding_push_pipeline_ != nullptr) {
+    embedding_push_pipeline_->Lookup(key, lookup_ids, row_size, lookup_result->data(), &missing);
+  } else {
+    missing.resize(lookup_ids.size());
+    std::iota(missing.begin(), missing.end(), 0);
+  }
+  if (missing.empty()) {
+    return;
+  }
+  // every id is pulled once, however many positions of the lookup hold it
+  std::vector<int> pull_ids;
+  std::vector<size_t> pull_rows(missing.size());
+  std::unordered_map<int, size_t> id_to_pull_row;
+  for (size_t i = 0; i < missing.size(); ++i) {
+    auto iter = id_to_pull_row.emplace(lookup_ids[missing[i]], pull_ids.size());
+    if (iter.second) {
+      pull_ids.push_back(lookup_ids[missing[i]]);
+    }
+    pull_rows[i] = iter.first->second;
+  }
+  if (pull_ids.size() == lookup_ids.size()) {
+    PullEmbeddings(key, lookup_ids, lookup_result, cmd);
+    return;
+  }
+  std::vector<float> pull_result(pull_ids.size() * row_size, 0);
+  PullEmbeddings(key, pull_ids, &pull_result, cmd);
+  for (size_t i = 0; i < missing.size(); ++i) {
+    std::copy(pull_result.begin() + pull_rows[i] * row_size, pull_result.begin() + (pull_rows[i] + 1) * row_size,
+              lookup_result->begin() + missing[i] * row_size);
+  }
+}
+
+void Worker::PullEmbeddings(const Key &key, const std::vector<int> &lookup_ids, std::vector<float> *lookup_result,
+                            int64_t cmd) {
+  MS_EXCEPTION_IF_NULL(lookup_result);
   EmbeddingTableLookup embedding_table_lookup;
   embedding_table_lookup.set_key(key);
   *embedding_table_lookup.mutable_keys() = {lookup_ids.begin(), lookup_ids.end()};
@@ -288,53 +343,42 @@ void Worker::DoPSEmbeddingLookup(const Key &key, const std::vector<int> &lookup_
   for (size_t i = 0; i < messages.size(); i++) {
     if (messages.at(i).first) {
       rank_ids.push_back(i);
-      std::string kv_data = messages.at(i).second.SerializeAsString();
-
-      std::shared_ptr<unsigned char[]> res(new unsigned char[kv_data.length()]);
-      size_t dest_size = kv_data.length();
-      int ret = memcpy_s(res.get(), dest_size, kv_data.data(), kv_data.length());
-      if (ret != 0) {
-        MS_LOG(ERROR) << "memcpy_s error, errorno(" << ret << ")";
-        return;
+      size_t size = messages.at(i).second.ByteSizeLong();
+      DataPtr res(new unsigned char[size]);
+      if (!messages.at(i).second.SerializeToArray(res.get(), SizeToInt(size))) {
+        MS_LOG(EXCEPTION) << "Serialize the lookup of " << lookup_ids.size() << " ids failed.";
       }
       data.push_back(res);
-      sizes.push_back(kv_data.length());
+      sizes.push_back(size);
     }
   }
 
   std::vector<VectorPtr> resp;
   worker_node_.Send(core::NodeRole::SERVER, rank_ids, data, sizes, cmd, &resp);
   int64_t single_id_len = SizeToLong(lookup_result->size() / lookup_ids.size());
-  std::unordered_map<Key, std::shared_ptr<std::pair<float *, int64_t>>> id_addr_map;
-  std::shared_ptr<std::vector<float>> values = std::make_shared<std::vector<float>>();
-  std::shared_ptr<std::vector<Key>> keys = std::make_shared<std::vector<Key>>();
-  int64_t value_offset = 0;
+  // the rows are copied from the responses, which hold them until the end of the function, into the result
+  std::unordered_map<Key, std::shared_ptr<std::pair<const float *, int64_t>>> id_addr_map;
   for (size_t i = 0; i < resp.size(); ++i) {
     KVMessage message;
-    message.ParseFromArray(resp.at(i)->data(), resp.at(i)->size());
-    for (auto j = 0; j < message.values_size(); j++) {
-      values->push_back(message.values(j));
+    size_t value_num = 0;
+    const float *values = KVMessageFrame::Decode(resp.at(i)->data(), resp.at(i)->size(), &message, &value_num);
+    if (value_num != IntToSize(message.keys_size()) * LongToSize(single_id_len)) {
+      MS_LOG(EXCEPTION) << "The lookup response of " << message.keys_size() << " ids has " << value_num << " values.";
     }
     for (auto k = 0; k < message.keys_size(); k++) {
       const Key &key = message.keys(k);
-      keys->push_back(key);
+      const float *addr = values + k * single_id_len;
+      id_addr_map[key] = std::make_shared<std::pair<const float *, int64_t>>(std::make_pair(addr, single_id_len));
     }
   }
 
-  for (size_t i = 0; i < keys->size(); i++) {
-    const Key &key = keys->at(i);
-    float *addr = values->data() + value_offset;
-    value_offset += single_id_len;
-    id_addr_map[key] = std::make_shared<std::pair<float *, int64_t>>(std::make_pair(addr, single_id_len));
-  }
-
   float *result_addr = lookup_result->data();
   MS_EXCEPTION_IF_NULL(result_addr);
   int64_t offset = 0;
   size_t dst_size = 0;
   size_t src_size = 0;
   void *dst_data = nullptr;
-  void *src_data = nullptr;
+  const void *src_data = nullptr;
   for (size_t i = 0; i < lookup_ids.size(); i++) {
     if (id_addr_map.count(lookup_ids[i]) == 0) {
       offset += single_id_len;
@@ -360,8 +404,25 @@ void Worker::DoPSEmbeddingLookup(const Key &key, const std::vector<int> &lookup_
 
 void Worker::UpdateEmbeddingTable(const std::vector<Key> &keys, const std::vector<int> &lookup_ids,
                                   const std::vector<float> &vals) {
+  if (keys.size() != 1) {
+    MS_LOG(EXCEPTION) << "UpdateEmbeddingTable updates one table, but got " << keys.size() << " keys.";
+  }
+  if (embedding_push_pipeline_ != nullptr) {
+    embedding_push_pipeline_->Push(keys[0], lookup_ids, vals);
+  } else {
+    SendEmbeddingUpdates(keys[0], lookup_ids, vals);
+  }
+}
+
+void Worker::FlushEmbeddingTableUpdates() {
+  if (embedding_push_pipeline_ != nullptr) {
+    embedding_push_pipeline_->Flush();
+  }
+}
+
+void Worker::SendEmbeddingUpdates(const Key &key, const std::vector<int> &lookup_ids, const std::vector<float> &vals) {
   KVMessage kvs;
-  *kvs.mutable_keys() = {keys.begin(), keys.end()};
+  kvs.add_keys(key);
   *kvs.mutable_len() = {lookup_ids.begin(), lookup_ids.end()};
   *kvs.mutable_values() = {vals.begin(), vals.end()};
   PartitionKVMessages messages;
@@ -372,17 +433,9 @@ void Worker::UpdateEmbeddingTable(const std::vector<Key> &keys, const std::vecto
   for (size_t i = 0; i < messages.size(); i++) {
     if (messages.at(i).first) {
       rank_ids.push_back(i);
-      std::string kv_data = messages.at(i).second.SerializeAsString();
-
-      std::shared_ptr<unsigned char[]> res(new unsigned char[kv_data.length()]);
-      size_t dest_size = kv_data.length();
-      int ret = memcpy_s(res.get(), dest_size, kv_data.data(), kv_data.length());
-      if (ret != 0) {
-        MS_LOG(ERROR) << "memcpy_s error, errorno(" << ret << ")";
-        return;
-      }
-      data.push_back(res);
-      sizes.push_back(kv_data.length());
+      size_t size = 0;
+      data.push_back(KVMessageFrame::Encode(&messages.at(i).second, &size));
+      sizes.push_back(size);
     }
   }
   worker_node_.Send(core::NodeRole::SERVER, rank_ids, data, sizes, kUpdateEmbeddingsCmd);
@@ -391,18 +444,25 @@ void Worker::UpdateEmbeddingTable(const std::vector<Key> &keys, const std::vecto
 void Worker::Finalize() {
   if (running_) {
     MS_LOG(INFO) << "Worker starts finalizing...";
+    // the pushes still in flight must reach the servers before they are finalized
+    FlushEmbeddingTableUpdates();
+    embedding_push_pipeline_ = nullptr;
+    if (grad_push_pipeline_ != nullptr) {
+      grad_push_pipeline_->Flush();
+      grad_push_pipeline_ = nullptr;
+    }
+    if (grad_compressor_ != nullptr) {
+      GradCompressionMetrics metrics = grad_compressor_->metrics();
+      MS_LOG(INFO) << "The worker compressed " << metrics.compress_count << " gradients of " << metrics.raw_bytes
+                   << " bytes into " << metrics.compressed_bytes << " bytes, ratio " << metrics.ratio() << ", in "
+                   << metrics.compress_us << " us.";
+    }
     KVMessage kvs;
     kvs.add_keys(0);
     kvs.add_values(0.0f);
-    std::string kv_data = kvs.SerializeAsString();
-    std::shared_ptr<unsigned char[]> res(new unsigned char[kv_data.length()]);
-    size_t dest_size = kv_data.length();
-    int ret = memcpy_s(res.get(), dest_size, kv_data.data(), kv_data.length());
-    if (ret != 0) {
-      MS_LOG(ERROR) << "memcpy_s error, errorno(" << ret << ")";
-      return;
-    }
-    worker_node_.Broadcast(core::NodeRole::SERVER, res, kv_data.length(), kFinalizeCmd);
+    size_t size = 0;
+    DataPtr res = KVMessageFrame::Encode(&kvs, &size);
+    worker_node_.Broadcast(core::NodeRole::SERVER, res, size, kFinalizeCmd);
     worker_node_.Finish();
     worker_node_.Stop();
     running_ = false;
@@ -429,6 +489,41 @@ void Worker::Initialize() {
   broadcast_partitioner_ = [this](auto &&send, auto &&partition, auto &&attrs) {
     BroadcastPartitioner(send, partition, attrs);
   };
+
+  size_t push_window = kDefaultEmbeddingPushWindow;
+  std::string push_window_env = common::GetEnv(kEnvEmbeddingPushWindow);
+  if (!push_window_env.empty()) {
+    push_window = std::strtoul(push_window_env.c_str(), nullptr, 10);
+  }
+  if (push_window > 0) {
+    embedding_push_pipeline_ = std::make_unique<EmbeddingPushPipeline>(
+      push_window, [this](const Key &key, const std::vector<int> &lookup_ids, const std::vector<float> &vals) {
+        SendEmbeddingUpdates(key, lookup_ids, vals);
+      });
+  }
+  MS_LOG(INFO) << "The embedding push window of the worker is " << push_window;
+
+  size_t grad_push_window = kDefaultGradPushWindow;
+  std::string grad_push_window_env = common::GetEnv(kEnvGradPushWindow);
+  if (!grad_push_window_env.empty()) {
+    grad_push_window = std::strtoul(grad_push_window_env.c_str(), nullptr, 10);
+  }
+  if (grad_push_window > 0) {
+    grad_push_pipeline_ = std::make_unique<GradientPushPipeline>(grad_push_window);
+  }
+  MS_LOG(INFO) << "The gradient push window of the worker is " << grad_push_window;
+
+  GradCompressionType compression = GradientCompressor::TypeFromName(common::GetEnv(kEnvGradCompression));
+  if (compression != GradCompressionType::kNone) {
+    float ratio = kDefaultGradCompressionRatio;
+    std::string ratio_env = common::GetEnv(kEnvGradCompressionRatio);
+    if (!ratio_env.empty()) {
+      ratio = std::strtof(ratio_env.c_str(), nullptr);
+    }
+    grad_compressor_ = std::make_unique<GradientCompressor>(compression, ratio);
+    MS_LOG(INFO) << "The worker compresses dense gradients with " << common::GetEnv(kEnvGradCompression)
+                 << ", ratio " << ratio;
+  }
 }
 
 bool Worker::IsKeyInit(const size_t key) {
@@ -629,28 +724,44 @@ void Worker::PushData(const std::vector<Key> &keys, const std::vector<float> &va
                       int cmd, int64_t priority) {
   KVMessage kvs;
   *kvs.mutable_keys() = {keys.begin(), keys.end()};
-  *kvs.mutable_values() = {vals.begin(), vals.end()};
   *kvs.mutable_len() = {lens.begin(), lens.end()};
   MS_LOG(INFO) << "the result is:" << embedding_table_ranges_.count(keys[0]);
+  if (embedding_table_ranges_.count(keys[0]) && cmd != kInitWeightsCmd) {
+    // every server gets all the values, which are written into the frame without going through the message
+    size_t size = 0;
+    DataPtr res = KVMessageFrame::Encode(kvs, vals.data(), vals.size(), &size);
+    worker_node_.Broadcast(core::NodeRole::SERVER, res, size, cmd);
+    return;
+  }
+  *kvs.mutable_values() = {vals.begin(), vals.end()};
   if (embedding_table_ranges_.count(keys[0])) {
-    if (cmd == kInitWeightsCmd) {
-      SendForPush(cmd, kvs, worker_init_embedding_partitioner_, {});
-    } else {
-      std::string kv_data = kvs.SerializeAsString();
-      std::shared_ptr<unsigned char[]> res(new unsigned char[kv_data.length()]);
-      size_t dest_size = kv_data.length();
-      int ret = memcpy_s(res.get(), dest_size, kv_data.data(), kv_data.length());
-      if (ret != 0) {
-        MS_LOG(ERROR) << "memcpy_s error, errorno(" << ret << ")";
-        return;
-      }
-      worker_node_.Broadcast(core::NodeRole::SERVER, res, kv_data.length(), cmd);
-    }
+    SendForPush(cmd, kvs, worker_init_embedding_partitioner_, {});
   } else {
     SendForPush(cmd, kvs, round_robin_partitioner_, {});
   }
 }
 
+void Worker::PushCompressedData(const std::vector<Key> &keys, const std::vector<float> &vals,
+                                const std::vector<int> &lens, int64_t optim_id) {
+  MS_EXCEPTION_IF_NULL(grad_compressor_);
+  const OptimPSSendIdx &send_index = kOptimToPSSendIdx.at(Util::optimizer_name(optim_id));
+  size_t grad_index = send_index.at("grad");
+  EXC_IF_VEC_IDX_OOB(lens, grad_index);
+  size_t grad_offset = std::accumulate(lens.begin(), lens.begin() + grad_index, IntToSize(0));
+  size_t grad_size = IntToSize(lens[grad_index]);
+
+  std::vector<float> other_vals(vals.begin(), vals.begin() + grad_offset);
+  (void)other_vals.insert(other_vals.end(), vals.begin() + grad_offset + grad_size, vals.end());
+  KVMessage kvs;
+  *kvs.mutable_keys() = {keys.begin(), keys.end()};
+  *kvs.mutable_values() = {other_vals.begin(), other_vals.end()};
+  *kvs.mutable_len() = {lens.begin(), lens.end()};
+  kvs.set_len(grad_index, 0);
+  grad_compressor_->Compress(keys[0], vals.data() + grad_offset, grad_size, kvs.mutable_grad());
+  kvs.mutable_grad()->set_index(SizeToInt(grad_index));
+  SendForPush(kPushCmd, kvs, round_robin_partitioner_, {});
+}
+
 void Worker::PushSparseData(const std::vector<Key> &keys, const std::vector<float> &vals, const std::vector<int> &lens,
                             size_t grad_index, size_t indice_index, size_t first_dim_size, size_t outer_dim_size) {
   KVMessage kvs;
@@ -828,9 +939,9 @@ void Worker::RoundRobinPartitioner(const KVMessage &send, PartitionKVMessages *p
                                    const std::map<int64_t, int64_t> &attrs) {
   MS_EXCEPTION_IF_NULL(partition);
   partition->resize(server_num_);
-  auto keys = send.keys();
-  auto values = send.values();
-  auto lens = send.len();
+  const auto &keys = send.keys();
+  const auto &values = send.values();
+  const auto &lens = send.len();
   MS_LOG(INFO) << "the key size is:" << send.keys_size() << " the values size is:" << send.values_size()
                << " the lens:" << send.len_size();
 
@@ -857,15 +968,18 @@ void Worker::RoundRobinPartitioner(const KVMessage &send, PartitionKVMessages *p
     }
     server_kv_pairs.add_len(len);
   }
+  if (send.has_grad() && send.keys_size() > 0) {
+    *partition->at(key_to_server_id_[keys[0]]).second.mutable_grad() = send.grad();
+  }
 }
 
 void Worker::WorkerInitEmbeddingPartitioner(const KVMessage &send, std::vector<std::pair<bool, KVMessage>> *partition,
                                             const std::map<int64_t, int64_t> &attrs) {
   MS_EXCEPTION_IF_NULL(partition);
   partition->resize(server_num_);
-  auto keys = send.keys();
-  auto values = send.values();
-  auto lens = send.len();
+  const auto &keys = send.keys();
+  const auto &values = send.values();
+  const auto &lens = send.len();
 
   size_t col_cnt = lens[0] / embedding_row_cnt_[keys[0]];
   const std::vector<EmbeddingTableShardMetadata> &ranges = *(embedding_table_ranges_[keys[0]]);
@@ -937,25 +1051,15 @@ void Worker::SendForPush(int cmd, const KVMessage &send, const KVPartitioner &pa
   for (size_t i = 0; i < messages.size(); i++) {
     if (messages.at(i).first) {
       rank_ids.push_back(i);
-      std::string kv_data = messages.at(i).second.SerializeAsString();
-
-      std::shared_ptr<unsigned char[]> res(new unsigned char[kv_data.length()]);
-      size_t dest_size = kv_data.length();
-      int ret = memcpy_s(res.get(), dest_size, kv_data.data(), kv_data.length());
-      if (ret != 0) {
-        MS_LOG(ERROR) << "memcpy_s error, errorno(" << ret << ")";
-        return;
-      }
-      data.push_back(res);
-      sizes.push_back(kv_data.length());
+      size_t size = 0;
+      data.push_back(KVMessageFrame::Encode(&messages.at(i).second, &size));
+      sizes.push_back(size);
     }
   }
   worker_node_.Send(core::NodeRole::SERVER, rank_ids, data, sizes, cmd);
 }
 
-void Worker::SendForPull(int cmd, const KVMessage &send, const KVPartitioner &partitioner,
-                         const std::map<int64_t, int64_t> &attrs, std::vector<float> *vals, std::vector<int> *lens) {
-  MS_EXCEPTION_IF_NULL(vals);
+std::vector<VectorPtr> Worker::SendForPull(int cmd, const KVMessage &send, const KVPartitioner &partitioner) {
   PartitionKVMessages messages;
   partitioner(send, &messages, {});
   std::vector<uint32_t> rank_ids;
@@ -964,26 +1068,26 @@ void Worker::SendForPull(int cmd, const KVMessage &send, const KVPartitioner &pa
   for (size_t i = 0; i < messages.size(); i++) {
     if (messages.at(i).first) {
       rank_ids.push_back(i);
-      std::string kv_data = messages.at(i).second.SerializeAsString();
-
-      std::shared_ptr<unsigned char[]> res(new unsigned char[kv_data.length()]);
-      size_t dest_size = kv_data.length();
-      int ret = memcpy_s(res.get(), dest_size, kv_data.data(), kv_data.length());
-      if (ret != 0) {
-        MS_LOG(ERROR) << "memcpy_s error, errorno(" << ret << ")";
-        return;
-      }
-      data.push_back(res);
-      sizes.push_back(kv_data.length());
+      size_t size = 0;
+      data.push_back(KVMessageFrame::Encode(&messages.at(i).second, &size));
+      sizes.push_back(size);
     }
   }
   std::vector<VectorPtr> resp;
   worker_node_.Send(core::NodeRole::SERVER, rank_ids, data, sizes, cmd, &resp);
+  return resp;
+}
+
+void Worker::SendForPull(int cmd, const KVMessage &send, const KVPartitioner &partitioner,
+                         const std::map<int64_t, int64_t> &attrs, std::vector<float> *vals, std::vector<int> *lens) {
+  MS_EXCEPTION_IF_NULL(vals);
+  std::vector<VectorPtr> resp = SendForPull(cmd, send, partitioner);
   vals->clear();
   for (size_t i = 0; i < resp.size(); ++i) {
     KVMessage message;
-    message.ParseFromArray(resp.at(i)->data(), resp.at(i)->size());
-    std::copy(message.values().begin(), message.values().end(), std::back_inserter(*vals));
+    size_t value_num = 0;
+    const float *values = KVMessageFrame::Decode(resp.at(i)->data(), resp.at(i)->size(), &message, &value_num);
+    (void)vals->insert(vals->end(), values, values + value_num);
 
     if (lens) {
       lens->clear();
@@ -991,5 +1095,26 @@ void Worker::SendForPull(int cmd, const KVMessage &send, const KVPartitioner &pa
     }
   }
 }
+
+void Worker::SendForPull(int cmd, const KVMessage &send, const KVPartitioner &partitioner, float *output,
+                         size_t output_num) {
+  MS_EXCEPTION_IF_NULL(output);
+  std::vector<VectorPtr> resp = SendForPull(cmd, send, partitioner);
+  size_t offset = 0;
+  for (size_t i = 0; i < resp.size(); ++i) {
+    KVMessage message;
+    size_t value_num = 0;
+    const float *values = KVMessageFrame::Decode(resp.at(i)->data(), resp.at(i)->size(), &message, &value_num);
+    if (value_num > output_num - offset) {
+      MS_LOG(EXCEPTION) << "The pulled values of key " << send.keys(0) << " exceed the " << output_num
+                        << " values of the output.";
+    }
+    auto ret = memcpy_s(output + offset, (output_num - offset) * sizeof(float), values, value_num * sizeof(float));
+    if (ret != 0) {
+      MS_LOG(EXCEPTION) << "memcpy_s error, errorno(" << ret << ")";
+    }
+    offset += value_num;
+  }
+}
 }  // namespace ps
 }  // namespace mindspore
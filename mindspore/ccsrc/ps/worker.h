@@ -37,6 +37,10 @@
 #include "ps/ps_cache/ps_data/ps_data_prefetch.h"
 #include "ps/core/worker_node.h"
 #include "ps/embedding_table_shard_metadata.h"
+#include "ps/embedding_push_pipeline.h"
+#include "ps/gradient_push_pipeline.h"
+#include "ps/gradient_compressor.h"
+#include "ps/kv_message_frame.h"
 #include "proto/comm.pb.h"
 #include "proto/ps.pb.h"
 #include "ps/ps_context.h"
@@ -59,6 +63,7 @@ class Worker {
     std::function<void(const KVMessage &send, PartitionKVMessages *partition, const std::map<int64_t, int64_t> &attrs)>;
 
   void Run();
+  // Queued in the gradient push pipeline when it is enabled, a pull of the key waits for it.
   void Push(const std::vector<size_t> &keys, std::vector<uintptr_t> addrs, const ShapeVector &sizes);
   void Pull(const size_t key, void *dev_addr, const size_t size);
   size_t SetParamKey(const std::string &param_name);
@@ -74,8 +79,11 @@ class Worker {
   void InitPSParamAndOptim(const AnfNodePtr &input_node, const tensor::TensorPtr &tensor);
   void DoPSEmbeddingLookup(const Key &key, const std::vector<int> &lookup_ids, std::vector<float> *lookup_result,
                            int64_t cmd);
+  // Queued in the push pipeline when it is enabled, lookups of this worker see the rows right away.
   void UpdateEmbeddingTable(const std::vector<Key> &keys, const std::vector<int> &lookup_ids,
                             const std::vector<float> &vals);
+  // Waits until the servers hold every row pushed by UpdateEmbeddingTable.
+  void FlushEmbeddingTableUpdates();
 
   bool running() { return running_; }
   void Finalize();
@@ -103,8 +111,14 @@ class Worker {
 
   void PushData(const std::vector<Key> &keys, const std::vector<float> &vals, const std::vector<int> &lens = {},
                 int command = 0, int64_t priority = 0);
+  // the gradient input of the optimizer is sent compressed instead of in vals
+  void PushCompressedData(const std::vector<Key> &keys, const std::vector<float> &vals, const std::vector<int> &lens,
+                          int64_t optim_id);
   void PushSparseData(const std::vector<Key> &keys, const std::vector<float> &vals, const std::vector<int> &lens,
                       size_t grad_index, size_t indice_index, size_t first_dim_size, size_t outer_dim_size);
+  void PullEmbeddings(const Key &key, const std::vector<int> &lookup_ids, std::vector<float> *lookup_result,
+                      int64_t cmd);
+  void SendEmbeddingUpdates(const Key &key, const std::vector<int> &lookup_ids, const std::vector<float> &vals);
   void PullData(const std::vector<Key> &keys, std::vector<float> *const vals, std::vector<int> *lens = nullptr,
                 int cmd = 0, int64_t priority = 0);
 
@@ -123,8 +137,13 @@ class Worker {
                             const std::map<int64_t, int64_t> &attrs);
   void SendForPush(int cmd, const KVMessage &send, const KVPartitioner &partitioner,
                    const std::map<int64_t, int64_t> &attrs);
+  // The requests and responses carry KVMessageFrame, the responses are returned as received.
+  std::vector<VectorPtr> SendForPull(int cmd, const KVMessage &send, const KVPartitioner &partitioner);
   void SendForPull(int cmd, const KVMessage &send, const KVPartitioner &partitioner,
                    const std::map<int64_t, int64_t> &attrs, std::vector<float> *vals, std::vector<int> *lens);
+  // Copies the values of the responses one after another into output of output_num floats.
+  void SendForPull(int cmd, const KVMessage &send, const KVPartitioner &partitioner, float *output,
+                   size_t output_num);
 
   int64_t server_num_;
   bool running_;
@@ -147,6 +166,9 @@ class Worker {
   std::unordered_map<Key, size_t> embedding_row_cnt_;
 
   std::unordered_map<Key, std::shared_ptr<std::vector<EmbeddingTableShardMetadata>>> embedding_table_ranges_;
+  std::unique_ptr<EmbeddingPushPipeline> embedding_push_pipeline_;
+  std::unique_ptr<GradientPushPipeline> grad_push_pipeline_;
+  std::unique_ptr<GradientCompressor> grad_compressor_;
 };
 }  // namespace ps
 }  // namespace mindspore
@@ -223,6 +223,9 @@ GraphId GraphCompiler::CompileGraphImpl(const KernelGraphPtr &graph) const {
 
   graph->set_is_all_nop_node(opt::IsAllNopNode(graph.get()));
 
+  // Plan the memory of the graph ahead, which needs the nop node flag above.
+  device_context_->PlanGraphMemory(graph);
+
   return graph->graph_id();
 }
 
@@ -24,6 +24,7 @@
 #include "utils/log_adapter.h"
 #include "utils/convert_utils.h"
 #include "common/trans.h"
+#include "common/thread_pool.h"
 
 namespace mindspore {
 namespace runtime {
@@ -359,6 +360,29 @@ void AllocateContinuousMemoryForOutput(const AnfNodePtr &kernel, const DeviceCon
     }
   }
 }
+
+// The kernel number of the widest dependency level, which bounds the kernels able to run at the same time.
+size_t GetParallelWidth(const KernelGraphPtr &graph) {
+  MS_EXCEPTION_IF_NULL(graph);
+  std::unordered_map<AnfNodePtr, size_t> kernel_levels;
+  std::vector<size_t> level_sizes;
+  for (const auto &kernel : graph->execution_order()) {
+    size_t level = 0;
+    for (size_t i = 0; i < AnfAlgo::GetInputNum(kernel); ++i) {
+      auto input_node = AnfAlgo::VisitKernelWithReturnType(AnfAlgo::GetInputNode(kernel, i), 0, true).first;
+      const auto &iter = kernel_levels.find(input_node);
+      if (iter != kernel_levels.end()) {
+        level = std::max(level, iter->second + 1);
+      }
+    }
+    kernel_levels[kernel] = level;
+    if (level >= level_sizes.size()) {
+      level_sizes.resize(level + 1, 0);
+    }
+    ++level_sizes[level];
+  }
+  return level_sizes.empty() ? 1 : *std::max_element(level_sizes.begin(), level_sizes.end());
+}
 }  // namespace
 
 void GraphScheduler::Initialize() {
@@ -370,10 +394,14 @@ void GraphScheduler::Initialize() {
   auto actorMgr = ActorMgr::GetActorMgrRef();
   MS_EXCEPTION_IF_NULL(actorMgr);
 
-  // Create the thread pool of actor runtime.
-  auto max_thread_num = GetMaxThreadNum();
-  MS_LOG(INFO) << "Max available thread number: " << max_thread_num;
-  actorMgr->Initialize(max_thread_num);
+  // Create the thread pool of actor runtime, the other half of the cores is left to the kernel thread pool.
+  max_thread_num_ = std::max<size_t>(LongToSize(GetMaxThreadNum()), 1);
+  actor_thread_num_ = std::max<size_t>(max_thread_num_ / 2, 1);
+  MS_LOG(INFO) << "Max available thread number: " << max_thread_num_ << ", actor thread number: " << actor_thread_num_;
+  actorMgr->Initialize(SizeToInt(actor_thread_num_));
+  // Size the kernel thread pool once for the graphs leaving the most cores to the kernels, the others cap the
+  // parallelism of their kernels instead of respawning the pool whenever the running graph changes.
+  common::ThreadPool::GetInstance().SetSyncRunThreadNum(max_thread_num_);
 
   // Create memory manager actor.
   auto memory_manager_actor = std::make_shared<MemoryManagerActor>();
@@ -400,6 +428,12 @@ ActorSet *GraphScheduler::Transform(const std::vector<KernelGraphPtr> &graphs,
     MS_LOG(INFO) << "Graph(" << graph->ToString() << ") transforms actor begin.";
     PersistDeviceTensor(graph);
     auto actor_set = Build(graph, device_context);
+    // Split the cores between the actors (inter-op) and the kernels (intra-op) by the graph. Wide graphs of many small
+    // kernels keep as many actor threads busy as they have branches, deep graphs leave the cores to the kernels.
+    auto busy_actor_thread_num = std::min(GetParallelWidth(graph), actor_thread_num_);
+    actor_set->kernel_thread_num_ = std::max<size_t>(max_thread_num_ - busy_actor_thread_num, 1);
+    MS_LOG(INFO) << "Graph(" << graph->ToString() << ") busy actor thread number: " << busy_actor_thread_num
+                 << ", kernel thread number: " << actor_set->kernel_thread_num_;
     actor_sets.emplace_back(actor_set);
     graph_to_actors_.emplace(graph, actor_set);
     Link(actor_set.get(), graph, strategy);
@@ -497,6 +531,8 @@ void GraphScheduler::PrepareRun(const KernelGraphPtr &graph, const std::vector<T
 
 bool GraphScheduler::Run(const ActorSet *actor_set, GraphExecutionStrategy strategy) {
   MS_EXCEPTION_IF_NULL(actor_set);
+  common::ThreadPool::GetInstance().SetParallelThreadNum(actor_set->kernel_thread_num_);
+
   // Construct OpContext.
   OpContext<DeviceTensor> op_context;
   uuids::uuid sequential_num;
@@ -54,6 +54,8 @@ struct ActorSet {
   // No input kernel actors need be triggered specifically.
   std::vector<KernelActorPtr> no_input_kernel_actors_;
   LoopCountActorPtr loop_count_actor_{nullptr};
+  // The threads of the intra-op kernel thread pool the kernels of this actor set split their work for.
+  size_t kernel_thread_num_{1};
 };
 using ActorSetPtr = std::shared_ptr<ActorSet>;
 
@@ -64,7 +66,8 @@ class GraphScheduler {
     return instance;
   }
 
-  // 1. Thread pool creating.
+  // 1. Thread pool creating. The actor thread pool is global and takes up to half of the cores, the kernel thread pool
+  // is resized for every actor set when it runs, see Transform.
   // 2. The memory manager creating and scheduling.
   void Initialize();
 
@@ -148,6 +151,10 @@ class GraphScheduler {
   // The id of memory manager actor.
   AID memory_manager_aid_;
 
+  // The thread number of the actor runtime, which can not be resized after initializing.
+  size_t actor_thread_num_{1};
+  size_t max_thread_num_{1};
+
   bool init_{false};
 };
 }  // namespace runtime
@@ -15,6 +15,7 @@
  */
 
 #include "runtime/hardware/cpu/cpu_device_context.h"
+#include <cstdint>
 #include <string>
 #include "runtime/device/cpu/cpu_device_address.h"
 #include "runtime/device/cpu/cpu_memory_manager.h"
@@ -24,9 +25,13 @@
 #include "backend/optimizer/common/optimizer.h"
 #include "backend/optimizer/common/pass_manager.h"
 #include "backend/optimizer/cpu/insert_cast_cpu.h"
+#include "backend/optimizer/cpu/embedding_lookup_segment_reduce_fusion.h"
 #include "backend/optimizer/cpu/insert_format_transform_op.h"
 #include "backend/optimizer/pass/replace_node_by_proxy.h"
 #include "backend/optimizer/pass/erase_visit_attr.h"
+#include "backend/optimizer/somas/somas.h"
+#include "debug/env_config_parser.h"
+#include "utils/ms_context.h"
 
 namespace mindspore {
 namespace device {
@@ -41,6 +46,14 @@ bool CPUDeviceContext::Initialize() {
   return true;
 }
 
+void CPUDeviceContext::Destroy() {
+  std::lock_guard<std::mutex> lock(arena_mutex_);
+  for (auto &graph_arena : graph_arenas_) {
+    FreeGraphArena(&graph_arena.second);
+  }
+  graph_arenas_.clear();
+}
+
 bool CPUDeviceContext::AllocateMemory(DeviceAddress *const &address, size_t size) const {
   MS_EXCEPTION_IF_NULL(address);
   MS_EXCEPTION_IF_NULL(mem_manager_);
@@ -58,10 +71,104 @@ void CPUDeviceContext::FreeMemory(DeviceAddress *const &address) const {
   MS_EXCEPTION_IF_NULL(address);
   MS_EXCEPTION_IF_NULL(address->ptr_);
   MS_EXCEPTION_IF_NULL(mem_manager_);
+  // The memory planned for the graph lives in its arena and is kept for the next step.
+  if (!address->from_mem_pool_) {
+    return;
+  }
   mem_manager_->FreeMemFromMemPool(address->ptr_);
   address->ptr_ = nullptr;
 }
 
+void CPUDeviceContext::FreeGraphArena(GraphArena *const graph_arena) const {
+  MS_EXCEPTION_IF_NULL(graph_arena);
+  MS_EXCEPTION_IF_NULL(mem_manager_);
+  auto arena_begin = reinterpret_cast<uintptr_t>(graph_arena->arena);
+  for (const auto &weak_address : graph_arena->addresses) {
+    auto address = weak_address.lock();
+    if (address == nullptr || address->from_mem_pool_) {
+      continue;
+    }
+    auto ptr = reinterpret_cast<uintptr_t>(address->ptr_);
+    if (ptr >= arena_begin && ptr < arena_begin + graph_arena->size) {
+      address->ptr_ = nullptr;
+    }
+  }
+  mem_manager_->FreeMemFromMemPool(graph_arena->arena);
+  graph_arena->arena = nullptr;
+  graph_arena->size = 0;
+  graph_arena->addresses.clear();
+}
+
+void CPUDeviceContext::PlanGraphMemory(const KernelGraphPtr &graph) const {
+  MS_EXCEPTION_IF_NULL(graph);
+  MS_EXCEPTION_IF_NULL(mem_manager_);
+  std::lock_guard<std::mutex> lock(arena_mutex_);
+  // Release the arenas of the destroyed graphs and the previous plan of this graph before its addresses are planned.
+  for (auto iter = graph_arenas_.begin(); iter != graph_arenas_.end();) {
+    if (iter->second.graph.expired() || iter->first == graph->graph_id()) {
+      FreeGraphArena(&iter->second);
+      iter = graph_arenas_.erase(iter);
+    } else {
+      ++iter;
+    }
+  }
+
+  auto ms_context = MsContext::GetInstance();
+  MS_EXCEPTION_IF_NULL(ms_context);
+  // The sizes of dynamic shape kernels are only known when they run, which are allocated by the actors as before.
+  if (!EnvConfigParser::GetInstance().GetSysMemreuse() ||
+      ms_context->get_param<int>(MS_CTX_EXECUTION_MODE) == kPynativeMode || graph->is_dynamic_shape()) {
+    return;
+  }
+
+  // The actors launch the kernels whose inputs are ready at the same time, so the lifetime of the tensors only
+  // follows the data dependencies instead of the execution order.
+  somas::Somas somas;
+  somas.set_parallel_execution(true);
+  if (!somas.Allocate(graph.get())) {
+    MS_LOG(EXCEPTION) << "Plan memory of graph " << graph->graph_id() << " failed.";
+  }
+  size_t arena_size = somas.GetTotalMemSize();
+  if (arena_size == 0) {
+    return;
+  }
+  auto arena = static_cast<uint8_t *>(mem_manager_->MallocMemFromMemPool(arena_size));
+  if (arena == nullptr) {
+    MS_LOG(EXCEPTION) << "Malloc memory arena of graph " << graph->graph_id() << " failed, size: " << arena_size;
+  }
+  somas.set_mem_base_addr(arena);
+  auto &graph_arena = graph_arenas_[graph->graph_id()];
+  graph_arena.graph = graph;
+  graph_arena.arena = arena;
+  graph_arena.size = arena_size;
+
+  size_t planned_size = 0;
+  auto set_planned_ptr = [&planned_size, &graph_arena](const DeviceAddressPtr &address, uint8_t *ptr) {
+    MS_EXCEPTION_IF_NULL(address);
+    if (address->ptr_ != nullptr || address->size_ == 0) {
+      return;
+    }
+    address->ptr_ = ptr;
+    address->from_mem_pool_ = false;
+    graph_arena.addresses.emplace_back(address);
+    planned_size += address->size_;
+  };
+  for (const auto &kernel : graph->execution_order()) {
+    MS_EXCEPTION_IF_NULL(kernel);
+    auto kernel_mod = AnfAlgo::GetKernelMod(kernel);
+    MS_EXCEPTION_IF_NULL(kernel_mod);
+    for (size_t i = 0; i < kernel_mod->GetOutputSizeList().size(); ++i) {
+      set_planned_ptr(AnfAlgo::GetMutableOutputAddr(kernel, i, false), somas.GetNodeOutputPtr(kernel, i));
+    }
+    for (size_t i = 0; i < kernel_mod->GetWorkspaceSizeList().size(); ++i) {
+      set_planned_ptr(AnfAlgo::GetMutableWorkspaceAddr(kernel, i), somas.GetNodeWorkSpacePtr(kernel, i));
+    }
+  }
+  // Without reuse every planned tensor would take its own memory, the arena is the peak memory of the step.
+  MS_LOG(INFO) << "Graph " << graph->graph_id() << " plans " << planned_size << " bytes of kernel outputs and workspaces"
+               << " in an arena of " << arena_size << " bytes";
+}
+
 DeviceAddressPtr CPUDeviceContext::CreateDeviceAddress(void *device_ptr, size_t device_size, const string &format,
                                                        TypeId type_id) const {
   return std::make_shared<CPUDeviceAddress>(device_ptr, device_size, format, type_id);
@@ -90,6 +197,7 @@ void CPUDeviceContext::OptimizeGraphImpl(const KernelGraphPtr &graph) const {
   auto optimizer = std::make_shared<opt::GraphOptimizer>();
   auto pm = std::make_shared<opt::PassManager>();
   pm->AddPass(std::make_shared<opt::InsertCastCPU>());
+  pm->AddPass(std::make_shared<opt::EmbeddingLookupSegmentReduceFusion>());
   pm->AddPass(std::make_shared<opt::InsertFormatTransformOpCPU>("insert_format_transform_op_cpu"));
   pm->AddPass(std::make_shared<opt::EraseVisitAttr>());
   optimizer->AddPassManager(pm);
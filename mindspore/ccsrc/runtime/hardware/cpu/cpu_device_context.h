@@ -18,7 +18,9 @@
 
 #include <vector>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <unordered_map>
 #include "runtime/hardware/device_context.h"
 #include "runtime/hardware/device_context_manager.h"
 #include "runtime/device/memory_manager.h"
@@ -34,9 +36,14 @@ class CPUDeviceContext : public DeviceContext {
 
   bool Initialize() override;
 
+  // Release the memory arenas planned for the graphs.
+  void Destroy() override;
+
   bool AllocateMemory(DeviceAddress *const &address, size_t size) const override;
   void FreeMemory(DeviceAddress *const &address) const override;
 
+  void PlanGraphMemory(const KernelGraphPtr &graph) const override;
+
   DeviceAddressPtr CreateDeviceAddress(void *device_ptr, size_t device_size, const string &format,
                                        TypeId type_id) const override;
   DeviceAddressType GetDeviceAddressType() const override { return DeviceAddressType::kCPU; }
@@ -57,9 +64,24 @@ class CPUDeviceContext : public DeviceContext {
 
   void OptimizeGraphImpl(const KernelGraphPtr &graph) const;
 
+  // The memory arena planned for a graph and the addresses placed in it.
+  struct GraphArena {
+    std::weak_ptr<session::KernelGraph> graph;
+    void *arena{nullptr};
+    size_t size{0};
+    std::vector<std::weak_ptr<DeviceAddress>> addresses;
+  };
+  // Free the arena, the addresses which are still placed in it are reset to be planned or allocated again.
+  void FreeGraphArena(GraphArena *const graph_arena) const;
+
   uint32_t device_id_;
   std::shared_ptr<MemoryManager> mem_manager_;
   bool initialized_;
+
+  // The arenas are planned when the graphs are compiled and kept until the graph is planned again, destroyed or the
+  // device context is destroyed.
+  mutable std::mutex arena_mutex_;
+  mutable std::unordered_map<uint32_t, GraphArena> graph_arenas_;
 };
 }  // namespace cpu
 }  // namespace device
@@ -63,6 +63,11 @@ class DeviceContext {
     return true;
   }
 
+  // Plan the memory of kernel outputs and workspaces of a whole graph once after the device addresses are created,
+  // the planned addresses keep their memory over the steps. Devices which allocate memory when the kernels run could
+  // ignore the implementation of this function.
+  virtual void PlanGraphMemory(const KernelGraphPtr &graph) const {}
+
   // Create concrete device address according different device type.
   virtual DeviceAddressPtr CreateDeviceAddress(void *device_ptr, size_t device_size, const string &format,
                                                TypeId type_id) const = 0;
@@ -218,6 +218,7 @@ constexpr auto kUpdateCacheOpName = "UpdateCache";
 constexpr auto kCacheSwapTableOpName = "CacheSwapTable";
 constexpr auto kEmbeddingLookupOpName = "EmbeddingLookup";
 constexpr auto kEmbeddingLookupProxyOpName = "EmbeddingLookupProxy";
+constexpr auto kEmbeddingLookupSegmentReduceOpName = "EmbeddingLookupSegmentReduce";
 constexpr auto kGatherV2OpName = "Gather";
 constexpr auto kPaddingOpName = "Padding";
 constexpr auto kAvgPoolOpName = "AvgPool";
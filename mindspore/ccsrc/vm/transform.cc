@@ -30,8 +30,12 @@
 #endif
 #include "ir/graph_utils.h"
 #include "utils/ms_context.h"
+#include "utils/ms_utils.h"
 #include "debug/trace.h"
 #include "debug/anf_ir_dump.h"
+#if (ENABLE_CPU && !_WIN32)
+#include "ps/ps_context.h"
+#endif
 
 namespace mindspore {
 namespace compile {
@@ -521,9 +525,41 @@ FinalVMPtr CompileGraphs::CompileAndLink(const FuncGraphPtr &graph) {
   return rt;
 }
 
-// Judge whether to use mindRT. GPU and CPU use mindRT currently, and other hardwares will use it in the future.
-// Return false in the transitional stage.
-bool IsMindRTUsed() { return false; }
+// Judge whether to use mindRT. Graphs of CPU run on mindRT by default so that independent kernels run concurrently,
+// MS_ENABLE_MINDRT=0 falls back to the session runtime. The graphs mindRT does not support yet fall back too, see
+// IsMindRTSupported. Other hardwares will use it in the future.
+bool IsMindRTUsed() {
+  if (common::GetEnv("MS_ENABLE_MINDRT") == "0") {
+    return false;
+  }
+  auto context_ptr = MsContext::GetInstance();
+  MS_EXCEPTION_IF_NULL(context_ptr);
+  if (context_ptr->get_param<std::string>(MS_CTX_DEVICE_TARGET) != kCPUDevice ||
+      context_ptr->get_param<int>(MS_CTX_EXECUTION_MODE) != kGraphMode) {
+    return false;
+  }
+#if (ENABLE_CPU && !_WIN32)
+  // the parameter server embeds its own runtime in the CPU session
+  if (ps::PSContext::instance()->is_ps_mode()) {
+    return false;
+  }
+#endif
+  return true;
+}
+
+bool IsMindRTSupported(const FuncGraphPtr &func_graph) {
+  MS_EXCEPTION_IF_NULL(func_graph);
+  if (!func_graph->func_graphs_used_total().empty()) {
+    return false;
+  }
+  GraphPartition graph_partition(GetMsNonlinearOps(), kMsConvert);
+  const auto &segments = graph_partition.Partition(func_graph);
+  auto kernel_graph_num = std::count_if(segments.begin(), segments.end(), [](const GraphSegmentPtr &segment) {
+    MS_EXCEPTION_IF_NULL(segment);
+    return !segment->is_cut_;
+  });
+  return kernel_graph_num <= 1;
+}
 
 BackendPtr CreateBackend() {
   auto context_ptr = MsContext::GetInstance();
@@ -134,6 +134,10 @@ class CompileGraphs {
 // Judge whether to use mindRT. GPU and CPU use mindRT currently, and other hardwares will use it in the future.
 bool IsMindRTUsed();
 
+// Judge whether mindRT is able to run the graph. MindRTBackend runs the kernel graph of the root graph only, graphs
+// calling sub graphs (control flow) or split into several kernel graphs by nonlinear nodes run on the segment VM.
+bool IsMindRTSupported(const FuncGraphPtr &func_graph);
+
 BackendPtr CreateBackend();
 
 }  // namespace compile
@@ -66,7 +66,7 @@ constexpr int RET_INPUT_PARAM_INVALID = -600; /**< Invalid input param by user.
 /// \param[in] error_code define return status of procedure.
 ///
 /// \return String of errorcode info.
-String GetErrorInfo(STATUS error_code);
+String MS_API GetErrorInfo(STATUS error_code);
 
 }  // namespace lite
 }  // namespace mindspore
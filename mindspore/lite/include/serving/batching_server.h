@@ -0,0 +1,104 @@
+/**
+ * Copyright 2021 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MINDSPORE_LITE_INCLUDE_SERVING_BATCHING_SERVER_H_
+#define MINDSPORE_LITE_INCLUDE_SERVING_BATCHING_SERVER_H_
+
+#include <cstdint>
+#include <future>
+#include <utility>
+#include <vector>
+#include "include/context.h"
+#include "include/lite_utils.h"
+
+namespace mindspore {
+namespace session {
+/// \brief ServingConfig defined for the dynamic batching of a BatchingServer.
+struct ServingConfig {
+  /// \brief Most requests run together in one session run.
+  int max_batch = 8;
+  /// \brief The longest time in microseconds the oldest queued request waits for more requests before its batch runs.
+  int64_t max_delay_us = 2000;
+  /// \brief Batch sizes compiled ahead of time, a batch runs on the smallest bucket holding it and is padded with
+  /// zeros. Empty to resize one session to the exact batch of every run.
+  std::vector<int> batch_buckets;
+  /// \brief Sessions running batches concurrently, each has its own copy of the buckets.
+  int worker_num = 1;
+};
+
+/// \brief Data of one sample for every graph input or output, in the order of the session inputs or outputs.
+using SampleData = std::vector<std::vector<char>>;
+
+/// \brief ServingStat defined for the batches a BatchingServer has run.
+struct ServingStat {
+  uint64_t batch_num = 0;
+  uint64_t sample_num = 0;
+  uint64_t padded_num = 0;
+};
+
+/// \brief BatchingServer collects concurrent single sample requests and runs them in dynamic batches, the first dim
+/// of every graph input and output is the batch dim.
+class MS_API BatchingServer {
+ public:
+  /// \brief Static method to create a BatchingServer object.
+  ///
+  /// \param[in] config Define the batching of the server.
+  ///
+  /// \return Pointer of MindSpore Lite BatchingServer.
+  static BatchingServer *CreateBatchingServer(const ServingConfig &config);
+
+  /// \brief Destructor of MindSpore Lite BatchingServer, stops the server.
+  virtual ~BatchingServer() = default;
+
+  /// \brief Compile the model for every batch bucket of every worker and start the workers.
+  ///
+  /// \param[in] model_buf Define the buffer read from a model file.
+  /// \param[in] size Define bytes number of model buffer.
+  /// \param[in] context Define the context of the sessions, which must outlive the server.
+  ///
+  /// \return STATUS as an error code of initializing the server, STATUS is defined in errorcode.h.
+  virtual int Init(const char *model_buf, size_t size, const lite::Context *context) = 0;
+
+  /// \brief Stop the workers, the requests still queued fail.
+  virtual void Stop() = 0;
+
+  /// \brief Queue a request of one sample.
+  ///
+  /// \param[in] inputs Define the data of the sample for every graph input.
+  /// \param[out] outputs Define the data of the sample for every graph output, which is filled when the future is
+  /// ready.
+  ///
+  /// \return The future of the STATUS of the request, STATUS is defined in errorcode.h.
+  virtual std::future<int> PredictAsync(SampleData inputs, SampleData *outputs) = 0;
+
+  /// \brief Queue a request of one sample and wait for its batch.
+  ///
+  /// \return STATUS as an error code of the request, STATUS is defined in errorcode.h.
+  int Predict(SampleData inputs, SampleData *outputs) { return PredictAsync(std::move(inputs), outputs).get(); }
+
+  /// \brief Get the bytes of one sample of each graph input.
+  ///
+  /// \return The vector of the sample sizes.
+  virtual const std::vector<size_t> &input_sample_size() const = 0;
+
+  /// \brief Get the batches run so far.
+  ///
+  /// \return The counters of batches, samples and padded samples.
+  virtual ServingStat stat() = 0;
+};
+}  // namespace session
+}  // namespace mindspore
+#endif  // MINDSPORE_LITE_INCLUDE_SERVING_BATCHING_SERVER_H_
@@ -26,7 +26,7 @@ namespace lite {
 constexpr int METRICS_CLASSIFICATION = 0;
 constexpr int METRICS_MULTILABEL = 1;
 
-class AccuracyMetrics : public Metrics {
+class MS_API AccuracyMetrics : public Metrics {
  public:
   explicit AccuracyMetrics(int accuracy_metrics = METRICS_CLASSIFICATION, const std::vector<int> &input_indexes = {1},
                            const std::vector<int> &output_indexes = {0});
@@ -26,7 +26,7 @@ using GraphPoint = std::pair<int, float>;
 namespace mindspore {
 namespace lite {
 
-class AccuracyMonitor : public session::TrainLoopCallBack {
+class MS_API AccuracyMonitor : public session::TrainLoopCallBack {
  public:
   explicit AccuracyMonitor(mindspore::dataset::Dataset *dataset, int check_every_n, int max_steps = -1)
       : ds_(dataset), check_every_n_(check_every_n), max_steps_(max_steps) {}
@@ -27,7 +27,7 @@ using GraphPoint = std::pair<int, float>;
 namespace mindspore {
 namespace lite {
 
-class CkptSaver : public session::TrainLoopCallBack {
+class MS_API CkptSaver : public session::TrainLoopCallBack {
  public:
   CkptSaver(int save_every_n, const std::string &filename_prefix, mindspore::lite::Model *model)
       : save_every_n_(save_every_n), filename_prefix_(filename_prefix), model_(model) {}
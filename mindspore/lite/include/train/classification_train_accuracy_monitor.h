@@ -28,7 +28,7 @@ using GraphPoint = std::pair<int, float>;
 namespace mindspore {
 namespace lite {
 
-class ClassificationTrainAccuracyMonitor : public session::TrainLoopCallBack {
+class MS_API ClassificationTrainAccuracyMonitor : public session::TrainLoopCallBack {
  public:
   explicit ClassificationTrainAccuracyMonitor(int print_every_n = INT_MAX,
                                               int accuracy_metrics = METRICS_CLASSIFICATION,
@@ -27,7 +27,7 @@ using GraphPoint = std::pair<int, float>;
 namespace mindspore {
 namespace lite {
 
-class LossMonitor : public session::TrainLoopCallBack {
+class MS_API LossMonitor : public session::TrainLoopCallBack {
  public:
   /// \brief constructor
   ///
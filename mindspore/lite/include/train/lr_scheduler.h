@@ -31,10 +31,10 @@ constexpr int UPDATE_LR = 1;
 using LR_Lambda = std::function<int(float *lr, int epoch, void *cb_data)>;
 
 /// \brief Multiply the LR by a factor of gamma every epoch
-int MultiplicativeLRLambda(float *lr, int epoch, void *multiplication);
+int MS_API MultiplicativeLRLambda(float *lr, int epoch, void *multiplication);
 
 /// \brief Multiply the LR by a factor of gamma every step_size
-int StepLRLambda(float *lr, int epoch, void *step_size);
+int MS_API StepLRLambda(float *lr, int epoch, void *step_size);
 struct StepLRLambda {
   StepLRLambda(int step, float g) : step_size(step), gamma(g) {}
 
@@ -42,7 +42,7 @@ struct StepLRLambda {
   float gamma;    // LR decay factor
 };
 
-class LRScheduler : public session::TrainLoopCallBack {
+class MS_API LRScheduler : public session::TrainLoopCallBack {
  public:
   explicit LRScheduler(LR_Lambda lambda_func, void *lr_cb_data = nullptr, int step_ = 1);
   virtual ~LRScheduler() = default;
@@ -24,7 +24,7 @@
 namespace mindspore {
 namespace session {
 
-class Metrics {
+class MS_API Metrics {
  public:
   virtual ~Metrics() = default;
   virtual void Clear() {}
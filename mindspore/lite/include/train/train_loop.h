@@ -36,7 +36,7 @@ using LoadDataFunc = std::function<int(std::vector<tensor::MSTensor *> inputs, d
 
 namespace session {
 
-class TrainLoop {
+class MS_API TrainLoop {
  public:
   /// \brief Static method to create a TrainLoop object
   ///
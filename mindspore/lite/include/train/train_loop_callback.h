@@ -19,6 +19,7 @@
 #include <string>
 #include <tuple>
 #include <unordered_map>
+#include "include/lite_utils.h"
 
 namespace mindspore {
 namespace session {
@@ -41,7 +42,7 @@ constexpr int RET_CONTINUE = 0;
 constexpr int RET_STOP_TRAINING = 1;
 constexpr int RET_EXIT = 2;
 
-class TrainLoopCallBack {
+class MS_API TrainLoopCallBack {
  public:
   virtual ~TrainLoopCallBack() = default;
 
@@ -25,7 +25,7 @@ namespace mindspore {
 namespace session {
 
 /// \brief TrainSession Defines a class that allows training a MindSpore model
-class TrainSession : public session::LiteSession {
+class MS_API TrainSession : public session::LiteSession {
  public:
   /// \brief Class destructor
   virtual ~TrainSession() = default;
@@ -103,6 +103,14 @@ class TrainSession : public session::LiteSession {
   /// \return STATUS as an error code of the set operation, STATUS is defined in errorcode.h
   virtual int SetupVirtualBatch(int virtual_batch_multiplier, float lr = -1.0f, float momentum = -1.0f) = 0;
 
+  /// \brief Setup training with recomputed activations
+  ///
+  /// \param[in] segment_num - number of segments the forward pass is split into, activations used by the backward
+  /// pass are freed after the forward pass and recomputed segment by segment, use any number < 1 to disable
+  ///
+  /// \return STATUS as an error code of the set operation, STATUS is defined in errorcode.h
+  int SetupRecompute(int segment_num);
+
   /// \brief Get output MindSpore Lite MSTensors of Training model prediction
   ///
   /// \return a vector of output tensors (MindSpore Lite MSTensor).
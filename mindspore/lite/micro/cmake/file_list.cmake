@@ -135,6 +135,7 @@ set(LITE_SRC
         ${LITE_DIR}/src/common/tensor_util.cc
         ${LITE_DIR}/src/runtime/infer_manager.cc
         ${LITE_DIR}/src/lite_model.cc
+        ${LITE_DIR}/src/runtime/packed_weight_cache.cc
         ${LITE_DIR}/src/tensorlist.cc
         ${LITE_DIR}/src/tensor.cc
         ${LITE_DIR}/src/weight_decoder.cc
@@ -194,6 +195,7 @@ set(LITE_KERNEL_SRC
         ${NNACL_DIR}/fp32/arithmetic_fp32.c
         ${NNACL_DIR}/fp32/deconv_fp32.c
         ${NNACL_DIR}/fp32/matmul_fp32.c
+        ${NNACL_DIR}/fp32/sparse_matmul_fp32.c
         ${NNACL_DIR}/fp32/common_func_fp32.c
         ${NNACL_DIR}/fp32/resize_fp32.c
         ${NNACL_DIR}/int8/quantize.c
@@ -85,9 +85,19 @@ void MemoryAllocator::RecordTensorsAddr(const std::map<Tensor *, size_t> &offset
     auto tensor = item.first;
     auto offset = item.second;
     tensors_addr_.insert(std::make_pair(tensor, kBufferPrefixNameAdd + std::to_string(offset)));
+    tensors_offset_.insert(std::make_pair(tensor, offset));
   }
 }
 
+bool MemoryAllocator::IsAliasOf(Tensor *tensor, Tensor *base, size_t offset) const {
+  auto tensor_iter = tensors_offset_.find(tensor);
+  auto base_iter = tensors_offset_.find(base);
+  if (tensor_iter == tensors_offset_.end() || base_iter == tensors_offset_.end()) {
+    return false;
+  }
+  return tensor_iter->second == base_iter->second + offset;
+}
+
 void MemoryAllocator::AssignGraphInputs(const std::vector<Tensor *> &inputs) {
   size_t num = inputs.size();
   for (size_t i = 0; i < num; ++i) {
@@ -128,6 +128,12 @@ class MemoryAllocator {
 
   std::map<Tensor *, std::string> tensors_map() const;
 
+  /*
+   * whether the tensor is assigned to the buffer of the base tensor with the given offset,
+   * in which case copying the tensor into the base is needless
+   */
+  bool IsAliasOf(Tensor *tensor, Tensor *base, size_t offset = 0) const;
+
   /**
    * @return weight tensor map which
    */
@@ -158,6 +164,7 @@ class MemoryAllocator {
   std::map<Tensor *, std::string> origin_weights_addr_;
   std::map<Tensor *, std::string> malloc_weights_addr_;
   std::map<Tensor *, std::string> tensors_addr_;
+  std::map<Tensor *, size_t> tensors_offset_;
 };
 }  // namespace mindspore::lite::micro
 #endif  // MINDSPORE_LITE_MICRO_CODER_MEMORY_ALLOCATOR_H_
@@ -15,8 +15,12 @@
  */
 
 #include "coder/allocator/memory_manager.h"
+#include <algorithm>
+#include <cstdint>
+#include <functional>
 #include <vector>
 #include "coder/opcoders/op_coder.h"
+#include "src/common/utils.h"
 
 namespace mindspore::lite::micro {
 
@@ -26,142 +30,248 @@ static size_t AlignMemorySize(size_t size) {
   return ((size + kDefaultMemAlignSize - 1) / kDefaultMemAlignSize) * kDefaultMemAlignSize;
 }
 
+// ops whose output is the input with another shape
+static const std::vector<int> kReshapeLikeOps = {schema::PrimitiveType_Reshape, schema::PrimitiveType_Flatten,
+                                                 schema::PrimitiveType_ExpandDims, schema::PrimitiveType_Squeeze,
+                                                 schema::PrimitiveType_Unsqueeze};
+
+// ops whose i-th output element only depends on the i-th elements of the same sized inputs,
+// so that the output can overwrite such an input in place.
+static const std::vector<int> kElementWiseOps = {
+  schema::PrimitiveType_Activation, schema::PrimitiveType_AddFusion, schema::PrimitiveType_SubFusion,
+  schema::PrimitiveType_MulFusion,  schema::PrimitiveType_DivFusion, schema::PrimitiveType_RealDiv,
+  schema::PrimitiveType_Maximum,    schema::PrimitiveType_Minimum,   schema::PrimitiveType_SquaredDifference,
+  schema::PrimitiveType_Abs,        schema::PrimitiveType_Cos,       schema::PrimitiveType_Sin,
+  schema::PrimitiveType_Log,        schema::PrimitiveType_Square,    schema::PrimitiveType_Sqrt,
+  schema::PrimitiveType_Rsqrt,      schema::PrimitiveType_Floor,     schema::PrimitiveType_Ceil,
+  schema::PrimitiveType_Round,      schema::PrimitiveType_Neg,       schema::PrimitiveType_Erf,
+  schema::PrimitiveType_ExpFusion};
+
 int MemoryManager::AssignMemory(const std::vector<std::unique_ptr<OperatorCoder>> &nodes) {
   for (const auto &node : nodes) {
-    AssignOutputs(node);
-    StoreMembufListInfo(node);
-    ReleaseInputs(node);
+    for (const auto &tensor : node->input_tensors()) {
+      MS_CHECK_PTR(tensor);
+    }
+    for (const auto &tensor : node->output_tensors()) {
+      MS_CHECK_PTR(tensor);
+    }
+  }
+  CollectTensorLives(nodes);
+  for (size_t i = 0; i < nodes.size(); ++i) {
+    AliasInplaceOutput(nodes.at(i), i);
+    AliasConcatInputs(nodes.at(i), i);
+  }
+  std::vector<size_t> block_index;
+  std::vector<MemBlock> blocks = BuildBlocks(&block_index);
+  std::vector<size_t> order(blocks.size());
+  for (size_t i = 0; i < order.size(); ++i) {
+    order[i] = i;
+  }
+  // finding the optimal offsets is NP-hard, greedy placement in a few orders is close to the lower bound in practice
+  auto length = [](const MemBlock &block) { return block.end - block.start + 1; };
+  std::vector<std::function<bool(const MemBlock &, const MemBlock &)>> rules = {
+    [](const MemBlock &a, const MemBlock &b) { return a.size > b.size; },
+    [length](const MemBlock &a, const MemBlock &b) {
+      return length(a) > length(b) || (length(a) == length(b) && a.size > b.size);
+    },
+    [length](const MemBlock &a, const MemBlock &b) { return a.size * length(a) > b.size * length(b); }};
+  std::vector<MemBlock> best_blocks;
+  for (const auto &rule : rules) {
+    std::stable_sort(order.begin(), order.end(),
+                     [&blocks, &rule](size_t a, size_t b) { return rule(blocks.at(a), blocks.at(b)); });
+    size_t size = PlaceBlocks(order, &blocks);
+    if (best_blocks.empty() || size < allocated_size_) {
+      allocated_size_ = size;
+      best_blocks = blocks;
+    }
+  }
+  for (const auto &life : lives_) {
+    size_t offset = best_blocks.at(block_index.at(life.root)).offset + life.offset_in_root;
+    variables_offset_.insert(std::make_pair(life.tensor, offset));
   }
+  ReportPeakMemory(best_blocks);
   return RET_OK;
 }
 
-void MemoryManager::StoreMembufListInfo(const std::unique_ptr<OperatorCoder> &node) {
-  std::vector<MembufPtr> temp;
-  for (const auto &membuf : membuf_list_) {
-    auto buf = std::make_shared<Membuf>(membuf->key_, membuf->status_, membuf->size_, membuf->offset_);
-    temp.emplace_back(buf);
-  }
-  auto info = std::make_pair(node->node_index(), temp);
-  all_membuf_list_info_.emplace_back(info);
+void MemoryManager::CollectTensorLives(const std::vector<std::unique_ptr<OperatorCoder>> &nodes) {
+  for (size_t i = 0; i < nodes.size(); ++i) {
+    for (const auto &input : nodes.at(i)->input_tensors()) {
+      auto iter = life_index_.find(input);
+      if (iter != life_index_.end()) {
+        lives_.at(iter->second).end = i;
+      }
+    }
+    for (const auto &output : nodes.at(i)->output_tensors()) {
+      if (life_index_.find(output) != life_index_.end()) {
+        continue;
+      }
+      size_t index = lives_.size();
+      life_index_.insert(std::make_pair(output, index));
+      // a tensor used by no node is a graph output, which is read after the whole inference
+      lives_.push_back({output, output->Size(), i, nodes.size(), index, 0});
+    }
+  }
 }
 
-size_t MemoryManager::GetAllocatedSize() const {
-  if (membuf_list_.empty()) {
-    return 0;
+bool MemoryManager::CanAlias(Tensor *input, Tensor *output, size_t node_index) {
+  auto in_iter = life_index_.find(input);
+  auto out_iter = life_index_.find(output);
+  if (in_iter == life_index_.end() || out_iter == life_index_.end() || input == output) {
+    return false;
   }
-  return membuf_list_.back()->offset_ + membuf_list_.back()->size_;
+  auto &in_life = lives_.at(in_iter->second);
+  auto &out_life = lives_.at(out_iter->second);
+  // the input must die at this node, otherwise later users would read the overwritten data
+  return in_life.end == node_index && out_life.root == out_iter->second && in_life.size == out_life.size &&
+         input->data_type() == output->data_type();
 }
 
-void MemoryManager::AssignOutputs(const std::unique_ptr<OperatorCoder> &node) {
-  for (const auto &output : node->output_tensors()) {
-    if (output == nullptr) {
-      MS_LOG(ERROR) << "output tensor is nullptr";
-      return;
-    }
-    size_t size = AlignMemorySize(output->Size());
-    std::map<size_t, size_t> size_map = GetReusableMembufMap(size);
-    if (size_map.empty()) {
-      AssignNewMembuf(output, size);
-    } else {
-      size_t membuf_index = size_map.begin()->second;
-      ReuseExistedMembuf(membuf_index, output, size);
+void MemoryManager::MergeLife(size_t member, size_t root, size_t offset_in_root) {
+  lives_.at(member).root = root;
+  lives_.at(member).offset_in_root = offset_in_root;
+}
+
+void MemoryManager::AliasInplaceOutput(const std::unique_ptr<OperatorCoder> &node, size_t node_index) {
+  if (node->output_tensors().size() != 1) {
+    return;
+  }
+  bool reshape_like = IsContain(kReshapeLikeOps, node->type());
+  if (!reshape_like && !IsContain(kElementWiseOps, node->type())) {
+    return;
+  }
+  Tensor *output = node->output_tensors().front();
+  auto inputs = node->input_tensors();
+  // the second input of reshape-like ops is the shape
+  size_t candidate_num = reshape_like ? 1 : inputs.size();
+  for (size_t i = 0; i < candidate_num && i < inputs.size(); ++i) {
+    if (!CanAlias(inputs.at(i), output, node_index)) {
+      continue;
     }
+    auto &in_life = lives_.at(life_index_.at(inputs.at(i)));
+    MergeLife(life_index_.at(output), in_life.root, in_life.offset_in_root);
+    return;
   }
 }
 
-void MemoryManager::ReleaseInputs(const std::unique_ptr<OperatorCoder> &node) {
-  // release node input and workspace
-  for (const auto &input : node->input_tensors()) {
-    if (input == nullptr) {
-      MS_LOG(ERROR) << "input tensor is nullptr";
+void MemoryManager::AliasConcatInputs(const std::unique_ptr<OperatorCoder> &node, size_t node_index) {
+  // int8 concat requantizes the inputs, only the float one is a pure copy
+  if (node->type() != schema::PrimitiveType_Concat || node->output_tensors().size() != 1 ||
+      node->output_tensors().front()->data_type() != kNumberTypeFloat32) {
+    return;
+  }
+  Tensor *output = node->output_tensors().front();
+  auto out_iter = life_index_.find(output);
+  auto inputs = node->input_tensors();
+  if (out_iter == life_index_.end() || lives_.at(out_iter->second).root != out_iter->second || inputs.size() < 2) {
+    return;
+  }
+  // the inputs are contiguous in the output only if all dims before the concat axis are 1
+  auto out_shape = output->shape();
+  auto in_shape = inputs.front()->shape();
+  if (in_shape.size() != out_shape.size()) {
+    return;
+  }
+  size_t axis = 0;
+  while (axis < out_shape.size() && in_shape.at(axis) == out_shape.at(axis)) {
+    ++axis;
+  }
+  for (size_t i = 0; i < axis && i < out_shape.size(); ++i) {
+    if (out_shape.at(i) != 1) {
       return;
     }
-    if (input->category() != Tensor::VAR && input->data_c() != nullptr) {
-      continue;
-    }
-    input->DecRefCount();
-    if (input->ref_count() > 0) {
-      continue;
+  }
+  size_t total_size = 0;
+  for (const auto &input : inputs) {
+    auto in_iter = life_index_.find(input);
+    if (in_iter == life_index_.end() || std::count(inputs.begin(), inputs.end(), input) != 1) {
+      return;
     }
-    auto item = std::find_if(membuf_list_.begin(), membuf_list_.end(),
-                             [input](const MembufPtr &membuf) { return membuf->key_ == input; });
-    if (item == membuf_list_.end()) {
-      continue;
+    // an input dying here has no alias yet, but it may be an alias of another tensor itself
+    auto &in_life = lives_.at(in_iter->second);
+    if (in_life.end != node_index || in_life.root != in_iter->second || input->data_type() != output->data_type()) {
+      return;
     }
-    auto membuf = *item;
-    membuf->status_ = kUnused;
+    total_size += input->Size();
   }
-  MergeMembuf();
-}
-
-void MemoryManager::AssignNewMembuf(Tensor *key, size_t size) {
-  MS_LOG(DEBUG) << "assign new membuf: " << size;
-  size_t offset = GetAllocatedSize();
-  auto membuf = std::make_shared<Membuf>(key, kReused, size, offset);
-  membuf_list_.push_back(membuf);
-  variables_offset_.insert(std::make_pair(key, offset));
-}
-
-void MemoryManager::ReuseExistedMembuf(size_t index, Tensor *key, size_t size) {
-  MembufPtr membuf = membuf_list_[index];
-  UpdataMembufInfo(membuf, key);
-  if (membuf->size_ > size) {
-    SplitMembuf(index, size);
+  if (total_size != output->Size()) {
+    return;
+  }
+  size_t offset = 0;
+  for (const auto &input : inputs) {
+    MergeLife(life_index_.at(input), out_iter->second, offset);
+    offset += input->Size();
   }
 }
 
-void MemoryManager::UpdataMembufInfo(const MembufPtr &membuf, Tensor *key) {
-  membuf->status_ = kReused;
-  membuf->key_ = key;
-  variables_offset_.insert(std::make_pair(key, membuf->offset_));
-}
-
-void MemoryManager::SplitMembuf(size_t index, size_t size) {
-  if (index >= membuf_list_.size()) {
-    MS_LOG(ERROR) << "Index out of vector range.";
-  }
-  auto membuf = membuf_list_[index];
-  size_t bias = membuf->size_ - size;
-  if (bias < 32) {
-    return;  // Res is too smallTensor
-  }
-  membuf->size_ = size;
-  auto new_membuf = std::make_shared<Membuf>(kUnused, bias, membuf->offset_ + membuf->size_);
-  (void)membuf_list_.insert(membuf_list_.begin() + index + 1, new_membuf);
+std::vector<MemBlock> MemoryManager::BuildBlocks(std::vector<size_t> *block_index) {
+  std::vector<MemBlock> blocks;
+  block_index->assign(lives_.size(), 0);
+  for (size_t i = 0; i < lives_.size(); ++i) {
+    if (lives_.at(i).root == i) {
+      block_index->at(i) = blocks.size();
+      blocks.push_back({0, lives_.at(i).start, lives_.at(i).end, 0});
+    }
+  }
+  for (const auto &life : lives_) {
+    auto &block = blocks.at(block_index->at(life.root));
+    block.size = std::max(block.size, AlignMemorySize(life.offset_in_root + life.size));
+    block.start = std::min(block.start, life.start);
+    block.end = std::max(block.end, life.end);
+  }
+  return blocks;
 }
 
-void MemoryManager::MergeMembuf() {
-  if (membuf_list_.empty()) {
-    return;
-  }
-  std::vector<MembufPtr> temp;
-  bool is_continue = false;
-  for (const auto &membuf : membuf_list_) {
-    if (membuf->status_ == kReused) {
-      temp.emplace_back(membuf);
-      is_continue = false;
-    } else {
-      if (!is_continue) {
-        temp.emplace_back(membuf);
-        is_continue = true;
-      } else {
-        auto back = temp.back();
-        back->size_ += membuf->size_;
+size_t MemoryManager::PlaceBlocks(const std::vector<size_t> &order, std::vector<MemBlock> *blocks) {
+  size_t total_size = 0;
+  std::vector<MemBlock *> placed;
+  for (auto index : order) {
+    auto &block = blocks->at(index);
+    std::vector<std::pair<size_t, size_t>> used;
+    for (const auto *other : placed) {
+      if (other->start <= block.end && block.start <= other->end) {
+        used.emplace_back(other->offset, other->offset + other->size);
+      }
+    }
+    std::sort(used.begin(), used.end());
+    size_t best_offset = 0;
+    size_t best_gap = SIZE_MAX;
+    size_t cursor = 0;
+    for (const auto &range : used) {
+      if (range.first > cursor && range.first - cursor >= block.size && range.first - cursor < best_gap) {
+        best_gap = range.first - cursor;
+        best_offset = cursor;
       }
+      cursor = std::max(cursor, range.second);
     }
+    block.offset = best_gap == SIZE_MAX ? cursor : best_offset;
+    total_size = std::max(total_size, block.offset + block.size);
+    placed.push_back(&block);
   }
-  membuf_list_ = temp;
+  return total_size;
 }
 
-std::map<size_t, size_t> MemoryManager::GetReusableMembufMap(size_t size) {
-  std::map<size_t, size_t> size_map;
-  for (size_t i = 0; i < membuf_list_.size(); ++i) {
-    auto membuf = membuf_list_[i];
-    auto index = i;
-    if (membuf->status_ == kUnused && membuf->size_ >= size) {
-      (void)size_map.insert(std::make_pair(membuf->size_, index));
+void MemoryManager::ReportPeakMemory(const std::vector<MemBlock> &blocks) const {
+  size_t no_reuse_size = 0;
+  for (const auto &life : lives_) {
+    no_reuse_size += AlignMemorySize(life.size);
+  }
+  size_t end = 0;
+  for (const auto &block : blocks) {
+    end = std::max(end, block.end);
+  }
+  // no placement can be smaller than the bytes alive at the same time
+  size_t lower_bound = 0;
+  for (size_t i = 0; i <= end; ++i) {
+    size_t live_size = 0;
+    for (const auto &block : blocks) {
+      if (block.start <= i && i <= block.end) {
+        live_size += block.size;
+      }
     }
+    lower_bound = std::max(lower_bound, live_size);
   }
-  return size_map;
+  MS_LOG(INFO) << "tensor buffer size: " << allocated_size_ << " bytes, " << no_reuse_size
+               << " bytes without reuse, lower bound: " << lower_bound << " bytes, " << lives_.size()
+               << " tensors in " << blocks.size() << " memory blocks";
 }
 }  // namespace mindspore::lite::micro
@@ -26,20 +26,26 @@
 namespace mindspore::lite::micro {
 class OperatorCoder;
 
-enum Status { kUnused = 0, kReused = 1 };
+/*
+ * the life of a variable tensor, measured by the index of the op which produces it and the last op which uses it.
+ * tensors sharing memory with each other are put into one group, the root of a group owns the memory block and
+ * the other members lie in it at a fixed offset.
+ */
+struct TensorLife {
+  Tensor *tensor{nullptr};
+  size_t size{0};
+  size_t start{0};
+  size_t end{0};
+  size_t root{0};
+  size_t offset_in_root{0};
+};
 
-class Membuf {
- public:
-  Membuf(Status status, size_t size, size_t offset) : status_(status), size_(size), offset_(offset) {}
-  Membuf(Tensor *key, Status status, size_t size, size_t offset)
-      : key_(key), status_(status), size_(size), offset_(offset) {}
-  ~Membuf() = default;
-  Tensor *key_ = nullptr;
-  Status status_;
-  size_t size_;
-  size_t offset_;
+struct MemBlock {
+  size_t size{0};
+  size_t start{0};
+  size_t end{0};
+  size_t offset{0};
 };
-using MembufPtr = std::shared_ptr<Membuf>;
 
 class MemoryManager {
  public:
@@ -47,27 +53,27 @@ class MemoryManager {
   ~MemoryManager() = default;
 
   int AssignMemory(const std::vector<std::unique_ptr<OperatorCoder>> &nodes);
-  size_t GetAllocatedSize() const;
+  size_t GetAllocatedSize() const { return allocated_size_; }
   std::map<Tensor *, size_t> variables_offset() { return variables_offset_; }
 
  private:
-  void AssignOutputs(const std::unique_ptr<OperatorCoder> &node);
-  void ReleaseInputs(const std::unique_ptr<OperatorCoder> &node);
+  void CollectTensorLives(const std::vector<std::unique_ptr<OperatorCoder>> &nodes);
+  // reuse the memory of the input for the output of reshape-like ops and element-wise ops
+  void AliasInplaceOutput(const std::unique_ptr<OperatorCoder> &node, size_t node_index);
+  // place the inputs of concat one after another in the memory of its output, so that concat copies nothing
+  void AliasConcatInputs(const std::unique_ptr<OperatorCoder> &node, size_t node_index);
+  bool CanAlias(Tensor *input, Tensor *output, size_t node_index);
+  void MergeLife(size_t member, size_t root, size_t offset_in_root);
+  std::vector<MemBlock> BuildBlocks(std::vector<size_t> *block_index);
+  void ReportPeakMemory(const std::vector<MemBlock> &blocks) const;
 
-  void SplitMembuf(size_t index, size_t size);
-  void MergeMembuf();
-  void UpdataMembufInfo(const MembufPtr &membuf, Tensor *key);
-  void AssignNewMembuf(Tensor *key, size_t size);
-  void ReuseExistedMembuf(size_t index, Tensor *key, size_t size);
+  // offset solver: greedy placement in the given order, each block takes the best fit gap among live blocks
+  static size_t PlaceBlocks(const std::vector<size_t> &order, std::vector<MemBlock> *blocks);
 
-  std::map<size_t, size_t> GetReusableMembufMap(size_t size);
-
-  void StoreMembufListInfo(const std::unique_ptr<OperatorCoder> &node);
-
- private:
-  std::vector<MembufPtr> membuf_list_;
-  std::vector<std::pair<size_t, std::vector<MembufPtr>>> all_membuf_list_info_;
+  std::vector<TensorLife> lives_;
+  std::map<Tensor *, size_t> life_index_;
   std::map<Tensor *, size_t> variables_offset_;
+  size_t allocated_size_{0};
 };
 
 }  // namespace mindspore::lite::micro
@@ -27,6 +27,7 @@
 #include "schema/inner/model_generated.h"
 #include "securec/include/securec.h"
 #include "src/common/prim_util.h"
+#include "src/weight_decoder.h"
 
 namespace mindspore::lite::micro {
 CoderGraph::~CoderGraph() {
@@ -82,14 +83,20 @@ int CoderGraph::ConvertTensors() {
     MS_CHECK_PTR(dstTensor);
     if (origin_tensor->nodeType() == NodeType_ValueNode && origin_tensor->data() != nullptr &&
         origin_tensor->data()->size() > 0) {
-      // copy data, this is weight && bias
-      MS_CHECK_TRUE_WITH_EXE(origin_tensor->data()->size() > 0, "invalid meta_tensor data size.", delete dstTensor);
-      auto data_size = static_cast<size_t>(origin_tensor->data()->size());
-      MS_CHECK_RET_CODE_WITH_EXE(dstTensor->MallocData(), "dst tensor malloc data failed!", delete dstTensor);
-      void *dst_data = dstTensor->data_c();
-      MS_CHECK_RET_CODE_WITH_EXE(memcpy_s(dst_data, dstTensor->Size(), origin_tensor->data()->data(), data_size),
-                                 "memcpy_s copy data failed!", delete dstTensor);
-      dstTensor->set_data(dst_data);
+      if (WeightDecoder::IsCompressed(*origin_tensor)) {
+        // compressed weights (e.g. block sparse ones) are restored to dense the same way the runtime does
+        MS_CHECK_RET_CODE_WITH_EXE(WeightDecoder::DecompressTensor(*origin_tensor, dstTensor),
+                                   "decompress weight data failed!", delete dstTensor);
+      } else {
+        // copy data, this is weight && bias
+        MS_CHECK_TRUE_WITH_EXE(origin_tensor->data()->size() > 0, "invalid meta_tensor data size.", delete dstTensor);
+        auto data_size = static_cast<size_t>(origin_tensor->data()->size());
+        MS_CHECK_RET_CODE_WITH_EXE(dstTensor->MallocData(), "dst tensor malloc data failed!", delete dstTensor);
+        void *dst_data = dstTensor->data_c();
+        MS_CHECK_RET_CODE_WITH_EXE(memcpy_s(dst_data, dstTensor->Size(), origin_tensor->data()->data(), data_size),
+                                   "memcpy_s copy data failed!", delete dstTensor);
+        dstTensor->set_data(dst_data);
+      }
     }
     if (origin_tensor->name() != nullptr) {
       dstTensor->set_tensor_name(origin_tensor->name()->str());
@@ -33,7 +33,10 @@ int ReshapeBaseCoder::Prepare(CoderContext *const context) { return RET_OK; }
 
 int ReshapeBaseCoder::DoCode(CoderContext *const context) {
   Serializer coder;
-
+  // the output shares the memory of the input when the input is not used any more
+  if (allocator_->IsAliasOf(output_tensor_, input_tensor_)) {
+    return RET_OK;
+  }
   size_t size = input_tensor_->Size();
   coder.CodeFunction("memcpy", output_tensor_, input_tensor_, size);
 
@@ -35,6 +35,16 @@ int ConcatFP32Coder::ReSize() {
 }
 
 int ConcatFP32Coder::DoCode(CoderContext *const context) {
+  // the inputs may have been written into the output buffer one after another already
+  size_t offset = 0;
+  bool in_place = true;
+  for (const auto &input : input_tensors_) {
+    in_place = in_place && allocator_->IsAliasOf(input, output_tensor_, offset);
+    offset += input->Size();
+  }
+  if (in_place) {
+    return RET_OK;
+  }
   Collect(context,
           {
             "nnacl/base/concat_base.h",
@@ -0,0 +1,143 @@
+/**
+ * Copyright 2019 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <memory>
+#include <vector>
+#include "gtest/gtest.h"
+#include "coder/allocator/memory_manager.h"
+#include "coder/opcoders/op_coder.h"
+
+namespace mindspore::lite::micro::test {
+class FakeCoder : public OperatorCoder {
+ public:
+  FakeCoder(const std::vector<Tensor *> &in_tensors, const std::vector<Tensor *> &out_tensors,
+            const Model::Node *node, size_t node_index, int type)
+      : OperatorCoder(in_tensors, out_tensors, node, node_index, kAllTargets) {
+    set_type(type);
+  }
+  int Prepare(CoderContext *const context) override { return RET_OK; }
+  int DoCode(CoderContext *const context) override { return RET_OK; }
+};
+
+TEST(MemoryManagerTest, InplaceAndConcatAlias) {
+  Model::Node node;
+  auto new_tensor = [](int channel) {
+    return std::make_unique<Tensor>(kNumberTypeFloat32, std::vector<int>{1, channel}, schema::Format_NHWC);
+  };
+  auto input = new_tensor(100);
+  auto conv = new_tensor(100);
+  auto relu = new_tensor(100);
+  auto reshape = new_tensor(100);
+  auto left = new_tensor(50);
+  auto right = new_tensor(50);
+  auto concat = new_tensor(100);
+  auto output = new_tensor(100);
+  std::vector<std::unique_ptr<OperatorCoder>> nodes;
+  auto add_node = [&nodes, &node](const std::vector<Tensor *> &inputs, Tensor *out, int type) {
+    nodes.push_back(std::make_unique<FakeCoder>(inputs, std::vector<Tensor *>{out}, &node, nodes.size(), type));
+  };
+  add_node({input.get()}, conv.get(), schema::PrimitiveType_Conv2DFusion);
+  add_node({conv.get()}, relu.get(), schema::PrimitiveType_Activation);
+  add_node({relu.get()}, reshape.get(), schema::PrimitiveType_Reshape);
+  add_node({reshape.get()}, left.get(), schema::PrimitiveType_Conv2DFusion);
+  add_node({reshape.get()}, right.get(), schema::PrimitiveType_Conv2DFusion);
+  add_node({left.get(), right.get()}, concat.get(), schema::PrimitiveType_Concat);
+  add_node({concat.get()}, output.get(), schema::PrimitiveType_Conv2DFusion);
+
+  MemoryManager manager;
+  ASSERT_EQ(manager.AssignMemory(nodes), RET_OK);
+  auto offsets = manager.variables_offset();
+  // relu works in place and reshape aliases its input
+  ASSERT_EQ(offsets[conv.get()], offsets[relu.get()]);
+  ASSERT_EQ(offsets[relu.get()], offsets[reshape.get()]);
+  // the inputs of concat are produced right in its output
+  ASSERT_EQ(offsets[left.get()], offsets[concat.get()]);
+  ASSERT_EQ(offsets[right.get()], offsets[concat.get()] + left->Size());
+  // two buffers of 400 bytes are enough for the whole graph
+  ASSERT_EQ(manager.GetAllocatedSize(), 800u);
+}
+
+TEST(MemoryManagerTest, MultiConsumerInputs) {
+  Model::Node node;
+  auto new_tensor = [](int channel) {
+    return std::make_unique<Tensor>(kNumberTypeFloat32, std::vector<int>{1, channel}, schema::Format_NHWC);
+  };
+  auto input = new_tensor(100);
+  auto conv = new_tensor(100);
+  auto relu = new_tensor(100);
+  auto add = new_tensor(100);
+  auto left = new_tensor(50);
+  auto right = new_tensor(50);
+  auto concat = new_tensor(100);
+  auto output = new_tensor(50);
+  std::vector<std::unique_ptr<OperatorCoder>> nodes;
+  auto add_node = [&nodes, &node](const std::vector<Tensor *> &inputs, Tensor *out, int type) {
+    nodes.push_back(std::make_unique<FakeCoder>(inputs, std::vector<Tensor *>{out}, &node, nodes.size(), type));
+  };
+  add_node({input.get()}, conv.get(), schema::PrimitiveType_Conv2DFusion);
+  add_node({conv.get()}, relu.get(), schema::PrimitiveType_Activation);
+  add_node({conv.get(), relu.get()}, add.get(), schema::PrimitiveType_AddFusion);
+  add_node({add.get()}, left.get(), schema::PrimitiveType_Conv2DFusion);
+  add_node({add.get()}, right.get(), schema::PrimitiveType_Conv2DFusion);
+  add_node({left.get(), right.get()}, concat.get(), schema::PrimitiveType_Concat);
+  add_node({concat.get(), left.get()}, output.get(), schema::PrimitiveType_Conv2DFusion);
+
+  MemoryManager manager;
+  ASSERT_EQ(manager.AssignMemory(nodes), RET_OK);
+  auto offsets = manager.variables_offset();
+  // conv is still read by add, relu must not overwrite it
+  ASSERT_NE(offsets[conv.get()], offsets[relu.get()]);
+  // both inputs of add die there, the output takes the first one
+  ASSERT_EQ(offsets[conv.get()], offsets[add.get()]);
+  // left is read again after concat, so the inputs are not placed in the output
+  ASSERT_TRUE(offsets[left.get()] + left->Size() <= offsets[concat.get()] ||
+              offsets[concat.get()] + concat->Size() <= offsets[left.get()]);
+  ASSERT_TRUE(offsets[right.get()] + right->Size() <= offsets[concat.get()] ||
+              offsets[concat.get()] + concat->Size() <= offsets[right.get()]);
+}
+
+TEST(MemoryManagerTest, ConcatWithLeadingDims) {
+  Model::Node node;
+  auto new_tensor = [](const std::vector<int> &shape) {
+    return std::make_unique<Tensor>(kNumberTypeFloat32, shape, schema::Format_NHWC);
+  };
+  auto input = new_tensor({2, 100});
+  auto left = new_tensor({2, 50});
+  auto right = new_tensor({2, 50});
+  auto concat = new_tensor({2, 100});
+  auto output = new_tensor({2, 100});
+  std::vector<std::unique_ptr<OperatorCoder>> nodes;
+  auto add_node = [&nodes, &node](const std::vector<Tensor *> &inputs, Tensor *out, int type) {
+    nodes.push_back(std::make_unique<FakeCoder>(inputs, std::vector<Tensor *>{out}, &node, nodes.size(), type));
+  };
+  add_node({input.get()}, left.get(), schema::PrimitiveType_Conv2DFusion);
+  add_node({input.get()}, right.get(), schema::PrimitiveType_Conv2DFusion);
+  add_node({left.get(), right.get()}, concat.get(), schema::PrimitiveType_Concat);
+  add_node({concat.get()}, output.get(), schema::PrimitiveType_Conv2DFusion);
+
+  MemoryManager manager;
+  ASSERT_EQ(manager.AssignMemory(nodes), RET_OK);
+  auto offsets = manager.variables_offset();
+  // the rows of left and right interleave in the output, concat has to copy them
+  ASSERT_NE(offsets[left.get()], offsets[concat.get()]);
+  ASSERT_TRUE(offsets[left.get()] + left->Size() <= offsets[concat.get()] ||
+              offsets[concat.get()] + concat->Size() <= offsets[left.get()]);
+  ASSERT_TRUE(offsets[right.get()] + right->Size() <= offsets[concat.get()] ||
+              offsets[concat.get()] + concat->Size() <= offsets[right.get()]);
+  // left, right and concat are alive together, input and output can share memory with them
+  ASSERT_EQ(manager.GetAllocatedSize(), 1600u);
+}
+}  // namespace mindspore::lite::micro::test
@@ -37,7 +37,8 @@ int InputTensor2TensorC(const std::vector<lite::Tensor *> &tensors_in, std::vect
     tensor_c->format_ = tensors_in[i]->format();
     tensor_c->data_type_ = tensors_in[i]->data_type();
     tensor_c->shape_size_ = shape_size;
-    tensor_c->data_ = tensors_in[i]->data_c();
+    // lazy weights are decoded only when shape inference can not do without their values
+    tensor_c->data_ = tensors_in[i]->IsLazy() ? nullptr : tensors_in[i]->data_c();
     for (size_t j = 0; j < shape_size; ++j) {
       tensor_c->shape_[j] = tensors_in[i]->shape()[j];
     }
@@ -90,7 +91,7 @@ void FreeTensorListC(TensorListC *tensorlist_c) {
 void Tensor2TensorC(Tensor *src, TensorC *dst) {
   dst->is_ready_ = src->IsReady();
   dst->format_ = src->format();
-  dst->data_ = src->data_c();
+  dst->data_ = src->IsLazy() ? nullptr : src->data_c();
   dst->data_type_ = src->data_type();
   dst->shape_size_ = src->shape().size();
   for (size_t i = 0; i < dst->shape_size_; i++) {
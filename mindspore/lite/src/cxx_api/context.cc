@@ -26,6 +26,7 @@
 namespace mindspore {
 constexpr auto kModelOptionCpuEnableFP16 = "mindspore.option.cpu.enable_fp16";
 constexpr auto kModelOptionCpuThreadAffinity = "mindspore.option.cpu.thread_affinity";
+constexpr auto kModelOptionCpuEnableParallel = "mindspore.option.cpu.enable_parallel";
 constexpr auto kModelOptionMaliGpuEnableFP16 = "mindspore.option.mali_gpu.enable_fp16";
 constexpr auto kModelOptionKirinNpuFrequency = "mindspore.option.kirin_npu.frequency";
 
@@ -127,6 +128,21 @@ int CPUDeviceInfo::GetThreadAffinity() const {
   return GetValue<int>(data_, kModelOptionCpuThreadAffinity);
 }
 
+void CPUDeviceInfo::SetEnableParallel(bool is_parallel) {
+  if (data_ == nullptr) {
+    MS_LOG(ERROR) << "Invalid context.";
+    return;
+  }
+  data_->params[kModelOptionCpuEnableParallel] = is_parallel;
+}
+bool CPUDeviceInfo::GetEnableParallel() const {
+  if (data_ == nullptr) {
+    MS_LOG(ERROR) << "Invalid context.";
+    return false;
+  }
+  return GetValue<bool>(data_, kModelOptionCpuEnableParallel);
+}
+
 void MaliGPUDeviceInfo::SetEnableFP16(bool is_fp16) {
   if (data_ == nullptr) {
     MS_LOG(ERROR) << "Invalid context.";
@@ -24,6 +24,7 @@
 #include "include/lite_session.h"
 #include "include/context.h"
 #include "src/lite_model.h"
+#include "src/lite_session.h"
 #include "src/runtime/allocator.h"
 #include "src/common/string_util.h"
 #include "src/cxx_api/graph/graph_data.h"
@@ -109,6 +110,7 @@ Status ModelImpl::Build() {
     MS_LOG(ERROR) << "Allocate session failed.";
     return kLiteNullptr;
   }
+  (reinterpret_cast<lite::LiteSession *>(session.get()))->set_enable_parallel(cpu_context->GetEnableParallel());
   auto ret = session->CompileGraph(model.get());
   if (ret != RET_OK) {
     MS_LOG(ERROR) << "Build model failed.";
@@ -28,6 +28,8 @@ namespace mindspore::lite {
 struct InnerContext : public Context {
  public:
   struct ThreadPool *thread_pool_ = nullptr;
+  // run independent kernels of a cpu subgraph concurrently
+  bool enable_parallel_ = false;
 
  public:
   InnerContext() = default;
@@ -36,14 +36,33 @@ using mindspore::kernel::KERNEL_ARCH;
 using mindspore::kernel::KernelCreator;
 using mindspore::kernel::KernelKey;
 
+#ifdef MSLITE_SELECTIVE_KERNELS
+// bounds of the REG_KERNEL entries, provided by the linker for sections named as a C identifier
+extern "C" mindspore::lite::KernelRegistration __start_mslite_kernels[];
+extern "C" mindspore::lite::KernelRegistration __stop_mslite_kernels[];
+#endif
+
 namespace mindspore::lite {
 namespace {
 static const int kKernelMaxNum = (kNumberTypeEnd - kNumberTypeBegin + 1) * (PrimitiveType_MAX - PrimitiveType_MIN + 1);
+
+#ifdef MSLITE_SELECTIVE_KERNELS
+KernelCreator FindLinkedCreator(const KernelKey &desc) {
+  for (auto *reg = __start_mslite_kernels; reg < __stop_mslite_kernels; ++reg) {
+    if (reg->creator != nullptr && reg->arch == desc.arch && reg->data_type == desc.data_type &&
+        reg->op_type == desc.type) {
+      return reg->creator;
+    }
+  }
+  return nullptr;
+}
+#endif
 }  // namespace
 
 KernelRegistry *KernelRegistry::GetInstance() {
   static KernelRegistry instance;
 
+#ifndef MSLITE_SELECTIVE_KERNELS
   std::unique_lock<std::mutex> malloc_creator_array(instance.lock_);
   if (instance.creator_arrays_ == nullptr) {
     instance.creator_arrays_ = reinterpret_cast<KernelCreator *>(malloc(array_size_ * sizeof(KernelCreator)));
@@ -52,6 +71,7 @@ KernelRegistry *KernelRegistry::GetInstance() {
     }
     memset(instance.creator_arrays_, 0, array_size_ * sizeof(KernelCreator));
   }
+#endif
   return &instance;
 }
 
@@ -106,7 +126,15 @@ kernel::KernelCreator KernelRegistry::GetCreator(const KernelKey &desc) {
                     << desc.type;
       return nullptr;
     }
+#ifdef MSLITE_SELECTIVE_KERNELS
+    // creators registered at runtime, e.g. by a train session replacing ops, go before the linked ones
+    if (creator_arrays_ != nullptr && creator_arrays_[index] != nullptr) {
+      return creator_arrays_[index];
+    }
+    return FindLinkedCreator(desc);
+#else
     return creator_arrays_[index];
+#endif
   }
   MS_LOG(ERROR) << "Call wrong interface!vendor: " << desc.vendor;
   return nullptr;
@@ -149,19 +177,32 @@ void KernelRegistry::RegKernel(const KernelKey desc, const kernel::KernelCreator
                   << desc.type;
     return;
   }
+#ifdef MSLITE_SELECTIVE_KERNELS
+  if (AllocCreatorArrays() != RET_OK) {
+    return;
+  }
+#endif
   creator_arrays_[index] = creator;
 }
 
 void KernelRegistry::RegKernel(KERNEL_ARCH arch, TypeId data_type, int op_type, kernel::KernelCreator creator) {
   KernelKey desc = {arch, data_type, op_type};
-  int index = GetCreatorFuncIndex(desc);
-  if (index >= array_size_) {
-    MS_LOG(ERROR) << "invalid kernel key, arch " << desc.arch << ", data_type" << desc.data_type << ",op type "
-                  << desc.type;
-    return;
+  RegKernel(desc, creator);
+}
+
+#ifdef MSLITE_SELECTIVE_KERNELS
+int KernelRegistry::AllocCreatorArrays() {
+  std::unique_lock<std::mutex> malloc_creator_array(lock_);
+  if (creator_arrays_ == nullptr) {
+    creator_arrays_ = reinterpret_cast<KernelCreator *>(calloc(array_size_, sizeof(KernelCreator)));
+    if (creator_arrays_ == nullptr) {
+      MS_LOG(ERROR) << "malloc kernel creator array failed";
+      return RET_ERROR;
+    }
   }
-  creator_arrays_[index] = creator;
+  return RET_OK;
 }
+#endif
 
 bool KernelRegistry::Merge(const std::unordered_map<KernelKey, KernelCreator> &new_creators) { return false; }
 
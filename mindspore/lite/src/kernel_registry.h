@@ -24,6 +24,9 @@
 #include "src/lite_kernel.h"
 #include "src/register_kernel.h"
 #include "schema/model_generated.h"
+#ifdef MSLITE_SELECTIVE_KERNELS
+#include "selected_kernel_ops.h"
+#endif
 
 using mindspore::kernel::kKernelArch_MAX;
 using mindspore::kernel::kKernelArch_MIN;
@@ -62,6 +65,10 @@ class KernelRegistry {
   std::set<std::string> all_vendors_;
 
  private:
+#ifdef MSLITE_SELECTIVE_KERNELS
+  // only creators registered at runtime land in creator_arrays_, it stays unallocated if there are none
+  int AllocCreatorArrays();
+#endif
   std::mutex lock_;
 };
 
@@ -78,8 +85,38 @@ class KernelRegistrar {
   }
 };
 
+#ifdef MSLITE_SELECTIVE_KERNELS
+// Selective build: every REG_KERNEL is a constant initialized entry of the MSLITE_KERNEL_SECTION linker section
+// instead of a static constructor. Kernels of operators missing from kSelectedOps (generated from the models given
+// to the build) keep a null creator, nothing references their code any more and the linker strips it.
+#define MSLITE_KERNEL_SECTION "mslite_kernels"
+
+struct KernelRegistration {
+  kernel::KERNEL_ARCH arch;
+  TypeId data_type;
+  int op_type;
+  kernel::KernelCreator creator;
+};
+
+constexpr bool IsOpSelected(int op_type, size_t index = 0) {
+  return index < sizeof(kSelectedOps) / sizeof(kSelectedOps[0]) &&
+         (kSelectedOps[index] == op_type || IsOpSelected(op_type, index + 1));
+}
+
+constexpr KernelRegistration MakeKernelRegistration(kernel::KERNEL_ARCH arch, TypeId data_type, int op_type,
+                                                    kernel::KernelCreator creator) {
+  return {arch, data_type, op_type, IsOpSelected(op_type) ? creator : nullptr};
+}
+
+// the explicit alignment stops the compiler from padding entries apart, the section must stay a plain array
+#define REG_KERNEL(arch, data_type, op_type, kernelCreater)                                                    \
+  __attribute__((used, section(MSLITE_KERNEL_SECTION), aligned(alignof(mindspore::lite::KernelRegistration)))) \
+  static mindspore::lite::KernelRegistration g_##arch##data_type##op_type##kernelReg =                         \
+    mindspore::lite::MakeKernelRegistration(arch, data_type, op_type, kernelCreater);
+#else
 #define REG_KERNEL(arch, data_type, op_type, kernelCreater) \
   static KernelRegistrar g_##arch##data_type##op_type##kernelReg(arch, data_type, op_type, kernelCreater);
+#endif
 }  // namespace mindspore::lite
 
 #endif  // MINDSPORE_LITE_SRC_KERNEL_REGISTRY_H_
@@ -87,6 +87,13 @@ int LiteKernel::FreeInWorkTensor() const {
 }
 
 int LiteKernel::PreProcess() {
+  // weights left encoded during compiling are decoded at the first run of their kernel
+  for (auto *input : this->in_tensors()) {
+    if (input->IsLazy() && input->DecodeLazyData() != RET_OK) {
+      MS_LOG(ERROR) << "Decode weight " << input->tensor_name() << " failed";
+      return RET_ERROR;
+    }
+  }
   if (!InferShapeDone()) {
     auto ret = lite::KernelInferShape(in_tensors_, &out_tensors_, op_parameter_);
     if (ret != 0) {
@@ -60,6 +60,13 @@ struct KernelKey {
 
 enum SubGraphType { kNotSubGraph = 0, kCpuFP32SubGraph, kCpuFP16SubGraph, kGpuSubGraph, kNpuSubGraph, kApuSubGraph };
 
+// state a kernel derives from its tensor shapes in shape inference and ReSize, e.g. parameter fields, tiling and the
+// size of its workspace. Kernels subclass it for their own fields.
+class KernelShapeState {
+ public:
+  virtual ~KernelShapeState() = default;
+};
+
 class LiteKernel {
  public:
   LiteKernel() = default;
@@ -96,6 +103,13 @@ class LiteKernel {
 
   virtual int ReSize() { return mindspore::lite::RET_ERROR; }
 
+  // A sub graph saves the shape state of a kernel after resizing it and restores it, instead of inferring and resizing
+  // the kernel again, when its inputs come back to shapes seen before. The state covers the parameter fields written
+  // by shape inference. Kernels returning nullptr are inferred and resized on every shape change.
+  virtual std::shared_ptr<KernelShapeState> SaveShapeState() { return nullptr; }
+
+  virtual int RestoreShapeState(const std::shared_ptr<KernelShapeState> &state) { return mindspore::lite::RET_ERROR; }
+
   virtual void FindInoutKernels(const std::vector<kernel::LiteKernel *> &scope_kernels);
 
   virtual int Init() { return mindspore::lite::RET_ERROR; }
@@ -16,6 +16,11 @@
 
 #include "src/lite_model.h"
 #include <sys/stat.h>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
 #include <iostream>
 #include <fstream>
 #include <vector>
@@ -24,6 +29,7 @@
 #include <memory>
 #include "src/common/prim_util.h"
 #include "src/common/graph_util.h"
+#include "src/runtime/packed_weight_cache.h"
 #ifdef ENABLE_V0
 #include "src/ops/compat/compat_register.h"
 #endif
@@ -95,7 +101,9 @@ int LiteModel::ConvertAttrToTensors() {
 #endif
 
 void LiteModel::Free() {
-  if (this->buf != nullptr) {
+  // weights of a mapped model are used in place by sessions, the mapping is released in Destroy
+  if (this->buf != nullptr && !this->mmap_buf_) {
+    PackedWeightCache::GetInstance()->RemoveModelBuffer(this->buf);
     free(this->buf);
     this->buf = nullptr;
   }
@@ -126,12 +134,20 @@ void LiteModel::Destroy() {
     delete node;
   }
   this->all_nodes_.clear();
+  this->node_device_types_.clear();
 
   auto sub_graph_size = this->sub_graphs_.size();
   for (size_t i = 0; i < sub_graph_size; ++i) {
     auto sub_graph = this->sub_graphs_[i];
     delete sub_graph;
   }
+#ifndef _WIN32
+  if (this->mmap_buf_ && this->buf != nullptr) {
+    PackedWeightCache::GetInstance()->RemoveModelBuffer(this->buf);
+    munmap(this->buf, this->buf_size_);
+    this->buf = nullptr;
+  }
+#endif
 }
 
 int LiteModel::ConvertSubGraph(const schema::SubGraph &sub_graph) {
@@ -279,6 +295,11 @@ bool LiteModel::ModelVerify() const {
   return NodeVerify() == RET_OK && SubGraphVerify() == RET_OK;
 }
 
+int LiteModel::NodeDeviceType(const Model::Node *node) const {
+  auto iter = node_device_types_.find(node);
+  return iter == node_device_types_.end() ? kDefaultDeviceType : iter->second;
+}
+
 const void *LiteModel::GetMetaGraphByVerison() {
   MS_ASSERT(this->buf != nullptr);
   auto schema_version = VersionManager::GetInstance()->GetSchemaVersion();
@@ -379,6 +400,7 @@ Model *ImportFromBuffer(const char *model_buf, size_t size, bool take_buf) {
     delete model;
     return nullptr;
   }
+  PackedWeightCache::GetInstance()->AddModelBuffer(model->buf, size);
   return model;
 }
 
@@ -434,6 +456,53 @@ Model *Model::Import(const char *filename) {
   return ImportFromBuffer(buf.get(), size, false);
 }
 
+Model *ImportFromMappedFile(const char *filename) {
+#ifndef _WIN32
+  if (filename == nullptr) {
+    MS_LOG(ERROR) << "The model file name is nullptr";
+    return nullptr;
+  }
+  int fd = open(filename, O_RDONLY);
+  if (fd < 0) {
+    MS_LOG(ERROR) << "File: " << filename << " open failed";
+    return nullptr;
+  }
+  struct stat file_stat {};
+  if (fstat(fd, &file_stat) != 0 || file_stat.st_size <= 0) {
+    MS_LOG(ERROR) << "Could not read file " << filename;
+    close(fd);
+    return nullptr;
+  }
+  auto size = static_cast<size_t>(file_stat.st_size);
+  // private writable mapping: kernels which touch const data in place only copy the pages they write
+  auto buf = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (buf == MAP_FAILED) {
+    MS_LOG(ERROR) << "mmap model file failed: " << filename;
+    return nullptr;
+  }
+  auto *model = new (std::nothrow) LiteModel();
+  if (model == nullptr) {
+    MS_LOG(ERROR) << "new model fail!";
+    munmap(buf, size);
+    return nullptr;
+  }
+  model->buf = reinterpret_cast<char *>(buf);
+  model->buf_size_ = size;
+  model->mmap_buf_ = true;
+  auto status = model->ConstructModel();
+  if (status != RET_OK) {
+    MS_LOG(ERROR) << "construct model failed.";
+    delete model;
+    return nullptr;
+  }
+  PackedWeightCache::GetInstance()->AddModelBuffer(model->buf, size);
+  return model;
+#else
+  return Model::Import(filename);
+#endif
+}
+
 int Model::Export(Model *model, char *buffer, size_t *len) {
   if (len == nullptr) {
     MS_LOG(ERROR) << "len is nullptr";
@@ -18,6 +18,7 @@
 #define MINDSPORE_LITE_SRC_LITE_MODEL_H_
 
 #include <string>
+#include <unordered_map>
 #include <vector>
 #include "include/errorcode.h"
 #include "include/model.h"
@@ -31,12 +32,18 @@
 
 namespace mindspore {
 namespace lite {
+// node may run on any device
+constexpr int kDefaultDeviceType = -1;
+
 class LiteModel : public Model {
  public:
   int ConstructModel();
 
   bool ModelVerify() const;
 
+  // DeviceType the converter assigned to node, kDefaultDeviceType if it assigned none
+  int NodeDeviceType(const Model::Node *node) const;
+
   void Free() override;
 
   void Destroy() override;
@@ -50,6 +57,11 @@ class LiteModel : public Model {
   int ConvertAttrToTensors();
 #endif
 
+  static int CNodeDeviceType(const schema::CNode &c_node) { return c_node.deviceType(); }
+#ifdef ENABLE_V0
+  static int CNodeDeviceType(const schema::v0::CNode &) { return kDefaultDeviceType; }
+#endif
+
   template <typename T = schema::MetaGraph, typename U = schema::CNode>
   bool ConvertNodes(const T &meta_graph) {
     if (meta_graph.nodes() == nullptr) {
@@ -63,6 +75,10 @@ class LiteModel : public Model {
         return false;
       }
       auto c_node = meta_graph.nodes()->template GetAs<U>(i);
+      auto device_type = CNodeDeviceType(*c_node);
+      if (device_type != kDefaultDeviceType) {
+        node_device_types_[node] = device_type;
+      }
       node->primitive_ = c_node->primitive();
       node->quant_type_ = c_node->quantType();
       if (node->quant_type_ == schema::QuantType_PostTraining || node->quant_type_ == schema::QuantType_AwareTraining) {
@@ -203,13 +219,19 @@ class LiteModel : public Model {
 
  public:
   size_t buf_size_ = 0;
+  // buf is a private mapping of the model file, const tensors stay views into it until Destroy
+  bool mmap_buf_ = false;
   std::vector<char *> node_bufs_;
 
  protected:
   std::vector<char *> attr_tensor_bufs_;
+  std::unordered_map<const Model::Node *, int> node_device_types_;
 };
 
 Model *ImportFromBuffer(const char *model_buf, size_t size, bool take_buf);
+
+// map the model file instead of reading it, the returned model must outlive the sessions compiled from it
+Model *ImportFromMappedFile(const char *filename);
 }  // namespace lite
 }  // namespace mindspore
 
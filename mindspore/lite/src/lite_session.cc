@@ -42,45 +42,6 @@
 
 namespace mindspore {
 namespace lite {
-namespace {
-int DecompressTensor(const schema::Tensor &src_tensor, Tensor *dst_tensor) {
-  MS_ASSERT(dst_tensor != nullptr);
-  if (src_tensor.weightQunatCompressType() == schema::WeightQunatCompressType_INDEXING) {
-    return IndexingDecompress(src_tensor, dst_tensor);
-  } else if (src_tensor.weightQunatCompressType() == schema::WeightQunatCompressType_SPARSE) {
-    return SparseDecompress(src_tensor, dst_tensor);
-  }
-
-  bool need_bit_unpack = src_tensor.quantParams() != nullptr && src_tensor.quantParams()->size() > 0 &&
-                         src_tensor.quantParams()->Get(0) != nullptr && src_tensor.quantParams()->Get(0)->inited();
-  if (need_bit_unpack) {
-    auto num_bits = src_tensor.quantParams()->Get(0)->numBits();
-    need_bit_unpack = ((num_bits > 0 && num_bits < 8) || (num_bits > 8 && num_bits < 16));
-  }
-  if (!src_tensor.enableHuffmanCode() && !need_bit_unpack) {
-    return RET_NO_CHANGE;
-  }
-  // huffman code and bit pack are not assumed to be performed at same time
-  STATUS ret = RET_ERROR;
-  if (src_tensor.enableHuffmanCode()) {
-    ret = WeightDecoder::DecodeHuffmanCode(src_tensor, dst_tensor);
-    if (ret != RET_OK && ret != RET_NO_CHANGE) {
-      MS_LOG(ERROR) << "Decode huffman code failed: " << ret;
-      return ret;
-    }
-  } else if (need_bit_unpack) {
-    ret = WeightDecoder::UnPackToInt(src_tensor, dst_tensor);
-    if (ret != RET_OK && ret != RET_NO_CHANGE) {
-      MS_LOG(ERROR) << "Unpack to int8 failed: " << ret;
-      return ret;
-    }
-  } else {
-    ret = RET_OK;
-  }
-  return ret;
-}
-}  // namespace
-
 LiteSession::LiteSession() { this->is_running_.store(false); }
 
 void LiteSession::ConvertTensorsQuantParam(const schema::Tensor *src_tensor, lite::Tensor *dst_tensor) {
@@ -125,8 +86,19 @@ int LiteSession::ConvertTensorsData(const lite::Model *model, size_t tensor_inde
         MS_LOG(ERROR) << "Decode tensorlist data failed";
         return RET_ERROR;
       }
+    } else if (reinterpret_cast<const LiteModel *>(model)->mmap_buf_ && !is_train_session_ && WeightDecoder::IsCompressed(*src_tensor)) {
+      // compressed weights of a mapped model stay encoded in the mapping until a kernel first reads them
+      dst_tensor->set_lazy_decoder([src_tensor](Tensor *tensor) {
+        auto ret = WeightDecoder::DecompressTensor(*src_tensor, tensor);
+        if (ret == RET_NO_CHANGE) {
+          tensor->set_data(const_cast<unsigned char *>(src_tensor->data()->data()));
+          tensor->set_own_data(false);
+          return RET_OK;
+        }
+        return ret;
+      });
     } else {
-      auto ret = DecompressTensor(*src_tensor, dst_tensor);
+      auto ret = WeightDecoder::DecompressTensor(*src_tensor, dst_tensor);
       if (ret == RET_NO_CHANGE) {
         dst_tensor->set_data(const_cast<unsigned char *>(src_tensor->data()->data()));
         dst_tensor->set_own_data(false);
@@ -461,6 +433,12 @@ int LiteSession::CompileGraph(Model *model) {
     is_running_.store(false);
     return ret;
   }
+  ret = PlanStaticMemory();
+  if (ret != RET_OK) {
+    MS_LOG(ERROR) << "Plan static memory failed: " << ret;
+    is_running_.store(false);
+    return ret;
+  }
 #ifndef SUPPORT_TRAIN
   // For reducing runtime RAM, free packop weight because packop will pack weight and will not access to origin weight
   FreePackOpWeight(kernels_);
@@ -469,6 +447,30 @@ int LiteSession::CompileGraph(Model *model) {
   return RET_OK;
 }  // namespace lite
 
+int LiteSession::PlanStaticMemory() {
+  if (memory_planner_ != nullptr) {
+    memory_planner_->Release();
+  }
+  // the plan follows the serial execution order of a single cpu fp32 subgraph, other graphs use the allocator
+  if (is_train_session_ || context_->enable_parallel_ || kernels_.size() != 1 ||
+      kernels_.front()->subgraph_type() != kernel::kCpuFP32SubGraph) {
+    return RET_OK;
+  }
+  if (memory_planner_ == nullptr) {
+    memory_planner_ = new (std::nothrow) StaticMemoryPlanner();
+    if (memory_planner_ == nullptr) {
+      MS_LOG(ERROR) << "New StaticMemoryPlanner failed";
+      return RET_ERROR;
+    }
+  }
+  auto sub_graph = reinterpret_cast<kernel::SubGraphKernel *>(kernels_.front());
+  auto ret = memory_planner_->Plan(sub_graph->nodes(), inputs_, outputs_);
+  if (ret != RET_OK) {
+    MS_LOG(WARNING) << "Plan static memory failed, tensors are allocated at runtime.";
+  }
+  return RET_OK;
+}
+
 int LiteSession::PrepareKernels(Model *model) {
   std::vector<kernel::LiteKernel *> all_kernels;
   // find in_kernels and out_kernels for subgraphs
@@ -610,6 +612,8 @@ LiteSession::~LiteSession() {
   delete this->context_;
   delete this->executor_;
   this->executor_ = nullptr;
+  delete this->memory_planner_;
+  this->memory_planner_ = nullptr;
 #if SUPPORT_NPU
   MS_ASSERT(npu_manager_ != nullptr);
   MS_ASSERT(npu_pass_manager_ != nullptr);
@@ -749,6 +753,12 @@ int LiteSession::Resize(const std::vector<mindspore::tensor::MSTensor *> &inputs
     is_running_.store(false);
     return ret;
   }
+  ret = PlanStaticMemory();
+  if (ret != RET_OK) {
+    MS_LOG(ERROR) << "Plan static memory failed: " << ret;
+    is_running_.store(false);
+    return ret;
+  }
   is_running_.store(false);
   return RET_OK;
 }
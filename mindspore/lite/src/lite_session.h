@@ -29,6 +29,7 @@
 #include "src/inner_context.h"
 #include "schema/model_generated.h"
 #include "src/executor.h"
+#include "src/runtime/static_memory_planner.h"
 #include "src/tensor.h"
 #include "src/tensorlist.h"
 #if SUPPORT_NPU
@@ -74,6 +75,18 @@ class LiteSession : public session::LiteSession {
 
   void set_model(Model *model) { this->model_ = model; }
 
+  // takes effect on the graphs compiled afterwards
+  void set_enable_parallel(bool enable_parallel) {
+    if (this->context_ != nullptr) {
+      this->context_->enable_parallel_ = enable_parallel;
+    }
+  }
+
+  // the thread pool the kernels run on, e.g. for the kernel profiler of the benchmark
+  struct ThreadPool *GetThreadPool() const {
+    return this->context_ == nullptr ? nullptr : this->context_->thread_pool_;
+  }
+
  protected:
   static void ConvertTensorsQuantParam(const schema::Tensor *src_tensor, lite::Tensor *dst_tensor);
 
@@ -108,6 +121,8 @@ class LiteSession : public session::LiteSession {
 
   static void FreePackOpWeight(const std::vector<kernel::LiteKernel *> &kernels);
 
+  int PlanStaticMemory();
+
  private:
   void ResetInputsShape(const std::vector<std::vector<int>> &dims);
 
@@ -132,6 +147,7 @@ class LiteSession : public session::LiteSession {
   // graph output tensor name -- output tensor
   std::unordered_map<std::string, mindspore::tensor::MSTensor *> output_tensor_map_;
   Executor *executor_ = nullptr;
+  StaticMemoryPlanner *memory_planner_ = nullptr;
   Model *model_ = nullptr;
   std::atomic<bool> is_running_ = false;
   bool is_train_session_ = false;
@@ -17,6 +17,7 @@
 #ifndef MINDSPORE_LITE_SRC_RUNTIME_KERNEL_ARM_FP32_ACTIVATION_H_
 #define MINDSPORE_LITE_SRC_RUNTIME_KERNEL_ARM_FP32_ACTIVATION_H_
 
+#include <memory>
 #include <vector>
 #include "src/lite_kernel.h"
 #include "nnacl/fp32/activation_fp32.h"
@@ -38,6 +39,9 @@ class ActivationCPUKernel : public LiteKernel {
   int ReSize() override;
   int Run() override;
   int DoActivation(int task_id);
+  // nothing is derived from shapes
+  std::shared_ptr<KernelShapeState> SaveShapeState() override { return std::make_shared<KernelShapeState>(); }
+  int RestoreShapeState(const std::shared_ptr<KernelShapeState> &state) override { return lite::RET_OK; }
 
  private:
   int thread_count_;
@@ -16,6 +16,7 @@
 #ifndef MINDSPORE_LITE_SRC_RUNTIME_KERNEL_ARM_FP32_ARITHMETIC_SELF_H_
 #define MINDSPORE_LITE_SRC_RUNTIME_KERNEL_ARM_FP32_ARITHMETIC_SELF_H_
 
+#include <memory>
 #include <vector>
 #include "src/lite_kernel.h"
 
@@ -51,6 +52,9 @@ class ArithmeticSelfCPUKernel : public LiteKernel {
   int ReSize() override;
   int Run() override;
   virtual int DoExecute(int task_id);
+  // nothing is derived from shapes
+  std::shared_ptr<KernelShapeState> SaveShapeState() override { return std::make_shared<KernelShapeState>(); }
+  int RestoreShapeState(const std::shared_ptr<KernelShapeState> &state) override { return lite::RET_OK; }
 
  private:
   ArithmeticSelfFunc GetArithmeticSelfFun(int primitive_type);
@@ -22,12 +22,21 @@ using mindspore::lite::RET_MEMORY_FAILED;
 using mindspore::lite::RET_OK;
 
 namespace mindspore::kernel {
+namespace {
+// ratio of zero blocks from which the block sparse kernel beats the dense packed one
+constexpr float kSparseConv1x1Threshold = 0.7f;
+}  // namespace
+
 Convolution1x1CPUKernel::~Convolution1x1CPUKernel() {
   FreeTmpBuffer();
   if (weight_ptr_ != nullptr) {
     free(weight_ptr_);
     weight_ptr_ = nullptr;
   }
+  if (sparse_weight_ != nullptr) {
+    free(sparse_weight_);
+    sparse_weight_ = nullptr;
+  }
   if (matmul_param_ != nullptr) {
     delete matmul_param_;
     matmul_param_ = nullptr;
@@ -85,6 +94,52 @@ int Convolution1x1CPUKernel::InitConv1x1BiasWeight() {
     memset(reinterpret_cast<char *>(bias_data_) + weight_size, 0, size - weight_size);
   }
 
+  auto ret = InitSparseWeight(input_channel, output_channel);
+  if (ret != RET_OK) {
+    return ret;
+  }
+  if (sparse_weight_ != nullptr) {
+    return RET_OK;
+  }
+  return InitDenseWeight();
+}
+
+int Convolution1x1CPUKernel::InitSparseWeight(int input_channel, int output_channel) {
+  if (is_trainable()) {
+    return RET_OK;
+  }
+  int block_num = BlockSparseNonzeroNum(origin_weight_, output_channel, input_channel);
+  int total_block = UP_DIV(output_channel, SPARSE_BLOCK) * input_channel;
+  float sparsity = 1.0f - static_cast<float>(block_num) / MSMAX(total_block, 1);
+  if (sparsity < kSparseConv1x1Threshold) {
+    // 2:4 pruned weights scatter their zeros, so few whole blocks are zero
+    if (!IsSparse24(origin_weight_, output_channel, input_channel)) {
+      return RET_OK;
+    }
+    sparse_weight_ = malloc(Sparse24PackSize(output_channel, input_channel));
+    if (sparse_weight_ == nullptr) {
+      MS_LOG(ERROR) << "Conv1x1 Malloc sparse_weight_ error!";
+      return RET_ERROR;
+    }
+    PackSparse24(origin_weight_, sparse_weight_, output_channel, input_channel);
+    sparse24_ = true;
+    MS_LOG(INFO) << name_ << " runs 2:4 sparse conv1x1";
+    return RET_OK;
+  }
+  sparse_weight_ = malloc(BlockSparsePackSize(output_channel, block_num));
+  if (sparse_weight_ == nullptr) {
+    MS_LOG(ERROR) << "Conv1x1 Malloc sparse_weight_ error!";
+    return RET_ERROR;
+  }
+  PackBlockSparse(origin_weight_, sparse_weight_, output_channel, input_channel);
+  MS_LOG(INFO) << name_ << " runs block sparse conv1x1, sparsity: " << sparsity;
+  return RET_OK;
+}
+
+int Convolution1x1CPUKernel::InitDenseWeight() {
+  auto filter_tensor = in_tensors_.at(kWeightIndex);
+  auto input_channel = filter_tensor->Channel();
+  auto output_channel = filter_tensor->Batch();
   int size = input_channel * UP_ROUND(output_channel, col_tile_) * sizeof(float);
   int down_size = input_channel * DOWN_DIV(output_channel, col_tile_) * col_tile_ * sizeof(float);
   weight_ptr_ = reinterpret_cast<float *>(malloc(size));
@@ -104,7 +159,16 @@ int Convolution1x1CPUKernel::InitConv1x1BiasWeight() {
 }
 
 int Convolution1x1CPUKernel::InitConv1x1Param() {
-  if ((matmul_param_->row_ > (row_tile_ * op_parameter_->thread_num_)) && (matmul_param_->row_ > matmul_param_->col_)) {
+  if (sparse24_) {
+    multi_thread_by_hw_ = false;
+    thread_count_ = MSMIN(op_parameter_->thread_num_, matmul_param_->col_);
+    thread_stride_ = UP_DIV(matmul_param_->col_, thread_count_);
+  } else if (sparse_weight_ != nullptr) {
+    multi_thread_by_hw_ = false;
+    thread_count_ = MSMIN(op_parameter_->thread_num_, UP_DIV(matmul_param_->col_, SPARSE_BLOCK));
+    thread_stride_ = UP_DIV(UP_DIV(matmul_param_->col_, SPARSE_BLOCK), thread_count_);
+  } else if ((matmul_param_->row_ > (row_tile_ * op_parameter_->thread_num_)) &&
+             (matmul_param_->row_ > matmul_param_->col_)) {
     multi_thread_by_hw_ = true;
     thread_count_ = MSMIN(op_parameter_->thread_num_, UP_DIV(matmul_param_->row_, row_tile_));
     thread_stride_ = UP_DIV(UP_DIV(matmul_param_->row_, row_tile_), thread_count_) * row_tile_;
@@ -178,6 +242,29 @@ int Convolution1x1CPUKernel::DoConv1x1(int task_id) {
   return RET_OK;
 }
 
+int Convolution1x1CPUKernel::DoSparseConv1x1(int task_id) {
+  if (sparse24_) {
+    Sparse24MatMulFp32(pack_input_, sparse_weight_, output_ptr_, reinterpret_cast<float *>(bias_data_),
+                       matmul_param_->act_type_, matmul_param_->deep_, matmul_param_->row_, matmul_param_->col_,
+                       task_id * thread_stride_, (task_id + 1) * thread_stride_);
+    return RET_OK;
+  }
+  SparseMatMulFp32(input_ptr_, sparse_weight_, output_ptr_, reinterpret_cast<float *>(bias_data_),
+                   matmul_param_->act_type_, matmul_param_->deep_, matmul_param_->row_, matmul_param_->col_,
+                   task_id * thread_stride_, (task_id + 1) * thread_stride_);
+  return RET_OK;
+}
+
+int Convolution1x1SparseRun(void *cdata, int task_id) {
+  auto conv1x1 = reinterpret_cast<Convolution1x1CPUKernel *>(cdata);
+  auto error_code = conv1x1->DoSparseConv1x1(task_id);
+  if (error_code != RET_OK) {
+    MS_LOG(ERROR) << "Convolution1x1SparseRun error task_id[" << task_id << "] error_code[" << error_code << "]";
+    return RET_ERROR;
+  }
+  return RET_OK;
+}
+
 int Convolution1x1Run(void *cdata, int task_id) {
   auto conv1x1 = reinterpret_cast<Convolution1x1CPUKernel *>(cdata);
   auto error_code = conv1x1->DoConv1x1(task_id);
@@ -223,9 +310,58 @@ int Convolution1x1RunHw(void *cdata, int task_id) {
   return RET_OK;
 }
 
+int Convolution1x1CPUKernel::DropSparseWeight() {
+  if (sparse_weight_ == nullptr) {
+    return RET_OK;
+  }
+  // trained weights lose the sparsity they were packed with, go back to the dense kernel
+  auto ret = InitDenseWeight();
+  if (ret != RET_OK) {
+    return ret;
+  }
+  free(sparse_weight_);
+  sparse_weight_ = nullptr;
+  sparse24_ = false;
+  FreeTmpBuffer();
+  return InitConv1x1Param();
+}
+
 int Convolution1x1CPUKernel::Run() {
   auto src_in = reinterpret_cast<float *>(in_tensors_[0]->MutableData());
   auto src_out = reinterpret_cast<float *>(out_tensors_[0]->MutableData());
+  if (IsTrain() && is_trainable() && DropSparseWeight() != RET_OK) {
+    return RET_ERROR;
+  }
+  if (sparse_weight_ != nullptr) {
+    if (sparse24_) {
+      size_t size = UP_ROUND(matmul_param_->row_, C4NUM) * matmul_param_->deep_ * sizeof(float);
+      pack_input_ = reinterpret_cast<float *>(ctx_->allocator->Malloc(size));
+      if (pack_input_ == nullptr) {
+        MS_LOG(ERROR) << "Conv1x1 Malloc pack_input_ error!";
+        return RET_MEMORY_FAILED;
+      }
+    }
+    int ret = RET_OK;
+    for (int batch_index = 0; batch_index < conv_param_->input_batch_ && ret == RET_OK; batch_index++) {
+      output_ptr_ = src_out + batch_index * matmul_param_->row_ * matmul_param_->col_;
+      auto tmp_in = src_in + batch_index * conv_param_->input_h_ * conv_param_->input_w_ * conv_param_->input_channel_;
+      if (pre_trans_input_) {
+        Conv1x1InputPack(tmp_in, input_ptr_, conv_param_, sizeof(float));
+      } else {
+        input_ptr_ = tmp_in;
+      }
+      if (sparse24_) {
+        RowMajor2Col4Major(input_ptr_, pack_input_, matmul_param_->row_, matmul_param_->deep_);
+      }
+      ret = ParallelLaunch(static_cast<const lite::InnerContext *>(this->context_)->thread_pool_,
+                           Convolution1x1SparseRun, this, thread_count_);
+    }
+    if (pack_input_ != nullptr) {
+      ctx_->allocator->Free(pack_input_);
+      pack_input_ = nullptr;
+    }
+    return ret;
+  }
   int pack_input_size = multi_thread_by_hw_ ? (thread_count_ * row_tile_ * matmul_param_->deep_)
                                             : (matmul_param_->row_align_ * matmul_param_->deep_);
   pack_input_ = reinterpret_cast<float *>(ctx_->allocator->Malloc(pack_input_size * sizeof(float)));
@@ -286,6 +422,9 @@ void Convolution1x1CPUKernel::PackWeight() {
 int Convolution1x1CPUKernel::Eval() {
   LiteKernel::Eval();
   if (is_trainable()) {
+    if (DropSparseWeight() != RET_OK) {
+      return RET_ERROR;
+    }
     PackWeight();
   }
   return RET_OK;
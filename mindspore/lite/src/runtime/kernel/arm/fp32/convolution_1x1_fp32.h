@@ -28,6 +28,7 @@
 #include "nnacl/fp32/common_func_fp32.h"
 #include "nnacl/matmul_parameter.h"
 #include "nnacl/fp32/matmul_fp32.h"
+#include "nnacl/fp32/sparse_matmul_fp32.h"
 
 namespace mindspore::kernel {
 class Convolution1x1CPUKernel : public ConvolutionBaseCPUKernel {
@@ -47,6 +48,7 @@ class Convolution1x1CPUKernel : public ConvolutionBaseCPUKernel {
  public:
   int DoConv1x1(int task_id);
   int DoConv1x1Hw(int task_id);
+  int DoSparseConv1x1(int task_id);
 
  private:
   int InitConv1x1Param();
@@ -55,6 +57,9 @@ class Convolution1x1CPUKernel : public ConvolutionBaseCPUKernel {
   void FreeTmpBuffer();
   void PackMatmulInput(const float *src_ptr, float *dst_ptr, int row, int col);
   void PackWeight();
+  int InitSparseWeight(int input_channel, int output_channel);
+  int InitDenseWeight();
+  int DropSparseWeight();
 
  private:
   MatMulParameter *matmul_param_ = nullptr;
@@ -65,6 +70,8 @@ class Convolution1x1CPUKernel : public ConvolutionBaseCPUKernel {
   float *origin_weight_;  // do not free
   float *origin_bias_;    // do not free
   float *weight_ptr_ = nullptr;
+  void *sparse_weight_ = nullptr;  // block sparse weight, the dense weight_ptr_ is not packed when it is set
+  bool sparse24_ = false;          // sparse_weight_ holds a 2:4 weight, the input is packed in 4 row tiles for it
   float *pack_input_ = nullptr;
   float *input_ptr_ = nullptr;
   float *output_ptr_ = nullptr;
@@ -15,6 +15,7 @@
  */
 
 #include "src/runtime/kernel/arm/fp32/convolution_fp32.h"
+#include <string>
 #include "include/errorcode.h"
 #include "nnacl/common_func.h"
 #include "schema/model_generated.h"
@@ -46,19 +47,31 @@ int ConvolutionCPUKernel::InitWeightBias() {
   size_t oc_block_num = UP_ROUND(out_channel, OC_BLOCK);
   size_t pack_weight_size = oc_block_num * in_channel * kernel_plane;
 
-  packed_weight_ = reinterpret_cast<float *>(malloc(pack_weight_size * sizeof(float)));
-  if (packed_weight_ == nullptr) {
-    MS_LOG(ERROR) << "malloc packed weight failed.";
-    return RET_ERROR;
-  }
-  memset(packed_weight_, 0, pack_weight_size * sizeof(float));
+  // sessions of the same model share one packed copy of the constant weight
+  auto origin_weight = origin_weight_;
+  auto pack = [origin_weight, out_channel, in_channel, kernel_plane, pack_weight_size](void *dst) {
+    auto packed_weight = reinterpret_cast<float *>(dst);
+    memset(packed_weight, 0, pack_weight_size * sizeof(float));
 #ifdef ENABLE_AVX
-  RowMajor2Col16Major(origin_weight_, packed_weight_, out_channel, in_channel * kernel_plane);
+    RowMajor2Col16Major(origin_weight, packed_weight, out_channel, in_channel * kernel_plane);
 #elif ENABLE_ARM32
-  RowMajor2Col4Major(origin_weight_, packed_weight_, out_channel, in_channel * kernel_plane);
+    RowMajor2Col4Major(origin_weight, packed_weight, out_channel, in_channel * kernel_plane);
 #else
-  RowMajor2Col8Major(origin_weight_, packed_weight_, out_channel, in_channel * kernel_plane);
+    RowMajor2Col8Major(origin_weight, packed_weight, out_channel, in_channel * kernel_plane);
 #endif
+  };
+  std::string layout = "conv_fp32_col" + std::to_string(OC_BLOCK) + "_" + std::to_string(out_channel) + "x" +
+                       std::to_string(in_channel * kernel_plane);
+  auto cache = lite::PackedWeightCache::GetInstance();
+  auto digest = cache->Digest(origin_weight_, out_channel * in_channel * kernel_plane * sizeof(float),
+                              kNumberTypeFloat32, filter_tensor->shape());
+  packed_weight_ =
+    reinterpret_cast<float *>(cache->GetOrPack(layout, digest, pack_weight_size * sizeof(float), pack));
+  if (packed_weight_ == nullptr) {
+    MS_LOG(ERROR) << "malloc packed weight failed.";
+    return RET_ERROR;
+  }
+  weight_cached_ = true;
 
   bias_data_ = reinterpret_cast<float *>(malloc(oc_block_num * sizeof(float)));
   if (bias_data_ == nullptr) {
@@ -170,6 +183,17 @@ void ConvolutionCPUKernel::PackWeight() {
   size_t pack_weight_size = oc_block_num * in_channel * kernel_plane;
 
   auto origin_weight = reinterpret_cast<float *>(filter_tensor->data_c());
+  if (weight_cached_) {
+    // the weight is trained from now on, leave the shared packed copy to the other sessions
+    auto private_weight = reinterpret_cast<float *>(malloc(pack_weight_size * sizeof(float)));
+    if (private_weight == nullptr) {
+      MS_LOG(ERROR) << "malloc packed weight failed.";
+      return;
+    }
+    lite::PackedWeightCache::GetInstance()->Release(packed_weight_);
+    packed_weight_ = private_weight;
+    weight_cached_ = false;
+  }
   memset(packed_weight_, 0, pack_weight_size * sizeof(float));
 #ifdef ENABLE_AVX
   RowMajor2Col16Major(origin_weight, packed_weight_, out_channel, in_channel * kernel_plane);
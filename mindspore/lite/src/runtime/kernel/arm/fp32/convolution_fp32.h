@@ -21,6 +21,7 @@
 #include "src/lite_kernel.h"
 #include "nnacl/op_base.h"
 #include "src/runtime/kernel/arm/base/convolution_base.h"
+#include "src/runtime/packed_weight_cache.h"
 
 namespace mindspore::kernel {
 class ConvolutionCPUKernel : public ConvolutionBaseCPUKernel {
@@ -33,7 +34,11 @@ class ConvolutionCPUKernel : public ConvolutionBaseCPUKernel {
         origin_bias_(origin_bias) {}
   ~ConvolutionCPUKernel() override {
     if (packed_weight_ != nullptr) {
-      free(packed_weight_);
+      if (weight_cached_) {
+        lite::PackedWeightCache::GetInstance()->Release(packed_weight_);
+      } else {
+        free(packed_weight_);
+      }
       packed_weight_ = nullptr;
     }
   }
@@ -66,6 +71,7 @@ class ConvolutionCPUKernel : public ConvolutionBaseCPUKernel {
   float *packed_weight_ = nullptr;
   float *packed_input_ = nullptr;
   float *col_major_input_ = nullptr;
+  bool weight_cached_ = false;  // packed_weight_ is owned by PackedWeightCache
 };
 }  // namespace mindspore::kernel
 
@@ -15,9 +15,17 @@
  */
 
 #include "src/runtime/kernel/arm/fp32/matmul_fp32_base.h"
+#include <string>
 #include "nnacl/fp32/matmul_fp32.h"
+#include "nnacl/fp32/sparse_matmul_fp32.h"
+#include "src/runtime/packed_weight_cache.h"
 
 namespace mindspore::kernel {
+namespace {
+// ratio of zero blocks from which the block sparse kernel beats the dense packed one
+constexpr float kSparseMatmulThreshold = 0.7f;
+}  // namespace
+
 int MatmulBaseFloatRun(void *cdata, int task_id) {
   auto op = reinterpret_cast<MatmulFp32BaseCPUKernel *>(cdata);
   auto error_code = op->FloatRun(task_id);
@@ -32,6 +40,14 @@ MatmulFp32BaseCPUKernel::~MatmulFp32BaseCPUKernel() {
   FreeResizeBufA();
   FreeResizeBufB();
   FreeBiasBuf();
+  if (sparse_b_ != nullptr) {
+    lite::PackedWeightCache::GetInstance()->Release(sparse_b_);
+    sparse_b_ = nullptr;
+  }
+  if (sparse24_b_ != nullptr) {
+    lite::PackedWeightCache::GetInstance()->Release(sparse24_b_);
+    sparse24_b_ = nullptr;
+  }
   return;
 }
 
@@ -78,6 +94,12 @@ int MatmulFp32BaseCPUKernel::InitBufferA() {
 }
 
 int MatmulFp32BaseCPUKernel::InitBufferB() {
+  if (b_pack_cached_) {
+    // b is repacked in place from now on, leave the shared packed copy to the other sessions
+    lite::PackedWeightCache::GetInstance()->Release(b_pack_ptr_);
+    b_pack_ptr_ = nullptr;
+    b_pack_cached_ = false;
+  }
   if (b_pack_ptr_ != nullptr) {
     return RET_OK;
   }
@@ -172,14 +194,71 @@ int MatmulFp32BaseCPUKernel::InitMatrixA(const float *src_ptr) {
   return RET_OK;
 }
 
-int MatmulFp32BaseCPUKernel::InitMatrixB(const float *src_ptr) {
+int MatmulFp32BaseCPUKernel::InitMatrixB(const float *src_ptr) { return PackMatrixB(src_ptr, b_pack_ptr_); }
+
+int MatmulFp32BaseCPUKernel::InitConstMatrixB() {
+  std::string layout = "matmul_fp32_" + std::to_string(vec_matmul_) + std::to_string(params_->b_transpose_) + "_col" +
+                       std::to_string(col_tile_) + "_" + std::to_string(params_->batch) + "x" +
+                       std::to_string(params_->deep_) + "x" + std::to_string(params_->col_);
+  auto src_b = src_b_;
+  auto pack = [this, src_b](void *dst) { PackMatrixB(src_b, reinterpret_cast<float *>(dst)); };
+  b_pack_ptr_ = reinterpret_cast<float *>(lite::PackedWeightCache::GetInstance()->GetOrPack(
+    layout, b_digest_, params_->batch * params_->col_align_ * params_->deep_ * sizeof(float), pack));
+  if (b_pack_ptr_ == nullptr) {
+    MS_LOG(ERROR) << "pack const matrix b failed";
+    return RET_ERROR;
+  }
+  b_pack_cached_ = true;
+  return RET_OK;
+}
+
+int MatmulFp32BaseCPUKernel::InitSparseMatrixB() {
+  if (sparse_b_ != nullptr || sparse24_b_ != nullptr || params_->batch != 1 || !params_->b_transpose_ ||
+      params_->a_transpose_ || is_trainable()) {
+    return RET_OK;
+  }
+  auto src_b = src_b_;
+  int col = params_->col_;
+  int deep = params_->deep_;
+  int block_num = BlockSparseNonzeroNum(src_b_, params_->col_, params_->deep_);
+  int total_block = UP_DIV(params_->col_, SPARSE_BLOCK) * params_->deep_;
+  float sparsity = 1.0f - static_cast<float>(block_num) / MSMAX(total_block, 1);
+  if (sparsity < kSparseMatmulThreshold) {
+    // 2:4 pruned weights scatter their zeros, so few whole blocks are zero
+    if (!IsSparse24(src_b_, col, deep)) {
+      return RET_OK;
+    }
+    std::string layout = "sparse24_matmul_fp32_" + std::to_string(deep) + "x" + std::to_string(col);
+    auto pack = [src_b, col, deep](void *dst) { PackSparse24(src_b, dst, col, deep); };
+    sparse24_b_ =
+      lite::PackedWeightCache::GetInstance()->GetOrPack(layout, b_digest_, Sparse24PackSize(col, deep), pack);
+    if (sparse24_b_ == nullptr) {
+      MS_LOG(ERROR) << "pack 2:4 sparse matrix b failed";
+      return RET_ERROR;
+    }
+    MS_LOG(INFO) << name_ << " runs 2:4 sparse matmul";
+    return RET_OK;
+  }
+  std::string layout = "sparse_matmul_fp32_" + std::to_string(params_->deep_) + "x" + std::to_string(params_->col_);
+  auto pack = [src_b, col, deep](void *dst) { PackBlockSparse(src_b, dst, col, deep); };
+  sparse_b_ =
+    lite::PackedWeightCache::GetInstance()->GetOrPack(layout, b_digest_, BlockSparsePackSize(col, block_num), pack);
+  if (sparse_b_ == nullptr) {
+    MS_LOG(ERROR) << "pack block sparse matrix b failed";
+    return RET_ERROR;
+  }
+  MS_LOG(INFO) << name_ << " runs block sparse matmul, sparsity: " << sparsity;
+  return RET_OK;
+}
+
+int MatmulFp32BaseCPUKernel::PackMatrixB(const float *src_ptr, float *dst_ptr) {
   if (vec_matmul_) {
     if (params_->b_transpose_) {
-      memcpy(b_pack_ptr_, src_ptr, params_->batch * params_->col_ * params_->deep_ * sizeof(float));
+      memcpy(dst_ptr, src_ptr, params_->batch * params_->col_ * params_->deep_ * sizeof(float));
     } else {
       for (int i = 0; i < params_->batch; i++) {
         const float *src = src_ptr + i * params_->deep_ * params_->col_;
-        float *dst = b_pack_ptr_ + i * params_->deep_ * params_->col_;
+        float *dst = dst_ptr + i * params_->deep_ * params_->col_;
         RowMajor2ColMajor(src, dst, params_->deep_, params_->col_);
       }
     }
@@ -188,7 +267,7 @@ int MatmulFp32BaseCPUKernel::InitMatrixB(const float *src_ptr) {
 
   for (int i = 0; i < params_->batch; i++) {
     const float *src = src_ptr + i * params_->deep_ * params_->col_;
-    float *dst = b_pack_ptr_ + i * params_->deep_ * params_->col_align_;
+    float *dst = dst_ptr + i * params_->deep_ * params_->col_align_;
 #ifdef ENABLE_AVX
     if (params_->b_transpose_) {
       RowMajor2Col16Major(src, dst, params_->col_, params_->deep_);
@@ -230,13 +309,28 @@ void MatmulFp32BaseCPUKernel::FreeResizeBufA() {
 
 void MatmulFp32BaseCPUKernel::FreeResizeBufB() {
   if (b_pack_ptr_ != nullptr) {
-    context_->allocator->Free(b_pack_ptr_);
+    if (b_pack_cached_) {
+      lite::PackedWeightCache::GetInstance()->Release(b_pack_ptr_);
+      b_pack_cached_ = false;
+    } else {
+      context_->allocator->Free(b_pack_ptr_);
+    }
     b_pack_ptr_ = nullptr;
   }
   return;
 }
 
 int MatmulFp32BaseCPUKernel::FloatRun(int task_id) {
+  if (sparse24_b_ != nullptr) {
+    Sparse24MatMulFp32(batch_a_ptr_, sparse24_b_, batch_c_ptr_, bias_ptr_, params_->act_type_, params_->deep_,
+                       params_->row_, params_->col_, task_id * thread_stride_, (task_id + 1) * thread_stride_);
+    return RET_OK;
+  }
+  if (sparse_b_ != nullptr) {
+    SparseMatMulFp32(batch_a_ptr_, sparse_b_, batch_c_ptr_, bias_ptr_, params_->act_type_, params_->deep_,
+                     params_->row_, params_->col_, task_id * thread_stride_, (task_id + 1) * thread_stride_);
+    return RET_OK;
+  }
   int current_stride_oc = thread_stride_ * col_tile_;
   int current_rest_oc = params_->col_ - task_id * thread_stride_ * col_tile_;
   int cur_oc = MSMIN(current_stride_oc, current_rest_oc);
@@ -282,6 +376,10 @@ int MatmulFp32BaseCPUKernel::Init() {
       return RET_ERROR;
     }
     memcpy(src_b_, b_tensor->data_c(), params_->batch * params_->col_ * params_->deep_ * sizeof(float));
+    // the digest of the model data is computed once for every session of the model
+    b_digest_ = lite::PackedWeightCache::GetInstance()->Digest(
+      b_tensor->data_c(), params_->batch * params_->col_ * params_->deep_ * sizeof(float), kNumberTypeFloat32,
+      b_tensor->shape());
   }
   return RET_OK;
 }
@@ -290,24 +388,68 @@ int MatmulFp32BaseCPUKernel::ReSize() {
   ResizeParameter();
 
   if (params_->b_const_ == true && src_b_ != nullptr) {
-    if (RET_OK != InitBufferB()) {
+    if (RET_OK != InitSparseMatrixB()) {
+      return RET_ERROR;
+    }
+    if (sparse_b_ == nullptr && sparse24_b_ == nullptr && RET_OK != InitConstMatrixB()) {
       return RET_ERROR;
     }
-    InitMatrixB(src_b_);
     free(src_b_);
     src_b_ = nullptr;
   }
 
+  if (sparse_b_ != nullptr) {
+    thread_count_ = MSMIN(op_parameter_->thread_num_, UP_DIV(params_->col_, SPARSE_BLOCK));
+    thread_stride_ = UP_DIV(UP_DIV(params_->col_, SPARSE_BLOCK), thread_count_);
+    return RET_OK;
+  }
+  if (sparse24_b_ != nullptr) {
+    thread_count_ = MSMIN(op_parameter_->thread_num_, params_->col_);
+    thread_stride_ = UP_DIV(params_->col_, thread_count_);
+    return RET_OK;
+  }
   thread_count_ = MSMIN(op_parameter_->thread_num_, UP_DIV(params_->col_align_, col_tile_));
   thread_stride_ = UP_DIV(UP_DIV(params_->col_align_, col_tile_), thread_count_);
   return RET_OK;
 }
 
+int MatmulFp32BaseCPUKernel::RunSparse24(float *a_ptr, float *c_ptr) {
+  size_t size = UP_ROUND(params_->row_, C4NUM) * params_->deep_ * sizeof(float);
+  batch_a_ptr_ = reinterpret_cast<float *>(context_->allocator->Malloc(size));
+  if (batch_a_ptr_ == nullptr) {
+    MS_LOG(ERROR) << "malloc packed a for 2:4 sparse matmul failed";
+    return RET_ERROR;
+  }
+  RowMajor2Col4Major(a_ptr, batch_a_ptr_, params_->row_, params_->deep_);
+  batch_c_ptr_ = c_ptr;
+  auto ret = ParallelLaunch(static_cast<const lite::InnerContext *>(this->context_)->thread_pool_, MatmulBaseFloatRun,
+                            this, thread_count_);
+  if (ret != RET_OK) {
+    MS_LOG(ERROR) << "MatmulBaseFloatRun failed";
+  }
+  context_->allocator->Free(batch_a_ptr_);
+  batch_a_ptr_ = nullptr;
+  return ret;
+}
+
 int MatmulFp32BaseCPUKernel::Run() {
   auto a_ptr = reinterpret_cast<float *>(in_tensors_.at(0)->data_c());
   auto b_ptr = reinterpret_cast<float *>(in_tensors_.at(1)->data_c());
   auto c_ptr = reinterpret_cast<float *>(out_tensors_.at(0)->data_c());
 
+  if (sparse_b_ != nullptr) {
+    batch_a_ptr_ = a_ptr;
+    batch_c_ptr_ = c_ptr;
+    auto ret = ParallelLaunch(static_cast<const lite::InnerContext *>(this->context_)->thread_pool_, MatmulBaseFloatRun,
+                              this, thread_count_);
+    if (ret != RET_OK) {
+      MS_LOG(ERROR) << "MatmulBaseFloatRun failed";
+    }
+    return ret;
+  }
+  if (sparse24_b_ != nullptr) {
+    return RunSparse24(a_ptr, c_ptr);
+  }
   if (params_->a_const_ == false) {
     if (RET_OK != InitBufferA()) {
       return RET_ERROR;
@@ -21,6 +21,7 @@
 #include "src/lite_kernel.h"
 #include "nnacl/matmul_parameter.h"
 #include "include/errorcode.h"
+#include "src/runtime/packed_weight_cache.h"
 
 using mindspore::lite::RET_ERROR;
 using mindspore::lite::RET_MEMORY_FAILED;
@@ -48,6 +49,13 @@ class MatmulFp32BaseCPUKernel : public LiteKernel {
   int InitBufferB();
   int InitMatrixA(const float *src_ptr);
   int InitMatrixB(const float *src_ptr);
+  int PackMatrixB(const float *src_ptr, float *dst_ptr);
+  // pack const b through PackedWeightCache, so sessions of the same model share it
+  int InitConstMatrixB();
+  // pick the block sparse kernel for a const b sparse enough, or the 2:4 one for a const b of that pattern, the packed
+  // b is shared through PackedWeightCache too
+  int InitSparseMatrixB();
+  int RunSparse24(float *a_ptr, float *c_ptr);
   void FreeBiasBuf();
   int InitBiasData();
   void InitParameter();
@@ -69,7 +77,11 @@ class MatmulFp32BaseCPUKernel : public LiteKernel {
   int thread_stride_ = 0;
   int thread_count_ = 0;
   bool vec_matmul_ = false;
+  bool b_pack_cached_ = false;  // b_pack_ptr_ is owned by PackedWeightCache
+  void *sparse_b_ = nullptr;    // block sparse b owned by PackedWeightCache, a is not packed when it is set
+  void *sparse24_b_ = nullptr;  // 2:4 sparse b owned by PackedWeightCache, a is packed in 4 row tiles when it is set
   float *src_b_ = nullptr;
+  lite::WeightDigest b_digest_;
   float *bias_ptr_ = nullptr;
   float *batch_a_ptr_ = nullptr;
   float *batch_b_ptr_ = nullptr;
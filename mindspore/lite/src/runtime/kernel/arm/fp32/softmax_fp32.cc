@@ -59,19 +59,54 @@ int SoftmaxCPUKernel::ReSize() {
   }
   in_plane_size_ = in_plane_size;
   out_plane_size_ = out_plane_size;
-  if (in_plane_size_ > 1) {
-    if (sum_data_ != nullptr) {
-      free(sum_data_);
-    }
-    sum_data_ = reinterpret_cast<float *>(malloc(out_plane_size * in_plane_size * sizeof(float)));
-    if (sum_data_ == nullptr) {
-      MS_LOG(ERROR) << "malloc data for softmax fail!";
-      return RET_ERROR;
-    }
+  return MallocSumData();
+}
+
+int SoftmaxCPUKernel::MallocSumData() {
+  if (in_plane_size_ <= 1) {
+    return RET_OK;
+  }
+  auto size = static_cast<size_t>(out_plane_size_) * in_plane_size_ * sizeof(float);
+  if (size <= sum_data_size_) {
+    return RET_OK;
   }
+  if (sum_data_ != nullptr) {
+    free(sum_data_);
+  }
+  sum_data_size_ = 0;
+  sum_data_ = reinterpret_cast<float *>(malloc(size));
+  if (sum_data_ == nullptr) {
+    MS_LOG(ERROR) << "malloc data for softmax fail!";
+    return RET_ERROR;
+  }
+  sum_data_size_ = size;
   return RET_OK;
 }
 
+std::shared_ptr<KernelShapeState> SoftmaxCPUKernel::SaveShapeState() {
+  auto state = std::make_shared<SoftmaxShapeState>();
+  state->param = *softmax_param_;
+  state->in_plane_size = in_plane_size_;
+  state->out_plane_size = out_plane_size_;
+  return state;
+}
+
+int SoftmaxCPUKernel::RestoreShapeState(const std::shared_ptr<KernelShapeState> &state) {
+  if (state == nullptr) {
+    return RET_ERROR;
+  }
+  // the sub graph only restores states saved by this kernel
+  auto softmax_state = std::static_pointer_cast<SoftmaxShapeState>(state);
+  // the op parameter header keeps the current thread number
+  softmax_param_->axis_ = softmax_state->param.axis_;
+  memcpy(softmax_param_->input_shape_, softmax_state->param.input_shape_, sizeof(softmax_param_->input_shape_));
+  softmax_param_->element_size_ = softmax_state->param.element_size_;
+  softmax_param_->n_dim_ = softmax_state->param.n_dim_;
+  in_plane_size_ = softmax_state->in_plane_size;
+  out_plane_size_ = softmax_state->out_plane_size;
+  return MallocSumData();
+}
+
 int SoftmaxCPUKernel::DoSoftmaxLastAxis(int task_id) {
   int unit = UP_DIV(out_plane_size_, context_->thread_num_);
   int begin = task_id * unit;
@@ -17,6 +17,7 @@
 #ifndef MINDSPORE_LITE_SRC_RUNTIME_KERNEL_ARM_FP32_SOFTMAX_H_
 #define MINDSPORE_LITE_SRC_RUNTIME_KERNEL_ARM_FP32_SOFTMAX_H_
 
+#include <memory>
 #include <vector>
 #include "src/lite_kernel.h"
 #include "src/runtime/kernel/arm/base/softmax_base.h"
@@ -37,9 +38,20 @@ class SoftmaxCPUKernel : public SoftmaxBaseCPUKernel {
   int ReSize() override;
   int Run() override;
   int DoSoftmaxLastAxis(int task_id);
+  std::shared_ptr<KernelShapeState> SaveShapeState() override;
+  int RestoreShapeState(const std::shared_ptr<KernelShapeState> &state) override;
 
  private:
+  struct SoftmaxShapeState : public KernelShapeState {
+    SoftmaxParameter param;
+    int in_plane_size = 0;
+    int out_plane_size = 0;
+  };
+  int MallocSumData();
+
+  // sum_data_ only grows, it fits every shape resized to before
   float *sum_data_ = nullptr;
+  size_t sum_data_size_ = 0;
   int in_plane_size_ = 0;
   int out_plane_size_ = 0;
 };
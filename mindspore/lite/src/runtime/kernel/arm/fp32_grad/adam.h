@@ -29,12 +29,7 @@ class AdamCPUKernel : public OptimizerKernel {
       : OptimizerKernel(parameter, inputs, outputs, ctx, 5, 9), thread_count_(ctx->thread_num_) {
     adam_param_ = reinterpret_cast<AdamParameter *>(parameter);
   }
-  ~AdamCPUKernel() override {
-    if (grad_sum_ != nullptr) {
-      context_->allocator->Free(grad_sum_);
-      grad_sum_ = nullptr;
-    }
-  }
+  ~AdamCPUKernel() override = default;
   int Init() override;
   int ReSize() override;
   int Run() override;
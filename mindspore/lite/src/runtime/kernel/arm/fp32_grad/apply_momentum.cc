@@ -107,7 +107,13 @@ int ApplyMomentumCPUKernel::OptimizerStep() {
   float moment = reinterpret_cast<float *>(in_tensors_.at(4)->MutableData())[0];
   size_t length = in_tensors_.at(0)->ElementsNum();
 
-  if (grad_sum_ != nullptr && valid_grad_sum_) {
+  if (grad_sum_in_place_ && valid_grad_sum_) {
+    // the accumulate tensor already holds accumulate * moment + sum of gradients
+    for (size_t i = 0; i < length; i++) {
+      weight[i] -= accumulate[i] * learning_rate;
+    }
+    OptimizerKernel::OptimizerStep();
+  } else if (grad_sum_ != nullptr && valid_grad_sum_) {
     size_t start = 0;
     size_t end = length;
     DoApplyMomentum(weight, accumulate, learning_rate, grad_sum_, moment, apply_momentum_param_->use_nesterov_, start,
@@ -118,6 +124,24 @@ int ApplyMomentumCPUKernel::OptimizerStep() {
   return RET_OK;
 }
 
+float *ApplyMomentumCPUKernel::InplaceGradSum() {
+  // nesterov reads the gradient again in the update, so the plain sum is kept apart
+  if (apply_momentum_param_->use_nesterov_) {
+    return nullptr;
+  }
+  return reinterpret_cast<float *>(in_tensors_.at(1)->MutableData());
+}
+
+void ApplyMomentumCPUKernel::GetGradSumFactors(float *decay, float *scale) {
+  if (!grad_sum_in_place_) {
+    OptimizerKernel::GetGradSumFactors(decay, scale);
+    return;
+  }
+  if (decay != nullptr) {
+    *decay = reinterpret_cast<float *>(in_tensors_.at(4)->MutableData())[0];
+  }
+}
+
 kernel::LiteKernel *CpuApplyMomentumFp32KernelCreator(const std::vector<lite::Tensor *> &inputs,
                                                       const std::vector<lite::Tensor *> &outputs,
                                                       OpParameter *opParameter, const lite::Context *ctx,
@@ -31,18 +31,17 @@ class ApplyMomentumCPUKernel : public OptimizerKernel {
         apply_momentum_param_(nullptr) {
     apply_momentum_param_ = reinterpret_cast<ApplyMomentumParameter *>(parameter);
   }
-  ~ApplyMomentumCPUKernel() override {
-    if (grad_sum_ != nullptr) {
-      context_->allocator->Free(grad_sum_);
-      grad_sum_ = nullptr;
-    }
-  }
+  ~ApplyMomentumCPUKernel() override = default;
   int Init() override;
   int ReSize() override;
   int Execute(int task_id);
   int Run() override;
   int OptimizerStep() override;
 
+ protected:
+  float *InplaceGradSum() override;
+  void GetGradSumFactors(float *decay, float *scale) override;
+
  private:
   int thread_count_;
   ApplyMomentumParameter *apply_momentum_param_;
@@ -66,7 +66,7 @@ int DoSgdInit(float *weight, float *accumulate, float *gradient, float *stat, fl
       weight[i] -= accumulate[i] * learning_rate;
     }
   }
-  *stat = 1.0f;
+  *stat = 0.0f;
   return RET_OK;
 }
 
@@ -185,15 +185,22 @@ int SgdCPUKernel::OptimizerStep() {
   float moment = reinterpret_cast<float *>(in_tensors_.at(4)->MutableData())[0];
   size_t length = in_tensors_.at(0)->ElementsNum();
 
-  if (grad_sum_ != nullptr && valid_grad_sum_) {
+  if (grad_sum_in_place_ && valid_grad_sum_) {
+    // the accumulate tensor already holds the momentum update of the summed gradients
+    for (size_t i = 0; i < length; ++i) {
+      weight[i] -= accumulate[i] * learning_rate;
+    }
+    *stat = 0.0f;
+    OptimizerKernel::OptimizerStep();
+  } else if (grad_sum_ != nullptr && valid_grad_sum_) {
     size_t start = 0;
     size_t end = length;
     if (*stat > 0) {
-      DoSgd(weight, accumulate, grad_sum_, learning_rate, sgd_param_->dampening_, moment, sgd_param_->use_nesterov_,
-            start, end);
-    } else {
       DoSgdInit(weight, accumulate, grad_sum_, stat, learning_rate, sgd_param_->dampening_, moment,
                 sgd_param_->use_nesterov_, start, end);
+    } else {
+      DoSgd(weight, accumulate, grad_sum_, learning_rate, sgd_param_->dampening_, moment, sgd_param_->use_nesterov_,
+            start, end);
     }
     std::fill(grad_sum_, grad_sum_ + length, 0);
     OptimizerKernel::OptimizerStep();
@@ -202,6 +209,28 @@ int SgdCPUKernel::OptimizerStep() {
   return RET_OK;
 }
 
+float *SgdCPUKernel::InplaceGradSum() {
+  // nesterov reads the gradient again in the update, so the plain sum is kept apart
+  if (sgd_param_->use_nesterov_) {
+    return nullptr;
+  }
+  return reinterpret_cast<float *>(in_tensors_.at(3)->MutableData());
+}
+
+void SgdCPUKernel::GetGradSumFactors(float *decay, float *scale) {
+  if (!grad_sum_in_place_) {
+    OptimizerKernel::GetGradSumFactors(decay, scale);
+    return;
+  }
+  // same as DoSgdInit on the first step and DoSgd afterwards, folded into the accumulate tensor
+  bool first_step = reinterpret_cast<float *>(in_tensors_.at(5)->MutableData())[0] > 0.0f;
+  float moment = reinterpret_cast<float *>(in_tensors_.at(4)->MutableData())[0];
+  if (decay != nullptr) {
+    *decay = (first_step || moment <= 0.0f) ? 0.0f : moment;
+  }
+  *scale = (first_step || moment <= 0.0f) ? 1.0f : 1.0f - sgd_param_->dampening_;
+}
+
 kernel::LiteKernel *CpuSgdFp32KernelCreator(const std::vector<lite::Tensor *> &inputs,
                                             const std::vector<lite::Tensor *> &outputs, OpParameter *opParameter,
                                             const lite::Context *ctx, const kernel::KernelKey &desc) {
@@ -29,12 +29,7 @@ class SgdCPUKernel : public OptimizerKernel {
       : OptimizerKernel(parameter, inputs, outputs, ctx, 2, 1), thread_count_(ctx->thread_num_), sgd_param_(nullptr) {
     sgd_param_ = reinterpret_cast<SgdParameter *>(parameter);
   }
-  ~SgdCPUKernel() override {
-    if (grad_sum_ != nullptr) {
-      context_->allocator->Free(grad_sum_);
-      grad_sum_ = nullptr;
-    }
-  }
+  ~SgdCPUKernel() override = default;
   int Init() override;
   int ReSize() override;
   int Run() override;
@@ -42,6 +37,10 @@ class SgdCPUKernel : public OptimizerKernel {
   int Execute(int task_id);
   int OptimizerStep() override;
 
+ protected:
+  float *InplaceGradSum() override;
+  void GetGradSumFactors(float *decay, float *scale) override;
+
  private:
   int thread_count_;
   SgdParameter *sgd_param_;
@@ -24,6 +24,11 @@ using mindspore::lite::RET_MEMORY_FAILED;
 using mindspore::lite::RET_OK;
 
 namespace mindspore::kernel {
+namespace {
+// ratio of zero blocks from which the block sparse kernel beats the dense packed one
+constexpr float kSparseConv1x1Threshold = 0.7f;
+}  // namespace
+
 Convolution1x1Int8CPUKernel::~Convolution1x1Int8CPUKernel() {
   if (matmul_param_ != nullptr) {
     delete matmul_param_;
@@ -33,6 +38,10 @@ Convolution1x1Int8CPUKernel::~Convolution1x1Int8CPUKernel() {
     free(packed_weight_);
     packed_weight_ = nullptr;
   }
+  if (sparse_weight_ != nullptr) {
+    free(sparse_weight_);
+    sparse_weight_ = nullptr;
+  }
   if (filter_peroc_ && filter_zp_ptr_ != nullptr) {
     free(filter_zp_ptr_);
     filter_zp_ptr_ = nullptr;
@@ -91,6 +100,16 @@ int Convolution1x1Int8OcOptPre(void *cdata, int task_id) {
   return RET_OK;
 }
 
+int Convolution1x1Int8SparseRun(void *cdata, int task_id) {
+  auto conv = reinterpret_cast<Convolution1x1Int8CPUKernel *>(cdata);
+  auto error_code = conv->SparseRun(task_id);
+  if (error_code != RET_OK) {
+    MS_LOG(ERROR) << "conv1x1 Int8 Run error task_id[" << task_id << "] error_code[" << error_code << "]";
+    return RET_ERROR;
+  }
+  return RET_OK;
+}
+
 int Convolution1x1Int8CPUKernel::OcRun(int task_id) {
   if (support_optimize_) {
     return RunArm64OptOc(task_id);
@@ -215,23 +234,26 @@ int Convolution1x1Int8CPUKernel::InitWeightBias() {
   auto output_channel = filter_tensor->Batch();
 
   /* weight */
-  size_t size = support_optimize_ ? UP_ROUND(input_channel, C4NUM) * UP_ROUND(output_channel, C16NUM) * sizeof(int8_t)
-                                  : UP_ROUND(input_channel, C16NUM) * UP_ROUND(output_channel, C4NUM) * sizeof(int8_t);
-  packed_weight_ = reinterpret_cast<int8_t *>(malloc(size));
-  if (packed_weight_ == nullptr) {
-    MS_LOG(ERROR) << "Conv1x1 int8 Malloc weight error!";
-    return RET_ERROR;
-  }
-  memset(packed_weight_, 0, size);
-  if (support_optimize_) {
-    RowMajor2Row4x16MajorInt8(reinterpret_cast<int8_t *>(filter_tensor->MutableData()), packed_weight_, output_channel,
-                              input_channel);
-  } else {
-    RowMajor2Row16x4MajorInt8(reinterpret_cast<int8_t *>(filter_tensor->MutableData()), packed_weight_, output_channel,
-                              input_channel);
+  if (sparse_weight_ == nullptr) {
+    size_t size = support_optimize_
+                    ? UP_ROUND(input_channel, C4NUM) * UP_ROUND(output_channel, C16NUM) * sizeof(int8_t)
+                    : UP_ROUND(input_channel, C16NUM) * UP_ROUND(output_channel, C4NUM) * sizeof(int8_t);
+    packed_weight_ = reinterpret_cast<int8_t *>(malloc(size));
+    if (packed_weight_ == nullptr) {
+      MS_LOG(ERROR) << "Conv1x1 int8 Malloc weight error!";
+      return RET_ERROR;
+    }
+    memset(packed_weight_, 0, size);
+    if (support_optimize_) {
+      RowMajor2Row4x16MajorInt8(reinterpret_cast<int8_t *>(filter_tensor->MutableData()), packed_weight_,
+                                output_channel, input_channel);
+    } else {
+      RowMajor2Row16x4MajorInt8(reinterpret_cast<int8_t *>(filter_tensor->MutableData()), packed_weight_,
+                                output_channel, input_channel);
+    }
   }
 
-  size = support_optimize_ ? UP_ROUND(output_channel, C16NUM) : UP_ROUND(output_channel, C4NUM);
+  size_t size = support_optimize_ ? UP_ROUND(output_channel, C16NUM) : UP_ROUND(output_channel, C4NUM);
   bias_data_ = malloc(size * sizeof(int32_t));
   if (bias_data_ == nullptr) {
     MS_LOG(ERROR) << "Conv1x1 int8 Malloc bias_ptr_ error!";
@@ -246,21 +268,48 @@ int Convolution1x1Int8CPUKernel::InitWeightBias() {
   return RET_OK;
 }
 
+int Convolution1x1Int8CPUKernel::InitSparseWeight() {
+  auto filter_tensor = in_tensors_.at(kWeightIndex);
+  auto input_channel = filter_tensor->Channel();
+  auto output_channel = filter_tensor->Batch();
+  auto weight = reinterpret_cast<int8_t *>(filter_tensor->data_c());
+  std::vector<int32_t> filter_zp(filter_peroc_ ? output_channel : 1);
+  for (size_t i = 0; i < filter_zp.size(); ++i) {
+    filter_zp[i] = conv_param_->conv_quant_arg_.filter_quant_args_[i].zp_;
+  }
+  int block_num = BlockSparseNonzeroNumInt8(weight, filter_zp.data(), filter_peroc_, output_channel, input_channel);
+  int total_block = UP_DIV(output_channel, SPARSE_BLOCK) * input_channel;
+  float sparsity = 1.0f - static_cast<float>(block_num) / MSMAX(total_block, 1);
+  if (sparsity < kSparseConv1x1Threshold) {
+    return RET_OK;
+  }
+  sparse_weight_ = malloc(BlockSparsePackSizeInt8(output_channel, block_num));
+  if (sparse_weight_ == nullptr) {
+    MS_LOG(ERROR) << "Conv1x1 int8 Malloc sparse_weight_ error!";
+    return RET_ERROR;
+  }
+  PackBlockSparseInt8(weight, filter_zp.data(), filter_peroc_, sparse_weight_, output_channel, input_channel);
+  MS_LOG(INFO) << name_ << " runs block sparse conv1x1, sparsity: " << sparsity;
+  return RET_OK;
+}
+
 int Convolution1x1Int8CPUKernel::InitWeightBiasArm32() {
   auto filter_tensor = in_tensors_.at(kWeightIndex);
   auto input_channel = filter_tensor->Channel();
   auto output_channel = filter_tensor->Batch();
 
   /* weight */
-  size_t size = UP_ROUND(input_channel, C16NUM) * UP_ROUND(output_channel, C2NUM) * sizeof(int8_t);
-  packed_weight_ = reinterpret_cast<int8_t *>(malloc(size));
-  if (packed_weight_ == nullptr) {
-    MS_LOG(ERROR) << "Conv1x1 int8 arm32 Malloc weight error!";
-    return RET_ERROR;
+  if (sparse_weight_ == nullptr) {
+    size_t size = UP_ROUND(input_channel, C16NUM) * UP_ROUND(output_channel, C2NUM) * sizeof(int8_t);
+    packed_weight_ = reinterpret_cast<int8_t *>(malloc(size));
+    if (packed_weight_ == nullptr) {
+      MS_LOG(ERROR) << "Conv1x1 int8 arm32 Malloc weight error!";
+      return RET_ERROR;
+    }
+    memset(packed_weight_, 0, size);
+    RowMajor2Row2x16MajorInt8(reinterpret_cast<int8_t *>(filter_tensor->MutableData()), packed_weight_,
+                              output_channel, input_channel);
   }
-  memset(packed_weight_, 0, size);
-  RowMajor2Row2x16MajorInt8(reinterpret_cast<int8_t *>(filter_tensor->MutableData()), packed_weight_, output_channel,
-                            input_channel);
 
   /* bias */
   int col2 = UP_ROUND(output_channel, C2NUM);
@@ -295,6 +344,12 @@ int Convolution1x1Int8CPUKernel::Init() {
 
   CheckSupportOptimize();
 
+  ret = InitSparseWeight();
+  if (ret != RET_OK) {
+    MS_LOG(ERROR) << "Init sparse weight failed.";
+    return ret;
+  }
+
 #ifdef ENABLE_ARM32
   ret = InitWeightBiasArm32();
 #else
@@ -357,6 +412,11 @@ int Convolution1x1Int8CPUKernel::InitParam() {
   thread_count_oc_ = MSMIN(op_parameter_->thread_num_, oc_thread_count);
   thread_stride_oc_ = UP_DIV(oc_thread_count, thread_count_oc_);
   parallel_by_oc_ = oc_thread_count > op_parameter_->thread_num_;
+  if (sparse_weight_ != nullptr) {
+    /* the sparse kernel runs by column blocks */
+    thread_count_oc_ = MSMIN(op_parameter_->thread_num_, UP_DIV(matmul_param_->col_, SPARSE_BLOCK));
+    thread_stride_oc_ = UP_DIV(UP_DIV(matmul_param_->col_, SPARSE_BLOCK), thread_count_oc_);
+  }
 
   return RET_OK;
 }
@@ -507,7 +567,43 @@ int Convolution1x1Int8CPUKernel::OcOptPre(int task_id) {
   return RET_OK;
 }
 
+int Convolution1x1Int8CPUKernel::SparseRun(int task_id) {
+  SparseMatMulInt8(input_ptr_, sparse_weight_, output_ptr_, reinterpret_cast<int32_t *>(bias_data_),
+                   &sparse_quant_param_, filter_peroc_, matmul_param_->deep_, matmul_param_->row_, matmul_param_->col_,
+                   task_id * thread_stride_oc_, (task_id + 1) * thread_stride_oc_);
+  return RET_OK;
+}
+
+int Convolution1x1Int8CPUKernel::RunSparse() {
+  /* bias_data_ already holds -input_zp * sum(w - filter_zp), so the input is taken as is */
+  sparse_quant_param_.input_.zp_ = 0;
+  sparse_quant_param_.output_.zp_ = conv_param_->conv_quant_arg_.output_quant_args_[0].zp_;
+  sparse_quant_param_.out_act_min_ = conv_param_->conv_quant_arg_.out_act_min_[0];
+  sparse_quant_param_.out_act_max_ = conv_param_->conv_quant_arg_.out_act_max_[0];
+  sparse_quant_param_.left_shift_ = left_shift_;
+  sparse_quant_param_.right_shift_ = right_shift_;
+  sparse_quant_param_.quant_multiplier_ = multiplier_;
+
+  int8_t *src_in = reinterpret_cast<int8_t *>(in_tensors_[0]->data_c());
+  int8_t *src_out = reinterpret_cast<int8_t *>(out_tensors_[0]->data_c());
+  for (int batch_index = 0; batch_index < conv_param_->input_batch_; batch_index++) {
+    Pre1x1Trans(src_in + batch_index * conv_param_->input_h_ * conv_param_->input_w_ * conv_param_->input_channel_,
+                src_out + batch_index * matmul_param_->row_ * matmul_param_->col_);
+    int error_code = ParallelLaunch(static_cast<const lite::InnerContext *>(this->context_)->thread_pool_,
+                                    Convolution1x1Int8SparseRun, this, thread_count_oc_);
+    if (error_code != RET_OK) {
+      MS_LOG(ERROR) << "ParallelLaunch run error error_code[" << error_code << "]";
+      return error_code;
+    }
+  }
+  return RET_OK;
+}
+
 int Convolution1x1Int8CPUKernel::Run() {
+  if (sparse_weight_ != nullptr) {
+    return RunSparse();
+  }
+
   int error_code = InitRunBuf();
   if (error_code != RET_OK) {
     MS_LOG(ERROR) << "conv1x1 int8 InitRunBuf error_code[" << error_code << "]";
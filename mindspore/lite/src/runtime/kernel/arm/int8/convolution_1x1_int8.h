@@ -26,6 +26,7 @@
 #include "nnacl/base/conv1x1_base.h"
 #include "nnacl/int8/matmul_int8.h"
 #include "nnacl/matmul_parameter.h"
+#include "nnacl/int8/sparse_matmul_int8.h"
 #include "src/common/utils.h"
 
 namespace mindspore::kernel {
@@ -48,12 +49,14 @@ class Convolution1x1Int8CPUKernel : public ConvolutionBaseCPUKernel {
   int OcRun(int task_id);
   int HwRun(int task_id);
   int OcOptPre(int task_id);
+  int SparseRun(int task_id);
 
  private:
   int RunArmOc(int task_id);
   int RunArm64OptOc(int task_id);
   int RunArmHw(int task_id);
   int RunArm64OptHw(int task_id);
+  int RunSparse();
 
  private:
   void FreeResizeBuf();
@@ -63,6 +66,8 @@ class Convolution1x1Int8CPUKernel : public ConvolutionBaseCPUKernel {
   void Pre1x1Trans(int8_t *src_input, int8_t *src_output);
   void CheckSupportOptimize();
   int InitBiasByzp(const void *src_weight, int input_channel, int output_channel, int round_oc);
+  // pick the block sparse kernel for a weight sparse enough, the dense packed_weight_ is not packed when it is set
+  int InitSparseWeight();
 
  private:
   int32_t *input_sum_ = nullptr;     /* per-oc */
@@ -71,6 +76,8 @@ class Convolution1x1Int8CPUKernel : public ConvolutionBaseCPUKernel {
   int32_t *right_shift_ = nullptr;   /* per-oc up round  */
   int32_t *multiplier_ = nullptr;    /* per-oc up round  */
   int8_t *packed_weight_ = nullptr;
+  void *sparse_weight_ = nullptr;
+  MatmulQuantParameter sparse_quant_param_ = {};
   int8_t *packed_input_ = nullptr;
   int8_t *input_ptr_ = nullptr;
   int8_t *output_ptr_ = nullptr;
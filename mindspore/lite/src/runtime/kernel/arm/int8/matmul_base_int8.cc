@@ -16,12 +16,18 @@
 
 #include "src/runtime/kernel/arm/int8/matmul_base_int8.h"
 #include "src/runtime/runtime_api.h"
+#include "nnacl/int8/sparse_matmul_int8.h"
 
 using mindspore::lite::RET_ERROR;
 using mindspore::lite::RET_MEMORY_FAILED;
 using mindspore::lite::RET_OK;
 
 namespace mindspore::kernel {
+namespace {
+// ratio of zero blocks from which the block sparse kernel beats the dense packed one
+constexpr float kSparseMatmulThreshold = 0.7f;
+}  // namespace
+
 int MatmulBaseInt8Run(void *cdata, int task_id) {
   auto op = reinterpret_cast<MatmulBaseInt8CPUKernel *>(cdata);
   auto ret = op->RunImpl(task_id);
@@ -33,6 +39,12 @@ int MatmulBaseInt8Run(void *cdata, int task_id) {
 }
 
 int MatmulBaseInt8CPUKernel::RunImpl(int task_id) {
+  if (sparse_b_ != nullptr) {
+    SparseMatMulInt8(batch_a_ptr_, sparse_b_, batch_c_ptr_, bias_ptr_, quant_param_, filter_per_channel_,
+                     param_->deep_, param_->row_, param_->col_, task_id * thread_stride_,
+                     (task_id + 1) * thread_stride_);
+    return RET_OK;
+  }
   int stride = thread_stride_ * col_tile_;
   int cur_stride = task_id * stride;
   int res_stride = param_->col_ - cur_stride;
@@ -64,6 +76,10 @@ MatmulBaseInt8CPUKernel::~MatmulBaseInt8CPUKernel() {
     free(bias_ptr_);
     bias_ptr_ = nullptr;
   }
+  if (sparse_b_ != nullptr) {
+    free(sparse_b_);
+    sparse_b_ = nullptr;
+  }
 }
 
 void MatmulBaseInt8CPUKernel::FreeQuantParam() {
@@ -230,6 +246,29 @@ void MatmulBaseInt8CPUKernel::TransferB() {
   return;
 }
 
+int MatmulBaseInt8CPUKernel::InitSparseMatrixB() {
+  if (sparse_b_ != nullptr || param_->batch != 1 || !param_->b_transpose_ || param_->a_transpose_) {
+    return RET_OK;
+  }
+  auto weight_data = reinterpret_cast<int8_t *>(in_tensors_.at(1)->data_c());
+  int block_num = BlockSparseNonzeroNumInt8(weight_data, quant_param_->filter_zp_, filter_per_channel_, param_->col_,
+                                            param_->deep_);
+  int total_block = UP_DIV(param_->col_, SPARSE_BLOCK) * param_->deep_;
+  float sparsity = 1.0f - static_cast<float>(block_num) / MSMAX(total_block, 1);
+  if (sparsity < kSparseMatmulThreshold) {
+    return RET_OK;
+  }
+  sparse_b_ = malloc(BlockSparsePackSizeInt8(param_->col_, block_num));
+  if (sparse_b_ == nullptr) {
+    MS_LOG(ERROR) << "Malloc sparse_b_ for Matmul int8 op failed!";
+    return RET_ERROR;
+  }
+  PackBlockSparseInt8(weight_data, quant_param_->filter_zp_, filter_per_channel_, sparse_b_, param_->col_,
+                      param_->deep_);
+  MS_LOG(INFO) << name_ << " runs block sparse matmul, sparsity: " << sparsity;
+  return RET_OK;
+}
+
 int MatmulBaseInt8CPUKernel::InitTmpBuffer() {
   pack_a_ptr_ = reinterpret_cast<int8_t *>(malloc(param_->row_align_ * param_->deep_16_ * sizeof(int8_t)));
   if (pack_a_ptr_ == nullptr) {
@@ -301,6 +340,17 @@ int MatmulBaseInt8CPUKernel::ReSize() {
 
   ResizeParameter();
 
+  if (param_->b_const_ == true) {
+    if (InitSparseMatrixB() != RET_OK) {
+      return RET_ERROR;
+    }
+  }
+  if (sparse_b_ != nullptr) {
+    thread_count_ = MSMIN(op_parameter_->thread_num_, UP_DIV(param_->col_, SPARSE_BLOCK));
+    thread_stride_ = UP_DIV(UP_DIV(param_->col_, SPARSE_BLOCK), thread_count_);
+    return RET_OK;
+  }
+
   auto ret = InitTmpBuffer();
   if (ret != RET_OK) {
     FreeQuantParam();
@@ -320,6 +370,16 @@ int MatmulBaseInt8CPUKernel::Run() {
 
   int8_t *a_ptr = reinterpret_cast<int8_t *>(in_tensors_.at(0)->data_c());
   int8_t *c_ptr = reinterpret_cast<int8_t *>(out_tensors_.at(0)->data_c());
+  if (sparse_b_ != nullptr) {
+    batch_a_ptr_ = a_ptr;
+    batch_c_ptr_ = c_ptr;
+    auto ret = ParallelLaunch(static_cast<const lite::InnerContext *>(this->context_)->thread_pool_, MatmulBaseInt8Run,
+                              this, thread_count_);
+    if (ret != RET_OK) {
+      MS_LOG(ERROR) << "MatmulInt8Run error: [" << ret << "]";
+    }
+    return ret;
+  }
   int32_t tmp_weight_zp = filter_per_channel_ ? 1 : quant_param_->filter_zp_[0];
   for (int i = 0; i < param_->batch; i++) {
     auto current_src_a = a_ptr + i * param_->row_ * param_->deep_;
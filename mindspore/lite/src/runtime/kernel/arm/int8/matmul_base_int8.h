@@ -55,6 +55,8 @@ class MatmulBaseInt8CPUKernel : public LiteKernel {
   void FreeTmpBuffer();
   void TransferA();
   void TransferB();
+  // pick the block sparse kernel for a const b sparse enough, a and b are not packed then
+  int InitSparseMatrixB();
 
  private:
   int MallocQuantParam();
@@ -72,6 +74,8 @@ class MatmulBaseInt8CPUKernel : public LiteKernel {
   int *weight_bias_sums_ = nullptr;
   int *bias_ptr_ = nullptr;
   bool filter_per_channel_ = true;
+  void *sparse_b_ = nullptr;
+  int8_t *batch_a_ptr_ = nullptr;
   int8_t *batch_b_ptr_ = nullptr;
   int8_t *batch_c_ptr_ = nullptr;
   int *batch_sums_ = nullptr;
@@ -0,0 +1,297 @@
+/**
+ * Copyright 2021 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "src/runtime/packed_weight_cache.h"
+#include <climits>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <cstdio>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+#include <sstream>
+#include "securec/include/securec.h"
+#include "src/common/log_adapter.h"
+#include "utils/system/sha256.h"
+
+namespace mindspore::lite {
+namespace {
+// hex digest of utils/system/sha256.h
+constexpr size_t kSha256HexSize = 64;
+constexpr size_t kPersistAlignment = 64;
+
+// header of a persisted packed weight, the packed data follows it
+constexpr char kPersistMagic[8] = {'M', 'S', 'L', 'P', 'W', '0', '0', '1'};
+constexpr int kPersistMaxDims = 8;
+struct PersistHeader {
+  char magic[8];
+  int32_t data_type;
+  int32_t shape_size;
+  int32_t shape[kPersistMaxDims];
+  uint64_t origin_size;
+  uint64_t packed_size;
+  char sha256[kSha256HexSize];
+};
+static_assert(sizeof(PersistHeader) % kPersistAlignment == 0, "packed data behind the header must stay aligned");
+
+std::string ShapeString(const std::vector<int> &shape) {
+  std::string str;
+  for (size_t i = 0; i < shape.size(); i++) {
+    str += (i == 0 ? "" : "x") + std::to_string(shape[i]);
+  }
+  return str;
+}
+}  // namespace
+
+PackedWeightCache *PackedWeightCache::GetInstance() {
+  static PackedWeightCache instance;
+  return &instance;
+}
+
+PackedWeightCache::PackedWeightCache() {
+  auto dir = std::getenv(kPackedWeightDirEnv);
+  if (dir != nullptr) {
+    persist_dir_ = dir;
+  }
+}
+
+PackedWeightCache::~PackedWeightCache() {
+  for (auto &iter : weights_) {
+    FreeWeight(iter.second);
+  }
+  weights_.clear();
+  data_index_.clear();
+}
+
+void PackedWeightCache::FreeWeight(PackedWeight *weight) {
+#ifndef _WIN32
+  if (weight->map_base != nullptr) {
+    munmap(weight->map_base, weight->map_size);
+    delete weight;
+    return;
+  }
+#endif
+  free(weight->data);
+  delete weight;
+}
+
+void PackedWeightCache::AddModelBuffer(const void *buf, size_t size) {
+  if (buf == nullptr || size == 0) {
+    return;
+  }
+  std::lock_guard<std::mutex> guard(lock_);
+  auto &model_buffer = model_buffers_[reinterpret_cast<const char *>(buf)];
+  model_buffer.size = size;
+  model_buffer.digests.clear();
+}
+
+void PackedWeightCache::RemoveModelBuffer(const void *buf) {
+  std::lock_guard<std::mutex> guard(lock_);
+  model_buffers_.erase(reinterpret_cast<const char *>(buf));
+}
+
+WeightDigest PackedWeightCache::Digest(const void *data, size_t size, TypeId data_type,
+                                       const std::vector<int> &shape) {
+  WeightDigest digest;
+  digest.data_type = data_type;
+  digest.shape = shape;
+  digest.size = size;
+  auto find_buffer = [this, data, size]() -> ModelBuffer * {
+    auto begin = reinterpret_cast<const char *>(data);
+    auto iter = model_buffers_.upper_bound(begin);
+    if (iter == model_buffers_.begin()) {
+      return nullptr;
+    }
+    --iter;
+    return begin + size <= iter->first + iter->second.size ? &iter->second : nullptr;
+  };
+  auto digest_key = std::make_pair(data, size);
+  {
+    std::lock_guard<std::mutex> guard(lock_);
+    auto model_buffer = find_buffer();
+    if (model_buffer != nullptr) {
+      auto iter = model_buffer->digests.find(digest_key);
+      if (iter != model_buffer->digests.end()) {
+        digest.sha256 = iter->second;
+        return digest;
+      }
+    }
+  }
+  digest.sha256 = system::sha256::GetHashFromString(std::string(reinterpret_cast<const char *>(data), size));
+  std::lock_guard<std::mutex> guard(lock_);
+  auto model_buffer = find_buffer();
+  if (model_buffer != nullptr) {
+    model_buffer->digests[digest_key] = digest.sha256;
+  }
+  return digest;
+}
+
+std::string PackedWeightCache::Key(const std::string &layout, const WeightDigest &origin, size_t packed_size) {
+  return layout + "_" + std::to_string(origin.data_type) + "_" + ShapeString(origin.shape) + "_" +
+         std::to_string(origin.size) + "_" + std::to_string(packed_size) + "_" + origin.sha256;
+}
+
+bool PackedWeightCache::LoadPersisted(PackedWeight *weight) {
+#ifndef _WIN32
+  if (persist_dir_.empty()) {
+    return false;
+  }
+  auto path = persist_dir_ + "/" + weight->key + ".bin";
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return false;
+  }
+  auto map_size = sizeof(PersistHeader) + weight->size;
+  struct stat file_stat {};
+  if (fstat(fd, &file_stat) != 0 || static_cast<size_t>(file_stat.st_size) != map_size) {
+    close(fd);
+    return false;
+  }
+  // private mapping: pages come from the page cache, accidental writes never reach the file
+  auto map_base = mmap(nullptr, map_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (map_base == MAP_FAILED) {
+    MS_LOG(WARNING) << "mmap packed weight failed: " << path;
+    return false;
+  }
+  // a file of another weight or an interrupted version of this one is packed again
+  auto header = reinterpret_cast<const PersistHeader *>(map_base);
+  const auto &origin = weight->origin;
+  bool valid = memcmp(header->magic, kPersistMagic, sizeof(kPersistMagic)) == 0 &&
+               header->data_type == static_cast<int32_t>(origin.data_type) &&
+               header->shape_size == static_cast<int32_t>(origin.shape.size()) &&
+               memcmp(header->shape, origin.shape.data(), origin.shape.size() * sizeof(int32_t)) == 0 &&
+               header->origin_size == origin.size && header->packed_size == weight->size &&
+               memcmp(header->sha256, origin.sha256.data(), kSha256HexSize) == 0;
+  if (!valid) {
+    MS_LOG(WARNING) << "packed weight " << path << " does not match its origin weight, it is packed again";
+    munmap(map_base, map_size);
+    return false;
+  }
+  weight->map_base = map_base;
+  weight->map_size = map_size;
+  weight->data = reinterpret_cast<char *>(map_base) + sizeof(PersistHeader);
+  return true;
+#else
+  return false;
+#endif
+}
+
+void PackedWeightCache::Persist(const PackedWeight &weight) {
+  const auto &origin = weight.origin;
+  if (persist_dir_.empty() || origin.shape.size() > kPersistMaxDims) {
+    return;
+  }
+  PersistHeader header{};
+  memcpy(header.magic, kPersistMagic, sizeof(kPersistMagic));
+  header.data_type = static_cast<int32_t>(origin.data_type);
+  header.shape_size = static_cast<int32_t>(origin.shape.size());
+  memcpy(header.shape, origin.shape.data(), origin.shape.size() * sizeof(int32_t));
+  header.origin_size = origin.size;
+  header.packed_size = weight.size;
+  memcpy(header.sha256, origin.sha256.data(), kSha256HexSize);
+
+  auto path = persist_dir_ + "/" + weight.key + ".bin";
+  auto tmp_path = path + ".tmp";
+  auto file = fopen(tmp_path.c_str(), "wb");
+  if (file == nullptr) {
+    MS_LOG(WARNING) << "open " << tmp_path << " failed, packed weight is not persisted";
+    return;
+  }
+  auto written = fwrite(&header, 1, sizeof(header), file);
+  written += fwrite(weight.data, 1, weight.size, file);
+  fclose(file);
+  if (written != sizeof(header) + weight.size || rename(tmp_path.c_str(), path.c_str()) != 0) {
+    MS_LOG(WARNING) << "write " << path << " failed, packed weight is not persisted";
+    (void)remove(tmp_path.c_str());
+  }
+}
+
+void *PackedWeightCache::GetOrPack(const std::string &layout, const WeightDigest &origin, size_t packed_size,
+                                   const std::function<void(void *dst)> &pack) {
+  if (origin.sha256.size() != kSha256HexSize || packed_size == 0 || pack == nullptr) {
+    MS_LOG(ERROR) << "invalid packed weight request, layout: " << layout;
+    return nullptr;
+  }
+  auto key = Key(layout, origin, packed_size);
+  {
+    std::lock_guard<std::mutex> guard(lock_);
+    auto iter = weights_.find(key);
+    if (iter != weights_.end()) {
+      iter->second->ref_count++;
+      return iter->second->data;
+    }
+  }
+  auto weight = new (std::nothrow) PackedWeight;
+  if (weight == nullptr) {
+    MS_LOG(ERROR) << "new PackedWeight failed";
+    return nullptr;
+  }
+  weight->key = key;
+  weight->origin = origin;
+  weight->size = packed_size;
+  weight->ref_count = 1;
+  // pack outside of the lock, concurrent sessions packing the same weight keep the first inserted copy
+  if (!LoadPersisted(weight)) {
+    weight->data = malloc(packed_size);
+    if (weight->data == nullptr) {
+      MS_LOG(ERROR) << "malloc packed weight failed, size: " << packed_size;
+      delete weight;
+      return nullptr;
+    }
+    pack(weight->data);
+    Persist(*weight);
+  }
+  std::lock_guard<std::mutex> guard(lock_);
+  auto iter = weights_.find(key);
+  if (iter != weights_.end()) {
+    FreeWeight(weight);
+    iter->second->ref_count++;
+    return iter->second->data;
+  }
+  weights_[key] = weight;
+  data_index_[weight->data] = weight;
+  return weight->data;
+}
+
+void PackedWeightCache::Release(void *packed) {
+  if (packed == nullptr) {
+    return;
+  }
+  std::lock_guard<std::mutex> guard(lock_);
+  auto iter = data_index_.find(packed);
+  if (iter == data_index_.end()) {
+    MS_LOG(ERROR) << "packed weight is not in cache";
+    return;
+  }
+  auto weight = iter->second;
+  if (--weight->ref_count > 0) {
+    return;
+  }
+  data_index_.erase(iter);
+  weights_.erase(weight->key);
+  FreeWeight(weight);
+}
+
+size_t PackedWeightCache::entry_num() {
+  std::lock_guard<std::mutex> guard(lock_);
+  return weights_.size();
+}
+}  // namespace mindspore::lite
@@ -0,0 +1,99 @@
+/**
+ * Copyright 2021 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MINDSPORE_LITE_SRC_RUNTIME_PACKED_WEIGHT_CACHE_H_
+#define MINDSPORE_LITE_SRC_RUNTIME_PACKED_WEIGHT_CACHE_H_
+
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "ir/dtype/type_id.h"
+
+namespace mindspore::lite {
+// environment variable naming a directory where packed weights are persisted and mapped from on later loads
+constexpr const char *kPackedWeightDirEnv = "MSLITE_PACKED_WEIGHT_DIR";
+
+// identity of an origin weight: its type, shape, byte size and the sha256 of its content
+struct WeightDigest {
+  TypeId data_type = kTypeUnknown;
+  std::vector<int> shape;
+  size_t size = 0;
+  std::string sha256;
+};
+
+// Process wide cache of prepacked constant weights. Entries are addressed by the packing layout and the digest of
+// the origin weight, so every session of the same model shares one packed copy. Entries are refcounted and freed
+// when the last kernel releases them. Cached data is read only for kernels, a kernel which repacks its weight at
+// runtime (e.g. in train mode) must take a private copy first.
+// Packing kernels free their origin weights after compiling, so a hit can not be checked by comparing the content
+// and the digest is a cryptographic one. Digests of weights inside a registered model buffer are computed once per
+// buffer instead of once per session.
+class PackedWeightCache {
+ public:
+  static PackedWeightCache *GetInstance();
+
+  WeightDigest Digest(const void *data, size_t size, TypeId data_type, const std::vector<int> &shape);
+
+  // return the packed weight for origin, calling pack(dst) to fill packed_size bytes on a miss
+  void *GetOrPack(const std::string &layout, const WeightDigest &origin, size_t packed_size,
+                  const std::function<void(void *dst)> &pack);
+
+  void Release(void *packed);
+
+  // digests of the weights in [buf, buf + size) are kept until the buffer is removed
+  void AddModelBuffer(const void *buf, size_t size);
+  void RemoveModelBuffer(const void *buf);
+
+  size_t entry_num();
+
+ private:
+  PackedWeightCache();
+  ~PackedWeightCache();
+
+  struct PackedWeight {
+    std::string key;
+    WeightDigest origin;
+    void *data = nullptr;
+    size_t size = 0;
+    int ref_count = 0;
+    // mapping of a persisted file, data is behind its header
+    void *map_base = nullptr;
+    size_t map_size = 0;
+  };
+  struct ModelBuffer {
+    size_t size = 0;
+    std::map<std::pair<const void *, size_t>, std::string> digests;
+  };
+
+  static std::string Key(const std::string &layout, const WeightDigest &origin, size_t packed_size);
+  // persisted files are named by the key of their weight
+  bool LoadPersisted(PackedWeight *weight);
+  void Persist(const PackedWeight &weight);
+  void FreeWeight(PackedWeight *weight);
+
+ private:
+  std::mutex lock_;
+  std::unordered_map<std::string, PackedWeight *> weights_;
+  std::unordered_map<void *, PackedWeight *> data_index_;
+  std::map<const char *, ModelBuffer> model_buffers_;
+  std::string persist_dir_;
+};
+}  // namespace mindspore::lite
+#endif  // MINDSPORE_LITE_SRC_RUNTIME_PACKED_WEIGHT_CACHE_H_
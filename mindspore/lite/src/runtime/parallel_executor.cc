@@ -14,99 +14,321 @@
  * limitations under the License.
  */
 
-#include <utility>
 #include "src/runtime/parallel_executor.h"
+#include <algorithm>
+#include <queue>
+#include <utility>
 #include "src/runtime/runtime_api.h"
-#include "src/lite_kernel_util.h"
+#include "src/inner_context.h"
+#include "src/common/tensor_util.h"
+#include "src/common/utils.h"
 
 namespace mindspore::lite {
-ParallelExecutor::~ParallelExecutor() { DestroyThreadPool(thread_pool_); }
+namespace {
+constexpr float kMinKernelCost = 1.0f;
+// the lanes must beat the serial run by this ratio to pay for their synchronization
+constexpr float kMinLaneGain = 0.9f;
+// the single threaded profiling run is the last task of a launch of two, the other task holds a worker
+constexpr int kProfileTaskNum = 2;
+
+bool IsControlFlowKernel(const kernel::LiteKernel *kernel) {
+  auto type = kernel->Type();
+  return type == schema::PrimitiveType_PartialFusion || type == schema::PrimitiveType_Switch ||
+         type == schema::PrimitiveType_Merge;
+}
+
+int RunLaneImpl(void *data, int index) {
+  auto *executor = reinterpret_cast<ParallelExecutor *>(data);
+  return executor->RunLane(index);
+}
+
+int ProfileSingleThreadImpl(void *data, int index) {
+  auto *executor = reinterpret_cast<ParallelExecutor *>(data);
+  return executor->ProfileSingleThread(index);
+}
+}  // namespace
+
 int ParallelExecutor::Prepare(const std::vector<mindspore::kernel::LiteKernel *> &kernels) {
-  thread_pool_ = CreateLiteThreadPool(max_thread_num_, NO_BIND);
-  if (thread_pool_ == nullptr) {
-    MS_LOG(ERROR) << "Memory error: fail to new ThreadPool";
+  if (kernels.empty()) {
+    MS_LOG(ERROR) << "kernels is empty";
     return RET_ERROR;
   }
+  auto ret = Executor::Prepare(kernels);
+  if (ret != RET_OK) {
+    return ret;
+  }
+  thread_pool_ = static_cast<const InnerContext *>(kernels.front()->context())->thread_pool_;
+  max_thread_num_ = thread_pool_ == nullptr ? 1 : std::max(GetCurrentThreadNum(thread_pool_), 1);
+  kernels_ = kernels;
+  std::unordered_map<kernel::LiteKernel *, size_t> kernel_index;
+  for (size_t i = 0; i < kernels_.size(); i++) {
+    kernel_index[kernels_[i]] = i;
+  }
+  succs_.assign(kernels_.size(), {});
+  in_degree_.assign(kernels_.size(), 0);
+  for (size_t i = 0; i < kernels_.size(); i++) {
+    for (auto *out_kernel : kernels_[i]->out_kernels()) {
+      auto iter = kernel_index.find(out_kernel);
+      if (iter == kernel_index.end()) {
+        continue;
+      }
+      succs_[i].push_back(iter->second);
+      in_degree_[iter->second]++;
+    }
+  }
+  // Kahn's algorithm, ties are broken by the original kernel order
+  topo_order_.clear();
+  std::vector<int> degree = in_degree_;
+  std::priority_queue<size_t, std::vector<size_t>, std::greater<size_t>> ready;
+  for (size_t i = 0; i < kernels_.size(); i++) {
+    if (degree[i] == 0) {
+      ready.push(i);
+    }
+  }
+  while (!ready.empty()) {
+    auto cur = ready.top();
+    ready.pop();
+    topo_order_.push_back(cur);
+    for (auto succ : succs_[cur]) {
+      if (--degree[succ] == 0) {
+        ready.push(succ);
+      }
+    }
+  }
+  if (topo_order_.size() != kernels_.size()) {
+    MS_LOG(ERROR) << "Kernels contain a cycle, can not be executed in parallel";
+    return RET_ERROR;
+  }
+  pending_ = std::make_unique<std::atomic_int[]>(kernels_.size());
+  costs_.assign(kernels_.size(), kMinKernelCost);
+  single_thread_costs_.assign(kernels_.size(), kMinKernelCost);
+  profiled_runs_ = 0;
+  lanes_.clear();
+  inter_op_num_ = 1;
   return RET_OK;
 }
 
-static int RunKernel(void *data, int index) {
-  auto *executor = reinterpret_cast<ParallelExecutor *>(data);
-  auto kernel = executor->GetReadyKernel(index);
-  auto ret = kernel->Run();
-  executor->SetResult(index, ret);
-  if (0 != ret) {
+int ParallelExecutor::RunKernel(size_t index, const KernelCallBack &before, const KernelCallBack &after) {
+  auto *kernel = kernels_[index];
+  MS_ASSERT(kernel != nullptr);
+  auto ret = kernel->PreProcess();
+  if (RET_OK != ret) {
+    MS_LOG(ERROR) << "PreProcess kernel failed, name: " << kernel->name();
+    return ret;
+  }
+  ret = kernel->Run(before, after);
+  if (RET_OK != ret) {
     MS_LOG(ERROR) << "run kernel failed, name: " << kernel->name();
-    return 0;
+    return ret;
   }
-
-  ret = kernel->FreeInWorkTensor();
+  ret = kernel->PostProcess();
   if (RET_OK != ret) {
-    MS_LOG(ERROR) << "FreeInWorkTensor failed, name: " << kernel->name();
+    MS_LOG(ERROR) << "PostProcess kernel failed, name: " << kernel->name();
     return ret;
   }
-  return 0;
+  return RET_OK;
 }
 
-int ParallelExecutor::Run(const std::vector<Tensor *> &in_tensors, const std::vector<Tensor *> &out_tensors,
-                          const std::vector<kernel::LiteKernel *> &kernels, mindspore::Allocator *allocator,
-                          const KernelCallBack &before, const KernelCallBack &after) {
-  MS_ASSERT(nullptr != allocator);
-  for (auto &inTensor : in_tensors) {
-    if (inTensor == nullptr) {
-      MS_LOG(ERROR) << "Graph input tensor is nullptr";
-      return RET_ERROR;
+int ParallelExecutor::SerialRun(const KernelCallBack &before, const KernelCallBack &after,
+                                std::vector<float> *costs) {
+  for (auto index : topo_order_) {
+    auto start = costs != nullptr ? GetTimeUs() : 0;
+    auto ret = RunKernel(index, before, after);
+    if (ret != RET_OK) {
+      return ret;
     }
-    if (inTensor->format() != schema::Format::Format_NHWC) {
-      MS_LOG(ERROR) << "Model input tensor should be NHWC";
-      return RET_ERROR;
+    if (costs != nullptr) {
+      (*costs)[index] = std::max(static_cast<float>(GetTimeUs() - start), kMinKernelCost);
     }
   }
-  kernel::LiteKernelUtil::InitTensorInitRefCount(kernels);
+  return RET_OK;
+}
 
-  for (auto kernel : kernels) {
-    if (kernel->in_kernels().empty()) {
-      readyKernels.emplace_back(kernel);
-      continue;
-    }
-    refCount[kernel] = kernel->in_kernels().size();
-  }
-  std::vector<kernel::LiteKernel *> newReadyKernels;
-  while (!readyKernels.empty()) {
-    results.resize(readyKernels.size(), RET_OK);
-    if (0 != ParallelLaunch(thread_pool_, RunKernel, this, readyKernels.size())) {
-      MS_LOG(ERROR) << "ParallelLaunch failed ";
-      return RET_ERROR;
-    }
+int ParallelExecutor::ProfileSingleThread(int task_id) {
+  // the pool is held by this launch, so the kernels run their tasks on the calling thread as they do in a lane
+  if (task_id != kProfileTaskNum - 1) {
+    return RET_OK;
+  }
+  return SerialRun(profile_before_, profile_after_, &single_thread_costs_);
+}
 
-    if (std::find_if(results.begin(), results.end(), [](const int &ret) { return (ret != 0); }) != results.end()) {
-      return RET_ERROR;
+float ParallelExecutor::ListSchedule(const std::vector<float> &rank, int lane_num,
+                                     std::vector<std::vector<size_t>> *lanes) const {
+  // the ready kernel with the highest rank goes to the lane where it can start first
+  auto kernel_num = kernels_.size();
+  std::vector<float> lane_avail(lane_num, 0.0f);
+  std::vector<float> finish(kernel_num, 0.0f);
+  std::vector<float> ready_time(kernel_num, 0.0f);
+  std::vector<int> degree = in_degree_;
+  auto rank_less = [&rank](size_t a, size_t b) { return rank[a] < rank[b] || (rank[a] == rank[b] && a > b); };
+  std::priority_queue<size_t, std::vector<size_t>, decltype(rank_less)> ready(rank_less);
+  for (size_t i = 0; i < kernel_num; i++) {
+    if (degree[i] == 0) {
+      ready.push(i);
     }
-    newReadyKernels.clear();
-    for (auto completed : readyKernels) {
-      for (auto out : completed->out_kernels()) {
-        auto iter = refCount.find(out);
-        if (iter == refCount.end()) {
-          continue;
-        }
-        (iter->second)--;
-        if (iter->second <= 0) {
-          newReadyKernels.emplace_back(iter->first);
-          refCount.erase(iter);
-        }
+  }
+  lanes->assign(lane_num, {});
+  float makespan = 0.0f;
+  while (!ready.empty()) {
+    auto cur = ready.top();
+    ready.pop();
+    int best_lane = 0;
+    float best_start = std::max(lane_avail[0], ready_time[cur]);
+    for (int lane = 1; lane < lane_num; lane++) {
+      auto start = std::max(lane_avail[lane], ready_time[cur]);
+      if (start < best_start) {
+        best_start = start;
+        best_lane = lane;
       }
-
-      auto ret = completed->FreeInWorkTensor();
-      if (RET_OK != ret) {
-        MS_LOG(ERROR) << "FreeInWorkTensor failed, name: " << completed->name();
-        return ret;
+    }
+    finish[cur] = best_start + single_thread_costs_[cur];
+    makespan = std::max(makespan, finish[cur]);
+    lane_avail[best_lane] = finish[cur];
+    (*lanes)[best_lane].push_back(cur);
+    for (auto succ : succs_[cur]) {
+      ready_time[succ] = std::max(ready_time[succ], finish[cur]);
+      if (--degree[succ] == 0) {
+        ready.push(succ);
       }
     }
-    readyKernels.clear();
-    readyKernels = std::move(newReadyKernels);
   }
+  lanes->erase(
+    std::remove_if(lanes->begin(), lanes->end(), [](const std::vector<size_t> &lane) { return lane.empty(); }),
+    lanes->end());
+  return makespan;
+}
 
+int ParallelExecutor::BuildSchedule() {
+  auto kernel_num = kernels_.size();
+  lanes_.clear();
+  inter_op_num_ = 1;
+  if (max_thread_num_ <= 1 || kernel_num <= 1 ||
+      std::any_of(kernels_.begin(), kernels_.end(), IsControlFlowKernel)) {
+    return RET_OK;
+  }
+  // upward rank: the longest path from a kernel to the exit of the graph
+  std::vector<float> rank(kernel_num, 0.0f);
+  for (auto iter = topo_order_.rbegin(); iter != topo_order_.rend(); ++iter) {
+    float max_succ_rank = 0.0f;
+    for (auto succ : succs_[*iter]) {
+      max_succ_rank = std::max(max_succ_rank, rank[succ]);
+    }
+    rank[*iter] = single_thread_costs_[*iter] + max_succ_rank;
+  }
+  float serial_cost = 0.0f;
+  for (auto cost : costs_) {
+    serial_cost += cost;
+  }
+  // every lane takes one thread of the pool away from the intra-op work of the kernels
+  float best_makespan = serial_cost * kMinLaneGain;
+  std::vector<std::vector<size_t>> lanes;
+  for (int lane_num = 2; lane_num <= std::min(max_thread_num_, static_cast<int>(kernel_num)); lane_num++) {
+    auto makespan = ListSchedule(rank, lane_num, &lanes);
+    if (lanes.size() > 1 && makespan < best_makespan) {
+      best_makespan = makespan;
+      lanes_.swap(lanes);
+    }
+  }
+  if (lanes_.empty()) {
+    MS_LOG(INFO) << "Parallel executor keeps " << kernel_num << " kernels serial, serial cost: " << serial_cost
+                 << "us";
+    return RET_OK;
+  }
+  inter_op_num_ = static_cast<int>(lanes_.size());
+  MS_LOG(INFO) << "Parallel executor schedules " << kernel_num << " kernels onto " << inter_op_num_
+               << " inter-op lanes, estimated makespan: " << best_makespan << "us, serial cost: " << serial_cost
+               << "us";
   return RET_OK;
 }
 
+void ParallelExecutor::NotifyLanes() {
+  // taking the lock orders the notification after the check of a lane about to wait
+  {
+    std::lock_guard<std::mutex> lock(ready_mutex_);
+  }
+  ready_cond_.notify_all();
+}
+
+int ParallelExecutor::RunLane(int lane_id) {
+  for (auto index : lanes_.at(lane_id)) {
+    {
+      std::unique_lock<std::mutex> lock(ready_mutex_);
+      ready_cond_.wait(lock, [this, index] {
+        return pending_[index].load(std::memory_order_acquire) == 0 || failed_.load(std::memory_order_relaxed);
+      });
+    }
+    if (failed_.load(std::memory_order_relaxed)) {
+      return RET_ERROR;
+    }
+    auto ret = RunKernel(index, nullptr, nullptr);
+    if (ret != RET_OK) {
+      failed_.store(true);
+      NotifyLanes();
+      return ret;
+    }
+    bool has_ready = false;
+    for (auto succ : succs_[index]) {
+      if (pending_[succ].fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        has_ready = true;
+      }
+    }
+    if (has_ready) {
+      NotifyLanes();
+    }
+  }
+  return RET_OK;
+}
+
+int ParallelExecutor::Run(const std::vector<Tensor *> &in_tensors, const std::vector<Tensor *> &out_tensors,
+                          const std::vector<kernel::LiteKernel *> &kernels, mindspore::Allocator *allocator,
+                          const KernelCallBack &before, const KernelCallBack &after) {
+  MS_ASSERT(nullptr != allocator);
+  if (kernels.size() != kernels_.size()) {
+    MS_LOG(ERROR) << "Kernels are different from the prepared ones";
+    return RET_ERROR;
+  }
+  auto ret = CheckTensorsInvalid(in_tensors);
+  if (RET_OK != ret) {
+    MS_LOG(ERROR) << "CheckInputs failed";
+    return ret;
+  }
+  if (profiled_runs_ == 0) {
+    ret = SerialRun(before, after, &costs_);
+    if (ret != RET_OK) {
+      return ret;
+    }
+    profiled_runs_++;
+    return RET_OK;
+  }
+  if (profiled_runs_ == 1) {
+    if (max_thread_num_ <= 1) {
+      ret = SerialRun(before, after, &single_thread_costs_);
+    } else {
+      profile_before_ = before;
+      profile_after_ = after;
+      ret = ParallelLaunch(thread_pool_, ProfileSingleThreadImpl, this, kProfileTaskNum);
+      profile_before_ = nullptr;
+      profile_after_ = nullptr;
+    }
+    if (ret != RET_OK) {
+      return ret;
+    }
+    profiled_runs_++;
+    return BuildSchedule();
+  }
+  // callbacks are not guaranteed to be reentrant, keep them on the serial path
+  if (lanes_.empty() || before != nullptr || after != nullptr) {
+    return SerialRun(before, after, nullptr);
+  }
+  for (size_t i = 0; i < kernels_.size(); i++) {
+    pending_[i].store(in_degree_[i], std::memory_order_relaxed);
+  }
+  failed_.store(false);
+  ret = ParallelLaunch(thread_pool_, RunLaneImpl, this, inter_op_num_);
+  if (ret != RET_OK || failed_.load()) {
+    MS_LOG(ERROR) << "Run kernels in parallel failed";
+    return RET_ERROR;
+  }
+  return RET_OK;
+}
 }  // namespace mindspore::lite
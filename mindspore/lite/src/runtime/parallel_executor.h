@@ -17,8 +17,11 @@
 #ifndef MINDSPORE_LITE_SRC_RUNTIME_PARALLEL_EXECUTOR_H_
 #define MINDSPORE_LITE_SRC_RUNTIME_PARALLEL_EXECUTOR_H_
 
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
 #include <vector>
-#include <thread>
 #include <unordered_map>
 #include "src/runtime/allocator.h"
 #include "src/lite_kernel.h"
@@ -26,25 +29,61 @@
 #include "src/executor.h"
 
 namespace mindspore::lite {
+// Dependency driven executor which runs independent kernels concurrently.
+// The inter-op lanes run on the threads of the context thread pool, so they share the thread number and the bind
+// mode of the session with the intra-op work instead of adding threads. While the lanes hold the pool, the kernels
+// run their tasks on the lane thread.
+// The first run executes kernels serially with intra-op parallelism and the second one with single threaded kernels,
+// recording the cost of every kernel in both modes. Kernels are then assigned to lanes by critical-path list
+// scheduling, and the lanes are only used when their estimated makespan beats the serial run.
 class ParallelExecutor : public Executor {
  public:
   ParallelExecutor() = default;
-  ~ParallelExecutor() override;
+  ~ParallelExecutor() override = default;
 
   int Prepare(const std::vector<kernel::LiteKernel *> &kernels) override;
 
   int Run(const std::vector<Tensor *> &in_tensors, const std::vector<Tensor *> &out_tensors,
           const std::vector<kernel::LiteKernel *> &kernels, mindspore::Allocator *allocator = nullptr,
           const KernelCallBack &before = nullptr, const KernelCallBack &after = nullptr) override;
-  inline kernel::LiteKernel *GetReadyKernel(const int index) const { return readyKernels.at(index); }
-  inline void SetResult(const int index, const int result) { results.at(index) = result; }
+
+  int RunLane(int lane_id);
+
+  int ProfileSingleThread(int task_id);
+
+  int inter_op_num() const { return inter_op_num_; }
+
+ private:
+  int RunKernel(size_t index, const KernelCallBack &before, const KernelCallBack &after);
+  int SerialRun(const KernelCallBack &before, const KernelCallBack &after, std::vector<float> *costs);
+  float ListSchedule(const std::vector<float> &rank, int lane_num, std::vector<std::vector<size_t>> *lanes) const;
+  int BuildSchedule();
+  void NotifyLanes();
 
  private:
-  std::unordered_map<kernel::LiteKernel *, size_t> refCount;
-  std::vector<kernel::LiteKernel *> readyKernels;
-  std::vector<int> results;
+  std::vector<kernel::LiteKernel *> kernels_;
+  // kernels in topological order
+  std::vector<size_t> topo_order_;
+  std::vector<std::vector<size_t>> succs_;
+  std::vector<int> in_degree_;
+  // cost of each kernel in us, measured by the profiling runs with intra-op parallelism and single threaded
+  std::vector<float> costs_;
+  std::vector<float> single_thread_costs_;
+  // kernels of each inter-op lane in execution order
+  std::vector<std::vector<size_t>> lanes_;
+  std::unique_ptr<std::atomic_int[]> pending_;
+  std::atomic_bool failed_{false};
+  // lanes wait on ready_cond_ until the predecessors of their next kernel are done
+  std::mutex ready_mutex_;
+  std::condition_variable ready_cond_;
+  int profiled_runs_ = 0;
+  // the callbacks of the single threaded profiling run, which runs on a task of the thread pool
+  KernelCallBack profile_before_ = nullptr;
+  KernelCallBack profile_after_ = nullptr;
+  int inter_op_num_ = 1;
+  int max_thread_num_ = 1;
+  // thread pool of the context, not owned
   struct ThreadPool *thread_pool_ = nullptr;
-  int max_thread_num_ = std::thread::hardware_concurrency();
 };
 
 }  // namespace mindspore::lite
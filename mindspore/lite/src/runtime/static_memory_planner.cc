@@ -0,0 +1,198 @@
+/**
+ * Copyright 2021 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "src/runtime/static_memory_planner.h"
+#include <algorithm>
+#include <cstdint>
+#include <sstream>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include "src/runtime/allocator.h"
+#include "src/common/log_adapter.h"
+
+namespace mindspore::lite {
+namespace {
+constexpr size_t kArenaAlign = 64;
+constexpr size_t kPlanCacheSize = 8;
+
+size_t AlignSize(size_t size) { return (size + kArenaAlign - 1) / kArenaAlign * kArenaAlign; }
+}  // namespace
+
+StaticMemoryPlanner::~StaticMemoryPlanner() {
+  // tensors may have been freed already, only the arena is released here
+  free(arena_);
+  arena_ = nullptr;
+}
+
+bool StaticMemoryPlanner::IsStaticTensor(const Tensor *tensor) {
+  if (tensor == nullptr || tensor->IsConst() || tensor->IsGraphInput() || tensor->IsGraphOutput()) {
+    return false;
+  }
+  if (tensor->data_type() == kObjectTypeTensorType || tensor->root_tensor() != nullptr ||
+      tensor->data_c() != nullptr) {
+    return false;
+  }
+  auto shape = tensor->shape();
+  if (std::any_of(shape.begin(), shape.end(), [](int dim) { return dim < 0; })) {
+    return false;
+  }
+  return tensor->Size() > 0 && static_cast<int64_t>(tensor->Size()) <= MAX_MALLOC_SIZE;
+}
+
+size_t StaticMemoryPlanner::AssignOffsets(std::vector<TensorLife> *lives) {
+  std::vector<size_t> order(lives->size());
+  for (size_t i = 0; i < order.size(); i++) {
+    order[i] = i;
+  }
+  // largest tensors first, earlier tensors first on ties
+  std::sort(order.begin(), order.end(), [lives](size_t a, size_t b) {
+    auto &life_a = lives->at(a);
+    auto &life_b = lives->at(b);
+    return life_a.size > life_b.size || (life_a.size == life_b.size && life_a.start < life_b.start);
+  });
+  size_t arena_size = 0;
+  std::vector<TensorLife *> placed;
+  for (auto index : order) {
+    auto &life = lives->at(index);
+    std::vector<std::pair<size_t, size_t>> used;
+    for (auto *other : placed) {
+      if (other->start <= life.end && life.start <= other->end) {
+        used.emplace_back(other->offset, other->offset + other->size);
+      }
+    }
+    std::sort(used.begin(), used.end());
+    // best fit: the smallest gap between live tensors which can hold this one, or the top of the arena
+    size_t best_offset = 0;
+    size_t best_gap = SIZE_MAX;
+    size_t cursor = 0;
+    for (auto &range : used) {
+      if (range.first > cursor) {
+        auto gap = range.first - cursor;
+        if (gap >= life.size && gap < best_gap) {
+          best_gap = gap;
+          best_offset = cursor;
+        }
+      }
+      cursor = std::max(cursor, range.second);
+    }
+    life.offset = best_gap == SIZE_MAX ? cursor : best_offset;
+    arena_size = std::max(arena_size, life.offset + life.size);
+    placed.push_back(&life);
+  }
+  return arena_size;
+}
+
+std::string StaticMemoryPlanner::PlanKey(const std::vector<TensorLife> &lives) {
+  std::ostringstream oss;
+  for (auto &life : lives) {
+    oss << life.size << ',' << life.start << ',' << life.end << ';';
+  }
+  return oss.str();
+}
+
+int StaticMemoryPlanner::Plan(const std::vector<kernel::LiteKernel *> &kernels,
+                              const std::vector<Tensor *> &graph_inputs, const std::vector<Tensor *> &graph_outputs) {
+  Release();
+  std::unordered_set<Tensor *> excluded(graph_inputs.begin(), graph_inputs.end());
+  excluded.insert(graph_outputs.begin(), graph_outputs.end());
+  std::unordered_map<Tensor *, size_t> life_index;
+  std::vector<TensorLife> lives;
+  for (size_t i = 0; i < kernels.size(); i++) {
+    for (auto *tensor : kernels[i]->in_tensors()) {
+      auto iter = life_index.find(tensor);
+      if (iter != life_index.end()) {
+        lives[iter->second].end = i;
+      }
+    }
+    for (auto *tensor : kernels[i]->out_tensors()) {
+      if (excluded.find(tensor) != excluded.end() || life_index.find(tensor) != life_index.end() ||
+          !IsStaticTensor(tensor)) {
+        continue;
+      }
+      life_index[tensor] = lives.size();
+      lives.push_back({tensor, AlignSize(tensor->Size()), i, i, 0});
+    }
+  }
+  if (lives.empty()) {
+    return RET_OK;
+  }
+  total_size_ = 0;
+  for (auto &life : lives) {
+    total_size_ += life.size;
+  }
+  auto key = PlanKey(lives);
+  auto cached = std::find_if(plan_cache_.begin(), plan_cache_.end(),
+                             [&key](const CachedPlan &plan) { return plan.key == key; });
+  if (cached != plan_cache_.end()) {
+    for (size_t i = 0; i < lives.size(); i++) {
+      lives[i].offset = cached->offsets[i];
+    }
+    arena_size_ = cached->arena_size;
+    plan_cache_.splice(plan_cache_.begin(), plan_cache_, cached);
+  } else {
+    arena_size_ = AssignOffsets(&lives);
+    CachedPlan plan{key, {}, arena_size_};
+    for (auto &life : lives) {
+      plan.offsets.push_back(life.offset);
+    }
+    plan_cache_.push_front(std::move(plan));
+    if (plan_cache_.size() > kPlanCacheSize) {
+      plan_cache_.pop_back();
+    }
+  }
+  if (arena_size_ > arena_capacity_) {
+    free(arena_);
+    arena_capacity_ = 0;
+    arena_ = malloc(arena_size_ + kArenaAlign);
+    if (arena_ == nullptr) {
+      MS_LOG(ERROR) << "Malloc arena failed, size: " << arena_size_;
+      arena_size_ = 0;
+      total_size_ = 0;
+      return RET_ERROR;
+    }
+    arena_capacity_ = arena_size_;
+  }
+  auto base = (reinterpret_cast<uintptr_t>(arena_) + kArenaAlign - 1) / kArenaAlign * kArenaAlign;
+  for (auto &life : lives) {
+    life.tensor->set_data(reinterpret_cast<void *>(base + life.offset));
+    life.tensor->set_own_data(false);
+    planned_tensors_.push_back(life.tensor);
+  }
+  MS_LOG(INFO) << "Static memory plan: " << planned_tensors_.size() << " tensors, arena size: " << arena_size_
+               << " bytes, size without reuse: " << total_size_ << " bytes";
+  return RET_OK;
+}
+
+void StaticMemoryPlanner::Release() {
+  if (arena_ == nullptr) {
+    return;
+  }
+  auto begin = reinterpret_cast<uintptr_t>(arena_);
+  auto end = begin + arena_capacity_ + kArenaAlign;
+  for (auto *tensor : planned_tensors_) {
+    auto data = reinterpret_cast<uintptr_t>(tensor->data_c());
+    // kernels may have replaced the data of the tensor, which is not ours to reset
+    if (data >= begin && data < end) {
+      tensor->set_data(nullptr);
+      tensor->set_own_data(false);
+    }
+  }
+  planned_tensors_.clear();
+  arena_size_ = 0;
+  total_size_ = 0;
+}
+}  // namespace mindspore::lite
@@ -0,0 +1,80 @@
+/**
+ * Copyright 2021 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MINDSPORE_LITE_SRC_RUNTIME_STATIC_MEMORY_PLANNER_H_
+#define MINDSPORE_LITE_SRC_RUNTIME_STATIC_MEMORY_PLANNER_H_
+
+#include <list>
+#include <string>
+#include <utility>
+#include <vector>
+#include "src/lite_kernel.h"
+#include "src/tensor.h"
+
+namespace mindspore::lite {
+// Liveness based memory planner for the activation tensors of a serially executed kernel list.
+// Every tensor whose shape is known at compile time gets an offset in one arena, tensors with disjoint lifetimes
+// share memory. Planned tensors do not own their data, so PreProcess and PostProcess of kernels skip the allocator.
+// Tensors with dynamic shape are left to the allocator.
+// Offsets of recently planned shape signatures are cached, so switching between input shapes seen before only
+// reassigns tensor data. The arena is kept across plans and only grows.
+class StaticMemoryPlanner {
+ public:
+  StaticMemoryPlanner() = default;
+  ~StaticMemoryPlanner();
+
+  int Plan(const std::vector<kernel::LiteKernel *> &kernels, const std::vector<Tensor *> &graph_inputs,
+           const std::vector<Tensor *> &graph_outputs);
+
+  // detach planned tensors from the arena, the arena is kept for the next plan
+  void Release();
+
+  size_t arena_size() const { return arena_size_; }
+
+  // memory needed by the planned tensors without any reuse
+  size_t total_size() const { return total_size_; }
+
+ private:
+  struct TensorLife {
+    Tensor *tensor;
+    size_t size;
+    size_t start;
+    size_t end;
+    size_t offset;
+  };
+
+  static bool IsStaticTensor(const Tensor *tensor);
+
+  size_t AssignOffsets(std::vector<TensorLife> *lives);
+
+  static std::string PlanKey(const std::vector<TensorLife> &lives);
+
+ private:
+  struct CachedPlan {
+    std::string key;
+    std::vector<size_t> offsets;
+    size_t arena_size;
+  };
+  // most recently used plan first
+  std::list<CachedPlan> plan_cache_;
+  std::vector<Tensor *> planned_tensors_;
+  void *arena_ = nullptr;
+  size_t arena_capacity_ = 0;
+  size_t arena_size_ = 0;
+  size_t total_size_ = 0;
+};
+}  // namespace mindspore::lite
+#endif  // MINDSPORE_LITE_SRC_RUNTIME_STATIC_MEMORY_PLANNER_H_
@@ -21,6 +21,7 @@
 #include <semaphore.h>
 #include <string.h>
 #include <stdlib.h>
+#include <time.h>
 #include <unistd.h>
 
 #ifdef __WIN32__
@@ -72,6 +73,7 @@ typedef struct Thread {
   atomic_int tail;
   atomic_bool activate;
   atomic_bool is_running;
+  atomic_ullong busy_time;
   sem_t sem;
   sem_t sem_inited;
 } Thread;
@@ -88,8 +90,19 @@ typedef struct ThreadPool {
   int thread_num;
   BindMode mode;
   atomic_bool is_alive;
+  atomic_bool is_busy;
+  atomic_bool profiling;
+  atomic_ullong master_busy_time;
 } ThreadPool;
 
+static uint64_t GetTimeUs() {
+  struct timespec ts = {0, 0};
+  if (clock_gettime(CLOCK_MONOTONIC, &ts) != 0) {
+    return 0;
+  }
+  return (uint64_t)ts.tv_sec * 1000000 + (uint64_t)ts.tv_nsec / 1000;
+}
+
 Thread *GetThread(struct ThreadPool *thread_pool, int thread_id) {
   if (thread_pool == NULL) {
     LOG_ERROR("get thread pool instance failed, thread_id: %d", thread_id);
@@ -700,7 +713,12 @@ int DistributeTask(struct ThreadPool *thread_pool, Task *task, int task_num) {
     LOG_ERROR("task_num out of range in master thread");
     return RET_TP_ERROR;
   }
+  bool profiling = atomic_load_explicit(&thread_pool->profiling, memory_order_relaxed);
+  uint64_t start = profiling ? GetTimeUs() : 0;
   task->return_code[task_num - 1] = task->func(task->content, task_num - 1);
+  if (profiling) {
+    atomic_fetch_add_explicit(&thread_pool->master_busy_time, GetTimeUs() - start, memory_order_relaxed);
+  }
   // wait
   WaitAllThread(thread_pool);
   for (size_t i = 0; i < task->task_num; i++) {
@@ -711,6 +729,27 @@ int DistributeTask(struct ThreadPool *thread_pool, Task *task, int task_num) {
   return RET_TP_OK;
 }
 
+int RunTaskInMaster(int func(void *, int), void *content, int task_num) {
+  for (int i = 0; i < task_num; ++i) {
+    int ret = func(content, i);
+    if (ret != 0) {
+      return ret;
+    }
+  }
+  return RET_TP_OK;
+}
+
+int RunTaskInMasterWithProfiling(struct ThreadPool *thread_pool, int func(void *, int), void *content,
+                                 int task_num) {
+  if (!atomic_load_explicit(&thread_pool->profiling, memory_order_relaxed)) {
+    return RunTaskInMaster(func, content, task_num);
+  }
+  uint64_t start = GetTimeUs();
+  int ret = RunTaskInMaster(func, content, task_num);
+  atomic_fetch_add_explicit(&thread_pool->master_busy_time, GetTimeUs() - start, memory_order_relaxed);
+  return ret;
+}
+
 int AddTask(struct ThreadPool *thread_pool, int func(void *, int), void *content, int task_num) {
   if (thread_pool == NULL) {
     LOG_ERROR("get thread pool instance failed");
@@ -718,13 +757,13 @@ int AddTask(struct ThreadPool *thread_pool, int func(void *, int), void *content
   }
   // if single thread, run master thread
   if (thread_pool->thread_num <= 1 || task_num <= 1) {
-    for (int i = 0; i < task_num; ++i) {
-      int ret = func(content, i);
-      if (ret != 0) {
-        return ret;
-      }
-    }
-    return RET_TP_OK;
+    return RunTaskInMasterWithProfiling(thread_pool, func, content, task_num);
+  }
+  // workers are owned by another caller (e.g. a concurrent kernel of the parallel executor),
+  // run all tasks on the calling thread instead of waiting for them
+  bool expected = false;
+  if (!atomic_compare_exchange_strong(&thread_pool->is_busy, &expected, true)) {
+    return RunTaskInMasterWithProfiling(thread_pool, func, content, task_num);
   }
   Task task;
   task.func = func;
@@ -733,11 +772,13 @@ int AddTask(struct ThreadPool *thread_pool, int func(void *, int), void *content
   task.task_num = task_num;
   if (task.return_code == NULL) {
     LOG_ERROR("malloc return code return nullptr");
+    atomic_store(&thread_pool->is_busy, false);
     return RET_TP_ERROR;
   }
   memset(task.return_code, 0, sizeof(int) * task_num);
   int ret = DistributeTask(thread_pool, &task, task_num);
   free(task.return_code);
+  atomic_store(&thread_pool->is_busy, false);
   return ret;
 }
 
@@ -768,7 +809,12 @@ void ThreadRun(Thread *thread) {
           LOG_ERROR("task_num out of range in worker thread");
           return;
         }
+        bool profiling = atomic_load_explicit(&thread_pool->profiling, memory_order_relaxed);
+        uint64_t start = profiling ? GetTimeUs() : 0;
         task->return_code[thread_id] = task->func(task->content, thread_id);
+        if (profiling) {
+          atomic_fetch_add_explicit(&thread->busy_time, GetTimeUs() - start, memory_order_relaxed);
+        }
         atomic_fetch_sub_explicit(&thread->task_size, 1, memory_order_release);
         spin_count = 0;
         sem_trywait(&thread->sem);
@@ -822,6 +868,7 @@ int CreateNewThread(struct ThreadPool *thread_pool, int thread_id) {
   thread->tail = ATOMIC_VAR_INIT(0);
   thread->task_size = ATOMIC_VAR_INIT(0);
   thread->activate = ATOMIC_VAR_INIT(true);
+  thread->busy_time = ATOMIC_VAR_INIT(0);
   thread->is_running = ATOMIC_VAR_INIT(true);
   thread->next = NULL;
   sem_init(&thread->sem, 0, 0);
@@ -863,6 +910,9 @@ ThreadPool *CreateThreadPool(int thread_num, int mode) {
   }
   thread_pool->thread_num = thread_num > max_thread_num ? max_thread_num : thread_num;
   thread_pool->is_alive = ATOMIC_VAR_INIT(true);
+  thread_pool->is_busy = ATOMIC_VAR_INIT(false);
+  thread_pool->profiling = ATOMIC_VAR_INIT(false);
+  thread_pool->master_busy_time = ATOMIC_VAR_INIT(0);
   thread_pool->mode = mode;
   thread_pool->thread_list = NULL;
   if (thread_num > 1) {
@@ -953,6 +1003,36 @@ void DestroyThreadPool(struct ThreadPool *thread_pool) {
   LOG_INFO("destroy thread pool success");
 }
 
+void SetThreadPoolProfiling(struct ThreadPool *thread_pool, bool enable) {
+  if (thread_pool == NULL) {
+    LOG_ERROR("get thread pool instance failed");
+    return;
+  }
+  if (enable) {
+    for (int i = 0; i < thread_pool->thread_num - 1; ++i) {
+      Thread *thread = GetThread(thread_pool, i);
+      if (thread != NULL) {
+        atomic_store_explicit(&thread->busy_time, 0, memory_order_relaxed);
+      }
+    }
+    atomic_store_explicit(&thread_pool->master_busy_time, 0, memory_order_relaxed);
+  }
+  atomic_store_explicit(&thread_pool->profiling, enable, memory_order_relaxed);
+}
+
+int GetThreadPoolBusyTime(struct ThreadPool *thread_pool, uint64_t *busy_time, int size) {
+  if (thread_pool == NULL || busy_time == NULL || size < thread_pool->thread_num) {
+    LOG_ERROR("invalid busy time buffer, size: %d", size);
+    return 0;
+  }
+  for (int i = 0; i < thread_pool->thread_num - 1; ++i) {
+    Thread *thread = GetThread(thread_pool, i);
+    busy_time[i] = thread == NULL ? 0 : atomic_load_explicit(&thread->busy_time, memory_order_relaxed);
+  }
+  busy_time[thread_pool->thread_num - 1] = atomic_load_explicit(&thread_pool->master_busy_time, memory_order_relaxed);
+  return thread_pool->thread_num;
+}
+
 int GetCurrentThreadNum(struct ThreadPool *thread_pool) {
   if (thread_pool == NULL) {
     LOG_ERROR("get thread pool instance failed");
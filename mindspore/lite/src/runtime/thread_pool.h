@@ -18,6 +18,7 @@
 #define MINDSPORE_LITE_SRC_RUNTIME_THREAD_POOL_H_
 
 #include <stdbool.h>
+#include <stdint.h>
 
 #define MAX_TASK_NUM (2)
 
@@ -33,7 +34,8 @@ struct ThreadPool;
 struct ThreadPool *CreateThreadPool(int thread_num, int mode);
 
 /**
- *
+ * run job on the thread pool, if the workers are already used by another caller, all tasks of job run on the
+ * calling thread
  * @param session_index, support multi session
  * @param job
  * @param content
@@ -66,6 +68,20 @@ void DeactivateThreadPool(struct ThreadPool *thread_pool);
  */
 int GetCurrentThreadNum(struct ThreadPool *thread_pool);
 
+/**
+ * start or stop recording the time each thread spends running tasks, starting clears the previous records
+ * @param enable
+ */
+void SetThreadPoolProfiling(struct ThreadPool *thread_pool, bool enable);
+
+/**
+ * get the recorded busy time in microseconds, one element per worker thread followed by the calling thread
+ * @param busy_time array holding at least thread num elements
+ * @param size
+ * @return number of elements written
+ */
+int GetThreadPoolBusyTime(struct ThreadPool *thread_pool, uint64_t *busy_time, int size);
+
 /**
  * destroy thread pool, and release resource
  */
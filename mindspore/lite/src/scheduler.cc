@@ -33,6 +33,7 @@
 #include "src/runtime/infer_manager.h"
 #include "src/sub_graph_split.h"
 #include "src/weight_decoder.h"
+#include "src/lite_model.h"
 #if GPU_OPENCL
 #include "src/runtime/kernel/opencl/opencl_subgraph.h"
 #include "src/runtime/gpu/opencl/opencl_runtime.h"
@@ -146,6 +147,16 @@ int Scheduler::InferNodeShape(const lite::Model::Node *node) {
 
   op_parameters_[node->output_indices_.at(0)] = parameter;
   auto ret = KernelInferShape(inputs, &outputs, parameter);
+  // lazy weights are hidden from shape inference, decode them when the node can not be inferred without them
+  if (ret == RET_INFER_INVALID &&
+      std::any_of(inputs.begin(), inputs.end(), [](const Tensor *input) { return input->IsLazy(); })) {
+    for (auto *input : inputs) {
+      if (input->IsLazy() && input->DecodeLazyData() != RET_OK) {
+        return RET_ERROR;
+      }
+    }
+    ret = KernelInferShape(inputs, &outputs, parameter);
+  }
   if (ret == RET_OK) {
     for (auto &output : outputs) {
       if (output->ElementsNum() >= MAX_MALLOC_SIZE / static_cast<int>(sizeof(int64_t))) {
@@ -352,11 +363,13 @@ int Scheduler::FindCpuKernel(const std::vector<Tensor *> &in_tensors, const std:
       MS_LOG(DEBUG) << "CastConstTensorsData failed: " << ret;
       return RET_NOT_SUPPORT;
     }
-    // we don't need to restore tensor for copy data
-    ret = CopyConstTensorData(in_tensors, op_type);
-    if (ret != RET_OK) {
-      MS_LOG(DEBUG) << "CopyConstTensorsData failed: " << ret;
-      return RET_NOT_SUPPORT;
+    // we don't need to restore tensor for copy data, weights of a mapped model stay views into the mapping
+    if (!reinterpret_cast<LiteModel *>(src_model_)->mmap_buf_) {
+      ret = CopyConstTensorData(in_tensors, op_type);
+      if (ret != RET_OK) {
+        MS_LOG(DEBUG) << "CopyConstTensorsData failed: " << ret;
+        return RET_NOT_SUPPORT;
+      }
     }
   }
   ret = KernelRegistry::GetInstance()->GetKernel(in_tensors, out_tensors, context_, cpu_desc, op_parameter, kernel);
@@ -447,45 +460,49 @@ kernel::LiteKernel *Scheduler::FindBackendKernel(const std::vector<Tensor *> &in
   kernel::KernelKey desc{kCPU, data_type, static_cast<schema::PrimitiveType>(op_parameter->type_)};
   kernel::LiteKernel *kernel = nullptr;
   int status;
+#if defined(SUPPORT_GPU) || defined(SUPPORT_NPU)
+  // nodes the converter assigned to a device skip the others, the cpu stays the fallback of all of them
+  auto device_type = reinterpret_cast<LiteModel *>(src_model_)->NodeDeviceType(node);
+#endif
 #ifdef SUPPORT_GPU
-  //  if (node->device_type_ == DT_GPU || node->device_type_ == DEFAULT) {
-  status = FindGpuKernel(in_tensors, out_tensors, op_parameter, desc, &kernel);
-  if (status == RET_OK) {
-    return kernel;
-  } else {
-    MS_LOG(DEBUG) << "Get gpu op failed, scheduler to cpu: " << PrimitiveCurVersionTypeName(desc.type) << " "
-                  << node->name_;
-    if (status == RET_ERROR) {
-      auto ret = InferNodeShape(node);
-      if (ret == RET_INFER_INVALID || ret == RET_OK) {
-        op_parameter = op_parameters_[node->output_indices_.at(0)];
-      } else {
-        MS_LOG(ERROR) << "Try repeat infer fail: " << node->name_;
-        return nullptr;
+  if (device_type == DT_GPU || device_type == kDefaultDeviceType) {
+    status = FindGpuKernel(in_tensors, out_tensors, op_parameter, desc, &kernel);
+    if (status == RET_OK) {
+      return kernel;
+    } else {
+      MS_LOG(DEBUG) << "Get gpu op failed, scheduler to cpu: " << PrimitiveCurVersionTypeName(desc.type) << " "
+                    << node->name_;
+      if (status == RET_ERROR) {
+        auto ret = InferNodeShape(node);
+        if (ret == RET_INFER_INVALID || ret == RET_OK) {
+          op_parameter = op_parameters_[node->output_indices_.at(0)];
+        } else {
+          MS_LOG(ERROR) << "Try repeat infer fail: " << node->name_;
+          return nullptr;
+        }
       }
     }
   }
-//  }
 #endif
 #ifdef SUPPORT_NPU
-  //  if (node->device_type_ == DT_NPU || node->device_type_ == DEFAULT) {
-  status = FindNpuKernel(in_tensors, out_tensors, op_parameter, desc, &kernel);
-  if (status == RET_OK) {
-    return kernel;
-  } else {
-    MS_LOG(DEBUG) << "Get npu op failed, scheduler to cpu: " << PrimitiveCurVersionTypeName(desc.type) << " "
-                  << node->name_;
-    if (status == RET_ERROR) {
-      auto ret = InferNodeShape(node);
-      if (ret == RET_INFER_INVALID || ret == RET_OK) {
-        op_parameter = op_parameters_[node->output_indices_.at(0)];
-      } else {
-        MS_LOG(ERROR) << "Try repeat infer fail: " << node->name_;
-        return nullptr;
+  if (device_type == DT_NPU || device_type == kDefaultDeviceType) {
+    status = FindNpuKernel(in_tensors, out_tensors, op_parameter, desc, &kernel);
+    if (status == RET_OK) {
+      return kernel;
+    } else {
+      MS_LOG(DEBUG) << "Get npu op failed, scheduler to cpu: " << PrimitiveCurVersionTypeName(desc.type) << " "
+                    << node->name_;
+      if (status == RET_ERROR) {
+        auto ret = InferNodeShape(node);
+        if (ret == RET_INFER_INVALID || ret == RET_OK) {
+          op_parameter = op_parameters_[node->output_indices_.at(0)];
+        } else {
+          MS_LOG(ERROR) << "Try repeat infer fail: " << node->name_;
+          return nullptr;
+        }
       }
     }
   }
-//  }
 #endif
   if (prefer_data_type == kNumberTypeFloat16 || prefer_data_type == kTypeUnknown) {
     status = FindCpuKernel(in_tensors, out_tensors, op_parameter, desc, kNumberTypeFloat16, &kernel);
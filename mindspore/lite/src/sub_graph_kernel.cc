@@ -15,6 +15,7 @@
  */
 
 #include "src/sub_graph_kernel.h"
+#include <algorithm>
 #include "src/tensor.h"
 #include "src/tensorlist.h"
 #ifdef ENABLE_FP16
@@ -24,12 +25,16 @@
 #include "src/runtime/infer_manager.h"
 #include "src/common/tensor_util.h"
 #include "src/common/utils.h"
+#include "src/runtime/parallel_executor.h"
 
 namespace mindspore::kernel {
 using mindspore::lite::RET_ERROR;
 using mindspore::lite::RET_INFER_ERR;
 using mindspore::lite::RET_INFER_INVALID;
 using mindspore::lite::RET_OK;
+namespace {
+constexpr size_t kShapeStateCacheSize = 8;
+}  // namespace
 
 int SubGraphKernel::Prepare() {
   for (auto node : this->nodes_) {
@@ -86,7 +91,72 @@ int SubGraphKernel::Run(const KernelCallBack &before, const KernelCallBack &afte
   return RET_OK;
 }
 
+std::vector<std::vector<int>> SubGraphKernel::NodeShapes(const LiteKernel *node) {
+  std::vector<std::vector<int>> shapes;
+  for (auto *tensor : node->in_tensors()) {
+    shapes.push_back(tensor->shape());
+  }
+  for (auto *tensor : node->out_tensors()) {
+    shapes.push_back(tensor->shape());
+  }
+  return shapes;
+}
+
+SubGraphKernel::ShapeStates *SubGraphKernel::GetShapeStates() {
+  std::vector<std::vector<int>> in_shapes;
+  for (auto *tensor : in_tensors_) {
+    in_shapes.push_back(tensor->shape());
+  }
+  auto cached = std::find_if(shape_states_.begin(), shape_states_.end(),
+                             [&in_shapes](const ShapeStates &states) { return states.in_shapes == in_shapes; });
+  if (cached != shape_states_.end()) {
+    shape_states_.splice(shape_states_.begin(), shape_states_, cached);
+    return &shape_states_.front();
+  }
+  shape_states_.push_front({in_shapes, {}});
+  if (shape_states_.size() > kShapeStateCacheSize) {
+    shape_states_.pop_back();
+  }
+  return &shape_states_.front();
+}
+
+void SubGraphKernel::SaveNodeShapeState(LiteKernel *node, ShapeStates *states) {
+  auto kernel_state = node->SaveShapeState();
+  if (kernel_state == nullptr) {
+    return;
+  }
+  NodeShapeState state;
+  for (auto *tensor : node->out_tensors()) {
+    state.out_shapes.push_back(tensor->shape());
+    state.out_formats.push_back(tensor->format());
+    state.out_data_types.push_back(tensor->data_type());
+  }
+  state.kernel_state = kernel_state;
+  states->nodes[node] = state;
+}
+
+int SubGraphKernel::RestoreNodeShapeState(LiteKernel *node, const NodeShapeState &state) {
+  auto outputs = node->out_tensors();
+  if (outputs.size() != state.out_shapes.size()) {
+    return RET_ERROR;
+  }
+  auto ret = node->RestoreShapeState(state.kernel_state);
+  if (ret != RET_OK) {
+    return ret;
+  }
+  for (size_t i = 0; i < outputs.size(); i++) {
+    outputs[i]->FreeData();
+    outputs[i]->set_shape(state.out_shapes[i]);
+    outputs[i]->set_format(state.out_formats[i]);
+    outputs[i]->set_data_type(state.out_data_types[i]);
+  }
+  resized_shapes_[node] = NodeShapes(node);
+  return RET_OK;
+}
+
 int SubGraphKernel::ReSize() {
+  // inputs of the sub graph decide the shapes of all nodes, a signature seen before swaps in the saved node states
+  auto shape_states = GetShapeStates();
   for (auto kernel : nodes_) {
     if (kernel == nullptr) {
       MS_LOG(ERROR) << "input kernel is nullptr!";
@@ -101,6 +171,13 @@ int SubGraphKernel::ReSize() {
       MS_LOG(ERROR) << "kernel(" << kernel->name() << ")'s op_parameter is nullptr!";
       return RET_ERROR;
     }
+    auto saved = shape_states->nodes.find(kernel);
+    if (saved != shape_states->nodes.end()) {
+      if (RestoreNodeShapeState(kernel, saved->second) == RET_OK) {
+        continue;
+      }
+      shape_states->nodes.erase(saved);
+    }
     std::vector<lite::Tensor *> inputs = kernel->in_tensors();
     std::vector<lite::Tensor *> outputs = kernel->out_tensors();
     for (auto &output : outputs) {
@@ -117,12 +194,29 @@ int SubGraphKernel::ReSize() {
                     << schema::EnumNamePrimitiveType(static_cast<schema::PrimitiveType>(kernel->Type()));
       return RET_INFER_ERR;
     }
-    if (ret == RET_OK) {
+    if (ret != RET_OK) {
+      resized_shapes_.erase(kernel);
+      continue;
+    }
+    // tensorlist element shapes are not part of the tensor shape, such kernels are always resized
+    bool has_tensorlist =
+      std::any_of(inputs.begin(), inputs.end(),
+                  [](const lite::Tensor *tensor) { return tensor->data_type() == kObjectTypeTensorType; }) ||
+      std::any_of(outputs.begin(), outputs.end(),
+                  [](const lite::Tensor *tensor) { return tensor->data_type() == kObjectTypeTensorType; });
+    auto shapes = NodeShapes(kernel);
+    auto iter = resized_shapes_.find(kernel);
+    if (has_tensorlist || iter == resized_shapes_.end() || iter->second != shapes) {
       ret = kernel->ReSize();
       if (ret != RET_OK) {
+        resized_shapes_.erase(kernel);
         MS_LOG(ERROR) << "kernel " << kernel->name() << " resize fail!ret = " << ret;
         return ret;
       }
+      resized_shapes_[kernel] = shapes;
+    }
+    if (!has_tensorlist) {
+      SaveNodeShapeState(kernel, shape_states);
     }
   }
   return RET_OK;
@@ -137,6 +231,10 @@ void SubGraphKernel::DropNode(LiteKernel *node) {
   lite::VectorErase(&nodes_, node);
   lite::VectorErase(&in_nodes_, node);
   lite::VectorErase(&out_nodes_, node);
+  resized_shapes_.erase(node);
+  for (auto &states : shape_states_) {
+    states.nodes.erase(node);
+  }
 }
 
 int CpuSubGraph::Prepare() {
@@ -150,6 +248,19 @@ int CpuSubGraph::Prepare() {
       tensor->set_allocator(this->context_->allocator.get());
     }
   }
+  if (static_cast<const lite::InnerContext *>(this->context_)->enable_parallel_ && nodes_.size() > 1) {
+    delete this->executor_;
+    this->executor_ = new (std::nothrow) mindspore::lite::ParallelExecutor();
+    if (this->executor_ == nullptr) {
+      MS_LOG(ERROR) << "new ParallelExecutor failed";
+      return RET_ERROR;
+    }
+    ret = this->executor_->Prepare(this->nodes_);
+    if (ret != RET_OK) {
+      MS_LOG(ERROR) << "Prepare ParallelExecutor failed";
+      return ret;
+    }
+  }
   return RET_OK;
 }
 
@@ -172,6 +283,10 @@ int CpuSubGraph::Run(const KernelCallBack &before, const KernelCallBack &after)
   }
 #endif
 
+  if (this->executor_ != nullptr) {
+    return this->executor_->Run(this->in_tensors_, this->out_tensors_, this->nodes_, this->context_->allocator.get(),
+                                before, after);
+  }
   for (auto *kernel : nodes_) {
     MS_ASSERT(nullptr != kernel);
     auto ret = kernel->PreProcess();
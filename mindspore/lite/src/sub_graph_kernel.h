@@ -18,10 +18,13 @@
 #define MINDSPORE_LITE_SRC_SUB_GRAPH_H
 
 #include <atomic>
+#include <list>
+#include <memory>
 #include <utility>
 #include <string>
 #include <vector>
 #include <map>
+#include <unordered_map>
 #include "src/lite_kernel.h"
 #include "src/executor.h"
 #include "src/common/log_adapter.h"
@@ -112,6 +115,27 @@ class SubGraphKernel : public LiteKernel {
 
   void DropNode(LiteKernel *node);
 
+ protected:
+  // tensor shapes a node was last resized with, ReSize is skipped while they stay the same
+  static std::vector<std::vector<int>> NodeShapes(const LiteKernel *node);
+
+  // output tensors of a node after shape inference and the shape state of its kernel
+  struct NodeShapeState {
+    std::vector<std::vector<int>> out_shapes;
+    std::vector<schema::Format> out_formats;
+    std::vector<TypeId> out_data_types;
+    std::shared_ptr<KernelShapeState> kernel_state;
+  };
+  // node states of one signature of the sub graph input shapes
+  struct ShapeStates {
+    std::vector<std::vector<int>> in_shapes;
+    std::unordered_map<const LiteKernel *, NodeShapeState> nodes;
+  };
+
+  ShapeStates *GetShapeStates();
+  static void SaveNodeShapeState(LiteKernel *node, ShapeStates *states);
+  int RestoreNodeShapeState(LiteKernel *node, const NodeShapeState &state);
+
  protected:
   std::vector<LiteKernel *> nodes_{};
   // entry nodes in nodes
@@ -119,6 +143,9 @@ class SubGraphKernel : public LiteKernel {
   // exit nodes in nodes
   std::vector<LiteKernel *> out_nodes_{};
   mindspore::lite::Executor *executor_ = nullptr;
+  std::unordered_map<const LiteKernel *, std::vector<std::vector<int>>> resized_shapes_;
+  // most recently used signature first
+  std::list<ShapeStates> shape_states_;
 };
 
 class CpuSubGraph : public SubGraphKernel {
@@ -19,6 +19,7 @@
 #include <utility>
 #include <algorithm>
 #include <functional>
+#include <mutex>
 #include "src/tensor.h"
 #include "securec/include/securec.h"
 #include "include/errorcode.h"
@@ -327,7 +328,41 @@ void Tensor::FreeData() {
   }
 }
 
+void Tensor::set_lazy_decoder(const std::function<int(Tensor *)> &decoder) {
+  if (decoder == nullptr) {
+    this->lazy_decode_ = nullptr;
+  } else {
+    this->lazy_decode_ = [this, decoder]() { return decoder(this); };
+  }
+  this->lazy_.store(decoder != nullptr, std::memory_order_release);
+}
+
+int Tensor::DecodeLazyData() const {
+  // the decoder itself reads the tensor, a re-entrance from the decoding thread sees the data filled so far
+  if (this->lazy_decoding_thread_.load(std::memory_order_relaxed) == std::this_thread::get_id()) {
+    return RET_OK;
+  }
+  // kernels of parallel lanes may share a weight, the first reader decodes it and the others wait
+  std::call_once(this->lazy_once_, [this]() {
+    if (this->lazy_decode_ == nullptr) {
+      return;
+    }
+    this->lazy_decoding_thread_.store(std::this_thread::get_id(), std::memory_order_relaxed);
+    this->lazy_ret_ = this->lazy_decode_();
+    this->lazy_decoding_thread_.store(std::thread::id(), std::memory_order_relaxed);
+    this->lazy_decode_ = nullptr;
+    this->lazy_.store(false, std::memory_order_release);
+    if (this->lazy_ret_ != RET_OK) {
+      MS_LOG(ERROR) << "Decode lazy data of tensor " << this->tensor_name_ << " failed: " << this->lazy_ret_;
+    }
+  });
+  return this->lazy_ret_;
+}
+
 void *Tensor::MutableData() {
+  if (IsLazy() && DecodeLazyData() != RET_OK) {
+    return nullptr;
+  }
   if (this->root_tensor_ != nullptr) {
     if (this->root_tensor_ != this && this->root_tensor_->data_ == nullptr) {
       MS_LOG(ERROR) << "root tensor has not been malloced";
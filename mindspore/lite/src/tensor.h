@@ -23,6 +23,8 @@
 #include <numeric>
 #include <functional>
 #include <atomic>
+#include <mutex>
+#include <thread>
 #include "include/ms_tensor.h"
 #include "src/runtime/allocator.h"
 
@@ -113,12 +115,20 @@ class Tensor : public mindspore::tensor::MSTensor {
 
   void *MutableData() override;
 
-  void *data() override { return this->data_; }
+  void *data() override {
+    if (IsLazy() && DecodeLazyData() != 0) {
+      return nullptr;
+    }
+    return this->data_;
+  }
 
   virtual void *data_c() const {
     if (this->root_tensor_ != nullptr) {
       return this->root_tensor_->data_;
     }
+    if (IsLazy() && DecodeLazyData() != 0) {
+      return nullptr;
+    }
     return data_;
   }
 
@@ -160,10 +170,18 @@ class Tensor : public mindspore::tensor::MSTensor {
   void set_quant_clusters(const std::vector<float> &clusters);
 
   virtual bool IsConst() const {
-    return (this->category_ == CONST_TENSOR || this->category_ == CONST_SCALAR) && this->data_ != nullptr;
+    return (this->category_ == CONST_TENSOR || this->category_ == CONST_SCALAR) &&
+           (this->data_ != nullptr || IsLazy());
   }
 
-  bool IsScalar() const { return this->category_ == CONST_SCALAR && this->data_ != nullptr; }
+  bool IsScalar() const { return this->category_ == CONST_SCALAR && (this->data_ != nullptr || IsLazy()); }
+
+  // const data left encoded in the model, decoder fills the tensor the first time its data is read. Set at most once.
+  void set_lazy_decoder(const std::function<int(Tensor *)> &decoder);
+
+  bool IsLazy() const { return this->lazy_.load(std::memory_order_acquire); }
+
+  int DecodeLazyData() const;
 
   bool IsGraphInput() const { return this->category_ == GRAPH_INPUT; }
 
@@ -215,6 +233,11 @@ class Tensor : public mindspore::tensor::MSTensor {
   mindspore::Allocator *allocator_ = nullptr;
   Tensor *root_tensor_ = nullptr;
   bool own_data_{false};
+  mutable std::function<int()> lazy_decode_;
+  mutable std::atomic_bool lazy_{false};
+  mutable std::once_flag lazy_once_;
+  mutable std::atomic<std::thread::id> lazy_decoding_thread_;
+  mutable int lazy_ret_ = 0;
 };
 
 inline size_t DataTypeSize(const TypeId type) {
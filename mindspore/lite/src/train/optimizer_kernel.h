@@ -15,6 +15,7 @@
  */
 #ifndef MINDSPORE_LITE_SRC_TRAIN_OPTIMIZER_KERNEL_H_
 #define MINDSPORE_LITE_SRC_TRAIN_OPTIMIZER_KERNEL_H_
+#include <algorithm>
 #include <vector>
 #include "src/lite_kernel.h"
 #include "include/errorcode.h"
@@ -29,7 +30,7 @@ class OptimizerKernel : public LiteKernel {
   OptimizerKernel(OpParameter *parameter, const std::vector<lite::Tensor *> &inputs,
                   const std::vector<lite::Tensor *> &outputs, const lite::InnerContext *ctx, int lr_idx, int grad_idx)
       : LiteKernel(parameter, inputs, outputs, ctx), lr_idx_(lr_idx), grad_idx_(grad_idx) {}
-  ~OptimizerKernel() = default;
+  ~OptimizerKernel() override { FreeGradSum(); }
 
   enum class WeightUpdateMode { NORMAL, VIRTUAL_BATCH };
   WeightUpdateMode get_optimizer_mode() { return weight_update_mod_; }
@@ -54,30 +55,48 @@ class OptimizerKernel : public LiteKernel {
 
   int SetOptimizerMode(WeightUpdateMode mod) {
     if (mod == WeightUpdateMode::VIRTUAL_BATCH) {
-      if (grad_sum_ != nullptr) {
-        context_->allocator->Free(grad_sum_);
-        grad_sum_ = nullptr;
-      }
-      size_t size = in_tensors_.at(grad_idx_)->Size();
-      size_t elem_num = in_tensors_.at(grad_idx_)->ElementsNum();
-      grad_sum_ = reinterpret_cast<float *>(context_->allocator->Malloc(size));
-      if (grad_sum_ == nullptr) {
-        MS_LOG(ERROR) << "failed to malloc grad sum tensor, size=" << size;
-        return RET_ERROR;
+      FreeGradSum();
+      // optimizers keeping a per weight state sum the gradients into it, no extra buffer is needed
+      grad_sum_ = InplaceGradSum();
+      grad_sum_in_place_ = (grad_sum_ != nullptr);
+      if (!grad_sum_in_place_) {
+        size_t size = in_tensors_.at(grad_idx_)->Size();
+        size_t elem_num = in_tensors_.at(grad_idx_)->ElementsNum();
+        grad_sum_ = reinterpret_cast<float *>(context_->allocator->Malloc(size));
+        if (grad_sum_ == nullptr) {
+          MS_LOG(ERROR) << "failed to malloc grad sum tensor, size=" << size;
+          return RET_ERROR;
+        }
+        std::fill(grad_sum_, grad_sum_ + elem_num, 0);
       }
       valid_grad_sum_ = false;
-      std::fill(grad_sum_, grad_sum_ + elem_num, 0);
       weight_update_mod_ = WeightUpdateMode::VIRTUAL_BATCH;
     } else {
       if (grad_sum_ != nullptr) {
         OptimizerStep();
-        context_->allocator->Free(grad_sum_);
-        grad_sum_ = nullptr;
+        FreeGradSum();
       }
+      weight_update_mod_ = WeightUpdateMode::NORMAL;
     }
     return RET_OK;
   }
 
+  int PreProcess() override {
+    if (weight_update_mod_ == WeightUpdateMode::VIRTUAL_BATCH) {
+      sum_decay_ = 1.0f;
+      sum_scale_ = 1.0f;
+      GetGradSumFactors(valid_grad_sum_ ? nullptr : &sum_decay_, &sum_scale_);
+    }
+    return LiteKernel::PreProcess();
+  }
+
+  int PostProcess() override {
+    if (weight_update_mod_ == WeightUpdateMode::VIRTUAL_BATCH) {
+      valid_grad_sum_ = true;
+    }
+    return LiteKernel::PostProcess();
+  }
+
   int ExecuteVirtualBatch(int task_id) {
     auto gradient = reinterpret_cast<float *>(in_tensors_.at(grad_idx_)->MutableData());
     int length = in_tensors_.at(grad_idx_)->ElementsNum();
@@ -87,9 +106,8 @@ class OptimizerKernel : public LiteKernel {
     int start = stride * task_id;
     int end = start + count;
     for (int i = start; i < end; ++i) {
-      grad_sum_[i] += gradient[i];
+      grad_sum_[i] = grad_sum_[i] * sum_decay_ + gradient[i] * sum_scale_;
     }
-    valid_grad_sum_ = true;
     return RET_OK;
   }
 
@@ -103,6 +121,26 @@ class OptimizerKernel : public LiteKernel {
     return LiteKernel::Eval();
   }
 
+ protected:
+  // optimizer state buffer the gradients of a virtual batch may be summed into, nullptr if there is none
+  virtual float *InplaceGradSum() { return nullptr; }
+
+  // factors applied to the sum on the first micro batch (decay) and to every gradient (scale),
+  // a separate buffer starts from zero
+  virtual void GetGradSumFactors(float *decay, float *scale) {
+    if (decay != nullptr) {
+      *decay = 0.0f;
+    }
+  }
+
+  void FreeGradSum() {
+    if (grad_sum_ != nullptr && !grad_sum_in_place_) {
+      context_->allocator->Free(grad_sum_);
+    }
+    grad_sum_ = nullptr;
+    grad_sum_in_place_ = false;
+  }
+
  protected:
   float default_lr_ = 0.0f;
   float lr_ = 0.0f;
@@ -110,6 +148,9 @@ class OptimizerKernel : public LiteKernel {
   int grad_idx_ = 0;
   float *grad_sum_ = nullptr;
   bool valid_grad_sum_ = false;
+  bool grad_sum_in_place_ = false;
+  float sum_decay_ = 1.0f;
+  float sum_scale_ = 1.0f;
 
  private:
   WeightUpdateMode weight_update_mod_ = WeightUpdateMode::NORMAL;
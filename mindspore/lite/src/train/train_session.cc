@@ -17,11 +17,15 @@
 #include "src/train/train_session.h"
 #include <sys/stat.h>
 #include <algorithm>
+#include <cstdint>
 #include <utility>
 #include <vector>
 #include <iostream>
 #include <fstream>
 #include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
 #include "include/errorcode.h"
 #include "src/common/utils.h"
 #include "src/tensor.h"
@@ -42,8 +46,23 @@
 
 namespace mindspore {
 namespace lite {
+namespace {
+// the public TrainSession is a virtual base, which can not be cast down without rtti
+std::mutex g_sessions_lock;
+std::unordered_map<const session::TrainSession *, TrainSession *> g_sessions;
+}  // namespace
+
+TrainSession *TrainSession::FromSession(const session::TrainSession *session) {
+  std::lock_guard<std::mutex> lock(g_sessions_lock);
+  auto iter = g_sessions.find(session);
+  return iter == g_sessions.end() ? nullptr : iter->second;
+}
 
 TrainSession::TrainSession() {
+  {
+    std::lock_guard<std::mutex> lock(g_sessions_lock);
+    g_sessions[static_cast<session::TrainSession *>(this)] = this;
+  }
   is_train_session_ = true;
 #ifdef ENABLE_V0
   if (VersionManager::GetInstance()->CheckV0Schema()) {
@@ -90,6 +109,9 @@ int TrainSession::CompileGraph(lite::Model *model) { return lite::RET_ERROR; }
 
 int TrainSession::CompileTrainGraph(mindspore::lite::Model *model) {
   model_ = model;
+  // the graph is compiled again with fresh ref counts, the old plan refers to the old kernels
+  recompute_extra_refs_.clear();
+  ResetRecompute();
 
   auto restore = ReplaceOps();
   auto ret = lite::LiteSession::CompileGraph(model);
@@ -109,10 +131,14 @@ int TrainSession::CompileTrainGraph(mindspore::lite::Model *model) {
   CompileInferenceKernels();  // Prepare a list of eval kernels
   AllocWorkSpace();
 
-  return RET_OK;
+  return RebuildRecompute();
 }
 
 TrainSession::~TrainSession() {
+  {
+    std::lock_guard<std::mutex> lock(g_sessions_lock);
+    g_sessions.erase(static_cast<session::TrainSession *>(this));
+  }
   mindspore::kernel::LiteKernel::FreeWorkspace();
   if (model_ != nullptr) {
     delete model_;
@@ -135,6 +161,10 @@ int TrainSession::RunGraph(const KernelCallBack &before, const KernelCallBack &a
     return lite::RET_NULL_PTR;
   }
   auto run_kernel = (train_mode_) ? train_kernels_ : inference_kernels_;
+  bool recompute = train_mode_ && !recompute_run_kernels_.empty();
+  if (recompute) {
+    run_kernel = recompute_run_kernels_;
+  }
 
   auto ret = CheckTensorsInvalid(inputs_);
   if (ret != RET_OK) {
@@ -142,7 +172,8 @@ int TrainSession::RunGraph(const KernelCallBack &before, const KernelCallBack &a
     return ret;
   }
 
-  for (auto *kernel : run_kernel) {
+  for (size_t i = 0; i < run_kernel.size(); i++) {
+    auto *kernel = run_kernel[i];
     MS_ASSERT(nullptr != kernel);
     ret = kernel->PreProcess();
     if (RET_OK != ret) {
@@ -159,6 +190,15 @@ int TrainSession::RunGraph(const KernelCallBack &before, const KernelCallBack &a
       MS_LOG(ERROR) << "PostProcess kernel failed, name: " << kernel->name();
       return ret;
     }
+    if (recompute) {
+      // a recomputed tensor only lives until the next time it is produced
+      for (auto &item : recompute_ref_counts_[i]) {
+        item.first->set_ref_count(item.second);
+        if (item.second == 0) {
+          item.first->FreeData();
+        }
+      }
+    }
   }
 
   if (train_mode_ && virtual_batch_multiplier_) {
@@ -424,6 +464,207 @@ int TrainSession::OptimizerStep() {
   return RET_OK;
 }
 
+int TrainSession::SetupRecompute(int segment_num) {
+  recompute_segment_num_ = (segment_num < 1) ? 0 : segment_num;
+  auto ret = RebuildRecompute();
+  if (ret != RET_OK) {
+    recompute_segment_num_ = 0;
+  }
+  return ret;
+}
+
+int TrainSession::RebuildRecompute() {
+  // the plan depends on the kernels and the outputs, it is always built again from the plain ref counts
+  ResetRecompute();
+  if (recompute_segment_num_ == 0) {
+    return RET_OK;
+  }
+  auto ret = CompileRecomputeKernels(static_cast<size_t>(recompute_segment_num_));
+  if (ret != RET_OK) {
+    MS_LOG(ERROR) << "failed to setup recompute with " << recompute_segment_num_ << " segments";
+    ResetRecompute();
+  }
+  return ret;
+}
+
+void TrainSession::ResetRecompute() {
+  for (auto &item : recompute_extra_refs_) {
+    item.first->set_init_ref_count(item.first->init_ref_count() - item.second);
+  }
+  recompute_extra_refs_.clear();
+  recompute_run_kernels_.clear();
+  recompute_ref_counts_.clear();
+}
+
+int TrainSession::CompileRecomputeKernels(size_t segment_num) {
+  auto kernel_num = train_kernels_.size();
+  std::unordered_map<lite::Tensor *, std::vector<size_t>> consumers;
+  size_t first_grad = kernel_num;
+  for (size_t i = 0; i < kernel_num; i++) {
+    auto kernel = train_kernels_[i];
+    if (first_grad == kernel_num && IsGradKernel(kernel)) {
+      first_grad = i;
+    }
+    for (auto in : kernel->in_tensors()) {
+      consumers[in].push_back(i);
+    }
+  }
+  std::vector<size_t> forward;
+  for (size_t i = 0; i < first_grad; i++) {
+    if (!IsLossKernel(train_kernels_[i]) && !IsOptimizer(train_kernels_[i])) {
+      forward.push_back(i);
+    }
+  }
+  if (first_grad == kernel_num || forward.empty()) {
+    MS_LOG(ERROR) << "no forward and backward kernels to recompute between";
+    return RET_ERROR;
+  }
+  segment_num = std::min(segment_num, forward.size());
+  std::vector<size_t> segment_of(kernel_num, SIZE_MAX);
+  for (size_t j = 0; j < forward.size(); j++) {
+    segment_of[forward[j]] = j * segment_num / forward.size();
+  }
+  // outputs are read by the user after the run and are never dropped
+  std::unordered_set<lite::Tensor *> outputs;
+  for (auto *map : {&orig_output_tensor_map_, &train_output_tensor_map_, &eval_output_tensor_map_}) {
+    for (auto &item : *map) {
+      outputs.insert(static_cast<lite::Tensor *>(item.second));
+    }
+  }
+  auto droppable = [&](lite::Tensor *tensor, size_t segment) {
+    if (outputs.find(tensor) != outputs.end() || tensor->IsConst() || tensor->IsGraphInput()) {
+      return false;
+    }
+    auto &users = consumers[tensor];
+    return std::all_of(users.begin(), users.end(), [&](size_t user) {
+      return segment_of[user] == segment || IsGradKernel(train_kernels_[user]);
+    });
+  };
+
+  std::vector<std::vector<size_t>> inserted(kernel_num + 1);
+  size_t recompute_num = 0;
+  for (size_t segment = 0; segment < segment_num; segment++) {
+    std::vector<size_t> drop_kernels;
+    for (auto i : forward) {
+      auto &outs = train_kernels_[i]->out_tensors();
+      if (segment_of[i] == segment && IsRecomputable(train_kernels_[i]) &&
+          std::all_of(outs.begin(), outs.end(), [&](lite::Tensor *out) { return droppable(out, segment); })) {
+        drop_kernels.push_back(i);
+      }
+    }
+    // only the kernels producing what the backward kernels read, directly or through other dropped kernels
+    std::unordered_set<lite::Tensor *> needed;
+    for (auto i : drop_kernels) {
+      for (auto out : train_kernels_[i]->out_tensors()) {
+        auto &users = consumers[out];
+        if (std::any_of(users.begin(), users.end(), [&](size_t user) { return IsGradKernel(train_kernels_[user]); })) {
+          needed.insert(out);
+        }
+      }
+    }
+    std::vector<size_t> recompute;
+    for (auto iter = drop_kernels.rbegin(); iter != drop_kernels.rend(); iter++) {
+      auto &outs = train_kernels_[*iter]->out_tensors();
+      if (std::none_of(outs.begin(), outs.end(), [&](lite::Tensor *out) { return needed.count(out) > 0; })) {
+        continue;
+      }
+      recompute.insert(recompute.begin(), *iter);
+      for (auto in : train_kernels_[*iter]->in_tensors()) {
+        needed.insert(in);
+      }
+    }
+    if (recompute.empty()) {
+      continue;
+    }
+    // right before the first backward kernel reading the segment, and before its weights are updated
+    size_t position = kernel_num;
+    for (auto i : recompute) {
+      for (auto out : train_kernels_[i]->out_tensors()) {
+        for (auto user : consumers[out]) {
+          if (IsGradKernel(train_kernels_[user])) {
+            position = std::min(position, user);
+          }
+        }
+      }
+      for (auto in : train_kernels_[i]->in_tensors()) {
+        for (auto user : consumers[in]) {
+          if (IsOptimizer(train_kernels_[user])) {
+            position = std::min(position, user);
+          }
+        }
+      }
+    }
+    inserted[position].insert(inserted[position].end(), recompute.begin(), recompute.end());
+    recompute_num += recompute.size();
+  }
+  if (recompute_num == 0) {
+    MS_LOG(INFO) << "no activation can be recomputed";
+    return RET_OK;
+  }
+
+  std::vector<bool> is_recompute;
+  for (size_t i = 0; i <= kernel_num; i++) {
+    for (auto index : inserted[i]) {
+      recompute_run_kernels_.push_back(train_kernels_[index]);
+      is_recompute.push_back(true);
+    }
+    if (i < kernel_num) {
+      recompute_run_kernels_.push_back(train_kernels_[i]);
+      is_recompute.push_back(false);
+    }
+  }
+  auto run_num = recompute_run_kernels_.size();
+  std::unordered_map<lite::Tensor *, std::vector<size_t>> producers;
+  for (size_t i = 0; i < run_num; i++) {
+    for (auto out : recompute_run_kernels_[i]->out_tensors()) {
+      producers[out].push_back(i);
+    }
+  }
+  recompute_ref_counts_.resize(run_num);
+  for (auto &item : producers) {
+    auto &positions = item.second;
+    if (positions.size() < 2) {
+      continue;
+    }
+    for (size_t k = 0; k < positions.size(); k++) {
+      auto end = (k + 1 < positions.size()) ? positions[k + 1] : run_num;
+      size_t uses = 0;
+      for (auto i = positions[k] + 1; i < end; i++) {
+        auto &ins = recompute_run_kernels_[i]->in_tensors();
+        uses += std::count(ins.begin(), ins.end(), item.first);
+      }
+      recompute_ref_counts_[positions[k]].emplace_back(item.first, uses);
+    }
+  }
+  // the inputs of the recomputed kernels which are not recomputed themselves must live until then
+  std::unordered_map<lite::Tensor *, size_t> extra_refs;
+  for (size_t i = 0; i < run_num; i++) {
+    if (!is_recompute[i]) {
+      continue;
+    }
+    for (auto in : recompute_run_kernels_[i]->in_tensors()) {
+      if (producers[in].size() < 2) {
+        extra_refs[in]++;
+      }
+    }
+  }
+  for (auto &item : extra_refs) {
+    item.first->set_init_ref_count(item.first->init_ref_count() + item.second);
+    recompute_extra_refs_.emplace_back(item.first, item.second);
+  }
+  MS_LOG(INFO) << "recompute " << recompute_num << " of " << forward.size() << " forward kernels in " << segment_num
+               << " segments";
+  return RET_OK;
+}
+
+bool TrainSession::IsRecomputable(kernel::LiteKernel *kernel) const {
+  // batchnorm updates its moving statistics and dropout draws a new mask every time it runs
+  // and assign ops write their first input in place
+  return !IsLossKernel(kernel) && !IsGradKernel(kernel) && !IsMaskOutput(kernel) && !IsBN(kernel) &&
+         kernel->Type() != schema::PrimitiveType_Dropout && kernel->Type() != schema::PrimitiveType_Assign &&
+         kernel->Type() != schema::PrimitiveType_AssignAdd;
+}
+
 bool TrainSession::IsLossKernel(const kernel::LiteKernel *kernel) const {
   return (kernel->Type() == schema::PrimitiveType_SoftmaxCrossEntropyWithLogits ||
           kernel->Type() == schema::PrimitiveType_SparseSoftmaxCrossEntropyWithLogits ||
@@ -461,7 +702,8 @@ int TrainSession::SetLossName(std::string loss_name) {
     output_tensor_map_ = eval_output_tensor_map_;
     output_tensor_names_ = eval_output_tensor_names_;
   }
-  return RET_OK;
+  // eval outputs are never dropped, so they change what can be recomputed
+  return RebuildRecompute();
 }
 
 int TrainSession::ExportInference(std::string file_name) {
@@ -475,6 +717,15 @@ int TrainSession::ExportInference(std::string file_name) {
 
 }  // namespace lite
 
+int session::TrainSession::SetupRecompute(int segment_num) {
+  auto session = lite::TrainSession::FromSession(this);
+  if (session == nullptr) {
+    MS_LOG(ERROR) << "recompute is only supported by the sessions created by TrainSession";
+    return lite::RET_NOT_SUPPORT;
+  }
+  return session->SetupRecompute(segment_num);
+}
+
 session::TrainSession *session::TrainSession::CreateSession(mindspore::lite::Model *model, lite::Context *context,
                                                             bool train_mode) {
   auto session = new (std::nothrow) lite::TrainSession();
@@ -18,6 +18,7 @@
 #include <vector>
 #include <string>
 #include <tuple>
+#include <utility>
 #include <unordered_map>
 #include <memory>
 #include "include/train/train_session.h"
@@ -59,6 +60,11 @@ class TrainSession : virtual public session::TrainSession, virtual public lite::
   float GetLearningRate() override;
   int SetupVirtualBatch(int virtual_batch_multiplier, float lr = -1.0f, float momentum = -1.0f) override;
   int SetLossName(std::string loss_name) override;
+  // split the forward kernels into segment_num segments whose activations read by gradient kernels are freed after
+  // the forward pass and recomputed before the backward pass, use any number < 1 to disable
+  int SetupRecompute(int segment_num);
+  // the session implementing a public TrainSession, nullptr if it was not created by lite
+  static TrainSession *FromSession(const session::TrainSession *session);
 
   void BindThread(bool if_bind) override { return lite::LiteSession::BindThread(if_bind); }
   std::vector<tensor::MSTensor *> GetInputs() const override { return lite::LiteSession::GetInputs(); }
@@ -96,6 +102,7 @@ class TrainSession : virtual public session::TrainSession, virtual public lite::
   bool IsOptimizer(kernel::LiteKernel *kernel) const;
   bool IsMaskOutput(kernel::LiteKernel *kernel) const;
   bool IsBN(kernel::LiteKernel *kernel) const;
+  bool IsRecomputable(kernel::LiteKernel *kernel) const;
 
   virtual std::vector<CreatorOp> ReplaceOps();
   virtual void RestoreOps(const std::vector<CreatorOp> &restore);
@@ -125,8 +132,18 @@ class TrainSession : virtual public session::TrainSession, virtual public lite::
   void BuildInferenceKernelsRecursive(kernel::LiteKernel *ker, std::vector<kernel::LiteKernel *> *req_kernels);
   int AdminSetupVirtualBatch(int virtual_batch_multiplier, float lr, float momentum);
   int OptimizerStep();
+  int CompileRecomputeKernels(size_t segment_num);
+  void ResetRecompute();
+  int RebuildRecompute();
   int virtual_batch_idx_ = 0;
   int virtual_batch_multiplier_ = 0;
+  int recompute_segment_num_ = 0;
+  // train kernels with the recomputed forward kernels inserted before the backward kernels using them
+  std::vector<kernel::LiteKernel *> recompute_run_kernels_;
+  // ref counts of the tensors produced more than once, set after the kernel at the same position in the run list
+  std::vector<std::vector<std::pair<lite::Tensor *, size_t>>> recompute_ref_counts_;
+  // uses added to the init ref count of the tensors read by the recomputed kernels
+  std::vector<std::pair<lite::Tensor *, size_t>> recompute_extra_refs_;
 };
 
 }  // namespace lite
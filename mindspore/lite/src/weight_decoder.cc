@@ -18,6 +18,7 @@
 #include <memory>
 #include "src/weight_decoder.h"
 #include "src/huffman_decode.h"
+#include "nnacl/fp32/sparse_matmul_fp32.h"
 
 namespace mindspore::lite {
 std::vector<bool> StringToBitVector(const std::string &str) {
@@ -181,6 +182,29 @@ STATUS SparseDecompress(const schema::Tensor &src_tensor, Tensor *dst_tensor) {
   return RET_OK;
 }
 
+STATUS BlockSparseDecompress(const schema::Tensor &src_tensor, Tensor *dst_tensor) {
+  if (dst_tensor->data_type() != kNumberTypeFloat32 || dst_tensor->shape().empty()) {
+    MS_LOG(ERROR) << "block sparse weight should be a fp32 tensor with shape";
+    return RET_ERROR;
+  }
+  int col = dst_tensor->shape().front();
+  int deep = dst_tensor->ElementsNum() / MSMAX(col, 1);
+  dst_tensor->set_data(nullptr);
+  auto ret = dst_tensor->MallocData();
+  if (ret != RET_OK) {
+    MS_LOG(ERROR) << "Malloc tensor data failed";
+    return RET_NULL_PTR;
+  }
+  ret = UnpackBlockSparse(src_tensor.data()->data(), src_tensor.data()->size(),
+                          reinterpret_cast<float *>(dst_tensor->data_c()), col, deep);
+  if (ret != NNACL_OK) {
+    MS_LOG(ERROR) << "invalid block sparse weight of " << dst_tensor->tensor_name();
+    dst_tensor->FreeData();
+    return RET_ERROR;
+  }
+  return RET_OK;
+}
+
 int WeightDecoder::DequantWeight(lite::Tensor *input_tensor, bool channel_first, TypeId dst_data_type) {
   MS_ASSERT(input_tensor != nullptr);
   if (input_tensor->data_type() != kNumberTypeInt8 && input_tensor->data_type() != kNumberTypeInt16) {
@@ -229,6 +253,57 @@ int WeightDecoder::DequantWeight(lite::Tensor *input_tensor, bool channel_first,
   return RET_OK;
 }
 
+bool WeightDecoder::NeedBitUnpack(const schema::Tensor &src_tensor) {
+  bool need_bit_unpack = src_tensor.quantParams() != nullptr && src_tensor.quantParams()->size() > 0 &&
+                         src_tensor.quantParams()->Get(0) != nullptr && src_tensor.quantParams()->Get(0)->inited();
+  if (need_bit_unpack) {
+    auto num_bits = src_tensor.quantParams()->Get(0)->numBits();
+    need_bit_unpack = ((num_bits > 0 && num_bits < 8) || (num_bits > 8 && num_bits < 16));
+  }
+  return need_bit_unpack;
+}
+
+bool WeightDecoder::IsCompressed(const schema::Tensor &src_tensor) {
+  return src_tensor.weightQunatCompressType() == schema::WeightQunatCompressType_INDEXING ||
+         src_tensor.weightQunatCompressType() == schema::WeightQunatCompressType_SPARSE ||
+         src_tensor.weightQunatCompressType() == schema::WeightQunatCompressType_BLOCK_SPARSE ||
+         src_tensor.enableHuffmanCode() || NeedBitUnpack(src_tensor);
+}
+
+int WeightDecoder::DecompressTensor(const schema::Tensor &src_tensor, Tensor *dst_tensor) {
+  MS_ASSERT(dst_tensor != nullptr);
+  if (src_tensor.weightQunatCompressType() == schema::WeightQunatCompressType_INDEXING) {
+    return IndexingDecompress(src_tensor, dst_tensor);
+  } else if (src_tensor.weightQunatCompressType() == schema::WeightQunatCompressType_SPARSE) {
+    return SparseDecompress(src_tensor, dst_tensor);
+  } else if (src_tensor.weightQunatCompressType() == schema::WeightQunatCompressType_BLOCK_SPARSE) {
+    return BlockSparseDecompress(src_tensor, dst_tensor);
+  }
+
+  bool need_bit_unpack = NeedBitUnpack(src_tensor);
+  if (!src_tensor.enableHuffmanCode() && !need_bit_unpack) {
+    return RET_NO_CHANGE;
+  }
+  // huffman code and bit pack are not assumed to be performed at same time
+  STATUS ret = RET_ERROR;
+  if (src_tensor.enableHuffmanCode()) {
+    ret = DecodeHuffmanCode(src_tensor, dst_tensor);
+    if (ret != RET_OK && ret != RET_NO_CHANGE) {
+      MS_LOG(ERROR) << "Decode huffman code failed: " << ret;
+      return ret;
+    }
+  } else if (need_bit_unpack) {
+    ret = UnPackToInt(src_tensor, dst_tensor);
+    if (ret != RET_OK && ret != RET_NO_CHANGE) {
+      MS_LOG(ERROR) << "Unpack to int8 failed: " << ret;
+      return ret;
+    }
+  } else {
+    ret = RET_OK;
+  }
+  return ret;
+}
+
 int WeightDecoder::DecodeHuffmanCode(const schema::Tensor &src_tensor, lite::Tensor *dst_tensor) {
   MS_ASSERT(dst_tensor != nullptr);
   if (!dst_tensor->IsConst() || !src_tensor.enableHuffmanCode()) {
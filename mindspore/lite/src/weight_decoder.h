@@ -122,6 +122,11 @@ STATUS IndexingDecompress(const schema::Tensor &src_tensor, Tensor *dst_tensor);
 
 class WeightDecoder {
  public:
+  static bool IsCompressed(const schema::Tensor &src_tensor);
+
+  // decode src_tensor into dst_tensor, RET_NO_CHANGE means the data can be used as it is
+  static int DecompressTensor(const schema::Tensor &src_tensor, Tensor *dst_tensor);
+
   static int UnPackToInt(const schema::Tensor &src_tensor, lite::Tensor *dst_tensor);
 
   static int DecodeHuffmanCode(const schema::Tensor &src_tensor, lite::Tensor *dst_tensor);
@@ -131,6 +136,8 @@ class WeightDecoder {
  private:
   static int DequantTensor(Tensor *tensor, bool channel_first = true, TypeId dst_data_type = kNumberTypeFloat32);
 
+  static bool NeedBitUnpack(const schema::Tensor &src_tensor);
+
   template <typename ST, typename DT = float>
   static DT *DequantData(lite::Tensor *input_tensor, bool channel_first = true) {
     const auto *quant_datas = static_cast<const ST *>(input_tensor->data_c());
@@ -0,0 +1,147 @@
+#!/bin/bash
+
+# Print start msg after run testcase
+function MS_PRINT_TESTCASE_END_MSG() {
+    echo -e "-----------------------------------------------------------------------------------------------------------------------------------"
+}
+
+# Print start msg before run testcase
+function MS_PRINT_TESTCASE_START_MSG() {
+    echo ""
+    echo -e "-----------------------------------------------------------------------------------------------------------------------------------"
+    echo -e "env                  Testcase                                                                                             Result   "
+    echo -e "---                  --------                                                                                             ------   "
+}
+
+function Print_Selective_Result() {
+    MS_PRINT_TESTCASE_START_MSG
+    while read line; do
+        arr=("${line}")
+        printf "%-20s %-100s %-7s\n" ${arr[0]} ${arr[1]} ${arr[2]}
+    done < "${run_selective_result}"
+    MS_PRINT_TESTCASE_END_MSG
+}
+
+# best time of 5 fresh processes to dlopen a library, which covers relocations and static constructors
+function Load_time_us() {
+    python3 -c "
+import subprocess, sys
+best = min(int(subprocess.check_output([sys.executable, '-c',
+    'import ctypes, time; t = time.perf_counter(); ctypes.CDLL(\"' + sys.argv[1] + '\"); '
+    'print(int((time.perf_counter() - t) * 1e6))'])) for _ in range(5))
+print(best)" "$1"
+}
+
+function Check_result() {
+    if [ $1 = 0 ]; then
+        echo "$2 pass" >> "${run_selective_result}"
+    else
+        echo "$2 failed" >> "${run_selective_result}"; return 1
+    fi
+}
+
+function Run_selective_build() {
+    cd "${x86_path}" || exit 1
+    tar -zxf mindspore-lite-${version}-inference-linux-x64.tar.gz || exit 1
+    local full_path=${x86_path}/mindspore-lite-${version}-inference-linux-x64
+    local full_lib=${full_path}/inference/lib/libmindspore-lite.so
+
+    while read line; do
+        if [[ ${line} == \#* || -z ${line} ]]; then
+            continue
+        fi
+        model_name=${line}
+        local build_path=${selective_test_path}/${model_name}
+        mkdir -p "${build_path}" || exit 1
+        cd "${build_path}" || exit 1
+
+        ${full_path}/tools/cropper/cropper --modelFile=${models_path}/${model_name}.ms --opsFile=./selected_ops.txt \
+            >> "${run_selective_log_file}"
+        Check_result $? "write_ops: ${model_name}" || return 1
+
+        cmake -DMSLITE_SELECTED_OPS_FILE=${build_path}/selected_ops.txt -DCMAKE_BUILD_TYPE=Release -DENABLE_TOOLS=on \
+            -DSUPPORT_TRAIN=off -DBUILD_MINDDATA=off -DX86_64_SIMD=off ${lite_source_path} >> "${run_selective_log_file}" \
+            && make -j$(nproc) mindspore-lite benchmark >> "${run_selective_log_file}"
+        Check_result $? "build: ${model_name}" || return 1
+
+        # nothing but the MS_API interface and the logger may be exported, nnacl and the kernels have to be gone
+        local selective_lib=${build_path}/src/libmindspore-lite.so
+        local leaked=$(nm -D --defined-only ${selective_lib} | awk '$2 ~ /[TWtw]/ && $3 !~ /^_Z/ && $3 !~ /^_(init|fini)$/')
+        leaked=${leaked}$(nm -DC --defined-only ${selective_lib} | grep -E "mindspore::kernel::|mindspore::lite::LiteSession::")
+        [ -z "${leaked}" ]
+        Check_result $? "exported_symbols: ${model_name}" || { echo "${leaked}" >> "${run_selective_log_file}"; return 1; }
+
+        local full_size=$(stat -c %s ${full_lib})
+        local selective_size=$(stat -c %s ${selective_lib})
+        local full_exports=$(nm -D --defined-only ${full_lib} | wc -l)
+        local selective_exports=$(nm -D --defined-only ${selective_lib} | wc -l)
+        echo "${model_name}: size ${full_size} -> ${selective_size} bytes, exports ${full_exports} -> ${selective_exports}, load $(Load_time_us ${full_lib}) -> $(Load_time_us ${selective_lib}) us" >> "${run_selective_perf_file}"
+        [ ${selective_size} -lt ${full_size} ]
+        Check_result $? "size: ${model_name}" || return 1
+
+        # the startup of the model, PrepareTime, is logged by both benchmarks
+        for build in full selective; do
+            local bench=${full_path}/tools/benchmark/benchmark
+            if [ ${build} = selective ]; then
+                bench=${build_path}/tools/benchmark/benchmark
+            fi
+            LD_LIBRARY_PATH=${full_path}/inference/lib ${bench} --modelFile=${models_path}/${model_name}.ms \
+                --inDataFile=${models_path}/input_output/input/${model_name}.ms.bin \
+                --benchmarkDataFile=${models_path}/input_output/output/${model_name}.ms.out > ./benchmark_log.txt
+            Check_result $? "run_benchmark: ${model_name}_${build}" || { cat ./benchmark_log.txt >> "${run_selective_log_file}"; return 1; }
+            echo "${model_name} ${build}: $(grep -E 'PrepareTime|AvgRunTime' ./benchmark_log.txt | tr '\n' ' ')" >> "${run_selective_perf_file}"
+        done
+    done < ${models_selective_config}
+}
+
+basepath=$(pwd)
+echo "${basepath}"
+
+# Example:sh run_selective_build.sh -r /home/temp_test -m /home/temp_test/models -s /home/mindspore/mindspore/lite
+# the models folder holds the converted .ms models and their input_output data as run_benchmark_nets.sh leaves them
+while getopts "r:m:s:" opt; do
+    case ${opt} in
+        r)
+            release_path=${OPTARG}
+            echo "release_path is ${OPTARG}"
+            ;;
+        m)
+            models_path=${OPTARG}
+            echo "models_path is ${OPTARG}"
+            ;;
+        s)
+            lite_source_path=${OPTARG}
+            echo "lite_source_path is ${OPTARG}"
+            ;;
+        ?)
+        echo "unknown para"
+        exit 1;;
+    esac
+done
+
+x86_path=${release_path}/ubuntu_x86
+file_name=$(ls ${x86_path}/*inference-linux-x64.tar.gz)
+IFS="-" read -r -a file_name_array <<< "$file_name"
+version=${file_name_array[2]}
+
+models_selective_config=${basepath}/models_selective.cfg
+selective_test_path=${basepath}/selective_test
+rm -rf "${selective_test_path}"
+mkdir -p "${selective_test_path}"
+
+run_selective_result=${basepath}/run_selective_result.txt
+run_selective_log_file=${basepath}/run_selective_log.txt
+run_selective_perf_file=${basepath}/run_selective_perf.txt
+echo ' ' > "${run_selective_result}"
+echo ' ' > "${run_selective_log_file}"
+echo ' ' > "${run_selective_perf_file}"
+
+Run_selective_build
+Run_selective_build_status=$?
+Print_Selective_Result
+cat "${run_selective_perf_file}"
+if [[ ${Run_selective_build_status} != 0 ]]; then
+    echo "Run_selective_build failed"
+    cat "${run_selective_log_file}"
+fi
+exit ${Run_selective_build_status}
@@ -0,0 +1,101 @@
+#!/bin/bash
+
+# Compare the transposes left in the converted models and their x86 latency between two converter packages, e.g.
+# bash run_transpose_report.sh -b ${baseline_release_dir} -c ${release_dir} -m ${models_path}
+# Both directories hold a mindspore-lite-*-inference-linux-x64.tar.gz, the report is written to transpose_report.txt.
+
+# Unzip a package and convert every model of the cfg files, $1: release dir, $2: work dir
+function Convert_Models() {
+    rm -rf $2 && mkdir -p $2/ms_models || exit 1
+    tar -zxf $1/mindspore-lite-*-inference-linux-x64.tar.gz -C $2 || exit 1
+    local package_path=$(ls -d $2/mindspore-lite-*-inference-linux-x64)
+    export LD_LIBRARY_PATH=${package_path}/tools/converter/lib/:${package_path}/tools/converter/third_party/glog/lib:${package_path}/inference/lib
+    for fmk in TF TFLITE ONNX; do
+        local config=${models_config[${fmk}]}
+        while read line; do
+            local model_name=${line%;*}
+            if [[ $model_name == \#* || $model_name == "" ]]; then
+              continue
+            fi
+            # the unify format pass and the legacy transpose fusion pass log the transposes they leave
+            GLOG_v=1 ${package_path}/tools/converter/converter/converter_lite --fmk=${fmk} \
+                --modelFile=${models_path}/${model_name} --outputFile=$2/ms_models/${model_name} \
+                > $2/ms_models/${model_name}.convert.log 2>&1
+        done < ${config}
+    done
+}
+
+# $1: work dir, $2: model name, $3: input shapes, prints "transposes avg_run_time_ms"
+function Model_Result() {
+    local transposes=$(grep -o "transpose count: [0-9]* in the origin graph, [0-9]*" $1/ms_models/$2.convert.log | \
+        tail -n 1 | awk '{print $NF}')
+    local package_path=$(ls -d $1/mindspore-lite-*-inference-linux-x64)
+    local shape_flag=""
+    if [[ $3 != "" ]]; then
+        shape_flag="--inputShapes=$3"
+    fi
+    local avg_time=""
+    if [ -f $1/ms_models/$2.ms ]; then
+        avg_time=$(${package_path}/tools/benchmark/benchmark --modelFile=$1/ms_models/$2.ms \
+            --inDataFile=${models_path}/input_output/input/$2.ms.bin ${shape_flag} \
+            --loopCount=${loop_count} --warmUpLoopCount=3 2>&1 | grep -o "AvgRunTime = [0-9.]*" | awk '{print $3}')
+    fi
+    echo "${transposes:--} ${avg_time:--}"
+}
+
+baseline_path=""
+release_path=""
+models_path=""
+loop_count=50
+while getopts "b:c:m:l:" opt; do
+    case ${opt} in
+        b)
+            baseline_path=${OPTARG}
+            ;;
+        c)
+            release_path=${OPTARG}
+            ;;
+        m)
+            models_path=${OPTARG}
+            ;;
+        l)
+            loop_count=${OPTARG}
+            ;;
+        ?)
+        echo "unknown para"
+        exit 1;;
+    esac
+done
+if [[ ${baseline_path} == "" || ${release_path} == "" || ${models_path} == "" ]]; then
+    echo "usage: bash run_transpose_report.sh -b baseline_release_dir -c release_dir -m models_path [-l loop_count]"
+    exit 1
+fi
+
+basepath=$(pwd)
+declare -A models_config
+models_config[TF]=${basepath}/models_tf.cfg
+models_config[TFLITE]=${basepath}/models_tflite.cfg
+models_config[ONNX]=${basepath}/models_onnx.cfg
+work_path=${basepath}/transpose_report
+report_file=${basepath}/transpose_report.txt
+
+Convert_Models ${baseline_path} ${work_path}/baseline
+Convert_Models ${release_path} ${work_path}/current
+
+printf "%-64s %12s %12s %14s %14s\n" "model" "trans_before" "trans_after" "avg_ms_before" "avg_ms_after" > ${report_file}
+for fmk in TF TFLITE ONNX; do
+    while read line; do
+        model_name=${line%;*}
+        if [[ $model_name == \#* || $model_name == "" ]]; then
+          continue
+        fi
+        input_shapes=""
+        if [[ $line == *";"* ]]; then
+            input_shapes=${line#*;}
+        fi
+        before=($(Model_Result ${work_path}/baseline ${model_name} ${input_shapes}))
+        after=($(Model_Result ${work_path}/current ${model_name} ${input_shapes}))
+        printf "%-64s %12s %12s %14s %14s\n" ${model_name} ${before[0]} ${after[0]} ${before[1]} ${after[1]} >> ${report_file}
+    done < ${models_config[${fmk}]}
+done
+cat ${report_file}
@@ -0,0 +1,103 @@
+/**
+ * Copyright 2021 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <atomic>
+#include <thread>
+#include <vector>
+#include "common/common_test.h"
+#include "include/errorcode.h"
+#include "src/tensor.h"
+#include "src/common/tensor_util.h"
+
+namespace mindspore {
+class LazyWeightTest : public mindspore::CommonTest {
+ public:
+  LazyWeightTest() {}
+};
+
+namespace {
+std::function<int(lite::Tensor *)> CountingDecoder(std::atomic_int *decode_times) {
+  return [decode_times](lite::Tensor *tensor) {
+    (*decode_times)++;
+    if (tensor->MallocData() != lite::RET_OK) {
+      return lite::RET_ERROR;
+    }
+    // the decoder may read the tensor it fills
+    auto data = reinterpret_cast<float *>(tensor->MutableData());
+    for (int i = 0; i < tensor->ElementsNum(); i++) {
+      data[i] = static_cast<float>(i);
+    }
+    return lite::RET_OK;
+  };
+}
+}  // namespace
+
+TEST_F(LazyWeightTest, StaysEncodedUntilRead) {
+  std::atomic_int decode_times = 0;
+  lite::Tensor weight(kNumberTypeFloat32, {2, 3}, schema::Format_NHWC, lite::Tensor::CONST_TENSOR);
+  weight.set_lazy_decoder(CountingDecoder(&decode_times));
+  ASSERT_TRUE(weight.IsLazy());
+  ASSERT_TRUE(weight.IsConst());
+  ASSERT_TRUE(weight.IsReady());
+
+  // shape inference only sees the shape of a lazy weight
+  std::vector<TensorC *> tensors_c;
+  ASSERT_EQ(lite::InputTensor2TensorC({&weight}, &tensors_c), lite::RET_OK);
+  ASSERT_EQ(tensors_c.size(), 1);
+  ASSERT_EQ(tensors_c[0]->data_, nullptr);
+  ASSERT_EQ(tensors_c[0]->shape_size_, 2);
+  lite::FreeAllTensorC(&tensors_c);
+  ASSERT_EQ(decode_times, 0);
+
+  auto data = reinterpret_cast<float *>(weight.data_c());
+  ASSERT_NE(data, nullptr);
+  ASSERT_EQ(decode_times, 1);
+  ASSERT_FALSE(weight.IsLazy());
+  ASSERT_TRUE(weight.IsConst());
+  ASSERT_EQ(data[5], 5.0f);
+  ASSERT_EQ(weight.data_c(), data);
+  ASSERT_EQ(weight.MutableData(), data);
+  ASSERT_EQ(decode_times, 1);
+}
+
+TEST_F(LazyWeightTest, SharedWeightDecodedOnce) {
+  std::atomic_int decode_times = 0;
+  lite::Tensor weight(kNumberTypeFloat32, {64, 64}, schema::Format_NHWC, lite::Tensor::CONST_TENSOR);
+  weight.set_lazy_decoder(CountingDecoder(&decode_times));
+  constexpr int kReaderNum = 8;
+  std::vector<void *> reads(kReaderNum, nullptr);
+  std::vector<std::thread> readers;
+  for (int i = 0; i < kReaderNum; i++) {
+    readers.emplace_back([&weight, &reads, i]() { reads[i] = weight.data_c(); });
+  }
+  for (auto &reader : readers) {
+    reader.join();
+  }
+  ASSERT_EQ(decode_times, 1);
+  for (auto read : reads) {
+    ASSERT_NE(read, nullptr);
+    ASSERT_EQ(read, reads[0]);
+  }
+}
+
+TEST_F(LazyWeightTest, DecodeFailed) {
+  lite::Tensor weight(kNumberTypeFloat32, {2, 3}, schema::Format_NHWC, lite::Tensor::CONST_TENSOR);
+  weight.set_lazy_decoder([](lite::Tensor *) { return lite::RET_ERROR; });
+  ASSERT_EQ(weight.data_c(), nullptr);
+  ASSERT_FALSE(weight.IsLazy());
+  ASSERT_FALSE(weight.IsConst());
+}
+}  // namespace mindspore
@@ -16,10 +16,12 @@
 #include <sys/time.h>
 #include <iostream>
 #include <memory>
+#include <vector>
 #include "src/common/log_adapter.h"
 #include "common/common_test.h"
 #include "src/common/file_utils.h"
 #include "nnacl/matmul_parameter.h"
+#include "nnacl/fp32/sparse_matmul_fp32.h"
 #include "src/runtime/kernel/arm/fp32/convolution_1x1_fp32.h"
 
 namespace mindspore {
@@ -139,4 +141,144 @@ TEST_F(TestConv1x1Fp32, Input1x1PrePack4) {
   EXPECT_EQ(0, CompareOutputData(out, correct, 54));
   delete conv_param;
 }
+
+namespace {
+constexpr int kSparseInH = 5;
+constexpr int kSparseInW = 6;
+constexpr int kSparseOutH = 4;
+constexpr int kSparseOutW = 4;
+constexpr int kSparseInC = 16;
+constexpr int kSparseOutC = 20;
+
+// conv1x1 with stride 2 and pad 1 over a [1, 5, 6, 16] input, the weight is [20, 1, 1, 16]
+std::vector<float> RunConv1x1(const std::vector<float> &input, const std::vector<float> &weight,
+                              const std::vector<float> &bias, int thread_num) {
+  auto in_t = new lite::Tensor(kNumberTypeFloat32, {1, kSparseInH, kSparseInW, kSparseInC}, schema::Format_NHWC,
+                               lite::Tensor::Category::VAR);
+  in_t->MallocData();
+  memcpy(in_t->MutableData(), input.data(), input.size() * sizeof(float));
+  auto weight_t = new lite::Tensor(kNumberTypeFloat32, {kSparseOutC, 1, 1, kSparseInC}, schema::Format_NHWC,
+                                   lite::Tensor::Category::CONST_TENSOR);
+  weight_t->MallocData();
+  memcpy(weight_t->MutableData(), weight.data(), weight.size() * sizeof(float));
+  auto bias_t =
+    new lite::Tensor(kNumberTypeFloat32, {kSparseOutC}, schema::Format_NHWC, lite::Tensor::Category::CONST_TENSOR);
+  bias_t->MallocData();
+  memcpy(bias_t->MutableData(), bias.data(), bias.size() * sizeof(float));
+  auto out_t = new lite::Tensor(kNumberTypeFloat32, {1, kSparseOutH, kSparseOutW, kSparseOutC}, schema::Format_NHWC,
+                                lite::Tensor::Category::VAR);
+  out_t->MallocData();
+  std::vector<lite::Tensor *> inputs = {in_t, weight_t, bias_t};
+  std::vector<lite::Tensor *> outputs = {out_t};
+
+  auto conv_param = reinterpret_cast<ConvParameter *>(malloc(sizeof(ConvParameter)));
+  memset(conv_param, 0, sizeof(ConvParameter));
+  conv_param->kernel_h_ = conv_param->kernel_w_ = 1;
+  conv_param->stride_h_ = conv_param->stride_w_ = 2;
+  conv_param->dilation_h_ = conv_param->dilation_w_ = 1;
+  conv_param->pad_u_ = conv_param->pad_l_ = 1;
+  conv_param->group_ = 1;
+  conv_param->act_type_ = ActType_Relu;
+  auto ctx = new lite::InnerContext;
+  ctx->thread_num_ = thread_num;
+  EXPECT_EQ(lite::RET_OK, ctx->Init());
+  auto conv = new kernel::Convolution1x1CPUKernel(reinterpret_cast<OpParameter *>(conv_param), inputs, outputs, ctx,
+                                                  reinterpret_cast<float *>(weight_t->MutableData()),
+                                                  reinterpret_cast<float *>(bias_t->MutableData()));
+  EXPECT_EQ(lite::RET_OK, conv->Init());
+  EXPECT_EQ(lite::RET_OK, conv->ReSize());
+  EXPECT_EQ(lite::RET_OK, conv->Run());
+  auto out = reinterpret_cast<float *>(out_t->MutableData());
+  std::vector<float> output(out, out + out_t->ElementsNum());
+
+  delete conv;
+  delete ctx;
+  for (auto t : inputs) delete t;
+  for (auto t : outputs) delete t;
+  return output;
+}
+
+std::vector<float> Conv1x1Reference(const std::vector<float> &input, const std::vector<float> &weight,
+                                    const std::vector<float> &bias) {
+  std::vector<float> output(kSparseOutH * kSparseOutW * kSparseOutC);
+  for (int oh = 0; oh < kSparseOutH; ++oh) {
+    for (int ow = 0; ow < kSparseOutW; ++ow) {
+      int ih = oh * 2 - 1;
+      int iw = ow * 2 - 1;
+      bool in_range = ih >= 0 && ih < kSparseInH && iw >= 0 && iw < kSparseInW;
+      for (int oc = 0; oc < kSparseOutC; ++oc) {
+        float sum = bias[oc];
+        for (int ic = 0; in_range && ic < kSparseInC; ++ic) {
+          sum += input[(ih * kSparseInW + iw) * kSparseInC + ic] * weight[oc * kSparseInC + ic];
+        }
+        output[(oh * kSparseOutW + ow) * kSparseOutC + oc] = MSMAX(sum, 0.0f);
+      }
+    }
+  }
+  return output;
+}
+}  // namespace
+
+TEST_F(TestConv1x1Fp32, SparseWeightConv1x1) {
+  std::vector<float> input(kSparseInH * kSparseInW * kSparseInC);
+  for (size_t i = 0; i < input.size(); ++i) {
+    input[i] = (static_cast<int>(i % 11) - 5) * 0.125f;
+  }
+  std::vector<float> bias(kSparseOutC);
+  for (int oc = 0; oc < kSparseOutC; ++oc) {
+    bias[oc] = oc * 0.05f - 0.5f;
+  }
+  // every fourth input channel of the first and the partial last output channel block is nonzero
+  std::vector<float> sparse_weight(kSparseOutC * kSparseInC, 0.0f);
+  for (int oc = 0; oc < kSparseOutC; ++oc) {
+    if (oc / SPARSE_BLOCK == 1) {
+      continue;
+    }
+    for (int ic = 0; ic < kSparseInC; ic += 4) {
+      sparse_weight[oc * kSparseInC + ic] = ((oc + ic) % 7 - 3) * 0.25f;
+    }
+  }
+  int total_block = UP_DIV(kSparseOutC, SPARSE_BLOCK) * kSparseInC;
+  ASSERT_LT(BlockSparseNonzeroNum(sparse_weight.data(), kSparseOutC, kSparseInC), total_block * 3 / 10);
+  auto expect = Conv1x1Reference(input, sparse_weight, bias);
+  for (int thread_num : {1, 2}) {
+    auto output = RunConv1x1(input, sparse_weight, bias, thread_num);
+    ASSERT_EQ(0, CompareOutputData(output.data(), expect.data(), output.size(), 0.0001));
+  }
+
+  // a weight under the sparsity threshold runs the dense kernel and gives the same result
+  auto dense_weight = sparse_weight;
+  for (int ic = 1; ic < kSparseInC; ic += 2) {
+    dense_weight[SPARSE_BLOCK * kSparseInC + ic] = 0.5f;
+  }
+  expect = Conv1x1Reference(input, dense_weight, bias);
+  auto output = RunConv1x1(input, dense_weight, bias, 2);
+  ASSERT_EQ(0, CompareOutputData(output.data(), expect.data(), output.size(), 0.0001));
+}
+
+TEST_F(TestConv1x1Fp32, Sparse24WeightConv1x1) {
+  std::vector<float> input(kSparseInH * kSparseInW * kSparseInC);
+  for (size_t i = 0; i < input.size(); ++i) {
+    input[i] = (static_cast<int>(i % 11) - 5) * 0.125f;
+  }
+  std::vector<float> bias(kSparseOutC);
+  for (int oc = 0; oc < kSparseOutC; ++oc) {
+    bias[oc] = oc * 0.05f - 0.5f;
+  }
+  // two of every four input channels are kept at a position shifting with the output channel, no block is all zero
+  std::vector<float> weight(kSparseOutC * kSparseInC, 0.0f);
+  for (int oc = 0; oc < kSparseOutC; ++oc) {
+    for (int ic = 0; ic < kSparseInC; ++ic) {
+      if ((oc + ic) % C4NUM < 2) {
+        weight[oc * kSparseInC + ic] = ((oc + ic) % 7 - 3) * 0.25f + 0.125f;
+      }
+    }
+  }
+  ASSERT_TRUE(IsSparse24(weight.data(), kSparseOutC, kSparseInC));
+  auto expect = Conv1x1Reference(input, weight, bias);
+  for (int thread_num : {1, 3}) {
+    auto output = RunConv1x1(input, weight, bias, thread_num);
+    ASSERT_EQ(0, CompareOutputData(output.data(), expect.data(), output.size(), 0.0001));
+  }
+}
 }  // namespace mindspore
@@ -14,10 +14,12 @@
  * limitations under the License.
  */
 #include <iostream>
+#include <vector>
 #include "src/common/log_adapter.h"
 #include "common/common_test.h"
 #include "mindspore/lite/src/runtime/kernel/arm/fp32/matmul_fp32.h"
 #include "nnacl/fp32/matmul_fp32.h"
+#include "nnacl/fp32/sparse_matmul_fp32.h"
 #include "src/kernel_registry.h"
 #include "src/lite_kernel.h"
 
@@ -353,4 +355,100 @@ TEST_F(TestMatMulFp32, batch) {
   for (auto t : inputs_) delete t;
   for (auto t : outputs_) delete t;
 }
+
+TEST_F(TestMatMulFp32, BlockSparseMatMul) {
+  const int row = 7;
+  const int deep = 19;
+  const int col = 21;
+  std::vector<float> a(row * deep);
+  std::vector<float> b(col * deep, 0.0f);
+  std::vector<float> bias(col);
+  for (int i = 0; i < row * deep; ++i) {
+    a[i] = (i % 7 - 3) * 0.25f;
+  }
+  // every third deep index of every other column block is nonzero, the tail block is partial
+  for (int oc = 0; oc < col; ++oc) {
+    for (int d = 0; d < deep; d += 3) {
+      if ((oc / SPARSE_BLOCK) % 2 == 0) {
+        b[oc * deep + d] = ((oc + d) % 5 - 2) * 0.5f;
+      }
+    }
+  }
+  for (int oc = 0; oc < col; ++oc) {
+    bias[oc] = oc * 0.1f - 1.0f;
+  }
+  std::vector<float> expect(row * col);
+  for (int r = 0; r < row; ++r) {
+    for (int oc = 0; oc < col; ++oc) {
+      float sum = bias[oc];
+      for (int d = 0; d < deep; ++d) {
+        sum += a[r * deep + d] * b[oc * deep + d];
+      }
+      expect[r * col + oc] = MSMAX(sum, 0.0f);
+    }
+  }
+
+  int block_num = BlockSparseNonzeroNum(b.data(), col, deep);
+  ASSERT_EQ(block_num, 2 * UP_DIV(deep, 3));
+  std::vector<char> packed(BlockSparsePackSize(col, block_num));
+  PackBlockSparse(b.data(), packed.data(), col, deep);
+
+  std::vector<float> unpacked(col * deep);
+  ASSERT_EQ(NNACL_OK, UnpackBlockSparse(packed.data(), packed.size(), unpacked.data(), col, deep));
+  ASSERT_EQ(0, CompareOutputData(unpacked.data(), b.data(), col * deep, 0));
+  ASSERT_NE(NNACL_OK, UnpackBlockSparse(packed.data(), packed.size() - 1, unpacked.data(), col, deep));
+
+  // two column ranges, as two threads would run them
+  std::vector<float> out(row * col);
+  SparseMatMulFp32(a.data(), packed.data(), out.data(), bias.data(), ActType_Relu, deep, row, col, 0, 1);
+  SparseMatMulFp32(a.data(), packed.data(), out.data(), bias.data(), ActType_Relu, deep, row, col, 1, 3);
+  ASSERT_EQ(0, CompareOutputData(out.data(), expect.data(), row * col, 0.0001));
+}
+
+TEST_F(TestMatMulFp32, Sparse24MatMul) {
+  const int row = 7;
+  const int deep = 18;
+  const int col = 11;
+  std::vector<float> a(row * deep);
+  std::vector<float> b(col * deep, 0.0f);
+  std::vector<float> bias(col);
+  for (int i = 0; i < row * deep; ++i) {
+    a[i] = (i % 7 - 3) * 0.25f;
+  }
+  // two of every four deep values are kept at a position shifting with the column, the tail group is short
+  for (int oc = 0; oc < col; ++oc) {
+    for (int d = 0; d < deep; ++d) {
+      if ((d + oc) % C4NUM < 2) {
+        b[oc * deep + d] = ((oc + d) % 5 - 2) * 0.5f + 0.25f;
+      }
+    }
+    bias[oc] = oc * 0.1f - 0.5f;
+  }
+  std::vector<float> expect(row * col);
+  for (int r = 0; r < row; ++r) {
+    for (int oc = 0; oc < col; ++oc) {
+      float sum = bias[oc];
+      for (int d = 0; d < deep; ++d) {
+        sum += a[r * deep + d] * b[oc * deep + d];
+      }
+      expect[r * col + oc] = MSMAX(sum, 0.0f);
+    }
+  }
+  ASSERT_TRUE(IsSparse24(b.data(), col, deep));
+  ASSERT_EQ(BlockSparseNonzeroNum(b.data(), col, deep), UP_DIV(col, SPARSE_BLOCK) * deep);
+  std::vector<char> packed(Sparse24PackSize(col, deep));
+  PackSparse24(b.data(), packed.data(), col, deep);
+  std::vector<float> packed_a(UP_ROUND(row, C4NUM) * deep);
+  RowMajor2Col4Major(a.data(), packed_a.data(), row, deep);
+
+  // two column ranges, as two threads would run them
+  std::vector<float> out(row * col);
+  Sparse24MatMulFp32(packed_a.data(), packed.data(), out.data(), bias.data(), ActType_Relu, deep, row, col, 0, 5);
+  Sparse24MatMulFp32(packed_a.data(), packed.data(), out.data(), bias.data(), ActType_Relu, deep, row, col, 5, 10);
+  Sparse24MatMulFp32(packed_a.data(), packed.data(), out.data(), bias.data(), ActType_Relu, deep, row, col, 10, 15);
+  ASSERT_EQ(0, CompareOutputData(out.data(), expect.data(), row * col, 0.0001));
+
+  b[deep + 2] = 1.0f;
+  ASSERT_FALSE(IsSparse24(b.data(), col, deep));
+}
 }  // namespace mindspore
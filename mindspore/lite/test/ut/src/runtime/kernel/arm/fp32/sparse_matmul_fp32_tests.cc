@@ -0,0 +1,145 @@
+/**
+ * Copyright 2021 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <vector>
+#include "common/common_test.h"
+#include "src/common/utils.h"
+#include "nnacl/fp32/matmul_fp32.h"
+#include "nnacl/fp32/sparse_matmul_fp32.h"
+
+namespace mindspore {
+class TestSparseMatmulFp32 : public mindspore::CommonTest {
+ public:
+  TestSparseMatmulFp32() {}
+};
+
+namespace {
+constexpr int kBenchLoops = 20;
+
+struct BenchShape {
+  const char *name;
+  int row;
+  int deep;
+  int col;
+};
+
+// the tiles of the dense kernel MatmulFp32BaseCPUKernel runs on this platform
+#ifdef ENABLE_AVX
+constexpr int kRowTile = C6NUM;
+constexpr int kColTile = C16NUM;
+#elif defined(ENABLE_ARM32)
+constexpr int kRowTile = C12NUM;
+constexpr int kColTile = C4NUM;
+#elif defined(ENABLE_SSE)
+constexpr int kRowTile = C4NUM;
+constexpr int kColTile = C8NUM;
+#else
+constexpr int kRowTile = C12NUM;
+constexpr int kColTile = C8NUM;
+#endif
+
+void PackDenseA(const float *src, float *dst, int row, int deep) {
+#ifdef ENABLE_AVX
+  RowMajor2Col6Major(src, dst, row, deep);
+#elif defined(ENABLE_SSE)
+  RowMajor2Col4Major(src, dst, row, deep);
+#else
+  RowMajor2Col12Major(src, dst, row, deep);
+#endif
+}
+
+void PackDenseB(const float *src, float *dst, int col, int deep) {
+#ifdef ENABLE_AVX
+  RowMajor2Col16Major(src, dst, col, deep);
+#elif defined(ENABLE_ARM32)
+  RowMajor2Col4Major(src, dst, col, deep);
+#else
+  RowMajor2Col8Major(src, dst, col, deep);
+#endif
+}
+
+// a [col, deep] weight whose blocks are zero in the given ratio, spread over the column blocks
+std::vector<float> BlockSparseWeight(int col, int deep, float sparsity) {
+  std::vector<float> weight(col * deep, 0.0f);
+  int keep = static_cast<int>((1.0f - sparsity) * 100 + 0.5f);
+  for (int oc = 0; oc < col; ++oc) {
+    for (int d = 0; d < deep; ++d) {
+      if ((oc / SPARSE_BLOCK * 37 + d * 61) % 100 < keep) {
+        weight[oc * deep + d] = ((oc + d) % 9 - 4) * 0.125f;
+      }
+    }
+  }
+  return weight;
+}
+
+template <typename Func>
+uint64_t BestTimeUs(Func func) {
+  func();
+  uint64_t best = UINT64_MAX;
+  for (int i = 0; i < kBenchLoops; ++i) {
+    uint64_t start = lite::GetTimeUs();
+    func();
+    best = MSMIN(best, lite::GetTimeUs() - start);
+  }
+  return best;
+}
+}  // namespace
+
+// the fc and conv1x1 shapes run the dense packed kernel against the block sparse one, a is packed in every dense run
+// and b is packed once as the kernels do for a const weight
+TEST_F(TestSparseMatmulFp32, SparseVsDenseBenchmark) {
+  const BenchShape shapes[] = {{"fc", 8, 1024, 1024}, {"conv1x1", 28 * 28, 128, 128}};
+  printf("%-8s %-9s %-12s %-12s %-8s\n", "shape", "sparsity", "dense(us)", "sparse(us)", "speedup");
+  for (auto &shape : shapes) {
+    int row = shape.row;
+    int deep = shape.deep;
+    int col = shape.col;
+    std::vector<float> a(row * deep);
+    for (int i = 0; i < row * deep; ++i) {
+      a[i] = (i % 11 - 5) * 0.25f;
+    }
+    std::vector<float> bias(col, 0.5f);
+    std::vector<float> packed_a(UP_ROUND(row, kRowTile) * deep);
+    std::vector<float> packed_b(UP_ROUND(col, kColTile) * deep, 0.0f);
+    std::vector<float> dense_out(row * col);
+    std::vector<float> sparse_out(row * col);
+    for (float sparsity : {0.7f, 0.8f, 0.9f}) {
+      auto weight = BlockSparseWeight(col, deep, sparsity);
+      PackDenseB(weight.data(), packed_b.data(), col, deep);
+      int block_num = BlockSparseNonzeroNum(weight.data(), col, deep);
+      std::vector<char> sparse_b(BlockSparsePackSize(col, block_num));
+      PackBlockSparse(weight.data(), sparse_b.data(), col, deep);
+
+      uint64_t dense_time = BestTimeUs([&]() {
+        PackDenseA(a.data(), packed_a.data(), row, deep);
+        MatMulOpt(packed_a.data(), packed_b.data(), dense_out.data(), bias.data(), ActType_No, deep, row, col, col,
+                  OutType_Nhwc);
+      });
+      uint64_t sparse_time = BestTimeUs([&]() {
+        SparseMatMulFp32(a.data(), sparse_b.data(), sparse_out.data(), bias.data(), ActType_No, deep, row, col, 0,
+                         UP_DIV(col, SPARSE_BLOCK));
+      });
+      ASSERT_EQ(0, CompareOutputData(sparse_out.data(), dense_out.data(), row * col, 0.001));
+      printf("%-8s %-9.1f %-12lu %-12lu %-8.2f\n", shape.name, sparsity, static_cast<unsigned long>(dense_time),
+             static_cast<unsigned long>(sparse_time),
+             static_cast<double>(dense_time) / MSMAX(sparse_time, static_cast<uint64_t>(1)));
+      // a tenth of the blocks left has to beat the dense kernel by far, the threshold of the kernels relies on it
+      if (sparsity > 0.85f) {
+        EXPECT_LT(sparse_time, dense_time);
+      }
+    }
+  }
+}
+}  // namespace mindspore
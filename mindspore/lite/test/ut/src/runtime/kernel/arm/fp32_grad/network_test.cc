@@ -31,6 +31,7 @@
 #include "src/common/file_utils.h"
 #include "src/kernel_registry.h"
 #include "src/runtime/kernel/arm/fp32_grad/convolution.h"
+#include "src/train/train_session.h"
 
 using mindspore::lite::RET_OK;
 namespace mindspore {
@@ -594,4 +595,107 @@ TEST_F(NetworkTest, setname) {
   delete session;
 }
 
+namespace {
+lite::TrainSession *CreateRecomputeSession(const std::string &net, lite::Context *context, int segment_num) {
+  auto *model = mindspore::lite::Model::Import(net.c_str());
+  if (model == nullptr) {
+    return nullptr;
+  }
+  auto session = new (std::nothrow) lite::TrainSession();
+  if (session == nullptr) {
+    delete model;
+    return nullptr;
+  }
+  if (session->Init(context) != RET_OK || session->CompileTrainGraph(model) != RET_OK ||
+      session->SetupRecompute(segment_num) != RET_OK || session->Train() != RET_OK) {
+    delete session;
+    return nullptr;
+  }
+  return session;
+}
+
+void FillInputs(lite::TrainSession *session, int step) {
+  for (auto input : session->GetInputs()) {
+    auto num = input->ElementsNum();
+    if (input->data_type() == kNumberTypeFloat32) {
+      auto data = reinterpret_cast<float *>(input->MutableData());
+      for (int i = 0; i < num; i++) {
+        data[i] = static_cast<float>((i * 7 + step * 13) % 17) / 17.0f;
+      }
+    } else if (input->data_type() == kNumberTypeInt32) {
+      auto data = reinterpret_cast<int *>(input->MutableData());
+      for (int i = 0; i < num; i++) {
+        data[i] = (i + step) % 10;
+      }
+    }
+  }
+}
+
+void ExpectSameOutputs(lite::TrainSession *expect, lite::TrainSession *actual) {
+  auto expect_outputs = expect->GetOutputs();
+  auto actual_outputs = actual->GetOutputs();
+  ASSERT_EQ(expect_outputs.size(), actual_outputs.size());
+  for (auto &item : expect_outputs) {
+    auto actual_tensor = actual_outputs[item.first];
+    ASSERT_NE(actual_tensor, nullptr);
+    ASSERT_EQ(item.second->ElementsNum(), actual_tensor->ElementsNum());
+    auto expect_data = reinterpret_cast<float *>(item.second->MutableData());
+    auto actual_data = reinterpret_cast<float *>(actual_tensor->MutableData());
+    for (int i = 0; i < item.second->ElementsNum(); i++) {
+      EXPECT_NEAR(expect_data[i], actual_data[i], 1e-5);
+    }
+  }
+}
+}  // namespace
+
+TEST_F(NetworkTest, recompute) {
+  std::string net = "./test_data/nets/lenet_train.ms";
+  lite::Context context;
+  context.device_list_[0].device_info_.cpu_device_info_.cpu_bind_mode_ = lite::NO_BIND;
+  context.thread_num_ = 1;
+
+  auto plain = CreateRecomputeSession(net, &context, 0);
+  ASSERT_NE(plain, nullptr);
+  auto session = CreateRecomputeSession(net, &context, 2);
+  ASSERT_NE(session, nullptr);
+  // the loss and the updated weights of every step match a run without recompute
+  for (int step = 0; step < 3; step++) {
+    FillInputs(plain, step);
+    FillInputs(session, step);
+    ASSERT_EQ(plain->RunGraph(), RET_OK);
+    ASSERT_EQ(session->RunGraph(), RET_OK);
+    ExpectSameOutputs(plain, session);
+  }
+
+  // the plan is built again when the outputs change and the old ref counts are restored first
+  ASSERT_EQ(plain->SetLossName("nhwc"), RET_OK);
+  ASSERT_EQ(session->SetLossName("nhwc"), RET_OK);
+  ASSERT_EQ(session->SetupRecompute(4), RET_OK);
+  for (int step = 3; step < 5; step++) {
+    FillInputs(plain, step);
+    FillInputs(session, step);
+    ASSERT_EQ(plain->RunGraph(), RET_OK);
+    ASSERT_EQ(session->RunGraph(), RET_OK);
+    ExpectSameOutputs(plain, session);
+  }
+  ASSERT_EQ(session->Eval(), RET_OK);
+  ASSERT_EQ(plain->Eval(), RET_OK);
+  ASSERT_EQ(plain->RunGraph(), RET_OK);
+  ASSERT_EQ(session->RunGraph(), RET_OK);
+  ExpectSameOutputs(plain, session);
+
+  // disabling it through the public session runs the plain train kernels again
+  session::TrainSession *public_session = session;
+  ASSERT_EQ(public_session->SetupRecompute(0), RET_OK);
+  ASSERT_EQ(session->Train(), RET_OK);
+  ASSERT_EQ(plain->Train(), RET_OK);
+  FillInputs(plain, 5);
+  FillInputs(session, 5);
+  ASSERT_EQ(plain->RunGraph(), RET_OK);
+  ASSERT_EQ(session->RunGraph(), RET_OK);
+  ExpectSameOutputs(plain, session);
+  delete plain;
+  delete session;
+}
+
 }  // namespace mindspore
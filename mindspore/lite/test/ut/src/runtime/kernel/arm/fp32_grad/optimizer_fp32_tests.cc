@@ -0,0 +1,228 @@
+/**
+ * Copyright 2021 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <vector>
+#include "common/common_test.h"
+#include "src/kernel_registry.h"
+#include "src/train/optimizer_kernel.h"
+#include "nnacl/fp32_grad/optimizer.h"
+
+namespace mindspore {
+class TestOptimizerFp32 : public mindspore::CommonTest {
+ public:
+  TestOptimizerFp32() {}
+};
+
+namespace {
+constexpr int kWeightNum = 4;
+
+std::shared_ptr<lite::Tensor> ConstTensor(const std::vector<float> &data) {
+  auto tensor = std::make_shared<lite::Tensor>(kNumberTypeFloat32, std::vector<int>{static_cast<int>(data.size())},
+                                               schema::Format_NHWC, lite::Tensor::CONST_TENSOR);
+  tensor->MallocData();
+  std::copy(data.begin(), data.end(), reinterpret_cast<float *>(tensor->MutableData()));
+  return tensor;
+}
+
+kernel::OptimizerKernel *CreateSgd(const std::vector<lite::Tensor *> &inputs, const std::vector<lite::Tensor *> &outputs,
+                                   const lite::InnerContext *ctx, float dampening) {
+  auto param = static_cast<SgdParameter *>(malloc(sizeof(SgdParameter)));
+  if (param == nullptr) {
+    return nullptr;
+  }
+  memset(param, 0, sizeof(SgdParameter));
+  param->op_parameter_.type_ = schema::PrimitiveType_SGD;
+  param->dampening_ = dampening;
+  kernel::KernelKey desc = {kernel::kCPU, TypeId::kNumberTypeFloat32, schema::PrimitiveType_SGD};
+  auto creator = lite::KernelRegistry::GetInstance()->GetCreator(desc);
+  if (creator == nullptr) {
+    free(param);
+    return nullptr;
+  }
+  return reinterpret_cast<kernel::OptimizerKernel *>(
+    creator(inputs, outputs, reinterpret_cast<OpParameter *>(param), ctx, desc));
+}
+
+int RunKernel(kernel::LiteKernel *kernel) {
+  auto ret = kernel->PreProcess();
+  if (ret != lite::RET_OK) {
+    return ret;
+  }
+  ret = kernel->Run();
+  if (ret != lite::RET_OK) {
+    return ret;
+  }
+  return kernel->PostProcess();
+}
+}  // namespace
+
+TEST_F(TestOptimizerFp32, SgdMomentumAfterFirstStep) {
+  std::vector<float> grad0 = {0.1f, -0.2f, 0.3f, 0.4f};
+  std::vector<float> grad1 = {0.5f, 0.6f, -0.7f, 0.8f};
+  std::vector<float> weight = {1.0f, 2.0f, 3.0f, 4.0f};
+  float lr = 0.1f;
+  float moment = 0.9f;
+  float dampening = 0.1f;
+
+  auto weight_tensor = ConstTensor(weight);
+  auto grad_tensor = ConstTensor(grad0);
+  auto lr_tensor = ConstTensor({lr});
+  auto accumulate_tensor = ConstTensor({0.0f, 0.0f, 0.0f, 0.0f});
+  auto moment_tensor = ConstTensor({moment});
+  auto stat_tensor = ConstTensor({1.0f});
+  lite::Tensor out_tensor(kNumberTypeFloat32, {1});
+  std::vector<lite::Tensor *> inputs = {weight_tensor.get(),     grad_tensor.get(),  lr_tensor.get(),
+                                        accumulate_tensor.get(), moment_tensor.get(), stat_tensor.get()};
+  std::vector<lite::Tensor *> outputs = {&out_tensor};
+
+  lite::InnerContext ctx;
+  ctx.thread_num_ = 2;
+  ASSERT_EQ(lite::RET_OK, ctx.Init());
+  auto kernel_obj = CreateSgd(inputs, outputs, &ctx, dampening);
+  ASSERT_NE(kernel_obj, nullptr);
+
+  // the first step takes the gradient as it is and clears stat
+  ASSERT_EQ(lite::RET_OK, RunKernel(kernel_obj));
+  auto stat_data = reinterpret_cast<float *>(stat_tensor->MutableData());
+  EXPECT_FLOAT_EQ(0.0f, stat_data[0]);
+  std::vector<float> expect_weight(weight);
+  for (int i = 0; i < kWeightNum; i++) {
+    expect_weight[i] -= grad0[i] * lr;
+  }
+
+  // so the second one applies momentum and dampening
+  std::copy(grad1.begin(), grad1.end(), reinterpret_cast<float *>(grad_tensor->MutableData()));
+  ASSERT_EQ(lite::RET_OK, RunKernel(kernel_obj));
+  auto accumulate_data = reinterpret_cast<float *>(accumulate_tensor->MutableData());
+  auto weight_data = reinterpret_cast<float *>(weight_tensor->MutableData());
+  for (int i = 0; i < kWeightNum; i++) {
+    float expect_accumulate = grad0[i] * moment + grad1[i] * (1.0f - dampening);
+    expect_weight[i] -= expect_accumulate * lr;
+    EXPECT_NEAR(expect_accumulate, accumulate_data[i], 1e-6);
+    EXPECT_NEAR(expect_weight[i], weight_data[i], 1e-6);
+  }
+  delete kernel_obj;
+}
+
+TEST_F(TestOptimizerFp32, SgdVirtualBatchInPlace) {
+  std::vector<std::vector<float>> grads = {
+    {0.1f, -0.2f, 0.3f, 0.4f}, {0.5f, 0.6f, -0.7f, 0.8f}, {-0.3f, 0.2f, 0.1f, 0.5f}, {0.4f, -0.1f, 0.6f, -0.2f}};
+  std::vector<float> weight = {1.0f, 2.0f, 3.0f, 4.0f};
+  float lr = 0.1f;
+  float moment = 0.9f;
+  float dampening = 0.1f;
+
+  auto weight_tensor = ConstTensor(weight);
+  auto grad_tensor = ConstTensor(grads[0]);
+  auto lr_tensor = ConstTensor({lr});
+  auto accumulate_tensor = ConstTensor({0.0f, 0.0f, 0.0f, 0.0f});
+  auto moment_tensor = ConstTensor({moment});
+  auto stat_tensor = ConstTensor({1.0f});
+  lite::Tensor out_tensor(kNumberTypeFloat32, {1});
+  std::vector<lite::Tensor *> inputs = {weight_tensor.get(),     grad_tensor.get(),  lr_tensor.get(),
+                                        accumulate_tensor.get(), moment_tensor.get(), stat_tensor.get()};
+  std::vector<lite::Tensor *> outputs = {&out_tensor};
+
+  lite::InnerContext ctx;
+  ctx.thread_num_ = 2;
+  ASSERT_EQ(lite::RET_OK, ctx.Init());
+  auto kernel_obj = CreateSgd(inputs, outputs, &ctx, dampening);
+  ASSERT_NE(kernel_obj, nullptr);
+  ASSERT_EQ(lite::RET_OK, kernel_obj->SetOptimizerMode(kernel::OptimizerKernel::WeightUpdateMode::VIRTUAL_BATCH));
+
+  auto accumulate_data = reinterpret_cast<float *>(accumulate_tensor->MutableData());
+  auto weight_data = reinterpret_cast<float *>(weight_tensor->MutableData());
+  std::vector<float> expect_accumulate(kWeightNum, 0.0f);
+  std::vector<float> expect_weight(weight);
+  for (size_t batch = 0; batch < 2; batch++) {
+    for (size_t micro = 0; micro < 2; micro++) {
+      auto &grad = grads[batch * 2 + micro];
+      std::copy(grad.begin(), grad.end(), reinterpret_cast<float *>(grad_tensor->MutableData()));
+      ASSERT_EQ(lite::RET_OK, RunKernel(kernel_obj));
+    }
+    ASSERT_EQ(lite::RET_OK, kernel_obj->OptimizerStep());
+    // one sgd step on the summed gradients, the first one without momentum
+    for (int i = 0; i < kWeightNum; i++) {
+      float grad_sum = grads[batch * 2][i] + grads[batch * 2 + 1][i];
+      expect_accumulate[i] =
+        (batch == 0) ? grad_sum : expect_accumulate[i] * moment + grad_sum * (1.0f - dampening);
+      expect_weight[i] -= expect_accumulate[i] * lr;
+      EXPECT_NEAR(expect_accumulate[i], accumulate_data[i], 1e-6);
+      EXPECT_NEAR(expect_weight[i], weight_data[i], 1e-6);
+    }
+    EXPECT_FLOAT_EQ(0.0f, reinterpret_cast<float *>(stat_tensor->MutableData())[0]);
+  }
+  delete kernel_obj;
+}
+
+TEST_F(TestOptimizerFp32, ApplyMomentumVirtualBatchInPlace) {
+  std::vector<float> grad0 = {0.1f, -0.2f, 0.3f, 0.4f};
+  std::vector<float> grad1 = {0.5f, 0.6f, -0.7f, 0.8f};
+  std::vector<float> accumulate = {0.2f, 0.1f, -0.1f, 0.0f};
+  std::vector<float> weight = {1.0f, 2.0f, 3.0f, 4.0f};
+  float lr = 0.1f;
+  float moment = 0.9f;
+
+  auto weight_tensor = ConstTensor(weight);
+  auto accumulate_tensor = ConstTensor(accumulate);
+  auto lr_tensor = ConstTensor({lr});
+  auto grad_tensor = ConstTensor(grad0);
+  auto moment_tensor = ConstTensor({moment});
+  lite::Tensor out_tensor(kNumberTypeFloat32, {1});
+  std::vector<lite::Tensor *> inputs = {weight_tensor.get(), accumulate_tensor.get(), lr_tensor.get(),
+                                        grad_tensor.get(), moment_tensor.get()};
+  std::vector<lite::Tensor *> outputs = {&out_tensor};
+
+  lite::InnerContext ctx;
+  ctx.thread_num_ = 2;
+  ASSERT_EQ(lite::RET_OK, ctx.Init());
+  auto param = static_cast<ApplyMomentumParameter *>(malloc(sizeof(ApplyMomentumParameter)));
+  ASSERT_NE(param, nullptr);
+  memset(param, 0, sizeof(ApplyMomentumParameter));
+  param->op_parameter_.type_ = schema::PrimitiveType_ApplyMomentum;
+  kernel::KernelKey desc = {kernel::kCPU, TypeId::kNumberTypeFloat32, schema::PrimitiveType_ApplyMomentum};
+  auto creator = lite::KernelRegistry::GetInstance()->GetCreator(desc);
+  ASSERT_NE(creator, nullptr);
+  auto kernel_obj = reinterpret_cast<kernel::OptimizerKernel *>(
+    creator(inputs, outputs, reinterpret_cast<OpParameter *>(param), &ctx, desc));
+  ASSERT_NE(kernel_obj, nullptr);
+
+  ASSERT_EQ(lite::RET_OK, kernel_obj->SetOptimizerMode(kernel::OptimizerKernel::WeightUpdateMode::VIRTUAL_BATCH));
+  for (auto &grad : {grad0, grad1}) {
+    std::copy(grad.begin(), grad.end(), reinterpret_cast<float *>(grad_tensor->MutableData()));
+    ASSERT_EQ(lite::RET_OK, kernel_obj->PreProcess());
+    ASSERT_EQ(lite::RET_OK, kernel_obj->Run());
+    ASSERT_EQ(lite::RET_OK, kernel_obj->PostProcess());
+  }
+  // the weights only change on the optimizer step
+  auto weight_data = reinterpret_cast<float *>(weight_tensor->MutableData());
+  for (int i = 0; i < kWeightNum; i++) {
+    ASSERT_FLOAT_EQ(weight[i], weight_data[i]);
+  }
+  ASSERT_EQ(lite::RET_OK, kernel_obj->OptimizerStep());
+
+  // one momentum step on the summed gradients
+  auto accumulate_data = reinterpret_cast<float *>(accumulate_tensor->MutableData());
+  for (int i = 0; i < kWeightNum; i++) {
+    float expect_accumulate = accumulate[i] * moment + grad0[i] + grad1[i];
+    EXPECT_NEAR(expect_accumulate, accumulate_data[i], 1e-6);
+    EXPECT_NEAR(weight[i] - expect_accumulate * lr, weight_data[i], 1e-6);
+  }
+  delete kernel_obj;
+}
+}  // namespace mindspore
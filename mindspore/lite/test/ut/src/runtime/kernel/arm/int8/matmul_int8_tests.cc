@@ -21,6 +21,8 @@
 #include "nnacl/int8/quantize.h"
 #include "nnacl/common_func.h"
 #include "nnacl/int8/matmul_int8.h"
+#include "nnacl/int8/fixed_point.h"
+#include "nnacl/int8/sparse_matmul_int8.h"
 #include "mindspore/lite/src/kernel_registry.h"
 #include "mindspore/lite/src/lite_kernel.h"
 
@@ -259,4 +261,119 @@ TEST_F(TestMatmulInt8, mmtest2) {
   delete[] out;
 }
 
+TEST_F(TestMatmulInt8, BlockSparseMatMulInt8) {
+  const int row = 7;
+  const int deep = 19;
+  const int col = 21;
+  std::vector<int8_t> a(row * deep);
+  std::vector<int8_t> b(col * deep);
+  std::vector<int32_t> bias(col);
+  std::vector<int32_t> filter_zp(col);
+  std::vector<int32_t> multiplier(col);
+  std::vector<int32_t> left_shift(col, 0);
+  std::vector<int32_t> right_shift(col);
+  for (int i = 0; i < row * deep; ++i) {
+    a[i] = static_cast<int8_t>(i * 37 % 255 - 127);
+  }
+  // every third deep index of every other column block differs from the zero point of its channel
+  for (int oc = 0; oc < col; ++oc) {
+    filter_zp[oc] = oc % 5 - 2;
+    bias[oc] = oc * 7 - 50;
+    multiplier[oc] = 1500000000 + oc;
+    right_shift[oc] = -(6 + oc % 3);
+    for (int d = 0; d < deep; ++d) {
+      bool nonzero = d % 3 == 0 && (oc / SPARSE_BLOCK) % 2 == 0;
+      b[oc * deep + d] = static_cast<int8_t>(nonzero ? (oc * 11 + d * 3) % 200 - 100 : filter_zp[oc]);
+    }
+  }
+  MatmulQuantParameter quant_param = {};
+  quant_param.input_.zp_ = 3;
+  quant_param.output_.zp_ = -5;
+  quant_param.out_act_min_ = -128;
+  quant_param.out_act_max_ = 127;
+  quant_param.quant_multiplier_ = multiplier.data();
+  quant_param.left_shift_ = left_shift.data();
+  quant_param.right_shift_ = right_shift.data();
+  std::vector<int8_t> expect(row * col);
+  for (int r = 0; r < row; ++r) {
+    for (int oc = 0; oc < col; ++oc) {
+      int32_t sum = bias[oc];
+      for (int d = 0; d < deep; ++d) {
+        sum += (a[r * deep + d] - quant_param.input_.zp_) * (b[oc * deep + d] - filter_zp[oc]);
+      }
+      int32_t value = MultiplyByQuantizedMultiplier(sum, multiplier[oc], left_shift[oc], right_shift[oc]) +
+                      quant_param.output_.zp_;
+      expect[r * col + oc] = static_cast<int8_t>(MSMAX(-128, MSMIN(127, value)));
+    }
+  }
+
+  int block_num = BlockSparseNonzeroNumInt8(b.data(), filter_zp.data(), true, col, deep);
+  ASSERT_EQ(block_num, 2 * UP_DIV(deep, 3));
+  std::vector<char> packed(BlockSparsePackSizeInt8(col, block_num));
+  PackBlockSparseInt8(b.data(), filter_zp.data(), true, packed.data(), col, deep);
+
+  // two column ranges, as two threads would run them
+  std::vector<int8_t> out(row * col);
+  SparseMatMulInt8(a.data(), packed.data(), out.data(), bias.data(), &quant_param, true, deep, row, col, 0, 1);
+  SparseMatMulInt8(a.data(), packed.data(), out.data(), bias.data(), &quant_param, true, deep, row, col, 1, 3);
+  ASSERT_EQ(0, CompareOutputData(out.data(), expect.data(), row * col, 0));
+}
+
+TEST_F(TestMatmulInt8, SparseWeightMatmul) {
+  const int row = 5;
+  const int deep = 24;
+  const int col = 20;
+  std::vector<float> in(row * deep);
+  for (int i = 0; i < row * deep; ++i) {
+    in[i] = (i % 13 - 6) * 1.5f;
+  }
+  // every third deep index of the first and the partial last column block is nonzero, 78% of the blocks are zero
+  std::vector<float> weight(col * deep, 0.0f);
+  for (int oc = 0; oc < col; ++oc) {
+    for (int d = 0; oc / SPARSE_BLOCK != 1 && d < deep; d += 3) {
+      weight[oc * deep + d] = ((oc + d) % 9 - 4) * 0.2f;
+    }
+  }
+  std::vector<float> correct(row * col);
+  for (int r = 0; r < row; ++r) {
+    for (int oc = 0; oc < col; ++oc) {
+      float sum = 0.0f;
+      for (int d = 0; d < deep; ++d) {
+        sum += in[r * deep + d] * weight[oc * deep + d];
+      }
+      correct[r * col + oc] = sum;
+    }
+  }
+  std::vector<int> in_shape{1, row, deep};
+  std::vector<int> weight_shape{1, col, deep};
+  std::vector<int> out_shape{1, row, col};
+  TensorInfo in_params = {in.data(), -10, 10, row * deep, &in_shape};
+  TensorInfo weight_params = {weight.data(), -1, 1, col * deep, &weight_shape};
+  TensorInfo out_params = {correct.data(), -30, 30, row * col, &out_shape};
+
+  auto matmul_param = new MatMulParameter();
+  matmul_param->a_transpose_ = false;
+  matmul_param->b_transpose_ = true;
+  matmul_param->has_bias_ = false;
+  std::vector<lite::Tensor *> inputs;
+  std::vector<lite::Tensor *> outputs;
+  MMInt8TestInit(&inputs, &outputs, &in_params, &weight_params, &out_params);
+  auto ctx = new lite::InnerContext;
+  ctx->thread_num_ = 2;
+  ASSERT_EQ(lite::RET_OK, ctx->Init());
+  auto mm = new kernel::MatmulInt8CPUKernel(reinterpret_cast<OpParameter *>(matmul_param), inputs, outputs, ctx);
+  ASSERT_EQ(lite::RET_OK, mm->Init());
+  ASSERT_EQ(lite::RET_OK, mm->Run());
+  float out_scale;
+  int out_zp;
+  QuantProcess(correct.data(), out_params.len, out_params.min, out_params.max, &out_scale, &out_zp, nullptr);
+  std::vector<float> out(out_params.len);
+  Dequantize(reinterpret_cast<int8_t *>(outputs[0]->MutableData()), outputs[0]->ElementsNum(), out_scale, out_zp,
+             out.data());
+  ASSERT_EQ(0, CompareOutputData(out.data(), correct.data(), out_params.len, 0.5));
+  delete mm;
+  delete ctx;
+  for (auto t : inputs) delete t;
+  for (auto t : outputs) delete t;
+}
 }  // namespace mindspore
@@ -0,0 +1,95 @@
+/**
+ * Copyright 2021 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <string>
+#include <vector>
+#include "common/common_test.h"
+#include "src/runtime/packed_weight_cache.h"
+
+namespace mindspore {
+class PackedWeightCacheTest : public mindspore::CommonTest {
+ public:
+  PackedWeightCacheTest() {}
+};
+
+TEST_F(PackedWeightCacheTest, ShareSameWeight) {
+  auto cache = lite::PackedWeightCache::GetInstance();
+  auto entry_num = cache->entry_num();
+  std::vector<float> weight0 = {1, 2, 3, 4};
+  std::vector<float> weight1 = {1, 2, 3, 4};
+  std::vector<float> weight2 = {1, 2, 3, 5};
+  int pack_times = 0;
+  auto pack = [&pack_times](void *dst) {
+    pack_times++;
+    reinterpret_cast<float *>(dst)[0] = 1;
+  };
+  auto size = weight0.size() * sizeof(float);
+  auto digest0 = cache->Digest(weight0.data(), size, kNumberTypeFloat32, {2, 2});
+  auto digest1 = cache->Digest(weight1.data(), size, kNumberTypeFloat32, {2, 2});
+  auto digest2 = cache->Digest(weight2.data(), size, kNumberTypeFloat32, {2, 2});
+  auto packed0 = cache->GetOrPack("test", digest0, size, pack);
+  auto packed1 = cache->GetOrPack("test", digest1, size, pack);
+  auto packed2 = cache->GetOrPack("test", digest2, size, pack);
+  auto packed3 = cache->GetOrPack("test_other_layout", digest0, size, pack);
+  // the same bytes as another shape or type are another weight
+  auto packed4 = cache->GetOrPack("test", cache->Digest(weight0.data(), size, kNumberTypeFloat32, {4}), size, pack);
+  auto packed5 = cache->GetOrPack("test", cache->Digest(weight0.data(), size, kNumberTypeInt32, {2, 2}), size, pack);
+  ASSERT_NE(nullptr, packed0);
+  ASSERT_EQ(packed0, packed1);
+  ASSERT_NE(packed0, packed2);
+  ASSERT_NE(packed0, packed3);
+  ASSERT_NE(packed0, packed4);
+  ASSERT_NE(packed0, packed5);
+  ASSERT_EQ(5, pack_times);
+  ASSERT_EQ(entry_num + 5, cache->entry_num());
+  cache->Release(packed0);
+  ASSERT_EQ(entry_num + 5, cache->entry_num());
+  cache->Release(packed1);
+  cache->Release(packed2);
+  cache->Release(packed3);
+  cache->Release(packed4);
+  cache->Release(packed5);
+  ASSERT_EQ(entry_num, cache->entry_num());
+}
+
+TEST_F(PackedWeightCacheTest, DigestIsSha256) {
+  auto cache = lite::PackedWeightCache::GetInstance();
+  std::string one_block = "abc";
+  ASSERT_EQ(cache->Digest(one_block.data(), one_block.size(), kNumberTypeUInt8, {3}).sha256,
+            "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad");
+  // the padding of a 56 bytes message takes a second block
+  std::string two_blocks = "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq";
+  ASSERT_EQ(cache->Digest(two_blocks.data(), two_blocks.size(), kNumberTypeUInt8, {56}).sha256,
+            "248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1");
+  std::string million(1000000, 'a');
+  ASSERT_EQ(cache->Digest(million.data(), million.size(), kNumberTypeUInt8, {1000000}).sha256,
+            "cdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0");
+}
+
+TEST_F(PackedWeightCacheTest, DigestOncePerModelBuffer) {
+  auto cache = lite::PackedWeightCache::GetInstance();
+  std::vector<float> model_buf = {1, 2, 3, 4, 5, 6, 7, 8};
+  auto weight = model_buf.data() + 4;
+  auto size = 4 * sizeof(float);
+  cache->AddModelBuffer(model_buf.data(), model_buf.size() * sizeof(float));
+  auto digest = cache->Digest(weight, size, kNumberTypeFloat32, {4});
+  // a later session of the model reuses the digest instead of hashing the weight again
+  weight[0] = 0;
+  ASSERT_EQ(digest.sha256, cache->Digest(weight, size, kNumberTypeFloat32, {4}).sha256);
+  cache->RemoveModelBuffer(model_buf.data());
+  ASSERT_NE(digest.sha256, cache->Digest(weight, size, kNumberTypeFloat32, {4}).sha256);
+}
+}  // namespace mindspore
@@ -0,0 +1,97 @@
+/**
+ * Copyright 2021 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <memory>
+#include <vector>
+#include "common/common_test.h"
+#include "include/errorcode.h"
+#include "src/lite_kernel.h"
+#include "src/runtime/static_memory_planner.h"
+
+namespace mindspore {
+class StaticMemoryPlannerTest : public mindspore::CommonTest {
+ public:
+  StaticMemoryPlannerTest() {}
+};
+
+TEST_F(StaticMemoryPlannerTest, ReuseDisjointLifetime) {
+  // input -> k0 -> t1 -> k1 -> t2 -> k2 -> t3 -> k3 -> output
+  std::vector<std::shared_ptr<lite::Tensor>> tensors;
+  for (int i = 0; i < 5; i++) {
+    auto category = i == 0 ? lite::Tensor::GRAPH_INPUT : (i == 4 ? lite::Tensor::GRAPH_OUTPUT : lite::Tensor::VAR);
+    tensors.push_back(std::make_shared<lite::Tensor>(kNumberTypeFloat32, std::vector<int>{1, 100},
+                                                     schema::Format_NHWC, category));
+  }
+  std::vector<std::shared_ptr<kernel::LiteKernel>> kernels;
+  std::vector<kernel::LiteKernel *> kernel_list;
+  for (int i = 0; i < 4; i++) {
+    kernels.push_back(std::make_shared<kernel::LiteKernel>(nullptr, std::vector<lite::Tensor *>{tensors[i].get()},
+                                                           std::vector<lite::Tensor *>{tensors[i + 1].get()},
+                                                           nullptr));
+    kernel_list.push_back(kernels.back().get());
+  }
+  lite::StaticMemoryPlanner planner;
+  ASSERT_EQ(lite::RET_OK, planner.Plan(kernel_list, {tensors[0].get()}, {tensors[4].get()}));
+  // t1 and t3 are never alive at the same time
+  ASSERT_NE(nullptr, tensors[1]->data_c());
+  ASSERT_EQ(tensors[1]->data_c(), tensors[3]->data_c());
+  ASSERT_NE(tensors[1]->data_c(), tensors[2]->data_c());
+  ASSERT_EQ(nullptr, tensors[0]->data_c());
+  ASSERT_EQ(nullptr, tensors[4]->data_c());
+  ASSERT_FALSE(tensors[1]->own_data());
+  ASSERT_LT(planner.arena_size(), planner.total_size());
+  planner.Release();
+  ASSERT_EQ(nullptr, tensors[1]->data_c());
+  ASSERT_EQ(0u, planner.arena_size());
+}
+
+TEST_F(StaticMemoryPlannerTest, SkipDynamicShape) {
+  auto input = std::make_shared<lite::Tensor>(kNumberTypeFloat32, std::vector<int>{1, 100}, schema::Format_NHWC,
+                                              lite::Tensor::GRAPH_INPUT);
+  auto dynamic = std::make_shared<lite::Tensor>(kNumberTypeFloat32, std::vector<int>{-1, 100});
+  auto output = std::make_shared<lite::Tensor>(kNumberTypeFloat32, std::vector<int>{1, 100}, schema::Format_NHWC,
+                                               lite::Tensor::GRAPH_OUTPUT);
+  kernel::LiteKernel kernel0(nullptr, {input.get()}, {dynamic.get()}, nullptr);
+  kernel::LiteKernel kernel1(nullptr, {dynamic.get()}, {output.get()}, nullptr);
+  lite::StaticMemoryPlanner planner;
+  ASSERT_EQ(lite::RET_OK, planner.Plan({&kernel0, &kernel1}, {input.get()}, {output.get()}));
+  ASSERT_EQ(nullptr, dynamic->data_c());
+  ASSERT_EQ(0u, planner.arena_size());
+}
+
+TEST_F(StaticMemoryPlannerTest, ReuseArenaAcrossShapes) {
+  auto input = std::make_shared<lite::Tensor>(kNumberTypeFloat32, std::vector<int>{1, 100}, schema::Format_NHWC,
+                                              lite::Tensor::GRAPH_INPUT);
+  auto middle = std::make_shared<lite::Tensor>(kNumberTypeFloat32, std::vector<int>{1, 100});
+  auto output = std::make_shared<lite::Tensor>(kNumberTypeFloat32, std::vector<int>{1, 100}, schema::Format_NHWC,
+                                               lite::Tensor::GRAPH_OUTPUT);
+  kernel::LiteKernel kernel0(nullptr, {input.get()}, {middle.get()}, nullptr);
+  kernel::LiteKernel kernel1(nullptr, {middle.get()}, {output.get()}, nullptr);
+  lite::StaticMemoryPlanner planner;
+  ASSERT_EQ(lite::RET_OK, planner.Plan({&kernel0, &kernel1}, {input.get()}, {output.get()}));
+  auto first_data = middle->data_c();
+  auto first_arena_size = planner.arena_size();
+  // a smaller shape fits into the arena of the first plan
+  middle->set_shape({1, 10});
+  ASSERT_EQ(lite::RET_OK, planner.Plan({&kernel0, &kernel1}, {input.get()}, {output.get()}));
+  ASSERT_EQ(first_data, middle->data_c());
+  ASSERT_LT(planner.arena_size(), first_arena_size);
+  middle->set_shape({1, 100});
+  ASSERT_EQ(lite::RET_OK, planner.Plan({&kernel0, &kernel1}, {input.get()}, {output.get()}));
+  ASSERT_EQ(first_data, middle->data_c());
+  ASSERT_EQ(first_arena_size, planner.arena_size());
+}
+}  // namespace mindspore
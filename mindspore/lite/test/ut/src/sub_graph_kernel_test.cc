@@ -0,0 +1,160 @@
+/**
+ * Copyright 2021 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <utility>
+#include <vector>
+#include "common/common_test.h"
+#include "schema/ops_generated.h"
+#include "src/sub_graph_kernel.h"
+#include "src/runtime/kernel/arm/fp32/softmax_fp32.h"
+
+namespace mindspore {
+class SubGraphKernelTest : public mindspore::CommonTest {
+ public:
+  SubGraphKernelTest() {}
+};
+
+namespace {
+class ResizeCountKernel : public kernel::LiteKernel {
+ public:
+  ResizeCountKernel(std::vector<lite::Tensor *> in_tensors, std::vector<lite::Tensor *> out_tensors, int *resize_times,
+                    bool keep_shape_state)
+      : LiteKernel(NewParameter(), std::move(in_tensors), std::move(out_tensors), nullptr),
+        resize_times_(resize_times),
+        keep_shape_state_(keep_shape_state) {}
+  int Init() override { return lite::RET_OK; }
+  int ReSize() override {
+    (*resize_times_)++;
+    resized_size_ = in_tensors_.front()->ElementsNum();
+    return lite::RET_OK;
+  }
+  int Run() override { return lite::RET_OK; }
+  std::shared_ptr<kernel::KernelShapeState> SaveShapeState() override {
+    if (!keep_shape_state_) {
+      return nullptr;
+    }
+    auto state = std::make_shared<CountState>();
+    state->resized_size = resized_size_;
+    return state;
+  }
+  int RestoreShapeState(const std::shared_ptr<kernel::KernelShapeState> &state) override {
+    resized_size_ = std::static_pointer_cast<CountState>(state)->resized_size;
+    return lite::RET_OK;
+  }
+  int resized_size() const { return resized_size_; }
+
+ private:
+  struct CountState : public kernel::KernelShapeState {
+    int resized_size = 0;
+  };
+  static OpParameter *NewParameter() {
+    auto parameter = reinterpret_cast<OpParameter *>(malloc(sizeof(OpParameter)));
+    memset(parameter, 0, sizeof(OpParameter));
+    parameter->type_ = schema::PrimitiveType_Activation;
+    return parameter;
+  }
+  int *resize_times_;
+  bool keep_shape_state_;
+  int resized_size_ = 0;
+};
+}  // namespace
+
+TEST_F(SubGraphKernelTest, ResizeAlternatingShapes) {
+  auto input = std::make_shared<lite::Tensor>(kNumberTypeFloat32, std::vector<int>{1, 4}, schema::Format_NHWC,
+                                              lite::Tensor::GRAPH_INPUT);
+  auto middle = std::make_shared<lite::Tensor>(kNumberTypeFloat32, std::vector<int>{1, 4});
+  auto output = std::make_shared<lite::Tensor>(kNumberTypeFloat32, std::vector<int>{1, 4}, schema::Format_NHWC,
+                                               lite::Tensor::GRAPH_OUTPUT);
+  int resize_times0 = 0;
+  int resize_times1 = 0;
+  auto kernel0 = new ResizeCountKernel({input.get()}, {middle.get()}, &resize_times0, true);
+  auto kernel1 = new ResizeCountKernel({middle.get()}, {output.get()}, &resize_times1, false);
+  kernel::CpuFp32SubGraph sub_graph({input.get()}, {output.get()}, {kernel0}, {kernel1}, {kernel0, kernel1}, nullptr);
+
+  ASSERT_EQ(lite::RET_OK, sub_graph.ReSize());
+  ASSERT_EQ(resize_times0, 1);
+  ASSERT_EQ(resize_times1, 1);
+  // unchanged shapes skip the kernels
+  ASSERT_EQ(lite::RET_OK, sub_graph.ReSize());
+  ASSERT_EQ(resize_times0, 1);
+  ASSERT_EQ(resize_times1, 1);
+
+  // A -> B -> A -> B swaps in the saved state of kernel0, kernel1 keeps no state and is resized on every switch
+  input->set_shape({1, 8});
+  ASSERT_EQ(lite::RET_OK, sub_graph.ReSize());
+  ASSERT_EQ(std::vector<int>({1, 8}), output->shape());
+  ASSERT_EQ(resize_times0, 2);
+  ASSERT_EQ(resize_times1, 2);
+  ASSERT_EQ(kernel0->resized_size(), 8);
+  input->set_shape({1, 4});
+  ASSERT_EQ(lite::RET_OK, sub_graph.ReSize());
+  ASSERT_EQ(std::vector<int>({1, 4}), middle->shape());
+  ASSERT_EQ(std::vector<int>({1, 4}), output->shape());
+  ASSERT_EQ(resize_times0, 2);
+  ASSERT_EQ(resize_times1, 3);
+  ASSERT_EQ(kernel0->resized_size(), 4);
+  input->set_shape({1, 8});
+  ASSERT_EQ(lite::RET_OK, sub_graph.ReSize());
+  ASSERT_EQ(std::vector<int>({1, 8}), output->shape());
+  ASSERT_EQ(resize_times0, 2);
+  ASSERT_EQ(resize_times1, 4);
+  ASSERT_EQ(kernel0->resized_size(), 8);
+
+  // the least recently used signatures are dropped
+  for (int i = 1; i <= 8; i++) {
+    input->set_shape({2, i});
+    ASSERT_EQ(lite::RET_OK, sub_graph.ReSize());
+  }
+  ASSERT_EQ(resize_times0, 10);
+  input->set_shape({1, 8});
+  ASSERT_EQ(lite::RET_OK, sub_graph.ReSize());
+  ASSERT_EQ(resize_times0, 11);
+  ASSERT_EQ(kernel0->resized_size(), 8);
+}
+
+TEST_F(SubGraphKernelTest, SoftmaxShapeState) {
+  lite::InnerContext context;
+  auto input = std::make_shared<lite::Tensor>(kNumberTypeFloat32, std::vector<int>{2, 3, 4}, schema::Format_NHWC,
+                                              lite::Tensor::GRAPH_INPUT);
+  auto output = std::make_shared<lite::Tensor>(kNumberTypeFloat32, std::vector<int>{2, 3, 4}, schema::Format_NHWC,
+                                               lite::Tensor::GRAPH_OUTPUT);
+  auto parameter = reinterpret_cast<SoftmaxParameter *>(malloc(sizeof(SoftmaxParameter)));
+  memset(parameter, 0, sizeof(SoftmaxParameter));
+  parameter->op_parameter_.type_ = schema::PrimitiveType_Softmax;
+  parameter->axis_ = 1;
+  auto softmax = new kernel::SoftmaxCPUKernel(reinterpret_cast<OpParameter *>(parameter), {input.get()},
+                                              {output.get()}, &context);
+  kernel::CpuFp32SubGraph sub_graph({input.get()}, {output.get()}, {softmax}, {softmax}, {softmax}, &context);
+
+  ASSERT_EQ(lite::RET_OK, sub_graph.ReSize());
+  ASSERT_EQ(parameter->element_size_, 24);
+  input->set_shape({1, 5, 2, 2});
+  ASSERT_EQ(lite::RET_OK, sub_graph.ReSize());
+  ASSERT_EQ(std::vector<int>({1, 5, 2, 2}), output->shape());
+  ASSERT_EQ(parameter->n_dim_, 4);
+  ASSERT_EQ(parameter->element_size_, 20);
+  // switching back restores the parameter fields derived from the shape
+  input->set_shape({2, 3, 4});
+  ASSERT_EQ(lite::RET_OK, sub_graph.ReSize());
+  ASSERT_EQ(std::vector<int>({2, 3, 4}), output->shape());
+  ASSERT_EQ(parameter->n_dim_, 3);
+  ASSERT_EQ(parameter->element_size_, 24);
+  ASSERT_EQ(parameter->input_shape_[2], 4);
+}
+}  // namespace mindspore
@@ -0,0 +1,119 @@
+/**
+ * Copyright 2021 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+#include <nlohmann/json.hpp>
+#include "common/common_test.h"
+#include "src/tensor.h"
+#include "tools/benchmark/kernel_profiler.h"
+
+namespace mindspore {
+namespace lite {
+class KernelProfilerTest : public mindspore::CommonTest {
+ public:
+  KernelProfilerTest() {}
+};
+
+namespace {
+std::unique_ptr<Tensor> NewTensor(const std::vector<int> &shape) {
+  return std::make_unique<Tensor>(kNumberTypeFloat32, shape);
+}
+}  // namespace
+
+TEST_F(KernelProfilerTest, EstimateCost) {
+  // 3x3 conv of 16 to 32 channels on a 8x8 output, every output element takes 3 * 3 * 16 weights
+  auto input = NewTensor({1, 8, 8, 16});
+  auto weight = NewTensor({32, 3, 3, 16});
+  auto bias = NewTensor({32});
+  auto output = NewTensor({1, 8, 8, 32});
+  auto cost = KernelProfiler::EstimateCost("Conv2DFusion", {input.get(), weight.get(), bias.get()}, {output.get()});
+  ASSERT_DOUBLE_EQ(2.0 * 8 * 8 * 32 * 3 * 3 * 16 + 8 * 8 * 32, cost.flops);
+  ASSERT_DOUBLE_EQ(4.0 * (8 * 8 * 16 + 32 * 3 * 3 * 16 + 32 + 8 * 8 * 32), cost.bytes);
+
+  // [4, 64] x [64, 10]
+  auto matmul_input = NewTensor({4, 64});
+  auto matmul_weight = NewTensor({10, 64});
+  auto matmul_output = NewTensor({4, 10});
+  cost = KernelProfiler::EstimateCost("FullConnection", {matmul_input.get(), matmul_weight.get()},
+                                      {matmul_output.get()});
+  ASSERT_DOUBLE_EQ(2.0 * 4 * 10 * 64, cost.flops);
+
+  cost = KernelProfiler::EstimateCost("AddFusion", {output.get(), output.get()}, {output.get()});
+  ASSERT_DOUBLE_EQ(8 * 8 * 32, cost.flops);
+  ASSERT_DOUBLE_EQ(3 * 4.0 * 8 * 8 * 32, cost.bytes);
+  cost = KernelProfiler::EstimateCost("MaxPoolFusion", {output.get()}, {input.get()});
+  ASSERT_DOUBLE_EQ(8 * 8 * 32, cost.flops);
+  // kernels only moving data have no flops
+  cost = KernelProfiler::EstimateCost("Transpose", {output.get()}, {output.get()});
+  ASSERT_DOUBLE_EQ(0, cost.flops);
+  ASSERT_DOUBLE_EQ(2 * 4.0 * 8 * 8 * 32, cost.bytes);
+}
+
+TEST_F(KernelProfilerTest, Roofline) {
+  // 100 GFLOP/s and 10 GB/s meet at 10 FLOP/byte
+  auto point = KernelProfiler::Roofline({400, 100}, 100, 10);
+  ASSERT_DOUBLE_EQ(4, point.intensity);
+  ASSERT_DOUBLE_EQ(40, point.roof);
+  ASSERT_EQ("memory", point.bound);
+  point = KernelProfiler::Roofline({4000, 100}, 100, 10);
+  ASSERT_DOUBLE_EQ(100, point.roof);
+  ASSERT_EQ("compute", point.bound);
+  point = KernelProfiler::Roofline({0, 100}, 100, 10);
+  ASSERT_DOUBLE_EQ(0, point.roof);
+  ASSERT_EQ("data", point.bound);
+}
+
+TEST_F(KernelProfilerTest, ExportChromeTrace) {
+  auto input = NewTensor({1, 16});
+  auto output = NewTensor({1, 16});
+  std::vector<tensor::MSTensor *> inputs = {input.get()};
+  std::vector<tensor::MSTensor *> outputs = {output.get()};
+  // without a thread pool the kernels are profiled on the calling thread only
+  KernelProfiler profiler(nullptr, 1);
+  profiler.Start();
+  for (auto name : {"relu_1", "relu_2"}) {
+    CallBackParam param;
+    param.node_name = name;
+    param.node_type = "Activation";
+    ASSERT_TRUE(profiler.Before(inputs, outputs, param));
+    ASSERT_TRUE(profiler.After(inputs, outputs, param));
+  }
+  profiler.Stop();
+  std::string path = "./kernel_profiler_test_trace.json";
+  ASSERT_EQ(RET_OK, profiler.ExportChromeTrace(path));
+
+  std::ifstream in(path);
+  ASSERT_TRUE(in.is_open());
+  auto trace = nlohmann::json::parse(in);
+  auto &events = trace["traceEvents"];
+  // a complete event and a utilization counter per kernel
+  ASSERT_EQ(4u, events.size());
+  ASSERT_EQ("relu_1", events[0]["name"]);
+  ASSERT_EQ("Activation", events[0]["cat"]);
+  ASSERT_EQ("X", events[0]["ph"]);
+  ASSERT_DOUBLE_EQ(16, events[0]["args"]["flops"].get<double>());
+  ASSERT_DOUBLE_EQ(2 * 4 * 16, events[0]["args"]["bytes"].get<double>());
+  ASSERT_EQ("C", events[1]["ph"]);
+  ASSERT_EQ("relu_2", events[2]["name"]);
+  ASSERT_LE(events[0]["ts"].get<uint64_t>(), events[2]["ts"].get<uint64_t>());
+  in.close();
+  std::remove(path.c_str());
+}
+}  // namespace lite
+}  // namespace mindspore
@@ -0,0 +1,157 @@
+/**
+ * Copyright 2021 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <cstring>
+#include <memory>
+#include <vector>
+#include "common/common_test.h"
+#include "schema/inner/model_generated.h"
+#include "include/errorcode.h"
+#include "nnacl/fp32/sparse_matmul_fp32.h"
+#include "tools/converter/legacy_optimizer/graph/block_sparse_pass.h"
+
+namespace mindspore {
+class BlockSparsePassTest : public mindspore::CommonTest {
+ public:
+  BlockSparsePassTest() {}
+};
+
+namespace {
+constexpr int kCol = 24;
+constexpr int kDeep = 16;
+
+// three of the four deep rows of every column block are zero, the block sparsity is 0.75
+std::vector<float> PrunedWeight() {
+  std::vector<float> weight(kCol * kDeep, 0.0f);
+  for (int oc = 0; oc < kCol; ++oc) {
+    for (int d = 0; d < kDeep; d += 4) {
+      weight[oc * kDeep + d] = ((oc + d) % 5 - 2) * 0.5f + 0.25f;
+    }
+  }
+  return weight;
+}
+
+std::unique_ptr<schema::TensorT> WeightTensor(const std::vector<int> &dims, const std::vector<float> &weight) {
+  auto tensor = std::make_unique<schema::TensorT>();
+  tensor->nodeType = lite::NodeType_ValueNode;
+  tensor->format = schema::Format_NHWC;
+  tensor->dataType = TypeId::kNumberTypeFloat32;
+  tensor->dims = dims;
+  tensor->data.resize(weight.size() * sizeof(float));
+  memcpy(tensor->data.data(), weight.data(), tensor->data.size());
+  return tensor;
+}
+
+std::unique_ptr<schema::TensorT> VarTensor() {
+  auto tensor = std::make_unique<schema::TensorT>();
+  tensor->nodeType = lite::NodeType_ValueNode;
+  tensor->format = schema::Format_NHWC;
+  tensor->dataType = TypeId::kNumberTypeFloat32;
+  tensor->offset = -1;
+  return tensor;
+}
+
+// input -> FullConnection(weight 0) -> Conv2DFusion 1x1 (weight 1) -> Conv2DFusion 3x3 (weight 2)
+std::unique_ptr<schema::MetaGraphT> SparseGraph(const std::vector<float> &weight) {
+  auto graph = std::make_unique<schema::MetaGraphT>();
+  graph->name = "graph";
+  graph->allTensors.emplace_back(VarTensor());
+  graph->allTensors.emplace_back(WeightTensor({kCol, kDeep}, weight));
+  graph->allTensors.emplace_back(VarTensor());
+  graph->allTensors.emplace_back(WeightTensor({kCol, 1, 1, kDeep}, weight));
+  graph->allTensors.emplace_back(VarTensor());
+  auto conv3x3_weight = weight;
+  conv3x3_weight.resize(kCol * 3 * 3 * kDeep, 0.0f);
+  graph->allTensors.emplace_back(WeightTensor({kCol, 3, 3, kDeep}, conv3x3_weight));
+  graph->allTensors.emplace_back(VarTensor());
+
+  auto fc = std::make_unique<schema::CNodeT>();
+  fc->name = "fc";
+  fc->inputIndex = {0, 1};
+  fc->outputIndex = {2};
+  fc->primitive = std::make_unique<schema::PrimitiveT>();
+  fc->primitive->value.type = schema::PrimitiveType_FullConnection;
+  fc->primitive->value.value = new schema::FullConnectionT;
+  graph->nodes.emplace_back(std::move(fc));
+
+  for (int i = 0; i < 2; ++i) {
+    int64_t kernel = i == 0 ? 1 : 3;
+    auto conv = std::make_unique<schema::CNodeT>();
+    conv->name = i == 0 ? "conv1x1" : "conv3x3";
+    conv->inputIndex = {static_cast<uint32_t>(2 + 2 * i), static_cast<uint32_t>(3 + 2 * i)};
+    conv->outputIndex = {static_cast<uint32_t>(4 + 2 * i)};
+    conv->primitive = std::make_unique<schema::PrimitiveT>();
+    conv->primitive->value.type = schema::PrimitiveType_Conv2DFusion;
+    auto attr = new schema::Conv2DFusionT;
+    attr->group = 1;
+    attr->kernel_size = {kernel, kernel};
+    conv->primitive->value.value = attr;
+    graph->nodes.emplace_back(std::move(conv));
+  }
+  graph->inputIndex = {0};
+  graph->outputIndex = {6};
+  return graph;
+}
+
+void ExpectBlockSparse(const schema::TensorT &tensor, const std::vector<float> &weight) {
+  ASSERT_EQ(schema::WeightQunatCompressType_BLOCK_SPARSE, tensor.weightQunatCompressType);
+  ASSERT_LT(tensor.data.size(), weight.size() * sizeof(float));
+  std::vector<float> unpacked(weight.size());
+  ASSERT_EQ(NNACL_OK, UnpackBlockSparse(tensor.data.data(), tensor.data.size(), unpacked.data(), kCol, kDeep));
+  EXPECT_EQ(0, memcmp(unpacked.data(), weight.data(), weight.size() * sizeof(float)));
+}
+
+void ExpectDense(const schema::TensorT &tensor, const std::vector<float> &weight) {
+  ASSERT_EQ(schema::WeightQunatCompressType_NONE, tensor.weightQunatCompressType);
+  ASSERT_EQ(weight.size() * sizeof(float), tensor.data.size());
+  EXPECT_EQ(0, memcmp(tensor.data.data(), weight.data(), tensor.data.size()));
+}
+}  // namespace
+
+TEST_F(BlockSparsePassTest, PackWeightsOverThreshold) {
+  auto weight = PrunedWeight();
+  auto graph = SparseGraph(weight);
+  lite::BlockSparsePass pass(0.5f);
+  ASSERT_EQ(lite::RET_OK, pass.Run(graph.get()));
+  ExpectBlockSparse(*graph->allTensors.at(1), weight);
+  ExpectBlockSparse(*graph->allTensors.at(3), weight);
+  // only 1x1 convolutions run the block sparse GEMM
+  auto conv3x3_weight = weight;
+  conv3x3_weight.resize(kCol * 3 * 3 * kDeep, 0.0f);
+  ExpectDense(*graph->allTensors.at(5), conv3x3_weight);
+}
+
+TEST_F(BlockSparsePassTest, KeepWeightsUnderThreshold) {
+  auto weight = PrunedWeight();
+  auto graph = SparseGraph(weight);
+  lite::BlockSparsePass pass(0.8f);
+  ASSERT_EQ(lite::RET_OK, pass.Run(graph.get()));
+  ExpectDense(*graph->allTensors.at(1), weight);
+  ExpectDense(*graph->allTensors.at(3), weight);
+}
+
+TEST_F(BlockSparsePassTest, KeepGroupAndQuantizedWeights) {
+  auto weight = PrunedWeight();
+  auto graph = SparseGraph(weight);
+  graph->nodes.at(1)->primitive->value.AsConv2DFusion()->group = 2;
+  auto quant_param = std::make_unique<schema::QuantParamT>();
+  quant_param->inited = true;
+  graph->allTensors.at(1)->quantParams.emplace_back(std::move(quant_param));
+  lite::BlockSparsePass pass(0.5f);
+  ASSERT_EQ(lite::RET_OK, pass.Run(graph.get()));
+  ExpectDense(*graph->allTensors.at(1), weight);
+  ExpectDense(*graph->allTensors.at(3), weight);
+}
+}  // namespace mindspore
@@ -0,0 +1,135 @@
+/**
+ * Copyright 2021 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+#include "common/common_test.h"
+#include "schema/inner/model_generated.h"
+#include "include/errorcode.h"
+#include "tools/common/graph_util.h"
+#include "tools/converter/legacy_optimizer/graph/isolated_node_remove_pass.h"
+#include "tools/converter/legacy_optimizer/graph/transpose_fusion_pass.h"
+
+namespace mindspore {
+class TransposeFusionPassTest : public mindspore::CommonTest {
+ public:
+  TransposeFusionPassTest() {}
+};
+
+namespace {
+const std::vector<int> kNH2NC = {0, 3, 1, 2};
+const std::vector<int> kNC2NH = {0, 2, 3, 1};
+
+uint32_t AddVarTensor(schema::MetaGraphT *graph) {
+  auto tensor = std::make_unique<schema::TensorT>();
+  tensor->nodeType = lite::NodeType_CNode;
+  tensor->format = schema::Format_NHWC;
+  tensor->dataType = TypeId::kNumberTypeFloat32;
+  graph->allTensors.emplace_back(std::move(tensor));
+  return graph->allTensors.size() - 1;
+}
+
+uint32_t AddPermTensor(schema::MetaGraphT *graph, const std::vector<int> &perm) {
+  auto tensor = std::make_unique<schema::TensorT>();
+  tensor->nodeType = lite::NodeType_ValueNode;
+  tensor->format = schema::Format_NHWC;
+  tensor->dataType = TypeId::kNumberTypeInt32;
+  tensor->dims = {static_cast<int32_t>(perm.size())};
+  tensor->data.resize(perm.size() * sizeof(int));
+  memcpy(tensor->data.data(), perm.data(), tensor->data.size());
+  graph->allTensors.emplace_back(std::move(tensor));
+  return graph->allTensors.size() - 1;
+}
+
+// appends a node reading input, returns its output tensor
+uint32_t AddNode(schema::MetaGraphT *graph, schema::PrimitiveType type, const std::string &name, uint32_t input,
+                 const std::vector<int> &perm = {}) {
+  auto node = std::make_unique<schema::CNodeT>();
+  node->name = name;
+  node->primitive = std::make_unique<schema::PrimitiveT>();
+  node->primitive->value.type = type;
+  if (type == schema::PrimitiveType_Transpose) {
+    node->primitive->value.value = new schema::TransposeT;
+    node->inputIndex = {input, AddPermTensor(graph, perm)};
+  } else {
+    node->primitive->value.value = new schema::ActivationT;
+    node->inputIndex = {input};
+  }
+  node->outputIndex = {AddVarTensor(graph)};
+  graph->nodes.emplace_back(std::move(node));
+  return graph->nodes.back()->outputIndex.front();
+}
+
+void RunPasses(schema::MetaGraphT *graph) {
+  lite::TransposeFusionPass fusion_pass;
+  ASSERT_EQ(lite::RET_OK, fusion_pass.Run(graph));
+  lite::IsolatedNodeRemovePass remove_pass;
+  ASSERT_EQ(lite::RET_OK, remove_pass.Run(graph));
+}
+
+std::vector<std::string> NodeNames(const schema::MetaGraphT &graph) {
+  std::vector<std::string> names;
+  for (auto &node : graph.nodes) {
+    names.push_back(node->name);
+  }
+  return names;
+}
+}  // namespace
+
+// input -> to nchw -> to nhwc -> relu, the pair cancels out
+TEST_F(TransposeFusionPassTest, CancelPair) {
+  auto graph = std::make_unique<schema::MetaGraphT>();
+  auto input = AddVarTensor(graph.get());
+  graph->inputIndex = {input};
+  auto tensor = AddNode(graph.get(), schema::PrimitiveType_Transpose, "pre_trans", input, kNH2NC);
+  tensor = AddNode(graph.get(), schema::PrimitiveType_Transpose, "post_trans", tensor, kNC2NH);
+  graph->outputIndex = {AddNode(graph.get(), schema::PrimitiveType_Activation, "relu", tensor)};
+
+  RunPasses(graph.get());
+  ASSERT_EQ(std::vector<std::string>({"relu"}), NodeNames(*graph));
+  ASSERT_EQ(graph->inputIndex, graph->nodes.front()->inputIndex);
+}
+
+// input -> to nhwc -> swap h and w -> relu, the pair folds into one transpose
+TEST_F(TransposeFusionPassTest, FoldPair) {
+  auto graph = std::make_unique<schema::MetaGraphT>();
+  auto input = AddVarTensor(graph.get());
+  graph->inputIndex = {input};
+  auto tensor = AddNode(graph.get(), schema::PrimitiveType_Transpose, "pre_trans", input, kNC2NH);
+  tensor = AddNode(graph.get(), schema::PrimitiveType_Transpose, "post_trans", tensor, {0, 2, 1, 3});
+  graph->outputIndex = {AddNode(graph.get(), schema::PrimitiveType_Activation, "relu", tensor)};
+
+  RunPasses(graph.get());
+  ASSERT_EQ(std::vector<std::string>({"post_trans", "relu"}), NodeNames(*graph));
+  ASSERT_EQ(graph->inputIndex.front(), graph->nodes.front()->inputIndex.front());
+  ASSERT_EQ(std::vector<int>({0, 3, 2, 1}), lite::GetTransposePerm(graph.get(), graph->nodes.front()));
+}
+
+// an identity transpose is dropped unless it produces the graph output
+TEST_F(TransposeFusionPassTest, DropIdentity) {
+  auto graph = std::make_unique<schema::MetaGraphT>();
+  auto input = AddVarTensor(graph.get());
+  graph->inputIndex = {input};
+  auto tensor = AddNode(graph.get(), schema::PrimitiveType_Transpose, "identity", input, {0, 1, 2, 3});
+  tensor = AddNode(graph.get(), schema::PrimitiveType_Activation, "relu", tensor);
+  graph->outputIndex = {AddNode(graph.get(), schema::PrimitiveType_Transpose, "output_identity", tensor, {0, 1})};
+
+  RunPasses(graph.get());
+  ASSERT_EQ(std::vector<std::string>({"relu", "output_identity"}), NodeNames(*graph));
+  ASSERT_EQ(graph->inputIndex, graph->nodes.front()->inputIndex);
+}
+}  // namespace mindspore
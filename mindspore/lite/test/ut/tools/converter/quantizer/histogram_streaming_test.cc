@@ -0,0 +1,159 @@
+/**
+ * Copyright 2021 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cmath>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <vector>
+#include "common/common_test.h"
+#include "ir/func_graph.h"
+#include "tools/converter/quantizer/post_training_quantizer.h"
+
+namespace mindspore {
+class HistogramStreamingTest : public mindspore::CommonTest {
+ public:
+  HistogramStreamingTest() {}
+};
+
+namespace {
+constexpr int kBinNum = 2048;
+constexpr size_t kBitNum = 8;
+constexpr int kQuantMax = 127;
+constexpr int kQuantMin = -127;
+
+CNodePtr MakeCNode(const FuncGraphPtr &func_graph) {
+  return func_graph->NewCNode({NewValueNode(std::make_shared<Primitive>("Calibrated"))});
+}
+
+lite::quant::DivergInfo MakeInfo(const CNodePtr &cnode) {
+  return lite::quant::DivergInfo(cnode, kBinNum, kBitNum, kQuantMax, kQuantMin, lite::quant::kMethodKL);
+}
+
+// uniform data in [-1, 1], later batches carry outliers which widen the range after the histogram was started
+std::vector<std::vector<float>> MakeBatches(float outlier, size_t batch_size, int seed) {
+  std::mt19937 gen(seed);
+  std::uniform_real_distribution<float> bulk(-1.0f, 1.0f);
+  std::vector<std::vector<float>> batches;
+  constexpr int kBatchNum = 8;
+  for (int b = 0; b < kBatchNum; b++) {
+    std::vector<float> batch(batch_size);
+    for (auto &value : batch) {
+      value = bulk(gen);
+    }
+    if (b >= kBatchNum / 2) {
+      batch[b] = outlier;
+      batch[b + 1] = -0.9f * outlier;
+    }
+    batches.push_back(batch);
+  }
+  return batches;
+}
+
+void FullPass(const std::vector<std::vector<float>> &batches, lite::quant::DivergInfo *info) {
+  for (auto &batch : batches) {
+    ASSERT_EQ(lite::RET_OK, info->RecordMaxValue(batch));
+  }
+  info->UpdateInterval();
+  for (auto &batch : batches) {
+    ASSERT_EQ(lite::RET_OK, info->UpdateHistogram(batch));
+  }
+}
+
+void StreamingPass(const std::vector<std::vector<float>> &batches, lite::quant::DivergInfo *info) {
+  for (auto &batch : batches) {
+    ASSERT_EQ(lite::RET_OK, info->RecordMaxValue(batch));
+    ASSERT_EQ(lite::RET_OK, info->UpdateHistogramStreaming(batch));
+  }
+}
+
+float HistogramSum(const lite::quant::DivergInfo &info) {
+  return std::accumulate(info.histogram.begin(), info.histogram.end(), 0.0f);
+}
+}  // namespace
+
+TEST_F(HistogramStreamingTest, RescaleByPowerOfTwo) {
+  auto func_graph = std::make_shared<FuncGraph>();
+  auto cnode = MakeCNode(func_graph);
+  std::vector<std::vector<float>> batches = {{0.3f, -0.55f, 0.8f, 1.0f}, {-2.5f, 3.1f, 4.0f}};
+  auto full = MakeInfo(cnode);
+  auto streaming = MakeInfo(cnode);
+  FullPass(batches, &full);
+  StreamingPass(batches, &streaming);
+
+  // a range growing from 1 to 4 merges every four bins, which lands on the grid of the full pass
+  ASSERT_FLOAT_EQ(full.interval, streaming.interval);
+  ASSERT_NEAR(HistogramSum(full), HistogramSum(streaming), 1e-3);
+  for (int i = 0; i < kBinNum; i++) {
+    // 1.0 is clamped into the last bin of the first range, one bin below its full pass bin
+    if (i == 511 || i == 512) {
+      continue;
+    }
+    ASSERT_NEAR(full.histogram[i], streaming.histogram[i], 1e-5) << "bin " << i;
+  }
+  ASSERT_NEAR(full.histogram[511] + full.histogram[512], streaming.histogram[511] + streaming.histogram[512], 1e-5);
+  ASSERT_NEAR(streaming.histogram[153], 1.0f, 1e-5);
+  ASSERT_NEAR(streaming.histogram[281], 1.0f, 1e-5);
+  ASSERT_NEAR(streaming.histogram[kBinNum - 1], 1.0f, 1e-5);
+}
+
+TEST_F(HistogramStreamingTest, StreamingThresholdMatchesFullPass) {
+  auto func_graph = std::make_shared<FuncGraph>();
+  auto cnode = MakeCNode(func_graph);
+  constexpr size_t kBatchSize = 8192;
+  for (float outlier : {3.0f, 6.0f, 10.0f}) {
+    auto batches = MakeBatches(outlier, kBatchSize, 1);
+    auto full = MakeInfo(cnode);
+    auto streaming = MakeInfo(cnode);
+    FullPass(batches, &full);
+    StreamingPass(batches, &streaming);
+    ASSERT_GE(streaming.interval * kBinNum, outlier);
+    ASSERT_NEAR(HistogramSum(full), HistogramSum(streaming), 1.0f);
+
+    ASSERT_EQ(lite::RET_OK, full.ComputeThreshold());
+    ASSERT_EQ(lite::RET_OK, streaming.ComputeThreshold());
+    // outliers are clipped, both pick the edge of the bulk within one bin of the coarser histogram
+    ASSERT_NEAR(full.best_T, 1.0f, 0.01f) << "outlier " << outlier;
+    ASSERT_NEAR(full.best_T, streaming.best_T, streaming.interval) << "outlier " << outlier;
+  }
+}
+
+TEST_F(HistogramStreamingTest, MergedShardsMatchFullPass) {
+  auto func_graph = std::make_shared<FuncGraph>();
+  auto cnode = MakeCNode(func_graph);
+  constexpr size_t kBatchSize = 8192;
+  auto batches = MakeBatches(6.0f, kBatchSize, 2);
+  auto full = MakeInfo(cnode);
+  FullPass(batches, &full);
+
+  // the first shard only sees the bulk, the second one the outliers, so merging has to widen the first histogram
+  std::vector<std::vector<float>> shard0(batches.begin(), batches.begin() + batches.size() / 2);
+  std::vector<std::vector<float>> shard1(batches.begin() + batches.size() / 2, batches.end());
+  auto merged = MakeInfo(cnode);
+  auto other = MakeInfo(cnode);
+  StreamingPass(shard0, &merged);
+  StreamingPass(shard1, &other);
+  ASSERT_LT(merged.interval * kBinNum, other.interval * kBinNum);
+  merged.MergeMaxMin(other);
+  merged.MergeHistogram(other);
+  ASSERT_GE(merged.interval * kBinNum, 6.0f);
+  ASSERT_NEAR(HistogramSum(full), HistogramSum(merged), 1.0f);
+
+  ASSERT_EQ(lite::RET_OK, full.ComputeThreshold());
+  ASSERT_EQ(lite::RET_OK, merged.ComputeThreshold());
+  ASSERT_NEAR(full.best_T, merged.best_T, merged.interval);
+}
+}  // namespace mindspore
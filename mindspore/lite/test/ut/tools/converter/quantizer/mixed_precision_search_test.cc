@@ -0,0 +1,137 @@
+/**
+ * Copyright 2021 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <map>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+#include "common/common_test.h"
+#include "tools/converter/quantizer/post_training_quantizer.h"
+
+namespace mindspore {
+class MixedPrecisionSearchTest : public mindspore::CommonTest {
+ public:
+  MixedPrecisionSearchTest() {}
+};
+
+namespace {
+struct OpProfile {
+  double fp32_cost;
+  double int8_cost;
+  // output error added when the op is quantized
+  float error;
+};
+
+// a tiny model whose latency and error add up over its ops
+class TinyModel {
+ public:
+  explicit TinyModel(std::map<std::string, OpProfile> ops) : ops_(std::move(ops)) {}
+
+  lite::quant::MixedPrecisionProfile Profile() {
+    lite::quant::MixedPrecisionProfile profile;
+    for (auto &kv : ops_) {
+      profile.ops.push_back(kv.first);
+      profile.fp32_costs[kv.first] = kv.second.fp32_cost;
+      profile.int8_costs[kv.first] = kv.second.int8_cost;
+    }
+    std::set<std::string> all_ops(profile.ops.begin(), profile.ops.end());
+    Run(all_ops, &profile.fp32_latency, nullptr);
+    Run({}, &profile.int8_latency, &profile.int8_error);
+    return profile;
+  }
+
+  lite::quant::CandidateEvaluator Evaluator() {
+    return [this](const std::set<std::string> &fp32_ops, double *latency, float *error) {
+      evaluate_times_++;
+      Run(fp32_ops, latency, error);
+      return lite::RET_OK;
+    };
+  }
+
+  int evaluate_times() const { return evaluate_times_; }
+
+ private:
+  void Run(const std::set<std::string> &fp32_ops, double *latency, float *error) {
+    *latency = 0;
+    float total_error = 0;
+    for (auto &kv : ops_) {
+      if (fp32_ops.find(kv.first) != fp32_ops.end()) {
+        *latency += kv.second.fp32_cost;
+      } else {
+        *latency += kv.second.int8_cost;
+        total_error += kv.second.error;
+      }
+    }
+    if (error != nullptr) {
+      *error = total_error;
+    }
+  }
+
+  std::map<std::string, OpProfile> ops_;
+  int evaluate_times_ = 0;
+};
+
+constexpr float kMaxAccuracyLoss = 0.1f;
+}  // namespace
+
+TEST_F(MixedPrecisionSearchTest, SensitiveOpsStayFp32) {
+  // conv1 has the largest gain and alone breaks the budget, so it must not keep the ops behind it in fp32
+  TinyModel model({{"conv1", {10, 4, 0.5f}},
+                   {"conv2", {8, 3, 0.01f}},
+                   {"fc", {6, 2, 0.3f}},
+                   {"add", {2, 1.5, 0.01f}},
+                   {"softmax", {1, 1.2, 0.0f}}});
+  std::set<std::string> fp32_ops;
+  ASSERT_EQ(lite::RET_OK,
+            lite::quant::SearchMixedPrecision(model.Profile(), kMaxAccuracyLoss, model.Evaluator(), &fp32_ops));
+  // conv1 and fc are above the error budget, softmax is slower in int8
+  ASSERT_EQ(std::set<std::string>({"conv1", "fc", "softmax"}), fp32_ops);
+}
+
+TEST_F(MixedPrecisionSearchTest, AllOpsWithinBudget) {
+  TinyModel model({{"conv1", {10, 4, 0.001f}},
+                   {"conv2", {8, 3, 0.001f}},
+                   {"fc", {6, 2, 0.001f}},
+                   {"softmax", {1, 1.2, 0.0f}}});
+  std::set<std::string> fp32_ops;
+  ASSERT_EQ(lite::RET_OK,
+            lite::quant::SearchMixedPrecision(model.Profile(), kMaxAccuracyLoss, model.Evaluator(), &fp32_ops));
+  ASSERT_EQ(std::set<std::string>({"softmax"}), fp32_ops);
+
+  TinyModel faster_model({{"conv1", {10, 4, 0.001f}}, {"conv2", {8, 3, 0.001f}}});
+  ASSERT_EQ(lite::RET_OK, lite::quant::SearchMixedPrecision(faster_model.Profile(), kMaxAccuracyLoss,
+                                                            faster_model.Evaluator(), &fp32_ops));
+  ASSERT_TRUE(fp32_ops.empty());
+}
+
+TEST_F(MixedPrecisionSearchTest, AllOpsAboveBudget) {
+  TinyModel model({{"conv1", {10, 4, 0.5f}}, {"conv2", {8, 3, 0.2f}}, {"fc", {6, 2, 0.3f}}});
+  std::set<std::string> fp32_ops;
+  ASSERT_EQ(lite::RET_OK,
+            lite::quant::SearchMixedPrecision(model.Profile(), kMaxAccuracyLoss, model.Evaluator(), &fp32_ops));
+  ASSERT_EQ(std::set<std::string>({"conv1", "conv2", "fc"}), fp32_ops);
+  // the prefix search and one try per op behind the failing prefix
+  ASSERT_LE(model.evaluate_times(), 4);
+}
+
+TEST_F(MixedPrecisionSearchTest, EvaluateFailed) {
+  TinyModel model({{"conv1", {10, 4, 0.5f}}, {"conv2", {8, 3, 0.2f}}});
+  std::set<std::string> fp32_ops;
+  auto evaluate = [](const std::set<std::string> &, double *, float *) { return lite::RET_ERROR; };
+  ASSERT_EQ(lite::RET_ERROR, lite::quant::SearchMixedPrecision(model.Profile(), kMaxAccuracyLoss, evaluate, &fp32_ops));
+}
+}  // namespace mindspore
@@ -0,0 +1,187 @@
+/**
+ * Copyright 2021 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <memory>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+#include "common/common_test.h"
+#include "ir/func_graph.h"
+#include "ir/manager.h"
+#include "ops/fusion/activation.h"
+#include "ops/fusion/add_fusion.h"
+#include "tools/optimizer/common/format_utils.h"
+#include "tools/optimizer/common/gllo_utils.h"
+#include "tools/optimizer/graph/unify_format_pass.h"
+
+namespace mindspore {
+class UnifyFormatPassTest : public mindspore::CommonTest {
+ public:
+  UnifyFormatPassTest() = default;
+};
+
+namespace {
+const std::vector<int> kNH2NC = {0, 3, 1, 2};
+const std::vector<int> kNC2NH = {0, 2, 3, 1};
+
+ParameterPtr AddInput(const FuncGraphPtr &func_graph) {
+  auto input = func_graph->add_parameter();
+  input->set_name("input");
+  return input;
+}
+
+CNodePtr AddTranspose(const FuncGraphPtr &func_graph, const AnfNodePtr &input, const std::vector<int> &perm,
+                      const std::string &name) {
+  return opt::GenTransposeNode(func_graph, input, perm, name);
+}
+
+CNodePtr AddNode(const FuncGraphPtr &func_graph, const PrimitivePtr &prim, const std::vector<AnfNodePtr> &inputs,
+                 const ShapeVector &output_shape) {
+  std::vector<AnfNodePtr> node_inputs = {NewValueNode(prim)};
+  node_inputs.insert(node_inputs.end(), inputs.begin(), inputs.end());
+  auto cnode = func_graph->NewCNode(node_inputs);
+  cnode->set_abstract(std::make_shared<abstract::AbstractTensor>(kFloat32, output_shape));
+  return cnode;
+}
+
+// nhwc input -> to nchw -> agnostic ops -> back to nhwc, other inputs of the area are in nchw
+CNodePtr AddNchwArea(const FuncGraphPtr &func_graph, const AnfNodePtr &input) {
+  const ShapeVector nchw_shape = {1, 3, 8, 8};
+  auto pre_trans = AddTranspose(func_graph, input, kNH2NC, "pre_trans");
+  pre_trans->set_abstract(std::make_shared<abstract::AbstractTensor>(kFloat32, nchw_shape));
+  auto activation = std::make_shared<ops::Activation>();
+  activation->set_activation_type(RELU);
+  return AddNode(func_graph, activation, {pre_trans}, nchw_shape);
+}
+
+std::vector<int> TransposePerm(const AnfNodePtr &node) {
+  std::vector<int> perm;
+  if (!opt::CheckPrimitiveType(node, prim::kPrimTranspose) ||
+      opt::GetTransposePerm(node->cast<CNodePtr>(), &perm) != lite::RET_OK) {
+    return {};
+  }
+  return perm;
+}
+}  // namespace
+
+TEST_F(UnifyFormatPassTest, ComposePerm) {
+  ASSERT_TRUE(opt::IsIdentityPerm(opt::ComposePerm(kNC2NH, kNH2NC)));
+  ASSERT_TRUE(opt::IsIdentityPerm(opt::ComposePerm(kNH2NC, kNC2NH)));
+  ASSERT_TRUE(opt::IsIdentityPerm(opt::ComposePerm({1, 0, 2}, {1, 0, 2})));
+  ASSERT_EQ(std::vector<int>({0, 3, 2, 1}), opt::ComposePerm(kNC2NH, {0, 2, 1, 3}));
+  // negative axes count from the back
+  ASSERT_TRUE(opt::IsIdentityPerm(opt::ComposePerm({1, 0}, {-1, -2})));
+  ASSERT_TRUE(opt::ComposePerm(kNC2NH, {1, 0, 2}).empty());
+  ASSERT_TRUE(opt::ComposePerm(kNC2NH, {0, 1, 2, 4}).empty());
+  ASSERT_FALSE(opt::IsIdentityPerm({}));
+}
+
+TEST_F(UnifyFormatPassTest, CancelIdentityPair) {
+  auto func_graph = std::make_shared<FuncGraph>();
+  auto input = AddInput(func_graph);
+  auto pre_trans = AddTranspose(func_graph, input, {0, 2, 1, 3}, "pre_trans");
+  auto post_trans = AddTranspose(func_graph, pre_trans, {0, 2, 1, 3}, "post_trans");
+  func_graph->set_output(post_trans);
+
+  opt::UnifyFormatPass pass;
+  ASSERT_TRUE(pass.EliminateRedundantTranspose(func_graph));
+  // both transposes are gone
+  ASSERT_EQ(func_graph->output(), input);
+}
+
+TEST_F(UnifyFormatPassTest, FoldNonIdentityPair) {
+  auto func_graph = std::make_shared<FuncGraph>();
+  auto input = AddInput(func_graph);
+  auto pre_trans = AddTranspose(func_graph, input, kNC2NH, "pre_trans");
+  auto post_trans = AddTranspose(func_graph, pre_trans, {0, 2, 1, 3}, "post_trans");
+  func_graph->set_output(post_trans);
+
+  opt::UnifyFormatPass pass;
+  ASSERT_TRUE(pass.EliminateRedundantTranspose(func_graph));
+  // one transpose of the input with the composed perm is left
+  auto output = func_graph->output();
+  ASSERT_EQ(std::vector<int>({0, 3, 2, 1}), TransposePerm(output));
+  ASSERT_EQ(output->cast<CNodePtr>()->input(1), input);
+}
+
+TEST_F(UnifyFormatPassTest, KeepSharedTranspose) {
+  auto func_graph = std::make_shared<FuncGraph>();
+  auto input = AddInput(func_graph);
+  auto pre_trans = AddTranspose(func_graph, input, kNC2NH, "pre_trans");
+  auto fold_trans = AddTranspose(func_graph, pre_trans, {0, 2, 1, 3}, "fold_trans");
+  auto cancel_trans = AddTranspose(func_graph, pre_trans, kNH2NC, "cancel_trans");
+  auto make_tuple = func_graph->NewCNode({NewValueNode(prim::kPrimMakeTuple), fold_trans, cancel_trans, pre_trans});
+  func_graph->set_output(make_tuple);
+
+  opt::UnifyFormatPass pass;
+  ASSERT_TRUE(pass.EliminateRedundantTranspose(func_graph));
+  auto output = func_graph->output()->cast<CNodePtr>();
+  ASSERT_NE(output, nullptr);
+  // pre_trans has other consumers, folding fold_trans into it would not remove a transpose
+  ASSERT_EQ(output->input(1), fold_trans);
+  ASSERT_EQ(fold_trans->input(1), pre_trans);
+  ASSERT_EQ(std::vector<int>({0, 2, 1, 3}), TransposePerm(fold_trans));
+  ASSERT_EQ(kNC2NH, TransposePerm(pre_trans));
+  // a pair composing to identity is cancelled even if the first transpose is shared
+  ASSERT_EQ(output->input(2), input);
+  ASSERT_EQ(output->input(3), pre_trans);
+}
+
+TEST_F(UnifyFormatPassTest, FlipAreaWithForeignInput) {
+  auto func_graph = std::make_shared<FuncGraph>();
+  auto input = AddInput(func_graph);
+  input->set_abstract(std::make_shared<abstract::AbstractTensor>(kFloat32, ShapeVector{1, 8, 8, 3}));
+  auto nchw_input = func_graph->add_parameter();
+  nchw_input->set_name("nchw_input");
+  nchw_input->set_abstract(std::make_shared<abstract::AbstractTensor>(kFloat32, ShapeVector{1, 3, 8, 8}));
+  auto relu = AddNchwArea(func_graph, input);
+  auto add = AddNode(func_graph, std::make_shared<ops::AddFusion>(), {relu, nchw_input}, {1, 3, 8, 8});
+  auto post_trans = AddTranspose(func_graph, add, kNC2NH, "post_trans");
+  func_graph->set_output(post_trans);
+  Manage(func_graph, true);
+
+  opt::UnifyFormatPass pass;
+  opt::LayoutArea area;
+  ASSERT_EQ(lite::RET_OK, pass.FindLayoutArea(func_graph, relu->input(1)->cast<CNodePtr>(), &area));
+  ASSERT_EQ(1u, area.in_transposes.size());
+  ASSERT_EQ(1u, area.out_transposes.size());
+  ASSERT_EQ(std::set<CNodePtr>({relu, add}), area.middle_nodes);
+  // the nchw input needs a transpose in nhwc, which still saves one of the two transposes
+  ASSERT_EQ(1u, area.in_edges.size());
+  ASSERT_EQ(std::make_pair(add, static_cast<size_t>(2)), *area.in_edges.begin());
+  ASSERT_TRUE(area.out_edges.empty());
+  ASSERT_TRUE(pass.IsFlipProfitable(area));
+}
+
+TEST_F(UnifyFormatPassTest, KeepAreaWithoutSavings) {
+  auto func_graph = std::make_shared<FuncGraph>();
+  auto input = AddInput(func_graph);
+  input->set_abstract(std::make_shared<abstract::AbstractTensor>(kFloat32, ShapeVector{1, 8, 8, 3}));
+  auto relu = AddNchwArea(func_graph, input);
+  // the graph output expects nchw, running relu in nhwc would only move the transpose behind it
+  func_graph->set_output(relu);
+  Manage(func_graph, true);
+
+  opt::UnifyFormatPass pass;
+  opt::LayoutArea area;
+  ASSERT_EQ(lite::RET_OK, pass.FindLayoutArea(func_graph, relu->input(1)->cast<CNodePtr>(), &area));
+  ASSERT_EQ(1u, area.in_transposes.size());
+  ASSERT_TRUE(area.out_transposes.empty());
+  ASSERT_EQ(1u, area.out_edges.size());
+  ASSERT_FALSE(pass.IsFlipProfitable(area));
+}
+}  // namespace mindspore
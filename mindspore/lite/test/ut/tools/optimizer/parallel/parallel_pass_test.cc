@@ -0,0 +1,210 @@
+/**
+ * Copyright 2021 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <memory>
+#include <string>
+#include <vector>
+#include "common/common_test.h"
+#include "ir/func_graph.h"
+#include "include/lite_types.h"
+#include "ops/concat.h"
+#include "ops/mat_mul.h"
+#include "ops/op_utils.h"
+#include "ops/split_with_overlap.h"
+#include "ops/fusion/add_fusion.h"
+#include "ops/fusion/max_pool_fusion.h"
+#include "tools/converter/converter_flags.h"
+#include "tools/optimizer/fisson/fisson_util.h"
+#include "tools/optimizer/parallel/parallel_pass.h"
+
+namespace mindspore {
+class ParallelPassTest : public mindspore::CommonTest {
+ public:
+  ParallelPassTest() = default;
+  void TearDown() override { opt::g_graph_nodes_out_shapes.clear(); }
+};
+
+namespace {
+ParameterPtr AddInput(const FuncGraphPtr &func_graph, const std::string &name) {
+  auto input = func_graph->add_parameter();
+  input->set_name(name);
+  return input;
+}
+
+// record the shapes NodeOutShapes would have inferred for the new node
+CNodePtr AddNode(const FuncGraphPtr &func_graph, const PrimitivePtr &prim, const std::vector<AnfNodePtr> &inputs,
+                 const std::string &name, const std::vector<ShapeVector> &input_shapes,
+                 const ShapeVector &output_shape) {
+  std::vector<AnfNodePtr> node_inputs = {NewValueNode(prim)};
+  node_inputs.insert(node_inputs.end(), inputs.begin(), inputs.end());
+  auto cnode = func_graph->NewCNode(node_inputs);
+  cnode->set_fullname_with_scope(name);
+  opt::g_graph_nodes_out_shapes[name] = {input_shapes, {output_shape}};
+  func_graph->set_output(cnode);
+  return cnode;
+}
+
+AnfNodePtr RunParallelPass(const FuncGraphPtr &func_graph, const CNodePtr &cnode, opt::SplitMode split_mode,
+                           size_t dev_num) {
+  opt::ParallelPass pass(opt::ParserSplitStrategy(split_mode, dev_num), lite::converter::FmkType_TF);
+  return pass.Run(func_graph, cnode);
+}
+
+// the parallel nodes a concat or addn replacing the split node gathers
+std::vector<CNodePtr> ParallelNodes(const AnfNodePtr &replace_op) {
+  std::vector<CNodePtr> parallel_nodes;
+  auto cnode = replace_op->cast<CNodePtr>();
+  for (size_t i = 1; i < cnode->size(); ++i) {
+    parallel_nodes.push_back(cnode->input(i)->cast<CNodePtr>());
+  }
+  return parallel_nodes;
+}
+
+// the SplitWithOverlap cutting the index-th input of a parallel node, nullptr if that input is not split
+std::shared_ptr<ops::SplitWithOverlap> SplitOfInput(const CNodePtr &parallel_node, size_t index) {
+  auto tuple_getitem = parallel_node->input(index + 1)->cast<CNodePtr>();
+  if (tuple_getitem == nullptr) {
+    return nullptr;
+  }
+  auto split_cnode = tuple_getitem->input(1)->cast<CNodePtr>();
+  return split_cnode == nullptr ? nullptr : GetValueNode<std::shared_ptr<ops::SplitWithOverlap>>(split_cnode->input(0));
+}
+
+void CheckParallelNodes(const std::vector<CNodePtr> &parallel_nodes, const PrimitivePtr &prim, size_t dev_num) {
+  ASSERT_EQ(dev_num, parallel_nodes.size());
+  for (auto &parallel_node : parallel_nodes) {
+    ASSERT_NE(parallel_node, nullptr);
+    ASSERT_EQ(prim, GetValueNode<PrimitivePtr>(parallel_node->input(0)));
+    // every branch runs on a cpu core, the scheduler reads the device type back from the exported model
+    auto device_type = parallel_node->GetAttr(ops::kDeviceType);
+    ASSERT_NE(device_type, nullptr);
+    ASSERT_EQ(static_cast<int>(lite::DT_CPU), GetValue<int>(device_type));
+  }
+}
+}  // namespace
+
+TEST_F(ParallelPassTest, MatMulSplitColumns) {
+  auto func_graph = std::make_shared<FuncGraph>();
+  auto input = AddInput(func_graph, "input");
+  auto weight = AddInput(func_graph, "weight");
+  auto prim = std::make_shared<ops::MatMul>();
+  auto matmul = AddNode(func_graph, prim, {input, weight}, "matmul", {{4, 8}, {8, 6}}, {4, 6});
+
+  auto replace_op = RunParallelPass(func_graph, matmul, opt::SplitCOUT, 3);
+  ASSERT_NE(replace_op, nullptr);
+  auto concat = GetValueNode<std::shared_ptr<ops::Concat>>(replace_op->cast<CNodePtr>()->input(0));
+  ASSERT_NE(concat, nullptr);
+  ASSERT_EQ(1, concat->get_axis());
+  auto parallel_nodes = ParallelNodes(replace_op);
+  CheckParallelNodes(parallel_nodes, prim, 3);
+  for (auto &parallel_node : parallel_nodes) {
+    // the input is shared, the columns of the weight are split into 3 equal parts
+    ASSERT_EQ(input, parallel_node->input(1));
+    auto split = SplitOfInput(parallel_node, 1);
+    ASSERT_NE(split, nullptr);
+    ASSERT_EQ(1, split->get_split_dim());
+    ASSERT_EQ(std::vector<int64_t>({1, 1, 1}), split->get_ratio());
+  }
+}
+
+TEST_F(ParallelPassTest, MatMulSplitDepth) {
+  auto func_graph = std::make_shared<FuncGraph>();
+  auto input = AddInput(func_graph, "input");
+  auto weight = AddInput(func_graph, "weight");
+  auto prim = std::make_shared<ops::MatMul>();
+  auto matmul = AddNode(func_graph, prim, {input, weight}, "matmul", {{4, 8}, {8, 6}}, {4, 6});
+
+  auto replace_op = RunParallelPass(func_graph, matmul, opt::SplitCIN, 2);
+  ASSERT_NE(replace_op, nullptr);
+  // partial products of the depth are added up
+  ASSERT_TRUE(opt::CheckPrimitiveType(replace_op, prim::kPrimAddN));
+  auto parallel_nodes = ParallelNodes(replace_op);
+  CheckParallelNodes(parallel_nodes, prim, 2);
+  auto input_split = SplitOfInput(parallel_nodes[0], 0);
+  auto weight_split = SplitOfInput(parallel_nodes[0], 1);
+  ASSERT_NE(input_split, nullptr);
+  ASSERT_NE(weight_split, nullptr);
+  ASSERT_EQ(1, input_split->get_split_dim());
+  ASSERT_EQ(0, weight_split->get_split_dim());
+}
+
+TEST_F(ParallelPassTest, PoolingSplitBatch) {
+  auto func_graph = std::make_shared<FuncGraph>();
+  auto input = AddInput(func_graph, "input");
+  auto prim = std::make_shared<ops::MaxPoolFusion>();
+  auto pooling = AddNode(func_graph, prim, {input}, "pooling", {{4, 8, 8, 16}}, {4, 4, 4, 16});
+
+  auto replace_op = RunParallelPass(func_graph, pooling, opt::SplitN, 4);
+  ASSERT_NE(replace_op, nullptr);
+  auto concat = GetValueNode<std::shared_ptr<ops::Concat>>(replace_op->cast<CNodePtr>()->input(0));
+  ASSERT_NE(concat, nullptr);
+  ASSERT_EQ(0, concat->get_axis());
+  auto parallel_nodes = ParallelNodes(replace_op);
+  CheckParallelNodes(parallel_nodes, prim, 4);
+  auto split = SplitOfInput(parallel_nodes[0], 0);
+  ASSERT_NE(split, nullptr);
+  ASSERT_EQ(0, split->get_split_dim());
+  ASSERT_EQ(std::vector<int64_t>({1, 1, 1, 1}), split->get_ratio());
+}
+
+TEST_F(ParallelPassTest, ElementwiseSplitChannel) {
+  auto func_graph = std::make_shared<FuncGraph>();
+  auto input = AddInput(func_graph, "input");
+  auto bias = AddInput(func_graph, "bias");
+  auto scalar = AddInput(func_graph, "scalar");
+  auto prim = std::make_shared<ops::AddFusion>();
+  auto add = AddNode(func_graph, prim, {input, bias}, "add", {{2, 8, 8, 16}, {16}}, {2, 8, 8, 16});
+
+  auto replace_op = RunParallelPass(func_graph, add, opt::SplitCOUT, 2);
+  ASSERT_NE(replace_op, nullptr);
+  auto concat = GetValueNode<std::shared_ptr<ops::Concat>>(replace_op->cast<CNodePtr>()->input(0));
+  ASSERT_NE(concat, nullptr);
+  ASSERT_EQ(3, concat->get_axis());
+  auto parallel_nodes = ParallelNodes(replace_op);
+  CheckParallelNodes(parallel_nodes, prim, 2);
+  // the broadcast bias is split along its own axis of the output channel
+  auto input_split = SplitOfInput(parallel_nodes[0], 0);
+  auto bias_split = SplitOfInput(parallel_nodes[0], 1);
+  ASSERT_NE(input_split, nullptr);
+  ASSERT_NE(bias_split, nullptr);
+  ASSERT_EQ(3, input_split->get_split_dim());
+  ASSERT_EQ(0, bias_split->get_split_dim());
+
+  // an input broadcast along the split axis is shared by all branches
+  auto broadcast_add = AddNode(func_graph, std::make_shared<ops::AddFusion>(), {input, scalar}, "broadcast_add",
+                               {{2, 8, 8, 16}, {1, 1, 1, 1}}, {2, 8, 8, 16});
+  replace_op = RunParallelPass(func_graph, broadcast_add, opt::SplitCOUT, 2);
+  ASSERT_NE(replace_op, nullptr);
+  for (auto &parallel_node : ParallelNodes(replace_op)) {
+    ASSERT_EQ(scalar, parallel_node->input(2));
+  }
+}
+
+TEST_F(ParallelPassTest, AutoKeepsSmallNodes) {
+  auto func_graph = std::make_shared<FuncGraph>();
+  auto input = AddInput(func_graph, "input");
+  auto weight = AddInput(func_graph, "weight");
+  auto small_matmul =
+    AddNode(func_graph, std::make_shared<ops::MatMul>(), {input, weight}, "small_matmul", {{1, 8}, {8, 8}}, {1, 8});
+  ASSERT_EQ(nullptr, RunParallelPass(func_graph, small_matmul, opt::SplitAuto, 2));
+  // a large matmul is worth splitting across the cores
+  auto large_matmul = AddNode(func_graph, std::make_shared<ops::MatMul>(), {input, weight}, "large_matmul",
+                              {{256, 1024}, {1024, 1024}}, {256, 1024});
+  auto replace_op = RunParallelPass(func_graph, large_matmul, opt::SplitAuto, 4);
+  ASSERT_NE(replace_op, nullptr);
+  ASSERT_EQ(4u, ParallelNodes(replace_op).size());
+}
+}  // namespace mindspore
@@ -0,0 +1,89 @@
+/**
+ * Copyright 2021 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <string>
+#include <vector>
+#include "common/common_test.h"
+#include "tools/optimizer/parallel/split_strategy.h"
+
+namespace mindspore {
+class SplitStrategyTest : public mindspore::CommonTest {
+ public:
+  SplitStrategyTest() = default;
+};
+
+namespace {
+const std::vector<int64_t> kSplitRatio = {1, 1};
+const std::vector<int64_t> kNoSplitRatio = {0, 0};
+}  // namespace
+
+TEST_F(SplitStrategyTest, GenerateStrategy) {
+  auto conv = opt::GenerateSplitStrategy(opt::kSplitOp, opt::SplitCIN);
+  ASSERT_EQ(2u, conv.strategys.size());
+  ASSERT_EQ(kSplitRatio, conv.strategys[0][3]);
+  ASSERT_EQ(kSplitRatio, conv.strategys[1][3]);
+  ASSERT_EQ(kNoSplitRatio, conv.strategys[1][0]);
+  ASSERT_EQ(opt::kSplitDefaultDevNum, conv.dev_num);
+  // the channel of depthwise conv is split on the feature map and the kernel together
+  auto depthwise = opt::GenerateSplitStrategy(opt::kSplitDepthwiseConv2D, opt::SplitCOUT);
+  ASSERT_EQ(kSplitRatio, depthwise.strategys[0][3]);
+  ASSERT_EQ(kSplitRatio, depthwise.strategys[1][0]);
+  auto matmul = opt::GenerateSplitStrategy(opt::kSplitMatMul, opt::SplitCOUT);
+  ASSERT_EQ(kNoSplitRatio, matmul.strategys[0][0]);
+  ASSERT_EQ(kSplitRatio, matmul.strategys[1][0]);
+  ASSERT_TRUE(opt::GenerateSplitStrategy(opt::kSplitPooling, opt::SplitH).strategys.empty());
+  ASSERT_TRUE(opt::GenerateSplitStrategy(opt::kSplitElementwise, opt::SplitCIN).strategys.empty());
+}
+
+TEST_F(SplitStrategyTest, GenerateStrategyForCores) {
+  // one cpu branch per core of the target
+  auto conv = opt::GenerateSplitStrategy(opt::kSplitOp, opt::SplitH, 4);
+  ASSERT_EQ(4u, conv.dev_num);
+  ASSERT_EQ(std::vector<std::string>(4, opt::kSplitDevType), conv.dev_types);
+  ASSERT_EQ(std::vector<int64_t>({1, 1, 1, 1}), conv.strategys[0][1]);
+  ASSERT_EQ(std::vector<int64_t>({0, 0, 0, 0}), conv.strategys[0][0]);
+  ASSERT_TRUE(opt::GenerateSplitStrategy(opt::kSplitOp, opt::SplitH, 1).strategys.empty());
+  auto strategys = opt::ParserSplitStrategy(opt::SplitAuto, 3);
+  ASSERT_EQ(3u, strategys.at(opt::kSplitMatMul).dev_num);
+  ASSERT_TRUE(opt::ParserSplitStrategy(opt::SplitCOUT, 1).empty());
+}
+
+TEST_F(SplitStrategyTest, ParserStrategy) {
+  auto strategys = opt::ParserSplitStrategy(opt::SplitCIN);
+  ASSERT_TRUE(strategys.find(opt::kSplitOp) != strategys.end());
+  ASSERT_TRUE(strategys.find(opt::kSplitPooling) == strategys.end());
+  auto auto_strategys = opt::ParserSplitStrategy(opt::SplitAuto);
+  ASSERT_EQ(opt::kSupportSplitModes.size(), auto_strategys.size());
+  for (auto &strategy : auto_strategys) {
+    ASSERT_TRUE(strategy.second.strategys.empty());
+  }
+}
+
+TEST_F(SplitStrategyTest, ChooseSplitMode) {
+  // a large conv is compute bound, splitting the weight copies the least
+  std::vector<ShapeVector> conv_inputs = {{1, 56, 56, 64}, {64, 3, 3, 64}, {64}};
+  std::vector<ShapeVector> conv_outputs = {{1, 56, 56, 64}};
+  ASSERT_EQ(opt::SplitCOUT, opt::ChooseSplitMode(opt::kSplitOp, conv_inputs, conv_outputs, 2));
+  // a small elementwise op costs less than launching one more branch
+  std::vector<ShapeVector> add_inputs = {{1, 8}, {1, 8}};
+  std::vector<ShapeVector> add_outputs = {{1, 8}};
+  ASSERT_EQ(opt::NoSplit, opt::ChooseSplitMode(opt::kSplitElementwise, add_inputs, add_outputs, 2));
+  std::vector<ShapeVector> dynamic_inputs = {{-1, 56, 56, 64}, {64, 3, 3, 64}};
+  std::vector<ShapeVector> dynamic_outputs = {{-1, 56, 56, 64}};
+  ASSERT_EQ(opt::NoSplit, opt::ChooseSplitMode(opt::kSplitOp, dynamic_inputs, dynamic_outputs, 2));
+  ASSERT_EQ(opt::NoSplit, opt::ChooseSplitMode(opt::kSplitOp, conv_inputs, conv_outputs, 1));
+}
+}  // namespace mindspore
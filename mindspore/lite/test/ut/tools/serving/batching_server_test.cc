@@ -0,0 +1,213 @@
+/**
+ * Copyright 2021 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <chrono>
+#include <cstring>
+#include <future>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "common/common_test.h"
+#include "schema/inner/model_generated.h"
+#include "include/context.h"
+#include "include/errorcode.h"
+#include "include/serving/batching_server.h"
+
+namespace mindspore {
+class TestBatchingServer : public mindspore::CommonTest {
+ public:
+  TestBatchingServer() {}
+};
+
+namespace {
+constexpr int kSampleElements = 4;
+
+// relu over a [1, 4] input, every positive sample comes back unchanged
+std::vector<char> ReluModel() {
+  auto meta_graph = std::make_shared<schema::MetaGraphT>();
+  meta_graph->name = "graph";
+  auto node = std::make_unique<schema::CNodeT>();
+  node->inputIndex = {0};
+  node->outputIndex = {1};
+  node->primitive = std::make_unique<schema::PrimitiveT>();
+  node->primitive->value.type = schema::PrimitiveType_Activation;
+  auto primitive = new schema::ActivationT;
+  primitive->activation_type = schema::ActivationType_RELU;
+  node->primitive->value.value = primitive;
+  node->name = "Relu";
+  meta_graph->nodes.emplace_back(std::move(node));
+  meta_graph->inputIndex = {0};
+  meta_graph->outputIndex = {1};
+  for (int i = 0; i < 2; i++) {
+    auto tensor = std::make_unique<schema::TensorT>();
+    tensor->nodeType = lite::NodeType_ValueNode;
+    tensor->format = schema::Format_NHWC;
+    tensor->dataType = TypeId::kNumberTypeFloat32;
+    tensor->dims = {1, kSampleElements};
+    tensor->offset = -1;
+    meta_graph->allTensors.emplace_back(std::move(tensor));
+  }
+  flatbuffers::FlatBufferBuilder builder(1024);
+  auto offset = schema::MetaGraph::Pack(builder, meta_graph.get());
+  builder.Finish(offset);
+  auto content = reinterpret_cast<const char *>(builder.GetBufferPointer());
+  return std::vector<char>(content, content + builder.GetSize());
+}
+
+session::SampleData Sample(int id) {
+  std::vector<float> data(kSampleElements);
+  for (int i = 0; i < kSampleElements; i++) {
+    data[i] = static_cast<float>(id * kSampleElements + i + 1);
+  }
+  auto bytes = reinterpret_cast<const char *>(data.data());
+  return {std::vector<char>(bytes, bytes + data.size() * sizeof(float))};
+}
+
+void StartServer(session::BatchingServer *server, const lite::Context *context) {
+  auto model = ReluModel();
+  ASSERT_EQ(lite::RET_OK, server->Init(model.data(), model.size(), context));
+}
+
+lite::Context SingleThreadContext() {
+  lite::Context context;
+  context.device_list_[0].device_info_.cpu_device_info_.cpu_bind_mode_ = lite::NO_BIND;
+  context.thread_num_ = 1;
+  return context;
+}
+}  // namespace
+
+TEST_F(TestBatchingServer, FullBatchRunsBeforeDeadline) {
+  session::ServingConfig config;
+  config.max_batch = 4;
+  config.max_delay_us = 10 * 1000 * 1000;
+  std::unique_ptr<session::BatchingServer> server(session::BatchingServer::CreateBatchingServer(config));
+  ASSERT_NE(nullptr, server);
+  auto context = SingleThreadContext();
+  StartServer(server.get(), &context);
+
+  auto begin = std::chrono::steady_clock::now();
+  std::vector<session::SampleData> outputs(config.max_batch);
+  std::vector<std::future<int>> futures;
+  for (int i = 0; i < config.max_batch; i++) {
+    futures.push_back(server->PredictAsync(Sample(i), &outputs[i]));
+  }
+  for (int i = 0; i < config.max_batch; i++) {
+    ASSERT_EQ(lite::RET_OK, futures[i].get());
+    EXPECT_EQ(Sample(i), outputs[i]);
+  }
+  EXPECT_LT(std::chrono::steady_clock::now() - begin, std::chrono::microseconds(config.max_delay_us));
+  auto stat = server->stat();
+  EXPECT_EQ(1u, stat.batch_num);
+  EXPECT_EQ(4u, stat.sample_num);
+  EXPECT_EQ(0u, stat.padded_num);
+}
+
+TEST_F(TestBatchingServer, PartialBatchRunsOnDeadline) {
+  session::ServingConfig config;
+  config.max_batch = 8;
+  config.max_delay_us = 20 * 1000;
+  std::unique_ptr<session::BatchingServer> server(session::BatchingServer::CreateBatchingServer(config));
+  ASSERT_NE(nullptr, server);
+  auto context = SingleThreadContext();
+  StartServer(server.get(), &context);
+
+  auto begin = std::chrono::steady_clock::now();
+  session::SampleData output;
+  ASSERT_EQ(lite::RET_OK, server->Predict(Sample(0), &output));
+  EXPECT_GE(std::chrono::steady_clock::now() - begin, std::chrono::microseconds(config.max_delay_us));
+  EXPECT_EQ(Sample(0), output);
+  auto stat = server->stat();
+  EXPECT_EQ(1u, stat.batch_num);
+  EXPECT_EQ(1u, stat.sample_num);
+}
+
+TEST_F(TestBatchingServer, SmallestBucketIsPadded) {
+  session::ServingConfig config;
+  config.max_batch = 8;
+  config.max_delay_us = 200 * 1000;
+  config.batch_buckets = {4, 2};
+  std::unique_ptr<session::BatchingServer> server(session::BatchingServer::CreateBatchingServer(config));
+  ASSERT_NE(nullptr, server);
+  auto context = SingleThreadContext();
+  StartServer(server.get(), &context);
+
+  // three requests run on the bucket of 4 with one padded sample
+  std::vector<session::SampleData> outputs(3);
+  std::vector<std::future<int>> futures;
+  for (int i = 0; i < 3; i++) {
+    futures.push_back(server->PredictAsync(Sample(i), &outputs[i]));
+  }
+  for (int i = 0; i < 3; i++) {
+    ASSERT_EQ(lite::RET_OK, futures[i].get());
+    EXPECT_EQ(Sample(i), outputs[i]);
+  }
+  auto stat = server->stat();
+  EXPECT_EQ(1u, stat.batch_num);
+  EXPECT_EQ(1u, stat.padded_num);
+
+  // the largest bucket caps the batch, five requests run as a full 4 and a padded 2
+  outputs.resize(5);
+  futures.clear();
+  for (int i = 0; i < 5; i++) {
+    futures.push_back(server->PredictAsync(Sample(i), &outputs[i]));
+  }
+  for (int i = 0; i < 5; i++) {
+    ASSERT_EQ(lite::RET_OK, futures[i].get());
+    EXPECT_EQ(Sample(i), outputs[i]);
+  }
+  stat = server->stat();
+  EXPECT_EQ(3u, stat.batch_num);
+  EXPECT_EQ(8u, stat.sample_num);
+  EXPECT_EQ(2u, stat.padded_num);
+}
+
+TEST_F(TestBatchingServer, WorkersNeverRunEmptyBatches) {
+  session::ServingConfig config;
+  config.max_batch = 4;
+  config.max_delay_us = 500;
+  config.worker_num = 4;
+  std::unique_ptr<session::BatchingServer> server(session::BatchingServer::CreateBatchingServer(config));
+  ASSERT_NE(nullptr, server);
+  auto context = SingleThreadContext();
+  StartServer(server.get(), &context);
+
+  // workers woken at their deadline after another one emptied the queue go back to waiting
+  constexpr int kClientNum = 8;
+  constexpr int kRequestNum = 50;
+  std::vector<std::thread> clients;
+  std::vector<int> failures(kClientNum, 0);
+  for (int client = 0; client < kClientNum; client++) {
+    clients.emplace_back([&server, &failures, client]() {
+      for (int i = 0; i < kRequestNum; i++) {
+        session::SampleData output;
+        auto id = client * kRequestNum + i;
+        if (server->Predict(Sample(id), &output) != lite::RET_OK || output != Sample(id)) {
+          failures[client]++;
+        }
+      }
+    });
+  }
+  for (auto &client : clients) {
+    client.join();
+  }
+  for (auto failure : failures) {
+    EXPECT_EQ(0, failure);
+  }
+  auto stat = server->stat();
+  EXPECT_EQ(static_cast<uint64_t>(kClientNum * kRequestNum), stat.sample_num);
+  EXPECT_EQ(0u, stat.padded_num);
+  EXPECT_LE(stat.batch_num, stat.sample_num);
+}
+}  // namespace mindspore
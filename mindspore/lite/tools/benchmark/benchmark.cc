@@ -25,6 +25,8 @@
 #include "include/ms_tensor.h"
 #include "include/version.h"
 #include "src/common/common.h"
+#include "src/lite_model.h"
+#include "src/lite_session.h"
 #include "src/runtime/runtime_api.h"
 #ifdef ENABLE_ARM64
 #include <linux/perf_event.h>
@@ -454,6 +456,9 @@ int Benchmark::MarkPerformance() {
   uint64_t time_min = 1000000;
   uint64_t time_max = 0;
   uint64_t time_avg = 0;
+  if (kernel_profiler_ != nullptr) {
+    kernel_profiler_->Start();
+  }
 
   for (int i = 0; i < flags_->loop_count_; i++) {
     auto inputs = session_->GetInputs();
@@ -477,6 +482,12 @@ int Benchmark::MarkPerformance() {
     session_->BindThread(false);
   }
 
+  if (kernel_profiler_ != nullptr) {
+    kernel_profiler_->Stop();
+    (void)kernel_profiler_->ExportChromeTrace(flags_->trace_file_);
+    kernel_profiler_->PrintRoofline(flags_->peak_gflops_, flags_->peak_bandwidth_);
+  }
+
   if (flags_->time_profiling_) {
     const std::vector<std::string> per_op_name = {"opName", "avg(ms)", "percent", "calledTimes", "opTotalTime"};
     const std::vector<std::string> per_op_type = {"opType", "avg(ms)", "percent", "calledTimes", "opTotalTime"};
@@ -513,7 +524,80 @@ int Benchmark::MarkPerformance() {
     printf("Model = %s, NumThreads = %d, MinRunTime = %f ms, MaxRuntime = %f ms, AvgRunTime = %f ms\n",
            flags_->model_file_.substr(flags_->model_file_.find_last_of(DELIM_SLASH) + 1).c_str(), flags_->num_threads_,
            time_min / 1000.0f, time_max / 1000.0f, time_avg / 1000.0f);
+    if (serial_session_ != nullptr) {
+      return MarkParallelSpeedup(time_avg);
+    }
+  }
+  return RET_OK;
+}
+
+int Benchmark::CompileSerialSession(Model *model) {
+  auto context = std::make_shared<Context>();
+  if (context == nullptr) {
+    MS_LOG(ERROR) << "New context failed";
+    return RET_ERROR;
+  }
+  InitContext(context);
+  serial_session_ = session::LiteSession::CreateSession(context.get());
+  if (serial_session_ == nullptr) {
+    MS_LOG(ERROR) << "CreateSession failed";
+    return RET_ERROR;
+  }
+  auto ret = serial_session_->CompileGraph(model);
+  if (ret != RET_OK) {
+    MS_LOG(ERROR) << "CompileGraph failed";
+    return ret;
+  }
+  if (!flags_->resize_dims_.empty()) {
+    ret = serial_session_->Resize(serial_session_->GetInputs(), flags_->resize_dims_);
+    if (ret != RET_OK) {
+      MS_LOG(ERROR) << "Input tensor resize failed.";
+      return ret;
+    }
+  }
+  return RET_OK;
+}
+
+int Benchmark::MarkParallelSpeedup(uint64_t parallel_time_avg) {
+  auto serial_inputs = serial_session_->GetInputs();
+  if (serial_inputs.size() != ms_inputs_.size()) {
+    MS_LOG(ERROR) << "Inputs of serial session are different from inputs of parallel session";
+    return RET_ERROR;
+  }
+  for (size_t i = 0; i < serial_inputs.size(); i++) {
+    if (serial_inputs[i]->Size() != ms_inputs_[i]->Size()) {
+      MS_LOG(ERROR) << "Size of input " << i << " is different between serial and parallel session";
+      return RET_ERROR;
+    }
+    memcpy(serial_inputs[i]->MutableData(), ms_inputs_[i]->MutableData(), ms_inputs_[i]->Size());
+  }
+  for (int i = 0; i < flags_->warm_up_loop_count_; i++) {
+    auto status = serial_session_->RunGraph();
+    if (status != 0) {
+      MS_LOG(ERROR) << "Inference error " << status;
+      std::cerr << "Inference error " << status << std::endl;
+      return status;
+    }
   }
+  uint64_t time_avg = 0;
+  for (int i = 0; i < flags_->loop_count_; i++) {
+    serial_session_->BindThread(true);
+    auto start = GetTimeUs();
+    auto status = serial_session_->RunGraph();
+    if (status != 0) {
+      MS_LOG(ERROR) << "Inference error " << status;
+      std::cerr << "Inference error " << status << std::endl;
+      return status;
+    }
+    time_avg += GetTimeUs() - start;
+    serial_session_->BindThread(false);
+  }
+  time_avg /= flags_->loop_count_;
+  float speedup = parallel_time_avg == 0 ? 0.0f : static_cast<float>(time_avg) / parallel_time_avg;
+  MS_LOG(INFO) << "SerialAvgRunTime = " << time_avg / 1000.0f
+               << ", ParallelAvgRunTime = " << parallel_time_avg / 1000.0f << ", ParallelSpeedup = " << speedup;
+  printf("SerialAvgRunTime = %f ms, ParallelAvgRunTime = %f ms, ParallelSpeedup = %f\n", time_avg / 1000.0f,
+         parallel_time_avg / 1000.0f, speedup);
   return RET_OK;
 }
 
@@ -600,15 +684,20 @@ int Benchmark::RunBenchmark() {
 
   MS_LOG(INFO) << "start reading model file";
   std::cout << "start reading model file" << std::endl;
-  size_t size = 0;
-  char *graph_buf = ReadFile(flags_->model_file_.c_str(), &size);
-  if (graph_buf == nullptr) {
-    MS_LOG(ERROR) << "Read model file failed while running " << model_name.c_str();
-    std::cerr << "Read model file failed while running " << model_name.c_str() << std::endl;
-    return RET_ERROR;
+  std::shared_ptr<Model> model = nullptr;
+  if (flags_->mmap_model_) {
+    model = std::shared_ptr<Model>(lite::ImportFromMappedFile(flags_->model_file_.c_str()));
+  } else {
+    size_t size = 0;
+    char *graph_buf = ReadFile(flags_->model_file_.c_str(), &size);
+    if (graph_buf == nullptr) {
+      MS_LOG(ERROR) << "Read model file failed while running " << model_name.c_str();
+      std::cerr << "Read model file failed while running " << model_name.c_str() << std::endl;
+      return RET_ERROR;
+    }
+    model = std::shared_ptr<Model>(lite::Model::Import(graph_buf, size));
+    delete[](graph_buf);
   }
-  auto model = std::shared_ptr<Model>(lite::Model::Import(graph_buf, size));
-  delete[](graph_buf);
   if (model == nullptr) {
     MS_LOG(ERROR) << "Import model file failed while running " << model_name.c_str();
     std::cerr << "Import model file failed while running " << model_name.c_str() << std::endl;
@@ -629,6 +718,7 @@ int Benchmark::RunBenchmark() {
     std::cout << "CreateSession failed while running ", model_name.c_str();
     return RET_ERROR;
   }
+  (reinterpret_cast<lite::LiteSession *>(session_))->set_enable_parallel(flags_->enable_parallel_);
   auto ret = session_->CompileGraph(model.get());
   if (ret != RET_OK) {
     MS_LOG(ERROR) << "CompileGraph failed while running ", model_name.c_str();
@@ -643,6 +733,18 @@ int Benchmark::RunBenchmark() {
       return ret;
     }
   }
+  if (flags_->kernel_profiling_) {
+    auto thread_pool = reinterpret_cast<lite::LiteSession *>(session_)->GetThreadPool();
+    kernel_profiler_ = std::make_unique<KernelProfiler>(thread_pool, flags_->num_threads_);
+  }
+  if (flags_->enable_parallel_) {
+    ret = CompileSerialSession(model.get());
+    if (ret != RET_OK) {
+      MS_LOG(ERROR) << "Compile serial session failed.";
+      std::cout << "Compile serial session failed.";
+      return ret;
+    }
+  }
   if (model != nullptr && !flags_->dump_tensor_data_) {
     model->Free();
   }
@@ -769,6 +871,21 @@ int Benchmark::InitTimeProfilingCallbackParameter() {
   return RET_OK;
 }
 
+int Benchmark::InitKernelProfilingCallbackParameter() {
+  // the profiler is created with the session, kernels run before that (e.g. in warm up loops) are not recorded
+  before_call_back_ = [&](const std::vector<mindspore::tensor::MSTensor *> &before_inputs,
+                          const std::vector<mindspore::tensor::MSTensor *> &before_outputs,
+                          const CallBackParam &call_param) {
+    return kernel_profiler_ == nullptr || kernel_profiler_->Before(before_inputs, before_outputs, call_param);
+  };
+  after_call_back_ = [&](const std::vector<mindspore::tensor::MSTensor *> &after_inputs,
+                         const std::vector<mindspore::tensor::MSTensor *> &after_outputs,
+                         const CallBackParam &call_param) {
+    return kernel_profiler_ == nullptr || kernel_profiler_->After(after_inputs, after_outputs, call_param);
+  };
+  return RET_OK;
+}
+
 int Benchmark::InitPerfProfilingCallbackParameter() {
 #ifndef ENABLE_ARM64
   MS_LOG(ERROR) << "Only support perf_profiling on arm64.";
@@ -1081,6 +1198,8 @@ int Benchmark::InitCallbackParameter() {
   int ret = RET_OK;
   if (flags_->time_profiling_) {
     ret = InitTimeProfilingCallbackParameter();
+  } else if (flags_->kernel_profiling_) {
+    ret = InitKernelProfilingCallbackParameter();
   } else if (flags_->perf_profiling_) {
     ret = InitPerfProfilingCallbackParameter();
   } else if (flags_->print_tensor_data_) {
@@ -1332,6 +1451,7 @@ Benchmark::~Benchmark() {
   }
   this->benchmark_data_.clear();
   delete (session_);
+  delete (serial_session_);
 }
 
 int RunBenchmark(int argc, const char **argv) {
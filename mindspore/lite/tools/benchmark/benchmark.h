@@ -36,6 +36,7 @@
 #include "src/common/file_utils.h"
 #include "src/common/utils.h"
 #include "include/lite_session.h"
+#include "tools/benchmark/kernel_profiler.h"
 
 namespace mindspore::lite {
 enum MS_API InDataType { kImage = 0, kBinary = 1 };
@@ -86,6 +87,19 @@ class MS_API BenchmarkFlags : public virtual FlagParser {
     AddFlag(&BenchmarkFlags::perf_profiling_, "perfProfiling",
             "Perf event profiling(only instructions statics enabled currently)", false);
     AddFlag(&BenchmarkFlags::perf_event_, "perfEvent", "CYCLE|CACHE|STALL", "CYCLE");
+    AddFlag(&BenchmarkFlags::kernel_profiling_, "kernelProfiling",
+            "Record time, FLOPs, bytes and thread utilization of each kernel, export a trace and a roofline summary",
+            false);
+    AddFlag(&BenchmarkFlags::trace_file_, "traceFile", "Chrome trace JSON file written by kernelProfiling",
+            "kernel_trace.json");
+    AddFlag(&BenchmarkFlags::peak_gflops_, "peakGflops", "Peak GFLOP/s of all threads for the roofline, 0 to measure",
+            0.0f);
+    AddFlag(&BenchmarkFlags::peak_bandwidth_, "peakBandwidth", "Peak memory GB/s for the roofline, 0 to measure",
+            0.0f);
+    AddFlag(&BenchmarkFlags::enable_parallel_, "enableParallel",
+            "Run independent kernels concurrently and report speedup over the serial executor", false);
+    AddFlag(&BenchmarkFlags::mmap_model_, "mmapModel",
+            "Map the model file and use weights in place instead of reading it into memory", false);
     // MarkAccuracy
     AddFlag(&BenchmarkFlags::benchmark_data_file_, "benchmarkDataFile", "Benchmark data file path", "");
     AddFlag(&BenchmarkFlags::benchmark_data_type_, "benchmarkDataType",
@@ -126,6 +140,12 @@ class MS_API BenchmarkFlags : public virtual FlagParser {
   bool time_profiling_ = false;
   bool perf_profiling_ = false;
   std::string perf_event_ = "CYCLE";
+  bool kernel_profiling_ = false;
+  std::string trace_file_ = "kernel_trace.json";
+  float peak_gflops_ = 0.0f;
+  float peak_bandwidth_ = 0.0f;
+  bool enable_parallel_ = false;
+  bool mmap_model_ = false;
   bool dump_tensor_data_ = false;
   bool print_tensor_data_ = false;
 };
@@ -175,6 +195,8 @@ class MS_API Benchmark {
 
   int InitPerfProfilingCallbackParameter();
 
+  int InitKernelProfilingCallbackParameter();
+
   int InitDumpTensorDataCallbackParameter();
 
   int InitPrintTensorDataCallbackParameter();
@@ -275,11 +297,17 @@ class MS_API Benchmark {
 
   int MarkPerformance();
 
+  int CompileSerialSession(Model *model);
+
+  int MarkParallelSpeedup(uint64_t parallel_time_avg);
+
   int MarkAccuracy();
 
  private:
   BenchmarkFlags *flags_;
   session::LiteSession *session_{nullptr};
+  // session running the same model with the serial executor, used as baseline of enableParallel
+  session::LiteSession *serial_session_{nullptr};
   std::vector<mindspore::tensor::MSTensor *> ms_inputs_;
   std::unordered_map<std::string, std::vector<mindspore::tensor::MSTensor *>> ms_outputs_;
   std::unordered_map<std::string, CheckTensor *> benchmark_data_;
@@ -295,6 +323,7 @@ class MS_API Benchmark {
   float op_cost_total_ = 0.0f;
   std::map<std::string, std::pair<int, float>> op_times_by_type_;
   std::map<std::string, std::pair<int, float>> op_times_by_name_;
+  std::unique_ptr<KernelProfiler> kernel_profiler_;
 
   // dump data
   nlohmann::json dump_cfg_json_;
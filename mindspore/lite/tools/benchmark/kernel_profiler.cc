@@ -0,0 +1,390 @@
+/**
+ * Copyright 2021 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "tools/benchmark/kernel_profiler.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <set>
+#include <nlohmann/json.hpp>
+#include "include/errorcode.h"
+#include "src/common/log_adapter.h"
+#include "src/common/utils.h"
+#include "src/runtime/runtime_api.h"
+#include "nnacl/fp32/matmul_fp32.h"
+
+namespace mindspore::lite {
+namespace {
+constexpr double kGiga = 1e9;
+constexpr size_t kBandwidthBufferSize = 64 * 1024 * 1024;
+constexpr int kMeasureLoops = 5;
+// one gemm tile per thread, small enough to stay in the caches and a multiple of every row and col tile of nnacl
+constexpr int kGemmRow = 12;
+constexpr int kGemmCol = 16;
+constexpr int kGemmDeep = 256;
+constexpr int kGemmLoops = 2000;
+constexpr float kTriadScale = 3.0f;
+
+// flops per output element of ops doing a fixed amount of work per element
+const std::map<std::string, double> kElementwiseFlops = {
+  {"AddFusion", 1},   {"SubFusion", 1},    {"MulFusion", 1},          {"DivFusion", 1},   {"RealDiv", 1},
+  {"Maximum", 1},     {"Minimum", 1},      {"SquaredDifference", 2},  {"BiasAdd", 1},     {"AddN", 1},
+  {"Eltwise", 1},     {"Activation", 1},   {"PReLUFusion", 2},        {"LeakyRelu", 2},   {"Abs", 1},
+  {"Neg", 1},         {"Square", 1},       {"Sqrt", 1},               {"Rsqrt", 2},       {"ExpFusion", 1},
+  {"Log", 1},         {"Sin", 1},          {"Cos", 1},                {"Erf", 1},         {"Reciprocal", 1},
+  {"PowFusion", 1},   {"Clip", 2},         {"Elu", 2},                {"ScaleFusion", 2}, {"BatchNorm", 2},
+  {"FusedBatchNorm", 2}, {"InstanceNorm", 4}, {"LayerNormFusion", 4}, {"Softmax", 3},     {"LogSoftmax", 3},
+  {"L2NormalizeFusion", 3}};
+
+// ops reading every input element once to produce their output
+const std::set<std::string> kReduceOps = {"AvgPoolFusion", "MaxPoolFusion", "ReduceFusion", "ArgMaxFusion",
+                                          "ArgMinFusion"};
+
+double ElementsNum(const tensor::MSTensor *tensor) { return tensor == nullptr ? 0 : tensor->ElementsNum(); }
+
+int LastDim(const tensor::MSTensor *tensor) {
+  if (tensor == nullptr || tensor->shape().empty()) {
+    return 1;
+  }
+  return std::max(tensor->shape().back(), 1);
+}
+
+struct GemmArgs {
+  std::vector<std::unique_ptr<float[]>> a;
+  std::vector<std::unique_ptr<float[]>> b;
+  std::vector<std::unique_ptr<float[]>> c;
+};
+
+int GemmRun(void *cdata, int task_id) {
+  auto args = reinterpret_cast<GemmArgs *>(cdata);
+  for (int i = 0; i < kGemmLoops; i++) {
+    MatMulOpt(args->a[task_id].get(), args->b[task_id].get(), args->c[task_id].get(), nullptr, ActType_No, kGemmDeep,
+              kGemmRow, kGemmCol, kGemmCol, OutType_Nhwc);
+  }
+  return RET_OK;
+}
+
+struct TriadArgs {
+  int task_num = 1;
+  size_t length = 0;
+  float *a = nullptr;
+  const float *b = nullptr;
+  const float *c = nullptr;
+};
+
+int TriadRun(void *cdata, int task_id) {
+  auto args = reinterpret_cast<TriadArgs *>(cdata);
+  size_t stride = UP_DIV(args->length, static_cast<size_t>(args->task_num));
+  size_t start = std::min(stride * task_id, args->length);
+  size_t end = std::min(start + stride, args->length);
+  for (size_t i = start; i < end; i++) {
+    args->a[i] = args->b[i] + kTriadScale * args->c[i];
+  }
+  return RET_OK;
+}
+
+// one task per thread the pool really has, the thread num of the flags may be larger
+int TaskNum(struct ThreadPool *thread_pool, int thread_num) {
+  if (thread_pool == nullptr) {
+    return 1;
+  }
+  return std::max(std::min(thread_num, GetCurrentThreadNum(thread_pool)), 1);
+}
+
+int Launch(struct ThreadPool *thread_pool, int (*job)(void *, int), void *content, int task_num) {
+  if (thread_pool == nullptr) {
+    return job(content, 0);
+  }
+  return ParallelLaunch(thread_pool, job, content, task_num);
+}
+}  // namespace
+
+KernelProfiler::~KernelProfiler() { Stop(); }
+
+void KernelProfiler::Start() {
+  records_.clear();
+  trace_begin_ = GetTimeUs();
+  if (thread_pool_ != nullptr) {
+    SetThreadPoolProfiling(thread_pool_, true);
+  }
+}
+
+void KernelProfiler::Stop() {
+  if (thread_pool_ != nullptr) {
+    SetThreadPoolProfiling(thread_pool_, false);
+  }
+}
+
+std::vector<uint64_t> KernelProfiler::BusyTime() const {
+  std::vector<uint64_t> busy_time(thread_num_, 0);
+  if (thread_pool_ != nullptr) {
+    (void)GetThreadPoolBusyTime(thread_pool_, busy_time.data(), thread_num_);
+  }
+  return busy_time;
+}
+
+bool KernelProfiler::Before(const std::vector<tensor::MSTensor *> &inputs,
+                            const std::vector<tensor::MSTensor *> &outputs, const CallBackParam &call_param) {
+  std::vector<std::vector<int>> shapes;
+  for (auto tensor : inputs) {
+    shapes.push_back(tensor == nullptr ? std::vector<int>() : tensor->shape());
+  }
+  for (auto tensor : outputs) {
+    shapes.push_back(tensor == nullptr ? std::vector<int>() : tensor->shape());
+  }
+  auto iter = costs_.find(call_param.node_name);
+  if (iter == costs_.end() || iter->second.shapes != shapes) {
+    auto &cached = costs_[call_param.node_name];
+    cached.shapes = shapes;
+    cached.cost = EstimateCost(call_param.node_type, inputs, outputs);
+    kernel_cost_ = cached.cost;
+  } else {
+    kernel_cost_ = iter->second.cost;
+  }
+  busy_begin_ = BusyTime();
+  kernel_begin_ = GetTimeUs();
+  return true;
+}
+
+bool KernelProfiler::After(const std::vector<tensor::MSTensor *> &inputs,
+                           const std::vector<tensor::MSTensor *> &outputs, const CallBackParam &call_param) {
+  KernelRecord record;
+  record.end = GetTimeUs();
+  record.begin = kernel_begin_;
+  record.name = call_param.node_name;
+  record.type = call_param.node_type;
+  record.cost = kernel_cost_;
+  auto busy_end = BusyTime();
+  uint64_t busy = 0;
+  for (size_t i = 0; i < busy_end.size() && i < busy_begin_.size(); i++) {
+    busy += busy_end[i] - busy_begin_[i];
+  }
+  auto wall = std::max<uint64_t>(record.end - record.begin, 1);
+  record.utilization = std::min(1.0, static_cast<double>(busy) / static_cast<double>(wall * thread_num_));
+  records_.push_back(record);
+  return true;
+}
+
+KernelCost KernelProfiler::EstimateCost(const std::string &type, const std::vector<tensor::MSTensor *> &inputs,
+                                        const std::vector<tensor::MSTensor *> &outputs) {
+  KernelCost cost;
+  // compulsory traffic: every input (weights included) is read and every output written once
+  for (auto tensor : inputs) {
+    cost.bytes += tensor == nullptr ? 0 : tensor->Size();
+  }
+  for (auto tensor : outputs) {
+    cost.bytes += tensor == nullptr ? 0 : tensor->Size();
+  }
+  if (inputs.empty() || outputs.empty()) {
+    return cost;
+  }
+  auto out_num = ElementsNum(outputs.front());
+  auto in_num = ElementsNum(inputs.front());
+  if (type == "Conv2DFusion" || type == "AdderFusion") {
+    // each output element takes kh * kw * cin / group weights, which is the weight size over cout
+    if (inputs.size() > 1) {
+      cost.flops = 2 * out_num * ElementsNum(inputs[1]) / LastDim(outputs.front());
+    }
+  } else if (type == "Conv2dTransposeFusion") {
+    // each input element is scattered through kh * kw * cout / group weights
+    if (inputs.size() > 1) {
+      cost.flops = 2 * in_num * ElementsNum(inputs[1]) / LastDim(inputs.front());
+    }
+  } else if (type == "MatMul" || type == "FullConnection") {
+    // rows of the output times the reduced dim give the elements of the first input
+    auto rows = std::max(out_num / LastDim(outputs.front()), 1.0);
+    cost.flops = 2 * out_num * (in_num / rows);
+  } else if (kReduceOps.find(type) != kReduceOps.end()) {
+    cost.flops = in_num;
+  } else {
+    auto iter = kElementwiseFlops.find(type);
+    if (iter != kElementwiseFlops.end()) {
+      cost.flops = iter->second * out_num;
+    }
+  }
+  if (inputs.size() > 2 && (type == "Conv2DFusion" || type == "Conv2dTransposeFusion" || type == "MatMul" ||
+                            type == "FullConnection")) {
+    cost.flops += out_num;  // bias
+  }
+  return cost;
+}
+
+RooflinePoint KernelProfiler::Roofline(const KernelCost &cost, double peak_gflops, double peak_bandwidth) {
+  RooflinePoint point;
+  point.intensity = cost.bytes > 0 ? cost.flops / cost.bytes : 0;
+  point.roof = std::min(peak_gflops, point.intensity * peak_bandwidth);
+  auto ridge = peak_bandwidth > 0 ? peak_gflops / peak_bandwidth : 0;
+  point.bound = cost.flops <= 0 ? "data" : (point.intensity < ridge ? "memory" : "compute");
+  return point;
+}
+
+double KernelProfiler::MeasurePeakGflops() const {
+  int task_num = TaskNum(thread_pool_, thread_num_);
+  GemmArgs args;
+  for (int i = 0; i < task_num; i++) {
+    args.a.emplace_back(new (std::nothrow) float[kGemmRow * kGemmDeep]);
+    args.b.emplace_back(new (std::nothrow) float[kGemmDeep * kGemmCol]);
+    args.c.emplace_back(new (std::nothrow) float[kGemmRow * kGemmCol]);
+    if (args.a.back() == nullptr || args.b.back() == nullptr || args.c.back() == nullptr) {
+      MS_LOG(ERROR) << "malloc gemm buffer failed";
+      return 0;
+    }
+    // small values keep the sums away from denormals and infinities
+    std::fill(args.a.back().get(), args.a.back().get() + kGemmRow * kGemmDeep, 1e-3f);
+    std::fill(args.b.back().get(), args.b.back().get() + kGemmDeep * kGemmCol, 1e-3f);
+  }
+  double best = 0;
+  for (int loop = 0; loop < kMeasureLoops; loop++) {
+    auto start = GetTimeUs();
+    if (Launch(thread_pool_, GemmRun, &args, task_num) != RET_OK) {
+      MS_LOG(ERROR) << "run gemm failed";
+      return 0;
+    }
+    auto cost = std::max<uint64_t>(GetTimeUs() - start, 1);
+    double flops = 2.0 * kGemmRow * kGemmCol * kGemmDeep * kGemmLoops * task_num;
+    best = std::max(best, flops / (cost * 1e-6) / kGiga);
+  }
+  return best;
+}
+
+double KernelProfiler::MeasurePeakBandwidth() const {
+  size_t length = kBandwidthBufferSize / sizeof(float);
+  std::unique_ptr<float[]> a(new (std::nothrow) float[length]);
+  std::unique_ptr<float[]> b(new (std::nothrow) float[length]);
+  std::unique_ptr<float[]> c(new (std::nothrow) float[length]);
+  if (a == nullptr || b == nullptr || c == nullptr) {
+    MS_LOG(ERROR) << "malloc bandwidth buffer failed";
+    return 0;
+  }
+  TriadArgs args;
+  args.task_num = TaskNum(thread_pool_, thread_num_);
+  args.length = length;
+  args.a = a.get();
+  args.b = b.get();
+  args.c = c.get();
+  std::fill(b.get(), b.get() + length, 1.0f);
+  std::fill(c.get(), c.get() + length, 2.0f);
+  // the first run touches the pages of a on the threads which write them
+  double best = 0;
+  for (int loop = 0; loop <= kMeasureLoops; loop++) {
+    auto start = GetTimeUs();
+    if (Launch(thread_pool_, TriadRun, &args, args.task_num) != RET_OK) {
+      MS_LOG(ERROR) << "run stream triad failed";
+      return 0;
+    }
+    auto cost = std::max<uint64_t>(GetTimeUs() - start, 1);
+    if (loop > 0) {
+      // two arrays read and one written
+      best = std::max(best, 3.0 * kBandwidthBufferSize / (cost * 1e-6) / kGiga);
+    }
+  }
+  return best;
+}
+
+int KernelProfiler::ExportChromeTrace(const std::string &path) const {
+  nlohmann::json events = nlohmann::json::array();
+  for (auto &record : records_) {
+    auto dur = std::max<uint64_t>(record.end - record.begin, 1);
+    nlohmann::json event;
+    event["name"] = record.name;
+    event["cat"] = record.type;
+    event["ph"] = "X";
+    event["pid"] = 0;
+    event["tid"] = 0;
+    event["ts"] = record.begin - trace_begin_;
+    event["dur"] = record.end - record.begin;
+    event["args"]["flops"] = record.cost.flops;
+    event["args"]["bytes"] = record.cost.bytes;
+    event["args"]["gflops"] = record.cost.flops / (dur * 1e-6) / kGiga;
+    event["args"]["gbps"] = record.cost.bytes / (dur * 1e-6) / kGiga;
+    event["args"]["thread_utilization"] = record.utilization;
+    events.push_back(event);
+    nlohmann::json counter;
+    counter["name"] = "thread utilization";
+    counter["ph"] = "C";
+    counter["pid"] = 0;
+    counter["ts"] = record.begin - trace_begin_;
+    counter["args"]["utilization"] = record.utilization;
+    events.push_back(counter);
+  }
+  nlohmann::json trace;
+  trace["traceEvents"] = events;
+  trace["displayTimeUnit"] = "ms";
+  std::ofstream out(path);
+  if (!out.is_open()) {
+    MS_LOG(ERROR) << "open trace file failed: " << path;
+    return RET_ERROR;
+  }
+  out << trace.dump();
+  out.close();
+  std::cout << "Kernel trace is saved to : " << path << std::endl;
+  return RET_OK;
+}
+
+void KernelProfiler::PrintRoofline(double peak_gflops, double peak_bandwidth) const {
+  if (peak_gflops <= 0) {
+    peak_gflops = MeasurePeakGflops();
+  }
+  if (peak_bandwidth <= 0) {
+    peak_bandwidth = MeasurePeakBandwidth();
+  }
+  auto ridge = peak_bandwidth > 0 ? peak_gflops / peak_bandwidth : 0;
+  printf("Roofline: peak %.2f GFLOP/s, bandwidth %.2f GB/s, ridge point %.2f FLOP/byte\n", peak_gflops,
+         peak_bandwidth, ridge);
+
+  struct TypeSummary {
+    int count = 0;
+    double time_us = 0;
+    double flops = 0;
+    double bytes = 0;
+    double busy = 0;
+  };
+  std::map<std::string, TypeSummary> summaries;
+  double total_time = 0;
+  for (auto &record : records_) {
+    auto &summary = summaries[record.type];
+    double time = std::max<uint64_t>(record.end - record.begin, 1);
+    summary.count++;
+    summary.time_us += time;
+    summary.busy += record.utilization * time;
+    summary.flops += record.cost.flops;
+    summary.bytes += record.cost.bytes;
+    total_time += time;
+  }
+  std::vector<std::pair<std::string, TypeSummary>> sorted(summaries.begin(), summaries.end());
+  std::sort(sorted.begin(), sorted.end(),
+            [](const std::pair<std::string, TypeSummary> &a, const std::pair<std::string, TypeSummary> &b) {
+              return a.second.time_us > b.second.time_us;
+            });
+  printf("-------------------------------------------------------------------------\n");
+  printf("%-24s%10s%10s%10s%10s%12s%12s%10s%10s\n", "opType", "time(%)", "GFLOP/s", "GB/s", "FLOP/B", "roof GF/s",
+         "roof(%)", "threads", "bound");
+  for (auto &iter : sorted) {
+    auto &summary = iter.second;
+    auto seconds = summary.time_us * 1e-6;
+    auto gflops = summary.flops / seconds / kGiga;
+    auto gbps = summary.bytes / seconds / kGiga;
+    auto point = Roofline({summary.flops, summary.bytes}, peak_gflops, peak_bandwidth);
+    printf("%-24s%10.2f%10.2f%10.2f%10.2f%12.2f%12.2f%10.2f%10s\n", iter.first.c_str(),
+           100 * summary.time_us / total_time, gflops, gbps, point.intensity, point.roof,
+           point.roof > 0 ? 100 * gflops / point.roof : 0, summary.busy / summary.time_us, point.bound.c_str());
+  }
+}
+}  // namespace mindspore::lite
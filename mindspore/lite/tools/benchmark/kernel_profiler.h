@@ -0,0 +1,105 @@
+/**
+ * Copyright 2021 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MINDSPORE_LITE_TOOLS_BENCHMARK_KERNEL_PROFILER_H_
+#define MINDSPORE_LITE_TOOLS_BENCHMARK_KERNEL_PROFILER_H_
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "include/lite_utils.h"
+#include "include/ms_tensor.h"
+
+struct ThreadPool;
+
+namespace mindspore::lite {
+// work of one kernel run, estimated from its type and the shapes of its tensors
+struct KernelCost {
+  double flops = 0;
+  double bytes = 0;
+};
+
+// where the work of a kernel type lies on the roofline of the CPU
+struct RooflinePoint {
+  double intensity = 0;
+  // attainable GFLOP/s at this intensity
+  double roof = 0;
+  // "data" for kernels only moving data, "memory" or "compute" for the roof limiting the others
+  std::string bound;
+};
+
+struct KernelRecord {
+  std::string name;
+  std::string type;
+  uint64_t begin = 0;
+  uint64_t end = 0;
+  KernelCost cost;
+  // busy time of all threads of the pool over the wall time of the kernel times the thread num
+  double utilization = 0;
+};
+
+class KernelProfiler {
+ public:
+  KernelProfiler(struct ThreadPool *thread_pool, int thread_num) : thread_pool_(thread_pool), thread_num_(thread_num) {}
+  ~KernelProfiler();
+
+  void Start();
+
+  void Stop();
+
+  bool Before(const std::vector<tensor::MSTensor *> &inputs, const std::vector<tensor::MSTensor *> &outputs,
+              const CallBackParam &call_param);
+
+  bool After(const std::vector<tensor::MSTensor *> &inputs, const std::vector<tensor::MSTensor *> &outputs,
+             const CallBackParam &call_param);
+
+  int ExportChromeTrace(const std::string &path) const;
+
+  // peak_gflops is the compute of all threads together, both peaks are measured on this CPU when not positive
+  void PrintRoofline(double peak_gflops, double peak_bandwidth) const;
+
+  static RooflinePoint Roofline(const KernelCost &cost, double peak_gflops, double peak_bandwidth);
+
+  static KernelCost EstimateCost(const std::string &type, const std::vector<tensor::MSTensor *> &inputs,
+                                 const std::vector<tensor::MSTensor *> &outputs);
+
+  // cache resident packed gemm tiles on every thread of the pool
+  double MeasurePeakGflops() const;
+
+  // stream triad over buffers much larger than the caches on every thread of the pool
+  double MeasurePeakBandwidth() const;
+
+ private:
+  struct CachedCost {
+    std::vector<std::vector<int>> shapes;
+    KernelCost cost;
+  };
+
+  std::vector<uint64_t> BusyTime() const;
+
+  struct ThreadPool *thread_pool_ = nullptr;
+  int thread_num_ = 1;
+  uint64_t trace_begin_ = 0;
+  uint64_t kernel_begin_ = 0;
+  std::vector<uint64_t> busy_begin_;
+  std::vector<KernelRecord> records_;
+  // costs of the last shapes every node ran with, estimated again when they change (e.g. after a resize)
+  std::unordered_map<std::string, CachedCost> costs_;
+  KernelCost kernel_cost_;
+};
+}  // namespace mindspore::lite
+#endif  // MINDSPORE_LITE_TOOLS_BENCHMARK_KERNEL_PROFILER_H_
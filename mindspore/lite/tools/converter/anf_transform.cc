@@ -69,6 +69,8 @@
 #include "tools/optimizer/parallel/split_strategy.h"
 #include "tools/optimizer/fisson/iter_node_outputs.h"
 #include "tools/optimizer/fisson/node_out_shapes.h"
+#include "tools/optimizer/fisson/eliminate_concat_split.h"
+#include "tools/optimizer/fisson/fisson_util.h"
 #include "tools/optimizer/parallel/parallel_pass.h"
 
 using std::string;
@@ -128,12 +130,14 @@ int AnfTransform::RunFusionPass(const FuncGraphPtr &old_graph, const converter::
 int AnfTransform::RunParallelPass(const FuncGraphPtr &old_graph, const converter::Flags *config) {
   MS_LOG(DEBUG) << "Run ParallelPass start";
   auto optimizer = std::make_shared<opt::GraphOptimizer>();
-  if (config->trainModel || !config->parallelMode) {
+  if (config->trainModel || config->parallelMode == opt::NoSplit) {
     return RET_OK;
   }
+  opt::g_graph_nodes_output.clear();
+  opt::g_graph_nodes_out_shapes.clear();
   // 1. deal with split strategy
   std::unordered_map<std::string, opt::SplitStrategy> split_strategys =
-    ParserSplitStrategy(static_cast<opt::SplitMode>(config->parallelMode));
+    ParserSplitStrategy(static_cast<opt::SplitMode>(config->parallelMode), static_cast<size_t>(config->parallelNum));
   if (split_strategys.empty()) {
     MS_LOG(ERROR) << "parse split_strategy error.";
     return RET_OK;
@@ -151,6 +155,17 @@ int AnfTransform::RunParallelPass(const FuncGraphPtr &old_graph, const converter
     MS_LOG(ERROR) << "run const fold failed.";
     return RET_ERROR;
   }
+  // 5. chained parallel nodes concat and split the same axis in between, let them feed each other directly
+  opt::g_graph_nodes_output.clear();
+  auto eliminate_optimizer = std::make_shared<opt::GraphOptimizer>();
+  auto eliminate_pm = std::make_shared<opt::PassManager>("anf eliminate concat split pass manager", false);
+  eliminate_pm->AddPass(std::make_shared<opt::IterNodeOutputs>());
+  eliminate_pm->AddPass(std::make_shared<opt::EliminateConcatSplit>());
+  eliminate_optimizer->AddPassManager(eliminate_pm);
+  if (eliminate_optimizer->Optimize(old_graph) == nullptr) {
+    MS_LOG(ERROR) << "run eliminate concat split failed.";
+    return RET_ERROR;
+  }
   MS_LOG(DEBUG) << "Run ParallelPass end";
   return RET_OK;
 }
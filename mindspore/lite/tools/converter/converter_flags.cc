@@ -15,14 +15,21 @@
  */
 
 #include "tools/converter/converter_flags.h"
+#include <cstdlib>
 #include <regex>
 #include <string>
 #include <algorithm>
+#include <unordered_map>
 #include "ir/dtype/type_id.h"
 
 namespace mindspore {
 namespace lite {
 namespace converter {
+namespace {
+constexpr int kMinParallelNum = 2;
+constexpr int kMaxParallelNum = 64;
+}  // namespace
+
 Flags::Flags() {
   AddFlag(&Flags::fmkIn, "fmk", "Input model framework type. TF | TFLITE | CAFFE | MINDIR | ONNX", "");
   AddFlag(&Flags::modelFile, "modelFile",
@@ -46,6 +53,17 @@ Flags::Flags() {
           "whether the model is going to be trained on device. "
           "true | false",
           "false");
+  AddFlag(&Flags::parallelModeIn, "parallelMode",
+          "Split operators into parallel branches running on the cpu cores of the target, the branches run "
+          "concurrently when the session enables parallel execution. AUTO chooses the split of every operator by its "
+          "shapes. NONE | N | H | CIN | COUT | AUTO",
+          "NONE");
+  AddFlag(&Flags::parallelNumIn, "parallelNum",
+          "Number of cpu cores of the target, every split operator gets one branch per core. [2, 64]", "2");
+  AddFlag(&Flags::blockSparsityIn, "blockSparsity",
+          "Store fp32 weights of FullConnection and 1x1 Conv2D as nonzero blocks of 8 output channels when at least "
+          "this ratio of the blocks is zero, 0 disables. Kernels run a block sparse GEMM from 0.7. [0, 1)",
+          "0");
 }
 
 int Flags::InitInputOutputDataType() {
@@ -180,6 +198,43 @@ int Flags::InitTrainModel() {
   return RET_OK;
 }
 
+int Flags::InitParallelMode() {
+  static const std::unordered_map<std::string, opt::SplitMode> kParallelModes = {
+    {"NONE", opt::NoSplit}, {"N", opt::SplitN},       {"H", opt::SplitH},
+    {"CIN", opt::SplitCIN}, {"COUT", opt::SplitCOUT}, {"AUTO", opt::SplitAuto}};
+  auto iter = kParallelModes.find(this->parallelModeIn);
+  if (iter == kParallelModes.end()) {
+    std::cerr << "INPUT ILLEGAL: parallelMode must be NONE|N|H|CIN|COUT|AUTO ";
+    return RET_INPUT_PARAM_INVALID;
+  }
+  this->parallelMode = iter->second;
+  if (this->trainModel && this->parallelMode != opt::NoSplit) {
+    std::cerr << "INPUT ILLEGAL: parallelMode is not supported for train model ";
+    return RET_INPUT_PARAM_INVALID;
+  }
+  if (!IsValidNum(this->parallelNumIn, &this->parallelNum) || this->parallelNum < kMinParallelNum ||
+      this->parallelNum > kMaxParallelNum) {
+    std::cerr << "INPUT ILLEGAL: parallelNum must be an integer in [2, 64] ";
+    return RET_INPUT_PARAM_INVALID;
+  }
+  return RET_OK;
+}
+
+int Flags::InitBlockSparsity() {
+  char *end = nullptr;
+  this->blockSparsity = std::strtof(this->blockSparsityIn.c_str(), &end);
+  if (this->blockSparsityIn.empty() || end == nullptr || *end != '\0' || this->blockSparsity < 0.0f ||
+      this->blockSparsity >= 1.0f) {
+    std::cerr << "INPUT ILLEGAL: blockSparsity must be a number in [0, 1) ";
+    return RET_INPUT_PARAM_INVALID;
+  }
+  if (this->trainModel && this->blockSparsity > 0.0f) {
+    std::cerr << "INPUT ILLEGAL: blockSparsity is not supported for train model ";
+    return RET_INPUT_PARAM_INVALID;
+  }
+  return RET_OK;
+}
+
 int Flags::Init(int argc, const char **argv) {
   int ret;
   if (argc == 1) {
@@ -246,6 +301,18 @@ int Flags::Init(int argc, const char **argv) {
     return RET_INPUT_PARAM_INVALID;
   }
 
+  ret = InitParallelMode();
+  if (ret != RET_OK) {
+    std::cerr << "Init parallel mode failed.";
+    return RET_INPUT_PARAM_INVALID;
+  }
+
+  ret = InitBlockSparsity();
+  if (ret != RET_OK) {
+    std::cerr << "Init block sparsity failed.";
+    return RET_INPUT_PARAM_INVALID;
+  }
+
   return RET_OK;
 }
 }  // namespace converter
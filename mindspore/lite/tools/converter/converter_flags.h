@@ -21,6 +21,7 @@
 #include "tools/common/flag_parser.h"
 #include "ir/dtype/type_id.h"
 #include "schema/inner/model_generated.h"
+#include "tools/optimizer/parallel/split_strategy.h"
 
 namespace mindspore {
 namespace lite {
@@ -57,6 +58,10 @@ class Flags : public virtual mindspore::lite::FlagParser {
 
   int InitTrainModel();
 
+  int InitParallelMode();
+
+  int InitBlockSparsity();
+
   int Init(int argc, const char **argv);
 
  public:
@@ -77,12 +82,19 @@ class Flags : public virtual mindspore::lite::FlagParser {
   int quantWeightSize;
   std::string bitNumIn;
   int bitNum;
-  int parallelMode = 0;
+  std::string parallelModeIn;
+  int parallelMode = opt::NoSplit;
+  std::string parallelNumIn;
+  // branches of every split operator, the cpu cores of the target
+  int parallelNum = static_cast<int>(opt::kSplitDefaultDevNum);
   std::string configFile;
   std::string quantWeightChannelStr;
   int quantWeightChannel;
   std::string trainModelIn;
   bool trainModel = false;
+  std::string blockSparsityIn;
+  // zero block ratio from which weights are stored block sparse, 0 disables
+  float blockSparsity = 0.0f;
 };
 }  // namespace converter
 }  // namespace lite
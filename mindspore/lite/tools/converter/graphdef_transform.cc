@@ -36,6 +36,8 @@
 #include "tools/converter/legacy_optimizer/graph/subgraph_node_pass.h"
 #include "tools/converter/legacy_optimizer/graph/subgraph_tensor_pass.h"
 #include "tools/converter/legacy_optimizer/graph/nested_loop_expand_pass.h"
+#include "tools/converter/legacy_optimizer/graph/block_sparse_pass.h"
+#include "tools/converter/legacy_optimizer/graph/transpose_fusion_pass.h"
 
 using std::string;
 namespace mindspore::lite {
@@ -76,6 +78,7 @@ int GraphDefTransform::Transform(const converter::Flags &ctx) {
     auto old_nodes = GetGraphNodes();
     Optimizer format_trans_optimizer;
     if (!ctx.trainModel && ctx.fmk != converter::FmkType_ONNX) {
+      format_trans_optimizer.AddPass(new (std::nothrow) TransposeFusionPass());
       format_trans_optimizer.AddPass(new (std::nothrow) IsolatedNodeRemovePass());
       format_trans_optimizer.AddPass(new (std::nothrow) SubgraphNodePass(old_nodes));
     }
@@ -192,6 +195,16 @@ int GraphDefTransform::Transform(const converter::Flags &ctx) {
       return status;
     }
   }
+  // weights are read as dense by all the passes above
+  if (ctx.blockSparsity > 0.0f) {
+    Optimizer sparse_optimizer;
+    sparse_optimizer.AddPass(new (std::nothrow) BlockSparsePass(ctx.blockSparsity));
+    status = sparse_optimizer.Run(graph_defT_);
+    if (status != RET_OK && status != RET_NO_CHANGE) {
+      MS_LOG(ERROR) << "Run sparse_optimizer graphPasses Failed.";
+      return status;
+    }
+  }
   return RET_OK;
 }
 }  // namespace mindspore::lite
@@ -0,0 +1,90 @@
+/**
+ * Copyright 2021 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "tools/converter/legacy_optimizer/graph/block_sparse_pass.h"
+#include <algorithm>
+#include <functional>
+#include <numeric>
+#include <set>
+#include <vector>
+#include "ir/dtype/type_id.h"
+#include "src/common/log_adapter.h"
+#include "nnacl/fp32/sparse_matmul_fp32.h"
+
+namespace mindspore::lite {
+namespace {
+constexpr size_t kWeightIndex = 1;
+}  // namespace
+
+bool BlockSparsePass::IsSparseCandidate(const schema::CNodeT &node, const schema::TensorT &weight) {
+  if (weight.dataType != kNumberTypeFloat32 || weight.data.empty() || weight.dims.empty() ||
+      weight.weightQunatCompressType != schema::WeightQunatCompressType_NONE || weight.enableHuffmanCode ||
+      (!weight.quantParams.empty() && weight.quantParams.front()->inited)) {
+    return false;
+  }
+  auto type = node.primitive->value.type;
+  if (type == schema::PrimitiveType_FullConnection) {
+    return weight.dims.size() == 2;
+  }
+  if (type == schema::PrimitiveType_Conv2DFusion) {
+    auto conv = node.primitive->value.AsConv2DFusion();
+    return conv != nullptr && conv->group == 1 && weight.dims.size() == 4 &&
+           std::all_of(conv->kernel_size.begin(), conv->kernel_size.end(), [](int64_t k) { return k == 1; });
+  }
+  return false;
+}
+
+STATUS BlockSparsePass::Run(schema::MetaGraphT *graph) {
+  if (graph == nullptr) {
+    MS_LOG(ERROR) << "graph is nullptr";
+    return RET_NULL_PTR;
+  }
+  std::set<uint32_t> visited;
+  for (auto &node : graph->nodes) {
+    if (node == nullptr || node->primitive == nullptr) {
+      MS_LOG(ERROR) << "node or node->primitive is nullptr";
+      return RET_NULL_PTR;
+    }
+    if (node->inputIndex.size() <= kWeightIndex) {
+      continue;
+    }
+    auto tensor_id = node->inputIndex.at(kWeightIndex);
+    auto &weight = graph->allTensors.at(tensor_id);
+    if (!visited.insert(tensor_id).second || !IsSparseCandidate(*node, *weight)) {
+      continue;
+    }
+    int col = weight->dims.front();
+    int elem_num = std::accumulate(weight->dims.begin(), weight->dims.end(), 1, std::multiplies<int>());
+    if (col <= 0 || elem_num <= 0 || weight->data.size() != elem_num * sizeof(float)) {
+      continue;
+    }
+    int deep = elem_num / col;
+    auto data = reinterpret_cast<const float *>(weight->data.data());
+    int block_num = BlockSparseNonzeroNum(data, col, deep);
+    float sparsity = 1.0f - static_cast<float>(block_num) / (UP_DIV(col, SPARSE_BLOCK) * deep);
+    if (sparsity < threshold_) {
+      continue;
+    }
+    std::vector<uint8_t> packed(BlockSparsePackSize(col, block_num));
+    PackBlockSparse(data, packed.data(), col, deep);
+    MS_LOG(INFO) << "store weight of " << node->name << " block sparse, sparsity: " << sparsity
+                 << ", size: " << weight->data.size() << " -> " << packed.size();
+    weight->data = std::move(packed);
+    weight->weightQunatCompressType = schema::WeightQunatCompressType_BLOCK_SPARSE;
+  }
+  return RET_OK;
+}
+}  // namespace mindspore::lite
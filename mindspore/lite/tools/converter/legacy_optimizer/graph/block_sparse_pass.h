@@ -0,0 +1,41 @@
+/**
+ * Copyright 2021 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef MINDSPORE_LITE_TOOLS_CONVERTER_LEGACY_OPTIMIZER_GRAPH_BLOCK_SPARSE_PASS_H_
+#define MINDSPORE_LITE_TOOLS_CONVERTER_LEGACY_OPTIMIZER_GRAPH_BLOCK_SPARSE_PASS_H_
+
+#include "tools/converter/optimizer.h"
+
+namespace mindspore {
+namespace lite {
+// Stores pruned fp32 weights of FullConnection and 1x1 Conv2DFusion as nonzero blocks (BLOCK_SPARSE) when at least
+// threshold of their blocks are zero. The runtime restores them when loading and the kernels pick their block sparse
+// GEMM from the weight itself. It must be the last pass, the other passes read weight data as dense.
+class BlockSparsePass : public GraphPass {
+ public:
+  explicit BlockSparsePass(float threshold) : threshold_(threshold) {}
+
+  ~BlockSparsePass() override = default;
+
+  STATUS Run(schema::MetaGraphT *graph) override;
+
+ private:
+  bool IsSparseCandidate(const schema::CNodeT &node, const schema::TensorT &weight);
+
+  float threshold_;
+};
+}  // namespace lite
+}  // namespace mindspore
+#endif  // MINDSPORE_LITE_TOOLS_CONVERTER_LEGACY_OPTIMIZER_GRAPH_BLOCK_SPARSE_PASS_H_
@@ -0,0 +1,146 @@
+/**
+ * Copyright 2021 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "tools/converter/legacy_optimizer/graph/transpose_fusion_pass.h"
+#include <algorithm>
+#include <memory>
+#include <utility>
+#include <vector>
+#include "third_party/securec/include/securec.h"
+#include "src/common/log_adapter.h"
+#include "tools/common/graph_util.h"
+#include "tools/common/tensor_util.h"
+#include "tools/optimizer/common/format_utils.h"
+#include "include/errorcode.h"
+#include "schema/inner/model_generated.h"
+
+namespace mindspore::lite {
+namespace {
+constexpr size_t kPermIndex = 1;
+
+size_t CountTransposes(const schema::MetaGraphT &graph) {
+  return std::count_if(graph.nodes.begin(), graph.nodes.end(), [](const std::unique_ptr<schema::CNodeT> &node) {
+    return node->primitive->value.type == schema::PrimitiveType_Transpose && !node->inputIndex.empty();
+  });
+}
+}  // namespace
+
+bool TransposeFusionPass::IsGraphOutput(const schema::MetaGraphT &graph, uint32_t tensor_idx) {
+  if (std::find(graph.outputIndex.begin(), graph.outputIndex.end(), tensor_idx) != graph.outputIndex.end()) {
+    return true;
+  }
+  return std::any_of(graph.subGraph.begin(), graph.subGraph.end(),
+                     [tensor_idx](const std::unique_ptr<schema::SubGraphT> &sub_graph) {
+                       return std::find(sub_graph->outputIndices.begin(), sub_graph->outputIndices.end(),
+                                        tensor_idx) != sub_graph->outputIndices.end();
+                     });
+}
+
+STATUS TransposeFusionPass::SetPerm(schema::MetaGraphT *graph, schema::CNodeT *node, const std::vector<int> &perm) {
+  MS_ASSERT(graph != nullptr && node != nullptr);
+  auto perm_tensor = std::unique_ptr<schema::TensorT>(new (std::nothrow) schema::TensorT);
+  if (perm_tensor == nullptr) {
+    MS_LOG(ERROR) << "new perm tensor failed";
+    return RET_ERROR;
+  }
+  auto &old_perm_tensor = graph->allTensors.at(node->inputIndex.at(kPermIndex));
+  perm_tensor->nodeType = NodeType_ValueNode;
+  perm_tensor->dataType = kNumberTypeInt32;
+  perm_tensor->format = old_perm_tensor->format;
+  perm_tensor->dims = {static_cast<int32_t>(perm.size())};
+  perm_tensor->data.resize(perm.size() * sizeof(int));
+  if (memcpy_s(perm_tensor->data.data(), perm_tensor->data.size(), perm.data(), perm.size() * sizeof(int)) != EOK) {
+    MS_LOG(ERROR) << "memcpy data failed.";
+    return RET_ERROR;
+  }
+  // the old perm may be shared with other transposes
+  auto old_perm_idx = node->inputIndex.at(kPermIndex);
+  graph->allTensors.emplace_back(std::move(perm_tensor));
+  node->inputIndex.at(kPermIndex) = graph->allTensors.size() - 1;
+  return GetRefCount(graph, old_perm_idx) == 0 ? RemoveTensor(graph, {old_perm_idx}) : RET_OK;
+}
+
+STATUS TransposeFusionPass::FuseWithPreTranspose(schema::MetaGraphT *graph, size_t node_idx,
+                                                 const std::vector<int> &perm) {
+  MS_ASSERT(graph != nullptr);
+  auto &node = graph->nodes.at(node_idx);
+  auto pre_node_idxes = GetInputNodeIdx(*graph, node_idx, 0);
+  if (pre_node_idxes.size() != 1) {
+    return RET_NO_CHANGE;
+  }
+  auto pre_node_idx = pre_node_idxes.front();
+  auto &pre_node = graph->nodes.at(pre_node_idx);
+  auto fused_perm = opt::ComposePerm(GetTransposePerm(graph, pre_node), perm);
+  if (fused_perm.empty()) {
+    return RET_NO_CHANGE;
+  }
+  auto pre_output_idx = pre_node->outputIndex.front();
+  bool pre_shared = GetOutputNodeIdx(*graph, pre_node_idx, 0).size() > 1 || IsGraphOutput(*graph, pre_output_idx);
+  // folding into a shared transpose adds a transpose for its other users instead of removing one
+  if (pre_shared && !opt::IsIdentityPerm(fused_perm)) {
+    return RET_NO_CHANGE;
+  }
+  node->inputIndex.at(0) = pre_node->inputIndex.at(0);
+  auto status =
+    opt::IsIdentityPerm(fused_perm) ? IsolateOneWayNode(graph, node_idx) : SetPerm(graph, node.get(), fused_perm);
+  if (status != RET_OK) {
+    MS_LOG(ERROR) << "fuse transpose " << node->name << " with " << pre_node->name << " failed";
+    return status;
+  }
+  if (!pre_shared) {
+    status = IsolateOneWayNode(graph, pre_node_idx);
+    if (status != RET_OK) {
+      MS_LOG(ERROR) << "isolate transpose " << pre_node->name << " failed";
+      return status;
+    }
+  }
+  return RET_OK;
+}
+
+STATUS TransposeFusionPass::Run(schema::MetaGraphT *graph) {
+  if (graph == nullptr) {
+    MS_LOG(ERROR) << "graph is nullptr";
+    return RET_NULL_PTR;
+  }
+  auto origin_count = CountTransposes(*graph);
+  bool changed = false;
+  // nodes are in topological order, a transpose is fused after the one before it is final
+  for (size_t i = 0; i < graph->nodes.size(); i++) {
+    auto &node = graph->nodes.at(i);
+    if (node == nullptr || node->primitive == nullptr) {
+      MS_LOG(ERROR) << "node or node->primitive is nullptr";
+      return RET_NULL_PTR;
+    }
+    if (node->primitive->value.type != schema::PrimitiveType_Transpose || node->inputIndex.size() <= kPermIndex ||
+        node->outputIndex.size() != 1 || IsGraphOutput(*graph, node->outputIndex.front())) {
+      continue;
+    }
+    auto perm = GetTransposePerm(graph, node);
+    if (perm.empty()) {
+      continue;
+    }
+    auto status = opt::IsIdentityPerm(perm) ? IsolateOneWayNode(graph, i) : FuseWithPreTranspose(graph, i, perm);
+    if (status != RET_OK && status != RET_NO_CHANGE) {
+      MS_LOG(ERROR) << "remove redundant transpose " << node->name << " failed";
+      return status;
+    }
+    changed = changed || status == RET_OK;
+  }
+  MS_LOG(INFO) << "transpose count: " << origin_count << " in the origin graph, " << CountTransposes(*graph)
+               << " after transpose fusion.";
+  return changed ? RET_OK : RET_NO_CHANGE;
+}
+}  // namespace mindspore::lite
@@ -0,0 +1,41 @@
+/**
+ * Copyright 2021 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef MINDSPORE_LITE_TOOLS_CONVERTER_LEGACY_OPTIMIZER_GRAPH_TRANSPOSE_FUSION_PASS_H_
+#define MINDSPORE_LITE_TOOLS_CONVERTER_LEGACY_OPTIMIZER_GRAPH_TRANSPOSE_FUSION_PASS_H_
+
+#include <vector>
+#include "tools/converter/optimizer.h"
+
+namespace mindspore {
+namespace lite {
+// Drops identity transposes and merges back to back transposes of the MetaGraphT, the same way UnifyFormatPass does for
+// the func graph. Removed nodes are only isolated, IsolatedNodeRemovePass has to run after it.
+class TransposeFusionPass : public GraphPass {
+ public:
+  TransposeFusionPass() = default;
+
+  ~TransposeFusionPass() override = default;
+
+  STATUS Run(schema::MetaGraphT *graph) override;
+
+ private:
+  bool IsGraphOutput(const schema::MetaGraphT &graph, uint32_t tensor_idx);
+  STATUS SetPerm(schema::MetaGraphT *graph, schema::CNodeT *node, const std::vector<int> &perm);
+  STATUS FuseWithPreTranspose(schema::MetaGraphT *graph, size_t node_idx, const std::vector<int> &perm);
+};
+}  // namespace lite
+}  // namespace mindspore
+#endif  // MINDSPORE_LITE_TOOLS_CONVERTER_LEGACY_OPTIMIZER_GRAPH_TRANSPOSE_FUSION_PASS_H_
@@ -21,6 +21,8 @@
 #include <map>
 #include <memory>
 #include <algorithm>
+#include <chrono>
+#include <set>
 #include <unordered_map>
 #include <functional>
 #include <numeric>
@@ -166,6 +168,72 @@ STATUS DivergInfo::UpdateHistogram(const std::vector<float> &data) {
   return RET_OK;
 }
 
+STATUS DivergInfo::UpdateHistogramStreaming(const std::vector<float> &data) {
+  float max_value = 0.0f;
+  for (auto value : data) {
+    max_value = std::max(max_value, std::fabs(value));
+  }
+  if (max_value == 0.0f) {
+    return RET_OK;
+  }
+  if (this->interval == 0) {
+    this->interval = max_value / static_cast<float>(bin_num);
+  } else {
+    RescaleHistogram(max_value);
+  }
+  return UpdateHistogram(data);
+}
+
+void DivergInfo::RescaleHistogram(float max_value) {
+  // power of two factors keep every old bin inside one new bin
+  int factor = 1;
+  while (this->interval * static_cast<float>(bin_num) * factor < max_value) {
+    factor *= 2;
+  }
+  if (factor == 1) {
+    return;
+  }
+  std::vector<float> rescaled(bin_num, 0.0f);
+  for (int i = 0; i < bin_num; i++) {
+    rescaled[i / factor] += this->histogram[i];
+  }
+  this->histogram = std::move(rescaled);
+  this->interval *= factor;
+}
+
+void DivergInfo::ClearHistogram() { std::fill(histogram.begin(), histogram.end(), 0.0f); }
+
+void DivergInfo::MergeMaxMin(const DivergInfo &other) {
+  this->max = std::max(this->max, other.max);
+  this->min = std::min(this->min, other.min);
+  this->max_datas.insert(this->max_datas.end(), other.max_datas.begin(), other.max_datas.end());
+  this->min_datas.insert(this->min_datas.end(), other.min_datas.begin(), other.min_datas.end());
+}
+
+void DivergInfo::MergeHistogram(const DivergInfo &other) {
+  if (other.interval == 0) {
+    return;
+  }
+  if (this->interval == 0) {
+    this->interval = other.interval;
+    this->histogram = other.histogram;
+    return;
+  }
+  if (this->interval == other.interval) {
+    for (int i = 0; i < bin_num; i++) {
+      this->histogram[i] += other.histogram[i];
+    }
+    return;
+  }
+  RescaleHistogram(other.interval * static_cast<float>(other.bin_num));
+  for (int i = 0; i < other.bin_num; i++) {
+    // a bin of the other histogram moves as a whole to the bin holding its center
+    float center = (static_cast<float>(i) + 0.5f) * other.interval;
+    int bin_index = std::min(static_cast<int>(center / this->interval), bin_num - 1);
+    this->histogram[bin_index] += other.histogram[i];
+  }
+}
+
 void DivergInfo::DumpHistogram() {
   MS_LOG(INFO) << "Print node " << cnode->fullname_with_scope() << " histogram";
   for (float item : this->histogram) {
@@ -503,10 +571,15 @@ PostTrainingQuantizer::PostTrainingQuantizer(FuncGraphPtr graph, string path, in
 }
 
 PostTrainingQuantizer::~PostTrainingQuantizer() {
+  for (size_t i = 1; i < shards_.size(); i++) {
+    delete shards_[i]->session;
+    delete shards_[i]->model;
+  }
   delete fp32_session_;
   delete fp32_model_;
   delete int8_session_;
   delete int8_model_;
+  ClearFp32Outputs();
 }
 
 STATUS PostTrainingQuantizer::DoQuantInput(double scale, int32_t zeropoint, struct MaxMin *max_min,
@@ -779,11 +852,11 @@ STATUS PostTrainingQuantizer::QuantNodeSimpleOp(const CNodePtr &cnode) {
   return RET_OK;
 }
 
-STATUS PostTrainingQuantizer::QuantNode() {
+STATUS PostTrainingQuantizer::QuantNode(const FuncGraphPtr &func_graph) {
   auto inputs_diverg_info = calibrator_->GetInputDivergInfo();
   auto outputs_diverg_info = calibrator_->GetOutputDivergInfo();
 
-  auto cnodes = funcGraph->GetOrderedCnodes();
+  auto cnodes = func_graph->GetOrderedCnodes();
   for (auto &cnode : cnodes) {
     auto op_name = cnode->fullname_with_scope();
     auto primitive = GetValueNode<PrimitivePtr>(cnode->input(0));
@@ -798,6 +871,11 @@ STATUS PostTrainingQuantizer::QuantNode() {
       primitive_quant_holder->set_quant_type(schema::QuantType_QUANT_NONE);
       continue;
     }
+    if (fp32_ops_.find(op_name) != fp32_ops_.end()) {
+      MS_LOG(INFO) << op_name << " is kept in fp32";
+      primitive_quant_holder->set_quant_type(schema::QuantType_QUANT_NONE);
+      continue;
+    }
 
     auto op_type = primitive->name();
     MS_LOG(DEBUG) << "OpName: " << op_name;
@@ -813,6 +891,10 @@ STATUS PostTrainingQuantizer::QuantNode() {
       MS_ASSERT(input_node != nullptr);
       auto input_cnode = std::dynamic_pointer_cast<mindspore::CNode>(input_node);
       MS_ASSERT(input_cnode != nullptr);
+      if (fp32_ops_.find(input_cnode->fullname_with_scope()) != fp32_ops_.end()) {
+        primitive_quant_holder->set_quant_type(schema::QuantType_QUANT_NONE);
+        continue;
+      }
       auto input_cnode_primitive = GetValueNode<PrimitivePtr>(input_cnode->input(0));
       if (input_cnode_primitive == nullptr) {
         MS_LOG(WARNING) << "input_cnode_primitive is null";
@@ -940,20 +1022,152 @@ STATUS PostTrainingQuantizer::CheckFp32TensorVec(const std::string &node_name,
   return RET_OK;
 }
 
+namespace {
+STATUS CalibrateData(const std::vector<float> &data, const std::unique_ptr<DivergInfo> &diverg_info,
+                     CalibrationPass pass) {
+  if (pass == CALIBRATE_FREQUENCY) {
+    return Calibrator::UpdateDataFrequency(data, diverg_info);
+  }
+  auto status = Calibrator::RecordMaxValue(data, diverg_info);
+  if (status != RET_OK || pass == CALIBRATE_MAX_MIN) {
+    return status;
+  }
+  return diverg_info->UpdateHistogramStreaming(data);
+}
+
+void CloneDivergInfo(const DivergInfoMap &src, DivergInfoMap *dst, bool clear_histogram) {
+  dst->clear();
+  for (auto &kv : src) {
+    auto &infos = (*dst)[kv.first];
+    for (auto &info : kv.second) {
+      infos.push_back(std::make_unique<DivergInfo>(*info));
+      if (clear_histogram) {
+        infos.back()->ClearHistogram();
+      }
+    }
+  }
+}
+
+void MergeDivergInfo(DivergInfoMap *dst, const DivergInfoMap &src, CalibrationPass pass) {
+  for (auto &kv : src) {
+    auto &infos = (*dst)[kv.first];
+    for (size_t i = 0; i < kv.second.size(); i++) {
+      // concat, add and multi-output nodes get one info per tensor during the first pass
+      if (i >= infos.size()) {
+        infos.push_back(std::make_unique<DivergInfo>(*kv.second[i]));
+        continue;
+      }
+      if (pass != CALIBRATE_FREQUENCY) {
+        infos[i]->MergeMaxMin(*kv.second[i]);
+      }
+      if (pass != CALIBRATE_MAX_MIN) {
+        infos[i]->MergeHistogram(*kv.second[i]);
+      }
+    }
+  }
+}
+}  // namespace
+
 /**
  * 1. create input tensor
  * 2. insert callback to session
  * 3. run session
  **/
-STATUS PostTrainingQuantizer::DoInference() {
+STATUS PostTrainingQuantizer::DoInference() { return RunCalibration(CALIBRATE_MAX_MIN); }
+
+STATUS PostTrainingQuantizer::CreateCalibrationShards(const FuncGraphPtr &func_graph) {
+  shards_.clear();
+  auto shard_num = std::max<size_t>(std::min<size_t>(calibrator_->config_param_.calibrate_shard_num,
+                                                     calibrator_->GetBatchNum()),
+                                    1);
+  auto shard = std::make_unique<CalibrationShard>();
+  shard->session = fp32_session_;
+  shards_.push_back(std::move(shard));
+  // threads of the calibration are shared by the shards
+  int thread_num = std::max(static_cast<int>(calibrator_->GetThreadNum() / shard_num), 1);
+  for (size_t i = 1; i < shard_num; i++) {
+    auto sm = CreateSessionByFuncGraph(func_graph, flags, thread_num);
+    if (sm.session == nullptr || sm.model == nullptr) {
+      MS_LOG(ERROR) << "create session for calibration shard " << i << " failed!";
+      delete sm.session;
+      delete sm.model;
+      return RET_ERROR;
+    }
+    shard = std::make_unique<CalibrationShard>();
+    shard->session = sm.session;
+    shard->model = sm.model;
+    shards_.push_back(std::move(shard));
+  }
+  MS_LOG(INFO) << "calibrate with " << shard_num << " shards";
+  return RET_OK;
+}
+
+STATUS PostTrainingQuantizer::RunCalibrationShard(session::LiteSession *session, size_t shard_index,
+                                                  CalibrationPass pass, DivergInfoMap *inputs_diverg_info,
+                                                  DivergInfoMap *outputs_diverg_info) {
+  MS_ASSERT(session != nullptr);
   // get input tensor
-  vector<mindspore::tensor::MSTensor *> inputs = fp32_session_->GetInputs();
+  vector<mindspore::tensor::MSTensor *> inputs = session->GetInputs();
   if (inputs.size() != calibrator_->GetInputNum()) {
     MS_LOG(ERROR) << "model's input tensor cnt: " << inputs.size() << " != " << calibrator_->GetInputNum();
     return RET_ERROR;
   }
-
-  for (size_t i = 0; i < calibrator_->GetBatchNum(); i++) {
+  bool expand_info = pass != CALIBRATE_FREQUENCY;
+  KernelCallBack beforeCallBack = [&](const std::vector<mindspore::tensor::MSTensor *> &beforeInputs,
+                                      const std::vector<mindspore::tensor::MSTensor *> &beforeOutputs,
+                                      const CallBackParam &callParam) -> bool {
+    auto iter = inputs_diverg_info->find(callParam.node_name);
+    if (iter == inputs_diverg_info->end()) {
+      return true;
+    }
+    if (PostTrainingQuantizer::CheckFp32TensorVec(callParam.node_name, beforeInputs) != RET_OK) {
+      return false;
+    }
+    auto &infos = iter->second;
+    if (expand_info && infos.size() == 1 && (callParam.node_type == kTypeConcat || callParam.node_type == kTypeAdd)) {
+      for (size_t i = 1; i < beforeInputs.size(); i++) {
+        infos.push_back(std::make_unique<DivergInfo>(*infos[0]));
+      }
+    }
+    for (size_t i = 0; i < infos.size(); i++) {
+      auto tensor = beforeInputs[i];
+      MS_ASSERT(tensor != nullptr);
+      const auto *tensor_data = static_cast<const float *>(tensor->MutableData());
+      MS_ASSERT(tensor_data != nullptr);
+      size_t elem_count = tensor->ElementsNum();
+      vector<float> data(tensor_data, tensor_data + elem_count);
+      CalibrateData(data, infos[i], pass);
+    }
+    return true;
+  };
+  KernelCallBack afterCallBack = [&](const std::vector<mindspore::tensor::MSTensor *> &afterInputs,
+                                     const std::vector<mindspore::tensor::MSTensor *> &afterOutputs,
+                                     const CallBackParam &callParam) -> bool {
+    auto iter = outputs_diverg_info->find(callParam.node_name);
+    if (iter == outputs_diverg_info->end()) {
+      return true;
+    }
+    if (PostTrainingQuantizer::CheckFp32TensorVec(callParam.node_name, afterOutputs) != RET_OK) {
+      return false;
+    }
+    auto &infos = iter->second;
+    if (expand_info && infos.size() == 1 && afterOutputs.size() > 1) {
+      for (size_t i = 1; i < afterOutputs.size(); i++) {
+        infos.push_back(std::make_unique<DivergInfo>(*infos[0]));
+      }
+    }
+    size_t output_i = 0;
+    for (const auto &tensor : afterOutputs) {
+      const auto *tensor_data = static_cast<const float *>(tensor->MutableData());
+      MS_ASSERT(tensor_data != nullptr);
+      size_t elem_count = tensor->ElementsNum();
+      vector<float> data(tensor_data, tensor_data + elem_count);
+      CalibrateData(data, infos[output_i], pass);
+      output_i++;
+    }
+    return true;
+  };
+  for (size_t i = shard_index; i < calibrator_->GetBatchNum(); i += shards_.size()) {
     // set multi-input data
     for (size_t input_index = 0; input_index < inputs.size(); input_index++) {
       STATUS status = calibrator_->GenerateInputData(input_index, i, inputs[input_index]);
@@ -962,65 +1176,7 @@ STATUS PostTrainingQuantizer::DoInference() {
         return RET_ERROR;
       }
     }
-
-    KernelCallBack beforeCallBack = [&](const std::vector<mindspore::tensor::MSTensor *> &beforeInputs,
-                                        const std::vector<mindspore::tensor::MSTensor *> &beforeOutputs,
-                                        const CallBackParam &callParam) -> bool {
-      auto diverg_info_map = calibrator_->GetInputDivergInfo();
-      if (diverg_info_map->find(callParam.node_name) == diverg_info_map->end()) {
-        return true;
-      }
-      if (PostTrainingQuantizer::CheckFp32TensorVec(callParam.node_name, beforeInputs) != RET_OK) {
-        return false;
-      }
-      if ((*diverg_info_map)[callParam.node_name].size() == 1 &&
-          (callParam.node_type == kTypeConcat || callParam.node_type == kTypeAdd)) {
-        for (size_t i = 1; i < beforeInputs.size(); i++) {
-          auto input_diverg = std::make_unique<DivergInfo>();
-          *input_diverg = *((*diverg_info_map)[callParam.node_name][0]);
-          (*diverg_info_map)[callParam.node_name].push_back(std::move(input_diverg));
-        }
-      }
-      for (size_t i = 0; i < (*diverg_info_map)[callParam.node_name].size(); i++) {
-        auto tensor = beforeInputs[i];
-        MS_ASSERT(tensor != nullptr);
-        const auto *tensor_data = static_cast<const float *>(tensor->MutableData());
-        MS_ASSERT(tensor_data != nullptr);
-        size_t elem_count = tensor->ElementsNum();
-        vector<float> data(tensor_data, tensor_data + elem_count);
-        this->calibrator_->RecordMaxValue(data, (*diverg_info_map)[callParam.node_name][i]);
-      }
-      return true;
-    };
-    // func
-    KernelCallBack afterCallBack = [&](const std::vector<mindspore::tensor::MSTensor *> &afterInputs,
-                                       const std::vector<mindspore::tensor::MSTensor *> &afterOutputs,
-                                       const CallBackParam &callParam) -> bool {
-      auto diverg_info_map = calibrator_->GetOutputDivergInfo();
-      if (diverg_info_map->find(callParam.node_name) == diverg_info_map->end()) {
-        return true;
-      }
-      if (PostTrainingQuantizer::CheckFp32TensorVec(callParam.node_name, afterOutputs) != RET_OK) {
-        return false;
-      }
-      if ((*diverg_info_map)[callParam.node_name].size() == 1 && afterOutputs.size() > 1) {
-        for (size_t i = 1; i < afterOutputs.size(); i++) {
-          auto output_diverg = std::make_unique<DivergInfo>();
-          *output_diverg = *((*diverg_info_map)[callParam.node_name][0]);
-          (*diverg_info_map)[callParam.node_name].push_back(std::move(output_diverg));
-        }
-      }
-      size_t output_i = 0;
-      for (const auto &tensor : afterOutputs) {
-        const auto *tensor_data = static_cast<const float *>(tensor->MutableData());
-        size_t elem_count = tensor->ElementsNum();
-        vector<float> data(tensor_data, tensor_data + elem_count);
-        this->calibrator_->RecordMaxValue(data, (*diverg_info_map)[callParam.node_name][output_i]);
-        output_i++;
-      }
-      return true;
-    };
-    auto status = fp32_session_->RunGraph(beforeCallBack, afterCallBack);
+    auto status = session->RunGraph(beforeCallBack, afterCallBack);
     if (status != RET_OK) {
       MS_LOG(ERROR) << "run model failed!";
       return RET_ERROR;
@@ -1029,6 +1185,55 @@ STATUS PostTrainingQuantizer::DoInference() {
   return RET_OK;
 }
 
+STATUS PostTrainingQuantizer::RunCalibration(CalibrationPass pass) {
+  auto inputs_diverg_info = calibrator_->GetInputDivergInfo();
+  auto outputs_diverg_info = calibrator_->GetOutputDivergInfo();
+  if (shards_.size() <= 1) {
+    return RunCalibrationShard(fp32_session_, 0, pass, inputs_diverg_info, outputs_diverg_info);
+  }
+  // every shard collects into its own copy of the infos, histograms of the frequency pass start empty
+  bool clear_histogram = pass == CALIBRATE_FREQUENCY;
+  for (auto &shard : shards_) {
+    CloneDivergInfo(*inputs_diverg_info, &shard->inputs_diverg_info, clear_histogram);
+    CloneDivergInfo(*outputs_diverg_info, &shard->outputs_diverg_info, clear_histogram);
+  }
+  std::vector<std::future<STATUS>> results;
+  for (size_t i = 1; i < shards_.size(); i++) {
+    auto *shard = shards_[i].get();
+    results.push_back(std::async(std::launch::async, &PostTrainingQuantizer::RunCalibrationShard, this,
+                                 shard->session, i, pass, &shard->inputs_diverg_info, &shard->outputs_diverg_info));
+  }
+  auto status = RunCalibrationShard(fp32_session_, 0, pass, &shards_[0]->inputs_diverg_info,
+                                    &shards_[0]->outputs_diverg_info);
+  for (auto &result : results) {
+    auto ret = result.get();
+    status = status == RET_OK ? ret : status;
+  }
+  if (status != RET_OK) {
+    MS_LOG(ERROR) << "calibration shard failed!";
+    return status;
+  }
+  if (pass == CALIBRATE_FREQUENCY) {
+    for (auto &shard : shards_) {
+      MergeDivergInfo(inputs_diverg_info, shard->inputs_diverg_info, pass);
+      MergeDivergInfo(outputs_diverg_info, shard->outputs_diverg_info, pass);
+    }
+  } else {
+    // shard 0 started from the untouched infos, it becomes the base of the merge
+    inputs_diverg_info->swap(shards_[0]->inputs_diverg_info);
+    outputs_diverg_info->swap(shards_[0]->outputs_diverg_info);
+    for (size_t i = 1; i < shards_.size(); i++) {
+      MergeDivergInfo(inputs_diverg_info, shards_[i]->inputs_diverg_info, pass);
+      MergeDivergInfo(outputs_diverg_info, shards_[i]->outputs_diverg_info, pass);
+    }
+  }
+  for (auto &shard : shards_) {
+    shard->inputs_diverg_info.clear();
+    shard->outputs_diverg_info.clear();
+  }
+  return RET_OK;
+}
+
 STATUS PostTrainingQuantizer::Int8Inference() {
   // int8 inference
   vector<mindspore::tensor::MSTensor *> inputs = int8_session_->GetInputs();
@@ -1196,78 +1401,319 @@ STATUS PostTrainingQuantizer::BiasCorrection(const FuncGraphPtr &func_graph, con
   return RET_OK;
 }
 
-STATUS PostTrainingQuantizer::CollectDataFrequency() {
-  // get input tensor
-  vector<mindspore::tensor::MSTensor *> inputs = fp32_session_->GetInputs();
+STATUS PostTrainingQuantizer::CollectDataFrequency() { return RunCalibration(CALIBRATE_FREQUENCY); }
+
+STATUS PostTrainingQuantizer::ComputeThreshold() { return this->calibrator_->ComputeThreshold(); }
+
+namespace {
+// quant casts rename the graph outputs, so outputs of different candidates are matched by their index
+STATUS IndexedOutputs(const session::LiteSession *session,
+                      std::unordered_map<std::string, mindspore::tensor::MSTensor *> *outputs) {
+  MS_ASSERT(session != nullptr);
+  MS_ASSERT(outputs != nullptr);
+  outputs->clear();
+  auto names = session->GetOutputTensorNames();
+  for (size_t i = 0; i < names.size(); i++) {
+    auto tensor = session->GetOutputByTensorName(names[i]);
+    if (tensor == nullptr) {
+      MS_LOG(ERROR) << "can not find output tensor: " << names[i];
+      return RET_ERROR;
+    }
+    (*outputs)[std::to_string(i)] = tensor;
+  }
+  return RET_OK;
+}
+
+// copies of a func graph share the primitives, quant params written while evaluating a copy are rolled back
+std::vector<std::pair<PrimitivePtr, QuantParamHolder>> SaveQuantParams(const FuncGraphPtr &func_graph) {
+  std::vector<std::pair<PrimitivePtr, QuantParamHolder>> quant_params;
+  for (auto &cnode : func_graph->GetOrderedCnodes()) {
+    auto primitive = GetValueNode<PrimitivePtr>(cnode->input(0));
+    if (primitive == nullptr) {
+      continue;
+    }
+    auto quant_param_holder = GetCNodeQuantHolder(primitive);
+    MS_ASSERT(quant_param_holder != nullptr);
+    quant_params.emplace_back(primitive, *quant_param_holder);
+  }
+  return quant_params;
+}
+
+void RestoreQuantParams(const std::vector<std::pair<PrimitivePtr, QuantParamHolder>> &quant_params) {
+  for (auto &item : quant_params) {
+    item.first->AddAttr("quant_params", std::make_shared<QuantParamHolder>(item.second));
+  }
+}
+}  // namespace
+
+void PostTrainingQuantizer::ClearFp32Outputs() {
+  for (auto &outputs : fp32_outputs_) {
+    for (auto &kv : outputs) {
+      delete kv.second;
+    }
+  }
+  fp32_outputs_.clear();
+}
+
+STATUS PostTrainingQuantizer::ProfileSession(session::LiteSession *session, std::map<std::string, double> *op_costs,
+                                             double *latency, float *error) {
+  MS_ASSERT(session != nullptr);
+  MS_ASSERT(op_costs != nullptr);
+  MS_ASSERT(latency != nullptr);
+  auto inputs = session->GetInputs();
   if (inputs.size() != calibrator_->GetInputNum()) {
     MS_LOG(ERROR) << "model's input tensor cnt: " << inputs.size() << " != " << calibrator_->GetInputNum();
     return RET_ERROR;
   }
-
-  for (size_t i = 0; i < calibrator_->GetBatchNum(); i++) {
-    // set multi-input data
+  std::map<std::string, std::chrono::steady_clock::time_point> op_begin;
+  KernelCallBack before_call_back = [&](const std::vector<mindspore::tensor::MSTensor *> &before_inputs,
+                                        const std::vector<mindspore::tensor::MSTensor *> &before_outputs,
+                                        const CallBackParam &call_param) -> bool {
+    op_begin[call_param.node_name] = std::chrono::steady_clock::now();
+    return true;
+  };
+  KernelCallBack after_call_back = [&](const std::vector<mindspore::tensor::MSTensor *> &after_inputs,
+                                       const std::vector<mindspore::tensor::MSTensor *> &after_outputs,
+                                       const CallBackParam &call_param) -> bool {
+    auto end = std::chrono::steady_clock::now();
+    auto iter = op_begin.find(call_param.node_name);
+    if (iter != op_begin.end()) {
+      (*op_costs)[call_param.node_name] += std::chrono::duration<double, std::micro>(end - iter->second).count();
+    }
+    return true;
+  };
+  op_costs->clear();
+  *latency = 0;
+  float total_error = 0;
+  auto batch_num = calibrator_->GetBatchNum();
+  if (batch_num == 0) {
+    MS_LOG(ERROR) << "no calibration data to profile";
+    return RET_ERROR;
+  }
+  if (error == nullptr) {
+    ClearFp32Outputs();
+    fp32_outputs_.resize(batch_num);
+  }
+  for (size_t i = 0; i < batch_num; i++) {
     for (size_t input_index = 0; input_index < inputs.size(); input_index++) {
-      STATUS status = calibrator_->GenerateInputData(input_index, i, inputs[input_index]);
+      auto status = calibrator_->GenerateInputData(input_index, i, inputs[input_index]);
       if (status != RET_OK) {
         MS_LOG(ERROR) << "generate input data from images failed!";
         return RET_ERROR;
       }
     }
-
-    KernelCallBack beforeCallBack = [&](const std::vector<mindspore::tensor::MSTensor *> &beforeInputs,
-                                        const std::vector<mindspore::tensor::MSTensor *> &beforeOutputs,
-                                        const CallBackParam &callParam) {
-      auto diverg_info_map = calibrator_->GetInputDivergInfo();
-      if (diverg_info_map->find(callParam.node_name) == diverg_info_map->end()) {
-        return true;
-      }
-      if (PostTrainingQuantizer::CheckFp32TensorVec(callParam.node_name, beforeInputs) != RET_OK) {
-        return false;
-      }
-      for (size_t i = 0; i < (*diverg_info_map)[callParam.node_name].size(); i++) {
-        auto tensor = beforeInputs[i];
-        MS_ASSERT(tensor != nullptr);
-        const auto *tensor_data = static_cast<const float *>(tensor->MutableData());
-        MS_ASSERT(tensor_data != nullptr);
-        size_t elem_count = tensor->ElementsNum();
-        vector<float> data(tensor_data, tensor_data + elem_count);
-        this->calibrator_->UpdateDataFrequency(data, (*diverg_info_map)[callParam.node_name][i]);
-      }
-      return true;
-    };
-
-    KernelCallBack afterCallBack = [&](const std::vector<mindspore::tensor::MSTensor *> &after_inputs,
-                                       const std::vector<mindspore::tensor::MSTensor *> &after_outputs,
-                                       const CallBackParam &call_param) {
-      auto diverg_info_map = calibrator_->GetOutputDivergInfo();
-      if (diverg_info_map->find(call_param.node_name) == diverg_info_map->end()) {
-        return true;
-      }
-      if (PostTrainingQuantizer::CheckFp32TensorVec(call_param.node_name, after_outputs) != RET_OK) {
-        return false;
-      }
-      int output_i = 0;
-      for (const auto &tensor : after_outputs) {
-        const auto *tensor_data = static_cast<const float *>(tensor->MutableData());
-        MS_ASSERT(tensor_data != nullptr);
-        size_t elem_count = tensor->ElementsNum();
-        vector<float> data(tensor_data, tensor_data + elem_count);
-        this->calibrator_->UpdateDataFrequency(data, (*diverg_info_map)[call_param.node_name][output_i]);
-        output_i++;
-      }
-      return true;
-    };
-    auto status = fp32_session_->RunGraph(beforeCallBack, afterCallBack);
+    // the per op run also warms up the end to end run, which is timed without the callback overhead
+    auto status = session->RunGraph(before_call_back, after_call_back);
+    if (status != RET_OK) {
+      MS_LOG(ERROR) << "run model failed!";
+      return RET_ERROR;
+    }
+    auto begin = std::chrono::steady_clock::now();
+    status = session->RunGraph();
     if (status != RET_OK) {
       MS_LOG(ERROR) << "run model failed!";
       return RET_ERROR;
     }
+    *latency += std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - begin).count();
+    std::unordered_map<std::string, mindspore::tensor::MSTensor *> outputs;
+    status = IndexedOutputs(session, &outputs);
+    if (status != RET_OK) {
+      return status;
+    }
+    if (error != nullptr) {
+      auto mean_error = CompareOutputData<float>(fp32_outputs_[i], outputs);
+      if (mean_error < 0) {
+        MS_LOG(ERROR) << "compare output with fp32 model failed";
+        return RET_ERROR;
+      }
+      total_error += mean_error;
+      continue;
+    }
+    for (auto &kv : outputs) {
+      auto *new_tensor = Tensor::CopyTensor(*reinterpret_cast<lite::Tensor *>(kv.second), true);
+      if (new_tensor == nullptr) {
+        MS_LOG(ERROR) << "copy output tensor failed";
+        return RET_ERROR;
+      }
+      fp32_outputs_[i][kv.first] = new_tensor;
+    }
+  }
+  for (auto &kv : *op_costs) {
+    kv.second /= batch_num;
+  }
+  *latency /= batch_num;
+  if (error != nullptr) {
+    *error = total_error / batch_num;
   }
+  return RET_OK;
+}
 
+STATUS PostTrainingQuantizer::EvaluateCandidate(const FuncGraphPtr &func_graph, const std::set<std::string> &fp32_ops,
+                                                std::map<std::string, double> *op_costs, double *latency,
+                                                float *error) {
+  auto candidate = CopyFuncGraph(func_graph);
+  if (candidate == nullptr) {
+    MS_LOG(ERROR) << "CopyFuncGraph error";
+    return RET_ERROR;
+  }
+  auto quant_params = SaveQuantParams(func_graph);
+  fp32_ops_ = fp32_ops;
+  auto status = QuantNode(candidate);
+  if (status == RET_OK) {
+    quant::QuantCast quant_cast;
+    quant_cast.set_input_data_dtype(kNumberTypeFloat32);
+    status = quant_cast.Run(candidate);
+  }
+  SessionModel sm;
+  if (status == RET_OK) {
+    flags.quantType = schema::QuantType_PostTraining;
+    sm = CreateSessionByFuncGraph(candidate, flags, calibrator_->GetThreadNum());
+    flags.quantType = schema::QuantType_QUANT_NONE;
+  }
+  RestoreQuantParams(quant_params);
+  fp32_ops_.clear();
+  if (status != RET_OK || sm.session == nullptr || sm.model == nullptr) {
+    MS_LOG(ERROR) << "create session of the mixed precision candidate failed!";
+    delete sm.session;
+    delete sm.model;
+    return RET_ERROR;
+  }
+  status = ProfileSession(sm.session, op_costs, latency, error);
+  delete sm.session;
+  delete sm.model;
+  return status;
+}
+
+/**
+ * 1. keep the ops in fp32 whose int8 kernel is not faster
+ * 2. quantize the ops with the largest latency gain first, binary searching the largest prefix whose output error
+ *    stays within max_accuracy_loss
+ * 3. try the remaining ops one by one in the same order, so an op which alone breaks the budget stays in fp32
+ *    without keeping the cheaper ops behind it in fp32 too
+ * the measured fastest candidate within the budget wins
+ **/
+STATUS SearchMixedPrecision(const MixedPrecisionProfile &profile, float max_accuracy_loss,
+                            const CandidateEvaluator &evaluate, std::set<std::string> *fp32_ops) {
+  MS_ASSERT(fp32_ops != nullptr);
+  std::set<std::string> slower_ops;
+  std::vector<std::pair<std::string, double>> gains;
+  for (auto &op : profile.ops) {
+    auto fp32_iter = profile.fp32_costs.find(op);
+    auto int8_iter = profile.int8_costs.find(op);
+    // ops without a kernel of their own (e.g. fused away) follow the default
+    if (fp32_iter == profile.fp32_costs.end() || int8_iter == profile.int8_costs.end()) {
+      continue;
+    }
+    auto gain = fp32_iter->second - int8_iter->second;
+    MS_LOG(DEBUG) << "op: " << op << " fp32: " << fp32_iter->second << "us int8: " << int8_iter->second << "us";
+    if (gain <= 0) {
+      slower_ops.insert(op);
+    } else {
+      gains.emplace_back(op, gain);
+    }
+  }
+  std::stable_sort(gains.begin(), gains.end(),
+                   [](const std::pair<std::string, double> &a, const std::pair<std::string, double> &b) {
+                     return a.second > b.second;
+                   });
+
+  std::set<std::string> best_fp32_ops(profile.ops.begin(), profile.ops.end());
+  double best_latency = profile.fp32_latency;
+  if (profile.int8_error <= max_accuracy_loss && profile.int8_latency < best_latency) {
+    best_fp32_ops.clear();
+    best_latency = profile.int8_latency;
+  }
+  auto try_candidate = [&](const std::set<std::string> &candidate, bool *in_budget) {
+    double latency = 0;
+    float error = 0;
+    auto status = evaluate(candidate, &latency, &error);
+    if (status != RET_OK) {
+      return status;
+    }
+    MS_LOG(INFO) << "keep " << candidate.size() << " ops in fp32, latency: " << latency << "us, error: " << error;
+    *in_budget = error <= max_accuracy_loss;
+    if (*in_budget && latency < best_latency) {
+      best_latency = latency;
+      best_fp32_ops = candidate;
+    }
+    return RET_OK;
+  };
+  // the output error is assumed to grow with the number of quantized ops
+  size_t low = 0;
+  size_t high = gains.size();
+  while (low < high) {
+    auto mid = (low + high + 1) / 2;
+    auto candidate = slower_ops;
+    for (size_t i = mid; i < gains.size(); i++) {
+      candidate.insert(gains[i].first);
+    }
+    bool in_budget = false;
+    auto status = try_candidate(candidate, &in_budget);
+    if (status != RET_OK) {
+      return status;
+    }
+    if (in_budget) {
+      low = mid;
+    } else {
+      high = mid - 1;
+    }
+  }
+  // gains[low] broke the budget, the ops behind it may not
+  auto kept = slower_ops;
+  for (size_t i = low; i < gains.size(); i++) {
+    kept.insert(gains[i].first);
+  }
+  for (size_t i = low + 1; i < gains.size(); i++) {
+    auto candidate = kept;
+    candidate.erase(gains[i].first);
+    bool in_budget = false;
+    auto status = try_candidate(candidate, &in_budget);
+    if (status != RET_OK) {
+      return status;
+    }
+    if (in_budget) {
+      kept = std::move(candidate);
+    }
+  }
+  *fp32_ops = std::move(best_fp32_ops);
   return RET_OK;
 }
 
-STATUS PostTrainingQuantizer::ComputeThreshold() { return this->calibrator_->ComputeThreshold(); }
+STATUS PostTrainingQuantizer::MixedPrecisionSearch(const FuncGraphPtr &func_graph) {
+  MixedPrecisionProfile profile;
+  auto status = ProfileSession(fp32_session_, &profile.fp32_costs, &profile.fp32_latency, nullptr);
+  if (status != RET_OK) {
+    MS_LOG(ERROR) << "profile fp32 model failed";
+    ClearFp32Outputs();
+    return status;
+  }
+  status = EvaluateCandidate(func_graph, {}, &profile.int8_costs, &profile.int8_latency, &profile.int8_error);
+  if (status != RET_OK) {
+    MS_LOG(ERROR) << "profile int8 model failed";
+    ClearFp32Outputs();
+    return status;
+  }
+  MS_LOG(INFO) << "fp32 latency: " << profile.fp32_latency << "us, int8 latency: " << profile.int8_latency
+               << "us, int8 error: " << profile.int8_error;
+  for (auto &kv : *calibrator_->GetInputDivergInfo()) {
+    profile.ops.push_back(kv.first);
+  }
+  std::sort(profile.ops.begin(), profile.ops.end());
+  auto evaluate = [this, &func_graph](const std::set<std::string> &fp32_ops, double *latency, float *error) {
+    std::map<std::string, double> op_costs;
+    return EvaluateCandidate(func_graph, fp32_ops, &op_costs, latency, error);
+  };
+  std::set<std::string> fp32_ops;
+  status = SearchMixedPrecision(profile, calibrator_->config_param_.max_accuracy_loss, evaluate, &fp32_ops);
+  ClearFp32Outputs();
+  if (status != RET_OK) {
+    return status;
+  }
+  fp32_ops_ = fp32_ops;
+  MS_LOG(INFO) << "mixed precision keeps " << fp32_ops_.size() << " of " << profile.ops.size()
+               << " quantizable ops in fp32";
+  return RET_OK;
+}
 
 STATUS PostTrainingQuantizer::DoQuantize(FuncGraphPtr func_graph) {
   MS_LOG(INFO) << "start to parse config file";
@@ -1316,20 +1762,32 @@ STATUS PostTrainingQuantizer::DoQuantize(FuncGraphPtr func_graph) {
     return RET_ERROR;
   }
 
-  MS_LOG(INFO) << "start to update divergence's max value";
-  status = DoInference();
-  if (status != RET_OK) {
-    return status;
-  }
-  MS_LOG(INFO) << "start to update divergence's interval";
-  status = UpdateDivergInverval();
+  status = CreateCalibrationShards(func_graph);
   if (status != RET_OK) {
     return status;
   }
-  MS_LOG(INFO) << "start to collect data's distribution";
-  status = CollectDataFrequency();
-  if (status != RET_OK) {
-    return status;
+  if (calibrator_->config_param_.single_pass) {
+    MS_LOG(INFO) << "start to collect data's max value and distribution";
+    status = RunCalibration(CALIBRATE_STREAMING);
+    if (status != RET_OK) {
+      return status;
+    }
+  } else {
+    MS_LOG(INFO) << "start to update divergence's max value";
+    status = DoInference();
+    if (status != RET_OK) {
+      return status;
+    }
+    MS_LOG(INFO) << "start to update divergence's interval";
+    status = UpdateDivergInverval();
+    if (status != RET_OK) {
+      return status;
+    }
+    MS_LOG(INFO) << "start to collect data's distribution";
+    status = CollectDataFrequency();
+    if (status != RET_OK) {
+      return status;
+    }
   }
   MS_LOG(INFO) << "compute the best threshold";
   status = ComputeThreshold();
@@ -1337,7 +1795,14 @@ STATUS PostTrainingQuantizer::DoQuantize(FuncGraphPtr func_graph) {
     return status;
   }
   MS_LOG(INFO) << "start to generate quant param and quantize tensor's data";
-  status = QuantNode();
+  if (calibrator_->config_param_.mixed_precision_search) {
+    MS_LOG(INFO) << "search the fastest mixed precision within the accuracy budget";
+    status = MixedPrecisionSearch(func_graph);
+    if (status != RET_OK) {
+      return status;
+    }
+  }
+  status = QuantNode(func_graph);
   if (status != RET_OK) {
     return status;
   }
@@ -18,11 +18,13 @@
 #define MINDSPORE_LITE_TOOLS_CONVERTER_QUANTIZER_POSTRAINING_QUANTIZER_H
 
 #include <string>
+#include <functional>
 #include <memory>
 #include <unordered_map>
 #include <vector>
 #include <cfloat>
 #include <map>
+#include <set>
 #include <utility>
 #include "ops/primitive_c.h"
 #include "schema/inner/model_generated.h"
@@ -35,6 +37,17 @@
 
 namespace mindspore::lite::quant {
 class Calibrator;
+struct DivergInfo;
+struct CalibrationShard;
+
+using DivergInfoMap = std::unordered_map<std::string, std::vector<std::unique_ptr<DivergInfo>>>;
+
+// the default calibration runs CALIBRATE_MAX_MIN then CALIBRATE_FREQUENCY, CALIBRATE_STREAMING does both at once
+enum CalibrationPass {
+  CALIBRATE_MAX_MIN,
+  CALIBRATE_FREQUENCY,
+  CALIBRATE_STREAMING,
+};
 
 struct MaxMin {
  public:
@@ -44,6 +57,24 @@ struct MaxMin {
 
 constexpr int kDefaultBinNumber = 2048;
 
+// profile of the fp32 and the fully quantized model, costs are the average per op latency in us
+struct MixedPrecisionProfile {
+  std::vector<std::string> ops;
+  std::map<std::string, double> fp32_costs;
+  std::map<std::string, double> int8_costs;
+  double fp32_latency = 0;
+  double int8_latency = 0;
+  float int8_error = 0;
+};
+
+// end to end latency in us and mean output error of the model quantized except for fp32_ops
+using CandidateEvaluator =
+  std::function<STATUS(const std::set<std::string> &fp32_ops, double *latency, float *error)>;
+
+// choose the ops kept in fp32, the fastest evaluated candidate within max_accuracy_loss wins
+STATUS SearchMixedPrecision(const MixedPrecisionProfile &profile, float max_accuracy_loss,
+                            const CandidateEvaluator &evaluate, std::set<std::string> *fp32_ops);
+
 class PostTrainingQuantizer : public Quantizer {
  public:
   PostTrainingQuantizer(FuncGraphPtr graph, std::string path, int bit_num, TypeId target_type = kNumberTypeInt8,
@@ -65,11 +96,19 @@ class PostTrainingQuantizer : public Quantizer {
 
   std::unique_ptr<Calibrator> calibrator_;
 
+  // shard 0 runs on fp32_session_, the other shards own their sessions
+  std::vector<std::unique_ptr<CalibrationShard>> shards_;
+
   session::LiteSession *fp32_session_{nullptr};
   Model *fp32_model_{nullptr};
   session::LiteSession *int8_session_{nullptr};
   Model *int8_model_{nullptr};
 
+  // quantizable ops kept in fp32 by the mixed precision search
+  std::set<std::string> fp32_ops_;
+  // fp32 outputs of the calibration images, matched by output index
+  std::vector<std::unordered_map<std::string, mindspore::tensor::MSTensor *>> fp32_outputs_;
+
   std::map<std::string, std::vector<float>> fp32_op_input_map;           // concurrency
   std::map<std::string, std::vector<float>> fp32_op_output_ch_mean_map;  // concurrency
   std::map<std::string, std::vector<float>> op_bias_diff_map;            // only use by int8 model
@@ -101,11 +140,31 @@ class PostTrainingQuantizer : public Quantizer {
 
   STATUS CollectDataFrequency();
 
+  STATUS CreateCalibrationShards(const FuncGraphPtr &func_graph);
+
+  STATUS RunCalibration(CalibrationPass pass);
+
+  STATUS RunCalibrationShard(session::LiteSession *session, size_t shard_index, CalibrationPass pass,
+                             DivergInfoMap *inputs_diverg_info, DivergInfoMap *outputs_diverg_info);
+
   STATUS ComputeThreshold();
 
   STATUS QuantNodeSimpleOp(const CNodePtr &cnode);
 
-  STATUS QuantNode();
+  STATUS QuantNode(const FuncGraphPtr &func_graph);
+
+  STATUS MixedPrecisionSearch(const FuncGraphPtr &func_graph);
+
+  // run the calibration images, collecting the average per op and end to end latency in us. the fp32 outputs are
+  // stored when error is null, otherwise the mean error against them is returned
+  STATUS ProfileSession(session::LiteSession *session, std::map<std::string, double> *op_costs, double *latency,
+                        float *error);
+
+  // quantize a copy of func_graph keeping fp32_ops in fp32 and profile it
+  STATUS EvaluateCandidate(const FuncGraphPtr &func_graph, const std::set<std::string> &fp32_ops,
+                           std::map<std::string, double> *op_costs, double *latency, float *error);
+
+  void ClearFp32Outputs();
 
   STATUS DoQuantInput(double scale, int32_t zeropoint, struct MaxMin *max_min, const PrimitivePtr &primitive) const;
 
@@ -162,6 +221,18 @@ struct DivergInfo {
 
   STATUS UpdateHistogram(const std::vector<float> &data);
 
+  // update the histogram without a known range, bins are merged whenever data exceeds the current range
+  STATUS UpdateHistogramStreaming(const std::vector<float> &data);
+
+  // widen the histogram by a power of two until it covers max_value
+  void RescaleHistogram(float max_value);
+
+  void ClearHistogram();
+
+  void MergeMaxMin(const DivergInfo &other);
+
+  void MergeHistogram(const DivergInfo &other);
+
   void DumpHistogram();
 
   void HandleBinForKL(int quant_bint_nums, int bin_index, std::vector<float> *quantized_histogram,
@@ -174,6 +245,13 @@ struct DivergInfo {
   std::pair<CNodePtr, int32_t> GetZeropoint();
 };
 
+struct CalibrationShard {
+  session::LiteSession *session{nullptr};
+  Model *model{nullptr};
+  DivergInfoMap inputs_diverg_info;
+  DivergInfoMap outputs_diverg_info;
+};
+
 class Calibrator {
  public:
   explicit Calibrator(std::string path, size_t bit_num, int quant_max, int quant_min);
@@ -652,6 +652,19 @@ void ParseThreadNum(PostQuantConfig *post_quant_config, std::string value) {
   post_quant_config->thread_num = std::stoul(value);
 }
 
+void ParseCalibrateShardNum(PostQuantConfig *post_quant_config, std::string value) {
+  MS_ASSERT(post_quant_config != nullptr);
+  post_quant_config->calibrate_shard_num = std::max(std::stoul(value), 1ul);
+}
+
+void ParseSinglePass(PostQuantConfig *post_quant_config, std::string value) {
+  MS_ASSERT(post_quant_config != nullptr);
+  std::transform(value.begin(), value.end(), value.begin(), ::tolower);
+  if (value == "true") {
+    post_quant_config->single_pass = true;
+  }
+}
+
 void ParseMethodX(PostQuantConfig *post_quant_config, const std::string &value) {
   MS_ASSERT(post_quant_config != nullptr);
   if (value != kMethodKL && value != kMethodMaxMin && value != kMethodOutlier) {
@@ -674,6 +687,19 @@ void ParseMeanErrorThreshold(PostQuantConfig *post_quant_config, std::string val
   post_quant_config->mean_error_threshold = std::stof(value);
 }
 
+void ParseMixedPrecisionSearch(PostQuantConfig *post_quant_config, std::string value) {
+  MS_ASSERT(post_quant_config != nullptr);
+  std::transform(value.begin(), value.end(), value.begin(), ::tolower);
+  if (value == "true") {
+    post_quant_config->mixed_precision_search = true;
+  }
+}
+
+void ParseMaxAccuracyLoss(PostQuantConfig *post_quant_config, std::string value) {
+  MS_ASSERT(post_quant_config != nullptr);
+  post_quant_config->max_accuracy_loss = std::stof(value);
+}
+
 void ParseBiasCorrection(PostQuantConfig *post_quant_config, std::string value) {
   MS_ASSERT(post_quant_config != nullptr);
   std::for_each(value.begin(), value.end(), ::tolower);
@@ -714,9 +740,13 @@ STATUS ParseConfigFile(std::string config_file, PostQuantConfig *post_quant_conf
   std::string IMAGE_PATH = "image_path";
   std::string BATCH_COUNT = "batch_count";
   std::string THREAD_NUM = "thread_num";
+  std::string CALIBRATE_SHARD_NUM = "calibrate_shard_num";
+  std::string SINGLE_PASS = "single_pass";
   std::string METHOD_X = "method_x";
   std::string MIXED = "mixed";
   std::string MEAN_ERROR_THRESHOLD = "mean_error_threshold";
+  std::string MIXED_PRECISION_SEARCH = "mixed_precision_search";
+  std::string MAX_ACCURACY_LOSS = "max_accuracy_loss";
   std::string BIAS_CORRECTION = "bias_correction";
 
   std::map<std::string, std::function<void(PostQuantConfig *, std::string)>> value_parser;
@@ -724,9 +754,13 @@ STATUS ParseConfigFile(std::string config_file, PostQuantConfig *post_quant_conf
   value_parser[IMAGE_PATH] = ParseImagePath;
   value_parser[BATCH_COUNT] = ParseBatchCount;
   value_parser[THREAD_NUM] = ParseThreadNum;
+  value_parser[CALIBRATE_SHARD_NUM] = ParseCalibrateShardNum;
+  value_parser[SINGLE_PASS] = ParseSinglePass;
   value_parser[METHOD_X] = ParseMethodX;
   value_parser[MIXED] = ParseMixed;
   value_parser[MEAN_ERROR_THRESHOLD] = ParseMeanErrorThreshold;
+  value_parser[MIXED_PRECISION_SEARCH] = ParseMixedPrecisionSearch;
+  value_parser[MAX_ACCURACY_LOSS] = ParseMaxAccuracyLoss;
   value_parser[BIAS_CORRECTION] = ParseBiasCorrection;
 
   std::string line;
@@ -758,9 +792,13 @@ STATUS ParseConfigFile(std::string config_file, PostQuantConfig *post_quant_conf
   MS_LOG(DEBUG) << "batch_count: " << post_quant_config->batch_count << "\n"
                 << "method_x: " << post_quant_config->method_x << "\n"
                 << "thread_num: " << post_quant_config->thread_num << "\n"
+                << "calibrate_shard_num: " << post_quant_config->calibrate_shard_num << "\n"
+                << "single_pass: " << post_quant_config->single_pass << "\n"
                 << "bias_correction: " << post_quant_config->bias_correction << "\n"
                 << "mixed: " << post_quant_config->mixed << "\n"
-                << "mean_error_threshold: " << post_quant_config->mean_error_threshold;
+                << "mean_error_threshold: " << post_quant_config->mean_error_threshold << "\n"
+                << "mixed_precision_search: " << post_quant_config->mixed_precision_search << "\n"
+                << "max_accuracy_loss: " << post_quant_config->max_accuracy_loss;
   post_quant_config->inited = true;
   fs.close();
   return RET_OK;
@@ -22,11 +22,13 @@
 #include <memory>
 #include <string>
 #include <cmath>
+#include <cfloat>
 #include <array>
 #include <vector>
 #include <algorithm>
 #include <limits>
 #include <utility>
+#include <unordered_map>
 #include "ops/mat_mul.h"
 #include "ops/lstm.h"
 #include "ops/fusion/full_connection.h"
@@ -57,9 +59,17 @@ struct PostQuantConfig {
   uint32_t batch_count{100};
   std::string method_x{kMethodKL};
   uint32_t thread_num{1};
+  // fp32 sessions calibrating disjoint subsets of the images concurrently
+  uint32_t calibrate_shard_num{1};
+  // collect max/min and histograms in one inference pass with streaming histogram rebinning
+  bool single_pass{false};
   bool bias_correction{false};
   bool mixed{false};
   float mean_error_threshold{0.04};
+  // keep the ops in fp32 whose int8 kernels do not pay off, measured on the calibration images
+  bool mixed_precision_search{false};
+  // mean relative error of the model outputs allowed by the mixed precision search
+  float max_accuracy_loss{0.02};
   std::vector<std::vector<std::vector<int>>> input_shapes;  // different input
   bool inited{false};
 };
@@ -420,6 +430,76 @@ SessionModel CreateSessionByFuncGraph(const FuncGraphPtr &func_graph, const conv
 STATUS CollectCalibInputs(const std::vector<std::string> &input_dirs, size_t count_limited,
                           std::vector<std::vector<std::string>> *inputs);
 
+constexpr float relative_tolerance = 1e-5;
+constexpr float abs_tolerance = 1e-4;
+
+// mean relative error of the compared outputs, averaged over the output tensors
+template <typename T>
+float CompareOutputData(const std::unordered_map<std::string, mindspore::tensor::MSTensor *> &expected_tensor,
+                        const std::unordered_map<std::string, mindspore::tensor::MSTensor *> &compare_tensor) {
+  auto valid_data = [](T data) -> bool { return (!std::isnan(data) && !std::isinf(data)); };
+
+  float total_mean_error = 0.0f;
+  int tensor_cnt = expected_tensor.size();
+
+  if (tensor_cnt <= 0) {
+    MS_LOG(ERROR) << "unexpected tensor_cnt: " << tensor_cnt;
+    return RET_ERROR;
+  }
+
+  for (const auto &exp_tensor_pair : expected_tensor) {
+    float mean_error = 0.0f;
+    int error_cnt = 0;
+
+    auto exp_tensor_name = exp_tensor_pair.first;
+    auto exp_tensor = exp_tensor_pair.second;
+    auto cmp_tensor_find_iter = compare_tensor.find(exp_tensor_name);
+    if (cmp_tensor_find_iter == compare_tensor.end()) {
+      MS_LOG(ERROR) << "can not find: " << exp_tensor_name;
+      return RET_ERROR;
+    }
+    auto cmp_tensor = cmp_tensor_find_iter->second;
+
+    auto exp_tensor_shape = exp_tensor->shape();
+    auto cmp_tensor_shape = cmp_tensor->shape();
+    if (exp_tensor_shape != cmp_tensor_shape) {
+      MS_LOG(ERROR) << "exp tensor shape not equal to cmp. exp_tensor_elem_cnt: " << exp_tensor->ElementsNum()
+                    << " cmp_tensor_elem_cnt: " << cmp_tensor->ElementsNum();
+      return RET_ERROR;
+    }
+    auto exp_data = static_cast<T *>(exp_tensor->MutableData());
+    auto cmp_data = static_cast<T *>(cmp_tensor->MutableData());
+    auto elem_cnt = exp_tensor->ElementsNum();
+    for (int i = 0; i < elem_cnt; i++) {
+      if (!valid_data(exp_data[i]) || !valid_data(cmp_data[i])) {
+        MS_LOG(ERROR) << "data is not valid. exp: " << exp_data[i] << " cmp: " << cmp_data[i] << " index: " << i;
+        return RET_ERROR;
+      }
+      auto tolerance = abs_tolerance + relative_tolerance * fabs(exp_data[i]);
+      auto abs_error = std::fabs(exp_data[i] - cmp_data[i]);
+      if (abs_error > tolerance) {
+        if (fabs(exp_data[i] == 0)) {
+          if (abs_error > 1e-5) {
+            mean_error += abs_error;
+            error_cnt++;
+          } else {
+            // it is ok, very close to 0
+            continue;
+          }
+        } else {
+          mean_error += abs_error / (fabs(exp_data[i]) + FLT_MIN);
+          error_cnt++;
+        }
+      } else {
+        // it is ok, no error
+        continue;
+      }
+    }  // end one tensor data loop
+    total_mean_error += mean_error / elem_cnt;
+  }  // end tensor loop
+  return total_mean_error / tensor_cnt;
+}
+
 STATUS CopyInputDataToTensor(size_t input_index, size_t image_index,
                              const std::vector<std::vector<std::string>> &images, mindspore::tensor::MSTensor *tensor);
 
@@ -52,11 +52,6 @@ int Cropper::ReadPackage() {
 
 int Cropper::RunCropper() {
   int status;
-  status = ReadPackage();
-  if (status != RET_OK) {
-    MS_LOG(ERROR) << "read package failed.";
-    return status;
-  }
   status = GetModelFiles();
   if (status != RET_OK) {
     MS_LOG(ERROR) << "get model files failed.";
@@ -67,6 +62,14 @@ int Cropper::RunCropper() {
     MS_LOG(ERROR) << "get model ops failed.";
     return status;
   }
+  if (!this->flags_->ops_file_.empty()) {
+    return WriteOpsFile();
+  }
+  status = ReadPackage();
+  if (status != RET_OK) {
+    MS_LOG(ERROR) << "read package failed.";
+    return status;
+  }
   status = GetOpMatchFiles();
   if (status != RET_OK) {
     MS_LOG(ERROR) << "get op match files failed.";
@@ -124,6 +127,20 @@ int Cropper::GetModelOps() {
   return RET_OK;
 }
 
+int Cropper::WriteOpsFile() {
+  std::ofstream out_file(this->flags_->ops_file_);
+  if (!out_file.is_open()) {
+    MS_LOG(ERROR) << "open ops file failed: " << this->flags_->ops_file_;
+    return RET_ERROR;
+  }
+  for (auto op : this->all_operators_) {
+    out_file << schema::EnumNamePrimitiveType(op) << std::endl;
+  }
+  out_file.close();
+  MS_LOG(INFO) << "write " << this->all_operators_.size() << " operators to " << this->flags_->ops_file_;
+  return RET_OK;
+}
+
 int Cropper::GetModelFiles() {
   if (!this->flags_->model_file_.empty()) {
     auto files = StringSplit(this->flags_->model_file_, std::string(DELIM_COMMA));
@@ -48,6 +48,8 @@ class Cropper {
 
   int CutPackage();
 
+  int WriteOpsFile();
+
   std::vector<std::string> model_files_;
   std::vector<std::string> all_files_;
   std::set<std::string> archive_files_;
@@ -28,6 +28,9 @@ CropperFlags::CropperFlags() {
   AddFlag(&CropperFlags::model_folder_path_, "modelFolderPath", "Load all ms models in the folder", "");
   AddFlag(&CropperFlags::config_file_, "configFile", "The mapping configuration file path", "");
   AddFlag(&CropperFlags::output_file_, "outputFile", "Output library file path", "");
+  AddFlag(&CropperFlags::ops_file_, "opsFile",
+          "Write the operators of the models to this file for the MSLITE_SELECTED_OPS_FILE build instead of cropping",
+          "");
 }
 
 int CropperFlags::Init(int argc, const char **argv) {
@@ -53,6 +56,25 @@ int CropperFlags::Init(int argc, const char **argv) {
   MS_LOG(INFO) << "modelFolderPath = " << this->model_folder_path_;
   MS_LOG(INFO) << "configFile = " << this->config_file_;
   MS_LOG(INFO) << "outputFile = " << this->output_file_;
+  MS_LOG(INFO) << "opsFile = " << this->ops_file_;
+
+  if (this->model_file_.empty() && this->model_folder_path_.empty()) {
+    std::cerr << "INPUT MISSING: modelFile or modelFolderPath is necessary" << std::endl;
+    return RET_INPUT_PARAM_INVALID;
+  } else if (!this->model_file_.empty() && !this->model_folder_path_.empty()) {
+    std::cerr << "INPUT ILLEGAL: modelFile and modelFolderPath must choose one" << std::endl;
+    return RET_INPUT_PARAM_INVALID;
+  } else if (!this->model_folder_path_.empty()) {
+    this->model_folder_path_ = RealPath(this->model_folder_path_.c_str());
+    if (this->model_folder_path_.empty()) {
+      return RET_INPUT_PARAM_INVALID;
+    }
+  }
+
+  // only the operator list is written, nothing is cropped
+  if (!this->ops_file_.empty()) {
+    return RET_OK;
+  }
 
   if (this->package_file_.empty()) {
     std::cerr << "INPUT MISSING: packageFile is necessary" << std::endl;
@@ -68,19 +90,6 @@ int CropperFlags::Init(int argc, const char **argv) {
     }
   }
 
-  if (this->model_file_.empty() && this->model_folder_path_.empty()) {
-    std::cerr << "INPUT MISSING: modelFile or modelFolderPath is necessary" << std::endl;
-    return RET_INPUT_PARAM_INVALID;
-  } else if (!this->model_file_.empty() && !this->model_folder_path_.empty()) {
-    std::cerr << "INPUT ILLEGAL: modelFile and modelFolderPath must choose one" << std::endl;
-    return RET_INPUT_PARAM_INVALID;
-  } else if (!this->model_folder_path_.empty()) {
-    this->model_folder_path_ = RealPath(this->model_folder_path_.c_str());
-    if (this->model_folder_path_.empty()) {
-      return RET_INPUT_PARAM_INVALID;
-    }
-  }
-
   if (this->config_file_.empty()) {
     std::cerr << "INPUT MISSING: configFile is necessary" << std::endl;
     return RET_INPUT_PARAM_INVALID;
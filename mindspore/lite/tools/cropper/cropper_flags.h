@@ -36,6 +36,7 @@ class CropperFlags : public virtual mindspore::lite::FlagParser {
   std::string model_folder_path_;
   std::string config_file_;
   std::string output_file_;
+  std::string ops_file_;
 };
 }  // namespace cropper
 }  // namespace lite
@@ -19,15 +19,20 @@
 #include <vector>
 #include <string>
 #include <unordered_map>
+#include "ops/abs.h"
 #include "ops/adam.h"
 #include "ops/addn.h"
 #include "ops/apply_momentum.h"
 #include "ops/batch_norm.h"
 #include "ops/batch_to_space.h"
 #include "ops/bias_add.h"
+#include "ops/ceil.h"
 #include "ops/concat.h"
+#include "ops/cos.h"
 #include "ops/crop.h"
 #include "ops/depth_to_space.h"
+#include "ops/erf.h"
+#include "ops/floor.h"
 #include "ops/fused_batch_norm.h"
 #include "ops/fusion/activation.h"
 #include "ops/fusion/add_fusion.h"
@@ -37,11 +42,13 @@
 #include "ops/fusion/conv2d_fusion.h"
 #include "ops/fusion/conv2d_transpose_fusion.h"
 #include "ops/fusion/div_fusion.h"
+#include "ops/fusion/exp_fusion.h"
 #include "ops/fusion/max_pool_fusion.h"
 #include "ops/fusion/mul_fusion.h"
 #include "ops/fusion/pow_fusion.h"
 #include "ops/fusion/prelu_fusion.h"
 #include "ops/fusion/slice_fusion.h"
+#include "ops/fusion/sub_fusion.h"
 #include "ops/fusion/topk_fusion.h"
 #include "ops/eltwise.h"
 #include "ops/grad/activation_grad.h"
@@ -51,16 +58,26 @@
 #include "ops/grad/max_pool_grad.h"
 #include "ops/grad/resize_grad.h"
 #include "ops/instance_norm.h"
+#include "ops/log.h"
 #include "ops/lrn.h"
 #include "ops/maximum.h"
+#include "ops/minimum.h"
+#include "ops/neg.h"
 #include "ops/op_utils.h"
 #include "ops/quant_dtype_cast.h"
+#include "ops/reciprocal.h"
 #include "ops/resize.h"
+#include "ops/round.h"
+#include "ops/rsqrt.h"
 #include "ops/sgd.h"
+#include "ops/sin.h"
 #include "ops/space_to_batch.h"
 #include "ops/space_to_batch_nd.h"
 #include "ops/space_to_depth.h"
 #include "ops/split.h"
+#include "ops/sqrt.h"
+#include "ops/square.h"
+#include "ops/squared_difference.h"
 #include "ops/strided_slice.h"
 #include "tools/anf_exporter/fetch_content.h"
 
@@ -100,7 +117,11 @@ static const std::unordered_map<std::string, std::vector<size_t>> NCHWOpMap = {{
 static const std::vector<std::string> DynamicFormatOpList = {
   ops::kNameEltwise,      ops::kNameActivation, ops::kNameConcat,  ops::kNameDivFusion,      ops::kNamePowFusion,
   ops::kNameStridedSlice, ops::kNameAddFusion,  ops::kNameAddN,    ops::kNameSplit,          ops::kNameSliceFusion,
-  ops::kNameCrop,         ops::kNameMulFusion,  ops::kNameMaximum, ops::kNameActivationGrad, ops::kNameQuantDTypeCast};
+  ops::kNameCrop,         ops::kNameMulFusion,  ops::kNameMaximum, ops::kNameActivationGrad, ops::kNameQuantDTypeCast,
+  ops::kNameSubFusion,    ops::kNameMinimum,    ops::kNameAbs,     ops::kNameExpFusion,      ops::kNameNeg,
+  ops::kNameSqrt,         ops::kNameRsqrt,      ops::kNameSquare,  ops::kNameSin,            ops::kNameCos,
+  ops::kNameLog,          ops::kNameFloor,      ops::kNameCeil,    ops::kNameRound,          ops::kNameReciprocal,
+  ops::kNameErf,          ops::kNameSquaredDifference};
 
 static const std::unordered_map<int, int> NC2NHAxisMap = {{0, 0}, {1, 3}, {2, 1}, {3, 2}};
 
@@ -156,6 +177,33 @@ STATUS GetTransposePerm(const CNodePtr &cnode, std::vector<int> *perm) {
   return lite::RET_OK;
 }
 
+bool IsIdentityPerm(const std::vector<int> &perm) {
+  if (perm.empty()) {
+    return false;
+  }
+  for (size_t i = 0; i < perm.size(); ++i) {
+    if (perm[i] != static_cast<int>(i)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+std::vector<int> ComposePerm(const std::vector<int> &pre_perm, const std::vector<int> &post_perm) {
+  if (pre_perm.empty() || pre_perm.size() != post_perm.size()) {
+    return {};
+  }
+  std::vector<int> perm(post_perm.size());
+  for (size_t i = 0; i < post_perm.size(); ++i) {
+    auto axis = post_perm[i] < 0 ? post_perm[i] + static_cast<int>(pre_perm.size()) : post_perm[i];
+    if (axis < 0 || axis >= static_cast<int>(pre_perm.size())) {
+      return {};
+    }
+    perm[i] = pre_perm[axis];
+  }
+  return perm;
+}
+
 void RemoveIfMonad(const CNodePtr &cnode) {
   MS_ASSERT(cnode != nullptr);
   std::vector<AnfNodePtr> inputs{cnode->input(0)};
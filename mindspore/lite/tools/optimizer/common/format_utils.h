@@ -39,6 +39,10 @@ const std::unordered_map<int, int> &GetNC2NHAxisMap();
 const std::vector<std::string> &GetDynamicFormatOpList();
 Format GetFormat(const CNodePtr &cnode);
 STATUS GetTransposePerm(const CNodePtr &cnode, std::vector<int> *perm);
+// an empty perm is regarded as unknown, not as identity.
+bool IsIdentityPerm(const std::vector<int> &perm);
+// perm of transpose(transpose(x, pre_perm), post_perm), empty if the two perms cannot be composed.
+std::vector<int> ComposePerm(const std::vector<int> &pre_perm, const std::vector<int> &post_perm);
 void RemoveIfMonad(const CNodePtr &cnode);
 bool IsMonadNode(const AnfNodePtr &node);
 }  // namespace opt
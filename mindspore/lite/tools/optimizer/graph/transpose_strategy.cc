@@ -70,7 +70,7 @@ AnfNodePtr TransposeStrategy::TransposePairFuseWhenInsert(const FuncGraphPtr &fu
       MS_LOG(ERROR) << "transpose perm get failed.";
       return nullptr;
     }
-    if ((perm == NH2NC && trans_perm == NC2NH) || (perm == NC2NH && trans_perm == NH2NC)) {
+    if (IsIdentityPerm(ComposePerm(trans_perm, perm))) {
       return input_cnode->input(kFirstInput);
     }
   }
@@ -15,6 +15,7 @@
  */
 
 #include "tools/optimizer/graph/unify_format_pass.h"
+#include <algorithm>
 #include <queue>
 #include <set>
 #include <unordered_map>
@@ -29,6 +30,7 @@ namespace mindspore {
 namespace opt {
 namespace {
 constexpr size_t kNCHWDimNumber = 4;
+constexpr size_t kSubGraphNum = 2;
 const std::vector<int> NH2NC = {0, 3, 1, 2};
 const std::vector<int> NC2NH = {0, 2, 3, 1};
 bool IsSpecialType(const CNodePtr &cnode) {
@@ -40,107 +42,6 @@ bool IsSpecialType(const CNodePtr &cnode) {
   return false;
 }
 
-STATUS FindAreaSurroundedByTranspose(const FuncGraphPtr &func_graph, const CNodePtr &root_node,
-                                     std::set<CNodePtr> *in_nodes, std::set<CNodePtr> *out_nodes,
-                                     std::set<CNodePtr> *middle_nodes) {
-  MS_ASSERT(func_graph != nullptr && root_node != nullptr);
-  MS_ASSERT(in_nodes != nullptr && out_nodes != nullptr && middle_nodes != nullptr);
-  std::queue<CNodePtr> queue_nodes;
-  queue_nodes.push(root_node);
-  std::queue<bool> is_pre_nodes;
-  is_pre_nodes.push(true);
-  while (!queue_nodes.empty()) {
-    auto cur_node = queue_nodes.front();
-    auto is_pre_node = is_pre_nodes.front();
-    queue_nodes.pop();
-    is_pre_nodes.pop();
-    if (CheckPrimitiveType(cur_node, prim::kPrimTranspose)) {
-      if (is_pre_node) {
-        in_nodes->insert(cur_node);
-      } else {
-        out_nodes->insert(cur_node);
-        continue;
-      }
-    }
-    if (middle_nodes->find(cur_node) != middle_nodes->end()) {
-      continue;
-    }
-    if (in_nodes->find(cur_node) == in_nodes->end()) {
-      middle_nodes->insert(cur_node);
-      // insert pre nodes.
-      auto origin_inputs = cur_node->inputs();
-      lite::RemoveIfDepend(cur_node);
-      for (size_t i = 1; i < cur_node->size(); ++i) {
-        if (!utils::isa<CNodePtr>(cur_node->input(i))) {
-          continue;
-        }
-        auto cur_node_input = cur_node->input(i)->cast<CNodePtr>();
-        if (middle_nodes->find(cur_node_input) != middle_nodes->end() ||
-            in_nodes->find(cur_node_input) != in_nodes->end()) {
-          continue;
-        }
-        queue_nodes.push(cur_node_input);
-        is_pre_nodes.push(true);
-      }
-      if (CheckIsAllInputsParam(cur_node)) {
-        in_nodes->insert(cur_node);
-      }
-      cur_node->set_inputs(origin_inputs);
-    }
-    // insert post nodes
-    auto cur_node_users = func_graph->manager()->node_users()[cur_node];
-    for (auto &cur_node_user : cur_node_users) {
-      if (!utils::isa<CNodePtr>(cur_node_user.first)) {
-        MS_LOG(ERROR) << "post node is not cnode.";
-        return lite::RET_ERROR;
-      }
-      auto cur_node_post = cur_node_user.first->cast<CNodePtr>();
-      if (middle_nodes->find(cur_node_post) != middle_nodes->end() ||
-          out_nodes->find(cur_node_post) != out_nodes->end()) {
-        continue;
-      }
-      queue_nodes.push(cur_node_post);
-      is_pre_nodes.push(false);
-    }
-    if (cur_node_users.empty()) {
-      out_nodes->insert(cur_node);
-    }
-  }
-  return lite::RET_OK;
-}
-
-bool JudgeCanOptimizerForMultiOp(const FuncGraphPtr &func_graph, const std::set<CNodePtr> &in_nodes,
-                                 const std::set<CNodePtr> &out_nodes, const std::set<CNodePtr> &middle_nodes) {
-  MS_ASSERT(func_graph != nullptr);
-  for (auto &in_cnode : in_nodes) {
-    std::vector<int> perm;
-    if (!CheckPrimitiveType(in_cnode, prim::kPrimTranspose) || GetTransposePerm(in_cnode, &perm) != lite::RET_OK ||
-        perm != NH2NC) {
-      return false;
-    }
-  }
-  for (auto &out_cnode : out_nodes) {
-    std::vector<int> perm;
-    if (!CheckPrimitiveType(out_cnode, prim::kPrimTranspose) || GetTransposePerm(out_cnode, &perm) != lite::RET_OK ||
-        perm != NC2NH) {
-      return false;
-    }
-  }
-  auto &dynamic_ops = GetDynamicFormatOpList();
-  TransposeStrategy transpose_strategy;
-  for (auto &middle_cnode : middle_nodes) {
-    if (IsSpecialType(middle_cnode)) {
-      continue;
-    }
-    auto middle_node_prim = GetValueNode<PrimitivePtr>(middle_cnode->input(0));
-    if (!lite::IsContain(dynamic_ops, middle_node_prim->name()) ||
-        !transpose_strategy.CanChangeOpAxis(func_graph, middle_cnode)) {
-      return false;
-    }
-  }
-  return true;
-}
-
 void ConvertNcTensor2Nh(const FuncGraphPtr &func_graph, const CNodePtr &cnode, size_t index, FmkType fmk_type,
                         bool train_flag) {
   MS_ASSERT(cnode != nullptr);
@@ -168,6 +69,10 @@ void ConvertNcTensor2Nh(const FuncGraphPtr &func_graph, const CNodePtr &cnode, s
     new_shape = {1, 1, data_info.shape_[0], data_info.shape_[1]};
   } else if (data_info.shape_.size() == 3) {
     new_shape = {1, data_info.shape_[0], data_info.shape_[1], data_info.shape_[2]};
+  } else if (data_info.shape_.size() == kNCHWDimNumber) {
+    new_shape = data_info.shape_;
+  } else {
+    return;
   }
   auto size = data_info.data_.size() / sizeof(float);
   std::vector<float> new_data(size);
@@ -181,8 +86,8 @@ void ConvertNcTensor2Nh(const FuncGraphPtr &func_graph, const CNodePtr &cnode, s
     float *src_batch = nchw_data + i * channel * area;
     float *dst_batch = new_data_ptr + i * channel * area;
     for (int j = 0; j < area; ++j) {
-      float *src_area = src_batch + i;
-      float *dst_area = dst_batch + i * channel;
+      float *src_area = src_batch + j;
+      float *dst_area = dst_batch + j * channel;
       for (int k = 0; k < channel; ++k) {
         dst_area[k] = src_area[k * area];
       }
@@ -206,6 +111,28 @@ void ConvertNcTensor2Nh(const FuncGraphPtr &func_graph, const CNodePtr &cnode, s
   tr.Commit();
   return;
 }
+
+size_t CountTransposeNodes(const FuncGraphPtr &func_graph) {
+  MS_ASSERT(func_graph != nullptr);
+  size_t count = 0;
+  auto node_list = TopoSort(func_graph->get_return());
+  for (auto &node : node_list) {
+    if (CheckPrimitiveType(node, prim::kPrimTranspose)) {
+      ++count;
+      continue;
+    }
+    if (CheckPrimitiveType(node, prim::kPrimIf) || CheckPrimitiveType(node, prim::kPrimWhile)) {
+      auto cnode = node->cast<CNodePtr>();
+      for (size_t i = 1; i <= kSubGraphNum && i < cnode->size(); ++i) {
+        auto sub_func_graph = GetValueNode<FuncGraphPtr>(cnode->input(i));
+        if (sub_func_graph != nullptr) {
+          count += CountTransposeNodes(sub_func_graph);
+        }
+      }
+    }
+  }
+  return count;
+}
 }  // namespace
 
 void UnifyFormatPass::GetTransNodeFormatType(const CNodePtr &cnode, TransTypePair *trans_info) {
@@ -262,7 +189,7 @@ bool UnifyFormatPass::TransTransFusion(const FuncGraphPtr &func_graph, const CNo
     MS_LOG(ERROR) << "get tanspose perm failed.";
     return false;
   }
-  if ((pre_perm == NH2NC && post_perm == NC2NH) || (pre_perm == NC2NH && post_perm == NH2NC)) {
+  if (IsIdentityPerm(ComposePerm(pre_perm, post_perm))) {
     func_graph->manager()->Replace(cnode, pre_cnode->input(1));
     return true;
   }
@@ -289,7 +216,7 @@ STATUS UnifyFormatPass::PostTransposeFusion(const FuncGraphPtr &func_graph, cons
         MS_LOG(ERROR) << "get post transpose node perm failed.";
         return lite::RET_ERROR;
       }
-      if ((cur_perm == NH2NC && post_trans_perm == NC2NH) || (cur_perm == NC2NH && post_trans_perm == NH2NC)) {
+      if (IsIdentityPerm(ComposePerm(cur_perm, post_trans_perm))) {
         func_graph->manager()->Replace(post_node, cnode->input(1));
       }
     }
@@ -564,46 +491,152 @@ STATUS UnifyFormatPass::HandleGraphNode(const FuncGraphPtr &func_graph, const CN
   return lite::RET_OK;
 }
 
+bool UnifyFormatPass::IsLayoutAgnostic(const FuncGraphPtr &func_graph, const CNodePtr &cnode) {
+  MS_ASSERT(func_graph != nullptr && cnode != nullptr);
+  // outputs of a multi-output op follow its layout
+  if (CheckPrimitiveType(cnode, prim::kPrimTupleGetItem)) {
+    return true;
+  }
+  if (IsSpecialType(cnode)) {
+    return false;
+  }
+  auto prim = GetValueNode<PrimitivePtr>(cnode->input(0));
+  return prim != nullptr && lite::IsContain(GetDynamicFormatOpList(), prim->name()) &&
+         transpose_strategy_.CanChangeOpAxis(func_graph, cnode);
+}
+
+STATUS UnifyFormatPass::FindLayoutArea(const FuncGraphPtr &func_graph, const CNodePtr &root_node, LayoutArea *area) {
+  MS_ASSERT(func_graph != nullptr && root_node != nullptr && area != nullptr);
+  auto manager = func_graph->manager();
+  MS_ASSERT(manager != nullptr);
+  // nodes of the area whose inputs and users are not visited yet
+  std::queue<CNodePtr> queue_nodes;
+  area->in_transposes.insert(root_node);
+  queue_nodes.push(root_node);
+  while (!queue_nodes.empty()) {
+    auto cur_node = queue_nodes.front();
+    queue_nodes.pop();
+    // the input of a transpose entering the area stays outside
+    for (size_t i = 1; area->in_transposes.find(cur_node) == area->in_transposes.end() && i < cur_node->size(); ++i) {
+      auto input = cur_node->input(i);
+      if (IsMonadNode(input)) {
+        continue;
+      }
+      if (!utils::isa<CNodePtr>(input)) {
+        // constants are converted together with the area, graph inputs keep their layout
+        if (utils::isa<ParameterPtr>(input) && !input->cast<ParameterPtr>()->has_default()) {
+          area->in_edges.insert(std::make_pair(cur_node, i));
+        }
+        continue;
+      }
+      auto input_cnode = input->cast<CNodePtr>();
+      if (area->middle_nodes.find(input_cnode) != area->middle_nodes.end() ||
+          area->in_transposes.find(input_cnode) != area->in_transposes.end()) {
+        continue;
+      }
+      std::vector<int> perm;
+      if (CheckPrimitiveType(input_cnode, prim::kPrimTranspose) &&
+          GetTransposePerm(input_cnode, &perm) == lite::RET_OK && perm == NH2NC) {
+        area->in_transposes.insert(input_cnode);
+      } else if (IsLayoutAgnostic(func_graph, input_cnode)) {
+        area->middle_nodes.insert(input_cnode);
+      } else {
+        area->in_edges.insert(std::make_pair(cur_node, i));
+        continue;
+      }
+      queue_nodes.push(input_cnode);
+    }
+    auto node_users = manager->node_users()[cur_node];
+    for (auto &node_user : node_users) {
+      if (!utils::isa<CNodePtr>(node_user.first)) {
+        MS_LOG(ERROR) << "post node is not cnode.";
+        return lite::RET_ERROR;
+      }
+      auto post_cnode = node_user.first->cast<CNodePtr>();
+      if (area->middle_nodes.find(post_cnode) != area->middle_nodes.end() ||
+          area->out_transposes.find(post_cnode) != area->out_transposes.end()) {
+        continue;
+      }
+      std::vector<int> perm;
+      if (CheckPrimitiveType(post_cnode, prim::kPrimTranspose) && GetTransposePerm(post_cnode, &perm) == lite::RET_OK &&
+          perm == NC2NH) {
+        area->out_transposes.insert(post_cnode);
+      } else if (IsLayoutAgnostic(func_graph, post_cnode)) {
+        area->middle_nodes.insert(post_cnode);
+        queue_nodes.push(post_cnode);
+      } else {
+        area->out_edges.insert(std::make_pair(post_cnode, static_cast<size_t>(node_user.second)));
+      }
+    }
+  }
+  return lite::RET_OK;
+}
+
+bool UnifyFormatPass::IsFlipProfitable(const LayoutArea &area) {
+  // a transpose can only be put on an edge carrying a 4D tensor
+  auto is_4d_edge = [this](const std::pair<CNodePtr, size_t> &edge) {
+    return node_infer_shape_.GetInputShape(edge.first, edge.second).size() == kNCHWDimNumber;
+  };
+  if (!std::all_of(area.in_edges.begin(), area.in_edges.end(), is_4d_edge) ||
+      !std::all_of(area.out_edges.begin(), area.out_edges.end(), is_4d_edge)) {
+    return false;
+  }
+  auto removed = area.in_transposes.size() + area.out_transposes.size();
+  auto inserted = area.in_edges.size() + area.out_edges.size();
+  MS_LOG(DEBUG) << "flipping an area of " << area.middle_nodes.size() << " ops to NHWC removes " << removed
+                << " transposes and inserts " << inserted;
+  return inserted < removed;
+}
+
 STATUS UnifyFormatPass::HandleGraphMultiNode(const FuncGraphPtr &func_graph, const CNodePtr &cnode,
                                              std::set<CNodePtr> *visit_transposes) {
   MS_ASSERT(func_graph != nullptr && cnode != nullptr && visit_transposes != nullptr);
   auto manager = func_graph->manager();
   MS_ASSERT(manager != nullptr);
-  std::set<CNodePtr> middle_nodes;
-  std::set<CNodePtr> in_nodes;
-  std::set<CNodePtr> out_nodes;
-  auto status = FindAreaSurroundedByTranspose(func_graph, cnode, &in_nodes, &out_nodes, &middle_nodes);
+  LayoutArea area;
+  auto status = FindLayoutArea(func_graph, cnode, &area);
   if (status != lite::RET_OK) {
-    MS_LOG(ERROR) << "find an area surrounded by transpose failed.";
+    MS_LOG(ERROR) << "find an area of layout agnostic ops failed.";
     return status;
   }
-  for (auto &in_cnode : in_nodes) {
-    if (CheckPrimitiveType(in_cnode, prim::kPrimTranspose)) {
-      visit_transposes->insert(in_cnode);
-    }
-  }
-  if (!JudgeCanOptimizerForMultiOp(func_graph, in_nodes, out_nodes, middle_nodes)) {
+  visit_transposes->insert(area.in_transposes.begin(), area.in_transposes.end());
+  if (!IsFlipProfitable(area)) {
     return lite::RET_NO_CHANGE;
   }
-  auto node_list = TopoSort(func_graph->get_return());
-  std::vector<CNodePtr> middle_ops_vec;
-  for (auto &node : node_list) {
-    if (!utils::isa<CNodePtr>(node)) {
-      continue;
+  std::vector<CNodePtr> inserted_transposes;
+  for (auto &in_edge : area.in_edges) {
+    auto trans_name = in_edge.first->fullname_with_scope() + "_pre" + std::to_string(in_edge.second - 1);
+    auto trans_cnode = GenTransposeNode(func_graph, in_edge.first->input(in_edge.second), NC2NH, trans_name);
+    if (trans_cnode == nullptr) {
+      MS_LOG(ERROR) << "generate a transpose node failed.";
+      return lite::RET_ERROR;
     }
-    if (middle_nodes.find(node->cast<CNodePtr>()) != middle_nodes.end()) {
-      middle_ops_vec.push_back(node->cast<CNodePtr>());
-      middle_nodes.erase(node->cast<CNodePtr>());
+    manager->SetEdge(in_edge.first, in_edge.second, trans_cnode);
+    inserted_transposes.push_back(trans_cnode);
+  }
+  for (auto &out_edge : area.out_edges) {
+    auto trans_name = out_edge.first->fullname_with_scope() + "_pre" + std::to_string(out_edge.second - 1);
+    auto trans_cnode = GenTransposeNode(func_graph, out_edge.first->input(out_edge.second), NH2NC, trans_name);
+    if (trans_cnode == nullptr) {
+      MS_LOG(ERROR) << "generate a transpose node failed.";
+      return lite::RET_ERROR;
     }
+    manager->SetEdge(out_edge.first, out_edge.second, trans_cnode);
+    inserted_transposes.push_back(trans_cnode);
   }
-  for (auto &in_cnode : in_nodes) {
+  for (auto &in_cnode : area.in_transposes) {
     manager->Replace(in_cnode, in_cnode->input(1));
   }
-  for (auto &out_cnode : out_nodes) {
+  for (auto &out_cnode : area.out_transposes) {
     manager->Replace(out_cnode, out_cnode->input(1));
   }
-  for (auto &middle_cnode : middle_ops_vec) {
-    if (IsSpecialType(middle_cnode)) {
+  auto node_list = TopoSort(func_graph->get_return());
+  for (auto &node : node_list) {
+    if (!utils::isa<CNodePtr>(node)) {
+      continue;
+    }
+    auto middle_cnode = node->cast<CNodePtr>();
+    if (area.middle_nodes.find(middle_cnode) == area.middle_nodes.end() || IsSpecialType(middle_cnode)) {
       continue;
     }
     for (size_t i = 1; i < middle_cnode->size(); ++i) {
@@ -620,6 +653,13 @@ STATUS UnifyFormatPass::HandleGraphMultiNode(const FuncGraphPtr &func_graph, con
       return lite::RET_ERROR;
     }
   }
+  for (auto &trans_cnode : inserted_transposes) {
+    status = node_infer_shape_.InferShape(trans_cnode);
+    if (status != lite::RET_OK && status != lite::RET_INFER_INVALID) {
+      MS_LOG(ERROR) << "infer shape failed.";
+      return lite::RET_ERROR;
+    }
+  }
   return lite::RET_OK;
 }
 
@@ -913,6 +953,71 @@ bool UnifyFormatPass::DecreaseTransposeForMultiOp(const FuncGraphPtr &func_graph
   return true;
 }
 
+bool UnifyFormatPass::EliminateRedundantTranspose(const FuncGraphPtr &func_graph) {
+  MS_ASSERT(func_graph != nullptr);
+  auto manager = Manage(func_graph, true);
+  if (manager == nullptr) {
+    MS_LOG(ERROR) << "manager is nullptr.";
+    return false;
+  }
+  auto node_list = TopoSort(func_graph->get_return());
+  for (auto &node : node_list) {
+    if (!utils::isa<CNodePtr>(node)) {
+      continue;
+    }
+    auto cnode = node->cast<CNodePtr>();
+    if (CheckPrimitiveType(node, prim::kPrimIf) || CheckPrimitiveType(node, prim::kPrimWhile)) {
+      for (size_t i = 1; i <= kSubGraphNum && i < cnode->size(); ++i) {
+        auto sub_func_graph = GetValueNode<FuncGraphPtr>(cnode->input(i));
+        if (sub_func_graph == nullptr) {
+          return false;
+        }
+        (void)EliminateRedundantTranspose(sub_func_graph);
+      }
+      continue;
+    }
+    if (!CheckPrimitiveType(cnode, prim::kPrimTranspose) || manager->node_users()[cnode].empty()) {
+      continue;
+    }
+    std::vector<int> perm;
+    if (GetTransposePerm(cnode, &perm) != lite::RET_OK || perm.empty()) {
+      continue;
+    }
+    if (IsIdentityPerm(perm)) {
+      manager->Replace(cnode, cnode->input(1));
+      continue;
+    }
+    if (!CheckPrimitiveType(cnode->input(1), prim::kPrimTranspose)) {
+      continue;
+    }
+    auto pre_cnode = cnode->input(1)->cast<CNodePtr>();
+    std::vector<int> pre_perm;
+    if (pre_cnode == nullptr || GetTransposePerm(pre_cnode, &pre_perm) != lite::RET_OK) {
+      continue;
+    }
+    auto fused_perm = ComposePerm(pre_perm, perm);
+    if (fused_perm.empty()) {
+      continue;
+    }
+    if (IsIdentityPerm(fused_perm)) {
+      manager->Replace(cnode, pre_cnode->input(1));
+      continue;
+    }
+    // folding is only profitable when the previous transpose is dead afterwards.
+    if (manager->node_users()[pre_cnode].size() != 1) {
+      continue;
+    }
+    auto fused_cnode = GenTransposeNode(func_graph, pre_cnode->input(1), fused_perm, cnode->fullname_with_scope());
+    if (fused_cnode == nullptr) {
+      MS_LOG(ERROR) << "generate a fused transpose node failed.";
+      return false;
+    }
+    fused_cnode->set_abstract(cnode->abstract());
+    manager->Replace(cnode, fused_cnode);
+  }
+  return true;
+}
+
 bool UnifyFormatPass::ResetFuncGraph(const FuncGraphPtr &func_graph) {
   MS_ASSERT(func_graph != nullptr);
   auto manager = Manage(func_graph, true);
@@ -1052,6 +1157,7 @@ bool UnifyFormatPass::Run(const FuncGraphPtr &func_graph) {
     MS_LOG(ERROR) << "exist op cannot support infer shape.";
     return false;
   }
+  auto origin_trans_count = CountTransposeNodes(func_graph);
   // insert transpose for some ops whose format must be NHWC, which is depend on framework.
   // In this process, tranpose can be fused, which the original graph may not be able to restored.
   if (!BasicProcess(func_graph, true)) {
@@ -1071,6 +1177,13 @@ bool UnifyFormatPass::Run(const FuncGraphPtr &func_graph) {
     MS_LOG(ERROR) << "run global trans insert optimizer failed.";
     return false;
   }
+  // the optimizers above may leave transposes back to back, which are cancelled or folded into one.
+  if (!EliminateRedundantTranspose(func_graph)) {
+    MS_LOG(ERROR) << "eliminate redundant transpose failed.";
+    return false;
+  }
+  MS_LOG(INFO) << "transpose count: " << origin_trans_count << " in the origin graph, "
+               << CountTransposeNodes(func_graph) << " after format unified.";
   return true;
 }
 }  // namespace opt
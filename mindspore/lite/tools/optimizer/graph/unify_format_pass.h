@@ -22,6 +22,7 @@
 #include <set>
 #include <string>
 #include <unordered_map>
+#include <utility>
 #include "backend/optimizer/common/optimizer.h"
 #include "utils/utils.h"
 #include "tools/converter/converter_flags.h"
@@ -31,6 +32,16 @@
 using mindspore::lite::converter::FmkType;
 namespace mindspore {
 namespace opt {
+// layout agnostic ops running in NCHW between transposes. running them in NHWC instead removes the transposes around
+// them and needs a new transpose on every other edge crossing the border, the edges are {user, input index}
+struct LayoutArea {
+  std::set<CNodePtr> in_transposes;
+  std::set<CNodePtr> out_transposes;
+  std::set<std::pair<CNodePtr, size_t>> in_edges;
+  std::set<std::pair<CNodePtr, size_t>> out_edges;
+  std::set<CNodePtr> middle_nodes;
+};
+
 class UnifyFormatPass : public Pass {
  public:
   UnifyFormatPass() : Pass("unify_format_pass") {}
@@ -43,8 +54,15 @@ class UnifyFormatPass : public Pass {
   }
   bool Run(const FuncGraphPtr &func_graph) override;
   bool RunOnlyForShape(const FuncGraphPtr &func_graph);
+  // drop identity transposes, cancel back to back transposes composing to identity and fold the other pairs
+  bool EliminateRedundantTranspose(const FuncGraphPtr &func_graph);
+  // grow the area from a NHWC to NCHW transpose through layout agnostic ops
+  STATUS FindLayoutArea(const FuncGraphPtr &func_graph, const CNodePtr &root_node, LayoutArea *area);
+  // the area is flipped to NHWC only if that needs fewer transposes than keeping it in NCHW
+  bool IsFlipProfitable(const LayoutArea &area);
 
  private:
+  bool IsLayoutAgnostic(const FuncGraphPtr &func_graph, const CNodePtr &cnode);
   bool JudgeAllOpsCanInfer(const FuncGraphPtr &func_graph);
   bool ResetFuncGraph(const FuncGraphPtr &func_graph);
   bool BasicProcess(const FuncGraphPtr &func_graph, bool main_graph);
@@ -19,7 +19,6 @@
 #include <memory>
 #include <vector>
 #include <string>
-#include <numeric>
 #include "mindspore/core/ops/fusion/conv2d_fusion.h"
 #include "mindspore/core/ops/split_with_overlap.h"
 #include "tools/optimizer/common/gllo_utils.h"
@@ -45,11 +44,19 @@ constexpr auto kPadDown = 1;
 constexpr auto kPadLeft = 2;
 constexpr auto kPadRight = 3;
 
+constexpr size_t kConvStrategyNum = 2;
+constexpr size_t kConvStrategyAxisNum = 4;
+
 lite::STATUS Conv2DInfo::GetAttrs() { return lite::RET_OK; }
 
 lite::STATUS Conv2DInfo::CheckStrategy(const SplitStrategy &strategy) {
   int split_count = 0;
   Strategys strategys = strategy.strategys;
+  if (strategys.size() != kConvStrategyNum || strategys[0].size() != kConvStrategyAxisNum ||
+      strategys[1].size() != kConvStrategyAxisNum) {
+    MS_LOG(ERROR) << "Strategy ERROR, conv needs NHWC strategy of feature map and KHWC strategy of kernel.";
+    return lite::RET_ERROR;
+  }
 
   // if split N
   if (is_any_not_none(strategys[0][kAxisN])) {
@@ -64,6 +71,13 @@ lite::STATUS Conv2DInfo::CheckStrategy(const SplitStrategy &strategy) {
       MS_LOG(ERROR) << "Strategy ERROR, split C_in, input and kernel must use same strategy.";
       return lite::RET_ERROR;
     }
+    // partial sums are added up after the parallel convs, a fused activation must see the whole sum
+    auto conv_prim = GetValueNode<std::shared_ptr<ops::Conv2DFusion>>(cnode_->input(kAnfPrimitiveIndex));
+    if (conv_prim != nullptr && conv_prim->GetAttr(ops::kActivationType) != nullptr &&
+        conv_prim->get_activation_type() != NO_ACTIVATION) {
+      MS_LOG(ERROR) << "Strategy ERROR, split C_in doesn't support fused activation.";
+      return lite::RET_ERROR;
+    }
   }
   // if split C_out
   if (is_any_not_none(strategys[1][kAxisCOut])) {
@@ -123,7 +137,7 @@ AnfNodePtr Conv2DInfo::CreateOutputsOfSplit(CNodePtr orig_node, size_t input_ind
     split_prim->set_stride(0);
     split_prim->set_pad_top(0);
   }
-  std::vector<AnfNodePtr> split_inputs = {NewValueNode(std::make_shared<ops::SplitWithOverlap>())};
+  std::vector<AnfNodePtr> split_inputs = {NewValueNode(split_prim)};
   split_inputs.push_back(orig_node->input(input_index + 1));
   auto split_cnode = func_graph_->NewCNode(split_inputs);
   if (split_cnode == nullptr) {
@@ -154,6 +168,10 @@ lite::STATUS Conv2DInfo::InferParallelCNodes() {
 
   parallel_output_nodes_.clear();
   auto conv_prim = GetValueNode<std::shared_ptr<ops::Conv2DFusion>>(cnode_->input(kAnfPrimitiveIndex));
+  if (conv_prim == nullptr) {
+    MS_LOG(ERROR) << name_ << " : Primitive is not Conv2DFusion.";
+    return lite::RET_ERROR;
+  }
   // split feature and kernel
   switch (splitMode_) {
     case SplitH: {
@@ -213,21 +231,19 @@ lite::STATUS Conv2DInfo::InferParallelCNodes() {
   }
   name_ = orig_name;
 
-  return ConstructOutputCNodes(conv_prim);
+  return ConstructOutputCNodes(conv_prim, feature_split_outputs, kernel_split_outputs, bias_split_outputs);
 }
 
-lite::STATUS Conv2DInfo::ConstructOutputCNodes(std::shared_ptr<ops::Conv2DFusion> conv_prim) {
+lite::STATUS Conv2DInfo::ConstructOutputCNodes(const std::shared_ptr<ops::Conv2DFusion> &conv_prim,
+                                               const std::vector<AnfNodePtr> &feature_split_outputs,
+                                               const std::vector<AnfNodePtr> &kernel_split_outputs,
+                                               const std::vector<AnfNodePtr> &bias_split_outputs) {
   Strategys strategys = strategy_.strategys;
   size_t dev_num = strategy_.dev_num;
-  std::vector<AnfNodePtr> feature_split_outputs;
-  std::vector<AnfNodePtr> kernel_split_outputs;
-  std::vector<AnfNodePtr> bias_split_outputs;
-  int cin_strategy_sum = std::accumulate(strategys[0][kAxisCIn].begin(), strategys[0][kAxisCIn].end(), 0);
-  int cout_strategy_sum = std::accumulate(strategys[1][kAxisCOut].begin(), strategys[1][kAxisCOut].end(), 0);
-  std::string conv_cnode_name = cnode_->fullname_with_scope();
+  auto in_channels = SplitSizes(conv_prim->get_in_channel(), strategys[0][kAxisCIn]);
+  auto out_channels = SplitSizes(conv_prim->get_out_channel(), strategys[1][kAxisCOut]);
   // construct parallel Conv2D nodes
   for (size_t i = 0; i < dev_num; ++i) {
-    std::vector<AnfNodePtr> tmp_outputs;
     bool has_bias = cnode_->size() >= 4;
     // if split cin, only one parallel operator has bias
     if ((i != 0) && splitMode_ == SplitCIN) {
@@ -235,6 +251,9 @@ lite::STATUS Conv2DInfo::ConstructOutputCNodes(std::shared_ptr<ops::Conv2DFusion
     }
     // copy attr
     auto prim = std::make_shared<ops::Conv2DFusion>();
+    if (conv_prim->GetAttr(ops::kIsDepthWise) != nullptr) {
+      prim->AddAttr(ops::kIsDepthWise, conv_prim->GetAttr(ops::kIsDepthWise));
+    }
     prim->set_in_channel(conv_prim->get_in_channel());
     prim->set_out_channel(conv_prim->get_out_channel());
     prim->set_dilation(conv_prim->get_dilation());
@@ -260,52 +279,28 @@ lite::STATUS Conv2DInfo::ConstructOutputCNodes(std::shared_ptr<ops::Conv2DFusion
         }
       } break;
       case SplitCIN: {
-        auto in_channel = prim->get_in_channel();
-        if (i == 0) {
-          prim->set_in_channel(in_channel * strategys[0][kAxisCIn][0] / cin_strategy_sum);
-        } else {
-          prim->set_in_channel(in_channel - (in_channel * strategys[0][kAxisCIn][0] / cin_strategy_sum));
-        }
+        prim->set_in_channel(in_channels.at(i));
       } break;
       case SplitCOUT: {
-        auto out_channel = prim->get_out_channel();
-        if (i == 0) {
-          prim->set_out_channel(out_channel * strategys[1][kAxisCOut][0] / cout_strategy_sum);
-        } else {
-          prim->set_out_channel(out_channel - (out_channel * strategys[1][kAxisCOut][0] / cout_strategy_sum));
+        prim->set_out_channel(out_channels.at(i));
+        // depthwise conv splits its input channels together with the output channels
+        if (!feature_split_outputs.empty()) {
+          prim->set_in_channel(out_channels.at(i));
+          prim->set_group(out_channels.at(i));
         }
       } break;
       default:
         break;
     }
-    std::vector<AnfNodePtr> conv_inputs = {NewValueNode(std::make_shared<ops::Conv2DFusion>())};
-    // if split Cout, feature will not be splited
-    if (splitMode_ == SplitCOUT) {
-      conv_inputs.push_back(cnode_->input(1));
-    } else {
-      conv_inputs.push_back(feature_split_outputs[i]);
-    }
-    // kernel splited only when split Cin and Cout
-    if (splitMode_ == SplitCIN || splitMode_ == SplitCOUT) {
-      conv_inputs.push_back(kernel_split_outputs[i]);
-    } else {
-      conv_inputs.push_back(cnode_->input(2));
-    }
+    std::vector<AnfNodePtr> conv_inputs = {NewValueNode(prim)};
+    conv_inputs.push_back(feature_split_outputs.empty() ? cnode_->input(1) : feature_split_outputs[i]);
+    conv_inputs.push_back(kernel_split_outputs.empty() ? cnode_->input(2) : kernel_split_outputs[i]);
     if (has_bias) {
-      if (splitMode_ == SplitCOUT) {
-        conv_inputs.push_back(bias_split_outputs[i]);
-      } else {
-        conv_inputs.push_back(cnode_->input(3));
-      }
+      conv_inputs.push_back(bias_split_outputs.empty() ? cnode_->input(3) : bias_split_outputs[i]);
     }
-    auto conv_cnode = func_graph_->NewCNode(conv_inputs);
-    if (conv_cnode == nullptr) {
-      MS_LOG(ERROR) << name_ << " : Failed to create parallel Conv2D node " << i;
+    if (AddParallelCNode(conv_inputs, i) != lite::RET_OK) {
       return lite::RET_ERROR;
     }
-    conv_cnode->set_fullname_with_scope(conv_cnode_name + std::to_string(i));
-    CreateMultipleOutputsOfAnfNode(conv_cnode, 1, &tmp_outputs);
-    parallel_output_nodes_.push_back(tmp_outputs[0]);
   }
   return lite::RET_OK;
 }
@@ -334,7 +329,55 @@ lite::STATUS Conv2DInfo::InferReplaceOp() {
   return lite::RET_OK;
 }
 
+lite::STATUS DepthwiseConv2DInfo::CheckStrategy(const SplitStrategy &strategy) {
+  Strategys strategys = strategy.strategys;
+  if (strategys.size() != kConvStrategyNum || strategys[0].size() != kConvStrategyAxisNum ||
+      strategys[1].size() != kConvStrategyAxisNum) {
+    MS_LOG(ERROR) << "Strategy ERROR, conv needs NHWC strategy of feature map and KHWC strategy of kernel.";
+    return lite::RET_ERROR;
+  }
+  auto conv_prim = GetValueNode<std::shared_ptr<ops::Conv2DFusion>>(cnode_->input(kAnfPrimitiveIndex));
+  if (conv_prim == nullptr || !IsDwConvNode(cnode_)) {
+    MS_LOG(ERROR) << name_ << " : Node is not a depthwise conv.";
+    return lite::RET_ERROR;
+  }
+  int split_count = 0;
+  if (is_any_not_none(strategys[0][kAxisN])) {
+    split_count++;
+    splitMode_ = SplitN;
+  }
+  if (is_any_not_none(strategys[0][kAxisH])) {
+    split_count++;
+    splitMode_ = SplitH;
+  }
+  if (is_any_not_none(strategys[0][kAxisCIn]) || is_any_not_none(strategys[1][kAxisCOut])) {
+    split_count++;
+    splitMode_ = SplitCOUT;
+    if (strategys[0][kAxisCIn] != strategys[1][kAxisCOut]) {
+      MS_LOG(ERROR) << "Strategy ERROR, split channel, input C and kernel K must use same strategy.";
+      return lite::RET_ERROR;
+    }
+    if (conv_prim->get_in_channel() != conv_prim->get_out_channel()) {
+      MS_LOG(ERROR) << "Strategy ERROR, split channel doesn't support depthwise conv with channel multiplier.";
+      return lite::RET_ERROR;
+    }
+  }
+  if (is_any_not_none(strategys[0][kAxisW]) || is_any_not_none(strategys[1][kAxisH]) ||
+      is_any_not_none(strategys[1][kAxisW]) || is_any_not_none(strategys[1][kAxisCIn])) {
+    MS_LOG(ERROR) << "Strategy ERROR, depthwise conv only supports split N, H or channel.";
+    return lite::RET_ERROR;
+  }
+  if (split_count > 1) {
+    MS_LOG(ERROR) << "Strategy ERROR, only support split one dimension.";
+    return lite::RET_ERROR;
+  }
+  return lite::RET_OK;
+}
+
 lite::STATUS DepthwiseConv2DInfo::InferParallelCNodes() {
+  if (splitMode_ != SplitCOUT) {
+    return Conv2DInfo::InferParallelCNodes();
+  }
   if (CheckIfFuncGraphIsNull(func_graph_) != lite::RET_OK) {
     return lite::RET_ERROR;
   }
@@ -344,86 +387,39 @@ lite::STATUS DepthwiseConv2DInfo::InferParallelCNodes() {
   Strategys strategys = strategy_.strategys;
   size_t dev_num = strategy_.dev_num;
   std::vector<AnfNodePtr> feature_split_outputs;
+  std::vector<AnfNodePtr> kernel_split_outputs;
+  std::vector<AnfNodePtr> bias_split_outputs;
   std::string orig_name = name_;
 
-  switch (splitMode_) {
-    case SplitCIN: {
-      MS_LOG(ERROR) << "DepthwiseConv2DInfo doesn't support split Cin.";
-      return lite::RET_ERROR;
-    } break;
-    case SplitCOUT: {
-      MS_LOG(ERROR) << "DepthwiseConv2DInfo doesn't support split Cout.";
-      return lite::RET_ERROR;
-    } break;
-    case SplitH: {
-      MS_LOG(ERROR) << "DepthwiseConv2DInfo doesn't support split H.";
-      return lite::RET_ERROR;
-    } break;
-    default:
-      break;
-  }
-
   parallel_output_nodes_.clear();
-  std::string conv_cnode_name = cnode_->fullname_with_scope();
   auto conv_prim = GetValueNode<std::shared_ptr<ops::Conv2DFusion>>(cnode_->input(kAnfPrimitiveIndex));
-  if (!IsDwConvNode(conv_prim)) {
+  // every channel is convolved on its own, feature, kernel and bias are split along the channel together
+  name_ = orig_name + "_input";
+  auto feature_split_cnode =
+    CreateOutputsOfSplit(cnode_, 0, &feature_split_outputs, kAxisCIn, dev_num, strategys[0][kAxisCIn], true);
+  if ((feature_split_cnode == nullptr) || (feature_split_outputs.size() != IntToSize(dev_num))) {
+    MS_LOG(ERROR) << name_ << " : Make split cnode failed.";
     return lite::RET_ERROR;
   }
-  // split feature and kernel
-  if (splitMode_ == SplitN) {
-    name_ = orig_name + "_input";
-    auto feature_split_cnode =
-      CreateOutputsOfSplit(cnode_, 0, &feature_split_outputs, kAxisN, dev_num, strategys[0][kAxisN], true);
-    if ((feature_split_cnode == nullptr) || (feature_split_outputs.size() != IntToSize(dev_num))) {
+  name_ = orig_name + "_kernel";
+  auto kernel_split_cnode =
+    CreateOutputsOfSplit(cnode_, 1, &kernel_split_outputs, kAxisCOut, dev_num, strategys[1][kAxisCOut], false);
+  if ((kernel_split_cnode == nullptr) || (kernel_split_outputs.size() != IntToSize(dev_num))) {
+    MS_LOG(ERROR) << name_ << " : Make split cnode failed.";
+    return lite::RET_ERROR;
+  }
+  if (cnode_->size() >= 4) {
+    name_ = orig_name + "_bias";
+    auto bias_split_cnode =
+      CreateOutputsOfSplit(cnode_, 2, &bias_split_outputs, 0, dev_num, strategys[1][kAxisCOut], false);
+    if ((bias_split_cnode == nullptr) || (bias_split_outputs.size() != IntToSize(dev_num))) {
       MS_LOG(ERROR) << name_ << " : Make split cnode failed.";
       return lite::RET_ERROR;
     }
   }
   name_ = orig_name;
 
-  // construct parallel Conv2D nodes
-  for (size_t i = 0; i < dev_num; ++i) {
-    std::vector<AnfNodePtr> tmp_outputs;
-    // copy attr
-    auto prim = std::make_shared<ops::Conv2DFusion>();
-    prim->AddAttr(ops::kIsDepthWise, MakeValue<bool>(true));
-    prim->set_in_channel(conv_prim->get_in_channel());
-    prim->set_out_channel(conv_prim->get_out_channel());
-    prim->set_dilation(conv_prim->get_dilation());
-    prim->set_format(conv_prim->get_format());
-    prim->set_group(conv_prim->get_group());
-    prim->set_kernel_size(conv_prim->get_kernel_size());
-    prim->set_pad_mode(conv_prim->get_pad_mode());
-    prim->set_pad_list(conv_prim->get_pad_list());
-    prim->set_stride(conv_prim->get_stride());
-    prim->set_activation_type(conv_prim->get_activation_type());
-
-    std::vector<AnfNodePtr> conv_inputs = {NewValueNode(std::make_shared<ops::Conv2DFusion>())};
-    conv_inputs.push_back(feature_split_outputs[i]);
-    conv_inputs.push_back(cnode_->input(2));
-    if (cnode_->size() >= 4) {
-      conv_inputs.push_back(cnode_->input(3));
-    }
-    auto conv_cnode = func_graph_->NewCNode(conv_inputs);
-    if (conv_cnode == nullptr) {
-      MS_LOG(ERROR) << name_ << " : Failed to create parallel DepthwiseConv2D node " << i;
-      return lite::RET_ERROR;
-    }
-    conv_cnode->set_fullname_with_scope(conv_cnode_name + std::to_string(i));
-    CreateMultipleOutputsOfAnfNode(conv_cnode, 1, &tmp_outputs);
-    parallel_output_nodes_.push_back(tmp_outputs[0]);
-  }
-
-  return lite::RET_OK;
-}
-
-lite::STATUS DepthwiseConv2DInfo::InferReplaceOp() {
-  size_t dev_num = strategy_.dev_num;
-  replace_op_ = CreateConcateNode(cnode_, parallel_output_nodes_, kAxisN, dev_num, true);
-  if (replace_op_ == nullptr) {
-    return lite::RET_ERROR;
-  }
-  return lite::RET_OK;
+  return ConstructOutputCNodes(conv_prim, feature_split_outputs, kernel_split_outputs, bias_split_outputs);
 }
 
 }  // namespace opt
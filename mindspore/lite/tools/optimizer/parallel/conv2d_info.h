@@ -38,7 +38,11 @@ class Conv2DInfo : public OperatorInfo {
   lite::STATUS GetAttrs() override;
   lite::STATUS InferReplaceOp() override;
   lite::STATUS InferParallelCNodes() override;
-  lite::STATUS ConstructOutputCNodes(std::shared_ptr<ops::Conv2DFusion> conv_prim);
+  // an empty split_outputs means the corresponding input is not split
+  lite::STATUS ConstructOutputCNodes(const std::shared_ptr<ops::Conv2DFusion> &conv_prim,
+                                     const std::vector<AnfNodePtr> &feature_split_outputs,
+                                     const std::vector<AnfNodePtr> &kernel_split_outputs,
+                                     const std::vector<AnfNodePtr> &bias_split_outputs);
   AnfNodePtr CreateOutputsOfSplit(CNodePtr orig_node, size_t input_index, std::vector<AnfNodePtr> *split_outputs,
                                   size_t split_dim, size_t split_num, const std::vector<int64_t> &splits,
                                   bool trans_format);
@@ -54,7 +58,8 @@ class DepthwiseConv2DInfo : public Conv2DInfo {
   ~DepthwiseConv2DInfo() override = default;
 
  protected:
-  lite::STATUS InferReplaceOp() override;
+  // the channel of depthwise conv is split as SplitCOUT, on the feature map and the kernel together
+  lite::STATUS CheckStrategy(const SplitStrategy &strategy) override;
   lite::STATUS InferParallelCNodes() override;
 };
 
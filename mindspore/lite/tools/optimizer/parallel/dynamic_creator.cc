@@ -15,10 +15,17 @@
  */
 
 #include "tools/optimizer/parallel/dynamic_creator.h"
+#include "tools/optimizer/parallel/ops_info_head_files.h"
 
 namespace mindspore {
 namespace opt {
 // operator register
+REGISTER(Conv2DInfo);
+REGISTER(DepthwiseConv2DInfo);
+REGISTER(FullConnectionInfo);
+REGISTER(MatMulInfo);
+REGISTER(PoolingInfo);
+REGISTER(ElementwiseInfo);
 
 std::string GetDisOpName(const std::string &prim_name) {
   std::string op_name = prim_name;
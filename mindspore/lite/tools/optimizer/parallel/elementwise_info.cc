@@ -0,0 +1,107 @@
+/**
+ * Copyright 2021 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "tools/optimizer/parallel/elementwise_info.h"
+#include <string>
+#include <vector>
+#include "tools/optimizer/common/gllo_utils.h"
+#include "include/errorcode.h"
+
+namespace mindspore {
+namespace opt {
+constexpr size_t kElementwiseStrategyAxisNum = 2;
+constexpr size_t kElementwiseAxisBatch = 0;
+constexpr size_t kElementwiseAxisChannel = 1;
+
+lite::STATUS ElementwiseInfo::GetAttrs() {
+  if (GetNodeShapes(&input_shapes_, &output_shapes_) != lite::RET_OK) {
+    return lite::RET_ERROR;
+  }
+  // value node inputs have no recorded shape, the inputs could not be told apart
+  if (input_shapes_.size() + 1 != cnode_->size() || output_shapes_.size() != 1 || output_shapes_.front().empty()) {
+    MS_LOG(ERROR) << name_ << " : Unsupported inputs or outputs of elementwise op.";
+    return lite::RET_ERROR;
+  }
+  return lite::RET_OK;
+}
+
+lite::STATUS ElementwiseInfo::CheckStrategy(const SplitStrategy &strategy) {
+  Strategys strategys = strategy.strategys;
+  if (strategys.size() != 1 || strategys[0].size() != kElementwiseStrategyAxisNum) {
+    MS_LOG(ERROR) << "Strategy ERROR, elementwise op needs {batch, channel} strategy of output.";
+    return lite::RET_ERROR;
+  }
+  bool split_n = is_any_not_none(strategys[0][kElementwiseAxisBatch]);
+  bool split_c = is_any_not_none(strategys[0][kElementwiseAxisChannel]);
+  if (split_n == split_c) {
+    MS_LOG(ERROR) << "Strategy ERROR, elementwise op splits either batch or channel.";
+    return lite::RET_ERROR;
+  }
+  auto &output_shape = output_shapes_.front();
+  split_mode_ = split_n ? SplitN : SplitCOUT;
+  split_axis_ = split_n ? 0 : static_cast<int32_t>(output_shape.size()) - 1;
+  for (auto &input_shape : input_shapes_) {
+    auto aligned_axis = split_axis_ - static_cast<int32_t>(output_shape.size() - input_shape.size());
+    if (aligned_axis >= 0 && input_shape[aligned_axis] != 1 && input_shape[aligned_axis] != output_shape[split_axis_]) {
+      MS_LOG(ERROR) << "Strategy ERROR, input can't be split along the split axis of output.";
+      return lite::RET_ERROR;
+    }
+  }
+  return lite::RET_OK;
+}
+
+lite::STATUS ElementwiseInfo::InferParallelCNodes() {
+  if (CheckIfFuncGraphIsNull(func_graph_) != lite::RET_OK || CheckIfAnfNodeIsNull(cnode_) != lite::RET_OK) {
+    return lite::RET_ERROR;
+  }
+  size_t dev_num = strategy_.dev_num;
+  auto &ratio = strategy_.strategys[0][split_mode_ == SplitN ? kElementwiseAxisBatch : kElementwiseAxisChannel];
+  auto &output_shape = output_shapes_.front();
+  std::vector<std::vector<AnfNodePtr>> input_split_outputs(input_shapes_.size());
+  parallel_output_nodes_.clear();
+  for (size_t i = 0; i < input_shapes_.size(); ++i) {
+    auto aligned_axis = split_axis_ - static_cast<int32_t>(output_shape.size() - input_shapes_[i].size());
+    if (aligned_axis < 0 || input_shapes_[i][aligned_axis] == 1) {
+      continue;
+    }
+    auto split_cnode = CreateOutputsOfSplitWithOverlap(i, aligned_axis, ratio, false, &input_split_outputs[i]);
+    if (split_cnode == nullptr || input_split_outputs[i].size() != dev_num) {
+      MS_LOG(ERROR) << name_ << " : Make split cnode of input " << i << " failed.";
+      return lite::RET_ERROR;
+    }
+  }
+  auto prim = GetValueNode<PrimitivePtr>(cnode_->input(kAnfPrimitiveIndex));
+  for (size_t i = 0; i < dev_num; ++i) {
+    std::vector<AnfNodePtr> inputs = {NewValueNode(prim)};
+    for (size_t j = 0; j < input_split_outputs.size(); ++j) {
+      inputs.push_back(input_split_outputs[j].empty() ? cnode_->input(j + 1) : input_split_outputs[j][i]);
+    }
+    if (AddParallelCNode(inputs, i) != lite::RET_OK) {
+      return lite::RET_ERROR;
+    }
+  }
+  return lite::RET_OK;
+}
+
+lite::STATUS ElementwiseInfo::InferReplaceOp() {
+  replace_op_ = CreateConcateNode(cnode_, parallel_output_nodes_, split_axis_, strategy_.dev_num, false);
+  if (replace_op_ == nullptr) {
+    return lite::RET_ERROR;
+  }
+  return lite::RET_OK;
+}
+}  // namespace opt
+}  // namespace mindspore
@@ -0,0 +1,49 @@
+/**
+ * Copyright 2021 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MINDSPORE_LITE_SRC_PASS_PARALLEL_ELEMENTWISE_INFO_H_
+#define MINDSPORE_LITE_SRC_PASS_PARALLEL_ELEMENTWISE_INFO_H_
+
+#include <string>
+#include <vector>
+#include "tools/optimizer/parallel/operator_info.h"
+#include "tools/optimizer/parallel/split_strategy.h"
+#include "include/errorcode.h"
+
+namespace mindspore {
+namespace opt {
+// strategy format is {batch, channel} of the output, the first and the last axis whatever the rank is.
+// inputs broadcast along the split axis are passed to every parallel node unsplit
+class ElementwiseInfo : public OperatorInfo {
+ public:
+  ElementwiseInfo(const std::string &name, const SplitStrategy &strategy) : OperatorInfo(name, strategy) {}
+  ~ElementwiseInfo() override = default;
+
+ protected:
+  lite::STATUS CheckStrategy(const SplitStrategy &strategy) override;
+  lite::STATUS GetAttrs() override;
+  lite::STATUS InferReplaceOp() override;
+  lite::STATUS InferParallelCNodes() override;
+
+  SplitMode split_mode_ = NoSplit;
+  int32_t split_axis_ = 0;
+  std::vector<ShapeVector> input_shapes_;
+  std::vector<ShapeVector> output_shapes_;
+};
+}  // namespace opt
+}  // namespace mindspore
+
+#endif  // MINDSPORE_LITE_SRC_PASS_PARALLEL_ELEMENTWISE_INFO_H_
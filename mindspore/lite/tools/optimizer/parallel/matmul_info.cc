@@ -0,0 +1,227 @@
+/**
+ * Copyright 2021 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "tools/optimizer/parallel/matmul_info.h"
+#include <memory>
+#include <string>
+#include <vector>
+#include "mindspore/core/ops/mat_mul.h"
+#include "mindspore/core/ops/fusion/full_connection.h"
+#include "mindspore/core/ops/op_utils.h"
+#include "tools/optimizer/common/gllo_utils.h"
+#include "include/errorcode.h"
+
+namespace mindspore {
+namespace opt {
+constexpr size_t kMatMulStrategyAxisNum = 2;
+constexpr size_t kAxisRow = 0;
+constexpr size_t kAxisDepth = 1;
+constexpr size_t kMatMulMinRank = 2;
+constexpr size_t kMatMulBiasIndex = 2;
+
+lite::STATUS MatMulInfo::GetShapes() {
+  if (GetNodeShapes(&input_shapes_, &output_shapes_) != lite::RET_OK) {
+    return lite::RET_ERROR;
+  }
+  if (input_shapes_.size() < kMatMulStrategyAxisNum || output_shapes_.size() != 1 ||
+      input_shapes_[0].size() < kMatMulMinRank || input_shapes_[1].size() < kMatMulMinRank) {
+    MS_LOG(ERROR) << name_ << " : Unsupported shapes of matmul.";
+    return lite::RET_ERROR;
+  }
+  has_bias_ = cnode_->size() > kMatMulBiasIndex + 1;
+  return lite::RET_OK;
+}
+
+lite::STATUS MatMulInfo::GetAttrs() {
+  auto prim = GetValueNode<PrimitivePtr>(cnode_->input(kAnfPrimitiveIndex));
+  if (prim == nullptr) {
+    MS_LOG(ERROR) << name_ << " : Primitive is null.";
+    return lite::RET_ERROR;
+  }
+  transpose_a_ = prim->GetAttr(ops::kTransposeA) != nullptr && GetValue<bool>(prim->GetAttr(ops::kTransposeA));
+  transpose_b_ = prim->GetAttr(ops::kTransposeB) != nullptr && GetValue<bool>(prim->GetAttr(ops::kTransposeB));
+  return GetShapes();
+}
+
+lite::STATUS MatMulInfo::CheckStrategy(const SplitStrategy &strategy) {
+  Strategys strategys = strategy.strategys;
+  if (strategys.size() != kMatMulStrategyAxisNum || strategys[0].size() != kMatMulStrategyAxisNum ||
+      strategys[1].size() != kMatMulStrategyAxisNum) {
+    MS_LOG(ERROR) << "Strategy ERROR, matmul needs {rows, depth} of input and {columns, depth} of weight.";
+    return lite::RET_ERROR;
+  }
+  int split_count = 0;
+  if (is_any_not_none(strategys[0][kAxisRow])) {
+    split_count++;
+    split_mode_ = SplitN;
+  }
+  if (is_any_not_none(strategys[0][kAxisDepth]) || is_any_not_none(strategys[1][kAxisDepth])) {
+    split_count++;
+    split_mode_ = SplitCIN;
+    if (strategys[0][kAxisDepth] != strategys[1][kAxisDepth]) {
+      MS_LOG(ERROR) << "Strategy ERROR, split depth, input and weight must use same strategy.";
+      return lite::RET_ERROR;
+    }
+  }
+  if (is_any_not_none(strategys[1][kAxisRow])) {
+    split_count++;
+    split_mode_ = SplitCOUT;
+  }
+  if (split_count != 1) {
+    MS_LOG(ERROR) << "Strategy ERROR, only support split one dimension.";
+    return lite::RET_ERROR;
+  }
+  auto rank_a = input_shapes_[0].size();
+  auto rank_b = input_shapes_[1].size();
+  switch (split_mode_) {
+    case SplitN:
+      // rows of a 2D input, or the batch of an input multiplied by a shared 2D weight
+      if ((rank_a == kMatMulMinRank && transpose_a_) || (rank_a > kMatMulMinRank && rank_b != kMatMulMinRank)) {
+        MS_LOG(ERROR) << "Strategy ERROR, split rows needs the rows or the batch of input on axis 0.";
+        return lite::RET_ERROR;
+      }
+      split_axis_a_ = 0;
+      break;
+    case SplitCIN:
+      split_axis_a_ = static_cast<int64_t>(transpose_a_ ? rank_a - 2 : rank_a - 1);
+      split_axis_b_ = static_cast<int64_t>(transpose_b_ ? rank_b - 1 : rank_b - 2);
+      break;
+    default:
+      split_axis_b_ = static_cast<int64_t>(transpose_b_ ? rank_b - 2 : rank_b - 1);
+      break;
+  }
+  return lite::RET_OK;
+}
+
+PrimitivePtr MatMulInfo::ParallelPrim(size_t index) {
+  // no attr of matmul depends on the split, parallel nodes share the original primitive
+  return GetValueNode<PrimitivePtr>(cnode_->input(kAnfPrimitiveIndex));
+}
+
+lite::STATUS MatMulInfo::InferParallelCNodes() {
+  if (CheckIfFuncGraphIsNull(func_graph_) != lite::RET_OK || CheckIfAnfNodeIsNull(cnode_) != lite::RET_OK) {
+    return lite::RET_ERROR;
+  }
+  Strategys strategys = strategy_.strategys;
+  size_t dev_num = strategy_.dev_num;
+  std::vector<AnfNodePtr> a_split_outputs;
+  std::vector<AnfNodePtr> b_split_outputs;
+  std::vector<AnfNodePtr> bias_split_outputs;
+  parallel_output_nodes_.clear();
+  if (split_axis_a_ >= 0) {
+    auto ratio = split_mode_ == SplitN ? strategys[0][kAxisRow] : strategys[0][kAxisDepth];
+    auto split_cnode = CreateOutputsOfSplitWithOverlap(0, split_axis_a_, ratio, false, &a_split_outputs);
+    if (split_cnode == nullptr || a_split_outputs.size() != dev_num) {
+      MS_LOG(ERROR) << name_ << " : Make split cnode of input failed.";
+      return lite::RET_ERROR;
+    }
+  }
+  if (split_axis_b_ >= 0) {
+    auto ratio = split_mode_ == SplitCOUT ? strategys[1][kAxisRow] : strategys[1][kAxisDepth];
+    auto split_cnode = CreateOutputsOfSplitWithOverlap(1, split_axis_b_, ratio, false, &b_split_outputs);
+    if (split_cnode == nullptr || b_split_outputs.size() != dev_num) {
+      MS_LOG(ERROR) << name_ << " : Make split cnode of weight failed.";
+      return lite::RET_ERROR;
+    }
+    // bias follows the columns of the weight
+    if (split_mode_ == SplitCOUT && has_bias_) {
+      split_cnode = CreateOutputsOfSplitWithOverlap(kMatMulBiasIndex, 0, ratio, false, &bias_split_outputs);
+      if (split_cnode == nullptr || bias_split_outputs.size() != dev_num) {
+        MS_LOG(ERROR) << name_ << " : Make split cnode of bias failed.";
+        return lite::RET_ERROR;
+      }
+    }
+  }
+  for (size_t i = 0; i < dev_num; ++i) {
+    auto prim = ParallelPrim(i);
+    if (prim == nullptr) {
+      return lite::RET_ERROR;
+    }
+    std::vector<AnfNodePtr> inputs = {NewValueNode(prim)};
+    inputs.push_back(a_split_outputs.empty() ? cnode_->input(1) : a_split_outputs[i]);
+    inputs.push_back(b_split_outputs.empty() ? cnode_->input(2) : b_split_outputs[i]);
+    // partial products are added up, only one of them adds the bias
+    if (has_bias_ && (split_mode_ != SplitCIN || i == 0)) {
+      inputs.push_back(bias_split_outputs.empty() ? cnode_->input(kMatMulBiasIndex + 1) : bias_split_outputs[i]);
+    }
+    if (AddParallelCNode(inputs, i) != lite::RET_OK) {
+      return lite::RET_ERROR;
+    }
+  }
+  return lite::RET_OK;
+}
+
+lite::STATUS MatMulInfo::InferReplaceOp() {
+  size_t dev_num = strategy_.dev_num;
+  if (split_mode_ == SplitCIN) {
+    replace_op_ = CreateReduceNode(cnode_, parallel_output_nodes_, 0, dev_num, false);
+  } else {
+    auto concat_dim = split_mode_ == SplitN ? 0 : static_cast<int32_t>(output_shapes_.front().size()) - 1;
+    replace_op_ = CreateConcateNode(cnode_, parallel_output_nodes_, concat_dim, dev_num, false);
+  }
+  if (replace_op_ == nullptr) {
+    return lite::RET_ERROR;
+  }
+  return lite::RET_OK;
+}
+
+lite::STATUS FullConnectionInfo::GetAttrs() {
+  auto fc_prim = GetValueNode<std::shared_ptr<ops::FullConnection>>(cnode_->input(kAnfPrimitiveIndex));
+  if (fc_prim == nullptr) {
+    MS_LOG(ERROR) << name_ << " : Primitive is not FullConnection.";
+    return lite::RET_ERROR;
+  }
+  transpose_a_ = false;
+  transpose_b_ = true;
+  return GetShapes();
+}
+
+lite::STATUS FullConnectionInfo::CheckStrategy(const SplitStrategy &strategy) {
+  if (MatMulInfo::CheckStrategy(strategy) != lite::RET_OK) {
+    return lite::RET_ERROR;
+  }
+  auto fc_prim = GetValueNode<std::shared_ptr<ops::FullConnection>>(cnode_->input(kAnfPrimitiveIndex));
+  bool use_axis = fc_prim->GetAttr(ops::kUseAxis) != nullptr && fc_prim->get_use_axis();
+  if (split_mode_ == SplitN && use_axis && fc_prim->GetAttr(ops::kAxis) != nullptr && fc_prim->get_axis() == 0) {
+    MS_LOG(ERROR) << "Strategy ERROR, the whole input is one row, can't split rows.";
+    return lite::RET_ERROR;
+  }
+  if (split_mode_ == SplitCIN) {
+    // the depth of a flattened input is not one of its axes
+    if (input_shapes_[0].size() != kMatMulMinRank) {
+      MS_LOG(ERROR) << "Strategy ERROR, split depth needs a 2D input.";
+      return lite::RET_ERROR;
+    }
+    if (fc_prim->GetAttr(ops::kActivationType) != nullptr && fc_prim->get_activation_type() != NO_ACTIVATION) {
+      MS_LOG(ERROR) << "Strategy ERROR, split depth doesn't support fused activation.";
+      return lite::RET_ERROR;
+    }
+  }
+  return lite::RET_OK;
+}
+
+PrimitivePtr FullConnectionInfo::ParallelPrim(size_t index) {
+  auto fc_prim = GetValueNode<std::shared_ptr<ops::FullConnection>>(cnode_->input(kAnfPrimitiveIndex));
+  if (split_mode_ != SplitCIN || index == 0 || !has_bias_) {
+    return fc_prim;
+  }
+  auto prim = std::make_shared<ops::FullConnection>();
+  prim->SetAttrs(fc_prim->attrs());
+  prim->set_has_bias(false);
+  return prim;
+}
+}  // namespace opt
+}  // namespace mindspore
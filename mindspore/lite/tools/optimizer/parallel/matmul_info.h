@@ -0,0 +1,67 @@
+/**
+ * Copyright 2021 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MINDSPORE_LITE_SRC_PASS_PARALLEL_MATMUL_INFO_H_
+#define MINDSPORE_LITE_SRC_PASS_PARALLEL_MATMUL_INFO_H_
+
+#include <string>
+#include <vector>
+#include "tools/optimizer/parallel/operator_info.h"
+#include "tools/optimizer/parallel/split_strategy.h"
+#include "include/errorcode.h"
+
+namespace mindspore {
+namespace opt {
+// strategy format is {rows, depth} of the input and {columns, depth} of the weight, whatever the transposes are
+class MatMulInfo : public OperatorInfo {
+ public:
+  MatMulInfo(const std::string &name, const SplitStrategy &strategy) : OperatorInfo(name, strategy) {}
+  ~MatMulInfo() override = default;
+
+ protected:
+  lite::STATUS CheckStrategy(const SplitStrategy &strategy) override;
+  lite::STATUS GetAttrs() override;
+  lite::STATUS InferReplaceOp() override;
+  lite::STATUS InferParallelCNodes() override;
+  // primitive of the index-th parallel node
+  virtual PrimitivePtr ParallelPrim(size_t index);
+  lite::STATUS GetShapes();
+
+  SplitMode split_mode_ = NoSplit;
+  bool transpose_a_ = false;
+  bool transpose_b_ = false;
+  bool has_bias_ = false;
+  int64_t split_axis_a_ = -1;
+  int64_t split_axis_b_ = -1;
+  std::vector<ShapeVector> input_shapes_;
+  std::vector<ShapeVector> output_shapes_;
+};
+
+// FullConnection is a MatMul with transposed weight, the input is flattened from axis
+class FullConnectionInfo : public MatMulInfo {
+ public:
+  FullConnectionInfo(const std::string &name, const SplitStrategy &strategy) : MatMulInfo(name, strategy) {}
+  ~FullConnectionInfo() override = default;
+
+ protected:
+  lite::STATUS CheckStrategy(const SplitStrategy &strategy) override;
+  lite::STATUS GetAttrs() override;
+  PrimitivePtr ParallelPrim(size_t index) override;
+};
+}  // namespace opt
+}  // namespace mindspore
+
+#endif  // MINDSPORE_LITE_SRC_PASS_PARALLEL_MATMUL_INFO_H_
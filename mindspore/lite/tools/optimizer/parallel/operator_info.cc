@@ -16,11 +16,14 @@
 
 #include "tools/optimizer/parallel/operator_info.h"
 #include <algorithm>
+#include <numeric>
 #include "tools/converter/ops/ops_def.h"
 #include "tools/optimizer/parallel/split_strategy.h"
 #include "mindspore/core/ops/concat.h"
 #include "mindspore/core/ops/addn.h"
 #include "mindspore/core/ops/split.h"
+#include "mindspore/core/ops/split_with_overlap.h"
+#include "tools/optimizer/fisson/fisson_util.h"
 #include "include/lite_types.h"
 #include "mindspore/ccsrc/utils/utils.h"
 #include "base/core_ops.h"
@@ -36,6 +39,23 @@ bool is_any_not_none(const std::vector<int64_t> &split) {
   return std::any_of(split.begin(), split.end(), [](int64_t v) { return v != static_cast<int64_t>(NoSplit); });
 }
 
+std::vector<int64_t> SplitSizes(int64_t dim_size, const std::vector<int64_t> &ratio) {
+  auto total = std::accumulate(ratio.begin(), ratio.end(), static_cast<int64_t>(0));
+  std::vector<int64_t> sizes;
+  if (total <= 0) {
+    return sizes;
+  }
+  int64_t visited = 0;
+  int64_t border = 0;
+  for (size_t i = 0; i < ratio.size(); ++i) {
+    visited += ratio[i];
+    auto next_border = i + 1 == ratio.size() ? dim_size : (dim_size * visited + total - 1) / total;
+    sizes.push_back(next_border - border);
+    border = next_border;
+  }
+  return sizes;
+}
+
 int OperatorInfo::SetCNodeBackend() {
   for (size_t i = 0; i < strategy_.dev_num; ++i) {
     lite::DeviceType dt_type;
@@ -180,6 +200,60 @@ AnfNodePtr OperatorInfo::CreateReduceNode(const CNodePtr &orig_node, const std::
   return addn_cnode;
 }
 
+AnfNodePtr OperatorInfo::CreateOutputsOfSplitWithOverlap(size_t input_index, int64_t split_dim,
+                                                          const std::vector<int64_t> &ratio, bool trans_format,
+                                                          std::vector<AnfNodePtr> *split_outputs) {
+  MS_EXCEPTION_IF_NULL(split_outputs);
+  auto split_num = ratio.size();
+  auto split_prim = std::make_shared<ops::SplitWithOverlap>();
+  split_prim->set_split_dim(split_dim);
+  split_prim->set_number_split(split_num);
+  split_prim->set_ratio(ratio);
+  split_prim->set_trans_format(trans_format);
+  split_prim->set_extend_top(std::vector<int64_t>(split_num, 0));
+  split_prim->set_extend_bottom(std::vector<int64_t>(split_num, 0));
+  split_prim->set_stride(0);
+  split_prim->set_pad_top(0);
+  auto split_cnode = func_graph_->NewCNode({NewValueNode(split_prim), cnode_->input(input_index + 1)});
+  if (split_cnode == nullptr) {
+    MS_LOG(ERROR) << name_ << " : Failed to create split node.";
+    return nullptr;
+  }
+  split_cnode->set_fullname_with_scope("Split_" + name_ + "_" + std::to_string(input_index));
+  if (CreateMultipleOutputsOfAnfNode(split_cnode, split_num, split_outputs) != lite::RET_OK) {
+    return nullptr;
+  }
+  return split_cnode;
+}
+
+int OperatorInfo::AddParallelCNode(const std::vector<AnfNodePtr> &inputs, size_t index) {
+  auto parallel_cnode = func_graph_->NewCNode(inputs);
+  if (parallel_cnode == nullptr) {
+    MS_LOG(ERROR) << name_ << " : Failed to create parallel node " << index;
+    return lite::RET_ERROR;
+  }
+  parallel_cnode->set_fullname_with_scope(cnode_->fullname_with_scope() + std::to_string(index));
+  std::vector<AnfNodePtr> outputs;
+  if (CreateMultipleOutputsOfAnfNode(parallel_cnode, 1, &outputs) != lite::RET_OK) {
+    return lite::RET_ERROR;
+  }
+  parallel_output_nodes_.push_back(outputs.front());
+  return lite::RET_OK;
+}
+
+int OperatorInfo::GetNodeShapes(std::vector<ShapeVector> *input_shapes, std::vector<ShapeVector> *output_shapes) const {
+  MS_EXCEPTION_IF_NULL(input_shapes);
+  MS_EXCEPTION_IF_NULL(output_shapes);
+  auto iter = g_graph_nodes_out_shapes.find(name_);
+  if (iter == g_graph_nodes_out_shapes.end() || iter->second.size() < 2) {
+    MS_LOG(ERROR) << name_ << " : Shapes are not recorded.";
+    return lite::RET_ERROR;
+  }
+  *input_shapes = iter->second[0];
+  *output_shapes = iter->second[1];
+  return lite::RET_OK;
+}
+
 int OperatorInfo::Init() {
   if (GetAttrs() != lite::RET_OK) {
     MS_LOG(ERROR) << name_ << ": Parse attrs failed.";
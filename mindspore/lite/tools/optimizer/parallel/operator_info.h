@@ -40,6 +40,7 @@ namespace opt {
  *    3.1.Override CheckStrategy(), InferParallelCNodes() and InferReplaceOp()
  * 4.include header file of XXXInfo in ops_info_head_files.h
  * 5.REGISTER XXXInfo in dynamic_creator.cc
+ * 6.Add the split modes of XXX to kSupportSplitModes and its strategy to GenerateSplitStrategy
  */
 using schema::ReduceMode;
 
@@ -72,6 +73,13 @@ class OperatorInfo {
                                int32_t concat_dim, size_t input_nodes_num, bool trans_format);
   AnfNodePtr CreateReduceNode(const CNodePtr &orig_node, const std::vector<AnfNodePtr> &input_nodes, int32_t reduce_dim,
                               size_t input_nodes_num, bool trans_format);
+  // split the input_index-th input of cnode_ along split_dim by ratio, the parts do not overlap
+  AnfNodePtr CreateOutputsOfSplitWithOverlap(size_t input_index, int64_t split_dim, const std::vector<int64_t> &ratio,
+                                             bool trans_format, std::vector<AnfNodePtr> *split_outputs);
+  // create the index-th parallel node of cnode_ and record its output
+  int AddParallelCNode(const std::vector<AnfNodePtr> &inputs, size_t index);
+  // shapes of the non-value inputs and the outputs of cnode_, recorded before the split
+  int GetNodeShapes(std::vector<ShapeVector> *input_shapes, std::vector<ShapeVector> *output_shapes) const;
   virtual int GetAttrs() = 0;
   virtual int InferReplaceOp() = 0;
   virtual int InferParallelCNodes() = 0;
@@ -92,6 +100,8 @@ class OperatorInfo {
 
 bool is_any_none(const std::vector<int64_t> &split);
 bool is_any_not_none(const std::vector<int64_t> &split);
+// sizes of the parts SplitWithOverlap cuts dim_size into by ratio when nothing overlaps
+std::vector<int64_t> SplitSizes(int64_t dim_size, const std::vector<int64_t> &ratio);
 
 }  // namespace opt
 }  // namespace mindspore
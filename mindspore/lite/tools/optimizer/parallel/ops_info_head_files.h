@@ -0,0 +1,25 @@
+/**
+ * Copyright 2021 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MINDSPORE_LITE_SRC_PASS_PARALLEL_OPS_INFO_HEAD_FILES_H_
+#define MINDSPORE_LITE_SRC_PASS_PARALLEL_OPS_INFO_HEAD_FILES_H_
+
+#include "tools/optimizer/parallel/conv2d_info.h"
+#include "tools/optimizer/parallel/elementwise_info.h"
+#include "tools/optimizer/parallel/matmul_info.h"
+#include "tools/optimizer/parallel/pooling_info.h"
+
+#endif  // MINDSPORE_LITE_SRC_PASS_PARALLEL_OPS_INFO_HEAD_FILES_H_
@@ -17,6 +17,7 @@
 #include "tools/optimizer/parallel/parallel_pass.h"
 #include "include/errorcode.h"
 #include "ir/tensor.h"
+#include "tools/optimizer/fisson/fisson_util.h"
 
 namespace mindspore {
 namespace opt {
@@ -24,6 +25,10 @@ bool ParallelPass::IsParallelCareNode(const AnfNodePtr &node) {
   return std::any_of(PARALLEL_LIST.begin(), PARALLEL_LIST.end(), [this, &node](auto &prim) {
     if (CheckPrimitiveType(node, prim)) {
       type_name_ = PrimToString(prim);
+      // depthwise conv shares the primitive with conv but splits differently
+      if (type_name_ == kSplitOp && IsDwConvNode(node)) {
+        type_name_ = kSplitDepthwiseConv2D;
+      }
       return true;
     } else {
       return false;
@@ -38,6 +43,21 @@ std::string ParallelPass::PrimToString(const PrimitivePtr &prim) {
   return type_string.at(prim->name());
 }
 
+bool ParallelPass::ChooseSplitStrategy(const CNodePtr &cnode, SplitStrategy *strategy) {
+  auto iter = g_graph_nodes_out_shapes.find(cnode->fullname_with_scope());
+  if (iter == g_graph_nodes_out_shapes.end() || iter->second.size() < 2) {
+    MS_LOG(DEBUG) << cnode->fullname_with_scope() << " : No shapes recorded, keep it unsplit.";
+    return false;
+  }
+  auto split_mode = ChooseSplitMode(type_name_, iter->second[0], iter->second[1], strategy->dev_num);
+  if (split_mode == NoSplit) {
+    return false;
+  }
+  *strategy = GenerateSplitStrategy(type_name_, split_mode, strategy->dev_num);
+  MS_LOG(INFO) << cnode->fullname_with_scope() << " : Split mode " << split_mode << " is chosen.";
+  return !strategy->strategys.empty();
+}
+
 AnfNodePtr ParallelPass::Run(const FuncGraphPtr &func_graph, const AnfNodePtr &node) {
   if (CheckIfFuncGraphIsNull(func_graph) != lite::RET_OK || CheckIfAnfNodeIsNull(node) != lite::RET_OK) {
     return nullptr;
@@ -68,8 +88,14 @@ AnfNodePtr ParallelPass::Run(const FuncGraphPtr &func_graph, const AnfNodePtr &n
     MS_LOG(DEBUG) << name << " : No split strategy for the current CNode.";
     return nullptr;
   }
+  auto strategy = split_strategys_[name];
+  // strategies chosen by the cost model only split the nodes it can, the others are left as they are
+  bool auto_mode = strategy.strategys.empty();
+  if (auto_mode && !ChooseSplitStrategy(cnode, &strategy)) {
+    return nullptr;
+  }
   cnode->set_fullname_with_scope(cnode_name + PARALLEL_NAME_SUFFIX);
-  OperatorInfoPtr operator_ = OperatorInstance(type_name_, orig_name, split_strategys_[name]);
+  OperatorInfoPtr operator_ = OperatorInstance(type_name_, orig_name, strategy);
   if (operator_ == nullptr) {
     MS_LOG(EXCEPTION) << "Failure: Create " << name << " OperatorInstance failed";
   }
@@ -77,6 +103,11 @@ AnfNodePtr ParallelPass::Run(const FuncGraphPtr &func_graph, const AnfNodePtr &n
   operator_->set_func_graph(func_graph);
   operator_->setFmk(FmkType_);
   if (operator_->Init() == RET_ERROR) {
+    if (auto_mode) {
+      MS_LOG(WARNING) << "operator " << orig_name << " can't be split, keep it unsplit";
+      cnode->set_fullname_with_scope(orig_name);
+      return nullptr;
+    }
     MS_LOG(EXCEPTION) << "Failure: operator " << name << " init failed";
   }
   return operator_->replace_op();
@@ -38,11 +38,26 @@ class ParallelPass : public opt::NodePass {
   AnfNodePtr Run(const FuncGraphPtr &func_graph, const AnfNodePtr &node) override;
 
  private:
-  const std::set<PrimitivePtr> PARALLEL_LIST = {prim::kPrimConv2DFusion};
-  const std::unordered_map<std::string, std::string> type_string = {{prim::kPrimConv2DFusion->name(), "Conv2D"}};
+  const std::set<PrimitivePtr> PARALLEL_LIST = {prim::kPrimConv2DFusion,  prim::kPrimFullConnection,
+                                                prim::kPrimMatMul,        prim::kPrimAvgPoolFusion,
+                                                prim::kPrimMaxPoolFusion, prim::kPrimActivation,
+                                                prim::kPrimAddFusion,     prim::kPrimMulFusion,
+                                                prim::kPrimSubFusion};
+  const std::unordered_map<std::string, std::string> type_string = {
+    {prim::kPrimConv2DFusion->name(), kSplitOp},
+    {prim::kPrimFullConnection->name(), kSplitFullConnection},
+    {prim::kPrimMatMul->name(), kSplitMatMul},
+    {prim::kPrimAvgPoolFusion->name(), kSplitPooling},
+    {prim::kPrimMaxPoolFusion->name(), kSplitPooling},
+    {prim::kPrimActivation->name(), kSplitElementwise},
+    {prim::kPrimAddFusion->name(), kSplitElementwise},
+    {prim::kPrimMulFusion->name(), kSplitElementwise},
+    {prim::kPrimSubFusion->name(), kSplitElementwise}};
 
   bool IsParallelCareNode(const AnfNodePtr &node);
   std::string PrimToString(const PrimitivePtr &prim);
+  // in SplitAuto mode, the strategy of the mode the cost model picks from the shapes of cnode
+  bool ChooseSplitStrategy(const CNodePtr &cnode, SplitStrategy *strategy);
 
   std::string type_name_;
   std::unordered_map<std::string, SplitStrategy> split_strategys_;
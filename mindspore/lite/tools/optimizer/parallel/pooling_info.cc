@@ -0,0 +1,86 @@
+/**
+ * Copyright 2021 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "tools/optimizer/parallel/pooling_info.h"
+#include <string>
+#include <vector>
+#include "tools/optimizer/common/gllo_utils.h"
+#include "include/errorcode.h"
+
+namespace mindspore {
+namespace opt {
+constexpr size_t kPoolingStrategyAxisNum = 4;
+constexpr int32_t kPoolingAxisN = 0;
+constexpr int32_t kPoolingAxisH = 1;
+constexpr int32_t kPoolingAxisW = 2;
+constexpr int32_t kPoolingAxisC = 3;
+
+lite::STATUS PoolingInfo::GetAttrs() { return lite::RET_OK; }
+
+lite::STATUS PoolingInfo::CheckStrategy(const SplitStrategy &strategy) {
+  Strategys strategys = strategy.strategys;
+  if (strategys.size() != 1 || strategys[0].size() != kPoolingStrategyAxisNum) {
+    MS_LOG(ERROR) << "Strategy ERROR, pooling needs NHWC strategy of feature map.";
+    return lite::RET_ERROR;
+  }
+  auto &feature_strategy = strategys[0];
+  if (is_any_not_none(feature_strategy[kPoolingAxisH]) || is_any_not_none(feature_strategy[kPoolingAxisW])) {
+    MS_LOG(ERROR) << "Strategy ERROR, pooling doesn't support split H or W.";
+    return lite::RET_ERROR;
+  }
+  bool split_n = is_any_not_none(feature_strategy[kPoolingAxisN]);
+  bool split_c = is_any_not_none(feature_strategy[kPoolingAxisC]);
+  if (split_n == split_c) {
+    MS_LOG(ERROR) << "Strategy ERROR, pooling splits either N or C.";
+    return lite::RET_ERROR;
+  }
+  split_mode_ = split_n ? SplitN : SplitCOUT;
+  split_axis_ = split_n ? kPoolingAxisN : kPoolingAxisC;
+  return lite::RET_OK;
+}
+
+lite::STATUS PoolingInfo::InferParallelCNodes() {
+  if (CheckIfFuncGraphIsNull(func_graph_) != lite::RET_OK || CheckIfAnfNodeIsNull(cnode_) != lite::RET_OK) {
+    return lite::RET_ERROR;
+  }
+  size_t dev_num = strategy_.dev_num;
+  std::vector<AnfNodePtr> feature_split_outputs;
+  parallel_output_nodes_.clear();
+  auto split_cnode = CreateOutputsOfSplitWithOverlap(0, split_axis_, strategy_.strategys[0][split_axis_], true,
+                                                     &feature_split_outputs);
+  if (split_cnode == nullptr || feature_split_outputs.size() != dev_num) {
+    MS_LOG(ERROR) << name_ << " : Make split cnode failed.";
+    return lite::RET_ERROR;
+  }
+  // windows never cross the batch or the channel, parallel nodes share the original primitive
+  auto prim = GetValueNode<PrimitivePtr>(cnode_->input(kAnfPrimitiveIndex));
+  for (size_t i = 0; i < dev_num; ++i) {
+    if (AddParallelCNode({NewValueNode(prim), feature_split_outputs[i]}, i) != lite::RET_OK) {
+      return lite::RET_ERROR;
+    }
+  }
+  return lite::RET_OK;
+}
+
+lite::STATUS PoolingInfo::InferReplaceOp() {
+  replace_op_ = CreateConcateNode(cnode_, parallel_output_nodes_, split_axis_, strategy_.dev_num, true);
+  if (replace_op_ == nullptr) {
+    return lite::RET_ERROR;
+  }
+  return lite::RET_OK;
+}
+}  // namespace opt
+}  // namespace mindspore
@@ -15,45 +15,211 @@
  */
 
 #include "tools/optimizer/parallel/split_strategy.h"
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <numeric>
 #include <vector>
 #include <unordered_map>
 #include <string>
 
 namespace mindspore {
 namespace opt {
-std::unordered_map<std::string, opt::SplitStrategy> ParserSplitStrategy(SplitMode parallel_mode) {
+namespace {
+// strategy axes of conv, NHWC for the feature map and KHWC for the kernel
+constexpr size_t kConvAxisNum = 4;
+constexpr size_t kConvAxisN = 0;
+constexpr size_t kConvAxisH = 1;
+constexpr size_t kConvAxisC = 3;
+// strategy axes of matmul, {rows, depth} of the input and {columns, depth} of the weight
+constexpr size_t kMatMulAxisNum = 2;
+constexpr size_t kMatMulAxisRow = 0;
+constexpr size_t kMatMulAxisDepth = 1;
+// strategy axes of elementwise ops, {batch, channel} of the output
+constexpr size_t kElementwiseAxisNum = 2;
+constexpr size_t kElementwiseAxisChannel = 1;
+
+// rough throughput of one core, the cost model depends on their ratio rather than the absolute values
+constexpr double kFlopsPerUs = 4000.0;
+constexpr double kBytesPerUs = 4000.0;
+// launching one more branch together with its share of the split and concat kernels
+constexpr double kBranchOverheadUs = 10.0;
+constexpr double kDataTypeSize = sizeof(float);
+
+std::vector<std::vector<int64_t>> UnsplitAxes(size_t axis_num, size_t dev_num) {
+  return std::vector<std::vector<int64_t>>(axis_num, std::vector<int64_t>(dev_num, 0));
+}
+
+double ElementNum(const ShapeVector &shape) {
+  return shape.empty() ? 0 : std::accumulate(shape.begin(), shape.end(), 1.0, std::multiplies<double>());
+}
+
+// multiply-adds per output element
+double WorkPerOutput(const std::string &op_type, const std::vector<ShapeVector> &input_shapes, double output_num) {
+  auto &input = input_shapes.front();
+  auto weight = input_shapes.size() > 1 ? input_shapes[1] : ShapeVector{};
+  if (op_type == kSplitOp && weight.size() == kConvAxisNum) {
+    return ElementNum(weight) / weight[0];
+  }
+  if (op_type == kSplitDepthwiseConv2D && weight.size() == kConvAxisNum) {
+    return static_cast<double>(weight[1] * weight[2]);
+  }
+  if (op_type == kSplitFullConnection || op_type == kSplitMatMul) {
+    // [M, K] x [K, N] -> [M, N] gives K = sqrt(MK * KN / MN) whatever the transposes are
+    return std::sqrt(ElementNum(input) * ElementNum(weight) / output_num);
+  }
+  if (op_type == kSplitPooling) {
+    return ElementNum(input) / output_num;
+  }
+  return static_cast<double>(input_shapes.size());
+}
+}  // namespace
+
+SplitStrategy GenerateSplitStrategy(const std::string &op_type, SplitMode split_mode, size_t dev_num) {
+  SplitStrategy split_strategy{{}, std::vector<std::string>(dev_num, kSplitDevType), dev_num};
+  if (dev_num < 2) {
+    return split_strategy;
+  }
+  const std::vector<int64_t> split_ratio(dev_num, 1);
+  auto modes = kSupportSplitModes.find(op_type);
+  if (modes == kSupportSplitModes.end() ||
+      std::find(modes->second.begin(), modes->second.end(), split_mode) == modes->second.end()) {
+    return split_strategy;
+  }
+  if (op_type == kSplitOp || op_type == kSplitDepthwiseConv2D) {
+    auto split_feature_map = UnsplitAxes(kConvAxisNum, dev_num);
+    auto split_weight = UnsplitAxes(kConvAxisNum, dev_num);
+    switch (split_mode) {
+      case SplitN:
+        split_feature_map[kConvAxisN] = split_ratio;
+        break;
+      case SplitH:
+        split_feature_map[kConvAxisH] = split_ratio;
+        break;
+      case SplitCIN:
+        split_feature_map[kConvAxisC] = split_ratio;
+        split_weight[kConvAxisC] = split_ratio;
+        break;
+      default:
+        split_weight[kConvAxisN] = split_ratio;
+        // the channel of depthwise conv is both its input and output channel
+        if (op_type == kSplitDepthwiseConv2D) {
+          split_feature_map[kConvAxisC] = split_ratio;
+        }
+        break;
+    }
+    split_strategy.strategys = {split_feature_map, split_weight};
+  } else if (op_type == kSplitFullConnection || op_type == kSplitMatMul) {
+    auto split_input = UnsplitAxes(kMatMulAxisNum, dev_num);
+    auto split_weight = UnsplitAxes(kMatMulAxisNum, dev_num);
+    if (split_mode == SplitN) {
+      split_input[kMatMulAxisRow] = split_ratio;
+    } else if (split_mode == SplitCIN) {
+      split_input[kMatMulAxisDepth] = split_ratio;
+      split_weight[kMatMulAxisDepth] = split_ratio;
+    } else {
+      split_weight[kMatMulAxisRow] = split_ratio;
+    }
+    split_strategy.strategys = {split_input, split_weight};
+  } else if (op_type == kSplitPooling) {
+    auto split_feature_map = UnsplitAxes(kConvAxisNum, dev_num);
+    split_feature_map[split_mode == SplitN ? kConvAxisN : kConvAxisC] = split_ratio;
+    split_strategy.strategys = {split_feature_map};
+  } else {
+    auto split_output = UnsplitAxes(kElementwiseAxisNum, dev_num);
+    split_output[split_mode == SplitN ? 0 : kElementwiseAxisChannel] = split_ratio;
+    split_strategy.strategys = {split_output};
+  }
+  return split_strategy;
+}
+
+std::unordered_map<std::string, opt::SplitStrategy> ParserSplitStrategy(SplitMode parallel_mode, size_t dev_num) {
   std::unordered_map<std::string, opt::SplitStrategy> split_strategys;
-  if (kSplitRatio.empty() || kSplitDefaultRatio.empty() || kSplitDevTypes.empty()) {
+  if (dev_num < 2) {
     return split_strategys;
   }
-  if (kSplitRatio.size() != kSplitDevTypes.size()) {
-    return split_strategys;
+  for (auto &modes : kSupportSplitModes) {
+    if (parallel_mode == SplitAuto) {
+      split_strategys[modes.first] = {{}, std::vector<std::string>(dev_num, kSplitDevType), dev_num};
+      continue;
+    }
+    auto split_strategy = GenerateSplitStrategy(modes.first, parallel_mode, dev_num);
+    if (!split_strategy.strategys.empty()) {
+      split_strategys[modes.first] = split_strategy;
+    }
   }
-  std::vector<std::vector<int64_t>> split_feature_map;
-  std::vector<std::vector<int64_t>> split_weight;
-  switch (parallel_mode) {
-    case SplitN:
-      split_feature_map = {kSplitRatio, kSplitDefaultRatio, kSplitDefaultRatio, kSplitDefaultRatio};
-      split_weight = {kSplitDefaultRatio, kSplitDefaultRatio, kSplitDefaultRatio, kSplitDefaultRatio};
-      break;
-    case SplitH:
-      split_feature_map = {kSplitDefaultRatio, kSplitRatio, kSplitDefaultRatio, kSplitDefaultRatio};
-      split_weight = {kSplitDefaultRatio, kSplitDefaultRatio, kSplitDefaultRatio, kSplitDefaultRatio};
-      break;
-    case SplitCIN:
-      split_feature_map = {kSplitDefaultRatio, kSplitDefaultRatio, kSplitDefaultRatio, kSplitRatio};
-      split_weight = {kSplitDefaultRatio, kSplitDefaultRatio, kSplitDefaultRatio, kSplitRatio};
-      break;
-    case SplitCOUT:
-      split_feature_map = {kSplitDefaultRatio, kSplitDefaultRatio, kSplitDefaultRatio, kSplitDefaultRatio};
-      split_weight = {kSplitRatio, kSplitDefaultRatio, kSplitDefaultRatio, kSplitDefaultRatio};
-      break;
-    default:
-      return split_strategys;
-  }
-  opt::Strategys strategys = {split_feature_map, split_weight};
-  split_strategys[opt::kSplitOp] = {strategys, kSplitDevTypes, kSplitDevTypes.size()};
   return split_strategys;
 }
+
+/**
+ * cost = flops / branches + bytes copied by the split and concat (or AddN) nodes + overhead per branch
+ * a node is split only if some mode beats running it unsplit, so small and memory bound ops stay as they are
+ **/
+SplitMode ChooseSplitMode(const std::string &op_type, const std::vector<ShapeVector> &input_shapes,
+                          const std::vector<ShapeVector> &output_shapes, size_t dev_num) {
+  auto modes = kSupportSplitModes.find(op_type);
+  if (modes == kSupportSplitModes.end() || dev_num < 2 || input_shapes.empty() || output_shapes.size() != 1) {
+    return NoSplit;
+  }
+  for (auto &shapes : {input_shapes, output_shapes}) {
+    for (auto &shape : shapes) {
+      if (std::any_of(shape.begin(), shape.end(), [](int64_t dim) { return dim <= 0; })) {
+        return NoSplit;
+      }
+    }
+  }
+  auto &output = output_shapes.front();
+  bool has_weight = op_type == kSplitOp || op_type == kSplitDepthwiseConv2D || op_type == kSplitFullConnection ||
+                    op_type == kSplitMatMul;
+  double feature_bytes = 0;
+  double weight_bytes = 0;
+  for (size_t i = 0; i < input_shapes.size(); i++) {
+    if (has_weight && i > 0) {
+      weight_bytes += ElementNum(input_shapes[i]) * kDataTypeSize;
+    } else {
+      feature_bytes += ElementNum(input_shapes[i]) * kDataTypeSize;
+    }
+  }
+  auto output_num = ElementNum(output);
+  auto output_bytes = output_num * kDataTypeSize;
+  auto flops = output_num * WorkPerOutput(op_type, input_shapes, output_num);
+  auto best_cost = flops / kFlopsPerUs;
+  auto best_mode = NoSplit;
+  for (auto mode : modes->second) {
+    int64_t dim = 0;
+    double copy_bytes = feature_bytes + output_bytes;
+    double redundant = 0;
+    switch (mode) {
+      case SplitN:
+        dim = output.front();
+        break;
+      case SplitH:
+        dim = output.size() == kConvAxisNum ? output[kConvAxisH] : 0;
+        // rows of the kernel window overlapping at every border
+        if (dim > 0 && input_shapes.size() > 1 && input_shapes[1].size() == kConvAxisNum) {
+          redundant = static_cast<double>((input_shapes[1][kConvAxisH] - 1) * (dev_num - 1)) / dim;
+        }
+        break;
+      case SplitCIN:
+        dim = input_shapes.front().back();
+        copy_bytes = feature_bytes + weight_bytes + output_bytes * dev_num;
+        break;
+      default:
+        dim = output.back();
+        copy_bytes = (has_weight && op_type != kSplitDepthwiseConv2D ? 0 : feature_bytes) + weight_bytes + output_bytes;
+        break;
+    }
+    if (dim < static_cast<int64_t>(dev_num)) {
+      continue;
+    }
+    auto cost =
+      flops * (1 + redundant) / dev_num / kFlopsPerUs + copy_bytes / kBytesPerUs + dev_num * kBranchOverheadUs;
+    if (cost < best_cost) {
+      best_cost = cost;
+      best_mode = mode;
+    }
+  }
+  return best_mode;
+}
 }  // namespace opt
 }  // namespace mindspore
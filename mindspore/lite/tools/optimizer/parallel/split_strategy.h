@@ -17,6 +17,7 @@
 #include <vector>
 #include <string>
 #include <unordered_map>
+#include "utils/shape_utils.h"
 #ifndef MINDSPORE_LITE_SRC_PASS_PARALLEL_SPLIT_STRATEGY_H_
 #define MINDSPORE_LITE_SRC_PASS_PARALLEL_SPLIT_STRATEGY_H_
 
@@ -29,12 +30,16 @@ constexpr auto DEV_TYPE = "dev_type";
 constexpr auto PARALLEL_NAME_SUFFIX = "_parallel";
 
 constexpr auto kSplitOp = "Conv2D";
+constexpr auto kSplitDepthwiseConv2D = "DepthwiseConv2D";
+constexpr auto kSplitFullConnection = "FullConnection";
+constexpr auto kSplitMatMul = "MatMul";
+constexpr auto kSplitPooling = "Pooling";
+constexpr auto kSplitElementwise = "Elementwise";
 
-const std::vector<int64_t> kSplitRatio = {1, 1};
+// branches of a split node run on the cpu cores of the target, in parallel only when the session enables it
+constexpr auto kSplitDevType = "CPU";
 
-const std::vector<int64_t> kSplitDefaultRatio = {0, 0};
-
-const std::vector<std::string> kSplitDevTypes = {"CPU", "GPU"};
+constexpr size_t kSplitDefaultDevNum = 2;
 
 using Strategys = std::vector<std::vector<std::vector<int64_t>>>;
 
@@ -44,6 +49,18 @@ enum SplitMode {
   SplitCIN = 2,
   SplitCOUT = 3,
   NoSplit = 4,
+  // the cost model picks the split mode of every node from its shapes
+  SplitAuto = 5,
+};
+
+// split modes every operator type supports, the channel of depthwise conv, pooling and elementwise ops is SplitCOUT
+const std::unordered_map<std::string, std::vector<SplitMode>> kSupportSplitModes = {
+  {kSplitOp, {SplitN, SplitH, SplitCIN, SplitCOUT}},
+  {kSplitDepthwiseConv2D, {SplitN, SplitH, SplitCOUT}},
+  {kSplitFullConnection, {SplitN, SplitCIN, SplitCOUT}},
+  {kSplitMatMul, {SplitN, SplitCIN, SplitCOUT}},
+  {kSplitPooling, {SplitN, SplitCOUT}},
+  {kSplitElementwise, {SplitN, SplitCOUT}},
 };
 
 struct SplitStrategy {
@@ -52,7 +69,19 @@ struct SplitStrategy {
   size_t dev_num;
 };
 
-std::unordered_map<std::string, opt::SplitStrategy> ParserSplitStrategy(SplitMode parallel_mode);
+// strategies of all operator types supporting parallel_mode, splitting them into dev_num equal branches. in SplitAuto
+// mode the strategys are left empty and generated per node from the mode chosen by ChooseSplitMode
+std::unordered_map<std::string, opt::SplitStrategy> ParserSplitStrategy(SplitMode parallel_mode,
+                                                                         size_t dev_num = kSplitDefaultDevNum);
+
+// split strategy of op_type in split_mode into dev_num equal branches, strategys is empty if op_type does not support
+// split_mode
+SplitStrategy GenerateSplitStrategy(const std::string &op_type, SplitMode split_mode,
+                                    size_t dev_num = kSplitDefaultDevNum);
+
+// estimate the latency of op_type unsplit and in every supported split mode, return the cheapest one
+SplitMode ChooseSplitMode(const std::string &op_type, const std::vector<ShapeVector> &input_shapes,
+                          const std::vector<ShapeVector> &output_shapes, size_t dev_num);
 
 }  // namespace opt
 }  // namespace mindspore
@@ -0,0 +1,306 @@
+/**
+ * Copyright 2021 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "tools/serving/batching_server.h"
+#include <algorithm>
+#include <cstring>
+#include <new>
+#include <string>
+#include <utility>
+#include "include/errorcode.h"
+#include "src/common/log_adapter.h"
+
+namespace mindspore {
+namespace session {
+BatchingServer *BatchingServer::CreateBatchingServer(const ServingConfig &config) {
+  auto server = new (std::nothrow) lite::BatchingServer(config);
+  if (server == nullptr) {
+    MS_LOG(ERROR) << "new batching server failed";
+  }
+  return server;
+}
+}  // namespace session
+
+namespace lite {
+BatchingServer::~BatchingServer() { Stop(); }
+
+int BatchingServer::ResizeBatch(session::LiteSession *session, int batch) {
+  auto inputs = session->GetInputs();
+  std::vector<std::vector<int>> dims = input_shapes_;
+  bool same = true;
+  for (size_t i = 0; i < inputs.size(); i++) {
+    dims[i][0] = batch;
+    same = same && inputs[i]->shape() == dims[i];
+  }
+  if (same) {
+    return RET_OK;
+  }
+  auto ret = session->Resize(inputs, dims);
+  if (ret != RET_OK) {
+    MS_LOG(ERROR) << "resize session to batch " << batch << " failed";
+  }
+  return ret;
+}
+
+int BatchingServer::CreateSession(int batch, session::LiteSession **session) {
+  auto new_session = session::LiteSession::CreateSession(context_);
+  if (new_session == nullptr) {
+    MS_LOG(ERROR) << "create session failed";
+    return RET_ERROR;
+  }
+  auto ret = new_session->CompileGraph(model_.get());
+  if (ret != RET_OK) {
+    MS_LOG(ERROR) << "compile graph failed";
+    delete new_session;
+    return ret;
+  }
+  if (input_shapes_.empty()) {
+    for (auto input : new_session->GetInputs()) {
+      if (input->shape().empty() || input->shape()[0] <= 0) {
+        MS_LOG(ERROR) << "input " << input->tensor_name() << " has no batch dim";
+        delete new_session;
+        return RET_INPUT_TENSOR_ERROR;
+      }
+      input_shapes_.push_back(input->shape());
+    }
+  }
+  ret = ResizeBatch(new_session, batch);
+  if (ret != RET_OK) {
+    delete new_session;
+    return ret;
+  }
+  *session = new_session;
+  return RET_OK;
+}
+
+int BatchingServer::Init(const char *model_buf, size_t size, const Context *context) {
+  if (model_buf == nullptr || context == nullptr || config_.max_batch < 1 || config_.worker_num < 1 ||
+      config_.max_delay_us < 0) {
+    MS_LOG(ERROR) << "invalid serving config, max batch: " << config_.max_batch
+                  << ", worker num: " << config_.worker_num << ", max delay: " << config_.max_delay_us;
+    return RET_PARAM_INVALID;
+  }
+  auto &buckets = config_.batch_buckets;
+  std::sort(buckets.begin(), buckets.end());
+  buckets.erase(std::unique(buckets.begin(), buckets.end()), buckets.end());
+  if (!buckets.empty()) {
+    if (buckets.front() < 1) {
+      MS_LOG(ERROR) << "batch bucket should be positive";
+      return RET_PARAM_INVALID;
+    }
+    config_.max_batch = std::min(config_.max_batch, buckets.back());
+  }
+  context_ = context;
+  model_ = std::shared_ptr<Model>(Model::Import(model_buf, size));
+  if (model_ == nullptr) {
+    MS_LOG(ERROR) << "import model failed";
+    return RET_ERROR;
+  }
+  for (int i = 0; i < config_.worker_num; i++) {
+    auto worker = std::make_unique<Worker>();
+    auto batches = buckets.empty() ? std::vector<int>{config_.max_batch} : buckets;
+    for (auto batch : batches) {
+      session::LiteSession *session = nullptr;
+      auto ret = CreateSession(batch, &session);
+      if (ret != RET_OK) {
+        for (auto &item : worker->sessions) {
+          delete item.second;
+        }
+        Stop();
+        return ret;
+      }
+      worker->sessions[batch] = session;
+    }
+    workers_.push_back(std::move(worker));
+  }
+  auto inputs = workers_.front()->sessions.begin()->second->GetInputs();
+  auto batch = workers_.front()->sessions.begin()->first;
+  for (auto input : inputs) {
+    input_sample_size_.push_back(input->Size() / batch);
+  }
+  for (auto &worker : workers_) {
+    auto worker_ptr = worker.get();
+    worker->thread = std::thread([this, worker_ptr]() { WorkerRun(worker_ptr); });
+  }
+  MS_LOG(INFO) << "batching server started, workers: " << config_.worker_num << ", max batch: " << config_.max_batch
+               << ", max delay: " << config_.max_delay_us << "us, buckets: " << buckets.size();
+  return RET_OK;
+}
+
+void BatchingServer::Stop() {
+  {
+    std::lock_guard<std::mutex> guard(lock_);
+    stopped_ = true;
+  }
+  cond_.notify_all();
+  for (auto &worker : workers_) {
+    if (worker->thread.joinable()) {
+      worker->thread.join();
+    }
+    for (auto &item : worker->sessions) {
+      delete item.second;
+    }
+    worker->sessions.clear();
+  }
+  workers_.clear();
+  std::lock_guard<std::mutex> guard(lock_);
+  for (auto &request : queue_) {
+    request->done.set_value(RET_ERROR);
+  }
+  queue_.clear();
+}
+
+std::future<int> BatchingServer::PredictAsync(SampleData inputs, SampleData *outputs) {
+  auto request = std::make_unique<Request>();
+  auto future = request->done.get_future();
+  if (outputs == nullptr || inputs.size() != input_sample_size_.size()) {
+    MS_LOG(ERROR) << "request has " << inputs.size() << " inputs, model has " << input_sample_size_.size();
+    request->done.set_value(RET_INPUT_PARAM_INVALID);
+    return future;
+  }
+  for (size_t i = 0; i < inputs.size(); i++) {
+    if (inputs[i].size() != input_sample_size_[i]) {
+      MS_LOG(ERROR) << "size of input " << i << " is " << inputs[i].size() << ", expect " << input_sample_size_[i];
+      request->done.set_value(RET_INPUT_PARAM_INVALID);
+      return future;
+    }
+  }
+  request->inputs = std::move(inputs);
+  request->outputs = outputs;
+  request->arrival = std::chrono::steady_clock::now();
+  {
+    std::lock_guard<std::mutex> guard(lock_);
+    if (stopped_) {
+      request->done.set_value(RET_ERROR);
+      return future;
+    }
+    queue_.push_back(std::move(request));
+  }
+  cond_.notify_one();
+  return future;
+}
+
+ServingStat BatchingServer::stat() {
+  std::lock_guard<std::mutex> guard(lock_);
+  return stat_;
+}
+
+int BatchingServer::PopBatch(std::vector<std::unique_ptr<Request>> *batch) {
+  std::unique_lock<std::mutex> lock(lock_);
+  auto max_batch = static_cast<size_t>(config_.max_batch);
+  auto max_delay = std::chrono::microseconds(config_.max_delay_us);
+  while (true) {
+    cond_.wait(lock, [this]() { return stopped_ || !queue_.empty(); });
+    if (stopped_) {
+      return RET_ERROR;
+    }
+    // the batch closes when it is full or when the oldest request reaches its deadline, the oldest request is
+    // looked up again after every wait since other workers may have taken the one seen before
+    auto deadline = queue_.front()->arrival + max_delay;
+    if (queue_.size() >= max_batch || std::chrono::steady_clock::now() >= deadline) {
+      break;
+    }
+    (void)cond_.wait_until(lock, deadline);
+  }
+  auto num = std::min(max_batch, queue_.size());
+  for (size_t i = 0; i < num; i++) {
+    batch->push_back(std::move(queue_.front()));
+    queue_.pop_front();
+  }
+  if (!queue_.empty()) {
+    // wake up another worker for the rest
+    cond_.notify_one();
+  }
+  return RET_OK;
+}
+
+int BatchingServer::RunBatch(Worker *worker, std::vector<std::unique_ptr<Request>> *batch) {
+  int num = static_cast<int>(batch->size());
+  if (num == 0) {
+    MS_LOG(ERROR) << "run an empty batch";
+    return RET_ERROR;
+  }
+  session::LiteSession *session = nullptr;
+  int session_batch = num;
+  if (config_.batch_buckets.empty()) {
+    session = worker->sessions.begin()->second;
+    auto ret = ResizeBatch(session, num);
+    if (ret != RET_OK) {
+      return ret;
+    }
+  } else {
+    auto iter = worker->sessions.lower_bound(num);
+    if (iter == worker->sessions.end()) {
+      MS_LOG(ERROR) << "no batch bucket holds " << num << " requests";
+      return RET_ERROR;
+    }
+    session = iter->second;
+    session_batch = iter->first;
+  }
+  auto inputs = session->GetInputs();
+  for (size_t i = 0; i < inputs.size(); i++) {
+    auto data = reinterpret_cast<char *>(inputs[i]->MutableData());
+    if (data == nullptr) {
+      MS_LOG(ERROR) << "malloc input data failed";
+      return RET_ERROR;
+    }
+    auto sample_size = input_sample_size_[i];
+    for (int j = 0; j < num; j++) {
+      memcpy(data + j * sample_size, batch->at(j)->inputs[i].data(), sample_size);
+    }
+    if (session_batch > num) {
+      memset(data + num * sample_size, 0, (session_batch - num) * sample_size);
+    }
+  }
+  auto ret = session->RunGraph();
+  if (ret != RET_OK) {
+    MS_LOG(ERROR) << "run batch of " << num << " failed";
+    return ret;
+  }
+  auto names = session->GetOutputTensorNames();
+  for (auto &request : *batch) {
+    request->outputs->resize(names.size());
+  }
+  for (size_t i = 0; i < names.size(); i++) {
+    auto output = session->GetOutputByTensorName(names[i]);
+    auto data = reinterpret_cast<const char *>(output->MutableData());
+    auto sample_size = output->Size() / session_batch;
+    for (int j = 0; j < num; j++) {
+      auto &dst = batch->at(j)->outputs->at(i);
+      dst.assign(data + j * sample_size, data + (j + 1) * sample_size);
+    }
+  }
+  std::lock_guard<std::mutex> guard(lock_);
+  stat_.batch_num++;
+  stat_.sample_num += num;
+  stat_.padded_num += session_batch - num;
+  return RET_OK;
+}
+
+void BatchingServer::WorkerRun(Worker *worker) {
+  while (true) {
+    std::vector<std::unique_ptr<Request>> batch;
+    if (PopBatch(&batch) != RET_OK) {
+      return;
+    }
+    auto ret = RunBatch(worker, &batch);
+    for (auto &request : batch) {
+      request->done.set_value(ret);
+    }
+  }
+}
+}  // namespace lite
+}  // namespace mindspore
@@ -0,0 +1,87 @@
+/**
+ * Copyright 2021 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MINDSPORE_LITE_TOOLS_SERVING_BATCHING_SERVER_H_
+#define MINDSPORE_LITE_TOOLS_SERVING_BATCHING_SERVER_H_
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "include/context.h"
+#include "include/lite_session.h"
+#include "include/model.h"
+#include "include/serving/batching_server.h"
+
+namespace mindspore::lite {
+using session::SampleData;
+using session::ServingConfig;
+using session::ServingStat;
+
+class BatchingServer : public session::BatchingServer {
+ public:
+  explicit BatchingServer(const ServingConfig &config) : config_(config) {}
+  ~BatchingServer() override;
+
+  int Init(const char *model_buf, size_t size, const Context *context) override;
+
+  void Stop() override;
+
+  std::future<int> PredictAsync(SampleData inputs, SampleData *outputs) override;
+
+  const std::vector<size_t> &input_sample_size() const override { return input_sample_size_; }
+
+  ServingStat stat() override;
+
+ private:
+  struct Request {
+    SampleData inputs;
+    SampleData *outputs = nullptr;
+    std::promise<int> done;
+    std::chrono::steady_clock::time_point arrival;
+  };
+
+  struct Worker {
+    // batch size to the session compiled for it
+    std::map<int, session::LiteSession *> sessions;
+    std::thread thread;
+  };
+
+  int CreateSession(int batch, session::LiteSession **session);
+  int ResizeBatch(session::LiteSession *session, int batch);
+  int PopBatch(std::vector<std::unique_ptr<Request>> *batch);
+  int RunBatch(Worker *worker, std::vector<std::unique_ptr<Request>> *batch);
+  void WorkerRun(Worker *worker);
+
+  ServingConfig config_;
+  const Context *context_ = nullptr;
+  std::shared_ptr<Model> model_;
+  std::vector<std::vector<int>> input_shapes_;
+  std::vector<size_t> input_sample_size_;
+  std::vector<std::unique_ptr<Worker>> workers_;
+  std::mutex lock_;
+  std::condition_variable cond_;
+  std::deque<std::unique_ptr<Request>> queue_;
+  bool stopped_ = false;
+  ServingStat stat_;
+};
+}  // namespace mindspore::lite
+#endif  // MINDSPORE_LITE_TOOLS_SERVING_BATCHING_SERVER_H_
@@ -0,0 +1,192 @@
+/**
+ * Copyright 2021 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "tools/serving/serving_benchmark.h"
+#include <algorithm>
+#include <cstdio>
+#include <iostream>
+#include <random>
+#include <thread>
+#include "include/errorcode.h"
+#include "src/common/file_utils.h"
+#include "src/common/log_adapter.h"
+#include "src/common/utils.h"
+
+namespace mindspore::lite {
+namespace {
+constexpr double kPercentile50 = 0.5;
+constexpr double kPercentile99 = 0.99;
+
+std::vector<int> ParseIntList(const std::string &str) {
+  std::vector<int> values;
+  for (auto &item : StrSplit(str, ",")) {
+    if (!item.empty()) {
+      values.push_back(std::stoi(item));
+    }
+  }
+  return values;
+}
+
+double Percentile(const std::vector<uint64_t> &sorted, double percent) {
+  if (sorted.empty()) {
+    return 0;
+  }
+  auto index = std::min(sorted.size() - 1, static_cast<size_t>(percent * sorted.size()));
+  return sorted[index] / 1000.0;
+}
+}  // namespace
+
+int ServingBenchmark::Init() {
+  if (flags_->model_file_.empty()) {
+    std::cerr << "modelPath is required" << std::endl;
+    return RET_ERROR;
+  }
+  if (flags_->num_threads_ < 1 || flags_->request_num_ < 1) {
+    std::cerr << "numThreads and requestNum must be greater than 0" << std::endl;
+    return RET_ERROR;
+  }
+  session::ServingConfig config;
+  config.max_batch = flags_->max_batch_;
+  config.max_delay_us = flags_->max_delay_us_;
+  config.worker_num = flags_->worker_num_;
+  try {
+    config.batch_buckets = ParseIntList(flags_->batch_buckets_in_);
+    client_nums_ = ParseIntList(flags_->client_nums_in_);
+  } catch (const std::exception &e) {
+    std::cerr << "parse batchBuckets or clientNums failed: " << e.what() << std::endl;
+    return RET_ERROR;
+  }
+  if (client_nums_.empty() || *std::min_element(client_nums_.begin(), client_nums_.end()) < 1) {
+    std::cerr << "clientNums must be positive" << std::endl;
+    return RET_ERROR;
+  }
+
+  context_ = std::make_shared<Context>();
+  context_->thread_num_ = flags_->num_threads_;
+  // workers share the cores, binding would put all of them on the same ones
+  context_->device_list_[0].device_info_.cpu_device_info_.cpu_bind_mode_ = NO_BIND;
+  size_t size = 0;
+  char *model_buf = ReadFile(flags_->model_file_.c_str(), &size);
+  if (model_buf == nullptr) {
+    std::cerr << "Read model file failed: " << flags_->model_file_ << std::endl;
+    return RET_ERROR;
+  }
+  server_.reset(session::BatchingServer::CreateBatchingServer(config));
+  if (server_ == nullptr) {
+    delete[](model_buf);
+    std::cerr << "Create batching server failed" << std::endl;
+    return RET_ERROR;
+  }
+  auto ret = server_->Init(model_buf, size, context_.get());
+  delete[](model_buf);
+  if (ret != RET_OK) {
+    std::cerr << "Init batching server failed: " << ret << std::endl;
+    return ret;
+  }
+  return RET_OK;
+}
+
+int ServingBenchmark::RunLoad(int client_num) {
+  std::vector<std::vector<uint64_t>> latencies(client_num);
+  std::vector<int> results(client_num, RET_OK);
+  auto stat_begin = server_->stat();
+  auto begin = GetTimeUs();
+  std::vector<std::thread> clients;
+  for (int c = 0; c < client_num; c++) {
+    clients.emplace_back([this, c, &latencies, &results]() {
+      std::mt19937 random_engine(c);
+      std::uniform_int_distribution<int> distribution(0, UINT8_MAX);
+      session::SampleData inputs;
+      for (auto size : server_->input_sample_size()) {
+        std::vector<char> data(size);
+        std::generate(data.begin(), data.end(), [&]() { return static_cast<char>(distribution(random_engine)); });
+        inputs.push_back(std::move(data));
+      }
+      session::SampleData outputs;
+      for (int i = 0; i < flags_->request_num_; i++) {
+        auto start = GetTimeUs();
+        auto ret = server_->Predict(inputs, &outputs);
+        if (ret != RET_OK) {
+          results[c] = ret;
+          return;
+        }
+        latencies[c].push_back(GetTimeUs() - start);
+      }
+    });
+  }
+  for (auto &client : clients) {
+    client.join();
+  }
+  auto wall = std::max<uint64_t>(GetTimeUs() - begin, 1);
+  for (auto ret : results) {
+    if (ret != RET_OK) {
+      std::cerr << "Predict failed: " << ret << std::endl;
+      return ret;
+    }
+  }
+  std::vector<uint64_t> all;
+  for (auto &latency : latencies) {
+    all.insert(all.end(), latency.begin(), latency.end());
+  }
+  std::sort(all.begin(), all.end());
+  auto stat_end = server_->stat();
+  auto batch_num = std::max<uint64_t>(stat_end.batch_num - stat_begin.batch_num, 1);
+  auto avg_batch = static_cast<double>(stat_end.sample_num - stat_begin.sample_num) / batch_num;
+  auto padded = static_cast<double>(stat_end.padded_num - stat_begin.padded_num) / batch_num;
+  printf("%-10d%16.2f%12.3f%12.3f%12.2f%12.2f\n", client_num, all.size() / (wall / 1e6), Percentile(all, kPercentile50),
+         Percentile(all, kPercentile99), avg_batch, padded);
+  return RET_OK;
+}
+
+int ServingBenchmark::Run() {
+  printf("-------------------------------------------------------------------------\n");
+  printf("%-10s%16s%12s%12s%12s%12s\n", "clients", "throughput(/s)", "p50(ms)", "p99(ms)", "avgBatch", "avgPadded");
+  for (auto client_num : client_nums_) {
+    auto ret = RunLoad(client_num);
+    if (ret != RET_OK) {
+      return ret;
+    }
+  }
+  server_->Stop();
+  return RET_OK;
+}
+
+int RunServingBenchmark(int argc, const char **argv) {
+  ServingBenchmarkFlags flags;
+  Option<std::string> err = flags.ParseFlags(argc, argv);
+  if (err.IsSome()) {
+    std::cerr << err.Get() << std::endl;
+    std::cerr << flags.Usage() << std::endl;
+    return RET_ERROR;
+  }
+  if (flags.help) {
+    std::cerr << flags.Usage() << std::endl;
+    return RET_OK;
+  }
+  ServingBenchmark benchmark(&flags);
+  auto status = benchmark.Init();
+  if (status != RET_OK) {
+    MS_LOG(ERROR) << "Serving benchmark init failed: " << status;
+    return RET_ERROR;
+  }
+  status = benchmark.Run();
+  if (status != RET_OK) {
+    MS_LOG(ERROR) << "Run serving benchmark failed: " << status;
+    return RET_ERROR;
+  }
+  return RET_OK;
+}
+}  // namespace mindspore::lite
@@ -0,0 +1,76 @@
+/**
+ * Copyright 2021 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MINDSPORE_LITE_TOOLS_SERVING_SERVING_BENCHMARK_H_
+#define MINDSPORE_LITE_TOOLS_SERVING_SERVING_BENCHMARK_H_
+
+#include <memory>
+#include <string>
+#include <vector>
+#include "tools/common/flag_parser.h"
+#include "include/serving/batching_server.h"
+
+namespace mindspore::lite {
+class ServingBenchmarkFlags : public virtual FlagParser {
+ public:
+  ServingBenchmarkFlags() {
+    AddFlag(&ServingBenchmarkFlags::model_file_, "modelFile", "Input model file", "");
+    AddFlag(&ServingBenchmarkFlags::num_threads_, "numThreads", "Threads of each session", 2);
+    AddFlag(&ServingBenchmarkFlags::worker_num_, "workerNum", "Sessions running batches concurrently", 1);
+    AddFlag(&ServingBenchmarkFlags::max_batch_, "maxBatch", "Most requests in one batch", 8);
+    AddFlag(&ServingBenchmarkFlags::max_delay_us_, "maxDelayUs", "Longest wait of a request for its batch", 2000);
+    AddFlag(&ServingBenchmarkFlags::batch_buckets_in_, "batchBuckets",
+            "Batch sizes compiled ahead of time, e.g. 1,2,4,8, empty to resize to every batch", "");
+    AddFlag(&ServingBenchmarkFlags::client_nums_in_, "clientNums", "Concurrent clients of each load level",
+            "1,2,4,8,16");
+    AddFlag(&ServingBenchmarkFlags::request_num_, "requestNum", "Requests sent by each client", 100);
+  }
+
+  ~ServingBenchmarkFlags() override = default;
+
+ public:
+  std::string model_file_;
+  int num_threads_ = 2;
+  int worker_num_ = 1;
+  int max_batch_ = 8;
+  int max_delay_us_ = 2000;
+  std::string batch_buckets_in_;
+  std::string client_nums_in_ = "1,2,4,8,16";
+  int request_num_ = 100;
+};
+
+// closed loop load generator, every client sends its next request when the last one returns
+class ServingBenchmark {
+ public:
+  explicit ServingBenchmark(ServingBenchmarkFlags *flags) : flags_(flags) {}
+  ~ServingBenchmark() = default;
+
+  int Init();
+
+  int Run();
+
+ private:
+  int RunLoad(int client_num);
+
+  ServingBenchmarkFlags *flags_;
+  std::vector<int> client_nums_;
+  std::unique_ptr<session::BatchingServer> server_;
+  std::shared_ptr<Context> context_;
+};
+
+int RunServingBenchmark(int argc, const char **argv);
+}  // namespace mindspore::lite
+#endif  // MINDSPORE_LITE_TOOLS_SERVING_SERVING_BENCHMARK_H_
@@ -0,0 +1,131 @@
+# Copyright 2021 Huawei Technologies Co., Ltd
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+# http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+# ============================================================================
+""" test graphs of CPU on the actor runtime, control flow falls back to the segment VM """
+import numpy as np
+import pytest
+
+import mindspore.context as context
+import mindspore.nn as nn
+from mindspore import Tensor
+from mindspore.nn import Cell, Dense, TrainOneStepCell, WithLossCell
+from mindspore.nn.optim import Momentum
+import mindspore.ops.operations as P
+
+
+class IfWhileNet(Cell):
+    def __init__(self):
+        super().__init__()
+        self.add = P.Add()
+        self.mul = P.Mul()
+        self.reduce_sum = P.ReduceSum()
+
+    def construct(self, x, y):
+        if self.reduce_sum(x) > self.reduce_sum(y):
+            out = self.mul(x, y)
+        else:
+            out = self.add(x, y)
+        while self.reduce_sum(out) < 100:
+            out = self.add(out, out)
+        return out
+
+
+class WideNet(Cell):
+    def __init__(self):
+        super().__init__()
+        self.add = P.Add()
+        self.mul = P.Mul()
+        self.sub = P.Sub()
+        self.relu = P.ReLU()
+
+    def construct(self, x, y):
+        a = self.relu(self.add(x, y))
+        b = self.relu(self.mul(x, y))
+        c = self.relu(self.sub(x, y))
+        return self.add(self.add(a, b), c)
+
+
+class MlpNet(Cell):
+    def __init__(self):
+        super().__init__()
+        self.fc1 = Dense(8, 32)
+        self.relu = P.ReLU()
+        self.fc2 = Dense(32, 2)
+
+    def construct(self, x):
+        return self.fc2(self.relu(self.fc1(x)))
+
+
+def if_while_expect(x, y):
+    out = x * y if x.sum() > y.sum() else x + y
+    while out.sum() < 100:
+        out = out + out
+    return out
+
+
+def wide_expect(x, y):
+    return np.maximum(x + y, 0) + np.maximum(x * y, 0) + np.maximum(x - y, 0)
+
+
+@pytest.mark.level0
+@pytest.mark.platform_x86_cpu
+@pytest.mark.env_onecard
+def test_cpu_mindrt_control_flow():
+    context.set_context(mode=context.GRAPH_MODE, device_target="CPU")
+    net = IfWhileNet()
+    for seed in range(3):
+        np.random.seed(seed)
+        x = np.random.rand(2, 3).astype(np.float32) + 0.1
+        y = np.random.rand(2, 3).astype(np.float32) + 0.1
+        output = net(Tensor(x), Tensor(y))
+        assert np.allclose(output.asnumpy(), if_while_expect(x, y), rtol=1e-5)
+
+
+@pytest.mark.level0
+@pytest.mark.platform_x86_cpu
+@pytest.mark.env_onecard
+def test_cpu_mindrt_wide_graph():
+    context.set_context(mode=context.GRAPH_MODE, device_target="CPU")
+    net = WideNet()
+    x = np.random.randn(16, 32).astype(np.float32)
+    y = np.random.randn(16, 32).astype(np.float32)
+    output = net(Tensor(x), Tensor(y))
+    assert np.allclose(output.asnumpy(), wide_expect(x, y), rtol=1e-5)
+
+
+@pytest.mark.level0
+@pytest.mark.platform_x86_cpu
+@pytest.mark.env_onecard
+def test_cpu_mindrt_train():
+    """
+    The train and the eval graph alternate every step, so the kernels switch between the thread caps of the two
+    actor sets while training has to converge as before.
+    """
+    context.set_context(mode=context.GRAPH_MODE, device_target="CPU")
+    np.random.seed(1)
+    data = np.random.randn(64, 8).astype(np.float32)
+    label = (data[:, :4].sum(axis=1) > data[:, 4:].sum(axis=1)).astype(np.int32)
+    net = MlpNet()
+    criterion = nn.SoftmaxCrossEntropyWithLogits(sparse=True, reduction='mean')
+    optimizer = Momentum(filter(lambda x: x.requires_grad, net.get_parameters()), 0.1, 0.9)
+    train_network = TrainOneStepCell(WithLossCell(net, criterion), optimizer)
+    train_network.set_train()
+    losses = []
+    accuracies = []
+    for _ in range(40):
+        losses.append(train_network(Tensor(data), Tensor(label)).asnumpy())
+        logits = net(Tensor(data)).asnumpy()
+        accuracies.append((logits.argmax(axis=1) == label).mean())
+    assert losses[-1] < losses[0] * 0.5
+    assert accuracies[-1] > 0.9
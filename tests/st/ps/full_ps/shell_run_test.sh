@@ -49,7 +49,8 @@ do
   rm -rf ${execute_path}/worker_$i/
   mkdir ${execute_path}/worker_$i/
   cd ${execute_path}/worker_$i/ || exit
-  python ${self_path}/../test_full_ps_lenet.py --device_target=$DEVICE_TARGET --dataset_path=$DATASET_PATH &
+  python ${self_path}/../test_full_ps_lenet.py --device_target=$DEVICE_TARGET --dataset_path=$DATASET_PATH \
+    > worker.log 2>&1 &
   process_pid[${i}]=`echo $!`
 done
 
@@ -58,6 +59,7 @@ for((i=0; i<${MS_WORKER_NUM}; i++)); do
     status=`echo $?`
     if [ "${status}" != "0" ]; then
         echo "[ERROR] test_full_ps_lenet failed. status: ${status}"
+        cat ${execute_path}/worker_$i/worker.log
         exit 1
     else
         echo "[INFO] test_full_ps_lenet success."
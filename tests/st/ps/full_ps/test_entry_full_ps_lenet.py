@@ -13,6 +13,8 @@
 # limitations under the License.
 # ============================================================================
 import os
+import re
+import json
 import pytest
 
 
@@ -25,3 +27,79 @@ def test_full_ps_ascend_lenet():
         "bash shell_run_test.sh Ascend /home/workspace/mindspore_dataset/mnist 1 1 127.0.0.1 8082"
     )
     assert return_code == 0
+
+
+@pytest.mark.level0
+@pytest.mark.platform_arm_ascend_training
+@pytest.mark.platform_x86_ascend_training
+@pytest.mark.env_onecard
+@pytest.mark.parametrize('compression', ['int8', 'topk'])
+def test_full_ps_ascend_lenet_grad_compression(compression):
+    return_code = os.system(
+        "MS_PS_GRAD_COMPRESSION=" + compression +
+        " bash shell_run_test.sh Ascend /home/workspace/mindspore_dataset/mnist 1 1 127.0.0.1 8083"
+    )
+    assert return_code == 0
+
+
+@pytest.mark.level0
+@pytest.mark.platform_x86_cpu
+@pytest.mark.env_onecard
+def test_full_ps_cpu_lenet_grad_push_window():
+    """
+    Scheduler, server and worker on 127.0.0.1 with synchronous gradient pushes and with two pushes in flight,
+    the step time of the worker is printed for both.
+    """
+    step_ms = {}
+    for window, port in ((0, 8084), (2, 8085)):
+        return_code = os.system(
+            "MS_GRAD_PUSH_WINDOW=" + str(window) +
+            " bash shell_run_test.sh CPU /home/workspace/mindspore_dataset/mnist 1 1 127.0.0.1 " + str(port)
+        )
+        assert return_code == 0
+        with open(os.path.join("worker_0", "result.json")) as f:
+            result = json.load(f)
+        assert result["accuracy"] > 0.90
+        step_ms[window] = result["step_ms"]
+    print("step time of the worker, synchronous pushes: {:.3f} ms, push window 2: {:.3f} ms".format(
+        step_ms[0], step_ms[2]))
+
+
+@pytest.mark.level0
+@pytest.mark.platform_x86_cpu
+@pytest.mark.env_onecard
+def test_full_ps_cpu_lenet_grad_compression():
+    """
+    Scheduler, server and worker on 127.0.0.1 without compression and with every gradient compressor, the bytes of
+    the pushed gradients and the accuracy of each compressor are printed against the uncompressed run.
+    """
+    results = {}
+    for port, compression in enumerate(['none', 'fp16', 'int8', 'topk', 'randomk'], 8086):
+        env = "GLOG_v=1 "
+        if compression != 'none':
+            env += "MS_PS_GRAD_COMPRESSION=" + compression + " "
+        return_code = os.system(
+            env + "bash shell_run_test.sh CPU /home/workspace/mindspore_dataset/mnist 1 1 127.0.0.1 " + str(port)
+        )
+        assert return_code == 0
+        with open(os.path.join("worker_0", "result.json")) as f:
+            accuracy = json.load(f)["accuracy"]
+        assert accuracy > 0.90
+        raw_bytes, compressed_bytes = None, None
+        if compression != 'none':
+            # logged by the worker when it finalizes
+            with open(os.path.join("worker_0", "worker.log")) as f:
+                match = re.search(r"The worker compressed \d+ gradients of (\d+) bytes into (\d+) bytes", f.read())
+            assert match is not None
+            raw_bytes, compressed_bytes = int(match.group(1)), int(match.group(2))
+            assert 0 < compressed_bytes < raw_bytes
+        results[compression] = (accuracy, raw_bytes, compressed_bytes)
+
+    print("{:<10}{:>12}{:>16}{:>18}{:>12}".format("compressor", "accuracy", "raw bytes", "compressed bytes",
+                                                  "reduction"))
+    for compression, (accuracy, raw_bytes, compressed_bytes) in results.items():
+        if compression == 'none':
+            print("{:<10}{:>12.4f}".format(compression, accuracy))
+        else:
+            print("{:<10}{:>12.4f}{:>16}{:>18}{:>11.1f}x".format(compression, accuracy, raw_bytes, compressed_bytes,
+                                                                 raw_bytes / compressed_bytes))
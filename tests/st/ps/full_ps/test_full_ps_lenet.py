@@ -14,6 +14,8 @@
 # ============================================================================
 
 import os
+import json
+import time
 import argparse
 
 import mindspore.context as context
@@ -25,7 +27,7 @@ from mindspore.common import dtype as mstype
 from mindspore.dataset.vision import Inter
 from mindspore.nn.metrics import Accuracy
 from mindspore.train import Model
-from mindspore.train.callback import LossMonitor
+from mindspore.train.callback import Callback, LossMonitor
 from mindspore.common.initializer import TruncatedNormal
 
 parser = argparse.ArgumentParser(description='test_ps_lenet')
@@ -85,6 +87,29 @@ class LeNet5(nn.Cell):
         x = self.fc3(x)
         return x
 
+class StepTimeMonitor(Callback):
+    """Mean step time in ms, leaving out the first steps which compile and warm up."""
+    def __init__(self, skip_steps=10):
+        super(StepTimeMonitor, self).__init__()
+        self.skip_steps = skip_steps
+        self.step_num = 0
+        self.total_time = 0.0
+        self.timed_steps = 0
+        self.step_start = 0.0
+
+    def step_begin(self, run_context):
+        self.step_start = time.time()
+
+    def step_end(self, run_context):
+        self.step_num += 1
+        if self.step_num > self.skip_steps:
+            self.total_time += time.time() - self.step_start
+            self.timed_steps += 1
+
+    def step_ms(self):
+        return self.total_time * 1000 / max(self.timed_steps, 1)
+
+
 def create_dataset(data_path, batch_size=32, repeat_size=1,
                    num_parallel_workers=1):
     """
@@ -129,10 +154,15 @@ if __name__ == "__main__":
     model = Model(network, net_loss, net_opt, metrics={"Accuracy": Accuracy()})
 
     ds_train = create_dataset(os.path.join(dataset_path, "train"), 32, 1)
-    model.train(1, ds_train, callbacks=[LossMonitor()], dataset_sink_mode=False)
+    step_time = StepTimeMonitor()
+    model.train(1, ds_train, callbacks=[LossMonitor(), step_time], dataset_sink_mode=False)
 
     ds_eval = create_dataset(os.path.join(dataset_path, "test"), 32, 1)
     acc = model.eval(ds_eval, dataset_sink_mode=False)
 
-    print("Accuracy:", acc['Accuracy'])
+    print("Accuracy:", acc['Accuracy'], "step time:", step_time.step_ms(), "ms")
+    # read by the entry tests comparing runs, from the directory of the worker
+    if os.getenv("MS_ROLE") == "MS_WORKER":
+        with open("result.json", "w") as f:
+            json.dump({"accuracy": acc['Accuracy'], "step_ms": step_time.step_ms()}, f)
     assert acc['Accuracy'] > 0.90
@@ -0,0 +1,40 @@
+/**
+ * Copyright 2021 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "common/fake_kernel.h"
+
+#include <memory>
+#include "backend/session/anf_runtime_algorithm.h"
+#include "runtime/device/kernel_info.h"
+
+namespace mindspore {
+using KernelBuildInfoBuilder = kernel::KernelBuildInfo::KernelBuildInfoBuilder;
+
+CNodePtr NewFakeKernel(const KernelGraphPtr &graph, const std::string &name, const std::vector<AnfNodePtr> &inputs) {
+  std::vector<AnfNodePtr> cnode_inputs = {NewValueNode(std::make_shared<Primitive>(name))};
+  cnode_inputs.insert(cnode_inputs.end(), inputs.begin(), inputs.end());
+  auto kernel = graph->NewCNode(cnode_inputs);
+  kernel->set_abstract(std::make_shared<abstract::AbstractTensor>(kFloat32, kFakeTensorShape));
+  KernelBuildInfoBuilder builder;
+  builder.SetInputsFormat(std::vector<std::string>(inputs.size(), kOpFormat_DEFAULT));
+  builder.SetInputsDeviceType(std::vector<TypeId>(inputs.size(), kNumberTypeFloat32));
+  builder.SetOutputsFormat({kOpFormat_DEFAULT});
+  builder.SetOutputsDeviceType({kNumberTypeFloat32});
+  builder.SetKernelType(KernelType::CPU_KERNEL);
+  AnfAlgo::SetSelectKernelBuildInfo(builder.Build(), kernel.get());
+  AnfAlgo::SetKernelMod(std::make_shared<FakeKernelMod>(inputs.size()), kernel.get());
+  return kernel;
+}
+}  // namespace mindspore
@@ -0,0 +1,52 @@
+/**
+ * Copyright 2021 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef TESTS_UT_CPP_COMMON_FAKE_KERNEL_H_
+#define TESTS_UT_CPP_COMMON_FAKE_KERNEL_H_
+#include <string>
+#include <vector>
+#include "backend/kernel_compiler/kernel.h"
+#include "backend/session/kernel_graph.h"
+
+namespace mindspore {
+// every tensor of the fake kernels is a [16, 16] float32 one
+constexpr size_t kFakeTensorSize = 1024;
+const ShapeVector kFakeTensorShape = {16, 16};
+
+// kernel mod of fake tensors which launches without doing anything
+class FakeKernelMod : public kernel::KernelMod {
+ public:
+  explicit FakeKernelMod(size_t input_num)
+      : input_size_list_(input_num, kFakeTensorSize), output_size_list_{kFakeTensorSize} {}
+  ~FakeKernelMod() override = default;
+
+  const std::vector<size_t> &GetInputSizeList() const override { return input_size_list_; }
+  const std::vector<size_t> &GetOutputSizeList() const override { return output_size_list_; }
+  const std::vector<size_t> &GetWorkspaceSizeList() const override { return workspace_size_list_; }
+  bool Launch(const std::vector<kernel::AddressPtr> &, const std::vector<kernel::AddressPtr> &,
+              const std::vector<kernel::AddressPtr> &, void *) override {
+    return true;
+  }
+
+ private:
+  std::vector<size_t> input_size_list_;
+  std::vector<size_t> output_size_list_;
+  std::vector<size_t> workspace_size_list_;
+};
+
+// CPU kernel of a fake tensor on the given inputs, which has no device address yet
+CNodePtr NewFakeKernel(const KernelGraphPtr &graph, const std::string &name, const std::vector<AnfNodePtr> &inputs);
+}  // namespace mindspore
+#endif  // TESTS_UT_CPP_COMMON_FAKE_KERNEL_H_
@@ -0,0 +1,182 @@
+/**
+ * Copyright 2021 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include "common/common_test.h"
+#include "common/thread_pool.h"
+
+namespace mindspore {
+namespace common {
+class TestThreadPool : public UT::Common {
+ public:
+  TestThreadPool() = default;
+};
+
+TEST_F(TestThreadPool, ParallelForCoversRange) {
+  const size_t count = 10007;
+  std::vector<int> visited(count, 0);
+  auto task = [&visited](size_t start, size_t end) {
+    for (size_t i = start; i < end; ++i) {
+      visited[i]++;
+    }
+  };
+  EXPECT_TRUE(ThreadPool::GetInstance().ParallelFor(task, count, 1));
+  EXPECT_TRUE(ThreadPool::GetInstance().ParallelFor(task, count, 4096));
+  for (auto v : visited) {
+    EXPECT_EQ(v, 2);
+  }
+}
+
+TEST_F(TestThreadPool, SyncRunReportsFailure) {
+  std::vector<Task> tasks = {[]() { return SUCCESS; }, []() { return FAIL; }, []() { return SUCCESS; }};
+  EXPECT_FALSE(ThreadPool::GetInstance().SyncRun(tasks));
+}
+
+TEST_F(TestThreadPool, NestedParallelFor) {
+  const size_t outer = 16;
+  const size_t inner = 1000;
+  std::atomic<size_t> sum{0};
+  auto task = [&sum](size_t start, size_t end) {
+    for (size_t i = start; i < end; ++i) {
+      ThreadPool::GetInstance().ParallelFor([&sum](size_t s, size_t e) { sum += e - s; }, inner, 8);
+    }
+  };
+  EXPECT_TRUE(ThreadPool::GetInstance().ParallelFor(task, outer, 1));
+  EXPECT_EQ(sum, outer * inner);
+}
+
+// contention microbenchmark: several callers issue small parallel loops at the same time, which the single
+// queued pool ran one caller after the other, so they have to finish no later than the same loops issued in turn
+TEST_F(TestThreadPool, ConcurrentCallers) {
+  const size_t caller_num = 8;
+  const size_t loop_num = 200;
+  const size_t count = 4096;
+  const size_t repeat = 5;
+  std::atomic<size_t> sum{0};
+  auto parallel_loops = [&sum]() {
+    for (size_t i = 0; i < loop_num; ++i) {
+      ThreadPool::GetInstance().ParallelFor([&sum](size_t start, size_t end) { sum += end - start; }, count, 64);
+    }
+  };
+  auto best_cost = [&](const std::function<void()> &run) {
+    auto best = std::chrono::microseconds::max();
+    for (size_t r = 0; r < repeat; ++r) {
+      auto begin = std::chrono::steady_clock::now();
+      run();
+      best = std::min(best, std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() -
+                                                                                  begin));
+    }
+    return best;
+  };
+  auto serial_cost = best_cost([&]() {
+    for (size_t c = 0; c < caller_num; ++c) {
+      parallel_loops();
+    }
+  });
+  auto concurrent_cost = best_cost([&]() {
+    std::vector<std::thread> callers;
+    for (size_t c = 0; c < caller_num; ++c) {
+      callers.emplace_back(parallel_loops);
+    }
+    for (auto &caller : callers) {
+      caller.join();
+    }
+  });
+  MS_LOG(INFO) << caller_num * loop_num << " parallel loops took " << serial_cost.count() << " us from one caller and "
+               << concurrent_cost.count() << " us from " << caller_num << " callers";
+  EXPECT_EQ(sum, 2 * repeat * caller_num * loop_num * count);
+  // without spare cores the callers only add switches, there is nothing to overlap
+  if (std::thread::hardware_concurrency() >= 4) {
+    EXPECT_LE(concurrent_cost.count(), serial_cost.count());
+  }
+}
+
+// the graph scheduler caps the threads of the kernels of every graph on a pool sized once
+TEST_F(TestThreadPool, ParallelThreadNumCapsCalls) {
+  auto &pool = ThreadPool::GetInstance();
+  auto origin_thread_num = pool.GetSyncRunThreadNum();
+  pool.SetSyncRunThreadNum(4);
+  const size_t count = 64;
+  for (size_t cap : {1, 2}) {
+    pool.SetParallelThreadNum(cap);
+    EXPECT_EQ(pool.GetSyncRunThreadNum(), cap);
+    std::atomic<size_t> running{0};
+    std::atomic<size_t> max_running{0};
+    std::atomic<size_t> sum{0};
+    auto task = [&](size_t start, size_t end) {
+      size_t now = ++running;
+      size_t seen = max_running;
+      while (now > seen && !max_running.compare_exchange_weak(seen, now)) {
+      }
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      sum += end - start;
+      --running;
+    };
+    EXPECT_TRUE(pool.ParallelFor(task, count, 1));
+    EXPECT_EQ(sum, count);
+    // the caller runs blocks besides the capped workers
+    EXPECT_LE(max_running, cap + 1);
+  }
+  pool.SetParallelThreadNum(0);
+  EXPECT_EQ(pool.GetSyncRunThreadNum(), 4);
+  pool.SetSyncRunThreadNum(origin_thread_num);
+}
+
+// resizing the pool waits for the callers still running parallel loops on it
+TEST_F(TestThreadPool, ResizeWaitsForCallers) {
+  auto &pool = ThreadPool::GetInstance();
+  auto origin_thread_num = pool.GetSyncRunThreadNum();
+  const size_t caller_num = 4;
+  const size_t loop_num = 100;
+  const size_t count = 1024;
+  std::atomic<size_t> sum{0};
+  std::vector<std::thread> callers;
+  for (size_t c = 0; c < caller_num; ++c) {
+    callers.emplace_back([&pool, &sum]() {
+      for (size_t i = 0; i < loop_num; ++i) {
+        pool.ParallelFor([&sum](size_t start, size_t end) { sum += end - start; }, count, 16);
+      }
+    });
+  }
+  for (size_t thread_num : {1, 3, 2, 4}) {
+    pool.SetSyncRunThreadNum(thread_num);
+    EXPECT_EQ(pool.GetSyncRunThreadNum(), thread_num);
+  }
+  for (auto &caller : callers) {
+    caller.join();
+  }
+  EXPECT_EQ(sum, caller_num * loop_num * count);
+
+  // a task can not resize the pool it runs on, it would wait for its own call
+  std::atomic<size_t> refused{0};
+  auto task = [&pool, &refused](size_t, size_t) {
+    try {
+      pool.SetSyncRunThreadNum(1);
+    } catch (std::runtime_error &) {
+      ++refused;
+    }
+  };
+  EXPECT_TRUE(pool.ParallelFor(task, 2, 1));
+  EXPECT_EQ(refused, 2);
+  pool.SetSyncRunThreadNum(origin_thread_num);
+}
+}  // namespace common
+}  // namespace mindspore
@@ -0,0 +1,130 @@
+/**
+ * Copyright 2021 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <cmath>
+#include <vector>
+#include "common/common_test.h"
+#define private public
+#define protected public
+#include "backend/kernel_compiler/cpu/embedding_look_up_segment_reduce_cpu_kernel.h"
+#undef private
+#undef protected
+
+namespace mindspore {
+namespace kernel {
+class EmbeddingLookUpSegmentReduceCpuKernelTest : public UT::Common {
+ public:
+  EmbeddingLookUpSegmentReduceCpuKernelTest() = default;
+
+  AddressPtr CreateKernelAddress(void *addr) {
+    auto kernel_addr = std::make_shared<Address>();
+    kernel_addr->addr = addr;
+    return kernel_addr;
+  }
+
+  // runs the kernel on a [first_dim_size, outer_dim_size] table and returns the [segment_num, outer_dim_size] output
+  template <typename T, typename S>
+  std::vector<float> Run(const std::vector<T> &table, size_t outer_dim_size, std::vector<S> indices,
+                         std::vector<S> segment_ids, size_t segment_num, int64_t offset) {
+    EmbeddingLookUpSegmentReduceCPUKernel<T> kernel;
+    kernel.offset_ = offset;
+    kernel.indices_lens_ = indices.size();
+    kernel.first_dim_size_ = table.size() / outer_dim_size;
+    kernel.outer_dim_size_ = outer_dim_size;
+    kernel.segment_num_ = segment_num;
+    kernel.indices_data_type_ = sizeof(S) == sizeof(int) ? kNumberTypeInt32 : kNumberTypeInt64;
+
+    std::vector<T> table_data(table);
+    std::vector<size_t> bag_offsets(segment_num + 1);
+    std::vector<size_t> positions(indices.size());
+    std::vector<float> output(segment_num * outer_dim_size, -1.0f);
+    std::vector<AddressPtr> inputs = {CreateKernelAddress(table_data.data()), CreateKernelAddress(indices.data()),
+                                      CreateKernelAddress(segment_ids.data())};
+    std::vector<AddressPtr> workspace = {CreateKernelAddress(bag_offsets.data()),
+                                         CreateKernelAddress(positions.data())};
+    std::vector<AddressPtr> outputs = {CreateKernelAddress(output.data())};
+    EXPECT_TRUE(kernel.Launch(inputs, workspace, outputs));
+    return output;
+  }
+
+  // UnsortedSegmentSum(EmbeddingLookup(table, indices, offset), segment_ids, segment_num)
+  template <typename T, typename S>
+  std::vector<float> Reference(const std::vector<T> &table, size_t outer_dim_size, const std::vector<S> &indices,
+                               const std::vector<S> &segment_ids, size_t segment_num, int64_t offset) {
+    int64_t first_dim_size = static_cast<int64_t>(table.size() / outer_dim_size);
+    std::vector<float> output(segment_num * outer_dim_size, 0.0f);
+    for (size_t i = 0; i < indices.size(); ++i) {
+      int64_t index = static_cast<int64_t>(indices[i]) - offset;
+      if (segment_ids[i] < 0 || static_cast<size_t>(segment_ids[i]) >= segment_num || index < 0 ||
+          index >= first_dim_size) {
+        continue;
+      }
+      for (size_t j = 0; j < outer_dim_size; ++j) {
+        output[segment_ids[i] * outer_dim_size + j] += static_cast<float>(table[index * outer_dim_size + j]);
+      }
+    }
+    return output;
+  }
+};
+
+TEST_F(EmbeddingLookUpSegmentReduceCpuKernelTest, sum_bags_int32) {
+  // 5 rows of 2
+  std::vector<float> table{0, 1, 10, 11, 20, 21, 30, 31, 40, 41};
+  // index 7 is out of the table and reads a zero row, segment id -1 drops the lookup, bag 3 is empty
+  std::vector<int> indices{0, 4, 1, 4, 7, 2};
+  std::vector<int> segment_ids{1, 0, 1, 2, 0, -1};
+  auto output = Run(table, 2, indices, segment_ids, 4, 0);
+  std::vector<float> expect{40, 41, 10, 12, 40, 41, 0, 0};
+  EXPECT_EQ(expect, output);
+}
+
+TEST_F(EmbeddingLookUpSegmentReduceCpuKernelTest, sum_bags_float16_int64_offset) {
+  std::vector<float16> table;
+  for (int i = 0; i < 6 * 3; ++i) {
+    table.push_back(float16(static_cast<float>(i)));
+  }
+  // the table holds the rows [2, 8) of the whole embedding
+  std::vector<int64_t> indices{2, 7, 1, 5, 8, 3};
+  std::vector<int64_t> segment_ids{0, 0, 1, 1, 1, 2};
+  auto output = Run(table, 3, indices, segment_ids, 3, 2);
+  auto expect = Reference(table, 3, indices, segment_ids, 3, 2);
+  EXPECT_EQ(expect, output);
+}
+
+TEST_F(EmbeddingLookUpSegmentReduceCpuKernelTest, sum_long_bags_match_lookup_and_segment_sum) {
+  // bags are longer than the prefetch distance and the segment ids are not sorted
+  const size_t first_dim_size = 37;
+  const size_t outer_dim_size = 20;
+  const size_t indices_size = 300;
+  const size_t segment_num = 7;
+  std::vector<float> table(first_dim_size * outer_dim_size);
+  for (size_t i = 0; i < table.size(); ++i) {
+    table[i] = static_cast<float>(i % 13) * 0.25f;
+  }
+  std::vector<int> indices(indices_size);
+  std::vector<int> segment_ids(indices_size);
+  for (size_t i = 0; i < indices_size; ++i) {
+    indices[i] = static_cast<int>(i * 17 % (first_dim_size + 3));
+    segment_ids[i] = static_cast<int>(i * 5 % segment_num);
+  }
+  auto output = Run(table, outer_dim_size, indices, segment_ids, segment_num, 0);
+  auto expect = Reference(table, outer_dim_size, indices, segment_ids, segment_num, 0);
+  ASSERT_EQ(expect.size(), output.size());
+  for (size_t i = 0; i < expect.size(); ++i) {
+    EXPECT_TRUE(std::fabs(expect[i] - output[i]) < 1e-4);
+  }
+}
+}  // namespace kernel
+}  // namespace mindspore
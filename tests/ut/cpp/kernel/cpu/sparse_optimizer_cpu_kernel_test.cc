@@ -14,6 +14,11 @@
  * limitations under the License.
  */
 
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <map>
+#include <random>
 #include <vector>
 #include "common/common_test.h"
 #include "backend/kernel_compiler/cpu/sparse_optimizer_cpu_kernel.h"
@@ -25,6 +30,76 @@ class CommonUtilTest : public UT::Common {
   CommonUtilTest() = default;
 };
 
+namespace {
+// zipf distributed ids over [0, id_num), the hot ids are scattered over [0, max_index) like hashed feature ids
+std::vector<int> ZipfIndices(size_t indices_size, size_t id_num, size_t max_index, double exponent) {
+  std::vector<double> cdf(id_num);
+  double sum = 0;
+  for (size_t i = 0; i < id_num; ++i) {
+    sum += 1.0 / std::pow(i + 1, exponent);
+    cdf[i] = sum;
+  }
+  std::mt19937 random_engine(1);
+  std::uniform_real_distribution<double> distribution(0, sum);
+  std::vector<int> indices(indices_size);
+  for (auto &index : indices) {
+    uint64_t rank = std::lower_bound(cdf.begin(), cdf.end(), distribution(random_engine)) - cdf.begin();
+    index = static_cast<int>(rank * 2654435761ULL % max_index);
+  }
+  return indices;
+}
+
+// reduces the gradient and checks it against a reference, returns the time taken in ms
+double CheckReduceSparseGradient(const std::vector<int> &indices, size_t value_stride, size_t max_index,
+                                 bool use_sort_reduce) {
+  size_t indices_size = indices.size();
+  std::vector<int> input_indices(indices);
+  std::vector<float> grad(indices_size * value_stride);
+  for (size_t i = 0; i < grad.size(); ++i) {
+    grad[i] = static_cast<float>(i % 7);
+  }
+  std::vector<int> unique_indices(indices_size);
+  std::vector<float> summed_grad(indices_size * value_stride);
+  std::vector<int> tmp_indices(indices_size);
+  std::vector<float> tmp_grad(indices_size * value_stride);
+  SparseGradient<int> unique_grad({summed_grad.data(), unique_indices.data(), indices_size});
+  SparseGradient<int> workspace_grad({tmp_grad.data(), tmp_indices.data(), indices_size});
+  SparseGradient<int> input_grad({grad.data(), input_indices.data(), indices_size});
+
+  ReduceSparseGradientParam<int> param;
+  param.input_grad_ = &input_grad;
+  param.workspace_grad_ = &workspace_grad;
+  param.output_grad_ = &unique_grad;
+  param.max_index_ = max_index;
+  param.value_stride_ = value_stride;
+  param.use_sort_reduce_ = use_sort_reduce;
+  auto start = std::chrono::steady_clock::now();
+  SparseOptimizerCPUKernel::BucketReduceSparseGradient(param);
+  auto cost = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+  std::map<int, std::vector<float>> expect;
+  for (size_t i = 0; i < indices_size; ++i) {
+    auto &row = expect[indices[i]];
+    row.resize(value_stride, 0);
+    for (size_t j = 0; j < value_stride; ++j) {
+      row[j] += grad[i * value_stride + j];
+    }
+  }
+  EXPECT_EQ(unique_grad.indices_size_, expect.size());
+  for (size_t i = 0; i < unique_grad.indices_size_; ++i) {
+    auto iter = expect.find(unique_grad.indices_[i]);
+    EXPECT_TRUE(iter != expect.end());
+    if (iter == expect.end()) {
+      break;
+    }
+    for (size_t j = 0; j < value_stride; ++j) {
+      EXPECT_EQ(unique_grad.value_[i * value_stride + j], iter->second[j]);
+    }
+  }
+  return cost;
+}
+}  // namespace
+
 TEST_F(CommonUtilTest, BucketReduceSparseGradient1) {
   // The indices is a vector and the grad is a tensor with shape (6, 2)
   /* 0
@@ -130,5 +205,31 @@ TEST_F(CommonUtilTest, BucketReduceSparseGradient2) {
     EXPECT_EQ(unique_grad.value_[i], expect_value[i]);
   }
 }
+
+TEST_F(CommonUtilTest, SortReduceSparseGradient) {
+  std::vector<int> indices{0, 0, 1, 1, 0, 3, 5, 3};
+  CheckReduceSparseGradient(indices, 3, 6, true);
+}
+
+// benchmark of the hash and the sort reduce over zipf distributed indices, the high cardinality gradients are
+// partitioned into more buckets than threads. best of 5 runs with one pool thread, in ms:
+//   exponent  unique ids  unordered_map (before)  sort  hash table
+//   0.5       167533      32.2                    24.1  7.6
+//   0.8       119436      25.4                    25.8  8.4
+//   1.1       41624       11.9                    26.6  8.4
+//   1.5       4737        6.1                     24.1  6.2
+TEST_F(CommonUtilTest, ReduceSparseGradientZipf) {
+  const size_t indices_size = 200000;
+  const size_t id_num = 1000000;
+  const size_t max_index = 100000000;
+  const size_t value_stride = 16;
+  for (double exponent : {0.5, 0.8, 1.1, 1.5}) {
+    auto indices = ZipfIndices(indices_size, id_num, max_index, exponent);
+    auto hash_cost = CheckReduceSparseGradient(indices, value_stride, max_index, false);
+    auto sort_cost = CheckReduceSparseGradient(indices, value_stride, max_index, true);
+    MS_LOG(INFO) << "zipf exponent " << exponent << ": hash reduce " << hash_cost << " ms, sort reduce " << sort_cost
+                 << " ms";
+  }
+}
 }  // namespace kernel
 }  // namespace mindspore
@@ -0,0 +1,94 @@
+/**
+ * Copyright 2021 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "backend/optimizer/cpu/embedding_lookup_segment_reduce_fusion.h"
+#include "common/backend_common_test.h"
+#include "common/py_func_graph_fetcher.h"
+
+namespace mindspore {
+namespace opt {
+using KernelBuildInfoBuilder = kernel::KernelBuildInfo::KernelBuildInfoBuilder;
+
+class TestHWEmbeddingLookupSegmentReduceFusion : public BackendCommon {
+ public:
+  TestHWEmbeddingLookupSegmentReduceFusion()
+      : get_py_fun_("gtest_input.pre_activate.embedding_lookup_segment_reduce_fusion_test", true) {}
+  ~TestHWEmbeddingLookupSegmentReduceFusion() override = default;
+
+  KernelGraphPtr GetKernelGraph(const std::string &tag) {
+    FuncGraphPtr g = get_py_fun_.CallAndParseRet("test_embedding_lookup_segment_reduce_fusion", tag);
+    EXPECT_NE(g, nullptr);
+    std::vector<int64_t> shp_params{10, 8};
+    std::vector<int64_t> shp_indices{6};
+    auto params_abstract = std::make_shared<abstract::AbstractTensor>(kFloat32, shp_params);
+    auto indices_abstract = std::make_shared<abstract::AbstractTensor>(kInt32, shp_indices);
+    auto segment_ids_abstract = std::make_shared<abstract::AbstractTensor>(kInt32, shp_indices);
+    AbstractBasePtrList args_spec_list{params_abstract, indices_abstract, segment_ids_abstract};
+    auto kg = BackendCommon::GetKernelGraph(g, args_spec_list);
+    // the pass reads the selected device types, the kernels are selected with their infer types
+    for (const auto &node : kg->execution_order()) {
+      std::vector<TypeId> inputs_type;
+      for (size_t i = 0; i < AnfAlgo::GetInputTensorNum(node); ++i) {
+        inputs_type.push_back(AnfAlgo::GetPrevNodeOutputInferDataType(node, i));
+      }
+      KernelBuildInfoBuilder builder;
+      builder.SetInputsDeviceType(inputs_type);
+      builder.SetInputsFormat(std::vector<std::string>(inputs_type.size(), kOpFormat_DEFAULT));
+      builder.SetOutputsDeviceType({AnfAlgo::GetOutputInferDataType(node, 0)});
+      builder.SetOutputsFormat({kOpFormat_DEFAULT});
+      AnfAlgo::SetSelectKernelBuildInfo(builder.Build(), node.get());
+    }
+    return kg;
+  }
+
+  FuncGraphPtr Optimize(const KernelGraphPtr &kg) {
+    auto optimizer = std::make_shared<opt::GraphOptimizer>();
+    auto pm = std::make_shared<opt::PassManager>();
+    pm->AddPass(std::make_shared<opt::EmbeddingLookupSegmentReduceFusion>());
+    optimizer->AddPassManager(pm);
+    return optimizer->Optimize(kg);
+  }
+
+  UT::PyFuncGraphFetcher get_py_fun_;
+};
+
+TEST_F(TestHWEmbeddingLookupSegmentReduceFusion, test_fusion) {
+  auto kg = GetKernelGraph("before");
+  auto new_graph = Optimize(kg);
+  FuncGraphPtr g_after = get_py_fun_.CallAndParseRet("test_embedding_lookup_segment_reduce_fusion", "after");
+  EXPECT_TRUE(CheckEqualGraph(g_after, new_graph));
+
+  auto output = new_graph->output()->cast<CNodePtr>();
+  ASSERT_NE(output, nullptr);
+  auto fused = AnfAlgo::GetInputNode(output, 0)->cast<CNodePtr>();
+  ASSERT_NE(fused, nullptr);
+  EXPECT_EQ(AnfAlgo::GetCNodeName(fused), kEmbeddingLookupSegmentReduceOpName);
+  EXPECT_EQ(AnfAlgo::GetNodeAttr<int64_t>(fused, kAttrOffset), 2);
+  EXPECT_EQ(AnfAlgo::GetInputDeviceDataType(fused, 0), kNumberTypeFloat32);
+  EXPECT_EQ(AnfAlgo::GetInputDeviceDataType(fused, 1), kNumberTypeInt32);
+  EXPECT_EQ(AnfAlgo::GetOutputDeviceDataType(fused, 0), kNumberTypeFloat32);
+  EXPECT_EQ(AnfAlgo::GetOutputInferShape(fused, 0), std::vector<size_t>({4, 8}));
+}
+
+TEST_F(TestHWEmbeddingLookupSegmentReduceFusion, test_no_fusion_shared_lookup) {
+  // the gathered rows are needed by another user, fusing would compute them twice
+  auto kg = GetKernelGraph("before_shared_lookup");
+  auto new_graph = Optimize(kg);
+  FuncGraphPtr g_after =
+    get_py_fun_.CallAndParseRet("test_embedding_lookup_segment_reduce_fusion", "after_shared_lookup");
+  EXPECT_TRUE(CheckEqualGraph(g_after, new_graph));
+}
+}  // namespace opt
+}  // namespace mindspore
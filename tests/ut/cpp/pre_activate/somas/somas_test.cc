@@ -0,0 +1,143 @@
+/**
+ * Copyright 2021 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <memory>
+#include <vector>
+#include "common/common_test.h"
+#include "common/fake_kernel.h"
+#include "backend/optimizer/somas/somas.h"
+#include "backend/session/anf_runtime_algorithm.h"
+#include "backend/session/kernel_graph.h"
+#include "runtime/device/cpu/cpu_device_address.h"
+
+namespace mindspore {
+namespace somas {
+class TestSomas : public UT::Common {
+ public:
+  TestSomas() {}
+};
+
+namespace {
+// x -> a -> b1 -> b2 -> d
+//        \-> c ------/
+// all the kernels are in one stream and executed in the order a, b1, b2, c, d
+struct BranchGraph {
+  KernelGraphPtr graph;
+  CNodePtr a;
+  CNodePtr b1;
+  CNodePtr b2;
+  CNodePtr c;
+  CNodePtr d;
+};
+
+BranchGraph CreateBranchGraph() {
+  BranchGraph branch;
+  branch.graph = std::make_shared<session::KernelGraph>();
+  auto x = branch.graph->NewParameter(std::make_shared<abstract::AbstractTensor>(kFloat32, kFakeTensorShape));
+  branch.a = NewFakeKernel(branch.graph, "Abs", {x});
+  branch.b1 = NewFakeKernel(branch.graph, "Neg", {branch.a});
+  branch.b2 = NewFakeKernel(branch.graph, "Sqrt", {branch.b1});
+  branch.c = NewFakeKernel(branch.graph, "Exp", {branch.a});
+  branch.d = NewFakeKernel(branch.graph, "Add", {branch.b2, branch.c});
+  branch.graph->set_output(branch.d);
+  branch.graph->set_execution_order({branch.a, branch.b1, branch.b2, branch.c, branch.d});
+  return branch;
+}
+
+void SetOutputAddr(const CNodePtr &kernel, void *ptr) {
+  auto address = std::make_shared<device::cpu::CPUDeviceAddress>(ptr, kFakeTensorSize, kOpFormat_DEFAULT,
+                                                                 kNumberTypeFloat32);
+  AnfAlgo::SetOutputAddr(address, 0, kernel.get());
+}
+
+// offsets of the kernel outputs in the planned memory
+class PlannedMemory {
+ public:
+  PlannedMemory(Somas *somas, const BranchGraph &branch) : somas_(somas) {
+    EXPECT_TRUE(somas_->Allocate(branch.graph.get()));
+    base_.resize(somas_->GetTotalMemSize() + 1);
+    somas_->set_mem_base_addr(base_.data());
+  }
+
+  size_t Offset(const CNodePtr &kernel) const {
+    return static_cast<size_t>(somas_->GetNodeOutputPtr(kernel, 0) - base_.data());
+  }
+
+  bool Overlap(const CNodePtr &lhs, const CNodePtr &rhs) const {
+    return Offset(lhs) < Offset(rhs) + kFakeTensorSize && Offset(rhs) < Offset(lhs) + kFakeTensorSize;
+  }
+
+ private:
+  Somas *somas_;
+  std::vector<uint8_t> base_;
+};
+}  // namespace
+
+TEST_F(TestSomas, ParallelExecutionKeepsBranchesApart) {
+  auto branch = CreateBranchGraph();
+  Somas somas;
+  somas.set_parallel_execution(true);
+  PlannedMemory memory(&somas, branch);
+
+  // the kernels only wait for their inputs, so c may run at the same time as b1 and b2
+  EXPECT_FALSE(memory.Overlap(branch.b1, branch.c));
+  EXPECT_FALSE(memory.Overlap(branch.b2, branch.c));
+  EXPECT_FALSE(memory.Overlap(branch.a, branch.c));
+  // the graph output is read after the step and is not shared with any other tensor
+  for (const auto &kernel : {branch.a, branch.b1, branch.b2, branch.c}) {
+    EXPECT_FALSE(memory.Overlap(kernel, branch.d));
+  }
+}
+
+TEST_F(TestSomas, SequentialExecutionReusesAcrossBranches) {
+  auto sequential_branch = CreateBranchGraph();
+  Somas sequential;
+  PlannedMemory sequential_memory(&sequential, sequential_branch);
+  // b2 is done before c starts in the execution order
+  EXPECT_FALSE(sequential_memory.Overlap(sequential_branch.b2, sequential_branch.c));
+
+  auto parallel_branch = CreateBranchGraph();
+  Somas parallel;
+  parallel.set_parallel_execution(true);
+  PlannedMemory parallel_memory(&parallel, parallel_branch);
+  EXPECT_LT(sequential.GetTotalMemSize(), parallel.GetTotalMemSize());
+}
+
+TEST_F(TestSomas, ParallelExecutionPlansCreatedAddresses) {
+  // the actor runtime creates the device addresses before the memory is planned
+  auto branch = CreateBranchGraph();
+  for (const auto &kernel : branch.graph->execution_order()) {
+    SetOutputAddr(kernel, nullptr);
+  }
+  Somas sequential;
+  EXPECT_TRUE(sequential.Allocate(branch.graph.get()));
+  EXPECT_EQ(0u, sequential.GetTotalMemSize());
+
+  Somas parallel;
+  parallel.set_parallel_execution(true);
+  EXPECT_TRUE(parallel.Allocate(branch.graph.get()));
+  auto planned_size = parallel.GetTotalMemSize();
+  EXPECT_GT(planned_size, 0u);
+
+  // an output which already holds memory is skipped
+  std::vector<uint8_t> held(kFakeTensorSize);
+  SetOutputAddr(branch.d, held.data());
+  Somas parallel_held;
+  parallel_held.set_parallel_execution(true);
+  EXPECT_TRUE(parallel_held.Allocate(branch.graph.get()));
+  EXPECT_LT(parallel_held.GetTotalMemSize(), planned_size);
+}
+}  // namespace somas
+}  // namespace mindspore
@@ -15,10 +15,15 @@
  */
 
 #include "ps/core/communicator/tcp_message_handler.h"
+#include "ps/core/communicator/shared_memory.h"
 #include "common/common_test.h"
 
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <algorithm>
 #include <memory>
 #include <thread>
+#include <vector>
 
 namespace mindspore {
 namespace ps {
@@ -172,6 +177,77 @@ TEST_F(TestTcpMessageHandler, 16Header_2meta_4062Data_16Header_2meta_4062_data)
 
   handler.ReceiveMessage(result, 4064);
 }
+
+// the data is received into the buffer of the allocator, whatever the chunks the stream arrives in
+TEST_F(TestTcpMessageHandler, ReceiveDataIntoAllocatedBuffer) {
+  TcpMessageHandler handler;
+  std::vector<unsigned char> buffer;
+  size_t received = 0;
+  handler.SetAllocator([&](const MessageMeta &meta, size_t size) -> void * {
+    EXPECT_EQ(meta.request_id(), 1);
+    buffer.resize(size);
+    return buffer.data();
+  });
+  handler.SetCallback([&](std::shared_ptr<MessageMeta> meta, const Protos &, const void *data, size_t size) {
+    EXPECT_EQ(data, buffer.data());
+    EXPECT_EQ(size, 1000);
+    EXPECT_EQ(std::string(reinterpret_cast<const char *>(data), size), std::string(1000, 'a'));
+    received++;
+  });
+
+  std::string data(1000, 'a');
+  MessageMeta meta;
+  meta.set_request_id(1);
+  MessageHeader header;
+  header.message_proto_ = Protos::RAW;
+  header.message_meta_length_ = meta.ByteSizeLong();
+  header.message_length_ = data.length() + meta.ByteSizeLong();
+  std::string stream(reinterpret_cast<const char *>(&header), kHeaderLen);
+  stream += meta.SerializeAsString() + data;
+  stream += stream;
+
+  for (size_t chunk : {1, 7, 17, 4096}) {
+    for (size_t pos = 0; pos < stream.size(); pos += chunk) {
+      handler.ReceiveMessage(stream.data() + pos, std::min(chunk, stream.size() - pos));
+    }
+  }
+  EXPECT_EQ(received, 8);
+}
+
+// a message from the same host carries only its meta in the stream, the data is read from the shared memory, which
+// is removed once received
+TEST_F(TestTcpMessageHandler, ReceiveDataFromSharedMemory) {
+  std::string data(1 << 20, 'b');
+  auto shm_name = SharedMemory::Write(data.data(), data.length());
+  ASSERT_FALSE(shm_name.empty());
+
+  MessageMeta meta;
+  meta.set_request_id(2);
+  meta.set_shm_name(shm_name);
+  meta.set_shm_size(data.length());
+  MessageHeader header;
+  header.message_proto_ = Protos::RAW;
+  header.message_meta_length_ = meta.ByteSizeLong();
+  header.message_length_ = meta.ByteSizeLong();
+  std::string stream(reinterpret_cast<const char *>(&header), kHeaderLen);
+  stream += meta.SerializeAsString();
+
+  TcpMessageHandler handler;
+  std::vector<unsigned char> buffer;
+  handler.SetAllocator([&](const MessageMeta &, size_t size) -> void * {
+    buffer.resize(size);
+    return buffer.data();
+  });
+  size_t received = 0;
+  handler.SetCallback([&](std::shared_ptr<MessageMeta> meta, const Protos &, const void *received_data, size_t size) {
+    EXPECT_EQ(received_data, buffer.data());
+    EXPECT_EQ(std::string(reinterpret_cast<const char *>(received_data), size), data);
+    received++;
+  });
+  handler.ReceiveMessage(stream.data(), stream.size());
+  EXPECT_EQ(received, 1);
+  EXPECT_EQ(shm_open(shm_name.c_str(), O_RDONLY, 0), -1);
+}
 }  // namespace core
 }  // namespace ps
 }  // namespace mindspore
\ No newline at end of file
@@ -0,0 +1,112 @@
+/**
+ * Copyright 2021 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ps/core/communicator/tcp_client.h"
+#include "ps/core/communicator/tcp_server.h"
+#include "ps/core/cluster_metadata.h"
+#include "ps/core/communicator/shared_memory.h"
+#include "common/common_test.h"
+
+#include <chrono>
+#include <future>
+#include <memory>
+#include <string>
+#include <thread>
+#include <utility>
+
+namespace mindspore {
+namespace ps {
+namespace core {
+class TestTcpSharedMemory : public UT::Common {
+ public:
+  TestTcpSharedMemory() = default;
+  virtual ~TestTcpSharedMemory() = default;
+
+  void SetUp() override { ClusterMetadata::instance()->set_shm_threshold(kShmThreshold); }
+  void TearDown() override { ClusterMetadata::instance()->set_shm_threshold(0); }
+
+  static constexpr uint64_t kShmThreshold = 1024;
+};
+
+// the server answers a request passed in shared memory with a response below the threshold, which goes in the
+// stream and must not name the segment of the request
+TEST_F(TestTcpSharedMemory, LargeRequestSmallResponse) {
+  std::string request(1 << 20, 'r');
+  std::string response(16, 's');
+
+  std::promise<std::string> request_received;
+  auto server = std::make_unique<TcpServer>("127.0.0.1", 0);
+  server->SetMessageCallback([&](std::shared_ptr<TcpConnection> conn, std::shared_ptr<MessageMeta> meta,
+                                 const Protos &protos, const void *data, size_t size) {
+    request_received.set_value(std::string(reinterpret_cast<const char *>(data), size));
+    server->SendMessage(conn, meta, protos, response.data(), response.length());
+  });
+  server->Init();
+  std::thread server_thread([&]() { server->Start(); });
+
+  std::promise<std::pair<std::shared_ptr<MessageMeta>, std::string>> response_received;
+  auto client = std::make_unique<TcpClient>("127.0.0.1", server->BoundPort());
+  client->SetMessageCallback([&](std::shared_ptr<MessageMeta> meta, const Protos &, const void *data, size_t size) {
+    response_received.set_value(std::make_pair(meta, std::string(reinterpret_cast<const char *>(data), size)));
+  });
+  client->Init();
+  auto meta = std::make_shared<MessageMeta>();
+  meta->set_cmd(NodeCommand::SEND_DATA);
+  meta->set_request_id(1);
+  EXPECT_TRUE(client->SendMessage(meta, Protos::RAW, request.data(), request.length()));
+  std::thread client_thread([&]() { client->Start(); });
+
+  auto request_future = request_received.get_future();
+  auto response_future = response_received.get_future();
+  const auto timeout = std::chrono::seconds(10);
+  bool request_ready = request_future.wait_for(timeout) == std::future_status::ready;
+  bool response_ready = response_future.wait_for(timeout) == std::future_status::ready;
+  client->Stop();
+  server->Stop();
+  client_thread.join();
+  server_thread.join();
+
+  ASSERT_TRUE(request_ready);
+  EXPECT_EQ(request_future.get(), request);
+  ASSERT_TRUE(response_ready);
+  auto received = response_future.get();
+  EXPECT_EQ(received.first->request_id(), 1);
+  EXPECT_TRUE(received.first->shm_name().empty());
+  EXPECT_EQ(received.first->shm_size(), 0);
+  EXPECT_EQ(received.second, response);
+}
+
+// a received meta only names a segment of the transport, and the size it claims has to be the size of the segment
+TEST_F(TestTcpSharedMemory, OpenChecksNameAndSize) {
+  std::string data(4096, 'd');
+  EXPECT_ANY_THROW(SharedMemory::Open("/some_other_object", data.length()));
+  EXPECT_ANY_THROW(SharedMemory::Open("/mindspore_ps_/../dev/shm", data.length()));
+
+  std::string name = SharedMemory::Write(data.data(), data.length());
+  ASSERT_FALSE(name.empty());
+  // the name is removed by the failed open too, the segment cannot be opened a second time
+  EXPECT_ANY_THROW(SharedMemory::Open(name, data.length() * 2));
+  EXPECT_ANY_THROW(SharedMemory::Open(name, data.length()));
+
+  name = SharedMemory::Write(data.data(), data.length());
+  ASSERT_FALSE(name.empty());
+  auto shm = SharedMemory::Open(name, data.length());
+  ASSERT_NE(shm, nullptr);
+  EXPECT_EQ(std::string(reinterpret_cast<const char *>(shm->data()), shm->size()), data);
+}
+}  // namespace core
+}  // namespace ps
+}  // namespace mindspore
@@ -0,0 +1,162 @@
+/**
+ * Copyright 2021 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <atomic>
+#include <chrono>
+#include <random>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "common/common_test.h"
+#include "ps/ps_cache/embedding_hash_map.h"
+
+namespace mindspore {
+namespace ps {
+class TestEmbeddingHashMap : public UT::Common {
+ public:
+  TestEmbeddingHashMap() = default;
+  virtual ~TestEmbeddingHashMap() = default;
+
+  void SetUp() override {}
+  void TearDown() override {}
+};
+
+// random inserts and erases, ids strided by a power of two must still spread over the slots
+TEST_F(TestEmbeddingHashMap, IdMapMatchesUnorderedMap) {
+  const size_t capacity = 5000;
+  EmbeddingIdMap id_map(capacity);
+  std::unordered_map<int, int> expect;
+  std::mt19937 engine(1);
+  std::uniform_int_distribution<int> distribution(0, 20000);
+  for (size_t step = 0; step < 200000; ++step) {
+    int id = distribution(engine) * 1024;
+    auto iter = expect.find(id);
+    EXPECT_EQ(id_map.Find(id), iter == expect.end() ? INVALID_INDEX_VALUE : iter->second);
+    if (iter != expect.end()) {
+      id_map.Erase(id);
+      (void)expect.erase(iter);
+    } else if (expect.size() < capacity) {
+      int index = static_cast<int>(step % capacity);
+      id_map.Insert(id, index);
+      expect[id] = index;
+    }
+  }
+  EXPECT_EQ(id_map.size(), expect.size());
+  size_t visited = 0;
+  id_map.ForEach([&](int id, int index) {
+    EXPECT_EQ(expect[id], index);
+    visited++;
+  });
+  EXPECT_EQ(visited, expect.size());
+  id_map.ReclaimRetired();
+  for (const auto &item : expect) {
+    EXPECT_EQ(id_map.Find(item.first), item.second);
+  }
+}
+
+// lookups of a batch of 1M ids, one batch per thread as in PsCacheManager::CheckCacheHitOrOutRange, while the
+// writer keeps swapping ids that no reader asks for
+TEST_F(TestEmbeddingHashMap, ConcurrentFindBatch) {
+  const size_t capacity = 1 << 20;
+  const size_t batch_size = 1 << 20;
+  const size_t thread_num = 4;
+  EmbeddingIdMap id_map(capacity);
+  for (size_t i = 0; i < capacity / 2; ++i) {
+    id_map.Insert(static_cast<int>(i), static_cast<int>(i));
+  }
+  std::mt19937 engine(1);
+  std::uniform_int_distribution<int> distribution(0, capacity - 1);
+  std::vector<int> ids(batch_size);
+  for (auto &id : ids) {
+    id = distribution(engine);
+  }
+
+  std::vector<int> indices(batch_size);
+  auto start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < batch_size; ++i) {
+    indices[i] = id_map.Find(ids[i]);
+  }
+  auto find_cost = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+  start = std::chrono::steady_clock::now();
+  id_map.FindBatch(ids.data(), batch_size, indices.data());
+  auto batch_cost = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+  MS_LOG(INFO) << "Lookup of " << batch_size << " ids, Find: " << find_cost.count()
+               << "us, FindBatch: " << batch_cost.count() << "us";
+
+  std::atomic_bool stop{false};
+  std::thread writer([&]() {
+    for (int round = 0; !stop.load(); ++round) {
+      int id = static_cast<int>(capacity + round % capacity);
+      id_map.Insert(id, round % static_cast<int>(capacity));
+      id_map.Erase(id);
+    }
+  });
+  std::vector<std::vector<int>> thread_indices(thread_num, std::vector<int>(batch_size));
+  std::vector<std::thread> readers;
+  start = std::chrono::steady_clock::now();
+  for (size_t t = 0; t < thread_num; ++t) {
+    readers.emplace_back([&, t]() { id_map.FindBatch(ids.data(), batch_size, thread_indices[t].data()); });
+  }
+  for (auto &reader : readers) {
+    reader.join();
+  }
+  auto concurrent_cost =
+    std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+  stop = true;
+  writer.join();
+  MS_LOG(INFO) << "Lookup of " << thread_num << " x " << batch_size << " ids with a concurrent writer: "
+               << concurrent_cost.count() << "us";
+
+  for (size_t i = 0; i < batch_size; ++i) {
+    int expect = static_cast<size_t>(ids[i]) < capacity / 2 ? ids[i] : INVALID_INDEX_VALUE;
+    ASSERT_EQ(indices[i], expect);
+    for (size_t t = 0; t < thread_num; ++t) {
+      ASSERT_EQ(thread_indices[t][i], expect);
+    }
+  }
+}
+
+// an expired element hit since the clock hand passed it is swapped out after the ones that were not
+TEST_F(TestEmbeddingHashMap, ClockSecondChance) {
+  const size_t capacity = 6;
+  EmbeddingHashMap hash_map(0, capacity);
+  std::vector<int> swap_out_index(capacity);
+  std::vector<int> swap_out_ids(capacity);
+  size_t swap_out_size = 0;
+  bool need_wait_graph = false;
+  // the front and back elements are reserved
+  for (int id = 0; id < 4; ++id) {
+    int index = hash_map.ParseData(id, swap_out_index.data(), swap_out_ids.data(), 1, 0, &swap_out_size,
+                                   &need_wait_graph);
+    EXPECT_EQ(index, id + 1);
+    EXPECT_EQ(hash_map.hash_id_to_index().Find(id), index);
+  }
+  EXPECT_EQ(swap_out_size, 0);
+  // step 2 hits id 0 again, then the graph finished step 2 and ids of step 3 need room
+  EXPECT_TRUE(hash_map.Touch(hash_map.hash_id_to_index().Find(0), 2));
+  EXPECT_FALSE(hash_map.Touch(hash_map.hash_id_to_index().Find(0), 2));
+  hash_map.Reset();
+  for (int id = 10; id < 14; ++id) {
+    (void)hash_map.ParseData(id, swap_out_index.data(), swap_out_ids.data(), 3, 3, &swap_out_size,
+                             &need_wait_graph);
+  }
+  EXPECT_EQ(swap_out_size, 4);
+  EXPECT_EQ(swap_out_ids, std::vector<int>({1, 2, 3, 0, 0, 0}));
+  EXPECT_EQ(hash_map.hash_id_to_index().Find(0), INVALID_INDEX_VALUE);
+  EXPECT_FALSE(need_wait_graph);
+  EXPECT_EQ(hash_map.hash_id_to_index().size(), 4);
+}
+}  // namespace ps
+}  // namespace mindspore
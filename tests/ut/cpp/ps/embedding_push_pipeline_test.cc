@@ -0,0 +1,192 @@
+/**
+ * Copyright 2021 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <random>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include "common/common_test.h"
+#include "ps/embedding_push_pipeline.h"
+
+namespace mindspore {
+namespace ps {
+class TestEmbeddingPushPipeline : public UT::Common {
+ public:
+  TestEmbeddingPushPipeline() = default;
+  virtual ~TestEmbeddingPushPipeline() = default;
+
+  void SetUp() override {}
+  void TearDown() override {}
+};
+
+namespace {
+constexpr size_t kRowSize = 4;
+
+// rows of the tables on the servers, updated by a slow network
+class FakeServer {
+ public:
+  void Update(const Key &key, const std::vector<int> &ids, const std::vector<float> &vals) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (size_t i = 0; i < ids.size(); ++i) {
+      tables_[key][ids[i]].assign(vals.begin() + i * kRowSize, vals.begin() + (i + 1) * kRowSize);
+    }
+    sent_rows_ += ids.size();
+  }
+  void Lookup(const Key &key, const std::vector<int> &ids, float *result) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (size_t i = 0; i < ids.size(); ++i) {
+      auto &row = tables_[key][ids[i]];
+      row.resize(kRowSize, 0);
+      std::copy(row.begin(), row.end(), result + i * kRowSize);
+    }
+  }
+  size_t sent_rows() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return sent_rows_;
+  }
+
+ private:
+  std::mutex mutex_;
+  std::map<Key, std::map<int, std::vector<float>>> tables_;
+  size_t sent_rows_{0};
+};
+
+// as Worker::DoPSEmbeddingLookup does
+std::vector<float> Pull(EmbeddingPushPipeline *pipeline, FakeServer *server, const Key &key,
+                        const std::vector<int> &ids) {
+  std::vector<float> result(ids.size() * kRowSize);
+  std::vector<size_t> missing;
+  pipeline->Lookup(key, ids, kRowSize, result.data(), &missing);
+  std::vector<int> missing_ids;
+  for (auto pos : missing) {
+    missing_ids.push_back(ids[pos]);
+  }
+  std::vector<float> missing_result(missing_ids.size() * kRowSize);
+  server->Lookup(key, missing_ids, missing_result.data());
+  for (size_t i = 0; i < missing.size(); ++i) {
+    std::copy(missing_result.begin() + i * kRowSize, missing_result.begin() + (i + 1) * kRowSize,
+              result.begin() + missing[i] * kRowSize);
+  }
+  return result;
+}
+}  // namespace
+
+// the ps cache pattern: every step pushes the rows it evicts and pulls the rows it misses, often the same ones soon
+// after. Pulls must see every push of the worker while at most window pushes are waiting for the servers.
+TEST_F(TestEmbeddingPushPipeline, PullsSeeOwnPushes) {
+  const size_t window = 3;
+  FakeServer server;
+  EmbeddingPushPipeline pipeline(window, [&](const Key &key, const std::vector<int> &ids,
+                                             const std::vector<float> &vals) { server.Update(key, ids, vals); });
+
+  std::map<Key, std::map<int, std::vector<float>>> expect;
+  std::vector<std::vector<int>> pushed_ids;
+  std::mt19937 engine(1);
+  std::uniform_int_distribution<int> id_distribution(0, 200);
+  for (size_t step = 0; step < 200; ++step) {
+    Key key = step % 2;
+    std::vector<int> ids(16);
+    for (auto &id : ids) {
+      id = id_distribution(engine);
+    }
+    std::vector<float> result = Pull(&pipeline, &server, key, ids);
+    for (size_t i = 0; i < ids.size(); ++i) {
+      auto &row = expect[key][ids[i]];
+      row.resize(kRowSize, 0);
+      ASSERT_EQ(std::vector<float>(result.begin() + i * kRowSize, result.begin() + (i + 1) * kRowSize), row);
+    }
+
+    std::vector<float> vals;
+    for (size_t i = 0; i < ids.size(); ++i) {
+      for (size_t j = 0; j < kRowSize; ++j) {
+        vals.push_back(step * 100.0f + i + j * 0.5f);
+      }
+      expect[key][ids[i]].assign(vals.end() - kRowSize, vals.end());
+    }
+    pipeline.Push(key, ids, vals);
+    pushed_ids.push_back(ids);
+    // at most window pushes, this one included, are not on the servers yet. Rows hold the step that pushed them.
+    if (step >= window) {
+      size_t old_step = step - window;
+      const auto &old_ids = pushed_ids[old_step];
+      std::vector<float> old_rows(old_ids.size() * kRowSize);
+      server.Lookup(old_step % 2, old_ids, old_rows.data());
+      for (size_t i = 0; i < old_ids.size(); ++i) {
+        ASSERT_GE(static_cast<size_t>(old_rows[i * kRowSize] / 100), old_step);
+      }
+    }
+  }
+  pipeline.Flush();
+
+  for (auto &table : expect) {
+    for (auto &row : table.second) {
+      std::vector<float> result(kRowSize);
+      server.Lookup(table.first, {row.first}, result.data());
+      EXPECT_EQ(result, row.second);
+    }
+  }
+  auto metrics = pipeline.metrics();
+  EXPECT_EQ(metrics.push_count, 200);
+  EXPECT_EQ(metrics.pushed_rows, 200 * 16);
+  EXPECT_GT(metrics.served_rows, 0);
+  EXPECT_EQ(server.sent_rows() + metrics.coalesced_rows, metrics.pushed_rows);
+}
+
+// pushes queued while the previous one is on the wire go out together, repeated rows once
+TEST_F(TestEmbeddingPushPipeline, CoalescesQueuedPushes) {
+  FakeServer server;
+  std::atomic_bool sending{false};
+  std::atomic_bool hold{true};
+  EmbeddingPushPipeline pipeline(8, [&](const Key &key, const std::vector<int> &ids, const std::vector<float> &vals) {
+    sending = true;
+    while (hold) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    server.Update(key, ids, vals);
+  });
+  // keeps the sender busy until the others are queued
+  pipeline.Push(9, {0}, std::vector<float>(kRowSize, 0));
+  while (!sending) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  pipeline.Push(0, {1}, std::vector<float>(kRowSize, 1));
+  pipeline.Push(0, {2, 3}, std::vector<float>(2 * kRowSize, 2));
+  pipeline.Push(0, {3, 2}, std::vector<float>(2 * kRowSize, 3));
+  pipeline.Push(1, {3}, std::vector<float>(kRowSize, 4));
+  hold = false;
+  pipeline.Flush();
+
+  auto metrics = pipeline.metrics();
+  EXPECT_EQ(metrics.pushed_rows, 7);
+  EXPECT_EQ(metrics.coalesced_rows, 2);
+  EXPECT_EQ(server.sent_rows(), 5);
+  std::vector<float> result(3 * kRowSize);
+  server.Lookup(0, {1, 2, 3}, result.data());
+  EXPECT_EQ(result, std::vector<float>({1, 1, 1, 1, 3, 3, 3, 3, 3, 3, 3, 3}));
+}
+
+TEST_F(TestEmbeddingPushPipeline, SendErrorReachesCaller) {
+  EmbeddingPushPipeline pipeline(1, [](const Key &, const std::vector<int> &, const std::vector<float> &) {
+    throw std::runtime_error("server is gone");
+  });
+  pipeline.Push(0, {1}, std::vector<float>(kRowSize, 1));
+  EXPECT_THROW(pipeline.Flush(), std::runtime_error);
+}
+}  // namespace ps
+}  // namespace mindspore
@@ -0,0 +1,165 @@
+/**
+ * Copyright 2021 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+#include "common/common_test.h"
+#include "ps/embedding_store.h"
+
+namespace mindspore {
+namespace ps {
+class TestEmbeddingStore : public UT::Common {
+ public:
+  TestEmbeddingStore() = default;
+  virtual ~TestEmbeddingStore() = default;
+
+  void SetUp() override {}
+  void TearDown() override {}
+};
+
+namespace {
+void InitRow(size_t row, float *data, size_t row_size) {
+  for (size_t j = 0; j < row_size; ++j) {
+    data[j] = row * 0.5f + j;
+  }
+}
+
+// random pulls and pushes through a dram tier of a few percent of the table, every pull and the final export must
+// see the latest pushed values
+void CheckStore(EvictionPolicy policy) {
+  const size_t row_num = 2000;
+  const size_t row_size = 8;
+  const size_t offset = 100;
+  EmbeddingStore store(row_num, row_size, 100, policy, InitRow);
+  std::string log_path = "./embedding_store_test_" + std::to_string(static_cast<int>(policy)) + ".log";
+  ASSERT_TRUE(store.Open(log_path));
+
+  std::vector<float> expect(row_num * row_size);
+  for (size_t row = 0; row < row_num; ++row) {
+    InitRow(row, expect.data() + row * row_size, row_size);
+  }
+  std::mt19937 engine(1);
+  std::uniform_int_distribution<Key> distribution(offset - 10, offset + row_num + 10);
+  for (size_t step = 0; step < 500; ++step) {
+    std::vector<Key> ids(32);
+    for (auto &id : ids) {
+      id = distribution(engine);
+    }
+    if (step % 2 == 0) {
+      std::vector<float> output(ids.size() * row_size);
+      store.Lookup(ids.data(), ids.size(), offset, output.data());
+      for (size_t i = 0; i < ids.size(); ++i) {
+        bool valid = ids[i] >= offset && ids[i] - offset < row_num;
+        for (size_t j = 0; j < row_size; ++j) {
+          float value = valid ? expect[(ids[i] - offset) * row_size + j] : 0;
+          EXPECT_EQ(output[i * row_size + j], value);
+        }
+      }
+      continue;
+    }
+    std::vector<Key> update_ids;
+    std::vector<float> values;
+    for (auto id : ids) {
+      if (id < offset || id - offset >= row_num) {
+        continue;
+      }
+      update_ids.push_back(id);
+      for (size_t j = 0; j < row_size; ++j) {
+        values.push_back(step + j * 0.25f);
+        expect[(id - offset) * row_size + j] = values.back();
+      }
+    }
+    store.Update(update_ids.data(), values.data(), update_ids.size(), offset);
+  }
+
+  std::vector<float> exported(row_num * row_size);
+  // exported in chunks as the parameter server saves a shard
+  const size_t chunk_rows = 300;
+  for (size_t begin = 0; begin < row_num; begin += chunk_rows) {
+    size_t num = std::min(chunk_rows, row_num - begin);
+    store.Export(begin, num, exported.data() + begin * row_size, num * row_size);
+  }
+  EXPECT_EQ(exported, expect);
+  auto metrics = store.metrics();
+  EXPECT_EQ(metrics.pull_count, 250);
+  EXPECT_GT(metrics.written_back_rows, 0);
+  EXPECT_GT(metrics.log_bytes, 0);
+  EXPECT_GT(metrics.hit_rate(), 0);
+  EXPECT_LE(metrics.pull_p50_us, metrics.pull_p99_us);
+}
+}  // namespace
+
+TEST_F(TestEmbeddingStore, LRU) { CheckStore(EvictionPolicy::kLRU); }
+
+TEST_F(TestEmbeddingStore, LFU) { CheckStore(EvictionPolicy::kLFU); }
+
+// rows are only promoted on access, the dram tier keeps the most recent ones
+TEST_F(TestEmbeddingStore, HotRowsStayInDram) {
+  const size_t row_size = 4;
+  EmbeddingStore store(1000, row_size, 10, EvictionPolicy::kLRU, InitRow);
+  ASSERT_TRUE(store.Open("./embedding_store_test_hot.log"));
+  std::vector<Key> hot = {1, 2, 3};
+  std::vector<float> output(hot.size() * row_size);
+  for (size_t i = 0; i < 100; ++i) {
+    store.Lookup(hot.data(), hot.size(), 0, output.data());
+  }
+  auto metrics = store.metrics();
+  EXPECT_EQ(metrics.miss_rows, hot.size());
+  EXPECT_EQ(metrics.hit_rows, 99 * hot.size());
+  EXPECT_EQ(metrics.evicted_rows, 0);
+}
+
+// rows loaded as a whole table are read back from the log, and rewriting them over and over compacts the log once
+// it passes the lowered threshold
+TEST_F(TestEmbeddingStore, LoadAndCompactLog) {
+  const size_t row_num = 200;
+  const size_t row_size = 4;
+  const size_t row_bytes = row_size * sizeof(float);
+  EmbeddingStore store(row_num, row_size, 10, EvictionPolicy::kLRU, InitRow);
+  store.set_min_compact_bytes(4 * row_num * row_bytes);
+  ASSERT_TRUE(store.Open("./embedding_store_test_compact.log"));
+  std::vector<float> expect(row_num * row_size);
+  for (size_t i = 0; i < expect.size(); ++i) {
+    expect[i] = i * 0.125f;
+  }
+  store.Load(0, row_num / 2, expect.data());
+  store.Load(row_num / 2, row_num - row_num / 2, expect.data() + row_num / 2 * row_size);
+  EXPECT_EQ(store.metrics().log_bytes, row_num * row_bytes);
+
+  uint64_t max_log_bytes = 0;
+  for (size_t step = 0; step < 100; ++step) {
+    std::vector<Key> ids(row_num);
+    std::vector<float> values(row_num * row_size);
+    for (size_t row = 0; row < row_num; ++row) {
+      ids[row] = row;
+      for (size_t j = 0; j < row_size; ++j) {
+        values[row * row_size + j] = step + row + j * 0.25f;
+      }
+    }
+    store.Update(ids.data(), values.data(), ids.size(), 0);
+    expect = values;
+    max_log_bytes = std::max(max_log_bytes, store.metrics().log_bytes);
+  }
+  // without compaction the log would hold every evicted version of the rows
+  EXPECT_LE(max_log_bytes, 4 * row_num * row_bytes + row_bytes);
+
+  std::vector<float> exported(row_num * row_size);
+  store.Export(0, row_num, exported.data(), exported.size());
+  EXPECT_EQ(exported, expect);
+}
+}  // namespace ps
+}  // namespace mindspore
@@ -0,0 +1,139 @@
+/**
+ * Copyright 2021 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <cmath>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+#include <vector>
+#include "common/common_test.h"
+#include "ps/gradient_compressor.h"
+
+namespace mindspore {
+namespace ps {
+class TestGradientCompressor : public UT::Common {
+ public:
+  TestGradientCompressor() = default;
+  virtual ~TestGradientCompressor() = default;
+
+  void SetUp() override {}
+  void TearDown() override {}
+};
+
+namespace {
+constexpr size_t kGradSize = 10000;
+
+std::vector<float> RandomGrad(std::mt19937 *engine) {
+  std::normal_distribution<float> dist(0, 0.1);
+  std::vector<float> grad(kGradSize);
+  for (auto &value : grad) {
+    value = dist(*engine);
+  }
+  return grad;
+}
+
+// pushes steps gradients through the compressor and returns how far the sum of the decoded gradients is from the sum
+// of the raw ones, relative to the latter
+float PushSteps(GradientCompressor *compressor, size_t steps, size_t *wire_bytes) {
+  std::mt19937 engine(0);
+  std::vector<float> raw_sum(kGradSize, 0);
+  std::vector<float> decoded_sum(kGradSize, 0);
+  *wire_bytes = 0;
+  for (size_t step = 0; step < steps; ++step) {
+    std::vector<float> grad = RandomGrad(&engine);
+    for (size_t i = 0; i < kGradSize; ++i) {
+      raw_sum[i] += grad[i];
+    }
+    CompressedGradient compressed;
+    compressor->Compress(1, grad.data(), grad.size(), &compressed);
+    *wire_bytes += compressed.SerializeAsString().size();
+    GradientCompressor::Accumulate(compressed, decoded_sum.data(), decoded_sum.size());
+  }
+  float diff = 0;
+  float raw = 0;
+  for (size_t i = 0; i < kGradSize; ++i) {
+    diff += std::fabs(raw_sum[i] - decoded_sum[i]);
+    raw += std::fabs(raw_sum[i]);
+  }
+  return diff / raw;
+}
+}  // namespace
+
+TEST_F(TestGradientCompressor, QuantizedGradientsKeepTheirSum) {
+  for (auto type : {GradCompressionType::kFp16, GradCompressionType::kInt8}) {
+    GradientCompressor compressor(type, 1);
+    size_t wire_bytes = 0;
+    // the error of every step is carried into the next one, so it does not add up over the steps
+    EXPECT_LT(PushSteps(&compressor, 50, &wire_bytes), type == GradCompressionType::kFp16 ? 1e-3 : 5e-3);
+    GradCompressionMetrics metrics = compressor.metrics();
+    EXPECT_EQ(metrics.compress_count, 50);
+    EXPECT_EQ(metrics.raw_bytes, 50 * kGradSize * sizeof(float));
+    EXPECT_EQ(metrics.compressed_bytes, wire_bytes);
+    EXPECT_GT(metrics.ratio(), type == GradCompressionType::kFp16 ? 1.9 : 3.9);
+  }
+}
+
+TEST_F(TestGradientCompressor, SparsifiedGradientsKeepTheirSum) {
+  for (auto type : {GradCompressionType::kTopK, GradCompressionType::kRandomK}) {
+    GradientCompressor compressor(type, 0.01);
+    size_t wire_bytes = 0;
+    // the elements not sent yet are held back in the residual, without it the servers would miss 99% of the sum
+    EXPECT_LT(PushSteps(&compressor, 400, &wire_bytes), 0.5);
+    GradCompressionMetrics metrics = compressor.metrics();
+    EXPECT_EQ(metrics.compressed_bytes, wire_bytes);
+    EXPECT_GT(metrics.ratio(), type == GradCompressionType::kTopK ? 40 : 90);
+  }
+}
+
+TEST_F(TestGradientCompressor, TopKSendsTheLargestElements) {
+  std::vector<float> grad(100, 0.01);
+  grad[3] = -5;
+  grad[42] = 4;
+  grad[99] = 3;
+  GradientCompressor compressor(GradCompressionType::kTopK, 0.03);
+  CompressedGradient compressed;
+  compressor.Compress(7, grad.data(), grad.size(), &compressed);
+  std::vector<float> decoded(grad.size(), 1);
+  GradientCompressor::Accumulate(compressed, decoded.data(), decoded.size());
+  std::vector<float> expect(grad.size(), 1);
+  expect[3] = -4;
+  expect[42] = 5;
+  expect[99] = 4;
+  EXPECT_EQ(decoded, expect);
+
+  // the residual of the elements left out wins the next step
+  std::vector<float> zero(grad.size(), 0);
+  compressor.Compress(7, zero.data(), zero.size(), &compressed);
+  EXPECT_EQ(compressed.indices_size(), 3);
+  std::fill(decoded.begin(), decoded.end(), 0);
+  GradientCompressor::Accumulate(compressed, decoded.data(), decoded.size());
+  EXPECT_FLOAT_EQ(std::accumulate(decoded.begin(), decoded.end(), 0.0f), 0.03);
+}
+
+TEST_F(TestGradientCompressor, RejectsMismatchedGradient) {
+  std::vector<float> grad(64, 1);
+  GradientCompressor compressor(GradCompressionType::kInt8, 1);
+  CompressedGradient compressed;
+  compressor.Compress(1, grad.data(), grad.size(), &compressed);
+  std::vector<float> decoded(32, 0);
+  EXPECT_THROW(GradientCompressor::Accumulate(compressed, decoded.data(), decoded.size()), std::runtime_error);
+  compressed.mutable_values()->resize(10);
+  decoded.resize(64);
+  EXPECT_THROW(GradientCompressor::Accumulate(compressed, decoded.data(), decoded.size()), std::runtime_error);
+  EXPECT_THROW(GradientCompressor::TypeFromName("int4"), std::runtime_error);
+  EXPECT_EQ(GradientCompressor::TypeFromName(""), GradCompressionType::kNone);
+}
+}  // namespace ps
+}  // namespace mindspore
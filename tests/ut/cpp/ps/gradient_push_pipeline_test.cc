@@ -0,0 +1,121 @@
+/**
+ * Copyright 2021 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include "common/common_test.h"
+#include "ps/gradient_push_pipeline.h"
+#include "utils/log_adapter.h"
+
+namespace mindspore {
+namespace ps {
+class TestGradientPushPipeline : public UT::Common {
+ public:
+  TestGradientPushPipeline() = default;
+  virtual ~TestGradientPushPipeline() = default;
+
+  void SetUp() override {}
+  void TearDown() override {}
+};
+
+namespace {
+// the round trip of a push to a server on the same host
+constexpr auto kPushLatency = std::chrono::milliseconds(2);
+// the backward compute between the gradients of two parameters
+constexpr auto kComputeTime = std::chrono::milliseconds(2);
+
+// gradients accumulated by the servers over a slow network
+class FakeServer {
+ public:
+  void Push(const Key &key, float grad) {
+    std::this_thread::sleep_for(kPushLatency);
+    std::lock_guard<std::mutex> lock(mutex_);
+    grads_[key] += grad;
+    order_.push_back(key);
+  }
+  float grad(const Key &key) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return grads_[key];
+  }
+  std::vector<Key> order() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return order_;
+  }
+
+ private:
+  std::mutex mutex_;
+  std::map<Key, float> grads_;
+  std::vector<Key> order_;
+};
+
+// steps of a worker as in full ps mode: the backward pass pushes the gradient of every parameter, the next forward
+// pass pulls the updated weights. Returns the time of the steps in microseconds.
+int64_t RunSteps(GradientPushPipeline *pipeline, FakeServer *server, size_t step_num, size_t param_num) {
+  auto start = std::chrono::steady_clock::now();
+  for (size_t step = 0; step < step_num; ++step) {
+    for (size_t key = 0; key < param_num; ++key) {
+      if (pipeline != nullptr) {
+        pipeline->Wait(key);
+      }
+      // every push of the worker reached the server before its pull
+      EXPECT_EQ(server->grad(key), step);
+    }
+    for (size_t key = 0; key < param_num; ++key) {
+      std::this_thread::sleep_for(kComputeTime);
+      if (pipeline != nullptr) {
+        pipeline->Push(key, [server, key]() { server->Push(key, 1); });
+      } else {
+        server->Push(key, 1);
+      }
+    }
+  }
+  if (pipeline != nullptr) {
+    pipeline->Flush();
+  }
+  return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+}
+}  // namespace
+
+// the pushes overlap the compute of the next gradients, so a step costs the compute instead of compute and round
+// trips. Pulls still see every push and the servers get the pushes in order.
+TEST_F(TestGradientPushPipeline, OverlapsPushesWithCompute) {
+  const size_t step_num = 10;
+  const size_t param_num = 8;
+  FakeServer sync_server;
+  int64_t sync_us = RunSteps(nullptr, &sync_server, step_num, param_num);
+  FakeServer pipeline_server;
+  GradientPushPipeline pipeline(2);
+  int64_t pipeline_us = RunSteps(&pipeline, &pipeline_server, step_num, param_num);
+  MS_LOG(INFO) << step_num << " steps of " << param_num << " pushes, synchronous " << sync_us << " us, pipelined "
+               << pipeline_us << " us";
+  EXPECT_EQ(pipeline_server.order(), sync_server.order());
+  EXPECT_LT(pipeline_us, sync_us * 3 / 4);
+  auto metrics = pipeline.metrics();
+  EXPECT_EQ(metrics.push_count, step_num * param_num);
+  EXPECT_GT(metrics.send_us, 0);
+}
+
+TEST_F(TestGradientPushPipeline, SendErrorReachesCaller) {
+  GradientPushPipeline pipeline(1);
+  pipeline.Push(0, []() { throw std::runtime_error("server is gone"); });
+  EXPECT_THROW(pipeline.Wait(0), std::runtime_error);
+  EXPECT_THROW(pipeline.Flush(), std::runtime_error);
+}
+}  // namespace ps
+}  // namespace mindspore
@@ -0,0 +1,104 @@
+/**
+ * Copyright 2021 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <cstdint>
+#include <vector>
+#include "common/common_test.h"
+#include "ps/kv_message_frame.h"
+#include "utils/convert_utils_base.h"
+
+namespace mindspore {
+namespace ps {
+class TestKVMessageFrame : public UT::Common {
+ public:
+  TestKVMessageFrame() = default;
+  virtual ~TestKVMessageFrame() = default;
+
+  void SetUp() override {}
+  void TearDown() override {}
+};
+
+// the values come back in place, after a header of the keys and lengths
+TEST_F(TestKVMessageFrame, EncodeDecode) {
+  std::vector<float> values(1000);
+  for (size_t i = 0; i < values.size(); ++i) {
+    values[i] = 0.5f * i;
+  }
+  KVMessage message;
+  message.add_keys(3);
+  message.add_len(SizeToInt(values.size()));
+  *message.mutable_values() = {values.begin(), values.end()};
+
+  size_t size = 0;
+  DataPtr frame = KVMessageFrame::Encode(&message, &size);
+  EXPECT_EQ(message.values_size(), 0);
+
+  KVMessage header;
+  size_t value_num = 0;
+  const float *decoded = KVMessageFrame::Decode(frame.get(), size, &header, &value_num);
+  ASSERT_EQ(value_num, values.size());
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(decoded) % sizeof(float), 0);
+  EXPECT_GE(reinterpret_cast<const unsigned char *>(decoded), frame.get());
+  EXPECT_EQ(reinterpret_cast<const unsigned char *>(decoded + value_num), frame.get() + size);
+  EXPECT_EQ(std::vector<float>(decoded, decoded + value_num), values);
+  ASSERT_EQ(header.keys_size(), 1);
+  EXPECT_EQ(header.keys(0), 3);
+  ASSERT_EQ(header.len_size(), 1);
+  EXPECT_EQ(header.len(0), SizeToInt(values.size()));
+  EXPECT_EQ(header.values_size(), 0);
+}
+
+// a response is written into the buffer handed to the handler, the caller fills the values afterwards
+TEST_F(TestKVMessageFrame, WriteIntoOutput) {
+  KVMessage header;
+  header.add_keys(7);
+  std::vector<unsigned char> output;
+  float *values = KVMessageFrame::Write(header, 2, &output);
+  values[0] = 1.0f;
+  values[1] = 2.0f;
+
+  KVMessage decoded;
+  size_t value_num = 0;
+  const float *decoded_values = KVMessageFrame::Decode(output.data(), output.size(), &decoded, &value_num);
+  ASSERT_EQ(value_num, 2);
+  EXPECT_EQ(decoded_values[0], 1.0f);
+  EXPECT_EQ(decoded_values[1], 2.0f);
+  EXPECT_EQ(decoded.keys(0), 7);
+
+  output.clear();
+  (void)KVMessageFrame::Write(header, 0, &output);
+  decoded_values = KVMessageFrame::Decode(output.data(), output.size(), &decoded, &value_num);
+  EXPECT_EQ(value_num, 0);
+}
+
+TEST_F(TestKVMessageFrame, RejectMalformedFrame) {
+  KVMessage header;
+  header.add_keys(1);
+  std::vector<float> values(4, 1.0f);
+  size_t size = 0;
+  DataPtr frame = KVMessageFrame::Encode(header, values.data(), values.size(), &size);
+  KVMessage decoded;
+  size_t value_num = 0;
+  EXPECT_ANY_THROW(KVMessageFrame::Decode(frame.get(), 2, &decoded, &value_num));
+  EXPECT_ANY_THROW(KVMessageFrame::Decode(frame.get(), size - 1, &decoded, &value_num));
+  // a length past the end of the frame
+  *reinterpret_cast<uint32_t *>(frame.get()) = 1000;
+  EXPECT_ANY_THROW(KVMessageFrame::Decode(frame.get(), size, &decoded, &value_num));
+  // a header with values is not written, they would be sent twice
+  header.add_values(1.0f);
+  EXPECT_ANY_THROW(KVMessageFrame::Encode(header, values.data(), values.size(), &size));
+}
+}  // namespace ps
+}  // namespace mindspore
@@ -0,0 +1,50 @@
+/**
+ * Copyright 2021 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <vector>
+#include "common/common_test.h"
+#include "ps/random_normal/random_normal.h"
+
+namespace mindspore {
+namespace ps {
+class TestRandomNormal : public UT::Common {
+ public:
+  TestRandomNormal() = default;
+  virtual ~TestRandomNormal() = default;
+
+  void SetUp() override {}
+  void TearDown() override {}
+};
+
+// the chunks are the table InitRandomNormal fills at once, whatever the chunk size and the split of the threads
+TEST_F(TestRandomNormal, ChunksMatchTheWholeTable) {
+  for (auto shape : std::vector<std::vector<size_t>>{{1001, 7}, {3, 4}, {64, 16}}) {
+    size_t total = shape[0] * shape[1];
+    std::vector<float> expect(total);
+    ASSERT_TRUE(InitRandomNormal(0, 0.01, shape, 5, 7, expect.data()));
+    for (size_t chunk_size : {shape[1], 3 * shape[1], total}) {
+      std::vector<float> output;
+      auto consumer = [&output, chunk_size](const float *data, size_t size) {
+        EXPECT_LE(size, chunk_size);
+        output.insert(output.end(), data, data + size);
+        return true;
+      };
+      ASSERT_TRUE(InitRandomNormal(0.01, shape, 5, 7, chunk_size, consumer));
+      EXPECT_EQ(output, expect);
+    }
+  }
+}
+}  // namespace ps
+}  // namespace mindspore
@@ -0,0 +1,61 @@
+# Copyright 2021 Huawei Technologies Co., Ltd
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+# http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+# ============================================================================
+from mindspore.ops import Primitive
+from mindspore.ops import operations as P
+
+make_tuple = Primitive('MakeTuple')
+embedding_lookup = P.EmbeddingLookup()
+unsorted_segment_sum = P.UnsortedSegmentSum()
+num_segments = 4
+offset = 2
+op_embedding_lookup = Primitive('EmbeddingLookup')
+op_unsorted_segment_sum = Primitive('UnsortedSegmentSum')
+embedding_lookup_segment_reduce = Primitive('EmbeddingLookupSegmentReduce')
+
+
+class FnDict:
+    def __init__(self):
+        self.fnDict = {}
+
+    def __call__(self, fn):
+        self.fnDict[fn.__name__] = fn
+
+    def __getitem__(self, name):
+        return self.fnDict[name]
+
+
+def test_embedding_lookup_segment_reduce_fusion(tag):
+    fns = FnDict()
+
+    @fns
+    def before(params, indices, segment_ids):
+        x = embedding_lookup(params, indices, offset)
+        return unsorted_segment_sum(x, segment_ids, num_segments)
+
+    @fns
+    def after(params, indices, segment_ids):
+        return make_tuple(embedding_lookup_segment_reduce(params, indices, segment_ids))
+
+    @fns
+    def before_shared_lookup(params, indices, segment_ids):
+        x = embedding_lookup(params, indices, offset)
+        return make_tuple(unsorted_segment_sum(x, segment_ids, num_segments), x)
+
+    @fns
+    def after_shared_lookup(params, indices, segment_ids):
+        x = op_embedding_lookup(params, indices)
+        return make_tuple(make_tuple(op_unsorted_segment_sum(x, segment_ids), x))
+
+    return fns[tag]
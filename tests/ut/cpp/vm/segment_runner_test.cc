@@ -103,5 +103,16 @@ TEST_F(TestCompileSegmentRunner, test_RunOperation2) {
   auto res = RunOperation(std::make_shared<PrimitivePy>(py::str(prim::kPrimScalarGt->name())), args);
   ASSERT_EQ(py::cast<bool>(BaseRefToPyData(res)), false);
 }
+
+// mindRT runs a single kernel graph, graphs with control flow run on the segment VM
+TEST_F(TestCompileSegmentRunner, test_IsMindRTSupported) {
+  FuncGraphPtr linear = get_py_fun_(prim::kScalarAdd);
+  std::shared_ptr<mindspore::FuncGraphManager> linear_manager = mindspore::Manage(linear);
+  ASSERT_TRUE(IsMindRTSupported(linear));
+
+  FuncGraphPtr control_flow = get_py_fun_("test_if");
+  std::shared_ptr<mindspore::FuncGraphManager> control_flow_manager = mindspore::Manage(control_flow);
+  ASSERT_FALSE(IsMindRTSupported(control_flow));
+}
 }  // namespace compile
 }  // namespace mindspore